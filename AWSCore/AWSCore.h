@@ -51,9 +51,14 @@ FOUNDATION_EXPORT const unsigned char AWSCoreVersionString[] DEPRECATED_MSG_ATTR
 #import "AWSLogging.h"
 #import "AWSClientContext.h"
 #import "AWSSynchronizedMutableDictionary.h"
+#import "AWSExecutorPool.h"
 #import "AWSXMLDictionary.h"
 #import "AWSSerialization.h"
+#import "AWSJSONStreamParser.h"
+#import "AWSJSONLazyDictionary.h"
+#import "AWSQueryFormWriter.h"
 #import "AWSTimestampSerialization.h"
+#import "AWSTimestampFormat.h"
 #import "AWSURLRequestSerialization.h"
 #import "AWSURLResponseSerialization.h"
 #import "AWSURLSessionManager.h"
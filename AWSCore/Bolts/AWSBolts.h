@@ -15,6 +15,8 @@
 #import "AWSGeneric.h"
 #import "AWSTask.h"
 #import "AWSTaskCompletionSource.h"
+#import "AWSTaskGroup.h"
+#import "AWSTaskTracer.h"
 
 
 NS_ASSUME_NONNULL_BEGIN
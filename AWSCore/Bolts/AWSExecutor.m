@@ -12,6 +12,8 @@
 
 #import <pthread.h>
 
+#import "AWSTaskTracer+Private.h"
+
 NS_ASSUME_NONNULL_BEGIN
 
 /*!
@@ -128,6 +130,13 @@ __attribute__((noinline)) static size_t remaining_stack_size(size_t *restrict to
 #pragma mark - Execution
 
 - (void)execute:(void(^)(void))block {
+    if (AWSTaskTracerIsEnabled()) {
+        block = AWSTaskTracerWrapBlock(block, AWSTaskTraceEventTypeExecution, AWSTaskTracerCurrentOperationName());
+    }
+    self.block(block);
+}
+
+- (void)aws_executeWithoutTracing:(dispatch_block_t)block {
     self.block(block);
 }
 
@@ -10,9 +10,10 @@
 
 #import "AWSTask.h"
 
-#import <libkern/OSAtomic.h>
+#import <stdatomic.h>
 
 #import "AWSBolts.h"
+#import "AWSTaskTracer+Private.h"
 
 NS_ASSUME_NONNULL_BEGIN
 
@@ -26,19 +27,55 @@ NSInteger const kAWSMultipleErrorsError = 80175001;
 
 NSString *const AWSTaskMultipleErrorsUserInfoKey = @"errors";
 
+// A task moves from pending to completing when one of the `trySet*` methods wins
+// the race to complete it, and from completing to one of the completed states
+// once the result or error is stored. The completed state is published with
+// release semantics, and read with acquire semantics, so a reader that sees it
+// also sees the result and error.
+typedef NS_ENUM(uint8_t, AWSTaskState) {
+    AWSTaskStatePending,
+    AWSTaskStateCompleting,
+    AWSTaskStateSucceeded,
+    AWSTaskStateFaulted,
+    AWSTaskStateCancelled,
+};
+
+// A continuation registered on a pending task. The continuations form a stack
+// which is pushed to with compare and swap, and which the completing thread
+// drains until it can swap in `AWSTaskContinuationsSealed`.
+typedef struct AWSTaskContinuation {
+    struct AWSTaskContinuation *next;
+    void *block;
+} AWSTaskContinuation;
+
+static AWSTaskContinuation *const AWSTaskContinuationsSealed = (AWSTaskContinuation *)(uintptr_t)1;
+
+// A task whose continuations the current thread is running. Continuations may complete other tasks,
+// so the tasks form a stack, the innermost first, which lives on the stack of the running thread.
+typedef struct AWSTaskRunningContinuations {
+    const void *task;
+    const struct AWSTaskRunningContinuations *outer;
+} AWSTaskRunningContinuations;
+
+static __thread const AWSTaskRunningContinuations *AWSTaskRunningContinuationsInnermost = NULL;
+
+// Returns YES if the current thread is running the continuations of the task.
+static BOOL AWSTaskIsRunningContinuations(const void *task) {
+    for (const AWSTaskRunningContinuations *running = AWSTaskRunningContinuationsInnermost; running; running = running->outer) {
+        if (running->task == task) {
+            return YES;
+        }
+    }
+    return NO;
+}
+
 @interface AWSTask () {
     id _result;
     NSError *_error;
+    _Atomic(AWSTaskState) _state;
+    _Atomic(AWSTaskContinuation *) _continuations;
 }
 
-@property (nonatomic, assign, readwrite, getter=isCancelled) BOOL cancelled;
-@property (nonatomic, assign, readwrite, getter=isFaulted) BOOL faulted;
-@property (nonatomic, assign, readwrite, getter=isCompleted) BOOL completed;
-
-@property (nonatomic, strong) NSObject *lock;
-@property (nonatomic, strong) NSCondition *condition;
-@property (nonatomic, strong) NSMutableArray *callbacks;
-
 @end
 
 @implementation AWSTask
@@ -49,15 +86,14 @@ NSString *const AWSTaskMultipleErrorsUserInfoKey = @"errors";
     self = [super init];
     if (!self) return self;
 
-    _lock = [[NSObject alloc] init];
-    _condition = [[NSCondition alloc] init];
-    _callbacks = [NSMutableArray array];
+    atomic_init(&_state, AWSTaskStatePending);
+    atomic_init(&_continuations, NULL);
 
     return self;
 }
 
 - (instancetype)initWithResult:(nullable id)result {
-    self = [super init];
+    self = [self init];
     if (!self) return self;
 
     [self trySetResult:result];
@@ -66,7 +102,7 @@ NSString *const AWSTaskMultipleErrorsUserInfoKey = @"errors";
 }
 
 - (instancetype)initWithError:(NSError *)error {
-    self = [super init];
+    self = [self init];
     if (!self) return self;
 
     [self trySetError:error];
@@ -75,7 +111,7 @@ NSString *const AWSTaskMultipleErrorsUserInfoKey = @"errors";
 }
 
 - (instancetype)initCancelled {
-    self = [super init];
+    self = [self init];
     if (!self) return self;
 
     [self trySetCancelled];
@@ -83,6 +119,20 @@ NSString *const AWSTaskMultipleErrorsUserInfoKey = @"errors";
     return self;
 }
 
+- (void)dealloc {
+    // Continuations of a task which never completed are released without running.
+    AWSTaskContinuation *continuation = atomic_load_explicit(&_continuations, memory_order_acquire);
+    if (continuation == AWSTaskContinuationsSealed) {
+        return;
+    }
+    while (continuation) {
+        AWSTaskContinuation *next = continuation->next;
+        CFRelease(continuation->block);
+        free(continuation);
+        continuation = next;
+    }
+}
+
 #pragma mark - Task Class methods
 
 + (instancetype)taskWithResult:(nullable id)result {
@@ -98,12 +148,12 @@ NSString *const AWSTaskMultipleErrorsUserInfoKey = @"errors";
 }
 
 + (instancetype)taskForCompletionOfAllTasks:(nullable NSArray<AWSTask *> *)tasks {
-    __block int32_t total = (int32_t)tasks.count;
-    if (total == 0) {
+    if (tasks.count == 0) {
         return [self taskWithResult:nil];
     }
 
-    __block int32_t cancelled = 0;
+    __block atomic_uint total = (unsigned int)tasks.count;
+    __block atomic_uint cancelled = 0;
     NSObject *lock = [[NSObject alloc] init];
     NSMutableArray *errors = [NSMutableArray array];
 
@@ -115,10 +165,10 @@ NSString *const AWSTaskMultipleErrorsUserInfoKey = @"errors";
                     [errors addObject:t.error];
                 }
             } else if (t.cancelled) {
-                OSAtomicIncrement32Barrier(&cancelled);
+                atomic_fetch_add(&cancelled, 1);
             }
 
-            if (OSAtomicDecrement32Barrier(&total) == 0) {
+            if (atomic_fetch_sub(&total, 1) == 1) {
                 if (errors.count > 0) {
                     if (errors.count == 1) {
                         tcs.error = [errors firstObject];
@@ -128,7 +178,7 @@ NSString *const AWSTaskMultipleErrorsUserInfoKey = @"errors";
                                                          userInfo:@{ AWSTaskMultipleErrorsUserInfoKey: errors }];
                         tcs.error = error;
                     }
-                } else if (cancelled > 0) {
+                } else if (atomic_load(&cancelled) > 0) {
                     [tcs cancel];
                 } else {
                     tcs.result = nil;
@@ -148,13 +198,13 @@ NSString *const AWSTaskMultipleErrorsUserInfoKey = @"errors";
 
 + (instancetype)taskForCompletionOfAnyTask:(nullable NSArray<AWSTask *> *)tasks
 {
-    __block int32_t total = (int32_t)tasks.count;
-    if (total == 0) {
+    if (tasks.count == 0) {
         return [self taskWithResult:nil];
     }
     
-    __block int completed = 0;
-    __block int32_t cancelled = 0;
+    __block atomic_uint total = (unsigned int)tasks.count;
+    __block atomic_bool completed = false;
+    __block atomic_uint cancelled = 0;
     
     NSObject *lock = [NSObject new];
     NSMutableArray<NSError *> *errors = [NSMutableArray new];
@@ -167,16 +217,18 @@ NSString *const AWSTaskMultipleErrorsUserInfoKey = @"errors";
                     [errors addObject:t.error];
                 }
             } else if (t.cancelled) {
-                OSAtomicIncrement32Barrier(&cancelled);
+                atomic_fetch_add(&cancelled, 1);
             } else {
-                if(OSAtomicCompareAndSwap32Barrier(0, 1, &completed)) {
+                bool expected = false;
+                if (atomic_compare_exchange_strong(&completed, &expected, true)) {
                     [source setResult:t.result];
                 }
             }
             
-            if (OSAtomicDecrement32Barrier(&total) == 0 &&
-                OSAtomicCompareAndSwap32Barrier(0, 1, &completed)) {
-                if (cancelled > 0) {
+            bool expected = false;
+            if (atomic_fetch_sub(&total, 1) == 1 &&
+                atomic_compare_exchange_strong(&completed, &expected, true)) {
+                if (atomic_load(&cancelled) > 0) {
                     [source cancel];
                 } else if (errors.count > 0) {
                     if (errors.count == 1) {
@@ -231,83 +283,126 @@ NSString *const AWSTaskMultipleErrorsUserInfoKey = @"errors";
 
 #pragma mark - Custom Setters/Getters
 
+- (AWSTaskState)state {
+    return atomic_load_explicit(&_state, memory_order_acquire);
+}
+
 - (nullable id)result {
-    @synchronized(self.lock) {
-        return _result;
-    }
+    return [self state] == AWSTaskStateSucceeded ? _result : nil;
 }
 
 - (BOOL)trySetResult:(nullable id)result {
-    @synchronized(self.lock) {
-        if (self.completed) {
-            return NO;
-        }
-        self.completed = YES;
-        _result = result;
-        [self runContinuations];
-        return YES;
+    if (![self beginCompleting]) {
+        return NO;
     }
+    _result = result;
+    [self completeWithState:AWSTaskStateSucceeded];
+    return YES;
 }
 
 - (nullable NSError *)error {
-    @synchronized(self.lock) {
-        return _error;
-    }
+    return [self state] == AWSTaskStateFaulted ? _error : nil;
 }
 
 - (BOOL)trySetError:(NSError *)error {
-    @synchronized(self.lock) {
-        if (self.completed) {
-            return NO;
-        }
-        self.completed = YES;
-        self.faulted = YES;
-        _error = error;
-        [self runContinuations];
-        return YES;
+    if (![self beginCompleting]) {
+        return NO;
     }
+    _error = error;
+    [self completeWithState:AWSTaskStateFaulted];
+    return YES;
 }
 
 - (BOOL)isCancelled {
-    @synchronized(self.lock) {
-        return _cancelled;
-    }
+    return [self state] == AWSTaskStateCancelled;
 }
 
 - (BOOL)isFaulted {
-    @synchronized(self.lock) {
-        return _faulted;
-    }
+    return [self state] == AWSTaskStateFaulted;
 }
 
 - (BOOL)trySetCancelled {
-    @synchronized(self.lock) {
-        if (self.completed) {
-            return NO;
-        }
-        self.completed = YES;
-        self.cancelled = YES;
-        [self runContinuations];
-        return YES;
+    if (![self beginCompleting]) {
+        return NO;
     }
+    [self completeWithState:AWSTaskStateCancelled];
+    return YES;
 }
 
 - (BOOL)isCompleted {
-    @synchronized(self.lock) {
-        return _completed;
-    }
+    return [self state] >= AWSTaskStateSucceeded;
+}
+
+// Returns YES if the caller won the race to complete the task, and is the only
+// thread which may set its result or error.
+- (BOOL)beginCompleting {
+    AWSTaskState expected = AWSTaskStatePending;
+    return atomic_compare_exchange_strong_explicit(&_state, &expected, AWSTaskStateCompleting,
+                                                   memory_order_acquire, memory_order_relaxed);
+}
+
+- (void)completeWithState:(AWSTaskState)state {
+    atomic_store_explicit(&_state, state, memory_order_release);
+    [self runContinuations];
 }
 
 - (void)runContinuations {
-    @synchronized(self.lock) {
-        [self.condition lock];
-        [self.condition broadcast];
-        [self.condition unlock];
-        for (void (^callback)(void) in self.callbacks) {
-            callback();
+    // The stack is only sealed once it is empty: the continuations registered while the earlier ones run are
+    // pushed to it and run next on this thread, so that all of them run in the order they were registered.
+    const AWSTaskRunningContinuations running = {(__bridge const void *)self, AWSTaskRunningContinuationsInnermost};
+    AWSTaskRunningContinuationsInnermost = &running;
+    while (YES) {
+        AWSTaskContinuation *continuation = atomic_exchange_explicit(&_continuations, NULL, memory_order_acq_rel);
+        if (!continuation) {
+            AWSTaskContinuation *expected = NULL;
+            if (atomic_compare_exchange_strong_explicit(&_continuations, &expected, AWSTaskContinuationsSealed,
+                                                        memory_order_acq_rel, memory_order_acquire)) {
+                break;
+            }
+            continue;
         }
-        [self.callbacks removeAllObjects];
+
+        // The stack holds the most recent continuation first, run them in the order they were registered.
+        AWSTaskContinuation *reversed = NULL;
+        while (continuation) {
+            AWSTaskContinuation *next = continuation->next;
+            continuation->next = reversed;
+            reversed = continuation;
+            continuation = next;
+        }
+        while (reversed) {
+            AWSTaskContinuation *next = reversed->next;
+            dispatch_block_t block = (__bridge_transfer dispatch_block_t)reversed->block;
+            free(reversed);
+            block();
+            reversed = next;
+        }
+    }
+    AWSTaskRunningContinuationsInnermost = running.outer;
+}
+
+// Runs the block once the task is completed and the continuations registered before it have run,
+// or right away if they have. A continuation registered while the current thread runs the continuations
+// of the task, even from those of another task they complete, runs right away as well, as it may be
+// waited for by the continuation registering it.
+- (void)addContinuation:(dispatch_block_t)block {
+    AWSTaskContinuation *head = atomic_load_explicit(&_continuations, memory_order_acquire);
+    if (head != AWSTaskContinuationsSealed && !AWSTaskIsRunningContinuations((__bridge const void *)self)) {
+        AWSTaskContinuation *continuation = malloc(sizeof(AWSTaskContinuation));
+        continuation->block = (__bridge_retained void *)[block copy];
+        do {
+            continuation->next = head;
+            if (atomic_compare_exchange_weak_explicit(&_continuations, &head, continuation,
+                                                      memory_order_release, memory_order_acquire)) {
+                return;
+            }
+        } while (head != AWSTaskContinuationsSealed);
+
+        // The continuations of the task have all run while this one was being registered.
+        CFRelease(continuation->block);
+        free(continuation);
     }
+    block();
 }
 
 #pragma mark - Chaining methods
@@ -355,18 +450,23 @@ NSString *const AWSTaskMultipleErrorsUserInfoKey = @"errors";
         }
     };
 
-    BOOL completed;
-    @synchronized(self.lock) {
-        completed = self.completed;
-        if (!completed) {
-            [self.callbacks addObject:[^{
-                [executor execute:executionBlock];
-            } copy]];
-        }
+    if (AWSTaskTracerIsEnabled()) {
+        // The continuation inherits the operation of the caller, or else of this task, and passes it on to the
+        // task it returns.
+        NSString *operationName = AWSTaskTracerCurrentOperationName() ?: self.aws_traceOperationName;
+        tcs.task.aws_traceOperationName = operationName;
+        dispatch_block_t untracedExecutionBlock = executionBlock;
+        [self addContinuation:^{
+            [executor aws_executeWithoutTracing:AWSTaskTracerWrapBlock(untracedExecutionBlock, AWSTaskTraceEventTypeContinuation, operationName)];
+        }];
+        return tcs.task;
     }
-    if (completed) {
+
+    // The continuation is not run directly when the task is seen completed: the continuations registered before it
+    // may not have run yet. `addContinuation:` runs it right away once they have.
+    [self addContinuation:^{
         [executor execute:executionBlock];
-    }
+    }];
 
     return tcs.task;
 }
@@ -419,35 +519,25 @@ NSString *const AWSTaskMultipleErrorsUserInfoKey = @"errors";
         [self warnOperationOnMainThread];
     }
 
-    @synchronized(self.lock) {
-        if (self.completed) {
-            return;
-        }
-        [self.condition lock];
-    }
-    // TODO: (nlutsenko) Restructure this to use Bolts-Swift thread access synchronization architecture
-    // In the meantime, it's absolutely safe to get `_completed` aka an ivar, as long as it's a `BOOL` aka less than word size.
-    while (!_completed) {
-        [self.condition wait];
+    if (self.completed) {
+        return;
     }
-    [self.condition unlock];
+    dispatch_semaphore_t semaphore = dispatch_semaphore_create(0);
+    [self addContinuation:^{
+        dispatch_semaphore_signal(semaphore);
+    }];
+    dispatch_semaphore_wait(semaphore, DISPATCH_TIME_FOREVER);
 }
 
 #pragma mark - NSObject
 
 - (NSString *)description {
-    // Acquire the data from the locked properties
-    BOOL completed;
-    BOOL cancelled;
-    BOOL faulted;
-    NSString *resultDescription = nil;
-
-    @synchronized(self.lock) {
-        completed = self.completed;
-        cancelled = self.cancelled;
-        faulted = self.faulted;
-        resultDescription = completed ? [NSString stringWithFormat:@" result = %@", self.result] : @"";
-    }
+    // Read the state once, so the description is consistent
+    AWSTaskState state = [self state];
+    BOOL completed = state >= AWSTaskStateSucceeded;
+    BOOL cancelled = state == AWSTaskStateCancelled;
+    BOOL faulted = state == AWSTaskStateFaulted;
+    NSString *resultDescription = completed ? [NSString stringWithFormat:@" result = %@", state == AWSTaskStateSucceeded ? _result : nil] : @"";
 
     // Description string includes status information and, if available, the
     // result since in some ways this is what a promise actually "is".
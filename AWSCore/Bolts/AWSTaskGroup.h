@@ -0,0 +1,121 @@
+//
+// Copyright 2010-2021 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License.
+// A copy of the License is located at
+//
+// http://aws.amazon.com/apache2.0
+//
+// or in the "license" file accompanying this file. This file is distributed
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+//
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+@class AWSCancellationToken;
+@class AWSTask;
+
+/*!
+ How a task group handles the tasks which fail.
+ */
+typedef NS_ENUM(NSInteger, AWSTaskGroupErrorMode) {
+    /*!
+     No task is started after the first task fails or is cancelled, and the token passed to the tasks which
+     are still running is cancelled. The group fails with the error of the first failed task.
+     */
+    AWSTaskGroupErrorModeFailFast,
+    /*!
+     Every task is started regardless of the tasks which fail. The group fails with the error of the failed
+     task, or with a `kAWSMultipleErrorsError` error if more than one task failed.
+     */
+    AWSTaskGroupErrorModeCollectAll,
+};
+
+/*!
+ A block that starts the task for an object of the sequence run by a task group.
+ @param object The object of the sequence.
+ @param token A token that is cancelled when the group stops starting tasks, e.g. after a task failed in the
+ fail-fast mode or after the cancellation token of the group was cancelled.
+ @returns The task for the object. A `nil` task counts as a task completed with a `nil` result.
+ */
+typedef AWSTask * _Nullable (^AWSTaskGroupBlock)(id object, AWSCancellationToken *token);
+
+/*!
+ A block that reports the progress of a task group.
+ @param completedCount The number of tasks completed so far, including the failed and cancelled ones.
+ @param faultedCount The number of tasks which failed so far.
+ */
+typedef void (^AWSTaskGroupProgressBlock)(NSUInteger completedCount, NSUInteger faultedCount);
+
+/*!
+ Runs a task for each object of a sequence, with at most a given number of the tasks running at a time.
+
+ The objects are taken from an `NSEnumerator` only when a task can be started, so the sequence can be lazy
+ (e.g. the keys of a paginated listing) and the tasks are not created up front like for
+ <AWSTask taskForCompletionOfAllTasks:>.
+
+ A group only holds its configuration, and can run any number of sequences, concurrently or not.
+ */
+@interface AWSTaskGroup : NSObject
+
+/*!
+ The maximum number of tasks of a sequence running at a time.
+ */
+@property (nonatomic, assign, readonly) NSUInteger maximumConcurrency;
+
+/*!
+ How the tasks which fail are handled. The default is `AWSTaskGroupErrorModeFailFast`.
+ */
+@property (nonatomic, assign) AWSTaskGroupErrorMode errorMode;
+
+/*!
+ A token which stops the group from starting more tasks when it is cancelled. The token passed to the tasks
+ which are still running is cancelled as well, and the group is cancelled once they complete.
+ */
+@property (nonatomic, strong, nullable) AWSCancellationToken *cancellationToken;
+
+/*!
+ A block called every time a task of the group completes. It is called on the thread that completed the task,
+ one call at a time, and must not run a sequence on the group or wait for a task of the group.
+ */
+@property (nonatomic, copy, nullable) AWSTaskGroupProgressBlock progressBlock;
+
+/*!
+ Creates a group which runs at most the given number of tasks at a time. A maximum concurrency of 0 is raised
+ to 1.
+ */
++ (instancetype)taskGroupWithMaximumConcurrency:(NSUInteger)maximumConcurrency;
+
+/*!
+ Initializes a group which runs at most the given number of tasks at a time. A maximum concurrency of 0 is
+ raised to 1.
+ */
+- (instancetype)initWithMaximumConcurrency:(NSUInteger)maximumConcurrency NS_DESIGNATED_INITIALIZER;
+
+- (instancetype)init NS_UNAVAILABLE;
+
+/*!
+ Starts a task for each object of the enumerator, keeping at most `maximumConcurrency` of them running.
+ @param enumerator The objects to start the tasks for. It is only read from one thread at a time.
+ @param block The block that starts the task for an object.
+ @returns A task that completes once no more tasks will be started and the started ones have completed. If every
+ task succeeded, its result is an `NSArray` of the results of the tasks in the order of the objects, with `NSNull`
+ for the `nil` results. Otherwise it fails according to `errorMode`, or is cancelled if no task failed and a task
+ or the cancellation token of the group was cancelled.
+ */
+- (AWSTask<NSArray *> *)runWithEnumerator:(NSEnumerator *)enumerator block:(AWSTaskGroupBlock)block;
+
+/*!
+ Starts a task for each object of the array, keeping at most `maximumConcurrency` of them running.
+ @see runWithEnumerator:block:
+ */
+- (AWSTask<NSArray *> *)runWithObjects:(NSArray *)objects block:(AWSTaskGroupBlock)block;
+
+@end
+
+NS_ASSUME_NONNULL_END
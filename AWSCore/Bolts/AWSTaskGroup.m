@@ -0,0 +1,238 @@
+//
+// Copyright 2010-2021 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License.
+// A copy of the License is located at
+//
+// http://aws.amazon.com/apache2.0
+//
+// or in the "license" file accompanying this file. This file is distributed
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+//
+
+#import "AWSTaskGroup.h"
+
+#import <pthread.h>
+
+#import "AWSCancellationToken.h"
+#import "AWSCancellationTokenRegistration.h"
+#import "AWSCancellationTokenSource.h"
+#import "AWSExecutor.h"
+#import "AWSTask.h"
+#import "AWSTaskCompletionSource.h"
+
+// The state of one sequence run by a group. The run is kept alive by the
+// continuations of its running tasks, and releases the enumerator and the block
+// once it completes.
+@interface AWSTaskGroupRun : NSObject
+
+- (instancetype)initWithGroup:(AWSTaskGroup *)group
+                   enumerator:(NSEnumerator *)enumerator
+                        block:(AWSTaskGroupBlock)block;
+
+- (AWSTask<NSArray *> *)start;
+
+@end
+
+@implementation AWSTaskGroupRun {
+    pthread_mutex_t _lock;
+    NSUInteger _maximumConcurrency;
+    AWSTaskGroupErrorMode _errorMode;
+    AWSCancellationToken *_cancellationToken;
+    AWSTaskGroupProgressBlock _progressBlock;
+    NSEnumerator *_enumerator;
+    AWSTaskGroupBlock _block;
+    AWSCancellationTokenSource *_tasksCancellationTokenSource;
+    AWSCancellationTokenRegistration *_cancellationRegistration;
+    AWSTaskCompletionSource<NSArray *> *_completionSource;
+
+    // Guarded by _lock.
+    NSMutableArray *_results;
+    NSMutableArray<NSError *> *_errors;
+    NSUInteger _runningCount;
+    NSUInteger _completedCount;
+    NSUInteger _cancelledCount;
+    BOOL _starting;
+    BOOL _exhausted;
+    BOOL _stopped;
+    BOOL _cancelled;
+    BOOL _finished;
+}
+
+- (instancetype)initWithGroup:(AWSTaskGroup *)group
+                   enumerator:(NSEnumerator *)enumerator
+                        block:(AWSTaskGroupBlock)block {
+    if (self = [super init]) {
+        pthread_mutex_init(&_lock, NULL);
+        _maximumConcurrency = group.maximumConcurrency;
+        _errorMode = group.errorMode;
+        _cancellationToken = group.cancellationToken;
+        _progressBlock = group.progressBlock;
+        _enumerator = enumerator;
+        _block = [block copy];
+        _tasksCancellationTokenSource = [AWSCancellationTokenSource cancellationTokenSource];
+        _completionSource = [AWSTaskCompletionSource taskCompletionSource];
+        _results = [NSMutableArray new];
+        _errors = [NSMutableArray new];
+    }
+    return self;
+}
+
+- (void)dealloc {
+    pthread_mutex_destroy(&_lock);
+}
+
+- (AWSTask<NSArray *> *)start {
+    AWSTask<NSArray *> *task = _completionSource.task;
+    if (_cancellationToken) {
+        // The observer is called right away if the token is already cancelled.
+        __weak AWSTaskGroupRun *weakSelf = self;
+        _cancellationRegistration = [_cancellationToken registerCancellationObserverWithBlock:^{
+            [weakSelf cancel];
+        }];
+    }
+    [self startTasks];
+    return task;
+}
+
+- (void)cancel {
+    pthread_mutex_lock(&_lock);
+    _cancelled = YES;
+    _stopped = YES;
+    pthread_mutex_unlock(&_lock);
+
+    [_tasksCancellationTokenSource cancel];
+    [self startTasks];
+}
+
+// Starts tasks until the maximum concurrency is reached or the sequence is over.
+// Only one thread starts tasks at a time; a task completing while another thread
+// is starting tasks leaves it to that thread, which checks the running count
+// again before returning. This also keeps tasks which complete synchronously
+// from starting the next task recursively.
+- (void)startTasks {
+    pthread_mutex_lock(&_lock);
+    if (_starting) {
+        pthread_mutex_unlock(&_lock);
+        return;
+    }
+    _starting = YES;
+
+    while (!_stopped && !_exhausted && _runningCount < _maximumConcurrency) {
+        NSUInteger index = [_results count];
+        [_results addObject:[NSNull null]];
+        _runningCount++;
+        pthread_mutex_unlock(&_lock);
+
+        id object = [_enumerator nextObject];
+        AWSTask *task = nil;
+        if (object) {
+            task = _block(object, _tasksCancellationTokenSource.token) ?: [AWSTask taskWithResult:nil];
+            [task continueWithExecutor:[AWSExecutor immediateExecutor] withBlock:^id(AWSTask *t) {
+                [self task:t didCompleteAtIndex:index];
+                return nil;
+            }];
+        }
+
+        pthread_mutex_lock(&_lock);
+        if (!object) {
+            [_results removeLastObject];
+            _runningCount--;
+            _exhausted = YES;
+        }
+    }
+
+    _starting = NO;
+    BOOL finishes = !_finished && _runningCount == 0 && (_stopped || _exhausted);
+    if (finishes) {
+        _finished = YES;
+    }
+    pthread_mutex_unlock(&_lock);
+
+    if (finishes) {
+        [self finish];
+    }
+}
+
+- (void)task:(AWSTask *)task didCompleteAtIndex:(NSUInteger)index {
+    BOOL stops = NO;
+
+    pthread_mutex_lock(&_lock);
+    _runningCount--;
+    _completedCount++;
+    if (task.error) {
+        [_errors addObject:task.error];
+        stops = _errorMode == AWSTaskGroupErrorModeFailFast;
+    } else if (task.cancelled) {
+        _cancelledCount++;
+        stops = _errorMode == AWSTaskGroupErrorModeFailFast;
+    } else if (task.result) {
+        _results[index] = task.result;
+    }
+    if (stops) {
+        _stopped = YES;
+    }
+    if (_progressBlock) {
+        _progressBlock(_completedCount, [_errors count]);
+    }
+    pthread_mutex_unlock(&_lock);
+
+    if (stops) {
+        [_tasksCancellationTokenSource cancel];
+    }
+    [self startTasks];
+}
+
+- (void)finish {
+    [_cancellationRegistration dispose];
+    _cancellationRegistration = nil;
+    _enumerator = nil;
+    _block = nil;
+
+    // No task is running anymore, so the state can be read without the lock.
+    if ([_errors count] > 0) {
+        if (_errorMode == AWSTaskGroupErrorModeFailFast || [_errors count] == 1) {
+            _completionSource.error = [_errors firstObject];
+        } else {
+            _completionSource.error = [NSError errorWithDomain:AWSTaskErrorDomain
+                                                          code:kAWSMultipleErrorsError
+                                                      userInfo:@{AWSTaskMultipleErrorsUserInfoKey : [_errors copy]}];
+        }
+    } else if (_cancelled || _cancelledCount > 0) {
+        [_completionSource cancel];
+    } else {
+        _completionSource.result = [_results copy];
+    }
+}
+
+@end
+
+@implementation AWSTaskGroup
+
++ (instancetype)taskGroupWithMaximumConcurrency:(NSUInteger)maximumConcurrency {
+    return [[self alloc] initWithMaximumConcurrency:maximumConcurrency];
+}
+
+- (instancetype)initWithMaximumConcurrency:(NSUInteger)maximumConcurrency {
+    if (self = [super init]) {
+        _maximumConcurrency = MAX(maximumConcurrency, 1);
+        _errorMode = AWSTaskGroupErrorModeFailFast;
+    }
+    return self;
+}
+
+- (AWSTask<NSArray *> *)runWithEnumerator:(NSEnumerator *)enumerator block:(AWSTaskGroupBlock)block {
+    AWSTaskGroupRun *run = [[AWSTaskGroupRun alloc] initWithGroup:self
+                                                       enumerator:enumerator
+                                                            block:block];
+    return [run start];
+}
+
+- (AWSTask<NSArray *> *)runWithObjects:(NSArray *)objects block:(AWSTaskGroupBlock)block {
+    return [self runWithEnumerator:[objects objectEnumerator] block:block];
+}
+
+@end
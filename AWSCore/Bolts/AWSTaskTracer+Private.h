@@ -0,0 +1,66 @@
+//
+// Copyright 2010-2021 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License.
+// A copy of the License is located at
+//
+// http://aws.amazon.com/apache2.0
+//
+// or in the "license" file accompanying this file. This file is distributed
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+//
+
+#import <stdatomic.h>
+
+#import "AWSExecutor.h"
+#import "AWSTask.h"
+#import "AWSTaskTracer.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+// Set while a sink is set. It is the only thing checked while tracing is off.
+extern atomic_bool AWSTaskTracerEnabled;
+
+static inline BOOL AWSTaskTracerIsEnabled(void) {
+    return __builtin_expect(atomic_load_explicit(&AWSTaskTracerEnabled, memory_order_relaxed), 0);
+}
+
+uint64_t AWSTaskTracerCurrentTime(void);
+
+// The operation name of the current thread. It is not retained; the caller of
+// `AWSTaskTracerSetCurrentOperationName` keeps it alive until it restores the
+// previous name.
+NSString * _Nullable AWSTaskTracerCurrentOperationName(void);
+void AWSTaskTracerSetCurrentOperationName(NSString * _Nullable operationName);
+
+// Returns the block wrapped so that it runs with the operation name and records
+// an event when it returns. The enqueue time is the time of the call.
+dispatch_block_t AWSTaskTracerWrapBlock(dispatch_block_t block,
+                                        AWSTaskTraceEventType type,
+                                        NSString * _Nullable operationName);
+
+void AWSTaskTracerRecordEvent(AWSTaskTraceEventType type,
+                              NSString * _Nullable operationName,
+                              uint64_t enqueueTime,
+                              uint64_t startTime,
+                              uint64_t endTime);
+
+@interface AWSTask (AWSTaskTracer)
+
+// The operation name inherited by the continuations of the task.
+@property (nonatomic, strong, nullable, setter=aws_setTraceOperationName:) NSString *aws_traceOperationName;
+
+@end
+
+@interface AWSExecutor (AWSTaskTracer)
+
+// Runs the block without recording an execution event, for blocks which are
+// already traced as continuations.
+- (void)aws_executeWithoutTracing:(dispatch_block_t)block;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,164 @@
+//
+// Copyright 2010-2021 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License.
+// A copy of the License is located at
+//
+// http://aws.amazon.com/apache2.0
+//
+// or in the "license" file accompanying this file. This file is distributed
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+//
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/*!
+ What a trace event measures.
+ */
+typedef NS_ENUM(NSInteger, AWSTaskTraceEventType) {
+    /*!
+     A continuation block of a task, from the completion of the task to the end of the block.
+     */
+    AWSTaskTraceEventTypeContinuation,
+    /*!
+     A block run with `-[AWSExecutor execute:]`, from the call to the end of the block.
+     */
+    AWSTaskTraceEventTypeExecution,
+    /*!
+     The `NSURLSessionTask` of a service request, from its start to its completion.
+     */
+    AWSTaskTraceEventTypeNetwork,
+};
+
+/*!
+ A span recorded by `AWSTaskTracer`. The times are in nanoseconds of the monotonic clock of `mach_absolute_time()`.
+ */
+@interface AWSTaskTraceEvent : NSObject
+
+@property (nonatomic, assign, readonly) AWSTaskTraceEventType type;
+
+/*!
+ The service operation which the span is part of, e.g. `PutItem`, or `nil` if the span is not part of one.
+ */
+@property (nonatomic, strong, readonly, nullable) NSString *operationName;
+
+/*!
+ When the block was handed to its executor, or when the request was started.
+ */
+@property (nonatomic, assign, readonly) uint64_t enqueueTime;
+
+/*!
+ When the executor started running the block. The difference with `enqueueTime` is the time spent waiting in the
+ executor. It is equal to `enqueueTime` for network events.
+ */
+@property (nonatomic, assign, readonly) uint64_t startTime;
+
+/*!
+ When the block returned, or when the request completed.
+ */
+@property (nonatomic, assign, readonly) uint64_t endTime;
+
+/*!
+ The identifier of the thread which ran the block, as returned by `pthread_threadid_np()`.
+ */
+@property (nonatomic, assign, readonly) uint64_t threadID;
+
+- (instancetype)initWithType:(AWSTaskTraceEventType)type
+               operationName:(nullable NSString *)operationName
+                 enqueueTime:(uint64_t)enqueueTime
+                   startTime:(uint64_t)startTime
+                     endTime:(uint64_t)endTime
+                    threadID:(uint64_t)threadID;
+
+@end
+
+/*!
+ A receiver of the events recorded by `AWSTaskTracer`. Events are recorded on the threads that run the blocks, so
+ a sink must be thread-safe, and should return quickly.
+ */
+@protocol AWSTaskTraceSink <NSObject>
+
+- (void)recordEvent:(AWSTaskTraceEvent *)event;
+
+@end
+
+/*!
+ Records how long the continuations of tasks wait in their executors and run, and how long service requests spend
+ on the network, attributed to the service operation they are part of.
+
+ Tracing is off until a sink is set. While it is off, continuations and executors only check a flag.
+
+ Continuations and blocks inherit the operation name that is current when they are registered, or else the operation
+ name of the task they continue. Service clients set the operation name of their requests, and it can be set for
+ other work with `runWithOperationName:block:`.
+ */
+@interface AWSTaskTracer : NSObject
+
+/*!
+ The sink which receives the recorded events. Setting a sink turns tracing on, and setting `nil` turns it off.
+ */
+@property (class, nonatomic, strong, nullable) id<AWSTaskTraceSink> sink;
+
+/*!
+ Runs the block with the given operation name, so that the continuations registered by the block are attributed to
+ the operation.
+ */
++ (void)runWithOperationName:(NSString *)operationName block:(void (^)(void))block;
+
+/*!
+ The current time on the clock of the trace events.
+ */
++ (uint64_t)currentTime;
+
+@end
+
+/*!
+ A sink which keeps the events in memory, and writes them in the Chrome trace event format, which can be opened with
+ `chrome://tracing` or https://ui.perfetto.dev. Continuations and executions are complete events on the thread that
+ ran them, with the time spent in the executor in their arguments, and network requests are asynchronous events.
+ */
+@interface AWSChromeTraceSink : NSObject <AWSTaskTraceSink>
+
+/*!
+ The number of events which were not kept because the sink was full.
+ */
+@property (nonatomic, assign, readonly) NSUInteger droppedEventCount;
+
+/*!
+ Returns a sink which keeps up to 100,000 events.
+ */
+- (instancetype)init;
+
+/*!
+ Returns a sink which keeps up to the given number of events. Later events are dropped.
+ */
+- (instancetype)initWithMaximumEventCount:(NSUInteger)maximumEventCount NS_DESIGNATED_INITIALIZER;
+
+/*!
+ Returns the events recorded so far.
+ */
+- (NSArray<AWSTaskTraceEvent *> *)events;
+
+/*!
+ Returns the events recorded so far as a JSON trace.
+ */
+- (NSData *)traceData;
+
+/*!
+ Writes the events recorded so far as a JSON trace to the given file.
+ */
+- (BOOL)writeToURL:(NSURL *)URL error:(NSError **)error;
+
+/*!
+ Removes the events recorded so far.
+ */
+- (void)reset;
+
+@end
+
+NS_ASSUME_NONNULL_END
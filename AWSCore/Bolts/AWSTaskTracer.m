@@ -0,0 +1,287 @@
+//
+// Copyright 2010-2021 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License.
+// A copy of the License is located at
+//
+// http://aws.amazon.com/apache2.0
+//
+// or in the "license" file accompanying this file. This file is distributed
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+//
+
+#import "AWSTaskTracer.h"
+#import "AWSTaskTracer+Private.h"
+
+#import <mach/mach_time.h>
+#import <objc/runtime.h>
+#import <pthread.h>
+
+atomic_bool AWSTaskTracerEnabled = false;
+
+static pthread_mutex_t AWSTaskTracerSinkLock = PTHREAD_MUTEX_INITIALIZER;
+static id<AWSTaskTraceSink> AWSTaskTracerCurrentSink = nil;
+
+static pthread_key_t AWSTaskTracerOperationNameKey;
+
+static char AWSTaskTraceOperationNameAssociationKey;
+
+uint64_t AWSTaskTracerCurrentTime(void) {
+    static mach_timebase_info_data_t timebase;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        mach_timebase_info(&timebase);
+    });
+    return mach_absolute_time() * timebase.numer / timebase.denom;
+}
+
+static void AWSTaskTracerInitializeOperationNameKey(void) {
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        pthread_key_create(&AWSTaskTracerOperationNameKey, NULL);
+    });
+}
+
+NSString *AWSTaskTracerCurrentOperationName(void) {
+    AWSTaskTracerInitializeOperationNameKey();
+    return (__bridge NSString *)pthread_getspecific(AWSTaskTracerOperationNameKey);
+}
+
+void AWSTaskTracerSetCurrentOperationName(NSString *operationName) {
+    AWSTaskTracerInitializeOperationNameKey();
+    pthread_setspecific(AWSTaskTracerOperationNameKey, (__bridge const void *)operationName);
+}
+
+void AWSTaskTracerRecordEvent(AWSTaskTraceEventType type,
+                              NSString *operationName,
+                              uint64_t enqueueTime,
+                              uint64_t startTime,
+                              uint64_t endTime) {
+    pthread_mutex_lock(&AWSTaskTracerSinkLock);
+    id<AWSTaskTraceSink> sink = AWSTaskTracerCurrentSink;
+    pthread_mutex_unlock(&AWSTaskTracerSinkLock);
+    if (!sink) {
+        return;
+    }
+
+    uint64_t threadID = 0;
+    pthread_threadid_np(NULL, &threadID);
+    [sink recordEvent:[[AWSTaskTraceEvent alloc] initWithType:type
+                                                operationName:operationName
+                                                  enqueueTime:enqueueTime
+                                                    startTime:startTime
+                                                      endTime:endTime
+                                                     threadID:threadID]];
+}
+
+dispatch_block_t AWSTaskTracerWrapBlock(dispatch_block_t block,
+                                        AWSTaskTraceEventType type,
+                                        NSString *operationName) {
+    uint64_t enqueueTime = AWSTaskTracerCurrentTime();
+    return ^{
+        NSString *previousOperationName = AWSTaskTracerCurrentOperationName();
+        AWSTaskTracerSetCurrentOperationName(operationName);
+        uint64_t startTime = AWSTaskTracerCurrentTime();
+        block();
+        uint64_t endTime = AWSTaskTracerCurrentTime();
+        AWSTaskTracerSetCurrentOperationName(previousOperationName);
+        AWSTaskTracerRecordEvent(type, operationName, enqueueTime, startTime, endTime);
+    };
+}
+
+@implementation AWSTask (AWSTaskTracer)
+
+- (NSString *)aws_traceOperationName {
+    return objc_getAssociatedObject(self, &AWSTaskTraceOperationNameAssociationKey);
+}
+
+- (void)aws_setTraceOperationName:(NSString *)operationName {
+    objc_setAssociatedObject(self, &AWSTaskTraceOperationNameAssociationKey, operationName, OBJC_ASSOCIATION_COPY_NONATOMIC);
+}
+
+@end
+
+#pragma mark - AWSTaskTraceEvent
+
+@implementation AWSTaskTraceEvent
+
+- (instancetype)initWithType:(AWSTaskTraceEventType)type
+               operationName:(NSString *)operationName
+                 enqueueTime:(uint64_t)enqueueTime
+                   startTime:(uint64_t)startTime
+                     endTime:(uint64_t)endTime
+                    threadID:(uint64_t)threadID {
+    if (self = [super init]) {
+        _type = type;
+        _operationName = operationName;
+        _enqueueTime = enqueueTime;
+        _startTime = startTime;
+        _endTime = endTime;
+        _threadID = threadID;
+    }
+    return self;
+}
+
+- (NSString *)description {
+    return [NSString stringWithFormat:@"<%@: %p; type = %ld; operationName = %@; queued = %lluns; ran = %lluns; thread = %llu>",
+            NSStringFromClass([self class]),
+            self,
+            (long)self.type,
+            self.operationName,
+            self.startTime - self.enqueueTime,
+            self.endTime - self.startTime,
+            self.threadID];
+}
+
+@end
+
+#pragma mark - AWSTaskTracer
+
+@implementation AWSTaskTracer
+
++ (id<AWSTaskTraceSink>)sink {
+    pthread_mutex_lock(&AWSTaskTracerSinkLock);
+    id<AWSTaskTraceSink> sink = AWSTaskTracerCurrentSink;
+    pthread_mutex_unlock(&AWSTaskTracerSinkLock);
+    return sink;
+}
+
++ (void)setSink:(id<AWSTaskTraceSink>)sink {
+    pthread_mutex_lock(&AWSTaskTracerSinkLock);
+    AWSTaskTracerCurrentSink = sink;
+    atomic_store_explicit(&AWSTaskTracerEnabled, sink != nil, memory_order_relaxed);
+    pthread_mutex_unlock(&AWSTaskTracerSinkLock);
+}
+
++ (void)runWithOperationName:(NSString *)operationName block:(void (^)(void))block {
+    if (!AWSTaskTracerIsEnabled()) {
+        block();
+        return;
+    }
+    NSString *previousOperationName = AWSTaskTracerCurrentOperationName();
+    AWSTaskTracerSetCurrentOperationName(operationName);
+    block();
+    AWSTaskTracerSetCurrentOperationName(previousOperationName);
+}
+
++ (uint64_t)currentTime {
+    return AWSTaskTracerCurrentTime();
+}
+
+@end
+
+#pragma mark - AWSChromeTraceSink
+
+static const NSUInteger AWSChromeTraceSinkDefaultMaximumEventCount = 100000;
+
+@implementation AWSChromeTraceSink {
+    pthread_mutex_t _lock;
+    NSUInteger _maximumEventCount;
+    NSMutableArray<AWSTaskTraceEvent *> *_events;
+    NSUInteger _droppedEventCount;
+}
+
+- (instancetype)init {
+    return [self initWithMaximumEventCount:AWSChromeTraceSinkDefaultMaximumEventCount];
+}
+
+- (instancetype)initWithMaximumEventCount:(NSUInteger)maximumEventCount {
+    if (self = [super init]) {
+        pthread_mutex_init(&_lock, NULL);
+        _maximumEventCount = maximumEventCount;
+        _events = [NSMutableArray new];
+    }
+    return self;
+}
+
+- (void)dealloc {
+    pthread_mutex_destroy(&_lock);
+}
+
+- (void)recordEvent:(AWSTaskTraceEvent *)event {
+    pthread_mutex_lock(&_lock);
+    if ([_events count] < _maximumEventCount) {
+        [_events addObject:event];
+    } else {
+        _droppedEventCount++;
+    }
+    pthread_mutex_unlock(&_lock);
+}
+
+- (NSUInteger)droppedEventCount {
+    pthread_mutex_lock(&_lock);
+    NSUInteger droppedEventCount = _droppedEventCount;
+    pthread_mutex_unlock(&_lock);
+    return droppedEventCount;
+}
+
+- (NSArray<AWSTaskTraceEvent *> *)events {
+    pthread_mutex_lock(&_lock);
+    NSArray<AWSTaskTraceEvent *> *events = [_events copy];
+    pthread_mutex_unlock(&_lock);
+    return events;
+}
+
+- (void)reset {
+    pthread_mutex_lock(&_lock);
+    [_events removeAllObjects];
+    _droppedEventCount = 0;
+    pthread_mutex_unlock(&_lock);
+}
+
+- (NSData *)traceData {
+    NSArray<AWSTaskTraceEvent *> *events = [self events];
+    NSNumber *processID = @([[NSProcessInfo processInfo] processIdentifier]);
+    NSMutableArray *traceEvents = [NSMutableArray arrayWithCapacity:[events count]];
+    NSUInteger networkEventID = 0;
+    for (AWSTaskTraceEvent *event in events) {
+        // Trace event timestamps and durations are in microseconds.
+        NSString *name = event.operationName ?: @"(none)";
+        switch (event.type) {
+            case AWSTaskTraceEventTypeContinuation:
+            case AWSTaskTraceEventTypeExecution:
+                [traceEvents addObject:@{@"name" : name,
+                                         @"cat" : event.type == AWSTaskTraceEventTypeContinuation ? @"continuation" : @"execution",
+                                         @"ph" : @"X",
+                                         @"ts" : @(event.startTime / 1000.0),
+                                         @"dur" : @((event.endTime - event.startTime) / 1000.0),
+                                         @"pid" : processID,
+                                         @"tid" : @(event.threadID),
+                                         @"args" : @{@"queued_us" : @((event.startTime - event.enqueueTime) / 1000.0)}}];
+                break;
+            case AWSTaskTraceEventTypeNetwork:
+                // Requests overlap on a thread, so they are async events rather than complete events.
+                networkEventID++;
+                [traceEvents addObject:@{@"name" : name,
+                                         @"cat" : @"network",
+                                         @"ph" : @"b",
+                                         @"id" : @(networkEventID),
+                                         @"ts" : @(event.startTime / 1000.0),
+                                         @"pid" : processID,
+                                         @"tid" : @(event.threadID)}];
+                [traceEvents addObject:@{@"name" : name,
+                                         @"cat" : @"network",
+                                         @"ph" : @"e",
+                                         @"id" : @(networkEventID),
+                                         @"ts" : @(event.endTime / 1000.0),
+                                         @"pid" : processID,
+                                         @"tid" : @(event.threadID)}];
+                break;
+        }
+    }
+
+    return [NSJSONSerialization dataWithJSONObject:@{@"traceEvents" : traceEvents,
+                                                     @"displayTimeUnit" : @"ns",
+                                                     @"otherData" : @{@"droppedEventCount" : @([self droppedEventCount])}}
+                                           options:0
+                                             error:nil];
+}
+
+- (BOOL)writeToURL:(NSURL *)URL error:(NSError **)error {
+    return [[self traceData] writeToURL:URL options:NSDataWritingAtomic error:error];
+}
+
+@end
@@ -14,6 +14,7 @@
 //
 
 #import <AWSCore/AWSCore.h>
+#import "AWSFMDatabase.h"
 #import "AWSFMDatabasePool.h"
 #import "AWSFMDatabaseQueue.h"
 
@@ -32,6 +33,54 @@ NS_ASSUME_NONNULL_BEGIN
 
 + (instancetype)serialDatabaseQueueWithPath:(NSString*)aPath;
 
+/**
+ Opens a database queue for the local stores of the SDK (the Kinesis and Firehose recorders, the Pinpoint event recorder
+ and the S3 Transfer Utility), and applies the storage profile of `-[AWSFMDatabase aws_applyStoreProfile]` to it.
+
+ The connection is opened with the SQLITE_OPEN_NOMUTEX flag: it is only used on the serial queue of the database queue,
+ so SQLite does not need to lock it. Do not use the `AWSFMDatabase` of the queue outside of its blocks.
+
+ @param aPath The file path of the database.
+
+ @return The `FMDatabaseQueue` object. `nil` on error.
+ */
+
++ (instancetype)storeDatabaseQueueWithPath:(NSString*)aPath;
+
+@end
+
+@interface AWSFMDatabase (AWSHelpers)
+
+/**
+ Applies the storage profile of the SDK stores to an open database:
+
+ - The write-ahead log (`journal_mode = WAL`), so that a write appends to the log instead of copying pages to a rollback
+   journal, and readers do not block the writer.
+ - `synchronous = NORMAL`, which syncs the log to disk at checkpoints rather than at every commit. A commit can be lost
+   if the device loses power, but the database cannot be corrupted.
+ - `auto_vacuum = INCREMENTAL`, so that deleting rows does not move pages at every commit. Free pages are released by
+   `aws_releaseFreePagesIfNeeded`. A database created with `auto_vacuum = NONE` is vacuumed once to switch.
+ - A limit of the size of the log kept on disk after a checkpoint.
+ - Caching of prepared statements (`shouldCacheStatements`).
+
+ @return `YES` if the database uses the write-ahead log. The other settings are applied regardless.
+ */
+- (BOOL)aws_applyStoreProfile;
+
+/**
+ The number of bytes of the pages used by the tables and indexes of the database, which excludes the free pages and the
+ write-ahead log.
+ */
+- (unsigned long long)aws_usedByteCount;
+
+/**
+ Releases the free pages of a database using `auto_vacuum = INCREMENTAL` to the file system, when they take more than
+ a few hundred kilobytes. Call it after deleting rows.
+
+ @return `NO` on error.
+ */
+- (BOOL)aws_releaseFreePagesIfNeeded;
+
 @end
 
 
@@ -48,6 +97,27 @@ NS_ASSUME_NONNULL_BEGIN
 
 + (instancetype)serialDatabasePoolWithPath:(NSString*)aPath;
 
+/**
+ Creates a pool of read-only connections to the database of a database queue opened with
+ `+[AWSFMDatabaseQueue storeDatabaseQueueWithPath:]`.
+
+ With the write-ahead log, readers do not block the writer and are not blocked by it: a block of the pool reads the
+ database as it was committed when the block began, while the database queue keeps writing. Route the queries which do
+ not write, such as counting the stored records or listing them, to the pool, and keep the writes, and the reads which
+ decide a write, on the database queue.
+
+ A connection is opened for each block running at the same time, and kept open for the next blocks. The connections
+ cache their prepared statements, and refuse to write (`PRAGMA query_only`). Use `inDeferredTransaction:` to read
+ several queries from the same snapshot; `inTransaction:` would wait for the writer.
+
+ @param databaseQueue The database queue of the writer. It must be opened first, so that the database uses the
+ write-ahead log.
+
+ @return The `FMDatabasePool` object. `nil` if the database queue is `nil`.
+ */
+
++ (nullable instancetype)storeReaderPoolWithDatabaseQueue:(nullable AWSFMDatabaseQueue *)databaseQueue;
+
 @end
 
 NS_ASSUME_NONNULL_END
@@ -16,6 +16,47 @@
 #import <Foundation/Foundation.h>
 #import <sqlite3.h>
 #import "AWSFMDB+AWSHelpers.h"
+#import "AWSFMDatabaseAdditions.h"
+
+// The size of the write-ahead log kept on disk after a checkpoint.
+static const long long AWSFMDatabaseStoreJournalSizeLimit = 1024 * 1024;
+
+// The number of bytes of free pages above which they are released to the file system.
+static const unsigned long long AWSFMDatabaseStoreFreeByteCountLimit = 256 * 1024;
+
+// The values of `PRAGMA auto_vacuum`.
+typedef NS_ENUM(int, AWSFMDatabaseAutoVacuum) {
+    AWSFMDatabaseAutoVacuumNone = 0,
+    AWSFMDatabaseAutoVacuumFull = 1,
+    AWSFMDatabaseAutoVacuumIncremental = 2,
+};
+
+// Configures the connections of the reader pools, which have no other place to do it as they are opened lazily.
+@interface AWSFMDatabaseStoreReaderPoolDelegate : NSObject
+
++ (instancetype)sharedInstance;
+
+@end
+
+@implementation AWSFMDatabaseStoreReaderPoolDelegate
+
++ (instancetype)sharedInstance {
+    static AWSFMDatabaseStoreReaderPoolDelegate *_sharedInstance = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        _sharedInstance = [AWSFMDatabaseStoreReaderPoolDelegate new];
+    });
+    return _sharedInstance;
+}
+
+- (void)databasePool:(AWSFMDatabasePool*)pool didAddDatabase:(AWSFMDatabase*)database {
+    database.shouldCacheStatements = YES;
+    if (![database executeStatements:@"PRAGMA query_only = 1"]) {
+        AWSDDLogError(@"Failed to set 'query_only'. %@", database.lastError);
+    }
+}
+
+@end
 
 @implementation AWSFMDatabaseQueue (AWSHelpers)
 
@@ -27,6 +68,72 @@
                                                flags:flags];
 }
 
++ (instancetype)storeDatabaseQueueWithPath:(NSString*)aPath {
+    // The connection is only used on the serial queue of the database queue, so it does not need a mutex.
+    int flags = SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE | SQLITE_OPEN_NOMUTEX;
+    AWSFMDatabaseQueue *databaseQueue = [AWSFMDatabaseQueue databaseQueueWithPath:aPath
+                                                                            flags:flags];
+    [databaseQueue inDatabase:^(AWSFMDatabase *db) {
+        if (![db aws_applyStoreProfile]) {
+            AWSDDLogWarn(@"Failed to enable the write-ahead log of [%@]. %@", aPath, db.lastError);
+        }
+    }];
+    return databaseQueue;
+}
+
+@end
+
+@implementation AWSFMDatabase (AWSHelpers)
+
+- (BOOL)aws_applyStoreProfile {
+    self.shouldCacheStatements = YES;
+
+    // Switching to incremental auto vacuum from full auto vacuum takes effect right away, and from none takes a VACUUM
+    // of a database which has tables already.
+    int autoVacuum = [self intForQuery:@"PRAGMA auto_vacuum"];
+    if (autoVacuum != AWSFMDatabaseAutoVacuumIncremental) {
+        if (![self executeStatements:@"PRAGMA auto_vacuum = INCREMENTAL"]) {
+            AWSDDLogError(@"Failed to set 'auto_vacuum' to 'INCREMENTAL'. %@", self.lastError);
+        } else if (autoVacuum == AWSFMDatabaseAutoVacuumNone
+                   && [self intForQuery:@"SELECT COUNT(*) FROM sqlite_master"] > 0
+                   && ![self executeStatements:@"VACUUM"]) {
+            AWSDDLogError(@"SQLite error. [%@]", self.lastError);
+        }
+    }
+
+    NSString *journalMode = [self stringForQuery:@"PRAGMA journal_mode = WAL"];
+    if (![self executeStatements:@"PRAGMA synchronous = NORMAL"]) {
+        AWSDDLogError(@"Failed to set 'synchronous' to 'NORMAL'. %@", self.lastError);
+    }
+    if (![self executeStatements:[NSString stringWithFormat:@"PRAGMA journal_size_limit = %lld", AWSFMDatabaseStoreJournalSizeLimit]]) {
+        AWSDDLogError(@"Failed to set 'journal_size_limit'. %@", self.lastError);
+    }
+
+    return [[journalMode lowercaseString] isEqualToString:@"wal"];
+}
+
+- (unsigned long long)aws_usedByteCount {
+    unsigned long long pageCount = (unsigned long long)[self longForQuery:@"PRAGMA page_count"];
+    unsigned long long freePageCount = (unsigned long long)[self longForQuery:@"PRAGMA freelist_count"];
+    unsigned long long pageSize = (unsigned long long)[self longForQuery:@"PRAGMA page_size"];
+    return (pageCount > freePageCount ? pageCount - freePageCount : 0) * pageSize;
+}
+
+- (BOOL)aws_releaseFreePagesIfNeeded {
+    unsigned long long freePageCount = (unsigned long long)[self longForQuery:@"PRAGMA freelist_count"];
+    unsigned long long pageSize = (unsigned long long)[self longForQuery:@"PRAGMA page_size"];
+    if (freePageCount * pageSize <= AWSFMDatabaseStoreFreeByteCountLimit) {
+        return YES;
+    }
+
+    // `incremental_vacuum` returns a row per released page, which `executeStatements:` steps through.
+    if (![self executeStatements:@"PRAGMA incremental_vacuum"]) {
+        AWSDDLogError(@"SQLite error. [%@]", self.lastError);
+        return NO;
+    }
+    return YES;
+}
+
 @end
 
 @implementation AWSFMDatabasePool (AWSHelpers)
@@ -39,4 +146,19 @@
                                              flags:flags];
 }
 
++ (instancetype)storeReaderPoolWithDatabaseQueue:(AWSFMDatabaseQueue *)databaseQueue {
+    if (!databaseQueue) {
+        return nil;
+    }
+
+    // A connection of the pool is used by one block at a time, so it does not need a mutex either. The connections are
+    // opened read-write, because a read-only connection cannot recover the shared memory index of the write-ahead log
+    // when the writer is not open; `PRAGMA query_only` keeps them from writing.
+    int flags = SQLITE_OPEN_READWRITE | SQLITE_OPEN_NOMUTEX;
+    AWSFMDatabasePool *databasePool = [AWSFMDatabasePool databasePoolWithPath:databaseQueue.path
+                                                                        flags:flags];
+    databasePool.delegate = [AWSFMDatabaseStoreReaderPoolDelegate sharedInstance];
+    return databasePool;
+}
+
 @end
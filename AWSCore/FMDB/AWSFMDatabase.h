@@ -391,6 +391,43 @@ typedef int(^AWSFMDBExecuteStatementsCallbackBlock)(NSDictionary *resultsDiction
 
 - (BOOL)executeUpdate:(NSString*)sql withVAList: (va_list)args;
 
+/** Execute single update statement for many rows
+
+ This method prepares a single SQL update statement (e.g. an `INSERT`, or an `UPDATE` or `DELETE` of a single row) once, and executes it for each array of `argumentArrays`, binding the array to the `?` placeholders in the SQL by position. Each array must have one object per placeholder.
+
+ If the database is not in a transaction, the rows are executed in a single transaction, which is rolled back if one of them fails. Otherwise they are part of the current transaction, and the rows before the failed one are not undone.
+
+ @param sql The SQL to be performed, with `?` placeholders.
+
+ @param argumentArrays A `NSArray` of `NSArray` of objects to be used when binding values to the `?` placeholders in the SQL statement, one per execution of the statement.
+
+ @return `YES` upon success; `NO` upon failure. If failed, you can call `<lastError>`, `<lastErrorCode>`, or `<lastErrorMessage>` for diagnostic information regarding the failure.
+
+ @see executeUpdate:withArgumentsInArray:
+ @see executeUpdate:withValuesInTemporaryTable:
+ */
+
+- (BOOL)executeUpdate:(NSString*)sql withArgumentArrays:(NSArray<NSArray *> *)argumentArrays;
+
+/** Execute single update statement for a set of values
+
+ This method inserts `values` into the temporary table `aws_fmdb_values`, which has a single column `value`, executes `sql` once, and empties the table. Use it to update or delete many rows by key with one statement, instead of one statement per row:
+
+    [db executeUpdate:@"DELETE FROM record WHERE rowid IN aws_fmdb_values" withValuesInTemporaryTable:rowIds];
+
+ The values are inserted with `<executeUpdate:withArgumentArrays:>`. If the database is not in a transaction, the whole operation is executed in a single transaction.
+
+ @param sql The SQL to be performed, which selects the values from `aws_fmdb_values`. It has no `?` placeholders.
+
+ @param values A `NSArray` of objects to be inserted into `aws_fmdb_values`. Duplicated values are inserted once.
+
+ @return `YES` upon success; `NO` upon failure. If failed, you can call `<lastError>`, `<lastErrorCode>`, or `<lastErrorMessage>` for diagnostic information regarding the failure.
+
+ @see executeUpdate:withArgumentArrays:
+ */
+
+- (BOOL)executeUpdate:(NSString*)sql withValuesInTemporaryTable:(NSArray *)values;
+
 /** Execute multiple SQL statements
  
  This executes a series of SQL statements that are combined in a single string (e.g. the SQL generated by the `sqlite3` command line `.dump` command). This accepts no value parameters, but rather simply expects a single string with multiple SQL statements, each terminated with a semicolon. This uses `sqlite3_exec`. 
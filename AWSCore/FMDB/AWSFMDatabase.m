@@ -1151,6 +1151,163 @@ static int AWSFMDBDatabaseBusyHandler(void *f, int count) {
     return [self executeUpdate:sql withArgumentsInArray:arguments];
 }
 
+- (BOOL)executeUpdate:(NSString*)sql withArgumentArrays:(NSArray<NSArray *> *)argumentArrays {
+
+    if (!sql || [argumentArrays count] == 0) {
+        return YES;
+    }
+
+    if (![self databaseExists]) {
+        return NO;
+    }
+
+    if (_isExecutingStatement) {
+        [self warnInUse];
+        return NO;
+    }
+
+    // Outside of a transaction, every row would be committed, and synced, on its own.
+    BOOL ownsTransaction = sqlite3_get_autocommit(_db) != 0;
+    if (ownsTransaction && ![self beginTransaction]) {
+        return NO;
+    }
+
+    _isExecutingStatement = YES;
+
+    int rc                   = SQLITE_OK;
+    sqlite3_stmt *pStmt      = 0x00;
+    AWSFMStatement *cachedStmt  = 0x00;
+
+    if (_traceExecution) {
+        NSLog(@"%@ executeUpdate: %@ (%lu rows)", self, sql, (unsigned long)[argumentArrays count]);
+    }
+
+    if (_shouldCacheStatements) {
+        cachedStmt = [self cachedStatementForQuery:sql];
+        pStmt = cachedStmt ? [cachedStmt statement] : 0x00;
+        [cachedStmt reset];
+    }
+
+    if (!pStmt) {
+        rc = sqlite3_prepare_v2(_db, [sql UTF8String], -1, &pStmt, 0);
+
+        if (SQLITE_OK != rc) {
+            if (_logsErrors) {
+                NSLog(@"DB Error: %d \"%@\"", [self lastErrorCode], [self lastErrorMessage]);
+                NSLog(@"DB Query: %@", sql);
+                NSLog(@"DB Path: %@", _databasePath);
+            }
+
+            sqlite3_finalize(pStmt);
+            _isExecutingStatement = NO;
+
+            if (ownsTransaction) {
+                [self rollback];
+            }
+            return NO;
+        }
+    }
+
+    int queryCount = sqlite3_bind_parameter_count(pStmt);
+
+    for (NSArray *arguments in argumentArrays) {
+
+        if ((int)[arguments count] != queryCount) {
+            NSLog(@"Error: the bind count (%lu) is not correct for the # of variables in the query (%d) (%@) (executeUpdate)", (unsigned long)[arguments count], queryCount, sql);
+            rc = SQLITE_MISUSE;
+            break;
+        }
+
+        sqlite3_reset(pStmt);
+        sqlite3_clear_bindings(pStmt);
+
+        int idx = 0;
+        for (id obj in arguments) {
+            idx++;
+            [self bindObject:obj toColumn:idx inStatement:pStmt];
+        }
+
+        rc = sqlite3_step(pStmt);
+
+        if (SQLITE_DONE != rc) {
+            if (_logsErrors) {
+                NSLog(@"Error calling sqlite3_step (%d: %s) eu", rc, sqlite3_errmsg(_db));
+                NSLog(@"DB Query: %@", sql);
+            }
+            break;
+        }
+    }
+
+    if (_shouldCacheStatements && !cachedStmt) {
+        cachedStmt = [[AWSFMStatement alloc] init];
+
+        [cachedStmt setStatement:pStmt];
+
+        [self setCachedStatement:cachedStmt forQuery:sql];
+
+        AWSFMDBRelease(cachedStmt);
+    }
+
+    if (cachedStmt) {
+        [cachedStmt setUseCount:[cachedStmt useCount] + 1];
+        sqlite3_reset(pStmt);
+        sqlite3_clear_bindings(pStmt);
+    }
+    else {
+        sqlite3_finalize(pStmt);
+    }
+
+    _isExecutingStatement = NO;
+
+    if (ownsTransaction) {
+        if (rc == SQLITE_DONE) {
+            return [self commit];
+        }
+        [self rollback];
+    }
+
+    return (rc == SQLITE_DONE);
+}
+
+- (BOOL)executeUpdate:(NSString*)sql withValuesInTemporaryTable:(NSArray *)values {
+
+    if (!sql || [values count] == 0) {
+        return YES;
+    }
+
+    if (![self databaseExists]) {
+        return NO;
+    }
+
+    BOOL ownsTransaction = sqlite3_get_autocommit(_db) != 0;
+    if (ownsTransaction && ![self beginTransaction]) {
+        return NO;
+    }
+
+    NSMutableArray *argumentArrays = [NSMutableArray arrayWithCapacity:[values count]];
+    for (id value in values) {
+        [argumentArrays addObject:@[value]];
+    }
+
+    // The table has no column affinity, so that the values compare with the keys of any table the way they would in an `IN (...)` list.
+    BOOL success = ([self executeStatements:@"CREATE TEMP TABLE IF NOT EXISTS aws_fmdb_values (value PRIMARY KEY)"]
+                    && [self executeUpdate:@"INSERT OR IGNORE INTO aws_fmdb_values (value) VALUES (?)" withArgumentArrays:argumentArrays]
+                    && [self executeUpdate:sql]);
+
+    if (![self executeUpdate:@"DELETE FROM aws_fmdb_values"]) {
+        success = NO;
+    }
+
+    if (ownsTransaction) {
+        if (success) {
+            return [self commit];
+        }
+        [self rollback];
+    }
+
+    return success;
+}
+
 
 int AWSFMDBExecuteBulkSQLCallback(void *theBlockAsVoid, int columns, char **values, char **names); // shhh clang.
 int AWSFMDBExecuteBulkSQLCallback(void *theBlockAsVoid, int columns, char **values, char **names) {
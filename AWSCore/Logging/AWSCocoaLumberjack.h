@@ -79,6 +79,7 @@
 #import "AWSDDTTYLogger.h"
 #import "AWSDDASLLogger.h"
 #import "AWSDDFileLogger.h"
+#import "AWSDDBinaryFileLogger.h"
 #import "AWSDDOSLogger.h"
 
 // CLI
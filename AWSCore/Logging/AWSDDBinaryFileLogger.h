@@ -0,0 +1,72 @@
+//
+// Copyright 2010-2021 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License.
+// A copy of the License is located at
+//
+// http://aws.amazon.com/apache2.0
+//
+// or in the "license" file accompanying this file. This file is distributed
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+//
+
+#import <Foundation/Foundation.h>
+
+#import "AWSDDLog.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ * A logger which writes log messages to a file in a compact binary format, without formatting them.
+ *
+ * Set `defersFormatting` on the `AWSDDLog` the logger is added to. The messages of the log statements are then
+ * never formatted on the device (unless another logger needs them): the logger writes the format string of each
+ * log statement once, and the raw values of the arguments of each message.
+ * `Scripts/decode-binary-log.py` turns the files back into text.
+ *
+ * Messages which are already formatted, e.g. synchronous log statements, are written as text.
+ * The log formatter of the logger, if any, is only applied to them.
+ *
+ * The file starts with the 8 bytes `AWSDDBL\x01`, followed by records. Integers are little-endian, times are
+ * seconds since 1970 as a double, and strings are a 4 byte length followed by that many bytes of UTF-8.
+ * Each record starts with its type byte:
+ *
+ * - `0x01` Session: time. Starts the messages of a logger, which can append to a file from a previous session.
+ *   The site identifiers of the previous session do not apply anymore.
+ * - `0x02` Site: 4 byte site identifier, file, function, 4 byte line, format. Defines a log statement.
+ * - `0x03` Event: 4 byte site identifier, time, 4 byte flag, 8 byte context, thread ID, thread name, queue label,
+ *   4 byte length followed by the packed arguments. A message of a log statement.
+ * - `0x04` Text: time, 4 byte flag, 8 byte context, thread ID, thread name, queue label, file, function,
+ *   4 byte line, message. A message which was already formatted.
+ *
+ * The packed arguments are, in the order of the conversions of the format string (including `*` widths and
+ * precisions), a type byte followed by the value:
+ *
+ * - `i` a signed integer, 8 bytes (`d`, `i`, `D`, `c`, `*`)
+ * - `u` an unsigned integer, 8 bytes (`o`, `u`, `x`, `X`, `O`, `U`, `C`)
+ * - `f` a double, 8 bytes (`e`, `E`, `f`, `F`, `g`, `G`, `a`, `A`)
+ * - `p` a pointer, 8 bytes (`p`)
+ * - `s` a string (`s`, `S`, `@`)
+ **/
+@interface AWSDDBinaryFileLogger : AWSDDAbstractLogger <AWSDDLogger>
+
+- (instancetype)init NS_UNAVAILABLE;
+
+/**
+ *  Designated initializer. The file is created if needed, and appended to otherwise.
+ *
+ *  @param logFilePath the path of the log file
+ */
+- (instancetype)initWithLogFilePath:(NSString *)logFilePath NS_DESIGNATED_INITIALIZER;
+
+/**
+ *  The path of the log file
+ */
+@property (nonatomic, readonly, copy) NSString *logFilePath;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,245 @@
+//
+// Copyright 2010-2021 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License.
+// A copy of the License is located at
+//
+// http://aws.amazon.com/apache2.0
+//
+// or in the "license" file accompanying this file. This file is distributed
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+//
+
+#import "AWSDDBinaryFileLogger.h"
+
+// We use primitive logging macros around NSLog, as the logger cannot log through AWSDDLog itself.
+
+#ifndef AWSDD_NSLOG_LEVEL
+    #define AWSDD_NSLOG_LEVEL 2
+#endif
+
+#define NSLogError(frmt, ...)    do{ if(AWSDD_NSLOG_LEVEL >= 1) NSLog((frmt), ##__VA_ARGS__); } while(0)
+
+static const uint8_t AWSDDBinaryFileLoggerHeader[8] = {'A', 'W', 'S', 'D', 'D', 'B', 'L', 0x01};
+
+typedef NS_ENUM(uint8_t, AWSDDBinaryFileLoggerRecordType) {
+    AWSDDBinaryFileLoggerRecordTypeSession = 0x01,
+    AWSDDBinaryFileLoggerRecordTypeSite = 0x02,
+    AWSDDBinaryFileLoggerRecordTypeEvent = 0x03,
+    AWSDDBinaryFileLoggerRecordTypeText = 0x04,
+};
+
+// A log statement: the format string, and where it is.
+@interface AWSDDBinaryFileLoggerSite : NSObject
+
+@property (nonatomic, strong) NSString *format;
+@property (nonatomic, strong) NSString *file;
+@property (nonatomic, strong) NSString *function;
+@property (nonatomic, assign) NSUInteger line;
+@property (nonatomic, assign) uint32_t identifier;
+
+@end
+
+@implementation AWSDDBinaryFileLoggerSite
+
+@end
+
+@implementation AWSDDBinaryFileLogger {
+    NSFileHandle *_fileHandle;
+    NSMutableData *_buffer;
+    // The sites of the session, by the address of their format string.
+    // Retaining the format strings keeps their addresses from being reused.
+    NSMapTable<NSString *, NSMutableArray<AWSDDBinaryFileLoggerSite *> *> *_sites;
+    uint32_t _nextSiteIdentifier;
+}
+
+- (instancetype)initWithLogFilePath:(NSString *)logFilePath {
+    if (self = [super init]) {
+        _logFilePath = [logFilePath copy];
+        _buffer = [NSMutableData new];
+        _sites = [NSMapTable mapTableWithKeyOptions:NSPointerFunctionsStrongMemory | NSPointerFunctionsObjectPointerPersonality
+                                       valueOptions:NSPointerFunctionsStrongMemory];
+    }
+    return self;
+}
+
+- (void)dealloc {
+    [_fileHandle synchronizeFile];
+    [_fileHandle closeFile];
+}
+
+#pragma mark - Writing
+
+static void AWSDDBinaryFileLoggerAppendUInt8(NSMutableData *data, uint8_t value) {
+    [data appendBytes:&value length:sizeof(value)];
+}
+
+static void AWSDDBinaryFileLoggerAppendUInt32(NSMutableData *data, uint32_t value) {
+    value = CFSwapInt32HostToLittle(value);
+    [data appendBytes:&value length:sizeof(value)];
+}
+
+static void AWSDDBinaryFileLoggerAppendUInt64(NSMutableData *data, uint64_t value) {
+    value = CFSwapInt64HostToLittle(value);
+    [data appendBytes:&value length:sizeof(value)];
+}
+
+static void AWSDDBinaryFileLoggerAppendTime(NSMutableData *data, NSDate *date) {
+    double time = [date timeIntervalSince1970];
+    uint64_t bits;
+    memcpy(&bits, &time, sizeof(bits));
+    AWSDDBinaryFileLoggerAppendUInt64(data, bits);
+}
+
+static void AWSDDBinaryFileLoggerAppendString(NSMutableData *data, NSString *string) {
+    const char *bytes = [string UTF8String] ?: "";
+    uint32_t length = (uint32_t)strlen(bytes);
+    AWSDDBinaryFileLoggerAppendUInt32(data, length);
+    [data appendBytes:bytes length:length];
+}
+
+static void AWSDDBinaryFileLoggerAppendContext(NSMutableData *data, AWSDDLogMessage *logMessage) {
+    AWSDDBinaryFileLoggerAppendTime(data, logMessage->_timestamp);
+    AWSDDBinaryFileLoggerAppendUInt32(data, (uint32_t)logMessage->_flag);
+    AWSDDBinaryFileLoggerAppendUInt64(data, (uint64_t)(int64_t)logMessage->_context);
+    AWSDDBinaryFileLoggerAppendString(data, logMessage->_threadID);
+    AWSDDBinaryFileLoggerAppendString(data, logMessage->_threadName);
+    AWSDDBinaryFileLoggerAppendString(data, logMessage->_queueLabel);
+}
+
+- (NSFileHandle *)fileHandle {
+    if (_fileHandle) {
+        return _fileHandle;
+    }
+
+    NSFileManager *fileManager = [NSFileManager defaultManager];
+    if (![fileManager fileExistsAtPath:_logFilePath]) {
+        [fileManager createDirectoryAtPath:[_logFilePath stringByDeletingLastPathComponent]
+               withIntermediateDirectories:YES
+                                attributes:nil
+                                     error:nil];
+        [fileManager createFileAtPath:_logFilePath contents:nil attributes:nil];
+    }
+
+    _fileHandle = [NSFileHandle fileHandleForWritingAtPath:_logFilePath];
+    if (!_fileHandle) {
+        NSLogError(@"AWSDDBinaryFileLogger: Failed to open %@", _logFilePath);
+        return nil;
+    }
+
+    NSMutableData *data = [NSMutableData data];
+    if ([_fileHandle seekToEndOfFile] == 0) {
+        [data appendBytes:AWSDDBinaryFileLoggerHeader length:sizeof(AWSDDBinaryFileLoggerHeader)];
+    }
+    AWSDDBinaryFileLoggerAppendUInt8(data, AWSDDBinaryFileLoggerRecordTypeSession);
+    AWSDDBinaryFileLoggerAppendTime(data, [NSDate date]);
+    [_fileHandle writeData:data];
+
+    return _fileHandle;
+}
+
+- (uint32_t)siteIdentifierForLogMessage:(AWSDDLogMessage *)logMessage {
+    NSMutableArray<AWSDDBinaryFileLoggerSite *> *sites = [_sites objectForKey:logMessage->_format];
+    for (AWSDDBinaryFileLoggerSite *site in sites) {
+        if (site.line == logMessage->_line && [site.file isEqualToString:logMessage->_file]) {
+            return site.identifier;
+        }
+    }
+
+    AWSDDBinaryFileLoggerSite *site = [AWSDDBinaryFileLoggerSite new];
+    site.format = logMessage->_format;
+    site.file = logMessage->_file;
+    site.function = logMessage->_function;
+    site.line = logMessage->_line;
+    site.identifier = _nextSiteIdentifier++;
+    if (!sites) {
+        sites = [NSMutableArray arrayWithCapacity:1];
+        [_sites setObject:sites forKey:logMessage->_format];
+    }
+    [sites addObject:site];
+
+    AWSDDBinaryFileLoggerAppendUInt8(_buffer, AWSDDBinaryFileLoggerRecordTypeSite);
+    AWSDDBinaryFileLoggerAppendUInt32(_buffer, site.identifier);
+    AWSDDBinaryFileLoggerAppendString(_buffer, site.file);
+    AWSDDBinaryFileLoggerAppendString(_buffer, site.function);
+    AWSDDBinaryFileLoggerAppendUInt32(_buffer, (uint32_t)site.line);
+    AWSDDBinaryFileLoggerAppendString(_buffer, site.format);
+
+    return site.identifier;
+}
+
+- (void)appendLogMessage:(AWSDDLogMessage *)logMessage {
+    if (logMessage->_format) {
+        uint32_t siteIdentifier = [self siteIdentifierForLogMessage:logMessage];
+        AWSDDBinaryFileLoggerAppendUInt8(_buffer, AWSDDBinaryFileLoggerRecordTypeEvent);
+        AWSDDBinaryFileLoggerAppendUInt32(_buffer, siteIdentifier);
+        AWSDDBinaryFileLoggerAppendContext(_buffer, logMessage);
+        AWSDDBinaryFileLoggerAppendUInt32(_buffer, (uint32_t)[logMessage->_arguments length]);
+        [_buffer appendData:logMessage->_arguments];
+        return;
+    }
+
+    NSString *message = _logFormatter ? [_logFormatter formatLogMessage:logMessage] : logMessage->_message;
+    if (!message) {
+        return;
+    }
+    AWSDDBinaryFileLoggerAppendUInt8(_buffer, AWSDDBinaryFileLoggerRecordTypeText);
+    AWSDDBinaryFileLoggerAppendContext(_buffer, logMessage);
+    AWSDDBinaryFileLoggerAppendString(_buffer, logMessage->_file);
+    AWSDDBinaryFileLoggerAppendString(_buffer, logMessage->_function);
+    AWSDDBinaryFileLoggerAppendUInt32(_buffer, (uint32_t)logMessage->_line);
+    AWSDDBinaryFileLoggerAppendString(_buffer, message);
+}
+
+#pragma mark - AWSDDLogger
+
+- (BOOL)acceptsUnformattedMessages {
+    return YES;
+}
+
+- (void)logMessage:(AWSDDLogMessage *)logMessage {
+    [self logMessages:@[logMessage]];
+}
+
+- (void)logMessages:(NSArray<AWSDDLogMessage *> *)logMessages {
+    NSFileHandle *fileHandle = [self fileHandle];
+    if (!fileHandle) {
+        return;
+    }
+
+    [_buffer setLength:0];
+    for (AWSDDLogMessage *logMessage in logMessages) {
+        [self appendLogMessage:logMessage];
+    }
+
+    @try {
+        [fileHandle writeData:_buffer];
+    } @catch (NSException *exception) {
+        NSLogError(@"AWSDDBinaryFileLogger: %@", exception);
+    }
+}
+
+- (void)flush {
+    @try {
+        [_fileHandle synchronizeFile];
+    } @catch (NSException *exception) {
+        NSLogError(@"AWSDDBinaryFileLogger: %@", exception);
+    }
+}
+
+- (void)willRemoveLogger {
+    [self flush];
+    [_fileHandle closeFile];
+    _fileHandle = nil;
+    [_sites removeAllObjects];
+    _nextSiteIdentifier = 0;
+}
+
+- (NSString *)loggerName {
+    return @"cocoa.lumberjack.binaryFileLogger";
+}
+
+@end
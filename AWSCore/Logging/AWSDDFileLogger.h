@@ -33,6 +33,8 @@
 // rollingFrequency        -> kAWSDDDefaultLogRollingFrequency
 // maximumNumberOfLogFiles -> kAWSDDDefaultLogMaxNumLogFiles
 // logFilesDiskQuota       -> kAWSDDDefaultLogFilesDiskQuota
+// bufferSize              -> kAWSDDDefaultLogBufferSize
+// flushInterval           -> kAWSDDDefaultLogFlushInterval
 //
 // You should carefully consider the proper configuration values for your application.
 
@@ -40,6 +42,8 @@ extern unsigned long long const kAWSDDDefaultLogMaxFileSize;
 extern NSTimeInterval     const kAWSDDDefaultLogRollingFrequency;
 extern NSUInteger         const kAWSDDDefaultLogMaxNumLogFiles;
 extern unsigned long long const kAWSDDDefaultLogFilesDiskQuota;
+extern NSUInteger         const kAWSDDDefaultLogBufferSize;
+extern NSTimeInterval     const kAWSDDDefaultLogFlushInterval;
 
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -248,6 +252,26 @@ extern unsigned long long const kAWSDDDefaultLogFilesDiskQuota;
  **/
 - (BOOL)isLogFile:(NSString *)fileName NS_SWIFT_NAME(isLogFile(withName:));
 
+/**
+ * When set, log files are compressed with gzip in the background once they are archived,
+ * e.g. `com.organization.myapp 2013-12-03 17-14.log` becomes `com.organization.myapp 2013-12-03 17-14.log.gz`.
+ * The compressed files keep the creation date of the log file, and count towards `logFilesDiskQuota`
+ * with their compressed size.
+ *
+ * Default value is NO.
+ **/
+@property (readwrite, assign, atomic) BOOL compressesArchivedLogFiles;
+
+/**
+ * The log file manager keeps a sorted index of the log files, so that it does not need to list and examine
+ * the logs directory each time a log file is created.
+ * The index is updated as log files are created, archived, compressed and deleted, and is rebuilt when
+ * the contents of the logs directory change otherwise.
+ *
+ * If you modify the log files in place, invoke this method so that the index is rebuilt.
+ **/
+- (void)invalidateLogFileIndex;
+
 /* Inherited from AWSDDLogFileManager protocol:
 
    @property (readwrite, assign, atomic) NSUInteger maximumNumberOfLogFiles;
@@ -393,6 +417,38 @@ extern unsigned long long const kAWSDDDefaultLogFilesDiskQuota;
  **/
 @property (nonatomic, readwrite, assign) BOOL automaticallyAppendNewlineForCustomFormatters;
 
+/**
+ * Log Buffering:
+ *
+ * `bufferSize`
+ *   The approximate number of bytes of log messages to collect in memory before they are written to the log file.
+ *   Writing many log messages at once is much cheaper than writing each of them on its own.
+ *   The default value, zero, writes the log messages as they are logged.
+ *
+ * `flushInterval`
+ *   The longest time log messages stay in memory. Once this time has passed since the first of the messages
+ *   was logged, they are written to the log file.
+ *
+ * `flushLogLevel`
+ *   Log messages with any of these flags are written to the log file right away,
+ *   together with the log messages logged before them. Default value is `AWSDDLogLevelError`.
+ *
+ * The log messages in memory are also written to the log file when the log is flushed (see `[AWSDDLog flushLog]`),
+ * when the log file is rolled and when the logger is removed.
+ * Log messages which are still in memory are lost if the application crashes.
+ **/
+@property (readwrite, assign) NSUInteger bufferSize;
+
+/**
+ *  See description for `bufferSize`
+ */
+@property (readwrite, assign, atomic) NSTimeInterval flushInterval;
+
+/**
+ *  See description for `bufferSize`
+ */
+@property (readwrite, assign, atomic) AWSDDLogLevel flushLogLevel;
+
 /**
  *  You can optionally force the current log file to be rolled with this method.
  *  CompletionBlock will be called on main queue.
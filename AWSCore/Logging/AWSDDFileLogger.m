@@ -14,6 +14,7 @@
 //   prior written permission of Deusty, LLC.
 
 #import "AWSDDFileLogger.h"
+#import "AWSGZIP.h"
 
 #import <unistd.h>
 #import <sys/attr.h>
@@ -50,6 +51,10 @@ unsigned long long const kAWSDDDefaultLogMaxFileSize      = 1024 * 1024;      //
 NSTimeInterval     const kAWSDDDefaultLogRollingFrequency = 60 * 60 * 24;     // 24 Hours
 NSUInteger         const kAWSDDDefaultLogMaxNumLogFiles   = 5;                // 5 Files
 unsigned long long const kAWSDDDefaultLogFilesDiskQuota   = 20 * 1024 * 1024; // 20 MB
+NSUInteger         const kAWSDDDefaultLogBufferSize       = 0;                // Not buffered
+NSTimeInterval     const kAWSDDDefaultLogFlushInterval    = 1;                // 1 Second
+
+static NSString * const kAWSDDCompressedLogFileExtension = @"gz";
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 #pragma mark -
@@ -62,10 +67,17 @@ unsigned long long const kAWSDDDefaultLogFilesDiskQuota   = 20 * 1024 * 1024; //
 #if TARGET_OS_IPHONE
     NSString *_defaultFileProtectionLevel;
 #endif
+
+    // The log files, newest first. Guarded by @synchronized (self).
+    NSMutableArray<AWSDDLogFileInfo *> *_logFileIndex;
+    NSDate *_logFileIndexDirectoryModificationDate;
+
+    dispatch_queue_t _compressionQueue;
 }
 
 - (void)deleteOldLogFiles;
 - (NSString *)defaultLogsDirectory;
+- (NSMutableArray<AWSDDLogFileInfo *> *)logFileIndex;
 
 @end
 
@@ -90,6 +102,9 @@ unsigned long long const kAWSDDDefaultLogFilesDiskQuota   = 20 * 1024 * 1024; //
             _logsDirectory = [[self defaultLogsDirectory] copy];
         }
 
+        _compressionQueue = dispatch_queue_create("cocoa.lumberjack.logFileCompression", DISPATCH_QUEUE_SERIAL);
+        dispatch_set_target_queue(_compressionQueue, dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_BACKGROUND, 0));
+
         NSKeyValueObservingOptions kvoOptions = NSKeyValueObservingOptionOld | NSKeyValueObservingOptionNew;
 
         [self addObserver:self forKeyPath:NSStringFromSelector(@selector(maximumNumberOfLogFiles)) options:kvoOptions context:nil];
@@ -175,7 +190,14 @@ unsigned long long const kAWSDDDefaultLogFilesDiskQuota   = 20 * 1024 * 1024; //
 - (void)deleteOldLogFiles {
     NSLogVerbose(@"AWSDDLogFileManagerDefault: deleteOldLogFiles");
 
-    NSArray *sortedLogFileInfos = [self sortedLogFileInfos];
+    @synchronized (self) {
+        [self deleteOldLogFilesFromIndex:[self logFileIndex]];
+    }
+}
+
+- (void)deleteOldLogFilesFromIndex:(NSMutableArray<AWSDDLogFileInfo *> *)sortedLogFileInfos {
+    // The most recent log file may still be written to, so its size may have changed.
+    [sortedLogFileInfos.firstObject reset];
 
     NSUInteger firstIndexToDelete = NSNotFound;
 
@@ -220,7 +242,7 @@ unsigned long long const kAWSDDDefaultLogFilesDiskQuota   = 20 * 1024 * 1024; //
         }
     }
 
-    if (firstIndexToDelete != NSNotFound) {
+    if (firstIndexToDelete < sortedLogFileInfos.count) {
         // removing all logfiles starting with firstIndexToDelete
 
         for (NSUInteger i = firstIndexToDelete; i < sortedLogFileInfos.count; i++) {
@@ -230,6 +252,132 @@ unsigned long long const kAWSDDDefaultLogFilesDiskQuota   = 20 * 1024 * 1024; //
 
             [[NSFileManager defaultManager] removeItemAtPath:logFileInfo.filePath error:nil];
         }
+
+        [sortedLogFileInfos removeObjectsInRange:NSMakeRange(firstIndexToDelete, sortedLogFileInfos.count - firstIndexToDelete)];
+        [self didChangeLogFileIndex];
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+#pragma mark Log File Index
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+- (NSDate *)logsDirectoryModificationDate {
+    return [[NSFileManager defaultManager] attributesOfItemAtPath:[self logsDirectory] error:nil][NSFileModificationDate];
+}
+
+/**
+ * Returns the log files, newest first. Must be invoked within @synchronized (self).
+ *
+ * The index is only rebuilt, by listing the logs directory, if the directory was changed since the index was last
+ * updated. Methods updating the index must invoke didChangeLogFileIndex afterwards.
+ **/
+- (NSMutableArray<AWSDDLogFileInfo *> *)logFileIndex {
+    NSDate *modificationDate = [self logsDirectoryModificationDate];
+
+    if (_logFileIndex == nil || modificationDate == nil || ![modificationDate isEqualToDate:_logFileIndexDirectoryModificationDate]) {
+        NSLogVerbose(@"AWSDDLogFileManagerDefault: Building log file index");
+
+        NSArray *unsortedLogFileInfos = [self unsortedLogFileInfos];
+
+        _logFileIndex = [[unsortedLogFileInfos sortedArrayUsingSelector:@selector(reverseCompareByCreationDate:)] mutableCopy];
+        _logFileIndexDirectoryModificationDate = modificationDate;
+    }
+
+    return _logFileIndex;
+}
+
+- (void)didChangeLogFileIndex {
+    _logFileIndexDirectoryModificationDate = [self logsDirectoryModificationDate];
+}
+
+- (void)invalidateLogFileIndex {
+    @synchronized (self) {
+        _logFileIndex = nil;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+#pragma mark Compression
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+- (void)didArchiveLogFile:(NSString *)logFilePath {
+    [self compressLogFileInBackground:logFilePath];
+}
+
+- (void)didRollAndArchiveLogFile:(NSString *)logFilePath {
+    [self compressLogFileInBackground:logFilePath];
+}
+
+- (void)compressLogFileInBackground:(NSString *)logFilePath {
+    if (!self.compressesArchivedLogFiles || [[logFilePath pathExtension] isEqualToString:kAWSDDCompressedLogFileExtension]) {
+        return;
+    }
+
+    dispatch_async(_compressionQueue, ^{ @autoreleasepool {
+        [self compressLogFile:logFilePath];
+    } });
+}
+
+- (void)compressLogFile:(NSString *)logFilePath {
+    NSLogVerbose(@"AWSDDLogFileManagerDefault: Compressing log file: %@", logFilePath);
+
+    NSFileManager *fileManager = [NSFileManager defaultManager];
+    NSError *error = nil;
+
+    NSDictionary *attributes = [fileManager attributesOfItemAtPath:logFilePath error:&error];
+    NSData *data = attributes ? [NSData dataWithContentsOfFile:logFilePath options:NSDataReadingMappedIfSafe error:&error] : nil;
+
+    if (data == nil) {
+        NSLogWarn(@"AWSDDLogFileManagerDefault: Error reading log file to compress (%@): %@", logFilePath, error);
+        return;
+    }
+
+    NSData *compressedData = [data awsgzip_gzippedData];
+
+    if (compressedData == nil) {
+        NSLogError(@"AWSDDLogFileManagerDefault: Error compressing log file: %@", logFilePath);
+        return;
+    }
+
+    NSString *compressedFilePath = [logFilePath stringByAppendingPathExtension:kAWSDDCompressedLogFileExtension];
+
+    @synchronized (self) {
+        NSMutableArray<AWSDDLogFileInfo *> *sortedLogFileInfos = [self logFileIndex];
+        NSUInteger index = [sortedLogFileInfos indexOfObject:[[AWSDDLogFileInfo alloc] initWithFilePath:logFilePath]];
+
+        if (index == NSNotFound) {
+            // The log file was deleted while it was compressed.
+            return;
+        }
+
+        if (![compressedData writeToFile:compressedFilePath options:NSDataWritingAtomic error:&error]) {
+            NSLogError(@"AWSDDLogFileManagerDefault: Error writing compressed log file (%@): %@", compressedFilePath, error);
+            [self didChangeLogFileIndex];
+            return;
+        }
+
+        // The compressed log file takes the place of the log file when the log files are sorted.
+        NSMutableDictionary *compressedAttributes = [NSMutableDictionary dictionary];
+        compressedAttributes[NSFileCreationDate] = attributes[NSFileCreationDate];
+        compressedAttributes[NSFileModificationDate] = attributes[NSFileModificationDate];
+    #if TARGET_OS_IPHONE
+        compressedAttributes[NSFileProtectionKey] = attributes[NSFileProtectionKey];
+    #endif
+
+        if (![fileManager setAttributes:compressedAttributes ofItemAtPath:compressedFilePath error:&error]) {
+            NSLogWarn(@"AWSDDLogFileManagerDefault: Error setting attributes of compressed log file (%@): %@", compressedFilePath, error);
+        }
+
+        AWSDDLogFileInfo *compressedLogFileInfo = [[AWSDDLogFileInfo alloc] initWithFilePath:compressedFilePath];
+        compressedLogFileInfo.isArchived = YES;
+
+        if (![fileManager removeItemAtPath:logFilePath error:&error]) {
+            NSLogError(@"AWSDDLogFileManagerDefault: Error deleting log file after compressing it (%@): %@", logFilePath, error);
+        }
+
+        sortedLogFileInfos[index] = compressedLogFileInfo;
+        [self didChangeLogFileIndex];
     }
 }
 
@@ -343,20 +491,24 @@ unsigned long long const kAWSDDDefaultLogFilesDiskQuota   = 20 * 1024 * 1024; //
     for (NSString *fileName in fileNames) {
         // Filter out any files that aren't log files. (Just for extra safety)
 
+        // Compressed log files are named after the log file with an added 'gz' extension.
+        // isLogFile: method knows nothing about it. Thus removing it for this method.
+        NSString *theFileName = fileName;
+
+        if ([[theFileName pathExtension] isEqualToString:kAWSDDCompressedLogFileExtension]) {
+            theFileName = [theFileName stringByDeletingPathExtension];
+        }
+
     #if TARGET_IPHONE_SIMULATOR
         // In case of iPhone simulator there can be 'archived' extension. isLogFile:
         // method knows nothing about it. Thus removing it for this method.
         //
         // See full explanation in the header file.
-        NSString *theFileName = [fileName stringByReplacingOccurrencesOfString:@".archived"
-                                                                    withString:@""];
-
-        if ([self isLogFile:theFileName])
-    #else
-
-        if ([self isLogFile:fileName])
+        theFileName = [theFileName stringByReplacingOccurrencesOfString:@".archived"
+                                                             withString:@""];
     #endif
-        {
+
+        if ([self isLogFile:theFileName]) {
             NSString *filePath = [logsDirectory stringByAppendingPathComponent:fileName];
 
             [unsortedLogFilePaths addObject:filePath];
@@ -417,7 +569,20 @@ unsigned long long const kAWSDDDefaultLogFilesDiskQuota   = 20 * 1024 * 1024; //
 }
 
 - (NSArray *)sortedLogFileInfos {
-    return [[self unsortedLogFileInfos] sortedArrayUsingSelector:@selector(reverseCompareByCreationDate:)];
+    NSMutableArray *sortedLogFileInfos = nil;
+
+    @synchronized (self) {
+        NSArray *logFileIndex = [self logFileIndex];
+
+        sortedLogFileInfos = [NSMutableArray arrayWithCapacity:[logFileIndex count]];
+
+        for (AWSDDLogFileInfo *logFileInfo in logFileIndex) {
+            // New instances, so that the attributes are read again from the files.
+            [sortedLogFileInfos addObject:[[AWSDDLogFileInfo alloc] initWithFilePath:logFileInfo.filePath]];
+        }
+    }
+
+    return sortedLogFileInfos;
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -454,8 +619,10 @@ unsigned long long const kAWSDDDefaultLogFilesDiskQuota   = 20 * 1024 * 1024; //
         }
 
         NSString *filePath = [logsDirectory stringByAppendingPathComponent:actualFileName];
+        NSString *compressedFilePath = [filePath stringByAppendingPathExtension:kAWSDDCompressedLogFileExtension];
 
-        if (![[NSFileManager defaultManager] fileExistsAtPath:filePath]) {
+        if (![[NSFileManager defaultManager] fileExistsAtPath:filePath] &&
+            ![[NSFileManager defaultManager] fileExistsAtPath:compressedFilePath]) {
             NSLogVerbose(@"AWSDDLogFileManagerDefault: Creating new log file: %@", actualFileName);
 
             NSDictionary *attributes = nil;
@@ -475,7 +642,16 @@ unsigned long long const kAWSDDDefaultLogFilesDiskQuota   = 20 * 1024 * 1024; //
             };
         #endif
 
-            [[NSFileManager defaultManager] createFileAtPath:filePath contents:nil attributes:attributes];
+            @synchronized (self) {
+                NSMutableArray<AWSDDLogFileInfo *> *sortedLogFileInfos = [self logFileIndex];
+
+                [[NSFileManager defaultManager] createFileAtPath:filePath contents:nil attributes:attributes];
+
+                // The previous log file is not written to anymore.
+                [sortedLogFileInfos.firstObject reset];
+                [sortedLogFileInfos insertObject:[[AWSDDLogFileInfo alloc] initWithFilePath:filePath] atIndex:0];
+                [self didChangeLogFileIndex];
+            }
 
             // Since we just created a new log file, we may need to delete some old log files
             [self deleteOldLogFiles];
@@ -564,11 +740,20 @@ unsigned long long const kAWSDDDefaultLogFilesDiskQuota   = 20 * 1024 * 1024; //
     
     unsigned long long _maximumFileSize;
     NSTimeInterval _rollingFrequency;
+
+    // The size of the current log file, not counting the log messages in _logBuffer.
+    unsigned long long _currentLogFileSize;
+
+    NSMutableData *_logBuffer;
+    NSUInteger _bufferSize;
+    dispatch_source_t _flushTimer;
+    BOOL _flushTimerScheduled;
 }
 
 - (void)rollLogFileNow;
 - (void)maybeRollLogFileDueToAge;
 - (void)maybeRollLogFileDueToSize;
+- (void)flushLogBuffer;
 
 @end
 
@@ -585,6 +770,10 @@ unsigned long long const kAWSDDDefaultLogFilesDiskQuota   = 20 * 1024 * 1024; //
         _maximumFileSize = kAWSDDDefaultLogMaxFileSize;
         _rollingFrequency = kAWSDDDefaultLogRollingFrequency;
         _automaticallyAppendNewlineForCustomFormatters = YES;
+        _bufferSize = kAWSDDDefaultLogBufferSize;
+        _flushInterval = kAWSDDDefaultLogFlushInterval;
+        _flushLogLevel = AWSDDLogLevelError;
+        _logBuffer = [NSMutableData new];
 
         logFileManager = aLogFileManager;
 
@@ -595,9 +784,16 @@ unsigned long long const kAWSDDDefaultLogFilesDiskQuota   = 20 * 1024 * 1024; //
 }
 
 - (void)dealloc {
+    [self flushLogBuffer];
+
     [_currentLogFileHandle synchronizeFile];
     [_currentLogFileHandle closeFile];
 
+    if (_flushTimer) {
+        dispatch_source_cancel(_flushTimer);
+        _flushTimer = NULL;
+    }
+
     if (_currentLogFileVnode) {
         dispatch_source_cancel(_currentLogFileVnode);
         _currentLogFileVnode = NULL;
@@ -614,6 +810,8 @@ unsigned long long const kAWSDDDefaultLogFilesDiskQuota   = 20 * 1024 * 1024; //
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 @synthesize logFileManager;
+@synthesize flushInterval = _flushInterval;
+@synthesize flushLogLevel = _flushLogLevel;
 
 - (unsigned long long)maximumFileSize {
     __block unsigned long long result;
@@ -729,6 +927,58 @@ unsigned long long const kAWSDDDefaultLogFilesDiskQuota   = 20 * 1024 * 1024; //
     });
 }
 
+- (NSUInteger)bufferSize {
+    __block NSUInteger result;
+
+    dispatch_block_t block = ^{
+        result = self->_bufferSize;
+    };
+
+    // The design of this method is taken from the AWSDDAbstractLogger implementation.
+    // For extensive documentation please refer to the AWSDDAbstractLogger implementation.
+
+    // Note: The internal implementation MUST access the bufferSize variable directly,
+    // This method is designed explicitly for external access.
+
+    NSAssert(![self isOnGlobalLoggingQueue], @"Core architecture requirement failure");
+    NSAssert(![self isOnInternalLoggerQueue], @"MUST access ivar directly, NOT via self.* syntax.");
+
+    dispatch_queue_t globalLoggingQueue = [AWSDDLog loggingQueue];
+
+    dispatch_sync(globalLoggingQueue, ^{
+        dispatch_sync(self.loggerQueue, block);
+    });
+
+    return result;
+}
+
+- (void)setBufferSize:(NSUInteger)newBufferSize {
+    dispatch_block_t block = ^{
+        @autoreleasepool {
+            self->_bufferSize = newBufferSize;
+
+            if ([self->_logBuffer length] >= newBufferSize) {
+                [self flushLogBuffer];
+            }
+        }
+    };
+
+    // The design of this method is taken from the AWSDDAbstractLogger implementation.
+    // For extensive documentation please refer to the AWSDDAbstractLogger implementation.
+
+    // Note: The internal implementation MUST access the bufferSize variable directly,
+    // This method is designed explicitly for external access.
+
+    NSAssert(![self isOnGlobalLoggingQueue], @"Core architecture requirement failure");
+    NSAssert(![self isOnInternalLoggerQueue], @"MUST access ivar directly, NOT via self.* syntax.");
+
+    dispatch_queue_t globalLoggingQueue = [AWSDDLog loggingQueue];
+
+    dispatch_async(globalLoggingQueue, ^{
+        dispatch_async(self.loggerQueue, block);
+    });
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 #pragma mark File Rolling
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -817,9 +1067,14 @@ unsigned long long const kAWSDDDefaultLogFilesDiskQuota   = 20 * 1024 * 1024; //
         return;
     }
 
-    [_currentLogFileHandle synchronizeFile];
+    // The log messages in memory belong to the log file being rolled.
+    // There is no need to synchronize the file: the data written is in the file system cache already,
+    // and synchronizing would hold up logging until it is on disk.
+    [self flushLogBuffer];
+
     [_currentLogFileHandle closeFile];
     _currentLogFileHandle = nil;
+    _currentLogFileSize = 0;
 
     _currentLogFileInfo.isArchived = YES;
 
@@ -857,8 +1112,11 @@ unsigned long long const kAWSDDDefaultLogFilesDiskQuota   = 20 * 1024 * 1024; //
     // Note: Use direct access to maximumFileSize variable.
     // We specifically wrote our own getter/setter method to allow us to do this (for performance reasons).
 
+    // Note: Use the size kept by the logger instead of asking the file handle, which is a system call.
+    // The log messages in memory count as they will be written to the current log file.
+
     if (_maximumFileSize > 0) {
-        unsigned long long fileSize = [_currentLogFileHandle offsetInFile];
+        unsigned long long fileSize = _currentLogFileSize + [_logBuffer length];
 
         if (fileSize >= _maximumFileSize) {
             NSLogVerbose(@"AWSDDFileLogger: Rolling log file due to size (%qu)...", fileSize);
@@ -950,7 +1208,7 @@ unsigned long long const kAWSDDDefaultLogFilesDiskQuota   = 20 * 1024 * 1024; //
         NSString *logFilePath = [[self currentLogFileInfo] filePath];
 
         _currentLogFileHandle = [NSFileHandle fileHandleForWritingAtPath:logFilePath];
-        [_currentLogFileHandle seekToEndOfFile];
+        _currentLogFileSize = [_currentLogFileHandle seekToEndOfFile];
 
         if (_currentLogFileHandle) {
             [self scheduleTimerToRollLogFileDueToAge];
@@ -988,7 +1246,54 @@ unsigned long long const kAWSDDDefaultLogFilesDiskQuota   = 20 * 1024 * 1024; //
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 static int exception_count = 0;
+
+static void awsLogFileLoggerException(NSException *exception) {
+    exception_count++;
+
+    if (exception_count <= 10) {
+        NSLogError(@"AWSDDFileLogger.logMessage: %@", exception);
+
+        if (exception_count == 10) {
+            NSLogError(@"AWSDDFileLogger.logMessage: Too many exceptions -- will not log any more of them.");
+        }
+    }
+}
+
 - (void)logMessage:(AWSDDLogMessage *)logMessage {
+    BOOL shouldFlush = [self appendLogMessage:logMessage];
+
+    [self didAppendLogMessagesRequiringFlush:shouldFlush];
+}
+
+- (void)logMessages:(NSArray<AWSDDLogMessage *> *)logMessages {
+    // Subclasses which override logMessage: still get the log messages one at a time.
+    if ([self methodForSelector:@selector(logMessage:)] != [AWSDDFileLogger instanceMethodForSelector:@selector(logMessage:)]) {
+        for (AWSDDLogMessage *logMessage in logMessages) {
+            @autoreleasepool {
+                [self logMessage:logMessage];
+            }
+        }
+
+        return;
+    }
+
+    // The log messages are written to the log file at once.
+    BOOL shouldFlush = NO;
+
+    for (AWSDDLogMessage *logMessage in logMessages) {
+        @autoreleasepool {
+            shouldFlush = [self appendLogMessage:logMessage] || shouldFlush;
+        }
+    }
+
+    [self didAppendLogMessagesRequiringFlush:shouldFlush];
+}
+
+/**
+ * Formats the log message and appends it to the log buffer.
+ * Returns whether the log message should be written to the log file right away.
+ **/
+- (BOOL)appendLogMessage:(AWSDDLogMessage *)logMessage {
     NSString *message = logMessage->_message;
     BOOL isFormatted = NO;
 
@@ -997,32 +1302,97 @@ static int exception_count = 0;
         isFormatted = message != logMessage->_message;
     }
 
-    if (message) {
-        if ((!isFormatted || _automaticallyAppendNewlineForCustomFormatters) &&
-            (![message hasSuffix:@"\n"])) {
-            message = [message stringByAppendingString:@"\n"];
-        }
+    if (message == nil) {
+        return NO;
+    }
 
-        NSData *logData = [message dataUsingEncoding:NSUTF8StringEncoding];
+    if ((!isFormatted || _automaticallyAppendNewlineForCustomFormatters) &&
+        (![message hasSuffix:@"\n"])) {
+        message = [message stringByAppendingString:@"\n"];
+    }
 
-        @try {
-            [self willLogMessage];
-			
-            [[self currentLogFileHandle] writeData:logData];
+    NSData *logData = [message dataUsingEncoding:NSUTF8StringEncoding];
 
-            [self didLogMessage];
-        } @catch (NSException *exception) {
-            exception_count++;
+    @try {
+        [self willLogMessage];
 
-            if (exception_count <= 10) {
-                NSLogError(@"AWSDDFileLogger.logMessage: %@", exception);
+        // Open the log file first, so that the size of the log file is known when the log message is added.
+        [self currentLogFileHandle];
+        [_logBuffer appendData:logData];
 
-                if (exception_count == 10) {
-                    NSLogError(@"AWSDDFileLogger.logMessage: Too many exceptions -- will not log any more of them.");
-                }
-            }
+        if (_bufferSize > 0 && [_logBuffer length] >= _bufferSize) {
+            [self flushLogBuffer];
         }
+
+        [self didLogMessage];
+    } @catch (NSException *exception) {
+        awsLogFileLoggerException(exception);
     }
+
+    return (logMessage->_flag & self.flushLogLevel) != 0;
+}
+
+- (void)didAppendLogMessagesRequiringFlush:(BOOL)shouldFlush {
+    if (shouldFlush || _bufferSize == 0) {
+        [self flushLogBuffer];
+    } else if ([_logBuffer length] > 0) {
+        [self scheduleTimerToFlushLogBuffer];
+    }
+}
+
+- (void)flushLogBuffer {
+    _flushTimerScheduled = NO;
+
+    if ([_logBuffer length] == 0) {
+        return;
+    }
+
+    @try {
+        [_currentLogFileHandle writeData:_logBuffer];
+        _currentLogFileSize += [_logBuffer length];
+    } @catch (NSException *exception) {
+        awsLogFileLoggerException(exception);
+    }
+
+    [_logBuffer setLength:0];
+}
+
+- (void)scheduleTimerToFlushLogBuffer {
+    NSTimeInterval flushInterval = self.flushInterval;
+
+    if (_flushTimerScheduled || flushInterval <= 0.0) {
+        return;
+    }
+
+    if (_flushTimer == NULL) {
+        _flushTimer = dispatch_source_create(DISPATCH_SOURCE_TYPE_TIMER, 0, 0, self.loggerQueue);
+
+        __weak __typeof__(self) weakSelf = self;
+        dispatch_source_set_event_handler(_flushTimer, ^{ @autoreleasepool {
+                                                             [weakSelf flushLogBuffer];
+                                                         } });
+
+        #if !OS_OBJECT_USE_OBJC
+        dispatch_source_t theFlushTimer = _flushTimer;
+        dispatch_source_set_cancel_handler(_flushTimer, ^{
+            dispatch_release(theFlushTimer);
+        });
+        #endif
+
+        dispatch_resume(_flushTimer);
+    }
+
+    // Rescheduling replaces a pending fire of the timer,
+    // so the log buffer is flushed no later than flushInterval after its first log message.
+    uint64_t interval = (uint64_t)(flushInterval * (NSTimeInterval) NSEC_PER_SEC);
+    dispatch_source_set_timer(_flushTimer, dispatch_time(DISPATCH_TIME_NOW, (int64_t)interval), DISPATCH_TIME_FOREVER, interval / 10);
+
+    _flushTimerScheduled = YES;
+}
+
+- (void)flush {
+    // This method is invoked on the logger queue by [AWSDDLog flushLog].
+    [self flushLogBuffer];
 }
 
 - (void)willLogMessage {
@@ -1214,6 +1584,7 @@ static int exception_count = 0;
     _fileAttributes = nil;
     _creationDate = nil;
     _modificationDate = nil;
+    _fileSize = 0;
 }
 
 - (void)renameFile:(NSString *)newFileName {
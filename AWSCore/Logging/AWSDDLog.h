@@ -205,9 +205,28 @@ NSString * __nullable AWSDDExtractFileNameWithoutExtension(const char *filePath,
 #pragma mark -
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
+/**
+ * What happens to an asynchronous log statement when `AWSDDLOG_MAX_QUEUE_SIZE` statements are already queued.
+ */
+typedef NS_ENUM(NSUInteger, AWSDDLogQueueOverflowPolicy) {
+    /**
+     * The logging thread waits until a queued statement has been handed to the loggers.
+     */
+    AWSDDLogQueueOverflowPolicyBlock,
+    /**
+     * The statement is dropped, and counted in `droppedMessageCount`.
+     */
+    AWSDDLogQueueOverflowPolicyDrop,
+};
+
 /**
  *  The main class, exposes all logging mechanisms, loggers, ...
  *  For most of the users, this class is hidden behind the logging functions like `AWSDDLogInfo`
+ *
+ *  Asynchronous log statements are captured into a preallocated ring buffer without taking a lock, and are handed
+ *  to the loggers in batches from the logging queue. The `file` and `function` passed to the logging primitives
+ *  are copied into the record, the file keeping the end of its path and the function the start of its name when
+ *  they are too long, so they do not need to outlive the call.
  */
 @interface AWSDDLog : NSObject
 
@@ -222,6 +241,32 @@ NSString * __nullable AWSDDExtractFileNameWithoutExtension(const char *filePath,
  */
 @property (nonatomic, assign) AWSDDLogLevel logLevel;
 
+/**
+ * What happens to asynchronous log statements when the queue is full. The default is
+ * `AWSDDLogQueueOverflowPolicyBlock`. Statements issued from the logging queue itself are dropped when the queue is
+ * full, whatever the policy.
+ */
+@property (nonatomic, assign) AWSDDLogQueueOverflowPolicy queueOverflowPolicy;
+
+/**
+ * The number of asynchronous log statements dropped because the queue was full.
+ */
+@property (nonatomic, assign, readonly) NSUInteger droppedMessageCount;
+
+/**
+ * Whether asynchronous log statements are formatted on the logging queue rather than by the logging thread.
+ * The default is NO.
+ *
+ * When set, the logging thread only records the format string and the raw values of its arguments.
+ * The message is formatted on the logging queue if one of the loggers needs it, that is unless every logger
+ * accepts unformatted messages (see `acceptsUnformattedMessages`), like `AWSDDBinaryFileLogger`.
+ *
+ * The format string must be a string literal. Immutable values (strings, numbers, dates, UUIDs and URLs) passed
+ * for `%@` are formatted later, other objects are described by the logging thread. Statements whose arguments
+ * do not fit in a queued statement, or which use positional arguments, are formatted right away.
+ */
+@property (nonatomic, assign) BOOL defersFormatting;
+
 /**
  * Provides access to the underlying logging queue.
  * This may be helpful to Logger classes for things like thread synchronization.
@@ -587,6 +632,15 @@ NSString * __nullable AWSDDExtractFileNameWithoutExtension(const char *filePath,
 
 @optional
 
+/**
+ * Logs the messages queued since the last call, in order, with a single dispatch onto the logger queue.
+ * Loggers which write to a file or a database may implement this method to write the messages at once.
+ * If it is not implemented, `logMessage:` is called for each message.
+ *
+ *  @param logMessages the messages (models) whose flag matches the level of the logger
+ */
+- (void)logMessages:(NSArray<AWSDDLogMessage *> *)logMessages NS_SWIFT_NAME(log(messages:));
+
 /**
  * Since logging is asynchronous, adding and removing loggers is also asynchronous.
  * In other words, the loggers are added and removed at appropriate times with regards to log messages.
@@ -645,6 +699,13 @@ NSString * __nullable AWSDDExtractFileNameWithoutExtension(const char *filePath,
  **/
 @property (nonatomic, readonly) NSString *loggerName;
 
+/**
+ * Loggers which write the format and the arguments of messages rather than their text may return YES,
+ * so that messages logged with `defersFormatting` are not formatted for them.
+ * The `message` of such messages is nil, unless another logger needed it, and their `format` and `arguments` are set.
+ **/
+@property (nonatomic, readonly) BOOL acceptsUnformattedMessages;
+
 @end
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -786,6 +847,8 @@ typedef NS_OPTIONS(NSInteger, AWSDDLogMessageOptions){
     NSString *_threadID;
     NSString *_threadName;
     NSString *_queueLabel;
+    NSString *_format;
+    NSData *_arguments;
 }
 
 /**
@@ -853,6 +916,16 @@ typedef NS_OPTIONS(NSInteger, AWSDDLogMessageOptions){
 @property (readonly, nonatomic) NSString *threadName;
 @property (readonly, nonatomic) NSString *queueLabel;
 
+/**
+ *  The format string of a message logged with `defersFormatting`, or nil
+ */
+@property (readonly, nonatomic) NSString * __nullable format;
+
+/**
+ *  The arguments of a message logged with `defersFormatting`, packed as described in `AWSDDBinaryFileLogger.h`, or nil
+ */
+@property (readonly, nonatomic) NSData * __nullable arguments;
+
 @end
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -19,8 +19,11 @@
 #endif
 
 #import "AWSDDLog.h"
+#import "AWSDDLogArguments.h"
+#import "AWSDDLogRingBuffer.h"
 
 #import <pthread.h>
+#import <stdatomic.h>
 #import <dispatch/dispatch.h>
 #import <objc/runtime.h>
 #import <mach/mach_host.h>
@@ -64,6 +67,16 @@
     #define AWSDDLOG_MAX_QUEUE_SIZE 1000 // Should not exceed INT32_MAX
 #endif
 
+// Specifies the maximum number of queued log statements handed to the loggers at once.
+//
+// The logging thread drains the queue in batches of this size,
+// so that loggers implementing logMessages: can write several log messages at once,
+// and so that threads blocked on a full queue are unblocked as soon as a batch has been logged.
+
+#ifndef AWSDDLOG_BATCH_SIZE
+    #define AWSDDLOG_BATCH_SIZE 64
+#endif
+
 // The "global logging queue" refers to [AWSDDLog loggingQueue].
 // It is the queue that all log statements go through.
 //
@@ -91,6 +104,50 @@ static void *const GlobalLoggingQueueIdentityKey = (void *)&GlobalLoggingQueueId
 
 @end
 
+// Copies a C string into a fixed-size buffer of a record, keeping its end rather than its start if it is too long.
+// The string is cut between UTF-8 characters. NULL is copied as "(null)", the way `AWSDDLogMessage` formats it.
+static void AWSDDLogRecordCopyString(char *buffer, size_t size, const char *string, BOOL keepsEnd) {
+    if (string == NULL) {
+        string = "(null)";
+    }
+    size_t length = strlen(string);
+    if (length >= size) {
+        if (keepsEnd) {
+            string += length - (size - 1);
+            length = size - 1;
+            // Skip the continuation bytes of a character whose first bytes are cut.
+            while (length > 0 && ((unsigned char)*string & 0xC0) == 0x80) {
+                string++;
+                length--;
+            }
+        } else {
+            length = size - 1;
+            // Leave out a character whose last bytes are cut.
+            while (length > 0 && ((unsigned char)string[length] & 0xC0) == 0x80) {
+                length--;
+            }
+        }
+    }
+    memcpy(buffer, string, length);
+    buffer[length] = '\0';
+}
+
+// Fills in the statement, and the context of the current thread. Defined with the AWSDDLogMessage implementation.
+static void AWSDDLogRecordSetStatement(AWSDDLogRecord *record,
+                                       AWSDDLogLevel level,
+                                       AWSDDLogFlag flag,
+                                       NSInteger context,
+                                       const char *file,
+                                       const char *function,
+                                       NSUInteger line,
+                                       id tag);
+
+// Creates the log message of a record, and releases the objects of the record.
+static AWSDDLogMessage *AWSDDLogMessageFromRecord(AWSDDLogRecord *record);
+
+// Releases the objects of a record which is not logged.
+static void AWSDDLogRecordRelease(AWSDDLogRecord *record);
+
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 #pragma mark -
@@ -104,19 +161,30 @@ static void *const GlobalLoggingQueueIdentityKey = (void *)&GlobalLoggingQueueId
 
 @end
 
-@implementation AWSDDLog
+@implementation AWSDDLog {
+    // Asynchronous log statements are captured into this ring buffer by the logging threads,
+    // and drained in order on the logging queue.
+    // Its capacity is the maximum queue size (AWSDDLOG_MAX_QUEUE_SIZE), rounded up to a power of 2.
+    AWSDDLogRingBuffer *_ringBuffer;
+
+    // Set while a drain of the ring buffer is queued or running on the logging queue,
+    // so that only the first of a burst of log statements dispatches to the logging queue.
+    atomic_bool _drainScheduled;
+
+    // The threads blocked on a full ring buffer, and the semaphore they wait on.
+    atomic_uint _waiterCount;
+    dispatch_semaphore_t _spaceSemaphore;
+
+    atomic_ulong _droppedMessageCount;
+}
 
 // All logging statements are added to the same queue to ensure FIFO operation.
 static dispatch_queue_t _loggingQueue;
 
-// Individual loggers are executed concurrently per log statement.
+// Individual loggers are executed concurrently per batch of log statements.
 // Each logger has it's own associated queue, and a dispatch group is used for synchrnoization.
 static dispatch_group_t _loggingGroup;
 
-// In order to prevent to queue from growing infinitely large,
-// a maximum size is enforced (AWSDDLOG_MAX_QUEUE_SIZE).
-static dispatch_semaphore_t _queueSemaphore;
-
 // Minor optimization for uniprocessor machines
 static NSUInteger _numProcessors;
 
@@ -157,8 +225,6 @@ static NSUInteger _numProcessors;
         void *nonNullValue = GlobalLoggingQueueIdentityKey; // Whatever, just not null
         dispatch_queue_set_specific(_loggingQueue, GlobalLoggingQueueIdentityKey, nonNullValue, NULL);
         
-        _queueSemaphore = dispatch_semaphore_create(AWSDDLOG_MAX_QUEUE_SIZE);
-        
         // Figure out how many processors are available.
         // This may be used later for an optimization on uniprocessor machines.
         
@@ -180,6 +246,13 @@ static NSUInteger _numProcessors;
     if (self) {
         self._loggers = [[NSMutableArray alloc] initWithCapacity:4];
         self.logLevel = AWSDDLogLevelWarning;//default to warning
+        self.queueOverflowPolicy = AWSDDLogQueueOverflowPolicyBlock;
+
+        _ringBuffer = AWSDDLogRingBufferCreate(AWSDDLOG_MAX_QUEUE_SIZE);
+        atomic_init(&_drainScheduled, false);
+        atomic_init(&_waiterCount, 0);
+        _spaceSemaphore = dispatch_semaphore_create(0);
+        atomic_init(&_droppedMessageCount, 0);
         
 #if TARGET_OS_IOS
         NSString *notificationName = @"UIApplicationWillTerminateNotification";
@@ -216,6 +289,16 @@ static NSUInteger _numProcessors;
     return self;
 }
 
+- (void)dealloc {
+    // Every drain holds a reference to the instance, so there is nothing left to log.
+    AWSDDLogRecord *record = NULL;
+    while ((record = AWSDDLogRingBufferPeek(_ringBuffer))) {
+        AWSDDLogRecordRelease(record);
+        AWSDDLogRingBufferConsume(_ringBuffer);
+    }
+    AWSDDLogRingBufferDestroy(_ringBuffer);
+}
+
 /**
  * Provides access to the logging queue.
  **/
@@ -223,6 +306,10 @@ static NSUInteger _numProcessors;
     return _loggingQueue;
 }
 
+- (NSUInteger)droppedMessageCount {
+    return (NSUInteger)atomic_load_explicit(&_droppedMessageCount, memory_order_relaxed);
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 #pragma mark Notifications
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -313,60 +400,76 @@ static NSUInteger _numProcessors;
 #pragma mark - Master Logging
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-- (void)queueLogMessage:(AWSDDLogMessage *)logMessage asynchronously:(BOOL)asyncFlag {
-    // We have a tricky situation here...
-    //
-    // In the common case, when the queueSize is below the maximumQueueSize,
-    // we want to simply enqueue the logMessage. And we want to do this as fast as possible,
+- (AWSDDLogRecord *)claimRecord {
+    // In the common case, when the queue size is below the maximum queue size,
+    // we want to simply enqueue the log statement. And we want to do this as fast as possible,
     // which means we don't want to block and we don't want to use any locks.
     //
-    // However, if the queueSize gets too big, we want to block.
-    // But we have very strict requirements as to when we block, and how long we block.
-    //
-    // The following example should help illustrate our requirements:
-    //
-    // Imagine that the maximum queue size is configured to be 5,
-    // and that there are already 5 log messages queued.
-    // Let us call these 5 queued log messages A, B, C, D, and E. (A is next to be executed)
-    //
-    // Now if our thread issues a log statement (let us call the log message F),
-    // it should block before the message is added to the queue.
-    // Furthermore, it should be unblocked immediately after A has been unqueued.
-    //
-    // The requirements are strict in this manner so that we block only as long as necessary,
-    // and so that blocked threads are unblocked in the order in which they were blocked.
-    //
-    // Returning to our previous example, let us assume that log messages A through E are still queued.
-    // Our aforementioned thread is blocked attempting to queue log message F.
-    // Now assume we have another separate thread that attempts to issue log message G.
-    // It should block until log messages A and B have been unqueued.
+    // Claiming a record of the ring buffer is a single compare-and-swap.
 
+    AWSDDLogRecord *record = AWSDDLogRingBufferClaim(_ringBuffer);
+    if (record) {
+        return record;
+    }
 
-    // We are using a counting semaphore provided by GCD.
-    // The semaphore is initialized with our AWSDDLOG_MAX_QUEUE_SIZE value.
-    // Everytime we want to queue a log message we decrement this value.
-    // If the resulting value is less than zero,
-    // the semaphore function waits in FIFO order for a signal to occur before returning.
+    // The queue is full. Depending on the overflow policy, we either drop the log statement,
+    // or block until the logging queue has handed a batch of log statements to the loggers.
     //
-    // A dispatch semaphore is an efficient implementation of a traditional counting semaphore.
-    // Dispatch semaphores call down to the kernel only when the calling thread needs to be blocked.
-    // If the calling semaphore does not need to block, no kernel call is made.
+    // The logging queue cannot wait for itself, so log statements issued from it
+    // (typically by a logger) are always dropped.
+
+    if (self.queueOverflowPolicy == AWSDDLogQueueOverflowPolicyDrop || dispatch_get_specific(GlobalLoggingQueueIdentityKey)) {
+        atomic_fetch_add_explicit(&_droppedMessageCount, 1, memory_order_relaxed);
+        return NULL;
+    }
 
-    dispatch_semaphore_wait(_queueSemaphore, DISPATCH_TIME_FOREVER);
+    atomic_fetch_add(&_waiterCount, 1);
+    while (!(record = AWSDDLogRingBufferClaim(_ringBuffer))) {
+        [self scheduleDrain];
+        // The timeout covers a batch logged between our claim and our wait.
+        dispatch_semaphore_wait(_spaceSemaphore, dispatch_time(DISPATCH_TIME_NOW, NSEC_PER_MSEC));
+    }
+    atomic_fetch_sub(&_waiterCount, 1);
 
-    // We've now sure we won't overflow the queue.
-    // It is time to queue our log message.
+    return record;
+}
 
-    dispatch_block_t logBlock = ^{
-        @autoreleasepool {
-            [self lt_log:logMessage];
-        }
-    };
+- (void)commitRecord:(AWSDDLogRecord *)record {
+    AWSDDLogRingBufferCommit(_ringBuffer, record);
+    [self scheduleDrain];
+}
+
+- (void)scheduleDrain {
+    // Only the first log statement committed after a drain has finished dispatches to the logging queue.
+    // The drain hands every log statement committed in the meantime to the loggers, in batches.
+
+    if (!atomic_exchange(&_drainScheduled, true)) {
+        dispatch_async(_loggingQueue, ^{
+            [self lt_drainRingBuffer];
+        });
+    }
+}
 
+- (void)queueLogMessage:(AWSDDLogMessage *)logMessage asynchronously:(BOOL)asyncFlag {
     if (asyncFlag) {
-        dispatch_async(_loggingQueue, logBlock);
+        AWSDDLogRecord *record = [self claimRecord];
+        if (!record) {
+            return;
+        }
+
+        record->message = CFBridgingRetain(logMessage);
+        record->format = NULL;
+        record->argumentsLength = 0;
+        record->isLogMessage = YES;
+        [self commitRecord:record];
     } else {
-        dispatch_sync(_loggingQueue, logBlock);
+        // A synchronous log statement is logged after all the asynchronous log statements queued before it.
+        dispatch_sync(_loggingQueue, ^{
+            [self lt_deliverRecords];
+            @autoreleasepool {
+                [self lt_log:logMessage];
+            }
+        });
     }
 }
 
@@ -384,21 +487,7 @@ static NSUInteger _numProcessors;
     if (format) {
         va_start(args, format);
         
-        NSString *message = [[NSString alloc] initWithFormat:format arguments:args];
-        
-        va_end(args);
-        
-        va_start(args, format);
-        
-        [self log:asynchronous
-          message:message
-            level:level
-             flag:flag
-          context:context
-             file:file
-         function:function
-             line:line
-              tag:tag];
+        [self.sharedInstance log:asynchronous level:level flag:flag context:context file:file function:function line:line tag:tag format:format args:args];
         
         va_end(args);
     }
@@ -418,21 +507,7 @@ static NSUInteger _numProcessors;
     if (format) {
         va_start(args, format);
         
-        NSString *message = [[NSString alloc] initWithFormat:format arguments:args];
-        
-        va_end(args);
-        
-        va_start(args, format);
-        
-        [self log:asynchronous
-          message:message
-            level:level
-             flag:flag
-          context:context
-             file:file
-         function:function
-             line:line
-              tag:tag];
+        [self log:asynchronous level:level flag:flag context:context file:file function:function line:line tag:tag format:format args:args];
         
         va_end(args);
     }
@@ -461,6 +536,35 @@ static NSUInteger _numProcessors;
         tag:(id)tag
      format:(NSString *)format
        args:(va_list)args {
+    // Don't format statements which are not logged.
+    if (!(level & flag)) {
+        return;
+    }
+
+    if (format && asynchronous && self.defersFormatting) {
+        AWSDDLogRecord *record = [self claimRecord];
+        if (!record) {
+            return;
+        }
+
+        va_list argsCopy;
+        va_copy(argsCopy, args);
+        BOOL encoded = AWSDDLogArgumentsEncode(format, argsCopy, record->arguments, AWSDD_LOG_RECORD_ARGUMENTS_SIZE, &record->argumentsLength);
+        va_end(argsCopy);
+
+        if (encoded) {
+            record->message = NULL;
+            record->format = CFBridgingRetain(format);
+        } else {
+            record->message = CFBridgingRetain([[NSString alloc] initWithFormat:format arguments:args]);
+            record->format = NULL;
+            record->argumentsLength = 0;
+        }
+        AWSDDLogRecordSetStatement(record, level, flag, context, file, function, line, tag);
+        [self commitRecord:record];
+        return;
+    }
+
     if (format) {
         NSString *message = [[NSString alloc] initWithFormat:format arguments:args];
         [self log:asynchronous
@@ -496,7 +600,25 @@ static NSUInteger _numProcessors;
    function:(const char *)function
        line:(NSUInteger)line
         tag:(id)tag {
-    if(level & flag){
+    if (!(level & flag)) {
+        return;
+    }
+
+    if (asynchronous) {
+        // Only capture what the log message is made of here: the log message itself,
+        // and the file and function strings, are created on the logging queue.
+
+        AWSDDLogRecord *record = [self claimRecord];
+        if (!record) {
+            return;
+        }
+
+        record->message = CFBridgingRetain([message copy]);
+        record->format = NULL;
+        record->argumentsLength = 0;
+        AWSDDLogRecordSetStatement(record, level, flag, context, file, function, line, tag);
+        [self commitRecord:record];
+    } else {
         AWSDDLogMessage *logMessage = [[AWSDDLogMessage alloc] initWithMessage:message
                                                                          level:level
                                                                           flag:flag
@@ -508,7 +630,7 @@ static NSUInteger _numProcessors;
                                                                        options:(AWSDDLogMessageOptions)0
                                                                      timestamp:nil];
         
-        [self queueLogMessage:logMessage asynchronously:asynchronous];
+        [self queueLogMessage:logMessage asynchronously:NO];
     }
 }
 
@@ -527,9 +649,12 @@ static NSUInteger _numProcessors;
 }
 
 - (void)flushLog {
-    dispatch_sync(_loggingQueue, ^{ @autoreleasepool {
-        [self lt_flush];
-    } });
+    dispatch_sync(_loggingQueue, ^{
+        [self lt_deliverRecords];
+        @autoreleasepool {
+            [self lt_flush];
+        }
+    });
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -818,64 +943,141 @@ static NSUInteger _numProcessors;
     return [theLoggersWithLevel copy];
 }
 
-- (void)lt_log:(AWSDDLogMessage *)logMessage {
-    // Execute the given log message on each of our loggers.
-
+- (void)lt_drainRingBuffer {
     NSAssert(dispatch_get_specific(GlobalLoggingQueueIdentityKey),
              @"This method should only be run on the logging thread/queue");
 
-    if (_numProcessors > 1) {
-        // Execute each logger concurrently, each within its own queue.
-        // All blocks are added to same group.
-        // After each block has been queued, wait on group.
-        //
-        // The waiting ensures that a slow logger doesn't end up with a large queue of pending log messages.
-        // This would defeat the purpose of the efforts we made earlier to restrict the max queue size.
+    while (YES) {
+        [self lt_deliverRecords];
+
+        // A log statement committed after we found the ring buffer empty, but before we clear the flag,
+        // would not schedule a drain. So we check again once the flag is cleared,
+        // and keep draining unless a new drain has been scheduled in the meantime.
+
+        atomic_store(&_drainScheduled, false);
+        if (!AWSDDLogRingBufferHasCommittedRecord(_ringBuffer)) {
+            return;
+        }
+        if (atomic_exchange(&_drainScheduled, true)) {
+            return;
+        }
+    }
+}
 
-        for (AWSDDLoggerNode *loggerNode in self._loggers) {
-            // skip the loggers that shouldn't write this message based on the log level
+- (void)lt_deliverRecords {
+    // Hand the queued log statements to the loggers, in batches of AWSDDLOG_BATCH_SIZE.
 
-            if (!(logMessage->_flag & loggerNode->_level)) {
-                continue;
+    NSAssert(dispatch_get_specific(GlobalLoggingQueueIdentityKey),
+             @"This method should only be run on the logging thread/queue");
+
+    while (YES) { @autoreleasepool {
+        NSMutableArray<AWSDDLogMessage *> *logMessages = nil;
+        AWSDDLogRecord *record = NULL;
+
+        while ([logMessages count] < AWSDDLOG_BATCH_SIZE && (record = AWSDDLogRingBufferPeek(_ringBuffer))) {
+            if (!logMessages) {
+                logMessages = [[NSMutableArray alloc] initWithCapacity:AWSDDLOG_BATCH_SIZE];
             }
-            
-            dispatch_group_async(_loggingGroup, loggerNode->_loggerQueue, ^{ @autoreleasepool {
-                [loggerNode->_logger logMessage:logMessage];
-            } });
+            [logMessages addObject:AWSDDLogMessageFromRecord(record)];
+            AWSDDLogRingBufferConsume(_ringBuffer);
         }
-        
-        dispatch_group_wait(_loggingGroup, DISPATCH_TIME_FOREVER);
-    } else {
-        // Execute each logger serialy, each within its own queue.
-        
-        for (AWSDDLoggerNode *loggerNode in self._loggers) {
-            // skip the loggers that shouldn't write this message based on the log level
 
-            if (!(logMessage->_flag & loggerNode->_level)) {
-                continue;
+        if (!logMessages) {
+            return;
+        }
+
+        // The records are free again, unblock the threads waiting for one.
+
+        unsigned int waiterCount = atomic_load(&_waiterCount);
+        for (unsigned int i = 0; i < waiterCount; i++) {
+            dispatch_semaphore_signal(_spaceSemaphore);
+        }
+
+        [self lt_logMessages:logMessages];
+    } }
+}
+
+- (void)lt_log:(AWSDDLogMessage *)logMessage {
+    [self lt_logMessages:@[logMessage]];
+}
+
+- (void)lt_logMessages:(NSArray<AWSDDLogMessage *> *)logMessages {
+    // Execute the given log messages on each of our loggers.
+
+    NSAssert(dispatch_get_specific(GlobalLoggingQueueIdentityKey),
+             @"This method should only be run on the logging thread/queue");
+
+    // Format the messages whose formatting was deferred, if a logger needs their text.
+    // This is done before any logger runs, since the loggers run concurrently.
+
+    for (AWSDDLoggerNode *loggerNode in self._loggers) {
+        if ([loggerNode->_logger respondsToSelector:@selector(acceptsUnformattedMessages)] && loggerNode->_logger.acceptsUnformattedMessages) {
+            continue;
+        }
+        for (AWSDDLogMessage *logMessage in logMessages) {
+            if (!logMessage->_message && logMessage->_format) {
+                logMessage->_message = AWSDDLogArgumentsFormat(logMessage->_format, logMessage->_arguments);
             }
-            
-            dispatch_sync(loggerNode->_loggerQueue, ^{ @autoreleasepool {
-                [loggerNode->_logger logMessage:logMessage];
-            } });
         }
+        break;
     }
 
-    // If our queue got too big, there may be blocked threads waiting to add log messages to the queue.
-    // Since we've now dequeued an item from the log, we may need to unblock the next thread.
+    for (AWSDDLoggerNode *loggerNode in self._loggers) {
+        // skip the log messages that the logger shouldn't write based on its level
+
+        NSArray<AWSDDLogMessage *> *loggerMessages = logMessages;
+        NSUInteger count = [logMessages count];
+        for (NSUInteger i = 0; i < count; i++) {
+            if (!(logMessages[i]->_flag & loggerNode->_level)) {
+                NSMutableArray<AWSDDLogMessage *> *filteredMessages = [[logMessages subarrayWithRange:NSMakeRange(0, i)] mutableCopy];
+                for (NSUInteger j = i + 1; j < count; j++) {
+                    if (logMessages[j]->_flag & loggerNode->_level) {
+                        [filteredMessages addObject:logMessages[j]];
+                    }
+                }
+                loggerMessages = filteredMessages;
+                break;
+            }
+        }
+
+        if ([loggerMessages count] == 0) {
+            continue;
+        }
 
-    // We are using a counting semaphore provided by GCD.
-    // The semaphore is initialized with our AWSDDLOG_MAX_QUEUE_SIZE value.
-    // When a log message is queued this value is decremented.
-    // When a log message is dequeued this value is incremented.
-    // If the value ever drops below zero,
-    // the queueing thread blocks and waits in FIFO order for us to signal it.
-    //
-    // A dispatch semaphore is an efficient implementation of a traditional counting semaphore.
-    // Dispatch semaphores call down to the kernel only when the calling thread needs to be blocked.
-    // If the calling semaphore does not need to block, no kernel call is made.
+        dispatch_block_t logBlock = ^{
+            id <AWSDDLogger> logger = loggerNode->_logger;
+            if ([logger respondsToSelector:@selector(logMessages:)]) {
+                @autoreleasepool {
+                    [logger logMessages:loggerMessages];
+                }
+            } else {
+                for (AWSDDLogMessage *logMessage in loggerMessages) {
+                    @autoreleasepool {
+                        [logger logMessage:logMessage];
+                    }
+                }
+            }
+        };
+
+        if (_numProcessors > 1) {
+            // Execute each logger concurrently, each within its own queue.
+            // All blocks are added to same group.
+            // After each block has been queued, wait on group.
+            //
+            // The waiting ensures that a slow logger doesn't end up with a large queue of pending log messages.
+            // This would defeat the purpose of the efforts we made earlier to restrict the max queue size.
+
+            dispatch_group_async(_loggingGroup, loggerNode->_loggerQueue, logBlock);
+        } else {
+            // Execute each logger serialy, each within its own queue.
 
-    dispatch_semaphore_signal(_queueSemaphore);
+            dispatch_sync(loggerNode->_loggerQueue, logBlock);
+        }
+    }
+
+    if (_numProcessors > 1) {
+        dispatch_group_wait(_loggingGroup, DISPATCH_TIME_FOREVER);
+    }
 }
 
 - (void)lt_flush {
@@ -1115,6 +1317,122 @@ static __inline__ __attribute__((__always_inline__)) void _dispatch_queue_label_
 
 #endif /* if TARGET_OS_IOS */
 
+static void AWSDDLogRecordSetStatement(AWSDDLogRecord *record,
+                                       AWSDDLogLevel level,
+                                       AWSDDLogFlag flag,
+                                       NSInteger context,
+                                       const char *file,
+                                       const char *function,
+                                       NSUInteger line,
+                                       id tag) {
+    record->tag = tag ? CFBridgingRetain(tag) : NULL;
+    AWSDDLogRecordCopyString(record->file, sizeof(record->file), file, YES);
+    AWSDDLogRecordCopyString(record->function, sizeof(record->function), function, NO);
+    record->line = line;
+    record->context = context;
+    record->level = level;
+    record->flag = flag;
+    record->isLogMessage = NO;
+    record->timestamp = CFAbsoluteTimeGetCurrent();
+
+    if (USE_PTHREAD_THREADID_NP) {
+        __uint64_t tid;
+        pthread_threadid_np(NULL, &tid);
+        record->threadID = tid;
+    } else {
+        record->threadID = pthread_mach_thread_np(pthread_self());
+    }
+
+    NSString *threadName = NSThread.currentThread.name;
+    record->threadName = threadName ? CFBridgingRetain(threadName) : NULL;
+
+    const char *queueLabel = NULL;
+    if (USE_DISPATCH_CURRENT_QUEUE_LABEL) {
+        queueLabel = dispatch_queue_get_label(DISPATCH_CURRENT_QUEUE_LABEL);
+    } else if (USE_DISPATCH_GET_CURRENT_QUEUE) {
+        #pragma clang diagnostic push
+        #pragma clang diagnostic ignored "-Wdeprecated-declarations"
+        queueLabel = dispatch_queue_get_label(dispatch_get_current_queue());
+        #pragma clang diagnostic pop
+    }
+    strlcpy(record->queueLabel, queueLabel ?: "", sizeof(record->queueLabel));
+}
+
+static AWSDDLogMessage *AWSDDLogMessageFromRecord(AWSDDLogRecord *record) {
+    if (record->isLogMessage) {
+        AWSDDLogMessage *logMessage = CFBridgingRelease(record->message);
+        record->message = NULL;
+        return logMessage;
+    }
+
+    // Same as initWithMessage:level:flag:context:file:function:line:tag:options:timestamp:,
+    // with the context captured by the logging thread.
+
+    AWSDDLogMessage *logMessage = [AWSDDLogMessage new];
+    logMessage->_message = record->message ? CFBridgingRelease(record->message) : nil;
+    if (record->format) {
+        logMessage->_format = CFBridgingRelease(record->format);
+        logMessage->_arguments = AWSDDLogArgumentsArchive(record->arguments, record->argumentsLength);
+    }
+    logMessage->_level = record->level;
+    logMessage->_flag = record->flag;
+    logMessage->_context = record->context;
+    logMessage->_file = [NSString stringWithFormat:@"%s", record->file];
+    logMessage->_function = [NSString stringWithFormat:@"%s", record->function];
+    logMessage->_line = record->line;
+    logMessage->_tag = record->tag ? CFBridgingRelease(record->tag) : nil;
+    logMessage->_options = (AWSDDLogMessageOptions)0;
+    logMessage->_timestamp = [NSDate dateWithTimeIntervalSinceReferenceDate:record->timestamp];
+
+    if (USE_PTHREAD_THREADID_NP) {
+        logMessage->_threadID = [[NSString alloc] initWithFormat:@"%llu", record->threadID];
+    } else {
+        logMessage->_threadID = [[NSString alloc] initWithFormat:@"%x", (unsigned int)record->threadID];
+    }
+    logMessage->_threadName = record->threadName ? CFBridgingRelease(record->threadName) : nil;
+
+    // Get the file name without extension
+    NSString *fileName = [logMessage->_file lastPathComponent];
+    NSUInteger dotLocation = [fileName rangeOfString:@"." options:NSBackwardsSearch].location;
+    if (dotLocation != NSNotFound)
+    {
+        fileName = [fileName substringToIndex:dotLocation];
+    }
+    logMessage->_fileName = fileName;
+
+    logMessage->_queueLabel = [[NSString alloc] initWithUTF8String:record->queueLabel] ?: @"";
+
+    record->message = NULL;
+    record->format = NULL;
+    record->argumentsLength = 0;
+    record->tag = NULL;
+    record->threadName = NULL;
+    return logMessage;
+}
+
+static void AWSDDLogRecordRelease(AWSDDLogRecord *record) {
+    if (record->message) {
+        CFRelease(record->message);
+    }
+    if (!record->isLogMessage) {
+        if (record->tag) {
+            CFRelease(record->tag);
+        }
+        if (record->threadName) {
+            CFRelease(record->threadName);
+        }
+    }
+    if (record->format) {
+        CFRelease(record->format);
+        AWSDDLogArgumentsRelease(record->arguments, record->argumentsLength);
+    }
+    record->message = NULL;
+    record->format = NULL;
+    record->argumentsLength = 0;
+    record->tag = NULL;
+    record->threadName = NULL;
+}
+
 - (instancetype)init {
     self = [super init];
     return self;
@@ -1198,6 +1516,8 @@ static __inline__ __attribute__((__always_inline__)) void _dispatch_queue_label_
     newMessage->_threadID = _threadID;
     newMessage->_threadName = _threadName;
     newMessage->_queueLabel = _queueLabel;
+    newMessage->_format = _format;
+    newMessage->_arguments = _arguments;
 
     return newMessage;
 }
@@ -0,0 +1,68 @@
+//
+// Copyright 2010-2021 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License.
+// A copy of the License is located at
+//
+// http://aws.amazon.com/apache2.0
+//
+// or in the "license" file accompanying this file. This file is distributed
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+//
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+// The arguments of a log statement whose formatting is deferred, packed in the
+// order of the conversions of its format string. Each argument is a type byte
+// followed by its value, in the byte order of the device (little-endian on all
+// the supported architectures):
+//
+//     'i'  a signed integer, 8 bytes (d, i, D, c and the * widths and precisions)
+//     'u'  an unsigned integer, 8 bytes (o, u, x, X, O, U and C)
+//     'f'  a double, 8 bytes (e, E, f, F, g, G, a and A)
+//     'p'  a pointer, 8 bytes (p)
+//     's'  a string, a 4 byte length followed by that many bytes of UTF-8 (s, S and @)
+//     '@'  a retained object, 8 bytes (@). Only in the arguments captured by the
+//          logging thread; `AWSDDLogArgumentsArchive` replaces them with strings.
+//
+// `Scripts/decode-binary-log.py` reads the same layout.
+typedef NS_ENUM(uint8_t, AWSDDLogArgumentType) {
+    AWSDDLogArgumentTypeSigned = 'i',
+    AWSDDLogArgumentTypeUnsigned = 'u',
+    AWSDDLogArgumentTypeDouble = 'f',
+    AWSDDLogArgumentTypePointer = 'p',
+    AWSDDLogArgumentTypeString = 's',
+    AWSDDLogArgumentTypeObject = '@',
+};
+
+// Packs the arguments of the format string into the buffer. Immutable values
+// (strings, numbers, dates, UUIDs and URLs) passed for %@ are retained, other
+// objects are described right away, since they may change before the
+// statement is formatted.
+//
+// Returns NO if the arguments do not fit in the buffer, or if the format
+// string uses a conversion which cannot be deferred (positional arguments and
+// %n). The arguments retained so far are released, and `args` must not be
+// used again; the caller formats a copy of its `va_list` instead.
+BOOL AWSDDLogArgumentsEncode(NSString *format,
+                             va_list args,
+                             uint8_t *buffer,
+                             NSUInteger capacity,
+                             NSUInteger *length);
+
+// Replaces the retained objects of the arguments by their description.
+NSData *AWSDDLogArgumentsArchive(const uint8_t *buffer, NSUInteger length);
+
+// Releases the retained objects of arguments which are not archived.
+void AWSDDLogArgumentsRelease(const uint8_t *buffer, NSUInteger length);
+
+// Formats archived arguments, as `-[NSString initWithFormat:arguments:]` would
+// have formatted the original arguments.
+NSString *AWSDDLogArgumentsFormat(NSString *format, NSData *arguments);
+
+NS_ASSUME_NONNULL_END
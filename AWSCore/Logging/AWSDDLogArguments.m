@@ -0,0 +1,584 @@
+//
+// Copyright 2010-2021 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License.
+// A copy of the License is located at
+//
+// http://aws.amazon.com/apache2.0
+//
+// or in the "license" file accompanying this file. This file is distributed
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+//
+
+#import "AWSDDLogArguments.h"
+
+#import <ctype.h>
+#import <stddef.h>
+#import <stdint.h>
+#import <stdlib.h>
+#import <string.h>
+#import <wchar.h>
+
+typedef NS_ENUM(NSInteger, AWSDDLogLengthModifier) {
+    AWSDDLogLengthModifierNone,
+    AWSDDLogLengthModifierChar,       // hh
+    AWSDDLogLengthModifierShort,      // h
+    AWSDDLogLengthModifierLong,       // l
+    AWSDDLogLengthModifierLongLong,   // ll, q
+    AWSDDLogLengthModifierLongDouble, // L
+    AWSDDLogLengthModifierSize,       // z
+    AWSDDLogLengthModifierPtrDiff,    // t
+    AWSDDLogLengthModifierIntMax,     // j
+};
+
+// A conversion specification: %[flags][width][.precision][length modifier]conversion
+typedef struct AWSDDLogConversion {
+    const char *start;
+    const char *end;
+    const char *flags;
+    NSUInteger flagsLength;
+    const char *width;
+    NSUInteger widthLength;
+    BOOL widthStar;
+    BOOL hasPrecision;
+    const char *precision;
+    NSUInteger precisionLength;
+    BOOL precisionStar;
+    BOOL positional;
+    AWSDDLogLengthModifier lengthModifier;
+    // '%' for "%%", or 0 for a specification cut short by the end of the string.
+    char conversion;
+} AWSDDLogConversion;
+
+// wchar_t holds UTF-32 in the byte order of the host.
+#if __BIG_ENDIAN__
+static const NSStringEncoding AWSDDLogWideStringEncoding = NSUTF32BigEndianStringEncoding;
+#else
+static const NSStringEncoding AWSDDLogWideStringEncoding = NSUTF32LittleEndianStringEncoding;
+#endif
+
+static const char *AWSDDLogFormatCString(NSString *format) {
+    // Constant strings usually give access to their bytes without a copy.
+    const char *cformat = CFStringGetCStringPtr((__bridge CFStringRef)format, kCFStringEncodingUTF8);
+    return cformat ?: [format UTF8String];
+}
+
+static BOOL AWSDDLogNextConversion(const char *p, AWSDDLogConversion *conversion) {
+    const char *s = strchr(p, '%');
+    if (!s) {
+        return NO;
+    }
+
+    memset(conversion, 0, sizeof(AWSDDLogConversion));
+    conversion->start = s;
+    s++;
+
+    const char *digits = s;
+    while (isdigit((unsigned char)*digits)) {
+        digits++;
+    }
+    if (digits > s && *digits == '$') {
+        conversion->positional = YES;
+        conversion->end = digits + 1;
+        return YES;
+    }
+
+    conversion->flags = s;
+    while (*s && strchr("-+ #0'", *s)) {
+        s++;
+    }
+    conversion->flagsLength = (NSUInteger)(s - conversion->flags);
+
+    conversion->width = s;
+    if (*s == '*') {
+        conversion->widthStar = YES;
+        s++;
+    } else {
+        while (isdigit((unsigned char)*s)) {
+            s++;
+        }
+    }
+    conversion->widthLength = (NSUInteger)(s - conversion->width);
+
+    if (*s == '.') {
+        conversion->hasPrecision = YES;
+        s++;
+        conversion->precision = s;
+        if (*s == '*') {
+            conversion->precisionStar = YES;
+            s++;
+        } else {
+            while (isdigit((unsigned char)*s)) {
+                s++;
+            }
+        }
+        conversion->precisionLength = (NSUInteger)(s - conversion->precision);
+    }
+
+    switch (*s) {
+        case 'h':
+            s++;
+            if (*s == 'h') {
+                s++;
+                conversion->lengthModifier = AWSDDLogLengthModifierChar;
+            } else {
+                conversion->lengthModifier = AWSDDLogLengthModifierShort;
+            }
+            break;
+        case 'l':
+            s++;
+            if (*s == 'l') {
+                s++;
+                conversion->lengthModifier = AWSDDLogLengthModifierLongLong;
+            } else {
+                conversion->lengthModifier = AWSDDLogLengthModifierLong;
+            }
+            break;
+        case 'q':
+            s++;
+            conversion->lengthModifier = AWSDDLogLengthModifierLongLong;
+            break;
+        case 'L':
+            s++;
+            conversion->lengthModifier = AWSDDLogLengthModifierLongDouble;
+            break;
+        case 'z':
+            s++;
+            conversion->lengthModifier = AWSDDLogLengthModifierSize;
+            break;
+        case 't':
+            s++;
+            conversion->lengthModifier = AWSDDLogLengthModifierPtrDiff;
+            break;
+        case 'j':
+            s++;
+            conversion->lengthModifier = AWSDDLogLengthModifierIntMax;
+            break;
+        default:
+            break;
+    }
+
+    conversion->conversion = *s;
+    conversion->end = *s ? s + 1 : s;
+    return YES;
+}
+
+#pragma mark - Encoding
+
+static BOOL AWSDDLogPutValue(uint8_t *buffer, NSUInteger capacity, NSUInteger *position, AWSDDLogArgumentType type, uint64_t value) {
+    if (capacity - *position < 1 + sizeof(uint64_t)) {
+        return NO;
+    }
+    buffer[*position] = type;
+    memcpy(buffer + *position + 1, &value, sizeof(uint64_t));
+    *position += 1 + sizeof(uint64_t);
+    return YES;
+}
+
+static BOOL AWSDDLogPutString(uint8_t *buffer, NSUInteger capacity, NSUInteger *position, const char *bytes, NSUInteger length) {
+    if (length > UINT32_MAX || capacity - *position < 1 + sizeof(uint32_t) + length) {
+        return NO;
+    }
+    uint32_t stringLength = (uint32_t)length;
+    buffer[*position] = AWSDDLogArgumentTypeString;
+    memcpy(buffer + *position + 1, &stringLength, sizeof(uint32_t));
+    memcpy(buffer + *position + 1 + sizeof(uint32_t), bytes, length);
+    *position += 1 + sizeof(uint32_t) + length;
+    return YES;
+}
+
+static BOOL AWSDDLogPutObject(uint8_t *buffer, NSUInteger capacity, NSUInteger *position, id object) {
+    if (!object) {
+        return AWSDDLogPutString(buffer, capacity, position, "(null)", 6);
+    }
+
+    if ([object isKindOfClass:[NSString class]]
+        || [object isKindOfClass:[NSNumber class]]
+        || [object isKindOfClass:[NSDate class]]
+        || [object isKindOfClass:[NSUUID class]]
+        || [object isKindOfClass:[NSURL class]]) {
+        if (capacity - *position < 1 + sizeof(uint64_t)) {
+            return NO;
+        }
+        // The copy of an immutable value is the value itself; a mutable string is copied as it is now.
+        uint64_t value = (uint64_t)(uintptr_t)CFBridgingRetain([object copy]);
+        return AWSDDLogPutValue(buffer, capacity, position, AWSDDLogArgumentTypeObject, value);
+    }
+
+    const char *description = [[object description] UTF8String] ?: "(null)";
+    return AWSDDLogPutString(buffer, capacity, position, description, strlen(description));
+}
+
+// The most characters %s, %ls and %S read from their argument, which does not need to be terminated within them.
+// A negative * precision is taken as if the precision were omitted.
+static size_t AWSDDLogStringPrecision(const AWSDDLogConversion *conversion, int precisionArgument) {
+    if (!conversion->hasPrecision) {
+        return SIZE_MAX;
+    }
+    if (conversion->precisionStar) {
+        return precisionArgument < 0 ? SIZE_MAX : (size_t)precisionArgument;
+    }
+    size_t precision = 0;
+    for (NSUInteger i = 0; i < conversion->precisionLength; i++) {
+        precision = precision * 10 + (size_t)(conversion->precision[i] - '0');
+    }
+    return precision;
+}
+
+BOOL AWSDDLogArgumentsEncode(NSString *format,
+                             va_list args,
+                             uint8_t *buffer,
+                             NSUInteger capacity,
+                             NSUInteger *length) {
+    const char *cformat = AWSDDLogFormatCString(format);
+    NSUInteger position = 0;
+    AWSDDLogConversion conversion;
+    const char *p = cformat;
+
+    while (AWSDDLogNextConversion(p, &conversion)) {
+        p = conversion.end;
+        if (conversion.conversion == '%') {
+            continue;
+        }
+        if (conversion.positional || conversion.conversion == '\0') {
+            goto fail;
+        }
+
+        if (conversion.widthStar
+            && !AWSDDLogPutValue(buffer, capacity, &position, AWSDDLogArgumentTypeSigned, (uint64_t)(int64_t)va_arg(args, int))) {
+            goto fail;
+        }
+        int precisionArgument = 0;
+        if (conversion.precisionStar) {
+            precisionArgument = va_arg(args, int);
+            if (!AWSDDLogPutValue(buffer, capacity, &position, AWSDDLogArgumentTypeSigned, (uint64_t)(int64_t)precisionArgument)) {
+                goto fail;
+            }
+        }
+
+        BOOL fits = NO;
+        switch (conversion.conversion) {
+            case 'd':
+            case 'i':
+            case 'D': {
+                int64_t value;
+                switch (conversion.conversion == 'D' ? AWSDDLogLengthModifierLong : conversion.lengthModifier) {
+                    case AWSDDLogLengthModifierLong: value = va_arg(args, long); break;
+                    case AWSDDLogLengthModifierLongLong: value = va_arg(args, long long); break;
+                    case AWSDDLogLengthModifierSize: value = va_arg(args, ssize_t); break;
+                    case AWSDDLogLengthModifierPtrDiff: value = va_arg(args, ptrdiff_t); break;
+                    case AWSDDLogLengthModifierIntMax: value = va_arg(args, intmax_t); break;
+                    // char and short are promoted to int.
+                    case AWSDDLogLengthModifierChar: value = (signed char)va_arg(args, int); break;
+                    case AWSDDLogLengthModifierShort: value = (short)va_arg(args, int); break;
+                    default: value = va_arg(args, int); break;
+                }
+                fits = AWSDDLogPutValue(buffer, capacity, &position, AWSDDLogArgumentTypeSigned, (uint64_t)value);
+                break;
+            }
+            case 'o':
+            case 'u':
+            case 'x':
+            case 'X':
+            case 'O':
+            case 'U': {
+                uint64_t value;
+                switch ((conversion.conversion == 'O' || conversion.conversion == 'U') ? AWSDDLogLengthModifierLong : conversion.lengthModifier) {
+                    case AWSDDLogLengthModifierLong: value = va_arg(args, unsigned long); break;
+                    case AWSDDLogLengthModifierLongLong: value = va_arg(args, unsigned long long); break;
+                    case AWSDDLogLengthModifierSize: value = va_arg(args, size_t); break;
+                    case AWSDDLogLengthModifierPtrDiff: value = (uint64_t)va_arg(args, ptrdiff_t); break;
+                    case AWSDDLogLengthModifierIntMax: value = va_arg(args, uintmax_t); break;
+                    case AWSDDLogLengthModifierChar: value = (unsigned char)va_arg(args, unsigned int); break;
+                    case AWSDDLogLengthModifierShort: value = (unsigned short)va_arg(args, unsigned int); break;
+                    default: value = va_arg(args, unsigned int); break;
+                }
+                fits = AWSDDLogPutValue(buffer, capacity, &position, AWSDDLogArgumentTypeUnsigned, value);
+                break;
+            }
+            case 'c':
+                fits = AWSDDLogPutValue(buffer, capacity, &position, AWSDDLogArgumentTypeSigned, (uint64_t)(int64_t)va_arg(args, int));
+                break;
+            case 'C':
+                fits = AWSDDLogPutValue(buffer, capacity, &position, AWSDDLogArgumentTypeUnsigned, (uint64_t)va_arg(args, unsigned int));
+                break;
+            case 'e':
+            case 'E':
+            case 'f':
+            case 'F':
+            case 'g':
+            case 'G':
+            case 'a':
+            case 'A': {
+                double value;
+                if (conversion.lengthModifier == AWSDDLogLengthModifierLongDouble) {
+                    value = (double)va_arg(args, long double);
+                } else {
+                    value = va_arg(args, double);
+                }
+                uint64_t bits;
+                memcpy(&bits, &value, sizeof(uint64_t));
+                fits = AWSDDLogPutValue(buffer, capacity, &position, AWSDDLogArgumentTypeDouble, bits);
+                break;
+            }
+            case 'p':
+                fits = AWSDDLogPutValue(buffer, capacity, &position, AWSDDLogArgumentTypePointer, (uint64_t)(uintptr_t)va_arg(args, void *));
+                break;
+            case 's': {
+                size_t precision = AWSDDLogStringPrecision(&conversion, precisionArgument);
+                if (conversion.lengthModifier == AWSDDLogLengthModifierLong) {
+                    const wchar_t *wideString = va_arg(args, const wchar_t *);
+                    if (!wideString) {
+                        fits = AWSDDLogPutString(buffer, capacity, &position, "(null)", 6);
+                        break;
+                    }
+                    NSString *decodedString = [[NSString alloc] initWithBytes:wideString
+                                                                       length:wcsnlen(wideString, precision) * sizeof(wchar_t)
+                                                                     encoding:AWSDDLogWideStringEncoding];
+                    const char *string = [decodedString UTF8String] ?: "";
+                    fits = AWSDDLogPutString(buffer, capacity, &position, string, strlen(string));
+                    break;
+                }
+                const char *string = va_arg(args, const char *) ?: "(null)";
+                fits = AWSDDLogPutString(buffer, capacity, &position, string, strnlen(string, precision));
+                break;
+            }
+            case 'S': {
+                const unichar *characters = va_arg(args, const unichar *);
+                if (!characters) {
+                    fits = AWSDDLogPutString(buffer, capacity, &position, "(null)", 6);
+                } else {
+                    size_t precision = AWSDDLogStringPrecision(&conversion, precisionArgument);
+                    NSUInteger charactersLength = 0;
+                    while (charactersLength < precision && characters[charactersLength]) {
+                        charactersLength++;
+                    }
+                    const char *string = [[NSString stringWithCharacters:characters length:charactersLength] UTF8String] ?: "";
+                    fits = AWSDDLogPutString(buffer, capacity, &position, string, strlen(string));
+                }
+                break;
+            }
+            case '@':
+                fits = AWSDDLogPutObject(buffer, capacity, &position, va_arg(args, id));
+                break;
+            default:
+                // %n, or a conversion unknown to NSString.
+                break;
+        }
+        if (!fits) {
+            goto fail;
+        }
+    }
+
+    *length = position;
+    return YES;
+
+fail:
+    AWSDDLogArgumentsRelease(buffer, position);
+    return NO;
+}
+
+#pragma mark - Decoding
+
+typedef struct AWSDDLogArgument {
+    AWSDDLogArgumentType type;
+    uint64_t value;
+    const uint8_t *bytes;
+    uint32_t length;
+} AWSDDLogArgument;
+
+static BOOL AWSDDLogReadArgument(const uint8_t *buffer, NSUInteger length, NSUInteger *position, AWSDDLogArgument *argument) {
+    if (*position >= length) {
+        return NO;
+    }
+    argument->type = buffer[*position];
+    if (argument->type == AWSDDLogArgumentTypeString) {
+        if (length - *position < 1 + sizeof(uint32_t)) {
+            return NO;
+        }
+        memcpy(&argument->length, buffer + *position + 1, sizeof(uint32_t));
+        if (length - *position - 1 - sizeof(uint32_t) < argument->length) {
+            return NO;
+        }
+        argument->bytes = buffer + *position + 1 + sizeof(uint32_t);
+        *position += 1 + sizeof(uint32_t) + argument->length;
+    } else {
+        if (length - *position < 1 + sizeof(uint64_t)) {
+            return NO;
+        }
+        memcpy(&argument->value, buffer + *position + 1, sizeof(uint64_t));
+        *position += 1 + sizeof(uint64_t);
+    }
+    return YES;
+}
+
+NSData *AWSDDLogArgumentsArchive(const uint8_t *buffer, NSUInteger length) {
+    NSMutableData *archive = [NSMutableData dataWithCapacity:length];
+    NSUInteger position = 0;
+    NSUInteger start = 0;
+    AWSDDLogArgument argument;
+    while (AWSDDLogReadArgument(buffer, length, &position, &argument)) {
+        if (argument.type == AWSDDLogArgumentTypeObject) {
+            id object = CFBridgingRelease((CFTypeRef)(uintptr_t)argument.value);
+            NSData *description = [[object description] dataUsingEncoding:NSUTF8StringEncoding] ?: [NSData data];
+            uint8_t type = AWSDDLogArgumentTypeString;
+            uint32_t descriptionLength = (uint32_t)[description length];
+            [archive appendBytes:&type length:1];
+            [archive appendBytes:&descriptionLength length:sizeof(uint32_t)];
+            [archive appendData:description];
+        } else {
+            [archive appendBytes:buffer + start length:position - start];
+        }
+        start = position;
+    }
+    return archive;
+}
+
+void AWSDDLogArgumentsRelease(const uint8_t *buffer, NSUInteger length) {
+    NSUInteger position = 0;
+    AWSDDLogArgument argument;
+    while (AWSDDLogReadArgument(buffer, length, &position, &argument)) {
+        if (argument.type == AWSDDLogArgumentTypeObject) {
+            CFRelease((CFTypeRef)(uintptr_t)argument.value);
+        }
+    }
+}
+
+static NSString *AWSDDLogStringWithBytes(const char *bytes, NSUInteger length) {
+    return [[NSString alloc] initWithBytes:bytes length:length encoding:NSUTF8StringEncoding] ?: @"";
+}
+
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wformat-nonliteral"
+
+NSString *AWSDDLogArgumentsFormat(NSString *format, NSData *arguments) {
+    const char *cformat = AWSDDLogFormatCString(format);
+    const uint8_t *buffer = [arguments bytes];
+    NSUInteger length = [arguments length];
+    NSUInteger position = 0;
+
+    NSMutableString *string = [NSMutableString stringWithCapacity:[format length] + length];
+    AWSDDLogConversion conversion;
+    AWSDDLogArgument argument;
+    const char *p = cformat;
+
+    while (AWSDDLogNextConversion(p, &conversion)) {
+        [string appendString:AWSDDLogStringWithBytes(p, (NSUInteger)(conversion.start - p))];
+        p = conversion.end;
+
+        if (conversion.conversion == '%') {
+            [string appendString:@"%"];
+            continue;
+        }
+        if (conversion.positional || conversion.conversion == '\0') {
+            [string appendString:AWSDDLogStringWithBytes(conversion.start, (NSUInteger)(conversion.end - conversion.start))];
+            continue;
+        }
+
+        // Rebuild the specification for the type of the packed argument.
+        NSMutableString *specification = [NSMutableString stringWithString:@"%"];
+        [specification appendString:AWSDDLogStringWithBytes(conversion.flags, conversion.flagsLength)];
+        if (conversion.widthStar) {
+            if (!AWSDDLogReadArgument(buffer, length, &position, &argument)) {
+                goto malformed;
+            }
+            [specification appendFormat:@"%lld", (long long)argument.value];
+        } else {
+            [specification appendString:AWSDDLogStringWithBytes(conversion.width, conversion.widthLength)];
+        }
+        if (conversion.hasPrecision) {
+            [specification appendString:@"."];
+            if (conversion.precisionStar) {
+                if (!AWSDDLogReadArgument(buffer, length, &position, &argument)) {
+                    goto malformed;
+                }
+                [specification appendFormat:@"%lld", (long long)argument.value];
+            } else {
+                [specification appendString:AWSDDLogStringWithBytes(conversion.precision, conversion.precisionLength)];
+            }
+        }
+
+        if (!AWSDDLogReadArgument(buffer, length, &position, &argument)) {
+            goto malformed;
+        }
+
+        switch (conversion.conversion) {
+            case 'd':
+            case 'i':
+            case 'D':
+                [specification appendString:@"lld"];
+                [string appendFormat:specification, (long long)argument.value];
+                break;
+            case 'o':
+            case 'u':
+            case 'x':
+            case 'X':
+            case 'O':
+            case 'U':
+                [specification appendFormat:@"ll%c", conversion.conversion == 'O' ? 'o' : conversion.conversion == 'U' ? 'u' : conversion.conversion];
+                [string appendFormat:specification, (unsigned long long)argument.value];
+                break;
+            case 'c':
+                [specification appendString:@"c"];
+                [string appendFormat:specification, (int)argument.value];
+                break;
+            case 'C':
+                [specification appendString:@"C"];
+                [string appendFormat:specification, (unichar)argument.value];
+                break;
+            case 'e':
+            case 'E':
+            case 'f':
+            case 'F':
+            case 'g':
+            case 'G':
+            case 'a':
+            case 'A': {
+                double value;
+                memcpy(&value, &argument.value, sizeof(double));
+                [specification appendFormat:@"%c", conversion.conversion];
+                [string appendFormat:specification, value];
+                break;
+            }
+            case 'p':
+                [specification appendString:@"p"];
+                [string appendFormat:specification, (void *)(uintptr_t)argument.value];
+                break;
+            case 's':
+                // %ls was packed as UTF-8, and is formatted as a string object like %S.
+                if (argument.type == AWSDDLogArgumentTypeString && conversion.lengthModifier != AWSDDLogLengthModifierLong) {
+                    // Format the bytes as %s would have, whatever their encoding.
+                    char *cstring = strndup((const char *)argument.bytes, argument.length);
+                    [specification appendString:@"s"];
+                    [string appendFormat:specification, cstring];
+                    free(cstring);
+                    break;
+                }
+                // Fall through
+            default: {
+                // S, ls and @
+                id object = nil;
+                if (argument.type == AWSDDLogArgumentTypeString) {
+                    object = AWSDDLogStringWithBytes((const char *)argument.bytes, argument.length);
+                } else if (argument.type == AWSDDLogArgumentTypeObject) {
+                    object = (__bridge id)(CFTypeRef)(uintptr_t)argument.value;
+                }
+                [specification appendString:@"@"];
+                [string appendFormat:specification, object];
+                break;
+            }
+        }
+    }
+
+    [string appendString:AWSDDLogStringWithBytes(p, strlen(p))];
+    return string;
+
+malformed:
+    [string appendString:AWSDDLogStringWithBytes(conversion.start, strlen(conversion.start))];
+    return string;
+}
+
+#pragma clang diagnostic pop
@@ -0,0 +1,94 @@
+//
+// Copyright 2010-2021 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License.
+// A copy of the License is located at
+//
+// http://aws.amazon.com/apache2.0
+//
+// or in the "license" file accompanying this file. This file is distributed
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+//
+
+#import <Foundation/Foundation.h>
+
+#import "AWSDDLog.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+// The maximum length of the queue label kept in a record, including the terminating NUL.
+#define AWSDD_LOG_RECORD_QUEUE_LABEL_SIZE 64
+
+// The maximum lengths of the file and function names kept in a record, including the terminating NUL.
+// A longer file path keeps its end, so that the file name survives, and a longer function name keeps its start.
+#define AWSDD_LOG_RECORD_FILE_SIZE 256
+#define AWSDD_LOG_RECORD_FUNCTION_SIZE 128
+
+// The maximum size of the packed arguments of a statement whose formatting is deferred.
+#define AWSDD_LOG_RECORD_ARGUMENTS_SIZE 160
+
+// A log statement as captured by the logging thread. Everything which is costly
+// to compute (the `AWSDDLogMessage`, the file and function `NSString`s, the
+// timestamp and thread identifier strings) is left to the consumer.
+//
+// The object pointers are retained by the producer with `CFBridgingRetain` and
+// released by the consumer.
+typedef struct AWSDDLogRecord {
+    // An `AWSDDLogMessage` if `isLogMessage` is set, or else the `NSString` message,
+    // or NULL if the formatting is deferred.
+    CFTypeRef _Nullable message;
+    // The format string and the packed arguments (see `AWSDDLogArguments.h`) of a
+    // statement whose formatting is deferred.
+    CFTypeRef _Nullable format;
+    CFTypeRef _Nullable tag;
+    CFTypeRef _Nullable threadName;
+    NSUInteger line;
+    NSInteger context;
+    AWSDDLogLevel level;
+    AWSDDLogFlag flag;
+    CFAbsoluteTime timestamp;
+    uint64_t threadID;
+    BOOL isLogMessage;
+    char queueLabel[AWSDD_LOG_RECORD_QUEUE_LABEL_SIZE];
+    // Copied, because the caller's strings are not always literals and may be freed before the record is read.
+    char file[AWSDD_LOG_RECORD_FILE_SIZE];
+    char function[AWSDD_LOG_RECORD_FUNCTION_SIZE];
+    NSUInteger argumentsLength;
+    uint8_t arguments[AWSDD_LOG_RECORD_ARGUMENTS_SIZE];
+} AWSDDLogRecord;
+
+// A bounded queue of preallocated records, with any number of producers and a
+// single consumer. Producers claim a record, fill it in and commit it; the
+// consumer reads the committed records in order and frees their slots. Neither
+// side takes a lock.
+typedef struct AWSDDLogRingBuffer AWSDDLogRingBuffer;
+
+// The capacity is rounded up to a power of 2.
+AWSDDLogRingBuffer *AWSDDLogRingBufferCreate(NSUInteger capacity);
+void AWSDDLogRingBufferDestroy(AWSDDLogRingBuffer *ringBuffer);
+
+NSUInteger AWSDDLogRingBufferCapacity(AWSDDLogRingBuffer *ringBuffer);
+
+// Claims the next free record, or returns NULL if the ring buffer is full.
+AWSDDLogRecord * _Nullable AWSDDLogRingBufferClaim(AWSDDLogRingBuffer *ringBuffer);
+
+// Makes a claimed record visible to the consumer.
+void AWSDDLogRingBufferCommit(AWSDDLogRingBuffer *ringBuffer, AWSDDLogRecord *record);
+
+// Consumer only. Returns the oldest record if it is committed, or NULL. The
+// record stays in the ring buffer until `AWSDDLogRingBufferConsume` is called.
+AWSDDLogRecord * _Nullable AWSDDLogRingBufferPeek(AWSDDLogRingBuffer *ringBuffer);
+
+// Consumer only. Frees the slot of the record returned by the last peek.
+void AWSDDLogRingBufferConsume(AWSDDLogRingBuffer *ringBuffer);
+
+// Consumer only. Whether the oldest record is committed, like a peek, but with
+// a sequentially consistent load: a consumer which clears its "draining" flag
+// and then finds no committed record knows that the producer of the next
+// record will see the flag cleared after committing it.
+BOOL AWSDDLogRingBufferHasCommittedRecord(AWSDDLogRingBuffer *ringBuffer);
+
+NS_ASSUME_NONNULL_END
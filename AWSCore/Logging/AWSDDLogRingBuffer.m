@@ -0,0 +1,118 @@
+//
+// Copyright 2010-2021 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License.
+// A copy of the License is located at
+//
+// http://aws.amazon.com/apache2.0
+//
+// or in the "license" file accompanying this file. This file is distributed
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+//
+
+#import "AWSDDLogRingBuffer.h"
+
+#import <stdatomic.h>
+#import <stdlib.h>
+
+// Each slot carries a sequence number (see Dmitry Vyukov's bounded MPMC queue).
+// A slot at position p is free for the producer which claims position p when
+// its sequence is p, holds a committed record when its sequence is p + 1, and
+// becomes free for position p + capacity once it is consumed.
+typedef struct AWSDDLogRingBufferSlot {
+    AWSDDLogRecord record;
+    _Atomic(uint64_t) sequence;
+    uint64_t position;
+} AWSDDLogRingBufferSlot;
+
+struct AWSDDLogRingBuffer {
+    AWSDDLogRingBufferSlot *slots;
+    uint64_t mask;
+    // The producers and the consumer positions are kept on separate cache lines.
+    _Alignas(64) _Atomic(uint64_t) claimPosition;
+    _Alignas(64) uint64_t consumePosition;
+};
+
+AWSDDLogRingBuffer *AWSDDLogRingBufferCreate(NSUInteger capacity) {
+    uint64_t roundedCapacity = 2;
+    while (roundedCapacity < capacity) {
+        roundedCapacity <<= 1;
+    }
+
+    AWSDDLogRingBuffer *ringBuffer = NULL;
+    posix_memalign((void **)&ringBuffer, 64, sizeof(AWSDDLogRingBuffer));
+    memset(ringBuffer, 0, sizeof(AWSDDLogRingBuffer));
+    ringBuffer->slots = calloc(roundedCapacity, sizeof(AWSDDLogRingBufferSlot));
+    ringBuffer->mask = roundedCapacity - 1;
+    for (uint64_t i = 0; i < roundedCapacity; i++) {
+        atomic_init(&ringBuffer->slots[i].sequence, i);
+    }
+    atomic_init(&ringBuffer->claimPosition, 0);
+    ringBuffer->consumePosition = 0;
+    return ringBuffer;
+}
+
+void AWSDDLogRingBufferDestroy(AWSDDLogRingBuffer *ringBuffer) {
+    free(ringBuffer->slots);
+    free(ringBuffer);
+}
+
+NSUInteger AWSDDLogRingBufferCapacity(AWSDDLogRingBuffer *ringBuffer) {
+    return (NSUInteger)(ringBuffer->mask + 1);
+}
+
+AWSDDLogRecord *AWSDDLogRingBufferClaim(AWSDDLogRingBuffer *ringBuffer) {
+    uint64_t position = atomic_load_explicit(&ringBuffer->claimPosition, memory_order_relaxed);
+    while (YES) {
+        AWSDDLogRingBufferSlot *slot = &ringBuffer->slots[position & ringBuffer->mask];
+        uint64_t sequence = atomic_load_explicit(&slot->sequence, memory_order_acquire);
+        int64_t difference = (int64_t)(sequence - position);
+        if (difference == 0) {
+            // On failure, `position` is updated to the current claim position.
+            if (atomic_compare_exchange_weak_explicit(&ringBuffer->claimPosition, &position, position + 1,
+                                                      memory_order_relaxed, memory_order_relaxed)) {
+                slot->position = position;
+                return &slot->record;
+            }
+        } else if (difference < 0) {
+            // The slot still holds the record of the previous lap.
+            return NULL;
+        } else {
+            position = atomic_load_explicit(&ringBuffer->claimPosition, memory_order_relaxed);
+        }
+    }
+}
+
+void AWSDDLogRingBufferCommit(AWSDDLogRingBuffer *ringBuffer, AWSDDLogRecord *record) {
+    AWSDDLogRingBufferSlot *slot = (AWSDDLogRingBufferSlot *)record;
+    // Sequentially consistent, so that a consumer which stops draining and then
+    // checks for a committed record cannot miss a record whose producer saw the
+    // consumer still draining.
+    atomic_store_explicit(&slot->sequence, slot->position + 1, memory_order_seq_cst);
+}
+
+AWSDDLogRecord *AWSDDLogRingBufferPeek(AWSDDLogRingBuffer *ringBuffer) {
+    uint64_t position = ringBuffer->consumePosition;
+    AWSDDLogRingBufferSlot *slot = &ringBuffer->slots[position & ringBuffer->mask];
+    uint64_t sequence = atomic_load_explicit(&slot->sequence, memory_order_acquire);
+    if (sequence != position + 1) {
+        return NULL;
+    }
+    return &slot->record;
+}
+
+void AWSDDLogRingBufferConsume(AWSDDLogRingBuffer *ringBuffer) {
+    uint64_t position = ringBuffer->consumePosition;
+    AWSDDLogRingBufferSlot *slot = &ringBuffer->slots[position & ringBuffer->mask];
+    ringBuffer->consumePosition = position + 1;
+    atomic_store_explicit(&slot->sequence, position + ringBuffer->mask + 1, memory_order_release);
+}
+
+BOOL AWSDDLogRingBufferHasCommittedRecord(AWSDDLogRingBuffer *ringBuffer) {
+    uint64_t position = ringBuffer->consumePosition;
+    AWSDDLogRingBufferSlot *slot = &ringBuffer->slots[position & ringBuffer->mask];
+    return atomic_load_explicit(&slot->sequence, memory_order_seq_cst) == position + 1;
+}
@@ -54,6 +54,31 @@
 
 @end
 
+// Adopted by JSON dictionaries whose values are expensive to look up, because
+// they are decoded on first access.
+//
+// A model parsed from such a dictionary does not read all of its properties
+// up front. Each object property is read from the dictionary and transformed
+// the first time it is accessed, and the dictionary is kept alive until then.
+// Errors which occur while reading a property this way are logged, leave the
+// property nil, and are returned by
+// +[AWSMTLJSONAdapter lazyDecodingErrorForModel:].
+//
+// Such a model is an instance of a subclass of its model class, created at
+// runtime. `-class` returns the model class, so that comparing, copying and
+// archiving the model behaves the same as for an eagerly parsed one, but
+// `object_getClass()`, `type(of:)` in Swift and key-value observing see the
+// subclass.
+@protocol AWSMTLJSONLazyDecoding
+
+@optional
+
+// Returns the error which made the value of a key missing, or nil if the value
+// was decoded or was not there.
+- (NSError *)decodingErrorForKey:(NSString *)key;
+
+@end
+
 // The domain for errors originating from MTLJSONAdapter.
 extern NSString * const AWSMTLJSONAdapterErrorDomain;
 
@@ -146,6 +171,25 @@ extern const NSInteger AWSMTLJSONAdapterErrorInvalidJSONMapping;
 //         nil.
 - (id)initWithModel:(AWSMTLModel<AWSMTLJSONSerializing> *)model;
 
+// Looks up the NSValueTransformer which decodes a property of a model class
+// from its JSON value, from the key paths and transformers cached for the
+// class.
+//
+// modelClass - The MTLModel subclass. This argument must not be nil.
+// key        - The property key. This argument must not be nil.
+//
+// Returns a transformer to use, or nil to use the JSON value as it is.
++ (NSValueTransformer *)JSONTransformerForModelClass:(Class)modelClass key:(NSString *)key;
+
+// Returns the first error which occurred while reading a property of a model
+// parsed from an <AWSMTLJSONLazyDecoding> dictionary. Only the properties
+// which have been accessed so far have been read.
+//
+// model - The model. This argument must not be nil.
+//
+// Returns the error, or nil if none occurred or the model was parsed eagerly.
++ (NSError *)lazyDecodingErrorForModel:(AWSMTLModel *)model;
+
 // Serializes the receiver's `model` into JSON.
 //
 // Returns a JSON dictionary, or nil if a serialization error occurred.
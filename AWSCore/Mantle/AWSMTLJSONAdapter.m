@@ -9,6 +9,9 @@
 #import "AWSMTLJSONAdapter.h"
 #import "AWSMTLModel.h"
 #import "AWSMTLReflection.h"
+#import "NSError+AWSMTLModelException.h"
+#import <objc/runtime.h>
+#import <stdatomic.h>
 
 NSString * const AWSMTLJSONAdapterErrorDomain = @"AWSMTLJSONAdapterErrorDomain";
 const NSInteger AWSMTLJSONAdapterErrorNoClassFound = 2;
@@ -21,14 +24,128 @@ const NSInteger AWSMTLJSONAdapterErrorExceptionThrown = 1;
 // Associated with the NSException that was caught.
 static NSString * const AWSMTLJSONAdapterThrownExceptionErrorKey = @"AWSMTLJSONAdapterThrownException";
 
+// Used to cache the AWSMTLJSONModelCodec of a model class.
+static void *AWSMTLJSONAdapterCachedCodecKey = &AWSMTLJSONAdapterCachedCodecKey;
+
+// Used to attach the AWSMTLJSONLazyModelState to a lazily parsed model.
+static void *AWSMTLJSONAdapterLazyModelStateKey = &AWSMTLJSONAdapterLazyModelStateKey;
+
+// How a single property of a model class is read from and written to JSON.
+@interface AWSMTLJSONPropertyCodec : NSObject
+
+// The property key. This will not be nil.
+@property (nonatomic, copy, readonly) NSString *propertyKey;
+
+// The JSON key path of the property. This will not be nil.
+@property (nonatomic, copy, readonly) NSString *JSONKeyPath;
+
+// Whether `JSONKeyPath` is a single dictionary key, which can be looked up
+// with -objectForKey: instead of -valueForKeyPath:.
+@property (nonatomic, assign, readonly) BOOL JSONKeyPathIsKey;
+
+// The transformer for the property, or nil to not transform the property.
+@property (nonatomic, strong, readonly) NSValueTransformer *transformer;
+
+// The selector and implementation of the setter which key-value coding would
+// use for the property, if it takes an object or a number. Otherwise
+// `setterIMP` is NULL and the value is set with -setValue:forKey:.
+@property (nonatomic, assign, readonly) SEL setter;
+@property (nonatomic, assign, readonly) IMP setterIMP;
+
+// The type encoding of the argument of `setter`.
+@property (nonatomic, assign, readonly) char setterArgumentType;
+
+// The selector and implementation of the getter which key-value coding would
+// use for the property.
+@property (nonatomic, assign, readonly) SEL getter;
+@property (nonatomic, assign, readonly) IMP getterIMP;
+
+// Whether the property can be read lazily, which requires an object getter
+// and setter that can be overridden.
+@property (nonatomic, assign, readonly) BOOL decodesLazily;
+
+@end
+
+// The key paths, transformers and setters of a model class, which are looked
+// up once per class instead of once per parsed model.
+//
+// Instances are immutable, and can be used from any thread.
+@interface AWSMTLJSONModelCodec : NSObject
+
+// The model class.
+@property (nonatomic, strong, readonly) Class modelClass;
+
+// A copy of the return value of +JSONKeyPathsByPropertyKey.
+@property (nonatomic, copy, readonly) NSDictionary *JSONKeyPathsByPropertyKey;
+
+// The codecs of the properties which participate in JSON serialization.
+@property (nonatomic, copy, readonly) NSArray *propertyCodecs;
+
+// `propertyCodecs` keyed by property key.
+@property (nonatomic, copy, readonly) NSDictionary *propertyCodecsByKey;
+
+// Whether models of the class can be created with -init and populated through
+// `propertyCodecs`, instead of going through +modelWithDictionary:error:. This
+// is the case when the class does not override the initialization or the
+// validation of MTLModel.
+@property (nonatomic, assign, readonly) BOOL setsValuesDirectly;
+
+// Returns the cached codec of `modelClass`, creating it if necessary, or nil if
+// +JSONKeyPathsByPropertyKey of the class is invalid.
++ (instancetype)codecForModelClass:(Class)modelClass;
+
+// Initializes a codec which is not cached.
+//
+// modelClass - The model class. This argument must not be nil.
+// adapter    - If not nil, the adapter whose -JSONKeyPathForPropertyKey: and
+//              -JSONTransformerForKey: give the key paths and transformers.
+//              Otherwise they are looked up on the model class.
+//
+// Returns nil if +JSONKeyPathsByPropertyKey of the class is invalid.
+- (instancetype)initWithModelClass:(Class)modelClass adapter:(AWSMTLJSONAdapter *)adapter;
+
+// A subclass of `modelClass` whose getters read the properties which decode
+// lazily on first access, or Nil if models of the class cannot be parsed
+// lazily. The subclass is created on first use.
+- (Class)lazyModelClass;
+
+@end
+
+// The properties of a lazily parsed model which have not been read yet.
+@interface AWSMTLJSONLazyModelState : NSObject
+
+// The dictionary the model was parsed from, or nil once all properties have
+// been read.
+@property (nonatomic, strong) NSDictionary *JSONDictionary;
+
+// The class of the model.
+@property (nonatomic, strong, readonly) Class modelClass;
+
+// The codecs of the properties which have not been read yet, keyed by property
+// key.
+@property (nonatomic, strong, readonly) NSMutableDictionary *pendingPropertyCodecs;
+
+// The first error which occurred while reading a property, if any.
+@property (nonatomic, strong) NSError *error;
+
+// Whether every property has been read or set. This may be read without
+// synchronizing on the receiver, and is only set while synchronized on it.
+@property (atomic, assign, getter=isMaterialized) BOOL materialized;
+
+- (instancetype)initWithJSONDictionary:(NSDictionary *)JSONDictionary modelClass:(Class)modelClass;
+
+@end
+
 @interface AWSMTLJSONAdapter ()
 
 // The MTLModel subclass being parsed, or the class of `model` if parsing has
 // completed.
 @property (nonatomic, strong, readonly) Class modelClass;
 
-// A cached copy of the return value of +JSONKeyPathsByPropertyKey.
-@property (nonatomic, copy, readonly) NSDictionary *JSONKeyPathsByPropertyKey;
+// The codec of `modelClass`. It is the cached codec of the class, unless the
+// receiver's class overrides -JSONKeyPathForPropertyKey: or
+// -JSONTransformerForKey:, in which case it is built through those methods.
+@property (nonatomic, strong, readonly) AWSMTLJSONModelCodec *codec;
 
 // Looks up the NSValueTransformer that should be used for the given key.
 //
@@ -39,6 +156,430 @@ static NSString * const AWSMTLJSONAdapterThrownExceptionErrorKey = @"AWSMTLJSONA
 
 @end
 
+// Looks up the NSValueTransformer that should be used for the given key.
+//
+// modelClass - The class of the model. This argument must not be nil.
+// key        - The property key to transform from or to. This argument must not
+//              be nil.
+//
+// Returns a transformer to use, or nil to not transform the property.
+static NSValueTransformer *AWSMTLJSONTransformerForKey(Class modelClass, NSString *key) {
+	NSCParameterAssert(key != nil);
+
+	SEL selector = AWSMTLSelectorWithKeyPattern(key, "JSONTransformer");
+	if ([modelClass respondsToSelector:selector]) {
+		NSInvocation *invocation = [NSInvocation invocationWithMethodSignature:[modelClass methodSignatureForSelector:selector]];
+		invocation.target = modelClass;
+		invocation.selector = selector;
+		[invocation invoke];
+
+		__unsafe_unretained id result = nil;
+		[invocation getReturnValue:&result];
+		return result;
+	}
+
+	if ([modelClass respondsToSelector:@selector(JSONTransformerForKey:)]) {
+		return [modelClass JSONTransformerForKey:key];
+	}
+
+	return nil;
+}
+
+// Reads the value of a property from a JSON dictionary and transforms it.
+//
+// value - Set to the transformed value, which may be NSNull, or nil if the JSON
+//         dictionary has no value for the property.
+//
+// Returns YES if the value could be read, or NO if an error occurred.
+static BOOL AWSMTLJSONReadValue(NSDictionary *JSONDictionary, Class modelClass, AWSMTLJSONPropertyCodec *propertyCodec, id *value, NSError **error) {
+	NSString *JSONKeyPath = propertyCodec.JSONKeyPath;
+
+	id JSONValue;
+	if (propertyCodec.JSONKeyPathIsKey) {
+		JSONValue = [JSONDictionary objectForKey:JSONKeyPath];
+	} else {
+		@try {
+			JSONValue = [JSONDictionary valueForKeyPath:JSONKeyPath];
+		} @catch (NSException *ex) {
+			if (error != NULL) {
+				NSDictionary *userInfo = @{
+					NSLocalizedDescriptionKey: NSLocalizedString(@"Invalid JSON dictionary", nil),
+					NSLocalizedFailureReasonErrorKey: [NSString stringWithFormat:NSLocalizedString(@"%1$@ could not be parsed because an invalid JSON dictionary was provided for key path \"%2$@\"", nil), modelClass, JSONKeyPath],
+					AWSMTLJSONAdapterThrownExceptionErrorKey: ex
+				};
+
+				*error = [NSError errorWithDomain:AWSMTLJSONAdapterErrorDomain code:AWSMTLJSONAdapterErrorInvalidJSONDictionary userInfo:userInfo];
+			}
+
+			return NO;
+		}
+	}
+
+	if (JSONValue == nil) {
+		*value = nil;
+		return YES;
+	}
+
+	@try {
+		NSValueTransformer *transformer = propertyCodec.transformer;
+		if (transformer != nil) {
+			// Map NSNull -> nil for the transformer, and then back for the
+			// dictionary we're going to insert into.
+			if ([JSONValue isEqual:NSNull.null]) JSONValue = nil;
+			JSONValue = [transformer transformedValue:JSONValue] ?: NSNull.null;
+		}
+
+		*value = JSONValue;
+		return YES;
+	} @catch (NSException *ex) {
+		NSLog(@"*** Caught exception %@ parsing JSON key path \"%@\" from: %@", ex, JSONKeyPath, JSONDictionary);
+
+		// Fail fast in Debug builds.
+		#if DEBUG
+		@throw ex;
+		#else
+		if (error != NULL) {
+			NSDictionary *userInfo = @{
+				NSLocalizedDescriptionKey: ex.description,
+				NSLocalizedFailureReasonErrorKey: ex.reason,
+				AWSMTLJSONAdapterThrownExceptionErrorKey: ex
+			};
+
+			*error = [NSError errorWithDomain:AWSMTLJSONAdapterErrorDomain code:AWSMTLJSONAdapterErrorExceptionThrown userInfo:userInfo];
+		}
+
+		return NO;
+		#endif
+	}
+}
+
+// Sets a parsed value on a model the way -[MTLModel initWithDictionary:error:]
+// does, for a model class whose codec sets values directly.
+//
+// Returns YES if the value could be set, or NO if an error occurred.
+static BOOL AWSMTLJSONSetValue(AWSMTLModel *model, AWSMTLJSONPropertyCodec *propertyCodec, id value, NSError **error) {
+	if (value == NSNull.null) value = nil;
+
+	@try {
+		IMP setterIMP = propertyCodec.setterIMP;
+		SEL setter = propertyCodec.setter;
+		char type = propertyCodec.setterArgumentType;
+
+		// Key-value coding handles everything else, like setting a scalar
+		// property to nil.
+		if (setterIMP == NULL || (value == nil && type != '@')) {
+			[model setValue:value forKey:propertyCodec.propertyKey];
+			return YES;
+		}
+
+		// Scalars are unboxed with the same methods key-value coding uses.
+		switch (type) {
+			case '@': ((void (*)(id, SEL, id))setterIMP)(model, setter, value); break;
+			case 'c': ((void (*)(id, SEL, char))setterIMP)(model, setter, [value charValue]); break;
+			case 'C': ((void (*)(id, SEL, unsigned char))setterIMP)(model, setter, [value unsignedCharValue]); break;
+			case 's': ((void (*)(id, SEL, short))setterIMP)(model, setter, [value shortValue]); break;
+			case 'S': ((void (*)(id, SEL, unsigned short))setterIMP)(model, setter, [value unsignedShortValue]); break;
+			case 'i': ((void (*)(id, SEL, int))setterIMP)(model, setter, [value intValue]); break;
+			case 'I': ((void (*)(id, SEL, unsigned int))setterIMP)(model, setter, [value unsignedIntValue]); break;
+			case 'l': ((void (*)(id, SEL, long))setterIMP)(model, setter, [value longValue]); break;
+			case 'L': ((void (*)(id, SEL, unsigned long))setterIMP)(model, setter, [value unsignedLongValue]); break;
+			case 'q': ((void (*)(id, SEL, long long))setterIMP)(model, setter, [value longLongValue]); break;
+			case 'Q': ((void (*)(id, SEL, unsigned long long))setterIMP)(model, setter, [value unsignedLongLongValue]); break;
+			case 'B': ((void (*)(id, SEL, BOOL))setterIMP)(model, setter, [value boolValue]); break;
+			case 'f': ((void (*)(id, SEL, float))setterIMP)(model, setter, [value floatValue]); break;
+			case 'd': ((void (*)(id, SEL, double))setterIMP)(model, setter, [value doubleValue]); break;
+			default: [model setValue:value forKey:propertyCodec.propertyKey]; break;
+		}
+
+		return YES;
+	} @catch (NSException *ex) {
+		NSLog(@"*** Caught exception setting key \"%@\" : %@", propertyCodec.propertyKey, ex);
+
+		// Fail fast in Debug builds.
+		#if DEBUG
+		@throw ex;
+		#else
+		if (error != NULL) {
+			*error = [NSError awsmtl_modelErrorWithException:ex];
+		}
+
+		return NO;
+		#endif
+	}
+}
+
+// Reads a property of a lazily parsed model, if it has not been read yet.
+static void AWSMTLJSONMaterializeValue(AWSMTLModel *model, NSString *propertyKey) {
+	AWSMTLJSONLazyModelState *state = objc_getAssociatedObject(model, AWSMTLJSONAdapterLazyModelStateKey);
+	if (state == nil || state.materialized) return;
+
+	@synchronized (state) {
+		AWSMTLJSONPropertyCodec *propertyCodec = state.pendingPropertyCodecs[propertyKey];
+		if (propertyCodec == nil) return;
+
+		[state.pendingPropertyCodecs removeObjectForKey:propertyKey];
+
+		NSError *error = nil;
+		id value = nil;
+		if (AWSMTLJSONReadValue(state.JSONDictionary, state.modelClass, propertyCodec, &value, &error) && value != nil) {
+			AWSMTLJSONSetValue(model, propertyCodec, value, &error);
+		} else if (error == nil && propertyCodec.JSONKeyPathIsKey && [state.JSONDictionary respondsToSelector:@selector(decodingErrorForKey:)]) {
+			// The value may be missing because the dictionary failed to decode it.
+			error = [(id<AWSMTLJSONLazyDecoding>)state.JSONDictionary decodingErrorForKey:propertyCodec.JSONKeyPath];
+		}
+		if (error != nil) {
+			NSLog(@"*** Failed to read key \"%@\" of %@ : %@", propertyKey, state.modelClass, error);
+			if (state.error == nil) state.error = error;
+		}
+
+		// The dictionary, and whatever backs it, is not needed anymore once
+		// every property has been read.
+		if (state.pendingPropertyCodecs.count == 0) {
+			state.JSONDictionary = nil;
+			state.materialized = YES;
+		}
+	}
+}
+
+// Marks a property of a lazily parsed model as read, because it is being set.
+static void AWSMTLJSONDiscardValue(AWSMTLModel *model, NSString *propertyKey) {
+	AWSMTLJSONLazyModelState *state = objc_getAssociatedObject(model, AWSMTLJSONAdapterLazyModelStateKey);
+	if (state == nil || state.materialized) return;
+
+	@synchronized (state) {
+		[state.pendingPropertyCodecs removeObjectForKey:propertyKey];
+		if (state.pendingPropertyCodecs.count == 0) {
+			state.JSONDictionary = nil;
+			state.materialized = YES;
+		}
+	}
+}
+
+// Creates a subclass of `modelClass` which reads the lazily decoded properties
+// in their getters, and marks them as read in their setters.
+//
+// Returns the subclass, or Nil if it cannot be created.
+static Class AWSMTLJSONCreateLazyModelClass(Class modelClass, NSArray *propertyCodecs) {
+	NSString *className = [@"AWSMTLJSONLazy_" stringByAppendingString:NSStringFromClass(modelClass)];
+
+	// The class may have been registered for a codec which was replaced by
+	// another thread.
+	Class lazyModelClass = objc_getClass(className.UTF8String);
+	if (lazyModelClass != Nil) return (class_getSuperclass(lazyModelClass) == modelClass ? lazyModelClass : Nil);
+
+	lazyModelClass = objc_allocateClassPair(modelClass, className.UTF8String, 0);
+	if (lazyModelClass == Nil) return Nil;
+
+	for (AWSMTLJSONPropertyCodec *propertyCodec in propertyCodecs) {
+		if (!propertyCodec.decodesLazily) continue;
+
+		NSString *propertyKey = propertyCodec.propertyKey;
+
+		SEL getter = propertyCodec.getter;
+		IMP getterIMP = propertyCodec.getterIMP;
+		IMP lazyGetterIMP = imp_implementationWithBlock(^id (AWSMTLModel *model) {
+			AWSMTLJSONMaterializeValue(model, propertyKey);
+			return ((id (*)(id, SEL))getterIMP)(model, getter);
+		});
+		class_addMethod(lazyModelClass, getter, lazyGetterIMP, method_getTypeEncoding(class_getInstanceMethod(modelClass, getter)));
+
+		SEL setter = propertyCodec.setter;
+		IMP setterIMP = propertyCodec.setterIMP;
+		IMP lazySetterIMP = imp_implementationWithBlock(^(AWSMTLModel *model, id value) {
+			AWSMTLJSONDiscardValue(model, propertyKey);
+			((void (*)(id, SEL, id))setterIMP)(model, setter, value);
+		});
+		class_addMethod(lazyModelClass, setter, lazySetterIMP, method_getTypeEncoding(class_getInstanceMethod(modelClass, setter)));
+	}
+
+	// Hide the subclass, so that comparing, copying and archiving models
+	// behaves the same as for eagerly parsed ones.
+	IMP classIMP = imp_implementationWithBlock(^Class (id model) {
+		return modelClass;
+	});
+	class_addMethod(lazyModelClass, @selector(class), classIMP, method_getTypeEncoding(class_getInstanceMethod(NSObject.class, @selector(class))));
+
+	objc_registerClassPair(lazyModelClass);
+
+	return lazyModelClass;
+}
+
+@implementation AWSMTLJSONLazyModelState {
+	atomic_bool _materialized;
+}
+
+- (instancetype)initWithJSONDictionary:(NSDictionary *)JSONDictionary modelClass:(Class)modelClass {
+	self = [super init];
+	if (self == nil) return nil;
+
+	_JSONDictionary = JSONDictionary;
+	_modelClass = modelClass;
+	_pendingPropertyCodecs = [[NSMutableDictionary alloc] init];
+	atomic_init(&_materialized, false);
+
+	return self;
+}
+
+// Once a getter sees the flag set, it sees the values read before it was set
+// as well.
+- (BOOL)isMaterialized {
+	return atomic_load_explicit(&_materialized, memory_order_acquire);
+}
+
+- (void)setMaterialized:(BOOL)materialized {
+	atomic_store_explicit(&_materialized, materialized, memory_order_release);
+}
+
+@end
+
+@implementation AWSMTLJSONPropertyCodec
+
+- (instancetype)initWithModelClass:(Class)modelClass propertyKey:(NSString *)propertyKey JSONKeyPath:(NSString *)JSONKeyPath transformer:(NSValueTransformer *)transformer {
+	self = [super init];
+	if (self == nil) return nil;
+
+	_propertyKey = [propertyKey copy];
+	_JSONKeyPath = [JSONKeyPath copy];
+	_JSONKeyPathIsKey = ![JSONKeyPath hasPrefix:@"@"] && [JSONKeyPath rangeOfString:@"."].location == NSNotFound;
+	_transformer = transformer;
+
+	// Key-value coding prefers -set<Key>: over any other way of setting the
+	// property.
+	SEL setter = AWSMTLSelectorWithCapitalizedKeyPattern("set", propertyKey, ":");
+	Method method = (setter != NULL ? class_getInstanceMethod(modelClass, setter) : NULL);
+	if (method != NULL && method_getNumberOfArguments(method) == 3) {
+		char *argumentType = method_copyArgumentType(method, 2);
+		if (argumentType != NULL && argumentType[0] != '\0' && argumentType[1] == '\0' && strchr("@cCsSiIlLqQBfd", argumentType[0]) != NULL) {
+			_setter = setter;
+			_setterIMP = method_getImplementation(method);
+			_setterArgumentType = argumentType[0];
+		}
+		free(argumentType);
+	}
+
+	// Key-value coding prefers -<key> over any other way of getting the
+	// property.
+	SEL getter = NSSelectorFromString(propertyKey);
+	method = class_getInstanceMethod(modelClass, getter);
+	if (method != NULL && method_getNumberOfArguments(method) == 2) {
+		char *returnType = method_copyReturnType(method);
+		_getter = getter;
+		_getterIMP = method_getImplementation(method);
+		_decodesLazily = (_setterArgumentType == '@' && returnType != NULL && strcmp(returnType, "@") == 0);
+		free(returnType);
+	}
+
+	return self;
+}
+
+@end
+
+@implementation AWSMTLJSONModelCodec {
+	// Whether `_lazyModelClass` has been created, which may have failed.
+	BOOL _lazyModelClassCreated;
+	Class _lazyModelClass;
+}
+
++ (instancetype)codecForModelClass:(Class)modelClass {
+	AWSMTLJSONModelCodec *codec = objc_getAssociatedObject(modelClass, AWSMTLJSONAdapterCachedCodecKey);
+	if (codec != nil) return codec;
+
+	codec = [[self alloc] initWithModelClass:modelClass adapter:nil];
+	if (codec == nil) return nil;
+
+	// It doesn't really matter if we replace another thread's work, since we do
+	// it atomically and the result should be the same.
+	objc_setAssociatedObject(modelClass, AWSMTLJSONAdapterCachedCodecKey, codec, OBJC_ASSOCIATION_RETAIN);
+
+	return codec;
+}
+
+- (instancetype)initWithModelClass:(Class)modelClass adapter:(AWSMTLJSONAdapter *)adapter {
+	self = [super init];
+	if (self == nil) return nil;
+
+	_modelClass = modelClass;
+
+	NSDictionary *JSONKeyPathsByPropertyKey = [[modelClass JSONKeyPathsByPropertyKey] copy];
+	NSSet *propertyKeys = [modelClass propertyKeys];
+
+	for (NSString *mappedPropertyKey in JSONKeyPathsByPropertyKey) {
+		if (![propertyKeys containsObject:mappedPropertyKey]) {
+			NSAssert(NO, @"%@ is not a property of %@.", mappedPropertyKey, modelClass);
+			return nil;
+		}
+
+		id value = JSONKeyPathsByPropertyKey[mappedPropertyKey];
+
+		if (![value isKindOfClass:NSString.class] && value != NSNull.null) {
+			NSAssert(NO, @"%@ must either map to a JSON key path or NSNull, got: %@.",mappedPropertyKey, value);
+			return nil;
+		}
+	}
+
+	SEL modelWithDictionary = @selector(modelWithDictionary:error:);
+	SEL initWithDictionary = @selector(initWithDictionary:error:);
+	SEL validateValue = @selector(validateValue:forKey:error:);
+	BOOL setsValuesDirectly = ([modelClass methodForSelector:modelWithDictionary] == [AWSMTLModel methodForSelector:modelWithDictionary]
+		&& [modelClass instanceMethodForSelector:initWithDictionary] == [AWSMTLModel instanceMethodForSelector:initWithDictionary]
+		&& [modelClass instanceMethodForSelector:validateValue] == [NSObject instanceMethodForSelector:validateValue]);
+
+	NSMutableArray *propertyCodecs = [[NSMutableArray alloc] initWithCapacity:propertyKeys.count];
+	NSMutableDictionary *propertyCodecsByKey = [[NSMutableDictionary alloc] initWithCapacity:propertyKeys.count];
+
+	for (NSString *propertyKey in propertyKeys) {
+		id JSONKeyPath = nil;
+		if (adapter != nil) {
+			JSONKeyPath = [adapter JSONKeyPathForPropertyKey:propertyKey];
+			if (JSONKeyPath == nil) continue;
+		} else {
+			JSONKeyPath = JSONKeyPathsByPropertyKey[propertyKey] ?: propertyKey;
+			if ([JSONKeyPath isEqual:NSNull.null]) continue;
+		}
+
+		// -validateValue:forKey:error: calls -validate<Key>:error:, which
+		// -initWithDictionary:error: must not skip.
+		if ([modelClass instancesRespondToSelector:AWSMTLSelectorWithCapitalizedKeyPattern("validate", propertyKey, ":error:")]) {
+			setsValuesDirectly = NO;
+		}
+
+		NSValueTransformer *transformer = (adapter != nil ? [adapter JSONTransformerForKey:propertyKey] : AWSMTLJSONTransformerForKey(modelClass, propertyKey));
+		AWSMTLJSONPropertyCodec *propertyCodec = [[AWSMTLJSONPropertyCodec alloc] initWithModelClass:modelClass propertyKey:propertyKey JSONKeyPath:JSONKeyPath transformer:transformer];
+		[propertyCodecs addObject:propertyCodec];
+		propertyCodecsByKey[propertyKey] = propertyCodec;
+	}
+
+	_JSONKeyPathsByPropertyKey = JSONKeyPathsByPropertyKey;
+	_propertyCodecs = [propertyCodecs copy];
+	_propertyCodecsByKey = [propertyCodecsByKey copy];
+	_setsValuesDirectly = setsValuesDirectly;
+
+	return self;
+}
+
+- (Class)lazyModelClass {
+	if (!self.setsValuesDirectly) return Nil;
+
+	// Class pairs must not be created twice, so all codecs share the lock.
+	@synchronized (AWSMTLJSONModelCodec.class) {
+		if (!_lazyModelClassCreated) {
+			_lazyModelClass = AWSMTLJSONCreateLazyModelClass(self.modelClass, self.propertyCodecs);
+			_lazyModelClassCreated = YES;
+		}
+
+		return _lazyModelClass;
+	}
+}
+
+@end
+
+// Whether `adapterClass` overrides how key paths or transformers are looked up,
+// so that the cached codecs of model classes cannot be used.
+static BOOL AWSMTLJSONAdapterClassOverridesLookups(Class adapterClass) {
+	return ([adapterClass instanceMethodForSelector:@selector(JSONKeyPathForPropertyKey:)] != [AWSMTLJSONAdapter instanceMethodForSelector:@selector(JSONKeyPathForPropertyKey:)]
+		|| [adapterClass instanceMethodForSelector:@selector(JSONTransformerForKey:)] != [AWSMTLJSONAdapter instanceMethodForSelector:@selector(JSONTransformerForKey:)]);
+}
+
 @implementation AWSMTLJSONAdapter
 
 #pragma mark Convenience methods
@@ -138,82 +679,50 @@ static NSString * const AWSMTLJSONAdapterThrownExceptionErrorKey = @"AWSMTLJSONA
 	if (self == nil) return nil;
 
 	_modelClass = modelClass;
-	_JSONKeyPathsByPropertyKey = [[modelClass JSONKeyPathsByPropertyKey] copy];
-
-	NSMutableDictionary *dictionaryValue = [[NSMutableDictionary alloc] initWithCapacity:JSONDictionary.count];
-
-	NSSet *propertyKeys = [self.modelClass propertyKeys];
-
-	for (NSString *mappedPropertyKey in self.JSONKeyPathsByPropertyKey) {
-		if (![propertyKeys containsObject:mappedPropertyKey]) {
-			NSAssert(NO, @"%@ is not a property of %@.", mappedPropertyKey, modelClass);
-			return nil;
-		}
-
-		id value = self.JSONKeyPathsByPropertyKey[mappedPropertyKey];
-
-		if (![value isKindOfClass:NSString.class] && value != NSNull.null) {
-			NSAssert(NO, @"%@ must either map to a JSON key path or NSNull, got: %@.",mappedPropertyKey, value);
-			return nil;
+	_codec = [self codecForModelClass:modelClass];
+	if (_codec == nil) return nil;
+
+	// Models of classes which do not customize their initialization are
+	// populated directly, instead of through an intermediate dictionary. If the
+	// JSON dictionary decodes its values lazily, so does the model.
+	AWSMTLModel *model = nil;
+	AWSMTLJSONLazyModelState *lazyModelState = nil;
+	NSMutableDictionary *dictionaryValue = nil;
+	if (self.codec.setsValuesDirectly) {
+		Class lazyModelClass = ([JSONDictionary conformsToProtocol:@protocol(AWSMTLJSONLazyDecoding)] ? self.codec.lazyModelClass : Nil);
+		if (lazyModelClass != Nil) {
+			model = [[lazyModelClass alloc] init];
+			lazyModelState = [[AWSMTLJSONLazyModelState alloc] initWithJSONDictionary:JSONDictionary modelClass:modelClass];
+		} else {
+			model = [[modelClass alloc] init];
 		}
+		if (model == nil) return nil;
+	} else {
+		dictionaryValue = [[NSMutableDictionary alloc] initWithCapacity:JSONDictionary.count];
 	}
 
-	for (NSString *propertyKey in propertyKeys) {
-		NSString *JSONKeyPath = [self JSONKeyPathForPropertyKey:propertyKey];
-		if (JSONKeyPath == nil) continue;
-
-		id value;
-		@try {
-			value = [JSONDictionary valueForKeyPath:JSONKeyPath];
-		} @catch (NSException *ex) {
-			if (error != NULL) {
-				NSDictionary *userInfo = @{
-					NSLocalizedDescriptionKey: NSLocalizedString(@"Invalid JSON dictionary", nil),
-					NSLocalizedFailureReasonErrorKey: [NSString stringWithFormat:NSLocalizedString(@"%1$@ could not be parsed because an invalid JSON dictionary was provided for key path \"%2$@\"", nil), modelClass, JSONKeyPath],
-					AWSMTLJSONAdapterThrownExceptionErrorKey: ex
-				};
-
-				*error = [NSError errorWithDomain:AWSMTLJSONAdapterErrorDomain code:AWSMTLJSONAdapterErrorInvalidJSONDictionary userInfo:userInfo];
-			}
-
-			return nil;
+	for (AWSMTLJSONPropertyCodec *propertyCodec in self.codec.propertyCodecs) {
+		if (lazyModelState != nil && propertyCodec.decodesLazily) {
+			lazyModelState.pendingPropertyCodecs[propertyCodec.propertyKey] = propertyCodec;
+			continue;
 		}
 
+		id value = nil;
+		if (!AWSMTLJSONReadValue(JSONDictionary, modelClass, propertyCodec, &value, error)) return nil;
 		if (value == nil) continue;
 
-		@try {
-			NSValueTransformer *transformer = [self JSONTransformerForKey:propertyKey];
-			if (transformer != nil) {
-				// Map NSNull -> nil for the transformer, and then back for the
-				// dictionary we're going to insert into.
-				if ([value isEqual:NSNull.null]) value = nil;
-				value = [transformer transformedValue:value] ?: NSNull.null;
-			}
-
-			dictionaryValue[propertyKey] = value;
-		} @catch (NSException *ex) {
-			NSLog(@"*** Caught exception %@ parsing JSON key path \"%@\" from: %@", ex, JSONKeyPath, JSONDictionary);
-
-			// Fail fast in Debug builds.
-			#if DEBUG
-			@throw ex;
-			#else
-			if (error != NULL) {
-				NSDictionary *userInfo = @{
-					NSLocalizedDescriptionKey: ex.description,
-					NSLocalizedFailureReasonErrorKey: ex.reason,
-					AWSMTLJSONAdapterThrownExceptionErrorKey: ex
-				};
-
-				*error = [NSError errorWithDomain:AWSMTLJSONAdapterErrorDomain code:AWSMTLJSONAdapterErrorExceptionThrown userInfo:userInfo];
-			}
-
-			return nil;
-			#endif
+		if (model != nil) {
+			if (!AWSMTLJSONSetValue(model, propertyCodec, value, error)) return nil;
+		} else {
+			dictionaryValue[propertyCodec.propertyKey] = value;
 		}
 	}
 
-	_model = [self.modelClass modelWithDictionary:dictionaryValue error:error];
+	if (lazyModelState.pendingPropertyCodecs.count > 0) {
+		objc_setAssociatedObject(model, AWSMTLJSONAdapterLazyModelStateKey, lazyModelState, OBJC_ASSOCIATION_RETAIN);
+	}
+
+	_model = model ?: [self.modelClass modelWithDictionary:dictionaryValue error:error];
 	if (_model == nil) return nil;
 
 	return self;
@@ -227,11 +736,19 @@ static NSString * const AWSMTLJSONAdapterThrownExceptionErrorKey = @"AWSMTLJSONA
 
 	_model = model;
 	_modelClass = model.class;
-	_JSONKeyPathsByPropertyKey = [[model.class JSONKeyPathsByPropertyKey] copy];
+	_codec = [self codecForModelClass:model.class];
 
 	return self;
 }
 
+- (AWSMTLJSONModelCodec *)codecForModelClass:(Class)modelClass {
+	if (AWSMTLJSONAdapterClassOverridesLookups(self.class)) {
+		return [[AWSMTLJSONModelCodec alloc] initWithModelClass:modelClass adapter:self];
+	}
+
+	return [AWSMTLJSONModelCodec codecForModelClass:modelClass];
+}
+
 #pragma mark Serialization
 
 - (NSDictionary *)JSONDictionary {
@@ -239,10 +756,11 @@ static NSString * const AWSMTLJSONAdapterThrownExceptionErrorKey = @"AWSMTLJSONA
 	NSMutableDictionary *JSONDictionary = [[NSMutableDictionary alloc] initWithCapacity:dictionaryValue.count];
 
 	[dictionaryValue enumerateKeysAndObjectsUsingBlock:^(NSString *propertyKey, id value, BOOL *stop) {
-		NSString *JSONKeyPath = [self JSONKeyPathForPropertyKey:propertyKey];
-		if (JSONKeyPath == nil) return;
+		AWSMTLJSONPropertyCodec *propertyCodec = self.codec.propertyCodecsByKey[propertyKey];
+		if (propertyCodec == nil) return;
 
-		NSValueTransformer *transformer = [self JSONTransformerForKey:propertyKey];
+		NSString *JSONKeyPath = propertyCodec.JSONKeyPath;
+		NSValueTransformer *transformer = propertyCodec.transformer;
 		if ([transformer.class allowsReverseTransformation]) {
 			// Map NSNull -> nil for the transformer, and then back for the
 			// dictionaryValue we're going to insert into.
@@ -270,32 +788,37 @@ static NSString * const AWSMTLJSONAdapterThrownExceptionErrorKey = @"AWSMTLJSONA
 	return JSONDictionary;
 }
 
-- (NSValueTransformer *)JSONTransformerForKey:(NSString *)key {
++ (NSValueTransformer *)JSONTransformerForModelClass:(Class)modelClass key:(NSString *)key {
+	NSParameterAssert(modelClass != nil);
 	NSParameterAssert(key != nil);
 
-	SEL selector = AWSMTLSelectorWithKeyPattern(key, "JSONTransformer");
-	if ([self.modelClass respondsToSelector:selector]) {
-		NSInvocation *invocation = [NSInvocation invocationWithMethodSignature:[self.modelClass methodSignatureForSelector:selector]];
-		invocation.target = self.modelClass;
-		invocation.selector = selector;
-		[invocation invoke];
+	AWSMTLJSONPropertyCodec *propertyCodec = [AWSMTLJSONModelCodec codecForModelClass:modelClass].propertyCodecsByKey[key];
+	if (propertyCodec != nil) return propertyCodec.transformer;
 
-		__unsafe_unretained id result = nil;
-		[invocation getReturnValue:&result];
-		return result;
-	}
+	return AWSMTLJSONTransformerForKey(modelClass, key);
+}
 
-	if ([self.modelClass respondsToSelector:@selector(JSONTransformerForKey:)]) {
-		return [self.modelClass JSONTransformerForKey:key];
++ (NSError *)lazyDecodingErrorForModel:(AWSMTLModel *)model {
+	NSParameterAssert(model != nil);
+
+	AWSMTLJSONLazyModelState *state = objc_getAssociatedObject(model, AWSMTLJSONAdapterLazyModelStateKey);
+	if (state == nil) return nil;
+
+	@synchronized (state) {
+		return state.error;
 	}
+}
 
-	return nil;
+- (NSValueTransformer *)JSONTransformerForKey:(NSString *)key {
+	NSParameterAssert(key != nil);
+
+	return [AWSMTLJSONAdapter JSONTransformerForModelClass:self.modelClass key:key];
 }
 
 - (NSString *)JSONKeyPathForPropertyKey:(NSString *)key {
 	NSParameterAssert(key != nil);
 
-	id JSONKeyPath = self.JSONKeyPathsByPropertyKey[key];
+	id JSONKeyPath = [AWSMTLJSONModelCodec codecForModelClass:self.modelClass].JSONKeyPathsByPropertyKey[key];
 	if ([JSONKeyPath isEqual:NSNull.null]) return nil;
 
 	if (JSONKeyPath == nil) {
@@ -38,9 +38,11 @@ FOUNDATION_EXPORT NSString *const AWSResponseObjectErrorUserInfoKey;
 @class AWSNetworkingConfiguration;
 @class AWSNetworkingRequest;
 @class AWSTask<__covariant ResultType>;
+@class AWSExecutor;
 
 typedef void (^AWSNetworkingUploadProgressBlock) (int64_t bytesSent, int64_t totalBytesSent, int64_t totalBytesExpectedToSend);
 typedef void (^AWSNetworkingDownloadProgressBlock) (int64_t bytesWritten, int64_t totalBytesWritten, int64_t totalBytesExpectedToWrite);
+typedef void (^AWSNetworkingResponseListItemBlock) (NSString *memberName, id item);
 
 #pragma mark - AWSHTTPMethod
 
@@ -80,6 +82,13 @@ typedef NS_ENUM(NSInteger, AWSHTTPMethod) {
                      headers:(NSDictionary *)headers
                   parameters:(NSDictionary *)parameters;
 
+@optional
+/**
+ Checks the request parameters against the constraints of the service definition, before the request is serialized.
+ Called only when `validatesRequestParameters` is set.
+ */
+- (AWSTask *)validateParameters:(NSDictionary *)parameters;
+
 @end
 
 @protocol AWSNetworkingRequestInterceptor <NSObject>
@@ -115,6 +124,33 @@ typedef NS_ENUM(NSInteger, AWSHTTPMethod) {
 
 @end
 
+/**
+ Consumes a response body incrementally as it is received.
+ */
+@protocol AWSHTTPURLResponseStreamParser <NSObject>
+
+@required
+
+- (BOOL)parseData:(NSData *)data
+            error:(NSError *__autoreleasing *)error;
+
+@end
+
+/**
+ A response serializer which can parse the response body while it is being received. When the serializer returns a
+ stream parser for a response, the body is passed to the parser chunk by chunk instead of being buffered, and the
+ parser is passed as `data` to `responseObjectForResponse:originalRequest:currentRequest:data:error:` once the
+ body is complete.
+ */
+@protocol AWSHTTPURLResponseStreamingSerializer <AWSHTTPURLResponseSerializer>
+
+@required
+
+- (id<AWSHTTPURLResponseStreamParser>)streamParserForResponse:(NSHTTPURLResponse *)response
+                                                      request:(AWSNetworkingRequest *)request;
+
+@end
+
 @protocol AWSURLRequestRetryHandler <NSObject>
 
 @required
@@ -172,6 +208,20 @@ typedef NS_ENUM(NSInteger, AWSHTTPMethod) {
  */
 @property (nonatomic, assign) NSTimeInterval timeoutIntervalForResource;
 
+/**
+ Whether request parameters are checked against the `required`, `min`, `max` and `pattern` constraints of the service
+ definition before a request is sent. A request with an invalid parameter fails with an error in
+ `AWSValidationErrorDomain`, instead of being rejected by the service. The default value is `NO`.
+ */
+@property (nonatomic, assign) BOOL validatesRequestParameters;
+
+/**
+ The executor which runs the serialization, signing and response handling of the requests of a client, e.g.
+ `[[AWSExecutorPool defaultPool] executorWithQualityOfService:AWSExecutorQualityOfServiceUserInitiated]`. When `nil`,
+ they run on `[AWSExecutor defaultExecutor]`. The default value is `nil`.
+ */
+@property (nonatomic, strong) AWSExecutor *executor;
+
 @end
 
 #pragma mark - AWSNetworkingRequest
@@ -186,6 +236,19 @@ typedef NS_ENUM(NSInteger, AWSHTTPMethod) {
 @property (nonatomic, copy) AWSNetworkingUploadProgressBlock uploadProgress;
 @property (nonatomic, copy) AWSNetworkingDownloadProgressBlock downloadProgress;
 
+/**
+ When set, the elements of the list members of a successful response are delivered to this block as they are parsed
+ instead of being collected into the response object. The block is called on the URL session delegate queue.
+ Elements delivered before a request is retried may be delivered again.
+ */
+@property (nonatomic, copy) AWSNetworkingResponseListItemBlock responseListItemHandler;
+
+/**
+ When set, a successful response is kept as raw bytes and decoded on first access, instead of being parsed completely
+ when it is received.
+ */
+@property (nonatomic, assign) BOOL decodesResponseLazily;
+
 @property (readonly, nonatomic, strong) NSURLSessionTask *task;
 @property (readonly, nonatomic, assign, getter = isCancelled) BOOL cancelled;
 
@@ -199,6 +262,21 @@ typedef NS_ENUM(NSInteger, AWSHTTPMethod) {
 
 @property (nonatomic, copy) AWSNetworkingUploadProgressBlock uploadProgress;
 @property (nonatomic, copy) AWSNetworkingDownloadProgressBlock downloadProgress;
+/**
+ When set, the elements of the list members of the response (e.g. `items` of a DynamoDB `Scan`) are passed to this
+ block one at a time as they are parsed, and the corresponding properties of the response object are left `nil`.
+ The memory used to parse the response is then bounded by the largest single element rather than by the size of the
+ response. Only supported by services using the JSON and REST-JSON protocols.
+ */
+@property (nonatomic, copy) AWSNetworkingResponseListItemBlock responseListItemHandler;
+/**
+ When set, the response object is backed by the raw response body, and each of its properties is parsed the first
+ time it is read. Reading only a few properties of a large response (e.g. `nextToken` of a list operation) then avoids
+ parsing the rest of it. The response body is kept in memory until all properties have been read. Errors in a
+ property which is parsed this way are logged and leave the property `nil`, instead of failing the request. Only
+ supported by services using the JSON and REST-JSON protocols; other responses are parsed as usual.
+ */
+@property (nonatomic, assign) BOOL decodesResponseLazily;
 @property (nonatomic, assign, readonly, getter = isCancelled) BOOL cancelled;
 @property (nonatomic, strong) NSURL *downloadingFileURL;
 
@@ -166,6 +166,8 @@ NSString *const AWSNetworkingErrorDomain = @"com.amazonaws.AWSNetworkingErrorDom
     configuration.maxRetryCount = self.maxRetryCount;
     configuration.timeoutIntervalForRequest = self.timeoutIntervalForRequest;
     configuration.timeoutIntervalForResource = self.timeoutIntervalForResource;
+    configuration.validatesRequestParameters = self.validatesRequestParameters;
+    configuration.executor = self.executor;
 
     return configuration;
 }
@@ -223,6 +225,10 @@ NSString *const AWSNetworkingErrorDomain = @"com.amazonaws.AWSNetworkingErrorDom
     if (!self.retryHandler) {
         self.retryHandler = configuration.retryHandler;
     }
+
+    if (configuration.validatesRequestParameters) {
+        self.validatesRequestParameters = YES;
+    }
 }
 
 - (void)setTask:(NSURLSessionTask *)task {
@@ -279,6 +285,7 @@ NSString *const AWSNetworkingErrorDomain = @"com.amazonaws.AWSNetworkingErrorDom
 
     encodingBehaviors[@"downloadProgress"] = @(AWSMTLModelEncodingBehaviorExcluded);
     encodingBehaviors[@"internalRequest"] = @(AWSMTLModelEncodingBehaviorExcluded);
+    encodingBehaviors[@"responseListItemHandler"] = @(AWSMTLModelEncodingBehaviorExcluded);
     encodingBehaviors[@"uploadProgress"] = @(AWSMTLModelEncodingBehaviorExcluded);
 
     return encodingBehaviors;
@@ -306,6 +313,13 @@ NSString *const AWSNetworkingErrorDomain = @"com.amazonaws.AWSNetworkingErrorDom
     return NULL;
 }
 
+// This may be a bug in our version of Mantle--despite declaring these properties as "excluded",
+// Mantle attempts to decode them from an archive, and fails when it cannot find the field name.
+- (nullable id)decodeResponseListItemHandlerWithCoder:(NSCoder *)coder
+                                         modelVersion:(NSUInteger)modelVersion {
+    return NULL;
+}
+
 // This may be a bug in our version of Mantle--despite declaring these properties as "excluded",
 // Mantle attempts to decode them from an archive, and fails when it cannot find the field name.
 - (nullable id)decodeUploadProgressWithCoder:(NSCoder *)coder
@@ -321,6 +335,18 @@ NSString *const AWSNetworkingErrorDomain = @"com.amazonaws.AWSNetworkingErrorDom
     self.internalRequest.downloadProgress = downloadProgress;
 }
 
+- (void)setResponseListItemHandler:(AWSNetworkingResponseListItemBlock)responseListItemHandler {
+    self.internalRequest.responseListItemHandler = responseListItemHandler;
+}
+
+- (BOOL)decodesResponseLazily {
+    return self.internalRequest.decodesResponseLazily;
+}
+
+- (void)setDecodesResponseLazily:(BOOL)decodesResponseLazily {
+    self.internalRequest.decodesResponseLazily = decodesResponseLazily;
+}
+
 - (BOOL)isCancelled {
     return [self.internalRequest isCancelled];
 }
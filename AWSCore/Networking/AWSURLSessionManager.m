@@ -20,6 +20,7 @@
 #import "AWSSignature.h"
 #import "AWSBolts.h"
 #import "AWSCredentialsProvider.h"
+#import "AWSTaskTracer+Private.h"
 
 NSString* const AWSResponseObjectErrorUserInfoKey = @"ResponseObjectError";
 
@@ -47,6 +48,7 @@ typedef NS_ENUM(NSInteger, AWSURLSessionTaskType) {
 @property (nonatomic, strong) id responseObject;
 @property (nonatomic, strong) NSMutableData *responseData;
 @property (nonatomic, strong) NSFileHandle *responseFilehandle;
+@property (nonatomic, strong) id<AWSHTTPURLResponseStreamParser> responseStreamParser;
 @property (nonatomic, strong) NSURL *tempDownloadedFileURL;
 @property (nonatomic, assign) BOOL shouldWriteDirectly;
 @property (nonatomic, assign) BOOL shouldWriteToFile;
@@ -54,6 +56,10 @@ typedef NS_ENUM(NSInteger, AWSURLSessionTaskType) {
 @property (atomic, assign) int64_t lastTotalLengthOfChunkSignatureSent;
 @property (atomic, assign) int64_t payloadTotalBytesWritten;
 
+// Set while tracing is on, see `AWSTaskTracer`.
+@property (nonatomic, strong) NSString *traceOperationName;
+@property (atomic, assign) uint64_t traceStartTime;
+
 @end
 
 @implementation AWSURLSessionManagerDelegate
@@ -138,11 +144,32 @@ typedef NS_ENUM(NSInteger, AWSURLSessionTaskType) {
     delegate.uploadingFileURL = request.uploadingFileURL;
     delegate.shouldWriteDirectly = request.shouldWriteDirectly;
 
-    [self taskWithDelegate:delegate];
+    if (AWSTaskTracerIsEnabled()) {
+        delegate.traceOperationName = [self traceOperationNameForRequest:request];
+        delegate.taskCompletionSource.task.aws_traceOperationName = delegate.traceOperationName;
+        [AWSTaskTracer runWithOperationName:delegate.traceOperationName block:^{
+            [self taskWithDelegate:delegate];
+        }];
+    } else {
+        [self taskWithDelegate:delegate];
+    }
 
     return delegate.taskCompletionSource.task;
 }
 
+// The name of the service operation of the request, e.g. `PutItem`, or its URL
+// for requests which are not made by a service client.
+- (NSString *)traceOperationNameForRequest:(AWSNetworkingRequest *)request {
+    id requestSerializer = request.requestSerializer;
+    if ([requestSerializer respondsToSelector:NSSelectorFromString(@"actionName")]) {
+        NSString *actionName = [requestSerializer valueForKey:@"actionName"];
+        if ([actionName length] > 0) {
+            return actionName;
+        }
+    }
+    return request.URLString ?: [request.URL absoluteString];
+}
+
 - (void)taskWithDelegate:(AWSURLSessionManagerDelegate *)delegate {
     if (!self.session || !self.isSessionValid) {
         delegate.taskCompletionSource.error = [NSError errorWithDomain:AWSNetworkingErrorDomain
@@ -153,6 +180,7 @@ typedef NS_ENUM(NSInteger, AWSURLSessionTaskType) {
 
     if (delegate.downloadingFileURL) delegate.shouldWriteToFile = YES;
     delegate.responseData = nil;
+    delegate.responseStreamParser = nil;
     delegate.responseObject = nil;
     delegate.error = nil;
     NSMutableURLRequest *mutableRequest = [NSMutableURLRequest requestWithURL:delegate.request.URL];
@@ -168,24 +196,34 @@ typedef NS_ENUM(NSInteger, AWSURLSessionTaskType) {
 
     mutableRequest.HTTPMethod = [NSString aws_stringWithHTTPMethod:delegate.request.HTTPMethod];
 
+    AWSExecutor *executor = [self executor];
     AWSTask *task = [AWSTask taskWithResult:nil];
 
     if (request.requestSerializer) {
-        task = [request.requestSerializer serializeRequest:mutableRequest
-                                                   headers:request.headers
-                                                parameters:request.parameters];
+        if (request.validatesRequestParameters
+            && [request.requestSerializer respondsToSelector:@selector(validateParameters:)]) {
+            task = [[request.requestSerializer validateParameters:request.parameters] continueWithExecutor:executor withSuccessBlock:^id _Nullable(AWSTask * _Nonnull task) {
+                return [request.requestSerializer serializeRequest:mutableRequest
+                                                           headers:request.headers
+                                                        parameters:request.parameters];
+            }];
+        } else {
+            task = [request.requestSerializer serializeRequest:mutableRequest
+                                                       headers:request.headers
+                                                    parameters:request.parameters];
+        }
     }
 
     for(id<AWSNetworkingRequestInterceptor>interceptor in request.requestInterceptors) {
-        task = [task continueWithSuccessBlock:^id(AWSTask *task) {
+        task = [task continueWithExecutor:executor withSuccessBlock:^id(AWSTask *task) {
             return [interceptor interceptRequest:mutableRequest];
         }];
     }
 
-    [[[task continueWithSuccessBlock:^id _Nullable(AWSTask * _Nonnull task) {
+    [[[task continueWithExecutor:executor withSuccessBlock:^id _Nullable(AWSTask * _Nonnull task) {
         AWSNetworkingRequest *request = delegate.request;
         return [request.requestSerializer validateRequest:mutableRequest];
-    }] continueWithSuccessBlock:^id _Nullable(AWSTask * _Nonnull task) {
+    }] continueWithExecutor:executor withSuccessBlock:^id _Nullable(AWSTask * _Nonnull task) {
         switch (delegate.taskType) {
             case AWSURLSessionTaskTypeData:
                 delegate.request.task = [self.session dataTaskWithRequest:mutableRequest];
@@ -208,6 +246,9 @@ typedef NS_ENUM(NSInteger, AWSURLSessionTaskType) {
 
             [self printHTTPHeadersAndBodyForRequest:delegate.request.task.originalRequest];
 
+            if (AWSTaskTracerIsEnabled()) {
+                delegate.traceStartTime = AWSTaskTracerCurrentTime();
+            }
             [delegate.request.task resume];
         } else {
             AWSDDLogError(@"Invalid AWSURLSessionTaskType.");
@@ -226,6 +267,11 @@ typedef NS_ENUM(NSInteger, AWSURLSessionTaskType) {
     }];
 }
 
+// The executor of the continuations which serialize requests and handle responses.
+- (AWSExecutor *)executor {
+    return self.configuration.executor ?: [AWSExecutor defaultExecutor];
+}
+
 /**
  Invalidates the underlying NSURLSession to avoid memory leaks. Internally, calls
  `-[NSURLSession finishTasksAndInvalidate]` so that any in-process tasks are allowed
@@ -259,7 +305,22 @@ typedef NS_ENUM(NSInteger, AWSURLSessionTaskType) {
 
     [self printHTTPHeadersForResponse:sessionTask.response];
 
-    [[[AWSTask taskWithResult:nil] continueWithSuccessBlock:^id(AWSTask *task) {
+    // Attribute the network time and the continuations handling the response to
+    // the operation of the request.
+    BOOL tracing = AWSTaskTracerIsEnabled();
+    NSString *traceOperationName = nil;
+    NSString *previousTraceOperationName = nil;
+    if (tracing) {
+        AWSURLSessionManagerDelegate *delegate = [self.sessionManagerDelegates objectForKey:@(sessionTask.taskIdentifier)];
+        traceOperationName = delegate.traceOperationName;
+        if (delegate.traceStartTime > 0) {
+            AWSTaskTracerRecordEvent(AWSTaskTraceEventTypeNetwork, traceOperationName, delegate.traceStartTime, delegate.traceStartTime, AWSTaskTracerCurrentTime());
+        }
+        previousTraceOperationName = AWSTaskTracerCurrentOperationName();
+        AWSTaskTracerSetCurrentOperationName(traceOperationName);
+    }
+
+    [[[AWSTask taskWithResult:nil] continueWithExecutor:[self executor] withSuccessBlock:^id(AWSTask *task) {
         AWSURLSessionManagerDelegate *delegate = [self.sessionManagerDelegates objectForKey:@(sessionTask.taskIdentifier)];
 
         if (delegate.responseFilehandle) {
@@ -319,10 +380,11 @@ typedef NS_ENUM(NSInteger, AWSURLSessionTaskType) {
                 // need to call responseSerializer if there is no client-side error.
                 if ([delegate.request.responseSerializer respondsToSelector:@selector(responseObjectForResponse:originalRequest:currentRequest:data:error:)]) {
                     NSError *error = nil;
+                    id data = delegate.responseStreamParser ? delegate.responseStreamParser : delegate.responseData;
                     delegate.responseObject = [delegate.request.responseSerializer responseObjectForResponse:httpResponse
                                                                                              originalRequest:sessionTask.originalRequest
                                                                                               currentRequest:sessionTask.currentRequest
-                                                                                                        data:delegate.responseData
+                                                                                                        data:data
                                                                                                        error:&error];
                     if (error) {
                         if ([delegate.responseObject isKindOfClass:[NSDictionary class]]) {
@@ -438,6 +500,10 @@ typedef NS_ENUM(NSInteger, AWSURLSessionTaskType) {
         [self.sessionManagerDelegates removeObjectForKey:@(sessionTask.taskIdentifier)];
         return nil;
     }];
+
+    if (tracing) {
+        AWSTaskTracerSetCurrentOperationName(previousTraceOperationName);
+    }
 }
 
 - (void)URLSession:(NSURLSession *)session task:(NSURLSessionTask *)task didSendBodyData:(int64_t)bytesSent totalBytesSent:(int64_t)totalBytesSent totalBytesExpectedToSend:(int64_t)totalBytesExpectedToSend {
@@ -482,6 +548,16 @@ typedef NS_ENUM(NSInteger, AWSURLSessionTaskType) {
         }
     }
     
+    //If the caller asked for list items as they arrive, or for a lazily decoded response, let the response serializer consume the body as it arrives
+    if (!delegate.shouldWriteToFile
+        && (delegate.request.responseListItemHandler || delegate.request.decodesResponseLazily)
+        && [response isKindOfClass:[NSHTTPURLResponse class]]
+        && [delegate.request.responseSerializer conformsToProtocol:@protocol(AWSHTTPURLResponseStreamingSerializer)]) {
+        id<AWSHTTPURLResponseStreamingSerializer> responseSerializer = (id<AWSHTTPURLResponseStreamingSerializer>)delegate.request.responseSerializer;
+        delegate.responseStreamParser = [responseSerializer streamParserForResponse:(NSHTTPURLResponse *)response
+                                                                            request:delegate.request];
+    }
+
     @try {
         if (delegate.shouldWriteToFile) {
 
@@ -571,6 +647,13 @@ typedef NS_ENUM(NSInteger, AWSURLSessionTaskType) {
             delegate.error = [NSError errorWithDomain:AWSNetworkingErrorDomain code:AWSNetworkingErrorUnknown userInfo: userInfo];
             [dataTask cancel];
         }
+    } else if (delegate.responseStreamParser) {
+        NSError *error = nil;
+        if (![delegate.responseStreamParser parseData:data error:&error]) {
+            AWSDDLogError(@"Error: [%@]", error);
+            delegate.error = error;
+            [dataTask cancel];
+        }
     } else {
         if (!delegate.responseData) {
             delegate.responseData = [NSMutableData dataWithData:data];
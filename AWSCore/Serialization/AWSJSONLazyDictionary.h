@@ -0,0 +1,70 @@
+//
+// Copyright 2010-2021 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License.
+// A copy of the License is located at
+//
+// http://aws.amazon.com/apache2.0
+//
+// or in the "license" file accompanying this file. This file is distributed
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+//
+
+#import <Foundation/Foundation.h>
+#import "AWSNetworking.h"
+#import "AWSMTLJSONAdapter.h"
+
+/**
+ The output structure of a JSON response, backed by the raw response body.
+
+ Creating the dictionary scans the body once to find the byte range of each top-level member of the output shape.
+ A member is parsed, and converted the same way `AWSJSONParser` does, the first time its value is looked up. Models
+ parsed from this dictionary by `AWSMTLJSONAdapter` in turn decode their properties on first access, so a caller
+ reading only `nextToken` of a large list response never parses the list.
+
+ The scan checks the structure of the body, but the values of the members are only validated when they are parsed.
+ A member which turns out to be invalid JSON is treated as missing, and `decodingErrorForKey:` returns why.
+
+ The dictionary is safe to read from multiple threads. Counting or enumerating its keys parses all members, so that
+ the invalid members are left out, and so does copying it with `copy`. `mutableCopy` returns another lazy dictionary
+ sharing the body.
+ */
+@interface AWSJSONLazyDictionary : NSMutableDictionary <AWSMTLJSONLazyDecoding>
+
+/**
+ Returns a lazy dictionary for the body of a successful response, or `nil` if the response cannot be parsed lazily
+ (e.g. an error response, an output with a payload member, or a body which is not a JSON object). In that case, the
+ body should be parsed with `AWSJSONParser`.
+
+ @param data                  The response body.
+ @param response              The HTTP response the body belongs to.
+ @param actionName            The operation name.
+ @param serviceDefinitionRule The service definition.
+ */
++ (instancetype)dictionaryForJsonData:(NSData *)data
+                             response:(NSHTTPURLResponse *)response
+                           actionName:(NSString *)actionName
+                serviceDefinitionRule:(NSDictionary *)serviceDefinitionRule;
+
+@end
+
+/**
+ Collects the body of a response which should be decoded lazily. `AWSJSONResponseSerializer` returns it as the stream
+ parser of requests with `decodesResponseLazily` set, and turns the collected body into an `AWSJSONLazyDictionary`.
+ */
+@interface AWSJSONLazyResponseParser : NSObject <AWSHTTPURLResponseStreamParser>
+
+/**
+ Returns a parser for a successful response, or `nil` for any other response.
+ */
++ (instancetype)parserForResponse:(NSHTTPURLResponse *)response;
+
+/**
+ The response body received so far.
+ */
+@property (nonatomic, strong, readonly) NSData *data;
+
+@end
@@ -0,0 +1,414 @@
+//
+// Copyright 2010-2021 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License.
+// A copy of the License is located at
+//
+// http://aws.amazon.com/apache2.0
+//
+// or in the "license" file accompanying this file. This file is distributed
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+//
+
+#import "AWSJSONLazyDictionary.h"
+#import "AWSSerialization.h"
+#import "AWSCocoaLumberjack.h"
+
+@interface AWSJSONParser (AWSJSONLazyDictionary)
+
++ (id)serializeMember:(NSDictionary *)shape value:(id)value target:(id)target error:(NSError *__autoreleasing *)error;
+
+@end
+
+// Bodies nested deeper than this are parsed eagerly.
+static const NSUInteger AWSJSONLazyDictionaryMaxDepth = 512;
+
+static inline BOOL AWSJSONLazyDictionaryIsWhitespace(uint8_t byte) {
+    return byte == ' ' || byte == '\t' || byte == '\r' || byte == '\n';
+}
+
+static inline NSUInteger AWSJSONLazyDictionarySkipWhitespace(const uint8_t *bytes, NSUInteger length, NSUInteger position) {
+    while (position < length && AWSJSONLazyDictionaryIsWhitespace(bytes[position])) {
+        position++;
+    }
+    return position;
+}
+
+// Returns the position after the string starting with the quote at `position`, or `NSNotFound` if the string is not
+// terminated. `escaped` is set if the string contains escape sequences.
+static NSUInteger AWSJSONLazyDictionarySkipString(const uint8_t *bytes, NSUInteger length, NSUInteger position, BOOL *escaped) {
+    position++;
+    while (position < length) {
+        uint8_t byte = bytes[position];
+        if (byte == '"') {
+            return position + 1;
+        }
+        if (byte == '\\') {
+            if (escaped) {
+                *escaped = YES;
+            }
+            position += 2;
+            continue;
+        }
+        if (byte < 0x20) {
+            return NSNotFound;
+        }
+        position++;
+    }
+    return NSNotFound;
+}
+
+// Returns the position after the value starting at `position`, or `NSNotFound` if its brackets or quotes do not match.
+static NSUInteger AWSJSONLazyDictionarySkipValue(const uint8_t *bytes, NSUInteger length, NSUInteger position) {
+    if (position >= length) {
+        return NSNotFound;
+    }
+
+    uint8_t byte = bytes[position];
+    if (byte == '"') {
+        return AWSJSONLazyDictionarySkipString(bytes, length, position, NULL);
+    }
+
+    if (byte == '{' || byte == '[') {
+        uint8_t closingBrackets[AWSJSONLazyDictionaryMaxDepth];
+        NSUInteger depth = 0;
+        while (position < length) {
+            byte = bytes[position];
+            if (byte == '"') {
+                position = AWSJSONLazyDictionarySkipString(bytes, length, position, NULL);
+                if (position == NSNotFound) {
+                    return NSNotFound;
+                }
+                continue;
+            }
+            if (byte == '{' || byte == '[') {
+                if (depth == AWSJSONLazyDictionaryMaxDepth) {
+                    return NSNotFound;
+                }
+                closingBrackets[depth++] = (byte == '{') ? '}' : ']';
+            } else if (byte == '}' || byte == ']') {
+                if (depth == 0 || closingBrackets[depth - 1] != byte) {
+                    return NSNotFound;
+                }
+                if (--depth == 0) {
+                    return position + 1;
+                }
+            }
+            position++;
+        }
+        return NSNotFound;
+    }
+
+    // A number, `true`, `false` or `null`.
+    NSUInteger start = position;
+    while (position < length) {
+        byte = bytes[position];
+        if (byte == ',' || byte == '}' || byte == ']' || AWSJSONLazyDictionaryIsWhitespace(byte)) {
+            break;
+        }
+        position++;
+    }
+    return position > start ? position : NSNotFound;
+}
+
+@implementation AWSJSONLazyDictionary {
+    NSData *_data;
+    NSDictionary *_memberShapes;
+    NSMutableDictionary *_ranges;
+    NSMutableDictionary *_values;
+    // The errors of the members which failed to parse, keyed by member name.
+    NSMutableDictionary *_errors;
+}
+
++ (instancetype)dictionaryForJsonData:(NSData *)data
+                             response:(NSHTTPURLResponse *)response
+                           actionName:(NSString *)actionName
+                serviceDefinitionRule:(NSDictionary *)serviceDefinitionRule {
+    if ([data length] == 0 || response.statusCode / 100 != 2) {
+        return nil;
+    }
+
+    NSDictionary *actionRule = [[[serviceDefinitionRule objectForKey:@"operations"] objectForKey:actionName] objectForKey:@"output"];
+    NSDictionary *definitionRules = [serviceDefinitionRule objectForKey:@"shapes"];
+    if (![actionRule isKindOfClass:[NSDictionary class]]
+        || ![definitionRules isKindOfClass:[NSDictionary class]]
+        || [definitionRules count] == 0) {
+        return nil;
+    }
+
+    AWSJSONDictionary *rules = [[AWSJSONDictionary alloc] initWithDictionary:actionRule JSONDefinitionRule:definitionRules];
+
+    // Payload members are returned as-is or parsed as a whole by `AWSJSONParser`.
+    if (rules[@"payload"] || ![rules[@"type"] isEqualToString:@"structure"]) {
+        return nil;
+    }
+
+    NSDictionary *members = rules[@"members"];
+    NSMutableDictionary *memberShapes = [NSMutableDictionary new];
+    NSMutableDictionary *memberNamesByLocationName = [NSMutableDictionary new];
+    for (NSString *memberName in members) {
+        NSDictionary *memberShape = members[memberName];
+        memberShapes[memberName] = memberShape;
+
+        // The same lookup as `findMemberName:structureRules:` of `AWSJSONParser`.
+        NSString *locationName = memberShape[@"locationName"];
+        if ([locationName isKindOfClass:[NSString class]] && !memberNamesByLocationName[locationName]) {
+            memberNamesByLocationName[locationName] = memberName;
+        }
+    }
+
+    NSMutableDictionary *ranges = [NSMutableDictionary new];
+    const uint8_t *bytes = [data bytes];
+    NSUInteger length = [data length];
+
+    NSUInteger position = AWSJSONLazyDictionarySkipWhitespace(bytes, length, 0);
+    if (position >= length || bytes[position] != '{') {
+        return nil;
+    }
+    position = AWSJSONLazyDictionarySkipWhitespace(bytes, length, position + 1);
+
+    if (position < length && bytes[position] == '}') {
+        position++;
+    } else {
+        while (YES) {
+            if (position >= length || bytes[position] != '"') {
+                return nil;
+            }
+
+            BOOL escaped = NO;
+            NSUInteger keyEnd = AWSJSONLazyDictionarySkipString(bytes, length, position, &escaped);
+            if (keyEnd == NSNotFound) {
+                return nil;
+            }
+
+            NSString *key = nil;
+            if (escaped) {
+                NSData *keyData = [data subdataWithRange:NSMakeRange(position, keyEnd - position)];
+                key = [NSJSONSerialization JSONObjectWithData:keyData options:NSJSONReadingAllowFragments error:nil];
+            } else {
+                key = [[NSString alloc] initWithBytes:bytes + position + 1 length:keyEnd - position - 2 encoding:NSUTF8StringEncoding];
+            }
+            if (![key isKindOfClass:[NSString class]]) {
+                return nil;
+            }
+
+            position = AWSJSONLazyDictionarySkipWhitespace(bytes, length, keyEnd);
+            if (position >= length || bytes[position] != ':') {
+                return nil;
+            }
+            position = AWSJSONLazyDictionarySkipWhitespace(bytes, length, position + 1);
+
+            NSUInteger valueEnd = AWSJSONLazyDictionarySkipValue(bytes, length, position);
+            if (valueEnd == NSNotFound) {
+                return nil;
+            }
+
+            // Like `AWSJSONParser`, members which are not part of the output shape are dropped.
+            NSString *memberName = memberNamesByLocationName[key] ?: key;
+            if (memberShapes[memberName]) {
+                ranges[memberName] = [NSValue valueWithRange:NSMakeRange(position, valueEnd - position)];
+            }
+
+            position = AWSJSONLazyDictionarySkipWhitespace(bytes, length, valueEnd);
+            if (position < length && bytes[position] == ',') {
+                position = AWSJSONLazyDictionarySkipWhitespace(bytes, length, position + 1);
+                continue;
+            }
+            if (position < length && bytes[position] == '}') {
+                position++;
+                break;
+            }
+            return nil;
+        }
+    }
+
+    if (AWSJSONLazyDictionarySkipWhitespace(bytes, length, position) != length) {
+        return nil;
+    }
+
+    return [[self alloc] initWithData:[data copy]
+                         memberShapes:memberShapes
+                               ranges:ranges
+                               values:[NSMutableDictionary new]];
+}
+
+- (instancetype)initWithData:(NSData *)data
+                memberShapes:(NSDictionary *)memberShapes
+                      ranges:(NSMutableDictionary *)ranges
+                      values:(NSMutableDictionary *)values {
+    if (self = [super init]) {
+        _data = data;
+        _memberShapes = memberShapes;
+        _ranges = ranges;
+        _values = values;
+        _errors = [NSMutableDictionary new];
+    }
+
+    return self;
+}
+
+- (instancetype)init {
+    return [self initWithData:nil
+                 memberShapes:@{}
+                       ranges:[NSMutableDictionary new]
+                       values:[NSMutableDictionary new]];
+}
+
+- (instancetype)initWithCapacity:(NSUInteger)numItems {
+    return [self init];
+}
+
+- (instancetype)initWithObjects:(const id [])objects forKeys:(const id<NSCopying> [])keys count:(NSUInteger)count {
+    if (self = [self init]) {
+        for (NSUInteger i = 0; i < count; i++) {
+            _values[keys[i]] = objects[i];
+        }
+    }
+
+    return self;
+}
+
+- (id)decodeMember:(NSString *)memberName range:(NSRange)range error:(NSError *__autoreleasing *)error {
+    // The body is kept alive by the receiver while the member is parsed.
+    NSData *valueData = [NSData dataWithBytesNoCopy:(void *)((const uint8_t *)[_data bytes] + range.location)
+                                             length:range.length
+                                       freeWhenDone:NO];
+    id value = [NSJSONSerialization JSONObjectWithData:valueData
+                                               options:NSJSONReadingAllowFragments
+                                                 error:error];
+    if (!value) {
+        AWSDDLogError(@"Failed to parse the member %@ of the response: %@", memberName, *error);
+        return nil;
+    }
+
+    value = [AWSJSONParser serializeMember:_memberShapes[memberName] value:value target:nil error:error];
+    if (*error) {
+        AWSDDLogError(@"Failed to convert the member %@ of the response: %@", memberName, *error);
+    }
+
+    return value;
+}
+
+// Parses the members which have not been looked up yet. The members which fail to parse are dropped, so that the keys
+// counted and enumerated are the keys `objectForKey:` returns a value for.
+- (void)decodePendingMembers {
+    for (NSString *key in [_ranges allKeys]) {
+        [self objectForKey:key];
+    }
+}
+
+#pragma mark - NSDictionary
+
+- (NSUInteger)count {
+    @synchronized (self) {
+        [self decodePendingMembers];
+        return [_values count];
+    }
+}
+
+- (id)objectForKey:(id)key {
+    @synchronized (self) {
+        id value = _values[key];
+        if (value) {
+            return value;
+        }
+
+        NSValue *range = _ranges[key];
+        if (!range) {
+            return nil;
+        }
+        [_ranges removeObjectForKey:key];
+
+        NSError *error = nil;
+        value = [self decodeMember:key range:[range rangeValue] error:&error];
+        if (value) {
+            _values[key] = value;
+        } else if (error) {
+            _errors[key] = error;
+        }
+        if ([_ranges count] == 0) {
+            // Every member has been parsed.
+            _data = nil;
+        }
+
+        return value;
+    }
+}
+
+- (NSEnumerator *)keyEnumerator {
+    @synchronized (self) {
+        [self decodePendingMembers];
+        return [[_values allKeys] objectEnumerator];
+    }
+}
+
+#pragma mark - AWSMTLJSONLazyDecoding
+
+- (NSError *)decodingErrorForKey:(NSString *)key {
+    @synchronized (self) {
+        return _errors[key];
+    }
+}
+
+#pragma mark - NSMutableDictionary
+
+- (void)setObject:(id)object forKey:(id<NSCopying>)key {
+    @synchronized (self) {
+        [_ranges removeObjectForKey:key];
+        _values[key] = object;
+    }
+}
+
+- (void)removeObjectForKey:(id)key {
+    @synchronized (self) {
+        [_ranges removeObjectForKey:key];
+        [_values removeObjectForKey:key];
+    }
+}
+
+#pragma mark - NSMutableCopying
+
+- (id)mutableCopyWithZone:(NSZone *)zone {
+    @synchronized (self) {
+        return [[AWSJSONLazyDictionary allocWithZone:zone] initWithData:_data
+                                                           memberShapes:_memberShapes
+                                                                 ranges:[_ranges mutableCopy]
+                                                                 values:[_values mutableCopy]];
+    }
+}
+
+@end
+
+@implementation AWSJSONLazyResponseParser {
+    NSMutableData *_data;
+}
+
++ (instancetype)parserForResponse:(NSHTTPURLResponse *)response {
+    if (response.statusCode / 100 != 2) {
+        return nil;
+    }
+
+    return [self new];
+}
+
+- (instancetype)init {
+    if (self = [super init]) {
+        _data = [NSMutableData new];
+    }
+
+    return self;
+}
+
+- (NSData *)data {
+    return _data;
+}
+
+- (BOOL)parseData:(NSData *)data error:(NSError *__autoreleasing *)error {
+    [_data appendData:data];
+    return YES;
+}
+
+@end
@@ -0,0 +1,70 @@
+//
+// Copyright 2010-2021 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License.
+// A copy of the License is located at
+//
+// http://aws.amazon.com/apache2.0
+//
+// or in the "license" file accompanying this file. This file is distributed
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+//
+
+#import <Foundation/Foundation.h>
+#import "AWSNetworking.h"
+#import "AWSSerialization.h"
+
+/**
+ An incremental JSON parser bound to the output shape of an operation.
+
+ The response body is fed to the parser in arbitrary chunks as it arrives from the network. Elements of the
+ top-level list members of the output structure (e.g. `Items` of a DynamoDB `Scan`, `events` of a CloudWatch Logs
+ `FilterLogEvents`) are decoded one at a time and handed to the list item handler as soon as the closing bracket
+ of the element has been read. Only the bytes of the element currently being read are buffered, so the memory
+ footprint is bounded by the largest single element rather than by the size of the response.
+
+ All other members of the output structure are parsed the same way as `AWSJSONParser` does and are returned from
+ `finishWithError:`. Streamed list members are not included in that result.
+
+ If the response body is not a JSON object, the parser falls back to buffering the body and parsing it with
+ `AWSJSONParser` when the body is complete.
+ */
+@interface AWSJSONStreamParser : NSObject <AWSHTTPURLResponseStreamParser>
+
+/**
+ Returns a parser for the output of the given operation, or `nil` if the output shape has no list members which
+ can be streamed.
+
+ @param response              The HTTP response the body belongs to. Only 2xx responses are streamed.
+ @param actionName            The operation name.
+ @param serviceDefinitionRule The service definition.
+ @param listItemHandler       The block called with the member name and the parsed element of a streamed list.
+ */
++ (instancetype)parserForResponse:(NSHTTPURLResponse *)response
+                       actionName:(NSString *)actionName
+            serviceDefinitionRule:(NSDictionary *)serviceDefinitionRule
+                  listItemHandler:(AWSNetworkingResponseListItemBlock)listItemHandler;
+
+/**
+ The member names of the list members whose elements are delivered to the list item handler.
+ */
+@property (nonatomic, strong, readonly) NSSet<NSString *> *streamedMemberNames;
+
+/**
+ Parses the next chunk of the response body.
+
+ @return `NO` if the chunk is not valid JSON. Once this returns `NO`, the parser ignores any further data.
+ */
+- (BOOL)parseData:(NSData *)data error:(NSError *__autoreleasing *)error;
+
+/**
+ Completes parsing after the last chunk of the response body has been passed to `parseData:error:`.
+
+ @return The parsed output structure without the streamed list members, or `nil` if the body was truncated or invalid.
+ */
+- (NSDictionary *)finishWithError:(NSError *__autoreleasing *)error;
+
+@end
@@ -0,0 +1,461 @@
+//
+// Copyright 2010-2021 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License.
+// A copy of the License is located at
+//
+// http://aws.amazon.com/apache2.0
+//
+// or in the "license" file accompanying this file. This file is distributed
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+//
+
+#import "AWSJSONStreamParser.h"
+#import "AWSCocoaLumberjack.h"
+
+@interface AWSJSONParser (AWSJSONStreamParser)
+
++ (NSString *)findMemberName:(NSString*)locationName structureRules:(NSDictionary *)structureRules;
++ (id)serializeMember:(NSDictionary *)shape value:(id)value target:(id)target error:(NSError *__autoreleasing *)error;
+
+@end
+
+typedef NS_ENUM(NSInteger, AWSJSONStreamParserState) {
+    AWSJSONStreamParserStateExpectObject,
+    AWSJSONStreamParserStateExpectFirstKey,
+    AWSJSONStreamParserStateExpectKey,
+    AWSJSONStreamParserStateKey,
+    AWSJSONStreamParserStateExpectColon,
+    AWSJSONStreamParserStateExpectValue,
+    AWSJSONStreamParserStateValue,
+    AWSJSONStreamParserStateExpectMemberSeparator,
+    AWSJSONStreamParserStateExpectFirstElement,
+    AWSJSONStreamParserStateExpectElement,
+    AWSJSONStreamParserStateElement,
+    AWSJSONStreamParserStateExpectElementSeparator,
+    AWSJSONStreamParserStateDone,
+    AWSJSONStreamParserStateBuffering,
+    AWSJSONStreamParserStateFailed,
+};
+
+typedef NS_ENUM(NSInteger, AWSJSONStreamParserValueKind) {
+    AWSJSONStreamParserValueKindContainer,
+    AWSJSONStreamParserValueKindString,
+    AWSJSONStreamParserValueKindScalar,
+};
+
+static inline BOOL AWSJSONStreamParserIsWhitespace(uint8_t byte) {
+    return byte == ' ' || byte == '\t' || byte == '\r' || byte == '\n';
+}
+
+@interface AWSJSONStreamParser()
+
+@property (nonatomic, strong) NSHTTPURLResponse *response;
+@property (nonatomic, strong) NSString *actionName;
+@property (nonatomic, strong) NSDictionary *serviceDefinitionRule;
+@property (nonatomic, strong) AWSJSONDictionary *rules;
+@property (nonatomic, copy) AWSNetworkingResponseListItemBlock listItemHandler;
+@property (nonatomic, strong) NSSet<NSString *> *streamedMemberNames;
+
+@property (nonatomic, strong) NSMutableDictionary *parsedData;
+@property (nonatomic, strong) NSMutableData *valueBuffer;
+@property (nonatomic, strong) NSString *currentMemberName;
+@property (nonatomic, strong) NSDictionary *currentListRules;
+
+@end
+
+@implementation AWSJSONStreamParser {
+    AWSJSONStreamParserState _state;
+    AWSJSONStreamParserValueKind _valueKind;
+    NSInteger _valueDepth;
+    BOOL _valueStarted;
+    BOOL _valueInString;
+    BOOL _valueEscaped;
+}
+
++ (instancetype)parserForResponse:(NSHTTPURLResponse *)response
+                       actionName:(NSString *)actionName
+            serviceDefinitionRule:(NSDictionary *)serviceDefinitionRule
+                  listItemHandler:(AWSNetworkingResponseListItemBlock)listItemHandler {
+    if (!listItemHandler || response.statusCode / 100 != 2) {
+        return nil;
+    }
+
+    NSDictionary *actionRule = [[[serviceDefinitionRule objectForKey:@"operations"] objectForKey:actionName] objectForKey:@"output"];
+    NSDictionary *definitionRules = [serviceDefinitionRule objectForKey:@"shapes"];
+    if (![actionRule isKindOfClass:[NSDictionary class]]
+        || ![definitionRules isKindOfClass:[NSDictionary class]]
+        || [definitionRules count] == 0) {
+        return nil;
+    }
+
+    AWSJSONDictionary *rules = [[AWSJSONDictionary alloc] initWithDictionary:actionRule JSONDefinitionRule:definitionRules];
+
+    // Payload members are returned as-is or parsed as a whole by `AWSJSONParser`.
+    if (rules[@"payload"]) {
+        return nil;
+    }
+
+    NSMutableSet *streamedMemberNames = [NSMutableSet new];
+    NSDictionary *members = rules[@"members"];
+    for (NSString *memberName in members) {
+        NSDictionary *memberShape = members[memberName];
+        if ([memberShape[@"type"] isEqualToString:@"list"]
+            && !memberShape[@"location"]) {
+            [streamedMemberNames addObject:memberName];
+        }
+    }
+    if ([streamedMemberNames count] == 0) {
+        return nil;
+    }
+
+    AWSJSONStreamParser *parser = [self new];
+    parser.response = response;
+    parser.actionName = actionName;
+    parser.serviceDefinitionRule = serviceDefinitionRule;
+    parser.rules = rules;
+    parser.listItemHandler = listItemHandler;
+    parser.streamedMemberNames = streamedMemberNames;
+
+    return parser;
+}
+
+- (instancetype)init {
+    if (self = [super init]) {
+        _state = AWSJSONStreamParserStateExpectObject;
+        _parsedData = [NSMutableDictionary new];
+        _valueBuffer = [NSMutableData new];
+    }
+
+    return self;
+}
+
++ (BOOL)failWithDescription:(NSString *)description error:(NSError *__autoreleasing *)error {
+    if (error) {
+        *error = [NSError errorWithDomain:AWSJSONParserErrorDomain
+                                     code:AWSJSONParserInvalidParameter
+                                 userInfo:@{NSLocalizedDescriptionKey : description}];
+    }
+    return NO;
+}
+
+#pragma mark - Parsing
+
+- (BOOL)parseData:(NSData *)data error:(NSError *__autoreleasing *)error {
+    __block BOOL result = YES;
+    __block NSError *parseError = nil;
+    [data enumerateByteRangesUsingBlock:^(const void *bytes, NSRange byteRange, BOOL *stop) {
+        NSError *chunkError = nil;
+        if (![self parseBytes:(const uint8_t *)bytes length:byteRange.length error:&chunkError]) {
+            parseError = chunkError;
+            result = NO;
+            *stop = YES;
+        }
+    }];
+
+    if (!result && error) {
+        *error = parseError;
+    }
+    return result;
+}
+
+- (BOOL)parseBytes:(const uint8_t *)bytes length:(NSUInteger)length error:(NSError *__autoreleasing *)error {
+    NSUInteger index = 0;
+    while (index < length) {
+        uint8_t byte = bytes[index];
+        switch (_state) {
+            case AWSJSONStreamParserStateFailed:
+                return NO;
+
+            case AWSJSONStreamParserStateBuffering:
+                [self.valueBuffer appendBytes:bytes + index length:length - index];
+                return YES;
+
+            case AWSJSONStreamParserStateExpectObject:
+                if (AWSJSONStreamParserIsWhitespace(byte)) {
+                    index++;
+                } else if (byte == '{') {
+                    _state = AWSJSONStreamParserStateExpectFirstKey;
+                    index++;
+                } else {
+                    // Not an object; parse the whole body at the end.
+                    _state = AWSJSONStreamParserStateBuffering;
+                }
+                break;
+
+            case AWSJSONStreamParserStateExpectFirstKey:
+            case AWSJSONStreamParserStateExpectKey:
+                if (AWSJSONStreamParserIsWhitespace(byte)) {
+                    index++;
+                } else if (byte == '"') {
+                    [self beginValue];
+                    _state = AWSJSONStreamParserStateKey;
+                } else if (byte == '}' && _state == AWSJSONStreamParserStateExpectFirstKey) {
+                    _state = AWSJSONStreamParserStateDone;
+                    index++;
+                } else {
+                    return [self failWithByte:byte error:error];
+                }
+                break;
+
+            case AWSJSONStreamParserStateExpectColon:
+                if (AWSJSONStreamParserIsWhitespace(byte)) {
+                    index++;
+                } else if (byte == ':') {
+                    _state = AWSJSONStreamParserStateExpectValue;
+                    index++;
+                } else {
+                    return [self failWithByte:byte error:error];
+                }
+                break;
+
+            case AWSJSONStreamParserStateExpectValue:
+                if (AWSJSONStreamParserIsWhitespace(byte)) {
+                    index++;
+                } else if (byte == '[' && self.currentListRules) {
+                    _state = AWSJSONStreamParserStateExpectFirstElement;
+                    index++;
+                } else {
+                    [self beginValue];
+                    _state = AWSJSONStreamParserStateValue;
+                }
+                break;
+
+            case AWSJSONStreamParserStateExpectFirstElement:
+            case AWSJSONStreamParserStateExpectElement:
+                if (AWSJSONStreamParserIsWhitespace(byte)) {
+                    index++;
+                } else if (byte == ']' && _state == AWSJSONStreamParserStateExpectFirstElement) {
+                    self.currentListRules = nil;
+                    _state = AWSJSONStreamParserStateExpectMemberSeparator;
+                    index++;
+                } else if (byte == ']' || byte == ',') {
+                    return [self failWithByte:byte error:error];
+                } else {
+                    [self beginValue];
+                    _state = AWSJSONStreamParserStateElement;
+                }
+                break;
+
+            case AWSJSONStreamParserStateExpectElementSeparator:
+                if (AWSJSONStreamParserIsWhitespace(byte)) {
+                    index++;
+                } else if (byte == ',') {
+                    _state = AWSJSONStreamParserStateExpectElement;
+                    index++;
+                } else if (byte == ']') {
+                    self.currentListRules = nil;
+                    _state = AWSJSONStreamParserStateExpectMemberSeparator;
+                    index++;
+                } else {
+                    return [self failWithByte:byte error:error];
+                }
+                break;
+
+            case AWSJSONStreamParserStateExpectMemberSeparator:
+                if (AWSJSONStreamParserIsWhitespace(byte)) {
+                    index++;
+                } else if (byte == ',') {
+                    _state = AWSJSONStreamParserStateExpectKey;
+                    index++;
+                } else if (byte == '}') {
+                    _state = AWSJSONStreamParserStateDone;
+                    index++;
+                } else {
+                    return [self failWithByte:byte error:error];
+                }
+                break;
+
+            case AWSJSONStreamParserStateDone:
+                if (AWSJSONStreamParserIsWhitespace(byte)) {
+                    index++;
+                } else {
+                    return [self failWithByte:byte error:error];
+                }
+                break;
+
+            case AWSJSONStreamParserStateKey:
+            case AWSJSONStreamParserStateValue:
+            case AWSJSONStreamParserStateElement: {
+                // Scan ahead to the end of the value, or to the end of the chunk.
+                NSUInteger start = index;
+                BOOL consumed = YES;
+                BOOL complete = NO;
+                while (index < length && !complete) {
+                    complete = [self scanValueByte:bytes[index] consumed:&consumed];
+                    if (consumed) {
+                        index++;
+                    }
+                }
+                [self.valueBuffer appendBytes:bytes + start length:index - start];
+                if (complete && ![self completeValueWithError:error]) {
+                    _state = AWSJSONStreamParserStateFailed;
+                    return NO;
+                }
+            }
+                break;
+        }
+    }
+
+    return YES;
+}
+
+- (void)beginValue {
+    [self.valueBuffer setLength:0];
+    _valueDepth = 0;
+    _valueStarted = NO;
+    _valueInString = NO;
+    _valueEscaped = NO;
+}
+
+/**
+ Advances the value scanner by one byte. Returns `YES` when the byte completes the value. A scalar value is only
+ complete once the delimiter following it has been seen; the delimiter is left for the enclosing state.
+ */
+- (BOOL)scanValueByte:(uint8_t)byte consumed:(BOOL *)consumed {
+    *consumed = YES;
+
+    if (!_valueStarted) {
+        _valueStarted = YES;
+        if (byte == '{' || byte == '[') {
+            _valueKind = AWSJSONStreamParserValueKindContainer;
+            _valueDepth = 1;
+        } else if (byte == '"') {
+            _valueKind = AWSJSONStreamParserValueKindString;
+            _valueInString = YES;
+        } else {
+            _valueKind = AWSJSONStreamParserValueKindScalar;
+        }
+        return NO;
+    }
+
+    if (_valueInString) {
+        if (_valueEscaped) {
+            _valueEscaped = NO;
+        } else if (byte == '\\') {
+            _valueEscaped = YES;
+        } else if (byte == '"') {
+            _valueInString = NO;
+            return _valueKind == AWSJSONStreamParserValueKindString;
+        }
+        return NO;
+    }
+
+    switch (_valueKind) {
+        case AWSJSONStreamParserValueKindContainer:
+            if (byte == '"') {
+                _valueInString = YES;
+            } else if (byte == '{' || byte == '[') {
+                _valueDepth++;
+            } else if (byte == '}' || byte == ']') {
+                _valueDepth--;
+                return _valueDepth == 0;
+            }
+            return NO;
+
+        case AWSJSONStreamParserValueKindScalar:
+            if (byte == ',' || byte == '}' || byte == ']' || AWSJSONStreamParserIsWhitespace(byte)) {
+                *consumed = NO;
+                return YES;
+            }
+            return NO;
+
+        default:
+            return NO;
+    }
+}
+
+- (BOOL)completeValueWithError:(NSError *__autoreleasing *)error {
+    NSError *JSONError = nil;
+    id value = [NSJSONSerialization JSONObjectWithData:self.valueBuffer
+                                               options:NSJSONReadingAllowFragments
+                                                 error:&JSONError];
+    [self beginValue];
+
+    if (!value) {
+        if (error) {
+            *error = JSONError;
+        }
+        return NO;
+    }
+
+    switch (_state) {
+        case AWSJSONStreamParserStateKey: {
+            if (![value isKindOfClass:[NSString class]]) {
+                return [AWSJSONStreamParser failWithDescription:@"a member name should be a string." error:error];
+            }
+            self.currentMemberName = [AWSJSONParser findMemberName:value structureRules:self.rules];
+            self.currentListRules = nil;
+            if ([self.streamedMemberNames containsObject:self.currentMemberName]) {
+                self.currentListRules = self.rules[@"members"][self.currentMemberName];
+            }
+            _state = AWSJSONStreamParserStateExpectColon;
+        }
+            break;
+
+        case AWSJSONStreamParserStateValue: {
+            NSDictionary *memberShape = self.rules[@"members"][self.currentMemberName];
+            if (memberShape) {
+                self.parsedData[self.currentMemberName] = [AWSJSONParser serializeMember:memberShape
+                                                                                   value:value
+                                                                                  target:nil
+                                                                                   error:error];
+            }
+            self.currentListRules = nil;
+            _state = AWSJSONStreamParserStateExpectMemberSeparator;
+        }
+            break;
+
+        case AWSJSONStreamParserStateElement: {
+            @autoreleasepool {
+                id item = [AWSJSONParser serializeMember:self.currentListRules[@"member"]
+                                                   value:value
+                                                  target:nil
+                                                   error:error];
+                if (item) {
+                    self.listItemHandler(self.currentMemberName, item);
+                }
+            }
+            _state = AWSJSONStreamParserStateExpectElementSeparator;
+        }
+            break;
+
+        default:
+            break;
+    }
+
+    return YES;
+}
+
+- (BOOL)failWithByte:(uint8_t)byte error:(NSError *__autoreleasing *)error {
+    _state = AWSJSONStreamParserStateFailed;
+    return [AWSJSONStreamParser failWithDescription:[NSString stringWithFormat:@"unexpected character '%c' in the response body.", byte]
+                                              error:error];
+}
+
+- (NSDictionary *)finishWithError:(NSError *__autoreleasing *)error {
+    switch (_state) {
+        case AWSJSONStreamParserStateDone:
+            return self.parsedData;
+
+        case AWSJSONStreamParserStateBuffering:
+            return [AWSJSONParser dictionaryForJsonData:self.valueBuffer
+                                               response:self.response
+                                             actionName:self.actionName
+                                  serviceDefinitionRule:self.serviceDefinitionRule
+                                                  error:error];
+
+        case AWSJSONStreamParserStateFailed:
+            AWSDDLogError(@"Failed to parse the streamed response body.");
+            return nil;
+
+        default:
+            [AWSJSONStreamParser failWithDescription:@"the response body ended before the JSON object was complete." error:error];
+            return nil;
+    }
+}
+
+@end
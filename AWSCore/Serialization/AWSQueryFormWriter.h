@@ -0,0 +1,42 @@
+//
+// Copyright 2010-2021 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License.
+// A copy of the License is located at
+//
+// http://aws.amazon.com/apache2.0
+//
+// or in the "license" file accompanying this file. This file is distributed
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+//
+
+#import <Foundation/Foundation.h>
+
+typedef NS_ENUM(NSInteger, AWSQueryFormWriterProtocol) {
+    AWSQueryFormWriterProtocolQuery,
+    AWSQueryFormWriterProtocolEC2,
+};
+
+/**
+ Writes the `application/x-www-form-urlencoded` body of a Query or EC2 protocol request.
+
+ The writer walks the input shape and percent-encodes the flattened keys (e.g. `Attribute.1.Name`) and values
+ straight into the body, instead of building a dictionary of flattened keys with `AWSQueryParamBuilder` or
+ `AWSEC2ParamBuilder` and encoding it in a second pass. `Action` and `Version` come first, followed by the members
+ of each structure sorted by name, and the elements of lists in order.
+
+ Errors are reported in `AWSQueryParamBuilderErrorDomain` or `AWSEC2ParamBuilderErrorDomain`, matching the
+ corresponding parameter builder.
+ */
+@interface AWSQueryFormWriter : NSObject
+
++ (NSData *)formDataForDictionary:(NSDictionary *)params
+                       actionName:(NSString *)actionName
+            serviceDefinitionRule:(NSDictionary *)serviceDefinitionRule
+                         protocol:(AWSQueryFormWriterProtocol)protocol
+                            error:(NSError *__autoreleasing *)error;
+
+@end
@@ -0,0 +1,405 @@
+//
+// Copyright 2010-2021 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License.
+// A copy of the License is located at
+//
+// http://aws.amazon.com/apache2.0
+//
+// or in the "license" file accompanying this file. This file is distributed
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+//
+
+#import "AWSQueryFormWriter.h"
+#import "AWSSerialization.h"
+#import "AWSTimestampSerialization.h"
+#import "AWSCocoaLumberjack.h"
+
+static const char AWSQueryFormWriterHexDigits[] = "0123456789ABCDEF";
+
+// RFC 3986 unreserved characters; everything else is percent-encoded, the same as `aws_stringWithURLEncoding`.
+static inline BOOL AWSQueryFormWriterIsUnreserved(uint8_t byte) {
+    return (byte >= 'A' && byte <= 'Z')
+    || (byte >= 'a' && byte <= 'z')
+    || (byte >= '0' && byte <= '9')
+    || byte == '-' || byte == '_' || byte == '.' || byte == '~';
+}
+
+static void AWSQueryFormWriterAppendEncodedBytes(NSMutableData *data, const uint8_t *bytes, NSUInteger length) {
+    NSUInteger start = [data length];
+    [data setLength:start + length * 3];
+    uint8_t *output = (uint8_t *)[data mutableBytes] + start;
+    NSUInteger written = 0;
+    for (NSUInteger i = 0; i < length; i++) {
+        uint8_t byte = bytes[i];
+        if (AWSQueryFormWriterIsUnreserved(byte)) {
+            output[written++] = byte;
+        } else {
+            output[written++] = '%';
+            output[written++] = AWSQueryFormWriterHexDigits[byte >> 4];
+            output[written++] = AWSQueryFormWriterHexDigits[byte & 0x0F];
+        }
+    }
+    [data setLength:start + written];
+}
+
+static void AWSQueryFormWriterAppendEncodedString(NSMutableData *data, NSString *string) {
+    // `aws_stringWithURLEncoding` decodes existing percent escapes before encoding; keep that behavior so the body
+    // stays byte-for-byte identical to the one built from `AWSQueryParamBuilder`.
+    if ([string rangeOfString:@"%"].location != NSNotFound) {
+        NSString *decodedString = [string stringByRemovingPercentEncoding];
+        string = decodedString ? decodedString : string;
+    }
+
+    const char *UTF8String = CFStringGetCStringPtr((__bridge CFStringRef)string, kCFStringEncodingUTF8);
+    if (UTF8String) {
+        AWSQueryFormWriterAppendEncodedBytes(data, (const uint8_t *)UTF8String, strlen(UTF8String));
+        return;
+    }
+
+    uint8_t buffer[512];
+    NSRange range = NSMakeRange(0, [string length]);
+    while (range.length > 0) {
+        NSUInteger usedLength = 0;
+        NSRange remainingRange = NSMakeRange(0, 0);
+        if (![string getBytes:buffer
+                    maxLength:sizeof(buffer)
+                   usedLength:&usedLength
+                     encoding:NSUTF8StringEncoding
+                      options:0
+                        range:range
+               remainingRange:&remainingRange]
+            || usedLength == 0) {
+            AWSDDLogError(@"can not encode string as UTF-8:%@", string);
+            return;
+        }
+        AWSQueryFormWriterAppendEncodedBytes(data, buffer, usedLength);
+        range = remainingRange;
+    }
+}
+
+@interface AWSQueryFormWriter()
+
+@property (nonatomic, assign) AWSQueryFormWriterProtocol protocol;
+@property (nonatomic, strong) NSMutableData *body;
+@property (nonatomic, strong) NSMutableData *key;
+
+@end
+
+@implementation AWSQueryFormWriter
+
++ (NSData *)formDataForDictionary:(NSDictionary *)params
+                       actionName:(NSString *)actionName
+            serviceDefinitionRule:(NSDictionary *)serviceDefinitionRule
+                         protocol:(AWSQueryFormWriterProtocol)protocol
+                            error:(NSError *__autoreleasing *)error {
+    AWSQueryFormWriter *writer = [self new];
+    writer.protocol = protocol;
+
+    if (!actionName) {
+        AWSDDLogError(@"actionName is nil!");
+        [writer failWithCode:AWSQueryParamBuilderUndefinedActionRule description:@"actionName is nil" error:error];
+        return nil;
+    }
+    [writer writeKey:"Action" string:actionName];
+
+    //add Version Number
+    id apiVersion = serviceDefinitionRule[@"metadata"][@"apiVersion"];
+    if ([apiVersion isKindOfClass:[NSString class]]) {
+        [writer writeKey:"Version" string:apiVersion];
+    } else {
+        AWSDDLogError(@"can not find apiVersion keyword in definition file!");
+    }
+
+    if ([params count] == 0) {
+        return writer.body;
+    }
+
+    //add params
+    NSDictionary *actionRule = [[[serviceDefinitionRule objectForKey:@"operations"] objectForKey:actionName] objectForKey:@"input"];
+    NSDictionary *definitionRules = [serviceDefinitionRule objectForKey:@"shapes"];
+
+    if (definitionRules == (id)[NSNull null] || [definitionRules count] == 0) {
+        [writer failWithCode:AWSQueryParamBuilderDefinitionFileIsEmpty description:@"JSON definition File is empty or can not be found" error:error];
+        return nil;
+    }
+
+    if ([actionRule count] == 0) {
+        [writer failWithCode:AWSQueryParamBuilderUndefinedActionRule description:@"Invalid argument: actionRule is Empty" error:error];
+        return nil;
+    }
+
+    AWSJSONDictionary *rules = [[AWSJSONDictionary alloc] initWithDictionary:actionRule JSONDefinitionRule:definitionRules];
+    if (![writer writeStructure:params rules:rules error:error]) {
+        return nil;
+    }
+
+    return writer.body;
+}
+
+- (instancetype)init {
+    if (self = [super init]) {
+        _body = [[NSMutableData alloc] initWithCapacity:1024];
+        _key = [[NSMutableData alloc] initWithCapacity:128];
+    }
+
+    return self;
+}
+
+- (BOOL)failWithCode:(NSInteger)code description:(NSString *)description error:(NSError *__autoreleasing *)error {
+    if (error) {
+        // The Query and EC2 builders share the numeric values of their error codes.
+        NSString *domain = self.protocol == AWSQueryFormWriterProtocolEC2 ? AWSEC2ParamBuilderErrorDomain : AWSQueryParamBuilderErrorDomain;
+        *error = [NSError errorWithDomain:domain
+                                     code:code
+                                 userInfo:@{NSLocalizedDescriptionKey : description}];
+    }
+    return NO;
+}
+
+#pragma mark - Keys
+
+- (void)appendKeyName:(NSString *)name {
+    AWSQueryFormWriterAppendEncodedString(self.key, name);
+}
+
+- (void)appendKeyIndex:(NSUInteger)index {
+    char buffer[24];
+    int length = snprintf(buffer, sizeof(buffer), ".%lu", (unsigned long)index);
+    [self.key appendBytes:buffer length:length];
+}
+
+- (void)appendKeyBytes:(const char *)bytes {
+    [self.key appendBytes:bytes length:strlen(bytes)];
+}
+
+- (NSString *)queryName:(NSDictionary *)shape withDefaultName:(NSString *)defaultName {
+    if (self.protocol == AWSQueryFormWriterProtocolEC2) {
+        NSString *queryName = shape[@"queryName"];
+        if (queryName) {
+            return queryName;
+        }
+        NSString *locationName = shape[@"locationName"];
+        if ([locationName length] > 0) {
+            //upper case the first character, only allocating a new string when it changes
+            unichar firstCharacter = [locationName characterAtIndex:0];
+            if (firstCharacter < 0x80 && !(firstCharacter >= 'a' && firstCharacter <= 'z')) {
+                return locationName;
+            }
+            return [[[locationName substringToIndex:1] uppercaseString] stringByAppendingString:[locationName substringFromIndex:1]];
+        }
+        return defaultName;
+    }
+
+    return shape[@"locationName"] ? shape[@"locationName"] : defaultName;
+}
+
+#pragma mark - Values
+
+- (void)beginPair {
+    if ([self.body length] > 0) {
+        [self.body appendBytes:"&" length:1];
+    }
+    [self.body appendData:self.key];
+    [self.body appendBytes:"=" length:1];
+}
+
+- (void)writeKey:(const char *)key string:(NSString *)value {
+    if ([self.body length] > 0) {
+        [self.body appendBytes:"&" length:1];
+    }
+    [self.body appendBytes:key length:strlen(key)];
+    [self.body appendBytes:"=" length:1];
+    AWSQueryFormWriterAppendEncodedString(self.body, value);
+}
+
+- (void)writeString:(NSString *)value {
+    [self beginPair];
+    AWSQueryFormWriterAppendEncodedString(self.body, value);
+}
+
+- (void)writeNumber:(NSNumber *)value {
+    const char *type = [value objCType];
+    if ([value isKindOfClass:[NSDecimalNumber class]] || type[0] == 'f' || type[0] == 'd') {
+        [self writeString:[value stringValue]];
+        return;
+    }
+
+    char buffer[24];
+    int length = 0;
+    if (type[0] == 'Q' || type[0] == 'L' || type[0] == 'I') {
+        length = snprintf(buffer, sizeof(buffer), "%llu", [value unsignedLongLongValue]);
+    } else {
+        length = snprintf(buffer, sizeof(buffer), "%lld", [value longLongValue]);
+    }
+    [self beginPair];
+    // Digits and '-' never need to be escaped.
+    [self.body appendBytes:buffer length:length];
+}
+
+- (BOOL)writeStructure:(NSDictionary *)values rules:(AWSJSONDictionary *)structureRules error:(NSError *__autoreleasing *)error {
+    if (![values isKindOfClass:[NSDictionary class]]) {
+        return [self failWithCode:AWSQueryParamBuilderInvalidParameter
+                      description:[NSString stringWithFormat:@"a structure input should be a dictionary but got:%@", values]
+                            error:error];
+    }
+
+    NSUInteger keyLength = [self.key length];
+    NSDictionary *members = structureRules[@"members"];
+    for (NSString *name in [[values allKeys] sortedArrayUsingSelector:@selector(compare:)]) {
+        id value = values[name];
+
+        AWSJSONDictionary *memberShape = members[name];
+        if (memberShape && value) {
+            if (keyLength > 0) {
+                [self appendKeyBytes:"."];
+            }
+            [self appendKeyName:[self queryName:memberShape withDefaultName:name]];
+            BOOL result = [self writeMember:value rules:memberShape error:error];
+            [self.key setLength:keyLength];
+            if (!result) {
+                return NO;
+            }
+        }
+    }
+
+    return YES;
+}
+
+- (BOOL)writeList:(NSArray *)values rules:(AWSJSONDictionary *)listRules error:(NSError *__autoreleasing *)error {
+    if (![values isKindOfClass:[NSArray class]]) {
+        return [self failWithCode:AWSQueryParamBuilderInvalidParameter
+                      description:[NSString stringWithFormat:@"a list input should be an array but got:%@", values]
+                            error:error];
+    }
+
+    if (self.protocol == AWSQueryFormWriterProtocolQuery) {
+        if ([listRules[@"flattened"] boolValue]) {
+            NSString *memberName = [self queryName:listRules[@"member"] withDefaultName:nil];
+            if (memberName) {
+                //substitute memberName for the last component of the key
+                const uint8_t *bytes = [self.key bytes];
+                NSUInteger length = [self.key length];
+                while (length > 0 && bytes[length - 1] != '.') {
+                    length--;
+                }
+                [self.key setLength:length];
+                [self appendKeyName:memberName];
+            }
+        } else {
+            [self appendKeyBytes:".member"];
+        }
+    }
+
+    NSUInteger keyLength = [self.key length];
+    AWSJSONDictionary *memberRules = listRules[@"member"];
+    NSUInteger index = 0;
+    for (id value in values) {
+        [self appendKeyIndex:++index];
+        BOOL result = [self writeMember:value rules:memberRules error:error];
+        [self.key setLength:keyLength];
+        if (!result) {
+            return NO;
+        }
+    }
+
+    return YES;
+}
+
+- (BOOL)writeMap:(NSDictionary *)values rules:(AWSJSONDictionary *)mapRules error:(NSError *__autoreleasing *)error {
+    if (self.protocol == AWSQueryFormWriterProtocolEC2) {
+        // EC2 does not have any map type yet
+        return [self failWithCode:AWSEC2ParamBuilderInternalError description:@"serialize map type value has not been implemented yet" error:error];
+    }
+    if (![values isKindOfClass:[NSDictionary class]]) {
+        return [self failWithCode:AWSQueryParamBuilderInvalidParameter
+                      description:[NSString stringWithFormat:@"a map input should be a dictionary but got:%@", values]
+                            error:error];
+    }
+
+    if ([mapRules[@"flattened"] boolValue] == NO) {
+        [self appendKeyBytes:".entry"];
+    }
+
+    AWSJSONDictionary *keyRules = mapRules[@"key"];
+    AWSJSONDictionary *valueRules = mapRules[@"value"];
+    NSString *keyName = [self queryName:keyRules withDefaultName:@"key"];
+    NSString *valueName = [self queryName:valueRules withDefaultName:@"value"];
+
+    NSUInteger keyLength = [self.key length];
+    NSUInteger index = 0;
+    for (NSString *key in [[values allKeys] sortedArrayUsingSelector:@selector(localizedCaseInsensitiveCompare:)]) {
+        [self appendKeyIndex:++index];
+        [self appendKeyBytes:"."];
+        NSUInteger entryLength = [self.key length];
+
+        [self appendKeyName:keyName];
+        BOOL result = [self writeMember:key rules:keyRules error:error];
+        [self.key setLength:entryLength];
+
+        if (result) {
+            [self appendKeyName:valueName];
+            result = [self writeMember:values[key] rules:valueRules error:error];
+        }
+        [self.key setLength:keyLength];
+        if (!result) {
+            return NO;
+        }
+    }
+
+    return YES;
+}
+
+- (BOOL)writeMember:(id)value rules:(AWSJSONDictionary *)shape error:(NSError *__autoreleasing *)error {
+    NSString *rulesType = shape[@"type"];
+    if ([rulesType isEqualToString:@"structure"]) {
+        return [self writeStructure:value rules:shape error:error];
+    } else if ([rulesType isEqualToString:@"list"]) {
+        return [self writeList:value rules:shape error:error];
+    } else if ([rulesType isEqualToString:@"map"]) {
+        return [self writeMap:value rules:shape error:error];
+    } else if ([rulesType isEqualToString:@"timestamp"]) {
+        NSString *timestampStr = nil;
+        if (self.protocol == AWSQueryFormWriterProtocolEC2) {
+            timestampStr = [AWSEC2TimestampSerialization serializeTimestamp:shape value:value error:error];
+        } else {
+            timestampStr = [AWSQueryTimestampSerialization serializeTimestamp:shape value:value error:error];
+        }
+        if (timestampStr) {
+            [self writeString:timestampStr];
+        }
+    } else if ([rulesType isEqualToString:@"blob"]) {
+        //encode NSData to Base64String
+        if ([value isKindOfClass:[NSString class]]) {
+            value = [value dataUsingEncoding:NSUTF8StringEncoding];
+        }
+        if ([value isKindOfClass:[NSData class]]) {
+            NSData *base64EncodedData = [value base64EncodedDataWithOptions:0];
+            [self beginPair];
+            AWSQueryFormWriterAppendEncodedBytes(self.body, [base64EncodedData bytes], [base64EncodedData length]);
+        } else {
+            return [self failWithCode:AWSQueryParamBuilderInvalidParameter description:@"'blob' value should be a NSData type." error:error];
+        }
+    } else if ([rulesType isEqualToString:@"boolean"]) {
+        [self beginPair];
+        if ([value boolValue]) {
+            [self.body appendBytes:"true" length:4];
+        } else {
+            [self.body appendBytes:"false" length:5];
+        }
+    } else if ([value isKindOfClass:[NSString class]]) {
+        [self writeString:value];
+    } else if ([value isKindOfClass:[NSNumber class]]) {
+        [self writeNumber:value];
+    } else {
+        AWSDDLogError(@"key[%@] is invalid.", [[NSString alloc] initWithData:self.key encoding:NSUTF8StringEncoding]);
+        [self writeString:[value description]];
+    }
+
+    return YES;
+}
+
+@end
@@ -14,7 +14,7 @@
 //
 #import "AWSSerialization.h"
 #import "AWSTimestampSerialization.h"
-#import "AWSXMLWriter.h"
+#import "AWSXMLByteWriter.h"
 #import "AWSCategory.h"
 #import "AWSCocoaLumberjack.h"
 #import "AWSXMLDictionary.h"
@@ -118,7 +118,7 @@ NSString *const AWSJSONParserErrorDomain = @"com.amazonaws.AWSJSONParserErrorDom
     return resultData;
 }
 
-+ (AWSXMLWriter *)xmlBuildForDictionary:(NSDictionary *)params actionName:(NSString *)actionName serviceDefinitionRule:(NSDictionary *)serviceDefinitionRule error:(NSError *__autoreleasing *)error {
++ (AWSXMLByteWriter *)xmlBuildForDictionary:(NSDictionary *)params actionName:(NSString *)actionName serviceDefinitionRule:(NSDictionary *)serviceDefinitionRule error:(NSError *__autoreleasing *)error {
 
     NSDictionary *actionRule = [[[serviceDefinitionRule objectForKey:@"operations"] objectForKey:actionName] objectForKey:@"input"];
     NSDictionary *definitionRules = [serviceDefinitionRule objectForKey:@"shapes"];
@@ -136,7 +136,7 @@ NSString *const AWSJSONParserErrorDomain = @"com.amazonaws.AWSJSONParserErrorDom
     }
 
 
-    AWSXMLWriter* xmlWriter = [[AWSXMLWriter alloc]init];
+    AWSXMLByteWriter *xmlWriter = [AWSXMLByteWriter new];
     AWSJSONDictionary *rules = [[AWSJSONDictionary alloc] initWithDictionary:actionRule JSONDefinitionRule:definitionRules];
 
     NSString *xmlElementName = rules[@"locationName"];
@@ -154,7 +154,7 @@ NSString *const AWSJSONParserErrorDomain = @"com.amazonaws.AWSJSONParserErrorDom
     return xmlWriter;
 }
 
-+ (BOOL)serializeStructure:(NSDictionary *)params rules:(AWSJSONDictionary *)rules xmlWriter:(AWSXMLWriter *)xmlWriter error:(NSError *__autoreleasing *)error isRootRule:(BOOL)isRootRule {
++ (BOOL)serializeStructure:(NSDictionary *)params rules:(AWSJSONDictionary *)rules xmlWriter:(AWSXMLByteWriter *)xmlWriter error:(NSError *__autoreleasing *)error isRootRule:(BOOL)isRootRule {
 
     AWSJSONDictionary *structureMembersRule = rules[@"members"]?rules[@"members"]:@{};
 
@@ -204,7 +204,7 @@ NSString *const AWSJSONParserErrorDomain = @"com.amazonaws.AWSJSONParserErrorDom
     return isValid;
 }
 
-+ (BOOL)serializeList:(NSArray *)list name:(NSString *)name rules:(AWSJSONDictionary *)rules xmlWriter:(AWSXMLWriter *)xmlWriter error:(NSError *__autoreleasing *)error {
++ (BOOL)serializeList:(NSArray *)list name:(NSString *)name rules:(AWSJSONDictionary *)rules xmlWriter:(AWSXMLByteWriter *)xmlWriter error:(NSError *__autoreleasing *)error {
 
     AWSJSONDictionary *memberRules = rules[@"member"]?rules[@"member"]:@{};
     NSString *xmlListName = rules[@"locationName"]?rules[@"locationName"]:name;
@@ -242,7 +242,7 @@ NSString *const AWSJSONParserErrorDomain = @"com.amazonaws.AWSJSONParserErrorDom
     return isValid;
 }
 
-+ (BOOL)serializeMember:(id)params name:(NSString *)memberName rules:(AWSJSONDictionary *)rules isPayloadType:(Boolean)isPayloadType xmlWriter:(AWSXMLWriter *)xmlWriter error:(NSError *__autoreleasing *)error {
++ (BOOL)serializeMember:(id)params name:(NSString *)memberName rules:(AWSJSONDictionary *)rules isPayloadType:(Boolean)isPayloadType xmlWriter:(AWSXMLByteWriter *)xmlWriter error:(NSError *__autoreleasing *)error {
     NSString *xmlElementName = rules[@"locationName"]?rules[@"locationName"]:memberName;
     NSString *rulesType = rules[@"type"];
     if ([rulesType isEqualToString:@"structure"]) {
@@ -306,7 +306,7 @@ NSString *const AWSJSONParserErrorDomain = @"com.amazonaws.AWSJSONParserErrorDom
     return YES;
 }
 
-+ (void)applyNamespacesAndAttributesByRules:(NSDictionary *)rules params:(id)params xmlWriter:(AWSXMLWriter *)xmlWriter {
++ (void)applyNamespacesAndAttributesByRules:(NSDictionary *)rules params:(id)params xmlWriter:(AWSXMLByteWriter *)xmlWriter {
     id xmlNamespaceValue = rules[@"xmlNamespace"];
     if (xmlNamespaceValue) {
         if ([xmlNamespaceValue isKindOfClass:[NSDictionary class]]) {
@@ -539,44 +539,9 @@ NSString *const AWSJSONParserErrorDomain = @"com.amazonaws.AWSJSONParserErrorDom
     return result;
 }
 
-+ (BOOL)validateConstraint:(id)value rules:(NSDictionary *)rules error:(NSError *__autoreleasing *)error {
-
-    //    //validate the existence of  required parameters.
-    //    while ([rules[@"required"] boolValue]) {
-    //        //value is a structure or map
-    //        if ([value isKindOfClass:[NSDictionary class]] && [value count]>0) break;
-    //        //value is a list
-    //        if ([value isKindOfClass:[NSArray class]] && [value count]>0) break;
-    //        //value is a string
-    //        if ([value isKindOfClass:[NSString class]] && [value length] > 0) break;
-    //        //value is NSNumber( e.g long, integer, double, float)
-    //        if ([value isKindOfClass:[NSNumber class]]) break;
-    //
-    //        return [self failWithCode:AWSXMLParserMissingRequiredXMLElements
-    //                      description:[NSString stringWithFormat:@"Missing required key."]
-    //                            error:error];
-    //    }
-    //
-    //    //validate value of string according to enum list
-    //    if (rules[@"enum"] && [value isKindOfClass:[NSString class]]) {
-    //        NSArray *enumArray = rules[@"enum"];
-    //        if (![enumArray containsObject:value]) {
-    //            return [self failWithCode:AWSXMLParserInvalidXMLValue
-    //                          description:[NSString stringWithFormat:@"got unexpected string:%@ not in the enum list:%@", value, [enumArray description]]
-    //                                error:error];
-    //        }
-    //    }
-    return YES;
-}
-
-
 + (NSMutableDictionary *)parseStructure:(NSDictionary *)structure rules:(AWSJSONDictionary *)rules error:(NSError *__autoreleasing *)error {
     NSMutableDictionary *data = [NSMutableDictionary dictionary];
 
-    if (![self validateConstraint:structure rules:rules error:error]) {
-        return data;
-    }
-
     __block NSError *blockErr = nil;
     [structure enumerateKeysAndObjectsUsingBlock:^(NSString *xmlName, id value, BOOL *stop) {
         if ([xmlName isEqualToString:@"$"]) {
@@ -623,8 +588,6 @@ NSString *const AWSJSONParserErrorDomain = @"com.amazonaws.AWSJSONParserErrorDom
 
     __block NSMutableDictionary *data = [NSMutableDictionary dictionary];
 
-    if (![self validateConstraint:map rules:rules error:error]) return data;
-
     NSArray *mapList = nil;
     if ([rules[@"flattened"] boolValue] == NO) {
         //If it is non-flatened map,retrive the array with key 'entry' if it has one
@@ -668,8 +631,6 @@ NSString *const AWSJSONParserErrorDomain = @"com.amazonaws.AWSJSONParserErrorDom
 
     AWSJSONDictionary *memberRules = rules[@"member"]?rules[@"member"]:@{};
     __block NSMutableArray *data = [NSMutableArray array];
-
-    if (![self validateConstraint:list rules:rules error:error]) return data;
     __block NSError *blockErr = nil;
 
     //If not flattened, need to manually flatten it.
@@ -724,9 +685,6 @@ NSString *const AWSJSONParserErrorDomain = @"com.amazonaws.AWSJSONParserErrorDom
         return @"XMLPARSER:ERROR";
     }
 
-    //validate the value
-    if (![self validateConstraint:values rules:rules error:error]) return @"XMLPARSER:ERROR";
-
     if ([rulesType isEqualToString:@"string"] || [rulesType isEqualToString:@"character"]) {
         if ([values isKindOfClass:[NSString class]]) {
             return values;
@@ -16,9 +16,15 @@
 #import <Foundation/Foundation.h>
 #import "AWSTimestampSerialization.h"
 #import "AWSCategory.h"
+#import "AWSTimestampFormat.h"
 
 NSString *const AWSTimestampSerializationErrorDomain = @"com.amazonaws.AWSTimestampSerializationErrorDomain";
 
+static NSString *AWSTimestampEpochSecondsString(NSDate *date) {
+    NSString *timestampStr = date ? AWSTimestampStringFromTimeInterval([date timeIntervalSinceReferenceDate], AWSTimestampFormatEpochSeconds) : nil;
+    return timestampStr ? timestampStr : [NSString stringWithFormat:@"%.lf", [date timeIntervalSince1970]];
+}
+
 @implementation AWSTimestampSerialization
 
 + (BOOL)failWithCode:(NSInteger)code description:(NSString *)description error:(NSError *__autoreleasing *)error {
@@ -38,6 +44,10 @@ NSString *const AWSTimestampSerializationErrorDomain = @"com.amazonaws.AWSTimest
         timeStampDate = [NSDate aws_dateFromString:value];
         
         //if failed, then parse it as double value represented as string
+        NSTimeInterval timeInterval = 0;
+        if (!timeStampDate && AWSTimestampParseString(value, AWSTimestampFormatEpochSeconds, &timeInterval)) {
+            timeStampDate = [NSDate dateWithTimeIntervalSinceReferenceDate:timeInterval];
+        }
         if (!timeStampDate) {
             timeStampDate = [NSDate dateWithTimeIntervalSince1970:[value doubleValue]];
         }
@@ -69,7 +79,7 @@ NSString *const AWSTimestampSerializationErrorDomain = @"com.amazonaws.AWSTimest
             if ([rules[@"timestampFormat"] isEqualToString:@"iso8601"]) {
                 timestampStr = [timeStampDate aws_stringValue:AWSDateISO8601DateFormat1];
             } else if ([rules[@"timestampFormat"] isEqualToString:@"unixTimestamp"]) {
-                timestampStr = [NSString stringWithFormat:@"%.lf",[timeStampDate timeIntervalSince1970]];
+                timestampStr = AWSTimestampEpochSecondsString(timeStampDate);
             } else if ([rules[@"timestampFormat"] isEqualToString:@"rfc822"]) {
                 timestampStr = [timeStampDate aws_stringValue: AWSDateRFC822DateFormat1];
             }
@@ -88,7 +98,7 @@ NSString *const AWSTimestampSerializationErrorDomain = @"com.amazonaws.AWSTimest
     if (!timestampStr.length){
         // valid `timestampFormat` trait is not present, use protocol specific default.
         NSDate *timeStampDate = [self parseTimestamp:value];
-        timestampStr = [NSString stringWithFormat:@"%.lf",[timeStampDate timeIntervalSince1970]];
+        timestampStr = AWSTimestampEpochSecondsString(timeStampDate);
     }
     return timestampStr;
 }
@@ -19,6 +19,7 @@
 #import "AWSNetworking.h"
 #import "AWSValidation.h"
 #import "AWSSerialization.h"
+#import "AWSQueryFormWriter.h"
 #import "AWSCategory.h"
 #import "AWSCocoaLumberjack.h"
 #import "AWSClientContext.h"
@@ -46,6 +47,15 @@
 
 @end
 
+static AWSTask *AWSValidateRequestParameters(NSDictionary *parameters, NSString *actionName, NSDictionary *serviceDefinitionJSON) {
+    AWSRequestValidator *validator = [AWSRequestValidator validatorForServiceDefinition:serviceDefinitionJSON];
+    NSError *error = nil;
+    if (validator && ![validator validateParameters:parameters actionName:actionName error:&error]) {
+        return [AWSTask taskWithError:error];
+    }
+    return [AWSTask taskWithResult:nil];
+}
+
 @interface AWSJSONRequestSerializer()
 
 @property (nonatomic, strong) NSDictionary *serviceDefinitionJSON;
@@ -139,6 +149,10 @@
     return [AWSTask taskWithError:error];
 }
 
+- (AWSTask *)validateParameters:(NSDictionary *)parameters {
+    return AWSValidateRequestParameters(parameters, self.actionName, self.serviceDefinitionJSON);
+}
+
 - (AWSTask *)validateRequest:(NSURLRequest *)request {
     return [AWSTask taskWithResult:nil];
 
@@ -230,6 +244,10 @@
     }
 }
 
+- (AWSTask *)validateParameters:(NSDictionary *)parameters {
+    return AWSValidateRequestParameters(parameters, self.actionName, self.serviceDefinitionJSON);
+}
+
 - (AWSTask *)validateRequest:(NSURLRequest *)request {
     return [AWSTask taskWithResult:nil];
 }
@@ -535,18 +553,17 @@
 
     //Need to add version and actionName
     NSError *error = nil;
-    NSDictionary *formattedParams = [AWSQueryParamBuilder buildFormattedParams:parameters
-                                                                    actionName:self.actionName
-                                                         serviceDefinitionRule:self.serviceDefinitionJSON error:&error];
+    NSData *formData = [AWSQueryFormWriter formDataForDictionary:parameters
+                                                      actionName:self.actionName
+                                           serviceDefinitionRule:self.serviceDefinitionJSON
+                                                        protocol:AWSQueryFormWriterProtocolQuery
+                                                           error:&error];
     if (error) {
         return [AWSTask taskWithError:error];
     }
 
-    NSMutableString *queryString = [NSMutableString new];
-    [self processParameters:formattedParams queryString:queryString];
-
-    if ([queryString length] > 0) {
-        request.HTTPBody = [queryString dataUsingEncoding:NSUTF8StringEncoding];
+    if ([formData length] > 0) {
+        request.HTTPBody = formData;
     }
 
     //contruct additional headers
@@ -567,6 +584,10 @@
     return [AWSTask taskWithResult:nil];
 }
 
+- (AWSTask *)validateParameters:(NSDictionary *)parameters {
+    return AWSValidateRequestParameters(parameters, self.actionName, self.serviceDefinitionJSON);
+}
+
 - (AWSTask *)validateRequest:(NSURLRequest *)request {
     return [AWSTask taskWithResult:nil];
 }
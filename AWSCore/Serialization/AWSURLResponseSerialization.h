@@ -18,7 +18,7 @@
 #import "AWSNetworking.h"
 #import "AWSSerialization.h"
 
-@interface AWSJSONResponseSerializer : NSObject <AWSHTTPURLResponseSerializer>
+@interface AWSJSONResponseSerializer : NSObject <AWSHTTPURLResponseStreamingSerializer>
 
 @property (nonatomic, strong, readonly) NSDictionary *serviceDefinitionJSON;
 @property (nonatomic, strong, readonly) NSString *actionName;
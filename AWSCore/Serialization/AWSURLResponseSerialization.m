@@ -19,6 +19,9 @@
 #import "AWSService.h"
 #import "AWSValidation.h"
 #import "AWSSerialization.h"
+#import "AWSJSONStreamParser.h"
+#import "AWSJSONLazyDictionary.h"
+#import "AWSMantle.h"
 
 #pragma mark - Service errors
 
@@ -50,11 +53,70 @@
     return self;
 }
 
+- (id<AWSHTTPURLResponseStreamParser>)streamParserForResponse:(NSHTTPURLResponse *)response
+                                                      request:(AWSNetworkingRequest *)request {
+    AWSNetworkingResponseListItemBlock listItemHandler = request.responseListItemHandler;
+    if (!listItemHandler && !request.decodesResponseLazily) {
+        return nil;
+    }
+
+    NSString *responseContentTypeStr = [[response allHeaderFields] objectForKey:@"Content-Type"];
+    if ([responseContentTypeStr rangeOfString:@"text/html"].location != NSNotFound) {
+        return nil;
+    }
+
+    if (!listItemHandler) {
+        //keep the body as it is, its members are parsed when they are first read
+        return [AWSJSONLazyResponseParser parserForResponse:response];
+    }
+
+    // Look up the transformers of the list properties of the output model once. Each element is converted on its own
+    // with the transformer of its list, so the handler receives the same object it would find in the list property.
+    Class outputClass = self.outputClass;
+    NSMutableDictionary<NSString *, NSValueTransformer *> *transformersByJSONKeyPath = [NSMutableDictionary new];
+    if ([outputClass conformsToProtocol:@protocol(AWSMTLJSONSerializing)]) {
+        [[outputClass JSONKeyPathsByPropertyKey] enumerateKeysAndObjectsUsingBlock:^(NSString *propertyKey, id JSONKeyPath, BOOL *stop) {
+            if (![JSONKeyPath isKindOfClass:[NSString class]]) {
+                return;
+            }
+            NSValueTransformer *transformer = [AWSMTLJSONAdapter JSONTransformerForModelClass:outputClass key:propertyKey];
+            if (transformer) {
+                transformersByJSONKeyPath[JSONKeyPath] = transformer;
+            }
+        }];
+    }
+
+    return [AWSJSONStreamParser parserForResponse:response
+                                       actionName:self.actionName
+                            serviceDefinitionRule:self.serviceDefinitionJSON
+                                  listItemHandler:^(NSString *memberName, id item) {
+                                      NSValueTransformer *transformer = transformersByJSONKeyPath[memberName];
+                                      if (transformer) {
+                                          id items = nil;
+                                          @try {
+                                              items = [transformer transformedValue:@[item]];
+                                          } @catch (NSException *exception) {
+                                              AWSDDLogError(@"Failed to convert an element of [%@]. [%@]", memberName, exception);
+                                          }
+                                          if ([items isKindOfClass:[NSArray class]] && [items count] == 1) {
+                                              item = [items firstObject];
+                                          }
+                                      }
+                                      listItemHandler(memberName, item);
+                                  }];
+}
+
 - (id)responseObjectForResponse:(NSHTTPURLResponse *)response
                 originalRequest:(NSURLRequest *)originalRequest
                  currentRequest:(NSURLRequest *)currentRequest
                            data:(id)data
                           error:(NSError *__autoreleasing *)error {
+    NSData *lazyBody = nil;
+    if ([data isKindOfClass:[AWSJSONLazyResponseParser class]]) {
+        lazyBody = [(AWSJSONLazyResponseParser *)data data];
+        data = lazyBody;
+    }
+
     if([AWSDDLog sharedInstance].logLevel & AWSDDLogFlagDebug){
         if ([data isKindOfClass:[NSData class]]) {
             if ([data length] <= 100 * 1024) {
@@ -94,7 +156,21 @@
     id result = nil;
 
     //parse JSON data
-    result = [AWSJSONParser dictionaryForJsonData:data response:response actionName:self.actionName serviceDefinitionRule:self.serviceDefinitionJSON error:error];
+    if ([data isKindOfClass:[AWSJSONStreamParser class]]) {
+        //the body has already been parsed while it was received, only the non-list members are left
+        result = [(AWSJSONStreamParser *)data finishWithError:error];
+    } else if (lazyBody) {
+        //fall back to parsing the whole body if it cannot be decoded lazily, e.g. for an error response
+        result = [AWSJSONLazyDictionary dictionaryForJsonData:lazyBody
+                                                     response:response
+                                                   actionName:self.actionName
+                                        serviceDefinitionRule:self.serviceDefinitionJSON];
+        if (!result) {
+            result = [AWSJSONParser dictionaryForJsonData:lazyBody response:response actionName:self.actionName serviceDefinitionRule:self.serviceDefinitionJSON error:error];
+        }
+    } else {
+        result = [AWSJSONParser dictionaryForJsonData:data response:response actionName:self.actionName serviceDefinitionRule:self.serviceDefinitionJSON error:error];
+    }
 
     //Parse AWSServiceError
     if ([result isKindOfClass:[NSDictionary class]]) {
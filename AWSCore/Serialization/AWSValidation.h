@@ -37,3 +37,37 @@ typedef NS_ENUM(NSInteger, AWSValidationErrorType) {
     AWSValidationHeaderAPIActionIsInvalid,
     AWSValidationURIIsInvalid
 };
+
+/**
+ Checks request parameters against the `required`, `min`, `max` and `pattern` constraints of a service definition.
+
+ The constraints of all shapes are compiled once per service definition into tables of validators, with the patterns
+ compiled into `NSRegularExpression`s. Shapes without any constraint, directly or in their members, are left out, so
+ validating a parameter of such a shape costs nothing.
+ */
+@interface AWSRequestValidator : NSObject
+
+/**
+ Returns the validator for a service definition. The validator is compiled on first use and shared by all callers
+ passing the same definition.
+
+ @param serviceDefinition The service definition, e.g. `[[AWSDynamoDBResources sharedInstance] JSONObject]`.
+ */
++ (instancetype)validatorForServiceDefinition:(NSDictionary *)serviceDefinition;
+
+- (instancetype)init NS_UNAVAILABLE;
+
+/**
+ Validates the parameters of an operation, keyed by member name as passed to the request serializers.
+
+ @param parameters The request parameters.
+ @param actionName The operation name.
+ @param error      Set to an error in `AWSValidationErrorDomain` naming the first invalid parameter.
+
+ @return `YES` if the parameters are valid, or if the operation has no input.
+ */
+- (BOOL)validateParameters:(NSDictionary *)parameters
+                actionName:(NSString *)actionName
+                     error:(NSError *__autoreleasing *)error;
+
+@end
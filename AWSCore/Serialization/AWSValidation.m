@@ -14,6 +14,445 @@
 //
 
 #import "AWSValidation.h"
+#import <objc/runtime.h>
 #import "AWSCategory.h"
+#import "AWSCocoaLumberjack.h"
 
 NSString *const AWSValidationErrorDomain = @"com.amazonaws.AWSValidationErrorDomain";
+
+// Used to cache the AWSRequestValidator of a service definition.
+static void *AWSRequestValidatorCachedValidatorKey = &AWSRequestValidatorCachedValidatorKey;
+
+typedef NS_ENUM(NSInteger, AWSValidationShapeType) {
+    AWSValidationShapeTypeOther,
+    AWSValidationShapeTypeStructure,
+    AWSValidationShapeTypeList,
+    AWSValidationShapeTypeMap,
+    AWSValidationShapeTypeString,
+    AWSValidationShapeTypeBlob,
+    AWSValidationShapeTypeNumber,
+};
+
+@class AWSValidationShape;
+
+// A member of a structure which needs to be validated.
+@interface AWSValidationMember : NSObject
+
+@property (nonatomic, strong) NSString *name;
+// Shapes are owned by the validator, which outlives them being used.
+@property (nonatomic, unsafe_unretained) AWSValidationShape *shape;
+
+@end
+
+@implementation AWSValidationMember
+
+@end
+
+// The compiled constraints of a shape. `min` and `max` bound the length of strings and blobs, the number of elements
+// of lists and maps, and the value of numbers.
+@interface AWSValidationShape : NSObject
+
+@property (nonatomic, strong) NSString *name;
+@property (nonatomic, assign) AWSValidationShapeType type;
+@property (nonatomic, assign) BOOL hasMin;
+@property (nonatomic, assign) double min;
+@property (nonatomic, assign) BOOL hasMax;
+@property (nonatomic, assign) double max;
+@property (nonatomic, strong) NSRegularExpression *pattern;
+@property (nonatomic, strong) NSArray<NSString *> *requiredMembers;
+
+// Whether the shape, or any shape it contains, has a constraint.
+@property (nonatomic, assign) BOOL needsValidation;
+
+// The members of a structure which need to be validated.
+@property (nonatomic, strong) NSArray<AWSValidationMember *> *members;
+// The element shape of a list, and the key and value shapes of a map, if they need to be validated.
+@property (nonatomic, unsafe_unretained) AWSValidationShape *elementShape;
+@property (nonatomic, unsafe_unretained) AWSValidationShape *keyShape;
+
+@end
+
+@implementation AWSValidationShape
+
+@end
+
+// The length of a string in code points, which is what the constraints of string shapes refer to. Counting code
+// points is only needed when the number of UTF-16 code units alone cannot decide.
+static NSUInteger AWSValidationStringLength(NSString *string, AWSValidationShape *shape) {
+    NSUInteger length = [string length];
+    BOOL withinMin = !shape.hasMin || length / 2 >= shape.min;
+    BOOL withinMax = !shape.hasMax || length <= shape.max;
+    if (withinMin && withinMax) {
+        return length;
+    }
+    return [string lengthOfBytesUsingEncoding:NSUTF32StringEncoding] / 4;
+}
+
+static NSString *AWSValidationRangeDescription(AWSValidationShape *shape) {
+    return [NSString stringWithFormat:@"[%@, %@]",
+            shape.hasMin ? [@(shape.min) stringValue] : @"-",
+            shape.hasMax ? [@(shape.max) stringValue] : @"-"];
+}
+
+@interface AWSRequestValidator()
+
+// Every compiled shape, keyed by shape name.
+@property (nonatomic, strong) NSDictionary<NSString *, AWSValidationShape *> *shapes;
+// The input shapes of the operations which need to be validated, keyed by operation name.
+@property (nonatomic, strong) NSDictionary<NSString *, AWSValidationShape *> *inputShapes;
+
+@end
+
+@implementation AWSRequestValidator
+
++ (instancetype)validatorForServiceDefinition:(NSDictionary *)serviceDefinition {
+    if (![serviceDefinition isKindOfClass:[NSDictionary class]]) {
+        return nil;
+    }
+
+    AWSRequestValidator *validator = objc_getAssociatedObject(serviceDefinition, AWSRequestValidatorCachedValidatorKey);
+    if (validator) {
+        return validator;
+    }
+
+    @synchronized(serviceDefinition) {
+        validator = objc_getAssociatedObject(serviceDefinition, AWSRequestValidatorCachedValidatorKey);
+        if (!validator) {
+            validator = [[self alloc] initWithServiceDefinition:serviceDefinition];
+            objc_setAssociatedObject(serviceDefinition, AWSRequestValidatorCachedValidatorKey, validator, OBJC_ASSOCIATION_RETAIN);
+        }
+    }
+
+    return validator;
+}
+
+- (instancetype)initWithServiceDefinition:(NSDictionary *)serviceDefinition {
+    if (self = [super init]) {
+        NSDictionary *shapeRules = serviceDefinition[@"shapes"];
+        if (![shapeRules isKindOfClass:[NSDictionary class]]) {
+            shapeRules = @{};
+        }
+
+        // Create all shapes first, so members can refer to shapes which are compiled later, or to their own shape.
+        NSMutableDictionary *shapes = [NSMutableDictionary dictionaryWithCapacity:[shapeRules count]];
+        for (NSString *shapeName in shapeRules) {
+            AWSValidationShape *shape = [AWSValidationShape new];
+            shape.name = shapeName;
+            shapes[shapeName] = shape;
+        }
+        for (NSString *shapeName in shapeRules) {
+            [self compileShape:shapes[shapeName] rules:shapeRules[shapeName] shapes:shapes];
+        }
+
+        // A shape needs validation if any shape it contains does, which for recursive shapes is only known once
+        // nothing changes anymore.
+        BOOL changed = YES;
+        while (changed) {
+            changed = NO;
+            for (AWSValidationShape *shape in [shapes objectEnumerator]) {
+                if (!shape.needsValidation
+                    && [self containsShapeNeedingValidation:shape rules:shapeRules[shape.name] shapes:shapes]) {
+                    shape.needsValidation = YES;
+                    changed = YES;
+                }
+            }
+        }
+
+        // Link the shapes, leaving out everything which does not need validation.
+        for (NSString *shapeName in shapeRules) {
+            AWSValidationShape *shape = shapes[shapeName];
+            if (shape.needsValidation) {
+                [self linkShape:shape rules:shapeRules[shapeName] shapes:shapes];
+            }
+        }
+
+        NSMutableDictionary *inputShapes = [NSMutableDictionary new];
+        NSDictionary *operations = serviceDefinition[@"operations"];
+        if ([operations isKindOfClass:[NSDictionary class]]) {
+            for (NSString *operationName in operations) {
+                NSDictionary *input = operations[operationName][@"input"];
+                AWSValidationShape *shape = [input isKindOfClass:[NSDictionary class]] ? shapes[input[@"shape"]] : nil;
+                if (shape.needsValidation) {
+                    inputShapes[operationName] = shape;
+                }
+            }
+        }
+
+        _shapes = shapes;
+        _inputShapes = inputShapes;
+    }
+
+    return self;
+}
+
+- (void)compileShape:(AWSValidationShape *)shape rules:(NSDictionary *)rules shapes:(NSDictionary *)shapes {
+    if (![rules isKindOfClass:[NSDictionary class]]) {
+        return;
+    }
+
+    NSString *type = rules[@"type"];
+    if ([type isEqualToString:@"structure"]) {
+        shape.type = AWSValidationShapeTypeStructure;
+    } else if ([type isEqualToString:@"list"]) {
+        shape.type = AWSValidationShapeTypeList;
+    } else if ([type isEqualToString:@"map"]) {
+        shape.type = AWSValidationShapeTypeMap;
+    } else if ([type isEqualToString:@"string"]) {
+        shape.type = AWSValidationShapeTypeString;
+    } else if ([type isEqualToString:@"blob"]) {
+        shape.type = AWSValidationShapeTypeBlob;
+    } else if ([type isEqualToString:@"integer"]
+               || [type isEqualToString:@"long"]
+               || [type isEqualToString:@"float"]
+               || [type isEqualToString:@"double"]) {
+        shape.type = AWSValidationShapeTypeNumber;
+    } else {
+        return;
+    }
+
+    if ([rules[@"min"] isKindOfClass:[NSNumber class]]) {
+        shape.hasMin = YES;
+        shape.min = [rules[@"min"] doubleValue];
+    }
+    if ([rules[@"max"] isKindOfClass:[NSNumber class]]) {
+        shape.hasMax = YES;
+        shape.max = [rules[@"max"] doubleValue];
+    }
+
+    NSString *pattern = rules[@"pattern"];
+    if (shape.type == AWSValidationShapeTypeString && [pattern isKindOfClass:[NSString class]]) {
+        NSError *error = nil;
+        shape.pattern = [NSRegularExpression regularExpressionWithPattern:pattern options:0 error:&error];
+        if (!shape.pattern) {
+            // Left to the service to check.
+            AWSDDLogWarn(@"Ignoring the pattern of %@, which cannot be compiled: %@", shape.name, error);
+        }
+    }
+
+    NSArray *required = rules[@"required"];
+    if (shape.type == AWSValidationShapeTypeStructure && [required isKindOfClass:[NSArray class]] && [required count] > 0) {
+        shape.requiredMembers = required;
+    }
+
+    shape.needsValidation = shape.hasMin || shape.hasMax || shape.pattern != nil || shape.requiredMembers != nil;
+}
+
+// Returns whether any member, element, key or value shape of `shape` needs validation.
+- (BOOL)containsShapeNeedingValidation:(AWSValidationShape *)shape
+                                 rules:(NSDictionary *)rules
+                                shapes:(NSDictionary *)shapes {
+    NSMutableArray *childRules = [NSMutableArray new];
+    switch (shape.type) {
+        case AWSValidationShapeTypeStructure: {
+            NSDictionary *members = rules[@"members"];
+            if ([members isKindOfClass:[NSDictionary class]]) {
+                [childRules addObjectsFromArray:[members allValues]];
+            }
+            break;
+        }
+        case AWSValidationShapeTypeList:
+            if (rules[@"member"]) [childRules addObject:rules[@"member"]];
+            break;
+        case AWSValidationShapeTypeMap:
+            if (rules[@"key"]) [childRules addObject:rules[@"key"]];
+            if (rules[@"value"]) [childRules addObject:rules[@"value"]];
+            break;
+        default:
+            break;
+    }
+
+    for (NSDictionary *childRule in childRules) {
+        AWSValidationShape *childShape = [childRule isKindOfClass:[NSDictionary class]] ? shapes[childRule[@"shape"]] : nil;
+        if (childShape.needsValidation) {
+            return YES;
+        }
+    }
+    return NO;
+}
+
+- (void)linkShape:(AWSValidationShape *)shape rules:(NSDictionary *)rules shapes:(NSDictionary *)shapes {
+    switch (shape.type) {
+        case AWSValidationShapeTypeStructure: {
+            NSMutableArray *members = [NSMutableArray new];
+            NSDictionary *memberRules = rules[@"members"];
+            if ([memberRules isKindOfClass:[NSDictionary class]]) {
+                for (NSString *memberName in memberRules) {
+                    NSDictionary *memberRule = memberRules[memberName];
+                    AWSValidationShape *memberShape = [memberRule isKindOfClass:[NSDictionary class]] ? shapes[memberRule[@"shape"]] : nil;
+                    if (memberShape.needsValidation) {
+                        AWSValidationMember *member = [AWSValidationMember new];
+                        member.name = memberName;
+                        member.shape = memberShape;
+                        [members addObject:member];
+                    }
+                }
+            }
+            shape.members = members;
+            break;
+        }
+        case AWSValidationShapeTypeList: {
+            AWSValidationShape *elementShape = shapes[rules[@"member"][@"shape"]];
+            shape.elementShape = elementShape.needsValidation ? elementShape : nil;
+            break;
+        }
+        case AWSValidationShapeTypeMap: {
+            AWSValidationShape *keyShape = shapes[rules[@"key"][@"shape"]];
+            AWSValidationShape *valueShape = shapes[rules[@"value"][@"shape"]];
+            shape.keyShape = keyShape.needsValidation ? keyShape : nil;
+            shape.elementShape = valueShape.needsValidation ? valueShape : nil;
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+- (BOOL)validateParameters:(NSDictionary *)parameters
+                actionName:(NSString *)actionName
+                     error:(NSError *__autoreleasing *)error {
+    AWSValidationShape *inputShape = self.inputShapes[actionName];
+    if (!inputShape) {
+        return YES;
+    }
+
+    NSMutableArray *path = [NSMutableArray new];
+    NSInteger code = AWSValidationUnknownError;
+    NSString *reason = nil;
+    if ([self validateValue:parameters ?: @{} shape:inputShape path:path code:&code reason:&reason]) {
+        return YES;
+    }
+
+    if (error) {
+        NSString *parameterName = [[[path reverseObjectEnumerator] allObjects] componentsJoinedByString:@""];
+        if ([parameterName hasPrefix:@"."]) {
+            parameterName = [parameterName substringFromIndex:1];
+        }
+        *error = [NSError errorWithDomain:AWSValidationErrorDomain
+                                     code:code
+                                 userInfo:@{NSLocalizedDescriptionKey : [NSString stringWithFormat:@"Invalid parameter '%@' of %@: %@", parameterName, actionName, reason]}];
+    }
+    return NO;
+}
+
+// On failure, `path` is filled with the path of the invalid value, from the inside out.
+- (BOOL)validateValue:(id)value
+                shape:(AWSValidationShape *)shape
+                 path:(NSMutableArray *)path
+                 code:(NSInteger *)code
+               reason:(NSString **)reason {
+    switch (shape.type) {
+        case AWSValidationShapeTypeStructure: {
+            if (![value isKindOfClass:[NSDictionary class]]) {
+                return YES;
+            }
+            for (NSString *memberName in shape.requiredMembers) {
+                id memberValue = value[memberName];
+                if (!memberValue || memberValue == [NSNull null]) {
+                    [path addObject:[@"." stringByAppendingString:memberName]];
+                    *code = AWSValidationMissingRequiredParameter;
+                    *reason = @"missing required parameter";
+                    return NO;
+                }
+            }
+            for (AWSValidationMember *member in shape.members) {
+                id memberValue = value[member.name];
+                if (memberValue && ![self validateValue:memberValue shape:member.shape path:path code:code reason:reason]) {
+                    [path addObject:[@"." stringByAppendingString:member.name]];
+                    return NO;
+                }
+            }
+            return YES;
+        }
+        case AWSValidationShapeTypeList: {
+            if (![value isKindOfClass:[NSArray class]]) {
+                return YES;
+            }
+            if (![self validateLength:[value count] shape:shape code:code reason:reason]) {
+                return NO;
+            }
+            AWSValidationShape *elementShape = shape.elementShape;
+            if (elementShape) {
+                NSUInteger index = 0;
+                for (id element in value) {
+                    if (![self validateValue:element shape:elementShape path:path code:code reason:reason]) {
+                        [path addObject:[NSString stringWithFormat:@"[%lu]", (unsigned long)index]];
+                        return NO;
+                    }
+                    index++;
+                }
+            }
+            return YES;
+        }
+        case AWSValidationShapeTypeMap: {
+            if (![value isKindOfClass:[NSDictionary class]]) {
+                return YES;
+            }
+            if (![self validateLength:[value count] shape:shape code:code reason:reason]) {
+                return NO;
+            }
+            AWSValidationShape *keyShape = shape.keyShape;
+            AWSValidationShape *valueShape = shape.elementShape;
+            if (keyShape || valueShape) {
+                for (id key in value) {
+                    if ((keyShape && ![self validateValue:key shape:keyShape path:path code:code reason:reason])
+                        || (valueShape && ![self validateValue:value[key] shape:valueShape path:path code:code reason:reason])) {
+                        [path addObject:[NSString stringWithFormat:@"[%@]", key]];
+                        return NO;
+                    }
+                }
+            }
+            return YES;
+        }
+        case AWSValidationShapeTypeString: {
+            if (![value isKindOfClass:[NSString class]]) {
+                return YES;
+            }
+            if ((shape.hasMin || shape.hasMax)
+                && ![self validateLength:AWSValidationStringLength(value, shape) shape:shape code:code reason:reason]) {
+                *code = AWSValidationInvalidStringParameter;
+                return NO;
+            }
+            NSRegularExpression *pattern = shape.pattern;
+            if (pattern && [pattern rangeOfFirstMatchInString:value options:0 range:NSMakeRange(0, [value length])].location == NSNotFound) {
+                *code = AWSValidationInvalidStringParameter;
+                *reason = [NSString stringWithFormat:@"does not match the pattern %@", pattern.pattern];
+                return NO;
+            }
+            return YES;
+        }
+        case AWSValidationShapeTypeBlob: {
+            if (![value isKindOfClass:[NSData class]]) {
+                return YES;
+            }
+            return [self validateLength:[value length] shape:shape code:code reason:reason];
+        }
+        case AWSValidationShapeTypeNumber: {
+            if (![value isKindOfClass:[NSNumber class]]) {
+                return YES;
+            }
+            double number = [value doubleValue];
+            if ((shape.hasMin && number < shape.min) || (shape.hasMax && number > shape.max)) {
+                *code = AWSValidationOutOfRangeParameter;
+                *reason = [NSString stringWithFormat:@"%@ is out of the range %@", value, AWSValidationRangeDescription(shape)];
+                return NO;
+            }
+            return YES;
+        }
+        default:
+            return YES;
+    }
+}
+
+- (BOOL)validateLength:(NSUInteger)length
+                 shape:(AWSValidationShape *)shape
+                  code:(NSInteger *)code
+                reason:(NSString **)reason {
+    if ((shape.hasMin && length < shape.min) || (shape.hasMax && length > shape.max)) {
+        *code = AWSValidationOutOfRangeParameter;
+        *reason = [NSString stringWithFormat:@"length %lu is out of the range %@", (unsigned long)length, AWSValidationRangeDescription(shape)];
+        return NO;
+    }
+    return YES;
+}
+
+@end
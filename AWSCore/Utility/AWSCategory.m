@@ -19,6 +19,7 @@
 #import "AWSCocoaLumberjack.h"
 #import "AWSGZIP.h"
 #import "AWSMantle.h"
+#import "AWSTimestampFormat.h"
 
 NSString *const AWSDateRFC822DateFormat1 = @"EEE, dd MMM yyyy HH:mm:ss z";
 NSString *const AWSDateISO8601DateFormat1 = @"yyyy-MM-dd'T'HH:mm:ss'Z'";
@@ -55,6 +56,30 @@ static NSTimeInterval _clockskew = 0.0;
 }
 
 + (NSDate *)aws_dateFromString:(NSString *)string {
+    static const AWSTimestampFormat timestampFormats[] = {AWSTimestampFormatRFC822,
+                                                          AWSTimestampFormatISO8601,
+                                                          AWSTimestampFormatISO8601Basic,
+                                                          AWSTimestampFormatISO8601Milliseconds};
+
+    const char *bytes = CFStringGetCStringPtr((__bridge CFStringRef)string, kCFStringEncodingASCII);
+    char buffer[64];
+    if (!bytes && [string getCString:buffer maxLength:sizeof(buffer) encoding:NSASCIIStringEncoding]) {
+        bytes = buffer;
+    }
+    if (bytes) {
+        size_t length = strlen(bytes);
+        NSTimeInterval timeInterval = 0;
+        for (size_t i = 0; i < sizeof(timestampFormats) / sizeof(timestampFormats[0]); i++) {
+            if (AWSTimestampParse(bytes, length, timestampFormats[i], &timeInterval)) {
+                return [NSDate dateWithTimeIntervalSinceReferenceDate:timeInterval];
+            }
+        }
+        // A number of seconds can not match any of the date formats.
+        if (AWSTimestampParse(bytes, length, AWSTimestampFormatEpochSeconds, &timeInterval)) {
+            return nil;
+        }
+    }
+
     NSDate *parsedDate = nil;
     NSArray *arrayOfDateFormat = @[AWSDateRFC822DateFormat1,
                                    AWSDateISO8601DateFormat1,
@@ -63,7 +88,7 @@ static NSTimeInterval _clockskew = 0.0;
 
     for (NSString *dateFormat in arrayOfDateFormat) {
         if (!parsedDate) {
-            parsedDate = [NSDate aws_dateFromString:string format:dateFormat];
+            parsedDate = [[NSDate aws_dateFormatterWithFormat:dateFormat] dateFromString:string];
         } else {
             break;
         }
@@ -73,143 +98,52 @@ static NSTimeInterval _clockskew = 0.0;
 }
 
 + (NSDate *)aws_dateFromString:(NSString *)string format:(NSString *)dateFormat {
-    if ([dateFormat isEqualToString:AWSDateRFC822DateFormat1]) {
-        return [[NSDate aws_RFC822Date1Formatter] dateFromString:string];
-    }
-    if ([dateFormat isEqualToString:AWSDateISO8601DateFormat1]) {
-        return [[NSDate aws_ISO8601Date1Formatter] dateFromString:string];
-    }
-    if ([dateFormat isEqualToString:AWSDateISO8601DateFormat2]) {
-        return [[NSDate aws_ISO8601Date2Formatter] dateFromString:string];
+    AWSTimestampFormat timestampFormat;
+    NSTimeInterval timeInterval = 0;
+    if (AWSTimestampFormatForDateFormat(dateFormat, &timestampFormat)
+        && AWSTimestampParseString(string, timestampFormat, &timeInterval)) {
+        return [NSDate dateWithTimeIntervalSinceReferenceDate:timeInterval];
     }
-    if ([dateFormat isEqualToString:AWSDateISO8601DateFormat3]) {
-        return [[NSDate aws_ISO8601Date3Formatter] dateFromString:string];
-    }
-    if ([dateFormat isEqualToString:AWSDateShortDateFormat1]) {
-        return [[NSDate aws_ShortDateFormat1Formatter] dateFromString:string];
-    }
-    if ([dateFormat isEqualToString:AWSDateShortDateFormat2]) {
-        return [[NSDate aws_ShortDateFormat2Formatter] dateFromString:string];
-    }
-
-    NSDateFormatter *dateFormatter = [NSDateFormatter new];
-    dateFormatter.timeZone = [NSTimeZone timeZoneWithName:@"GMT"];
-    dateFormatter.locale = [NSLocale localeWithLocaleIdentifier:@"en_US_POSIX"];
-    dateFormatter.dateFormat = dateFormat;
 
-    return [dateFormatter dateFromString:string];
+    return [[NSDate aws_dateFormatterWithFormat:dateFormat] dateFromString:string];
 }
 
 - (NSString *)aws_stringValue:(NSString *)dateFormat {
-    if ([dateFormat isEqualToString:AWSDateRFC822DateFormat1]) {
-        return [[NSDate aws_RFC822Date1Formatter] stringFromDate:self];
-    }
-    if ([dateFormat isEqualToString:AWSDateISO8601DateFormat1]) {
-        return [[NSDate aws_ISO8601Date1Formatter] stringFromDate:self];
-    }
-    if ([dateFormat isEqualToString:AWSDateISO8601DateFormat2]) {
-        return [[NSDate aws_ISO8601Date2Formatter] stringFromDate:self];
-    }
-    if ([dateFormat isEqualToString:AWSDateISO8601DateFormat3]) {
-        return [[NSDate aws_ISO8601Date3Formatter] stringFromDate:self];
-    }
-    if ([dateFormat isEqualToString:AWSDateShortDateFormat1]) {
-        return [[NSDate aws_ShortDateFormat1Formatter] stringFromDate:self];
-    }
-    if ([dateFormat isEqualToString:AWSDateShortDateFormat2]) {
-        return [[NSDate aws_ShortDateFormat2Formatter] stringFromDate:self];
+    AWSTimestampFormat timestampFormat;
+    if (AWSTimestampFormatForDateFormat(dateFormat, &timestampFormat)) {
+        NSString *string = AWSTimestampStringFromTimeInterval([self timeIntervalSinceReferenceDate], timestampFormat);
+        if (string) {
+            return string;
+        }
     }
 
-    NSDateFormatter *dateFormatter = [NSDateFormatter new];
-    dateFormatter.timeZone = [NSTimeZone timeZoneWithName:@"GMT"];
-    dateFormatter.locale = [NSLocale localeWithLocaleIdentifier:@"en_US_POSIX"];
-    dateFormatter.dateFormat = dateFormat;
-
-    return [dateFormatter stringFromDate:self];
-}
-
-+ (NSDateFormatter *)aws_RFC822Date1Formatter {
-    static NSDateFormatter *_dateFormatter = nil;
-
-    static dispatch_once_t onceToken;
-    dispatch_once(&onceToken, ^{
-        _dateFormatter = [NSDateFormatter new];
-        _dateFormatter.timeZone = [NSTimeZone timeZoneWithName:@"GMT"];
-        _dateFormatter.locale = [NSLocale localeWithLocaleIdentifier:@"en_US_POSIX"];
-        _dateFormatter.dateFormat = AWSDateRFC822DateFormat1;
-    });
-
-    return _dateFormatter;
-}
-
-+ (NSDateFormatter *)aws_ISO8601Date1Formatter {
-    static NSDateFormatter *_dateFormatter = nil;
-
-    static dispatch_once_t onceToken;
-    dispatch_once(&onceToken, ^{
-        _dateFormatter = [NSDateFormatter new];
-        _dateFormatter.timeZone = [NSTimeZone timeZoneWithName:@"GMT"];
-        _dateFormatter.locale = [NSLocale localeWithLocaleIdentifier:@"en_US_POSIX"];
-        _dateFormatter.dateFormat = AWSDateISO8601DateFormat1;
-    });
-
-    return _dateFormatter;
-}
-
-+ (NSDateFormatter *)aws_ISO8601Date2Formatter {
-    static NSDateFormatter *_dateFormatter = nil;
-
-    static dispatch_once_t onceToken;
-    dispatch_once(&onceToken, ^{
-        _dateFormatter = [NSDateFormatter new];
-        _dateFormatter.timeZone = [NSTimeZone timeZoneWithName:@"GMT"];
-        _dateFormatter.locale = [NSLocale localeWithLocaleIdentifier:@"en_US_POSIX"];
-        _dateFormatter.dateFormat = AWSDateISO8601DateFormat2;
-    });
-
-    return _dateFormatter;
-}
-
-+ (NSDateFormatter *)aws_ISO8601Date3Formatter {
-    static NSDateFormatter *_dateFormatter = nil;
-
-    static dispatch_once_t onceToken;
-    dispatch_once(&onceToken, ^{
-        _dateFormatter = [NSDateFormatter new];
-        _dateFormatter.timeZone = [NSTimeZone timeZoneWithName:@"GMT"];
-        _dateFormatter.locale = [NSLocale localeWithLocaleIdentifier:@"en_US_POSIX"];
-        _dateFormatter.dateFormat = AWSDateISO8601DateFormat3;
-    });
-
-    return _dateFormatter;
+    return [[NSDate aws_dateFormatterWithFormat:dateFormat] stringFromDate:self];
 }
 
-+ (NSDateFormatter *)aws_ShortDateFormat1Formatter {
-    static NSDateFormatter *_dateFormatter = nil;
-
-    static dispatch_once_t onceToken;
-    dispatch_once(&onceToken, ^{
-        _dateFormatter = [NSDateFormatter new];
-        _dateFormatter.timeZone = [NSTimeZone timeZoneWithName:@"GMT"];
-        _dateFormatter.locale = [NSLocale localeWithLocaleIdentifier:@"en_US_POSIX"];
-        _dateFormatter.dateFormat = AWSDateShortDateFormat1;
-    });
-
-    return _dateFormatter;
-}
-
-+ (NSDateFormatter *)aws_ShortDateFormat2Formatter {
-    static NSDateFormatter *_dateFormatter = nil;
-
-    static dispatch_once_t onceToken;
-    dispatch_once(&onceToken, ^{
-        _dateFormatter = [NSDateFormatter new];
-        _dateFormatter.timeZone = [NSTimeZone timeZoneWithName:@"GMT"];
-        _dateFormatter.locale = [NSLocale localeWithLocaleIdentifier:@"en_US_POSIX"];
-        _dateFormatter.dateFormat = AWSDateShortDateFormat2;
-    });
+// Dates which are not handled by AWSTimestampFormat are left to NSDateFormatter. The formatters are cached per
+// thread, so that they are never used concurrently.
++ (NSDateFormatter *)aws_dateFormatterWithFormat:(NSString *)dateFormat {
+    static NSString *const AWSDateFormattersKey = @"com.amazonaws.AWSCategory.AWSDateFormatters";
+
+    NSMutableDictionary *threadDictionary = [[NSThread currentThread] threadDictionary];
+    NSMutableDictionary<NSString *, NSDateFormatter *> *dateFormatters = threadDictionary[AWSDateFormattersKey];
+    if (!dateFormatters) {
+        dateFormatters = [NSMutableDictionary new];
+        threadDictionary[AWSDateFormattersKey] = dateFormatters;
+    }
+
+    NSDateFormatter *dateFormatter = dateFormatters[dateFormat];
+    if (!dateFormatter) {
+        dateFormatter = [NSDateFormatter new];
+        dateFormatter.timeZone = [NSTimeZone timeZoneWithName:@"GMT"];
+        dateFormatter.locale = [NSLocale localeWithLocaleIdentifier:@"en_US_POSIX"];
+        dateFormatter.dateFormat = dateFormat;
+        if (dateFormat) {
+            dateFormatters[[dateFormat copy]] = dateFormatter;
+        }
+    }
 
-    return _dateFormatter;
+    return dateFormatter;
 }
 
 + (void)aws_setRuntimeClockSkew:(NSTimeInterval)clockskew {
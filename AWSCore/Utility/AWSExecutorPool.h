@@ -0,0 +1,91 @@
+//
+// Copyright 2010-2021 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License.
+// A copy of the License is located at
+//
+// http://aws.amazon.com/apache2.0
+//
+// or in the "license" file accompanying this file. This file is distributed
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+//
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+@class AWSExecutor;
+
+/**
+ The quality of service classes of an `AWSExecutorPool`. Each class has its own workers, which run at the
+ corresponding `NSQualityOfService`.
+ */
+typedef NS_ENUM(NSInteger, AWSExecutorQualityOfService) {
+    /** For work the user is waiting for, e.g. the continuations of a request started from the UI. */
+    AWSExecutorQualityOfServiceUserInteractive,
+    /** For work started by the user, whose result is needed soon. */
+    AWSExecutorQualityOfServiceUserInitiated,
+    /** For bulk work nobody is waiting for, e.g. submitting the records saved by a recorder. */
+    AWSExecutorQualityOfServiceBackground,
+};
+
+/**
+ A pool of worker threads for running task continuations, with a bounded number of workers per quality of service.
+
+ Each worker has a deque of blocks. A block executed from a worker of the same quality of service is pushed onto
+ the worker's own deque, and run by that worker in last-in, first-out order; other blocks are queued for all of
+ the workers. A worker which runs out of blocks steals the oldest block from the deque of another worker.
+
+ Workers are started on demand up to the maximum concurrency of their quality of service, and are not stopped.
+ Blocks run on the pool should not wait for other blocks run on the same quality of service, as every worker may
+ be busy waiting.
+ */
+@interface AWSExecutorPool : NSObject
+
+/**
+ Returns the shared pool. It runs up to `activeProcessorCount` user interactive and user initiated blocks, and
+ up to 2 background blocks at a time.
+ */
++ (instancetype)defaultPool;
+
+/**
+ Returns a pool with the default maximum concurrency.
+ */
+- (instancetype)init;
+
+/**
+ Returns a pool which runs at most the given number of blocks at a time for each quality of service. A maximum
+ concurrency of 0 is raised to 1.
+ */
+- (instancetype)initWithMaximumUserInteractiveConcurrency:(NSUInteger)userInteractiveConcurrency
+                          maximumUserInitiatedConcurrency:(NSUInteger)userInitiatedConcurrency
+                             maximumBackgroundConcurrency:(NSUInteger)backgroundConcurrency NS_DESIGNATED_INITIALIZER;
+
+/**
+ The maximum number of blocks run at a time for the given quality of service.
+ */
+- (NSUInteger)maximumConcurrencyForQualityOfService:(AWSExecutorQualityOfService)qualityOfService;
+
+/**
+ Runs the block on a worker of the given quality of service.
+ */
+- (void)execute:(dispatch_block_t)block qualityOfService:(AWSExecutorQualityOfService)qualityOfService;
+
+/**
+ Returns an executor which runs continuations on the workers of the given quality of service. The executor is
+ created once per quality of service.
+ */
+- (AWSExecutor *)executorWithQualityOfService:(AWSExecutorQualityOfService)qualityOfService;
+
+/**
+ Returns a new executor which runs continuations one at a time, in the order they are executed, on the workers of
+ the given quality of service. It can replace a serial dispatch queue without dedicating a thread to it.
+ */
+- (AWSExecutor *)serialExecutorWithQualityOfService:(AWSExecutorQualityOfService)qualityOfService;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,421 @@
+//
+// Copyright 2010-2021 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License.
+// A copy of the License is located at
+//
+// http://aws.amazon.com/apache2.0
+//
+// or in the "license" file accompanying this file. This file is distributed
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+//
+
+#import "AWSExecutorPool.h"
+#import <pthread.h>
+#import <stdatomic.h>
+#import "AWSBolts.h"
+
+static const NSUInteger AWSExecutorPoolDefaultBackgroundConcurrency = 2;
+static const NSUInteger AWSExecutorPoolInitialDequeCapacity = 64;
+static const NSUInteger AWSExecutorPoolSerialBatchSize = 16;
+
+// The worker running on the current thread, if any.
+static pthread_key_t AWSExecutorPoolCurrentWorkerKey;
+
+static NSQualityOfService AWSNSQualityOfService(AWSExecutorQualityOfService qualityOfService) {
+    switch (qualityOfService) {
+        case AWSExecutorQualityOfServiceUserInteractive:
+            return NSQualityOfServiceUserInteractive;
+        case AWSExecutorQualityOfServiceUserInitiated:
+            return NSQualityOfServiceUserInitiated;
+        case AWSExecutorQualityOfServiceBackground:
+            return NSQualityOfServiceBackground;
+    }
+    return NSQualityOfServiceDefault;
+}
+
+#pragma mark - AWSExecutorPoolDeque
+
+// A double-ended queue of blocks. The owner pushes and pops at the bottom, and
+// other workers steal from the top. The lock is only contended while stealing.
+@interface AWSExecutorPoolDeque : NSObject
+
+- (void)pushBottom:(dispatch_block_t)block;
+- (dispatch_block_t)popBottom;
+- (dispatch_block_t)popTop;
+
+@end
+
+@implementation AWSExecutorPoolDeque {
+    pthread_mutex_t _lock;
+    void **_buffer;
+    NSUInteger _capacity;
+    NSUInteger _top;
+    NSUInteger _count;
+}
+
+- (instancetype)init {
+    if (self = [super init]) {
+        pthread_mutex_init(&_lock, NULL);
+        _capacity = AWSExecutorPoolInitialDequeCapacity;
+        _buffer = malloc(sizeof(void *) * _capacity);
+    }
+    return self;
+}
+
+- (void)dealloc {
+    while (_count > 0) {
+        CFRelease(_buffer[_top]);
+        _top = (_top + 1) % _capacity;
+        _count--;
+    }
+    free(_buffer);
+    pthread_mutex_destroy(&_lock);
+}
+
+- (void)pushBottom:(dispatch_block_t)block {
+    void *element = (__bridge_retained void *)[block copy];
+    pthread_mutex_lock(&_lock);
+    if (_count == _capacity) {
+        void **buffer = malloc(sizeof(void *) * _capacity * 2);
+        for (NSUInteger i = 0; i < _count; i++) {
+            buffer[i] = _buffer[(_top + i) % _capacity];
+        }
+        free(_buffer);
+        _buffer = buffer;
+        _top = 0;
+        _capacity *= 2;
+    }
+    _buffer[(_top + _count) % _capacity] = element;
+    _count++;
+    pthread_mutex_unlock(&_lock);
+}
+
+- (dispatch_block_t)popBottom {
+    void *element = NULL;
+    pthread_mutex_lock(&_lock);
+    if (_count > 0) {
+        _count--;
+        element = _buffer[(_top + _count) % _capacity];
+    }
+    pthread_mutex_unlock(&_lock);
+    return element ? (__bridge_transfer dispatch_block_t)element : nil;
+}
+
+- (dispatch_block_t)popTop {
+    void *element = NULL;
+    pthread_mutex_lock(&_lock);
+    if (_count > 0) {
+        element = _buffer[_top];
+        _top = (_top + 1) % _capacity;
+        _count--;
+    }
+    pthread_mutex_unlock(&_lock);
+    return element ? (__bridge_transfer dispatch_block_t)element : nil;
+}
+
+@end
+
+#pragma mark - AWSExecutorPoolGroup
+
+@class AWSExecutorPoolGroup;
+
+@interface AWSExecutorPoolWorker : NSObject
+
+@property (nonatomic, strong, readonly) AWSExecutorPoolGroup *group;
+@property (nonatomic, strong, readonly) AWSExecutorPoolDeque *deque;
+@property (nonatomic, assign, readonly) NSUInteger index;
+
+@end
+
+// The workers of one quality of service.
+@interface AWSExecutorPoolGroup : NSObject
+
+@property (nonatomic, assign, readonly) AWSExecutorQualityOfService qualityOfService;
+@property (nonatomic, assign, readonly) NSUInteger maximumConcurrency;
+@property (nonatomic, strong, readonly) AWSExecutor *executor;
+
+- (instancetype)initWithQualityOfService:(AWSExecutorQualityOfService)qualityOfService
+                      maximumConcurrency:(NSUInteger)maximumConcurrency;
+- (void)execute:(dispatch_block_t)block;
+- (void)runWorker:(AWSExecutorPoolWorker *)worker;
+
+@end
+
+@implementation AWSExecutorPoolWorker
+
+- (instancetype)initWithGroup:(AWSExecutorPoolGroup *)group index:(NSUInteger)index {
+    if (self = [super init]) {
+        _group = group;
+        _deque = [AWSExecutorPoolDeque new];
+        _index = index;
+    }
+    return self;
+}
+
+- (void)main {
+    pthread_setspecific(AWSExecutorPoolCurrentWorkerKey, (__bridge void *)self);
+    [self.group runWorker:self];
+}
+
+@end
+
+@implementation AWSExecutorPoolGroup {
+    // Blocks executed from outside of the workers of the group.
+    AWSExecutorPoolDeque *_injectionQueue;
+    // The workers retain their group and are never stopped, so a group lives as
+    // long as the process once it has started a worker. `_workerSlots` is read
+    // without the lock.
+    NSMutableArray<AWSExecutorPoolWorker *> *_workers;
+    void **_workerSlots;
+    _Atomic(NSUInteger) _workerCount;
+    _Atomic(NSUInteger) _pendingCount;
+    _Atomic(NSUInteger) _sleepingCount;
+    pthread_mutex_t _lock;
+    pthread_cond_t _condition;
+}
+
+- (instancetype)initWithQualityOfService:(AWSExecutorQualityOfService)qualityOfService
+                      maximumConcurrency:(NSUInteger)maximumConcurrency {
+    if (self = [super init]) {
+        _qualityOfService = qualityOfService;
+        _maximumConcurrency = MAX(maximumConcurrency, 1);
+        _injectionQueue = [AWSExecutorPoolDeque new];
+        _workers = [NSMutableArray new];
+        _workerSlots = calloc(_maximumConcurrency, sizeof(void *));
+        atomic_init(&_workerCount, 0);
+        atomic_init(&_pendingCount, 0);
+        atomic_init(&_sleepingCount, 0);
+        pthread_mutex_init(&_lock, NULL);
+        pthread_cond_init(&_condition, NULL);
+
+        __weak AWSExecutorPoolGroup *weakSelf = self;
+        _executor = [AWSExecutor executorWithBlock:^(void (^block)(void)) {
+            [weakSelf execute:block];
+        }];
+    }
+    return self;
+}
+
+- (void)execute:(dispatch_block_t)block {
+    AWSExecutorPoolWorker *worker = (__bridge AWSExecutorPoolWorker *)pthread_getspecific(AWSExecutorPoolCurrentWorkerKey);
+    if (worker.group == self) {
+        [worker.deque pushBottom:block];
+    } else {
+        [_injectionQueue pushBottom:block];
+    }
+    atomic_fetch_add(&_pendingCount, 1);
+
+    if (atomic_load(&_sleepingCount) > 0) {
+        pthread_mutex_lock(&_lock);
+        pthread_cond_signal(&_condition);
+        pthread_mutex_unlock(&_lock);
+    } else if (atomic_load(&_workerCount) < _maximumConcurrency) {
+        [self startWorker];
+    }
+}
+
+- (void)startWorker {
+    pthread_mutex_lock(&_lock);
+    NSUInteger index = atomic_load(&_workerCount);
+    if (index < _maximumConcurrency) {
+        AWSExecutorPoolWorker *worker = [[AWSExecutorPoolWorker alloc] initWithGroup:self index:index];
+        [_workers addObject:worker];
+        _workerSlots[index] = (__bridge void *)worker;
+        atomic_store_explicit(&_workerCount, index + 1, memory_order_release);
+
+        NSThread *thread = [[NSThread alloc] initWithTarget:worker selector:@selector(main) object:nil];
+        thread.name = [NSString stringWithFormat:@"com.amazonaws.AWSExecutorPool.%ld.%lu", (long)self.qualityOfService, (unsigned long)index];
+        thread.qualityOfService = AWSNSQualityOfService(self.qualityOfService);
+        [thread start];
+    }
+    pthread_mutex_unlock(&_lock);
+}
+
+- (dispatch_block_t)nextBlockForWorker:(AWSExecutorPoolWorker *)worker {
+    dispatch_block_t block = [worker.deque popBottom] ?: [_injectionQueue popTop];
+    if (block) {
+        return block;
+    }
+
+    // Steal the oldest block of another worker, starting after this one so the workers spread out.
+    NSUInteger workerCount = atomic_load_explicit(&_workerCount, memory_order_acquire);
+    for (NSUInteger i = 1; i < workerCount; i++) {
+        AWSExecutorPoolWorker *victim = (__bridge AWSExecutorPoolWorker *)_workerSlots[(worker.index + i) % workerCount];
+        block = [victim.deque popTop];
+        if (block) {
+            return block;
+        }
+    }
+    return nil;
+}
+
+- (void)runWorker:(AWSExecutorPoolWorker *)worker {
+    while (YES) {
+        dispatch_block_t block = [self nextBlockForWorker:worker];
+        if (block) {
+            atomic_fetch_sub(&_pendingCount, 1);
+            @autoreleasepool {
+                block();
+            }
+            continue;
+        }
+
+        // Park until a block is executed. A block may be pending while another worker is taking it, in which case
+        // the worker looks again.
+        pthread_mutex_lock(&_lock);
+        atomic_fetch_add(&_sleepingCount, 1);
+        while (atomic_load(&_pendingCount) == 0) {
+            pthread_cond_wait(&_condition, &_lock);
+        }
+        atomic_fetch_sub(&_sleepingCount, 1);
+        pthread_mutex_unlock(&_lock);
+    }
+}
+
+@end
+
+#pragma mark - AWSExecutorPoolSerialQueue
+
+// Runs blocks one at a time in order, by scheduling a block on the pool which
+// drains the queue whenever it has blocks and is not already scheduled.
+@interface AWSExecutorPoolSerialQueue : NSObject
+
+- (instancetype)initWithGroup:(AWSExecutorPoolGroup *)group;
+- (void)execute:(dispatch_block_t)block;
+
+@end
+
+@implementation AWSExecutorPoolSerialQueue {
+    AWSExecutorPoolGroup *_group;
+    NSMutableArray<dispatch_block_t> *_blocks;
+    BOOL _scheduled;
+    pthread_mutex_t _lock;
+}
+
+- (instancetype)initWithGroup:(AWSExecutorPoolGroup *)group {
+    if (self = [super init]) {
+        _group = group;
+        _blocks = [NSMutableArray new];
+        pthread_mutex_init(&_lock, NULL);
+    }
+    return self;
+}
+
+- (void)dealloc {
+    pthread_mutex_destroy(&_lock);
+}
+
+- (void)execute:(dispatch_block_t)block {
+    pthread_mutex_lock(&_lock);
+    [_blocks addObject:[block copy]];
+    BOOL schedule = !_scheduled;
+    _scheduled = YES;
+    pthread_mutex_unlock(&_lock);
+
+    if (schedule) {
+        [self schedule];
+    }
+}
+
+- (void)schedule {
+    [_group execute:^{
+        [self drain];
+    }];
+}
+
+- (void)drain {
+    // Yield the worker after a batch, so a busy queue does not starve the other blocks of the pool.
+    for (NSUInteger i = 0; i < AWSExecutorPoolSerialBatchSize; i++) {
+        pthread_mutex_lock(&_lock);
+        dispatch_block_t block = [_blocks firstObject];
+        if (!block) {
+            _scheduled = NO;
+            pthread_mutex_unlock(&_lock);
+            return;
+        }
+        [_blocks removeObjectAtIndex:0];
+        pthread_mutex_unlock(&_lock);
+
+        @autoreleasepool {
+            block();
+        }
+    }
+    [self schedule];
+}
+
+@end
+
+#pragma mark - AWSExecutorPool
+
+@implementation AWSExecutorPool {
+    NSArray<AWSExecutorPoolGroup *> *_groups;
+}
+
++ (void)initialize {
+    if (self == [AWSExecutorPool class]) {
+        pthread_key_create(&AWSExecutorPoolCurrentWorkerKey, NULL);
+    }
+}
+
++ (instancetype)defaultPool {
+    static AWSExecutorPool *_defaultPool = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        _defaultPool = [AWSExecutorPool new];
+    });
+    return _defaultPool;
+}
+
+- (instancetype)init {
+    NSUInteger processorCount = [[NSProcessInfo processInfo] activeProcessorCount];
+    return [self initWithMaximumUserInteractiveConcurrency:processorCount
+                           maximumUserInitiatedConcurrency:processorCount
+                              maximumBackgroundConcurrency:AWSExecutorPoolDefaultBackgroundConcurrency];
+}
+
+- (instancetype)initWithMaximumUserInteractiveConcurrency:(NSUInteger)userInteractiveConcurrency
+                          maximumUserInitiatedConcurrency:(NSUInteger)userInitiatedConcurrency
+                             maximumBackgroundConcurrency:(NSUInteger)backgroundConcurrency {
+    if (self = [super init]) {
+        _groups = @[
+                    [[AWSExecutorPoolGroup alloc] initWithQualityOfService:AWSExecutorQualityOfServiceUserInteractive
+                                                        maximumConcurrency:userInteractiveConcurrency],
+                    [[AWSExecutorPoolGroup alloc] initWithQualityOfService:AWSExecutorQualityOfServiceUserInitiated
+                                                        maximumConcurrency:userInitiatedConcurrency],
+                    [[AWSExecutorPoolGroup alloc] initWithQualityOfService:AWSExecutorQualityOfServiceBackground
+                                                        maximumConcurrency:backgroundConcurrency],
+                    ];
+    }
+    return self;
+}
+
+- (AWSExecutorPoolGroup *)groupWithQualityOfService:(AWSExecutorQualityOfService)qualityOfService {
+    NSAssert(qualityOfService >= AWSExecutorQualityOfServiceUserInteractive && qualityOfService <= AWSExecutorQualityOfServiceBackground,
+             @"Invalid quality of service %ld", (long)qualityOfService);
+    return _groups[qualityOfService];
+}
+
+- (NSUInteger)maximumConcurrencyForQualityOfService:(AWSExecutorQualityOfService)qualityOfService {
+    return [self groupWithQualityOfService:qualityOfService].maximumConcurrency;
+}
+
+- (void)execute:(dispatch_block_t)block qualityOfService:(AWSExecutorQualityOfService)qualityOfService {
+    [[self groupWithQualityOfService:qualityOfService] execute:block];
+}
+
+- (AWSExecutor *)executorWithQualityOfService:(AWSExecutorQualityOfService)qualityOfService {
+    return [self groupWithQualityOfService:qualityOfService].executor;
+}
+
+- (AWSExecutor *)serialExecutorWithQualityOfService:(AWSExecutorQualityOfService)qualityOfService {
+    AWSExecutorPoolSerialQueue *queue = [[AWSExecutorPoolSerialQueue alloc] initWithGroup:[self groupWithQualityOfService:qualityOfService]];
+    return [AWSExecutor executorWithBlock:^(void (^block)(void)) {
+        [queue execute:block];
+    }];
+}
+
+@end
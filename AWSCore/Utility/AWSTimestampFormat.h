@@ -0,0 +1,94 @@
+//
+// Copyright 2010-2021 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License.
+// A copy of the License is located at
+//
+// http://aws.amazon.com/apache2.0
+//
+// or in the "license" file accompanying this file. This file is distributed
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+//
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ The timestamp formats used by AWS services, which can be parsed and written without an `NSDateFormatter`.
+
+ All formats are in GMT. The parsers and writers work on byte buffers, do not allocate and are safe to call from
+ any thread. They give the same results as an `NSDateFormatter` with the `en_US_POSIX` locale, the GMT time zone
+ and the corresponding `AWSDate...DateFormat...` format. Inputs they do not handle (e.g. an RFC 822 date in a
+ time zone other than GMT, UTC or one of the US time zones, or a year before 1583 or after 9999) are rejected, so
+ that callers can fall back to an `NSDateFormatter`.
+ */
+typedef NS_ENUM(NSInteger, AWSTimestampFormat) {
+    /** `AWSDateISO8601DateFormat1`, e.g. `2019-01-02T03:45:06Z`. */
+    AWSTimestampFormatISO8601,
+    /** `AWSDateISO8601DateFormat2`, e.g. `20190102T034506Z`. */
+    AWSTimestampFormatISO8601Basic,
+    /** `AWSDateISO8601DateFormat3`, e.g. `2019-01-02T03:45:06.789Z`. */
+    AWSTimestampFormatISO8601Milliseconds,
+    /** `AWSDateRFC822DateFormat1`, e.g. `Wed, 02 Jan 2019 03:45:06 GMT`. */
+    AWSTimestampFormatRFC822,
+    /** `AWSDateShortDateFormat1`, e.g. `20190102`. */
+    AWSTimestampFormatShortDate,
+    /** `AWSDateShortDateFormat2`, e.g. `2019-01-02`. */
+    AWSTimestampFormatShortDateExtended,
+    /** Seconds since 1970, e.g. `1546400706`. Written the same as `[NSString stringWithFormat:@"%.lf", seconds]`. */
+    AWSTimestampFormatEpochSeconds,
+};
+
+/**
+ The size of a buffer which can hold any timestamp written by `AWSTimestampWrite`.
+ */
+#define AWSTimestampMaxLength 32
+
+/**
+ Looks up the timestamp format for one of the `AWSDate...DateFormat...` constants.
+
+ @return `NO` if the date format has no corresponding timestamp format.
+ */
+FOUNDATION_EXPORT BOOL AWSTimestampFormatForDateFormat(NSString *dateFormat, AWSTimestampFormat *format);
+
+/**
+ Parses a timestamp.
+
+ @param bytes  The ASCII characters of the timestamp. They do not need to be NUL terminated.
+ @param length The number of bytes.
+ @param format The expected format.
+ @param timeInterval On success, the time interval since the reference date, as returned by `-[NSDate timeIntervalSinceReferenceDate]`.
+
+ @return `NO` if the bytes are not a timestamp in the given format, or a timestamp which is not handled.
+ */
+FOUNDATION_EXPORT BOOL AWSTimestampParse(const char *bytes, size_t length, AWSTimestampFormat format, NSTimeInterval *timeInterval);
+
+/**
+ Writes a timestamp.
+
+ @param timeInterval The time interval since the reference date.
+ @param format       The format to write.
+ @param buffer       The buffer to write to. The timestamp is not NUL terminated.
+ @param capacity     The size of the buffer. `AWSTimestampMaxLength` bytes are always enough.
+
+ @return The number of bytes written, or 0 if the timestamp is not handled or does not fit into the buffer.
+ */
+FOUNDATION_EXPORT size_t AWSTimestampWrite(NSTimeInterval timeInterval, AWSTimestampFormat format, char *buffer, size_t capacity);
+
+/**
+ Parses a timestamp from a string with `AWSTimestampParse`.
+ */
+FOUNDATION_EXPORT BOOL AWSTimestampParseString(NSString *string, AWSTimestampFormat format, NSTimeInterval *timeInterval);
+
+/**
+ Writes a timestamp to a new string with `AWSTimestampWrite`.
+
+ @return The timestamp string, or `nil` if the timestamp is not handled.
+ */
+FOUNDATION_EXPORT NSString * _Nullable AWSTimestampStringFromTimeInterval(NSTimeInterval timeInterval, AWSTimestampFormat format);
+
+NS_ASSUME_NONNULL_END
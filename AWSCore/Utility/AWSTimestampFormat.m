@@ -0,0 +1,525 @@
+//
+// Copyright 2010-2021 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License.
+// A copy of the License is located at
+//
+// http://aws.amazon.com/apache2.0
+//
+// or in the "license" file accompanying this file. This file is distributed
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+//
+
+#import "AWSTimestampFormat.h"
+#import <xlocale.h>
+#import "AWSCategory.h"
+
+static const int64_t AWSTimestampSecondsPerDay = 86400;
+static const int64_t AWSTimestampMillisecondsPerDay = 86400000;
+
+// NSDateFormatter uses a Gregorian calendar which switches from the Julian calendar in October 1582. The dates
+// after the switch are the same in the proleptic Gregorian calendar used here.
+static const int AWSTimestampMinYear = 1583;
+static const int AWSTimestampMaxYear = 9999;
+
+static const char AWSTimestampWeekdayNames[7][4] = {"Sun", "Mon", "Tue", "Wed", "Thu", "Fri", "Sat"};
+static const char AWSTimestampMonthNames[12][4] = {"Jan", "Feb", "Mar", "Apr", "May", "Jun", "Jul", "Aug", "Sep", "Oct", "Nov", "Dec"};
+
+// The time zone abbreviations accepted in RFC 822 dates, and their offsets from GMT in hours.
+static const struct {
+    const char *name;
+    int offset;
+} AWSTimestampTimeZones[] = {
+    {"GMT", 0}, {"UTC", 0},
+    {"EST", -5}, {"EDT", -4},
+    {"CST", -6}, {"CDT", -5},
+    {"MST", -7}, {"MDT", -6},
+    {"PST", -8}, {"PDT", -7},
+};
+
+typedef struct {
+    int year;
+    int month;
+    int day;
+    int hour;
+    int minute;
+    int second;
+    int millisecond;
+    int weekday; // 0 is Sunday
+} AWSTimestampFields;
+
+#pragma mark - Calendar
+
+static inline int64_t AWSTimestampFloorDivide(int64_t numerator, int64_t denominator) {
+    int64_t quotient = numerator / denominator;
+    return (numerator % denominator < 0) ? quotient - 1 : quotient;
+}
+
+static inline BOOL AWSTimestampIsLeapYear(int year) {
+    return (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+}
+
+static inline int AWSTimestampDaysInMonth(int year, int month) {
+    static const int daysInMonth[12] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+    return (month == 2 && AWSTimestampIsLeapYear(year)) ? 29 : daysInMonth[month - 1];
+}
+
+// Days since 1970-01-01 of a date in the proleptic Gregorian calendar.
+static int64_t AWSTimestampDaysFromCivil(int year, int month, int day) {
+    int64_t y = year - (month <= 2 ? 1 : 0);
+    int64_t era = (y >= 0 ? y : y - 399) / 400;
+    int64_t yearOfEra = y - era * 400;
+    int64_t dayOfYear = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+    int64_t dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+    return era * 146097 + dayOfEra - 719468;
+}
+
+static inline int AWSTimestampWeekday(int64_t days) {
+    // 1970-01-01 was a Thursday
+    return (int)(days + 4 - AWSTimestampFloorDivide(days + 4, 7) * 7);
+}
+
+static void AWSTimestampCivilFromDays(int64_t days, AWSTimestampFields *fields) {
+    int64_t z = days + 719468;
+    int64_t era = (z >= 0 ? z : z - 146096) / 146097;
+    int64_t dayOfEra = z - era * 146097;
+    int64_t yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+    int64_t dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+    int64_t monthIndex = (5 * dayOfYear + 2) / 153;
+    fields->day = (int)(dayOfYear - (153 * monthIndex + 2) / 5 + 1);
+    fields->month = (int)(monthIndex < 10 ? monthIndex + 3 : monthIndex - 9);
+    fields->year = (int)(yearOfEra + era * 400 + (fields->month <= 2 ? 1 : 0));
+    fields->weekday = AWSTimestampWeekday(days);
+}
+
+// Splits a time interval the same way NSDateFormatter does: CFDateFormatter rounds to the nearest millisecond and
+// ICU takes the floor of the result.
+static BOOL AWSTimestampFieldsFromTimeInterval(NSTimeInterval timeInterval, AWSTimestampFields *fields) {
+    static int64_t minMilliseconds = 0;
+    static int64_t maxMilliseconds = 0;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        minMilliseconds = AWSTimestampDaysFromCivil(AWSTimestampMinYear, 1, 1) * AWSTimestampMillisecondsPerDay;
+        maxMilliseconds = AWSTimestampDaysFromCivil(AWSTimestampMaxYear + 1, 1, 1) * AWSTimestampMillisecondsPerDay;
+    });
+
+    double udate = floor((timeInterval + NSTimeIntervalSince1970) * 1000.0 + 0.5);
+    if (!isfinite(udate) || udate < minMilliseconds || udate >= maxMilliseconds) {
+        return NO;
+    }
+
+    int64_t milliseconds = (int64_t)udate;
+    int64_t days = AWSTimestampFloorDivide(milliseconds, AWSTimestampMillisecondsPerDay);
+    int64_t millisecondOfDay = milliseconds - days * AWSTimestampMillisecondsPerDay;
+
+    AWSTimestampCivilFromDays(days, fields);
+    fields->hour = (int)(millisecondOfDay / 3600000);
+    fields->minute = (int)(millisecondOfDay / 60000 % 60);
+    fields->second = (int)(millisecondOfDay / 1000 % 60);
+    fields->millisecond = (int)(millisecondOfDay % 1000);
+    return YES;
+}
+
+static BOOL AWSTimestampTimeIntervalFromFields(const AWSTimestampFields *fields, int offsetSeconds, NSTimeInterval *timeInterval) {
+    if (fields->year < AWSTimestampMinYear || fields->year > AWSTimestampMaxYear
+        || fields->month < 1 || fields->month > 12
+        || fields->day < 1 || fields->day > AWSTimestampDaysInMonth(fields->year, fields->month)
+        || fields->hour > 23 || fields->minute > 59 || fields->second > 59) {
+        return NO;
+    }
+
+    int64_t seconds = AWSTimestampDaysFromCivil(fields->year, fields->month, fields->day) * AWSTimestampSecondsPerDay
+    + fields->hour * 3600 + fields->minute * 60 + fields->second - offsetSeconds;
+    // the same conversion as CFDateFormatter
+    double udate = (double)(seconds * 1000 + fields->millisecond);
+    *timeInterval = udate / 1000.0 - NSTimeIntervalSince1970;
+    return YES;
+}
+
+#pragma mark - Parsing
+
+static inline BOOL AWSTimestampReadDigits(const char *bytes, size_t count, int *value) {
+    int result = 0;
+    for (size_t i = 0; i < count; i++) {
+        char c = bytes[i];
+        if (c < '0' || c > '9') {
+            return NO;
+        }
+        result = result * 10 + (c - '0');
+    }
+    *value = result;
+    return YES;
+}
+
+static inline BOOL AWSTimestampReadName(const char *bytes, const char names[][4], int count, int *index) {
+    for (int i = 0; i < count; i++) {
+        if (memcmp(bytes, names[i], 3) == 0) {
+            *index = i;
+            return YES;
+        }
+    }
+    return NO;
+}
+
+// yyyy-MM-dd or yyyyMMdd
+static BOOL AWSTimestampReadDate(const char *bytes, BOOL extended, AWSTimestampFields *fields) {
+    if (extended) {
+        return AWSTimestampReadDigits(bytes, 4, &fields->year)
+        && bytes[4] == '-'
+        && AWSTimestampReadDigits(bytes + 5, 2, &fields->month)
+        && bytes[7] == '-'
+        && AWSTimestampReadDigits(bytes + 8, 2, &fields->day);
+    }
+    return AWSTimestampReadDigits(bytes, 4, &fields->year)
+    && AWSTimestampReadDigits(bytes + 4, 2, &fields->month)
+    && AWSTimestampReadDigits(bytes + 6, 2, &fields->day);
+}
+
+// HH:mm:ss or HHmmss
+static BOOL AWSTimestampReadTime(const char *bytes, BOOL extended, AWSTimestampFields *fields) {
+    if (extended) {
+        return AWSTimestampReadDigits(bytes, 2, &fields->hour)
+        && bytes[2] == ':'
+        && AWSTimestampReadDigits(bytes + 3, 2, &fields->minute)
+        && bytes[5] == ':'
+        && AWSTimestampReadDigits(bytes + 6, 2, &fields->second);
+    }
+    return AWSTimestampReadDigits(bytes, 2, &fields->hour)
+    && AWSTimestampReadDigits(bytes + 2, 2, &fields->minute)
+    && AWSTimestampReadDigits(bytes + 4, 2, &fields->second);
+}
+
+// EEE, dd MMM yyyy HH:mm:ss z
+static BOOL AWSTimestampParseRFC822(const char *bytes, size_t length, NSTimeInterval *timeInterval) {
+    AWSTimestampFields fields = {0};
+    int weekday = 0;
+    if (length < 28 || !AWSTimestampReadName(bytes, AWSTimestampWeekdayNames, 7, &weekday)
+        || bytes[3] != ',' || bytes[4] != ' ') {
+        return NO;
+    }
+
+    // the day may have one or two digits
+    size_t position = 5;
+    size_t dayLength = bytes[6] == ' ' ? 1 : 2;
+    if (!AWSTimestampReadDigits(bytes + position, dayLength, &fields.day)) {
+        return NO;
+    }
+    position += dayLength;
+
+    int monthIndex = 0;
+    if (length < position + 22
+        || bytes[position] != ' '
+        || !AWSTimestampReadName(bytes + position + 1, AWSTimestampMonthNames, 12, &monthIndex)
+        || bytes[position + 4] != ' '
+        || !AWSTimestampReadDigits(bytes + position + 5, 4, &fields.year)
+        || bytes[position + 9] != ' '
+        || !AWSTimestampReadTime(bytes + position + 10, YES, &fields)
+        || bytes[position + 18] != ' ') {
+        return NO;
+    }
+    fields.month = monthIndex + 1;
+    position += 19;
+
+    int offsetHours = 0;
+    BOOL knownTimeZone = NO;
+    for (size_t i = 0; i < sizeof(AWSTimestampTimeZones) / sizeof(AWSTimestampTimeZones[0]); i++) {
+        if (length - position == 3 && memcmp(bytes + position, AWSTimestampTimeZones[i].name, 3) == 0) {
+            offsetHours = AWSTimestampTimeZones[i].offset;
+            knownTimeZone = YES;
+            break;
+        }
+    }
+    if (!knownTimeZone || !AWSTimestampTimeIntervalFromFields(&fields, offsetHours * 3600, timeInterval)) {
+        return NO;
+    }
+
+    // Leave dates whose day of the week does not match to NSDateFormatter.
+    return AWSTimestampWeekday(AWSTimestampDaysFromCivil(fields.year, fields.month, fields.day)) == weekday;
+}
+
+static BOOL AWSTimestampParseEpochSeconds(const char *bytes, size_t length, NSTimeInterval *timeInterval) {
+    // [-]digits[.digits]
+    char buffer[40];
+    if (length == 0 || length >= sizeof(buffer)) {
+        return NO;
+    }
+    size_t position = bytes[0] == '-' ? 1 : 0;
+    size_t integerStart = position;
+    while (position < length && bytes[position] >= '0' && bytes[position] <= '9') {
+        position++;
+    }
+    size_t integerLength = position - integerStart;
+    if (integerLength == 0) {
+        return NO;
+    }
+
+    double seconds = 0;
+    if (position == length && integerLength <= 15) {
+        // exactly representable
+        int64_t integerValue = 0;
+        for (size_t i = integerStart; i < length; i++) {
+            integerValue = integerValue * 10 + (bytes[i] - '0');
+        }
+        seconds = (double)(bytes[0] == '-' ? -integerValue : integerValue);
+    } else {
+        if (position < length) {
+            if (bytes[position] != '.' || position + 1 == length) {
+                return NO;
+            }
+            for (position++; position < length; position++) {
+                if (bytes[position] < '0' || bytes[position] > '9') {
+                    return NO;
+                }
+            }
+        }
+        memcpy(buffer, bytes, length);
+        buffer[length] = '\0';
+        // a NULL locale is the C locale, so '.' is always the decimal point
+        seconds = strtod_l(buffer, NULL, NULL);
+    }
+
+    *timeInterval = seconds - NSTimeIntervalSince1970;
+    return YES;
+}
+
+BOOL AWSTimestampParse(const char *bytes, size_t length, AWSTimestampFormat format, NSTimeInterval *timeInterval) {
+    if (!bytes || !timeInterval) {
+        return NO;
+    }
+
+    AWSTimestampFields fields = {0};
+    switch (format) {
+        case AWSTimestampFormatISO8601:
+            // yyyy-MM-dd'T'HH:mm:ss'Z'
+            if (length != 20
+                || !AWSTimestampReadDate(bytes, YES, &fields)
+                || bytes[10] != 'T'
+                || !AWSTimestampReadTime(bytes + 11, YES, &fields)
+                || bytes[19] != 'Z') {
+                return NO;
+            }
+            break;
+        case AWSTimestampFormatISO8601Basic:
+            // yyyyMMdd'T'HHmmss'Z'
+            if (length != 16
+                || !AWSTimestampReadDate(bytes, NO, &fields)
+                || bytes[8] != 'T'
+                || !AWSTimestampReadTime(bytes + 9, NO, &fields)
+                || bytes[15] != 'Z') {
+                return NO;
+            }
+            break;
+        case AWSTimestampFormatISO8601Milliseconds:
+            // yyyy-MM-dd'T'HH:mm:ss.SSS'Z'
+            if (length != 24
+                || !AWSTimestampReadDate(bytes, YES, &fields)
+                || bytes[10] != 'T'
+                || !AWSTimestampReadTime(bytes + 11, YES, &fields)
+                || bytes[19] != '.'
+                || !AWSTimestampReadDigits(bytes + 20, 3, &fields.millisecond)
+                || bytes[23] != 'Z') {
+                return NO;
+            }
+            break;
+        case AWSTimestampFormatShortDate:
+            if (length != 8 || !AWSTimestampReadDate(bytes, NO, &fields)) {
+                return NO;
+            }
+            break;
+        case AWSTimestampFormatShortDateExtended:
+            if (length != 10 || !AWSTimestampReadDate(bytes, YES, &fields)) {
+                return NO;
+            }
+            break;
+        case AWSTimestampFormatRFC822:
+            return AWSTimestampParseRFC822(bytes, length, timeInterval);
+        case AWSTimestampFormatEpochSeconds:
+            return AWSTimestampParseEpochSeconds(bytes, length, timeInterval);
+        default:
+            return NO;
+    }
+
+    return AWSTimestampTimeIntervalFromFields(&fields, 0, timeInterval);
+}
+
+#pragma mark - Writing
+
+static inline char *AWSTimestampWriteDigits(char *buffer, int value, int count) {
+    for (int i = count - 1; i >= 0; i--) {
+        buffer[i] = '0' + value % 10;
+        value /= 10;
+    }
+    return buffer + count;
+}
+
+static size_t AWSTimestampWriteEpochSeconds(NSTimeInterval timeInterval, char *buffer, size_t capacity) {
+    double seconds = timeInterval + NSTimeIntervalSince1970;
+    if (!isfinite(seconds) || fabs(seconds) >= 1e18) {
+        return 0;
+    }
+
+    // "%.lf" rounds half to even, the same as nearbyint with the default rounding mode, and keeps the sign of -0.
+    double rounded = nearbyint(seconds);
+    BOOL negative = signbit(rounded);
+    uint64_t magnitude = (uint64_t)fabs(rounded);
+
+    char digits[24];
+    size_t count = 0;
+    do {
+        digits[count++] = '0' + magnitude % 10;
+        magnitude /= 10;
+    } while (magnitude > 0);
+
+    size_t length = count + (negative ? 1 : 0);
+    if (length > capacity) {
+        return 0;
+    }
+    char *position = buffer;
+    if (negative) {
+        *position++ = '-';
+    }
+    while (count > 0) {
+        *position++ = digits[--count];
+    }
+    return length;
+}
+
+size_t AWSTimestampWrite(NSTimeInterval timeInterval, AWSTimestampFormat format, char *buffer, size_t capacity) {
+    if (!buffer) {
+        return 0;
+    }
+    if (format == AWSTimestampFormatEpochSeconds) {
+        return AWSTimestampWriteEpochSeconds(timeInterval, buffer, capacity);
+    }
+
+    AWSTimestampFields fields;
+    if (!AWSTimestampFieldsFromTimeInterval(timeInterval, &fields)) {
+        return 0;
+    }
+
+    char output[AWSTimestampMaxLength];
+    char *position = output;
+    switch (format) {
+        case AWSTimestampFormatISO8601:
+        case AWSTimestampFormatISO8601Milliseconds:
+            position = AWSTimestampWriteDigits(position, fields.year, 4);
+            *position++ = '-';
+            position = AWSTimestampWriteDigits(position, fields.month, 2);
+            *position++ = '-';
+            position = AWSTimestampWriteDigits(position, fields.day, 2);
+            *position++ = 'T';
+            position = AWSTimestampWriteDigits(position, fields.hour, 2);
+            *position++ = ':';
+            position = AWSTimestampWriteDigits(position, fields.minute, 2);
+            *position++ = ':';
+            position = AWSTimestampWriteDigits(position, fields.second, 2);
+            if (format == AWSTimestampFormatISO8601Milliseconds) {
+                *position++ = '.';
+                position = AWSTimestampWriteDigits(position, fields.millisecond, 3);
+            }
+            *position++ = 'Z';
+            break;
+        case AWSTimestampFormatISO8601Basic:
+            position = AWSTimestampWriteDigits(position, fields.year, 4);
+            position = AWSTimestampWriteDigits(position, fields.month, 2);
+            position = AWSTimestampWriteDigits(position, fields.day, 2);
+            *position++ = 'T';
+            position = AWSTimestampWriteDigits(position, fields.hour, 2);
+            position = AWSTimestampWriteDigits(position, fields.minute, 2);
+            position = AWSTimestampWriteDigits(position, fields.second, 2);
+            *position++ = 'Z';
+            break;
+        case AWSTimestampFormatRFC822:
+            memcpy(position, AWSTimestampWeekdayNames[fields.weekday], 3);
+            position += 3;
+            *position++ = ',';
+            *position++ = ' ';
+            position = AWSTimestampWriteDigits(position, fields.day, 2);
+            *position++ = ' ';
+            memcpy(position, AWSTimestampMonthNames[fields.month - 1], 3);
+            position += 3;
+            *position++ = ' ';
+            position = AWSTimestampWriteDigits(position, fields.year, 4);
+            *position++ = ' ';
+            position = AWSTimestampWriteDigits(position, fields.hour, 2);
+            *position++ = ':';
+            position = AWSTimestampWriteDigits(position, fields.minute, 2);
+            *position++ = ':';
+            position = AWSTimestampWriteDigits(position, fields.second, 2);
+            memcpy(position, " GMT", 4);
+            position += 4;
+            break;
+        case AWSTimestampFormatShortDate:
+            position = AWSTimestampWriteDigits(position, fields.year, 4);
+            position = AWSTimestampWriteDigits(position, fields.month, 2);
+            position = AWSTimestampWriteDigits(position, fields.day, 2);
+            break;
+        case AWSTimestampFormatShortDateExtended:
+            position = AWSTimestampWriteDigits(position, fields.year, 4);
+            *position++ = '-';
+            position = AWSTimestampWriteDigits(position, fields.month, 2);
+            *position++ = '-';
+            position = AWSTimestampWriteDigits(position, fields.day, 2);
+            break;
+        default:
+            return 0;
+    }
+
+    size_t length = position - output;
+    if (length > capacity) {
+        return 0;
+    }
+    memcpy(buffer, output, length);
+    return length;
+}
+
+#pragma mark - Strings
+
+BOOL AWSTimestampFormatForDateFormat(NSString *dateFormat, AWSTimestampFormat *format) {
+    if (!dateFormat || !format) {
+        return NO;
+    }
+    if (dateFormat == AWSDateISO8601DateFormat1 || [dateFormat isEqualToString:AWSDateISO8601DateFormat1]) {
+        *format = AWSTimestampFormatISO8601;
+    } else if (dateFormat == AWSDateISO8601DateFormat2 || [dateFormat isEqualToString:AWSDateISO8601DateFormat2]) {
+        *format = AWSTimestampFormatISO8601Basic;
+    } else if (dateFormat == AWSDateISO8601DateFormat3 || [dateFormat isEqualToString:AWSDateISO8601DateFormat3]) {
+        *format = AWSTimestampFormatISO8601Milliseconds;
+    } else if (dateFormat == AWSDateRFC822DateFormat1 || [dateFormat isEqualToString:AWSDateRFC822DateFormat1]) {
+        *format = AWSTimestampFormatRFC822;
+    } else if (dateFormat == AWSDateShortDateFormat1 || [dateFormat isEqualToString:AWSDateShortDateFormat1]) {
+        *format = AWSTimestampFormatShortDate;
+    } else if (dateFormat == AWSDateShortDateFormat2 || [dateFormat isEqualToString:AWSDateShortDateFormat2]) {
+        *format = AWSTimestampFormatShortDateExtended;
+    } else {
+        return NO;
+    }
+    return YES;
+}
+
+BOOL AWSTimestampParseString(NSString *string, AWSTimestampFormat format, NSTimeInterval *timeInterval) {
+    if (!string) {
+        return NO;
+    }
+    const char *bytes = CFStringGetCStringPtr((__bridge CFStringRef)string, kCFStringEncodingASCII);
+    char buffer[64];
+    if (!bytes) {
+        if (![string getCString:buffer maxLength:sizeof(buffer) encoding:NSASCIIStringEncoding]) {
+            return NO;
+        }
+        bytes = buffer;
+    }
+    return AWSTimestampParse(bytes, strlen(bytes), format, timeInterval);
+}
+
+NSString *AWSTimestampStringFromTimeInterval(NSTimeInterval timeInterval, AWSTimestampFormat format) {
+    char buffer[AWSTimestampMaxLength];
+    size_t length = AWSTimestampWrite(timeInterval, format, buffer, sizeof(buffer));
+    if (length == 0) {
+        return nil;
+    }
+    return [[NSString alloc] initWithBytes:buffer length:length encoding:NSASCIIStringEncoding];
+}
@@ -0,0 +1,59 @@
+//
+// Copyright 2010-2021 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License.
+// A copy of the License is located at
+//
+// http://aws.amazon.com/apache2.0
+//
+// or in the "license" file accompanying this file. This file is distributed
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+//
+
+#import <Foundation/Foundation.h>
+
+/**
+ An XML stream writer which writes UTF-8 directly into a byte buffer.
+
+ It produces the same document as `AWSXMLWriter` with its default settings (a line break and tab indentation
+ before each start tag, `<a></a>` for elements closed by name), for the subset of `AWSXMLStreamWriter` used by
+ `AWSXMLBuilder`. Text and attribute values are escaped with a lookup table over the UTF-8 bytes, and the element
+ stack is kept in preallocated C buffers, so writing an element does not allocate any objects.
+
+ Characters which are not allowed in XML 1.0 (control characters other than tab, line feed and carriage return,
+ U+FFFE and U+FFFF, unpaired surrogates) are dropped, the same as `AWSXMLWriter` does. Characters outside of the
+ Basic Multilingual Plane are written as is.
+
+ Misuse (e.g. an attribute without an open start element) raises an `XMLWriterException`, the same as `AWSXMLWriter`.
+ */
+@interface AWSXMLByteWriter : NSObject
+
+/**
+ The number of elements which have been started and not ended yet.
+ */
+@property (nonatomic, assign, readonly) NSUInteger level;
+
+/**
+ Creates a writer whose buffer initially holds `capacity` bytes. The buffer grows as needed.
+ */
+- (instancetype)initWithCapacity:(NSUInteger)capacity NS_DESIGNATED_INITIALIZER;
+
+- (void)writeStartElement:(NSString *)localName;
+
+// automatic end element (mirrors previous start element at the same level)
+- (void)writeEndElement;
+- (void)writeEndElement:(NSString *)localName;
+
+- (void)writeAttribute:(NSString *)localName value:(NSString *)value;
+
+- (void)writeCharacters:(NSString *)text;
+
+// return the written xml as a string
+- (NSString *)toString;
+// return the written xml as UTF-8 data
+- (NSData *)toData;
+
+@end
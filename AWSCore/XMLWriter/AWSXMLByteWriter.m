@@ -0,0 +1,368 @@
+//
+// Copyright 2010-2021 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License.
+// A copy of the License is located at
+//
+// http://aws.amazon.com/apache2.0
+//
+// or in the "license" file accompanying this file. This file is distributed
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+//
+
+#import "AWSXMLByteWriter.h"
+
+static NSString *const AWSXMLByteWriterExceptionName = @"XMLWriterException";
+
+static const NSUInteger AWSXMLByteWriterDefaultCapacity = 1024;
+static const NSUInteger AWSXMLByteWriterDefaultStackDepth = 16;
+
+typedef struct {
+    uint8_t *bytes;
+    NSUInteger length;
+    NSUInteger capacity;
+} AWSXMLByteBuffer;
+
+static void AWSXMLByteBufferInit(AWSXMLByteBuffer *buffer, NSUInteger capacity) {
+    buffer->bytes = malloc(capacity);
+    if (!buffer->bytes) {
+        @throw([NSException exceptionWithName:AWSXMLByteWriterExceptionName reason:[NSString stringWithFormat:@"Could not allocate data buffer of %lu bytes", (unsigned long)capacity] userInfo:nil]);
+    }
+    buffer->length = 0;
+    buffer->capacity = capacity;
+}
+
+static void AWSXMLByteBufferGrow(AWSXMLByteBuffer *buffer, NSUInteger additionalLength) {
+    NSUInteger capacity = MAX(buffer->capacity * 2, buffer->length + additionalLength);
+    uint8_t *bytes = realloc(buffer->bytes, capacity);
+    if (!bytes) {
+        @throw([NSException exceptionWithName:AWSXMLByteWriterExceptionName reason:[NSString stringWithFormat:@"Could not allocate data buffer of %lu bytes", (unsigned long)capacity] userInfo:nil]);
+    }
+    buffer->bytes = bytes;
+    buffer->capacity = capacity;
+}
+
+static inline void AWSXMLByteBufferAppend(AWSXMLByteBuffer *buffer, const void *bytes, NSUInteger length) {
+    if (buffer->length + length > buffer->capacity) {
+        AWSXMLByteBufferGrow(buffer, length);
+    }
+    memcpy(buffer->bytes + buffer->length, bytes, length);
+    buffer->length += length;
+}
+
+static inline void AWSXMLByteBufferAppendByte(AWSXMLByteBuffer *buffer, uint8_t byte) {
+    if (buffer->length == buffer->capacity) {
+        AWSXMLByteBufferGrow(buffer, 1);
+    }
+    buffer->bytes[buffer->length++] = byte;
+}
+
+#define AWSXMLByteBufferAppendLiteral(buffer, literal) AWSXMLByteBufferAppend((buffer), (literal), sizeof(literal) - 1)
+
+// How each byte of UTF-8 text is written. Bytes which are not listed are copied.
+typedef NS_ENUM(uint8_t, AWSXMLByteWriterEscape) {
+    AWSXMLByteWriterEscapeNone = 0,
+    AWSXMLByteWriterEscapeQuot,
+    AWSXMLByteWriterEscapeAmp,
+    AWSXMLByteWriterEscapeLt,
+    AWSXMLByteWriterEscapeGt,
+    AWSXMLByteWriterEscapeDrop,
+    // 0xEF is the lead byte of U+FFFE and U+FFFF, which need to be dropped.
+    AWSXMLByteWriterEscapeCheckNonCharacter,
+};
+
+static const uint8_t AWSXMLByteWriterEscapeTable[256] = {
+    [0x00] = AWSXMLByteWriterEscapeDrop, [0x01] = AWSXMLByteWriterEscapeDrop, [0x02] = AWSXMLByteWriterEscapeDrop,
+    [0x03] = AWSXMLByteWriterEscapeDrop, [0x04] = AWSXMLByteWriterEscapeDrop, [0x05] = AWSXMLByteWriterEscapeDrop,
+    [0x06] = AWSXMLByteWriterEscapeDrop, [0x07] = AWSXMLByteWriterEscapeDrop, [0x08] = AWSXMLByteWriterEscapeDrop,
+    [0x0B] = AWSXMLByteWriterEscapeDrop, [0x0C] = AWSXMLByteWriterEscapeDrop, [0x0E] = AWSXMLByteWriterEscapeDrop,
+    [0x0F] = AWSXMLByteWriterEscapeDrop, [0x10] = AWSXMLByteWriterEscapeDrop, [0x11] = AWSXMLByteWriterEscapeDrop,
+    [0x12] = AWSXMLByteWriterEscapeDrop, [0x13] = AWSXMLByteWriterEscapeDrop, [0x14] = AWSXMLByteWriterEscapeDrop,
+    [0x15] = AWSXMLByteWriterEscapeDrop, [0x16] = AWSXMLByteWriterEscapeDrop, [0x17] = AWSXMLByteWriterEscapeDrop,
+    [0x18] = AWSXMLByteWriterEscapeDrop, [0x19] = AWSXMLByteWriterEscapeDrop, [0x1A] = AWSXMLByteWriterEscapeDrop,
+    [0x1B] = AWSXMLByteWriterEscapeDrop, [0x1C] = AWSXMLByteWriterEscapeDrop, [0x1D] = AWSXMLByteWriterEscapeDrop,
+    [0x1E] = AWSXMLByteWriterEscapeDrop, [0x1F] = AWSXMLByteWriterEscapeDrop,
+    ['"'] = AWSXMLByteWriterEscapeQuot,
+    ['&'] = AWSXMLByteWriterEscapeAmp,
+    ['<'] = AWSXMLByteWriterEscapeLt,
+    ['>'] = AWSXMLByteWriterEscapeGt,
+    [0xEF] = AWSXMLByteWriterEscapeCheckNonCharacter,
+};
+
+static const struct {
+    const char *bytes;
+    NSUInteger length;
+} AWSXMLByteWriterEntities[] = {
+    [AWSXMLByteWriterEscapeQuot] = {"&quot;", 6},
+    [AWSXMLByteWriterEscapeAmp] = {"&amp;", 5},
+    [AWSXMLByteWriterEscapeLt] = {"&lt;", 4},
+    [AWSXMLByteWriterEscapeGt] = {"&gt;", 4},
+};
+
+static void AWSXMLByteWriterAppendEscapedBytes(AWSXMLByteBuffer *buffer, const uint8_t *bytes, NSUInteger length) {
+    NSUInteger rangeStart = 0;
+    NSUInteger i = 0;
+    while (i < length) {
+        uint8_t escape = AWSXMLByteWriterEscapeTable[bytes[i]];
+        if (escape == AWSXMLByteWriterEscapeNone) {
+            i++;
+            continue;
+        }
+
+        NSUInteger skipLength = 1;
+        if (escape == AWSXMLByteWriterEscapeCheckNonCharacter) {
+            if (i + 2 < length && bytes[i + 1] == 0xBF && (bytes[i + 2] == 0xBE || bytes[i + 2] == 0xBF)) {
+                skipLength = 3;
+            } else {
+                i++;
+                continue;
+            }
+        }
+
+        // write range if any
+        if (i > rangeStart) {
+            AWSXMLByteBufferAppend(buffer, bytes + rangeStart, i - rangeStart);
+        }
+        if (escape <= AWSXMLByteWriterEscapeGt) {
+            AWSXMLByteBufferAppend(buffer, AWSXMLByteWriterEntities[escape].bytes, AWSXMLByteWriterEntities[escape].length);
+        }
+        i += skipLength;
+        rangeStart = i;
+    }
+
+    // main flow will probably write all bytes here
+    if (length > rangeStart) {
+        AWSXMLByteBufferAppend(buffer, bytes + rangeStart, length - rangeStart);
+    }
+}
+
+static void AWSXMLByteWriterAppendString(AWSXMLByteBuffer *buffer, NSString *string, BOOL escape) {
+    if (!string) {
+        return;
+    }
+
+    const char *UTF8String = CFStringGetCStringPtr((__bridge CFStringRef)string, kCFStringEncodingUTF8);
+    if (UTF8String) {
+        // main flow
+        NSUInteger length = strlen(UTF8String);
+        if (escape) {
+            AWSXMLByteWriterAppendEscapedBytes(buffer, (const uint8_t *)UTF8String, length);
+        } else {
+            AWSXMLByteBufferAppend(buffer, UTF8String, length);
+        }
+        return;
+    }
+
+    // The characters are converted in chunks which always end on a character boundary.
+    uint8_t chunk[1024];
+    NSRange range = NSMakeRange(0, [string length]);
+    while (range.length > 0) {
+        NSUInteger usedLength = 0;
+        NSRange remainingRange = NSMakeRange(NSMaxRange(range), 0);
+        BOOL converted = [string getBytes:chunk
+                                maxLength:sizeof(chunk)
+                               usedLength:&usedLength
+                                 encoding:NSUTF8StringEncoding
+                                  options:0
+                                    range:range
+                           remainingRange:&remainingRange];
+        if (!converted || usedLength == 0) {
+            // an unpaired surrogate can not be converted, skip it
+            range = NSMakeRange(range.location + 1, range.length - 1);
+            continue;
+        }
+        if (escape) {
+            AWSXMLByteWriterAppendEscapedBytes(buffer, chunk, usedLength);
+        } else {
+            AWSXMLByteBufferAppend(buffer, chunk, usedLength);
+        }
+        range = remainingRange;
+    }
+}
+
+@interface AWSXMLByteWriter() {
+    // the current output buffer
+    AWSXMLByteBuffer _output;
+
+    // the UTF-8 local names of the open elements, back to back
+    AWSXMLByteBuffer _elementNames;
+    // the offset of each open element's local name in _elementNames. one per element level
+    NSUInteger *_elementNameOffsets;
+    NSUInteger _elementNameOffsetsCapacity;
+
+    // is the element open, i.e. the end bracket has not been written yet
+    BOOL _openElement;
+    // does the element contain characters
+    BOOL _emptyElement;
+}
+
+@end
+
+@implementation AWSXMLByteWriter
+
+- (instancetype)init {
+    return [self initWithCapacity:AWSXMLByteWriterDefaultCapacity];
+}
+
+- (instancetype)initWithCapacity:(NSUInteger)capacity {
+    if (self = [super init]) {
+        AWSXMLByteBufferInit(&_output, MAX(capacity, (NSUInteger)64));
+        AWSXMLByteBufferInit(&_elementNames, AWSXMLByteWriterDefaultStackDepth * 32);
+        _elementNameOffsetsCapacity = AWSXMLByteWriterDefaultStackDepth;
+        _elementNameOffsets = malloc(_elementNameOffsetsCapacity * sizeof(NSUInteger));
+        if (!_elementNameOffsets) {
+            @throw([NSException exceptionWithName:AWSXMLByteWriterExceptionName reason:@"Could not allocate the element stack" userInfo:nil]);
+        }
+    }
+    return self;
+}
+
+- (void)dealloc {
+    free(_output.bytes);
+    free(_elementNames.bytes);
+    free(_elementNameOffsets);
+}
+
+#pragma mark - Element stack
+
+- (void)pushElementStack:(NSString *)localName {
+    if (_level == _elementNameOffsetsCapacity) {
+        NSUInteger capacity = _elementNameOffsetsCapacity * 2;
+        NSUInteger *offsets = realloc(_elementNameOffsets, capacity * sizeof(NSUInteger));
+        if (!offsets) {
+            @throw([NSException exceptionWithName:AWSXMLByteWriterExceptionName reason:@"Could not allocate the element stack" userInfo:nil]);
+        }
+        _elementNameOffsets = offsets;
+        _elementNameOffsetsCapacity = capacity;
+    }
+    _elementNameOffsets[_level] = _elementNames.length;
+    AWSXMLByteWriterAppendString(&_elementNames, localName, NO);
+}
+
+- (void)popElementStack {
+    // _level has already been decreased, so it is the index of the element being closed
+    _elementNames.length = _elementNameOffsets[_level];
+}
+
+#pragma mark - Writing
+
+- (void)writeLinebreakAndIndentation {
+    AWSXMLByteBufferAppendByte(&_output, '\n');
+    if (_output.length + _level > _output.capacity) {
+        AWSXMLByteBufferGrow(&_output, _level);
+    }
+    memset(_output.bytes + _output.length, '\t', _level);
+    _output.length += _level;
+}
+
+- (void)writeCloseStartElement {
+    if (_openElement) {
+        AWSXMLByteBufferAppendByte(&_output, '>');
+        _openElement = NO;
+    }
+}
+
+- (void)writeStartElement:(NSString *)localName {
+    [self writeCloseStartElement];
+    [self writeLinebreakAndIndentation];
+
+    AWSXMLByteBufferAppendByte(&_output, '<');
+    AWSXMLByteWriterAppendString(&_output, localName, NO);
+
+    [self pushElementStack:localName];
+
+    _openElement = YES;
+    _emptyElement = YES;
+    _level += 1;
+}
+
+- (void)writeEndElementWithBytes:(const uint8_t *)bytes length:(NSUInteger)length localName:(NSString *)localName {
+    if (_level == 0) {
+        // raise exception
+        @throw([NSException exceptionWithName:AWSXMLByteWriterExceptionName reason:@"Cannot write more end elements than start elements." userInfo:nil]);
+    }
+
+    _level -= 1;
+
+    if (_openElement) {
+        // go for <START><END>
+        [self writeCloseStartElement];
+    } else if (_emptyElement) {
+        // go for linebreak + indentation + <END>
+        [self writeLinebreakAndIndentation];
+    } else {
+        // go for <START>characters<END>
+    }
+
+    AWSXMLByteBufferAppendLiteral(&_output, "</");
+    if (localName) {
+        AWSXMLByteWriterAppendString(&_output, localName, NO);
+    } else {
+        AWSXMLByteBufferAppend(&_output, bytes, length);
+    }
+    AWSXMLByteBufferAppendByte(&_output, '>');
+
+    [self popElementStack];
+
+    _emptyElement = YES;
+    _openElement = NO;
+}
+
+- (void)writeEndElement {
+    if (_level == 0) {
+        @throw([NSException exceptionWithName:AWSXMLByteWriterExceptionName reason:@"Cannot write more end elements than start elements." userInfo:nil]);
+    }
+
+    if (_openElement) {
+        // go for <START />
+        AWSXMLByteBufferAppendLiteral(&_output, " />");
+        _level -= 1;
+        [self popElementStack];
+
+        _emptyElement = YES;
+        _openElement = NO;
+    } else {
+        NSUInteger offset = _elementNameOffsets[_level - 1];
+        [self writeEndElementWithBytes:_elementNames.bytes + offset length:_elementNames.length - offset localName:nil];
+    }
+}
+
+- (void)writeEndElement:(NSString *)localName {
+    [self writeEndElementWithBytes:NULL length:0 localName:localName];
+}
+
+- (void)writeAttribute:(NSString *)localName value:(NSString *)value {
+    if (!_openElement) {
+        // raise exception
+        @throw([NSException exceptionWithName:AWSXMLByteWriterExceptionName reason:@"No open start element" userInfo:nil]);
+    }
+
+    AWSXMLByteBufferAppendByte(&_output, ' ');
+    AWSXMLByteWriterAppendString(&_output, localName, NO);
+    AWSXMLByteBufferAppendLiteral(&_output, "=\"");
+    AWSXMLByteWriterAppendString(&_output, value, YES);
+    AWSXMLByteBufferAppendByte(&_output, '"');
+}
+
+- (void)writeCharacters:(NSString *)text {
+    [self writeCloseStartElement];
+
+    AWSXMLByteWriterAppendString(&_output, text, YES);
+
+    _emptyElement = NO;
+}
+
+#pragma mark - Output
+
+- (NSString *)toString {
+    return [[NSString alloc] initWithBytes:_output.bytes length:_output.length encoding:NSUTF8StringEncoding];
+}
+
+- (NSData *)toData {
+    return [NSData dataWithBytes:_output.bytes length:_output.length];
+}
+
+@end
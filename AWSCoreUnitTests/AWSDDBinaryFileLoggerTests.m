@@ -0,0 +1,213 @@
+//
+// Copyright 2010-2021 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License.
+// A copy of the License is located at
+//
+// http://aws.amazon.com/apache2.0
+//
+// or in the "license" file accompanying this file. This file is distributed
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+//
+
+#import <XCTest/XCTest.h>
+#import <AWSCore/AWSCore.h>
+
+static const NSUInteger AWSDDBinaryFileLoggerTestsIterations = 100000;
+
+#define AWSDDBinaryFileLoggerTestsLog(log, frmt, ...) \
+    LOG_MACRO_TO_AWSDDLOG(log, YES, AWSDDLogLevelAll, AWSDDLogFlagInfo, 0, nil, __PRETTY_FUNCTION__, frmt, ##__VA_ARGS__)
+
+@interface AWSDDBinaryFileLoggerTestsLogger : AWSDDAbstractLogger
+
+@property (nonatomic, assign) BOOL acceptsUnformattedMessages;
+@property (nonatomic, strong) NSMutableArray<AWSDDLogMessage *> *messages;
+
+@end
+
+@implementation AWSDDBinaryFileLoggerTestsLogger
+
+@synthesize acceptsUnformattedMessages = _acceptsUnformattedMessages;
+
+- (instancetype)init {
+    if (self = [super init]) {
+        _messages = [NSMutableArray new];
+    }
+    return self;
+}
+
+- (void)logMessage:(AWSDDLogMessage *)logMessage {
+    [self.messages addObject:logMessage];
+}
+
+@end
+
+@interface AWSDDBinaryFileLoggerTests : XCTestCase
+
+@end
+
+@implementation AWSDDBinaryFileLoggerTests
+
+- (void)testDeferredFormattingMatchesFormatting {
+    AWSDDLog *log = [AWSDDLog new];
+    log.defersFormatting = YES;
+    AWSDDBinaryFileLoggerTestsLogger *logger = [AWSDDBinaryFileLoggerTestsLogger new];
+    [log addLogger:logger];
+
+    NSMutableString *mutableString = [NSMutableString stringWithString:@"before"];
+    NSArray *array = @[@1, @"two"];
+    char character = 'x';
+    short shortValue = -3;
+    const unichar characters[] = {'u', 'n', 'i', 0};
+
+    AWSDDBinaryFileLoggerTestsLog(log, @"%d %i %ld %lld %qd %zd %hd %hhd", -1, 2, -3L, 4LL, -5LL, (ssize_t)6, shortValue, (char)-7);
+    AWSDDBinaryFileLoggerTestsLog(log, @"%u %lu %llu %zu %x %X %#lx %o %08.3f", 1U, 2UL, 3ULL, (size_t)4, 255U, 255U, 4096UL, 8U, 3.14159);
+    AWSDDBinaryFileLoggerTestsLog(log, @"%e %g %.2Lf %*d %-*.*s|", 1234.5, 0.0001, (long double)2.5, 5, 42, 6, 3, "abcdef");
+    AWSDDBinaryFileLoggerTestsLog(log, @"%c %C %S %s %s %p %%", character, (unichar)0x263A, characters, "c string", (char *)NULL, (void *)0x1234);
+    AWSDDBinaryFileLoggerTestsLog(log, @"%@ %@ %@ %@ %@", @"string", @42, mutableString, array, nil);
+    [mutableString setString:@"after"];
+    [log flushLog];
+
+    NSArray<NSString *> *expectedMessages = @[
+        [NSString stringWithFormat:@"%d %i %ld %lld %qd %zd %hd %hhd", -1, 2, -3L, 4LL, -5LL, (ssize_t)6, shortValue, (char)-7],
+        [NSString stringWithFormat:@"%u %lu %llu %zu %x %X %#lx %o %08.3f", 1U, 2UL, 3ULL, (size_t)4, 255U, 255U, 4096UL, 8U, 3.14159],
+        [NSString stringWithFormat:@"%e %g %.2Lf %*d %-*.*s|", 1234.5, 0.0001, (long double)2.5, 5, 42, 6, 3, "abcdef"],
+        [NSString stringWithFormat:@"%c %C %S %s %s %p %%", character, (unichar)0x263A, characters, "c string", (char *)NULL, (void *)0x1234],
+        [NSString stringWithFormat:@"%@ %@ %@ %@ %@", @"string", @42, @"before", array, nil],
+    ];
+
+    XCTAssertEqual([logger.messages count], [expectedMessages count]);
+    for (NSUInteger i = 0; i < [logger.messages count]; i++) {
+        XCTAssertEqualObjects(logger.messages[i].message, expectedMessages[i]);
+        XCTAssertNotNil(logger.messages[i].format);
+    }
+}
+
+- (void)testStringPrecisionAndWideStrings {
+    AWSDDLog *log = [AWSDDLog new];
+    log.defersFormatting = YES;
+    AWSDDBinaryFileLoggerTestsLogger *logger = [AWSDDBinaryFileLoggerTestsLogger new];
+    [log addLogger:logger];
+
+    // Not terminated: only the bytes within the precision may be read.
+    const char characters[] = {'a', 'b', 'c', 'd'};
+    const unichar unicharacters[] = {'u', 'n', 'i', 'c'};
+    const wchar_t *wideString = L"wide ☺";
+    AWSDDBinaryFileLoggerTestsLog(log, @"%.3s|%.*s|%ls|%.2ls|%ls", characters, 2, characters, wideString, wideString, (wchar_t *)NULL);
+    AWSDDBinaryFileLoggerTestsLog(log, @"%.*S|%.2S", 3, unicharacters, unicharacters);
+    [log flushLog];
+
+    XCTAssertEqual([logger.messages count], 2);
+    XCTAssertEqualObjects(logger.messages[0].message, @"abc|ab|wide ☺|wi|(null)");
+    XCTAssertEqualObjects(logger.messages[1].message, @"uni|un");
+}
+
+- (void)testUnformattedMessages {
+    AWSDDLog *log = [AWSDDLog new];
+    log.defersFormatting = YES;
+    AWSDDBinaryFileLoggerTestsLogger *logger = [AWSDDBinaryFileLoggerTestsLogger new];
+    logger.acceptsUnformattedMessages = YES;
+    [log addLogger:logger];
+
+    AWSDDBinaryFileLoggerTestsLog(log, @"count: %d", 7);
+    [log flushLog];
+
+    XCTAssertEqual([logger.messages count], 1);
+    AWSDDLogMessage *message = logger.messages[0];
+    XCTAssertNil(message.message);
+    XCTAssertEqualObjects(message.format, @"count: %d");
+    XCTAssertEqual([message.arguments length], 9);
+    XCTAssertEqual(((const uint8_t *)[message.arguments bytes])[0], 'i');
+}
+
+- (void)testArgumentsWhichDoNotFitAreFormattedRightAway {
+    AWSDDLog *log = [AWSDDLog new];
+    log.defersFormatting = YES;
+    AWSDDBinaryFileLoggerTestsLogger *logger = [AWSDDBinaryFileLoggerTestsLogger new];
+    logger.acceptsUnformattedMessages = YES;
+    [log addLogger:logger];
+
+    NSString *longString = [@"" stringByPaddingToLength:1000 withString:@"a" startingAtIndex:0];
+    AWSDDBinaryFileLoggerTestsLog(log, @"%s", [longString UTF8String]);
+    AWSDDBinaryFileLoggerTestsLog(log, @"%2$@ %1$@", @"b", @"a");
+    [log flushLog];
+
+    XCTAssertEqual([logger.messages count], 2);
+    XCTAssertEqualObjects(logger.messages[0].message, longString);
+    XCTAssertNil(logger.messages[0].format);
+    XCTAssertEqualObjects(logger.messages[1].message, @"a b");
+    XCTAssertNil(logger.messages[1].format);
+}
+
+- (void)testBinaryFileLogger {
+    NSString *path = [NSTemporaryDirectory() stringByAppendingPathComponent:@"AWSDDBinaryFileLoggerTests.log"];
+    [[NSFileManager defaultManager] removeItemAtPath:path error:nil];
+
+    AWSDDLog *log = [AWSDDLog new];
+    log.defersFormatting = YES;
+    AWSDDBinaryFileLogger *logger = [[AWSDDBinaryFileLogger alloc] initWithLogFilePath:path];
+    [log addLogger:logger];
+
+    for (int i = 0; i < 3; i++) {
+        AWSDDBinaryFileLoggerTestsLog(log, @"iteration %d of %@", i, @"loop");
+    }
+    [log log:NO
+     message:@"synchronous"
+       level:AWSDDLogLevelAll
+        flag:AWSDDLogFlagError
+     context:0
+        file:__FILE__
+    function:__PRETTY_FUNCTION__
+        line:__LINE__
+         tag:nil];
+    [log flushLog];
+    [log removeLogger:logger];
+    [log flushLog];
+
+    NSData *data = [NSData dataWithContentsOfFile:path];
+    XCTAssertNotNil(data);
+    XCTAssertEqualObjects([data subdataWithRange:NSMakeRange(0, 8)], [NSData dataWithBytes:"AWSDDBL\x01" length:8]);
+
+    // The format string is written once, the message of the synchronous statement as text.
+    NSData *format = [@"iteration %d of %@" dataUsingEncoding:NSUTF8StringEncoding];
+    NSRange range = [data rangeOfData:format options:0 range:NSMakeRange(0, [data length])];
+    XCTAssertNotEqual(range.location, NSNotFound);
+    NSUInteger end = NSMaxRange(range);
+    XCTAssertEqual([data rangeOfData:format options:0 range:NSMakeRange(end, [data length] - end)].location, NSNotFound);
+    XCTAssertNotEqual([data rangeOfData:[@"synchronous" dataUsingEncoding:NSUTF8StringEncoding] options:0 range:NSMakeRange(0, [data length])].location, NSNotFound);
+
+    [[NSFileManager defaultManager] removeItemAtPath:path error:nil];
+}
+
+// Compare with testPerformanceDeferredFormatting.
+- (void)testPerformanceFormatting {
+    AWSDDLog *log = [AWSDDLog new];
+    [log addLogger:[[AWSDDBinaryFileLogger alloc] initWithLogFilePath:@"/dev/null"]];
+    [self measureBlock:^{
+        for (NSUInteger i = 0; i < AWSDDBinaryFileLoggerTestsIterations; i++) {
+            @autoreleasepool {
+                AWSDDBinaryFileLoggerTestsLog(log, @"EventCode:%lu, status:%lu, stream: %@", (unsigned long)i, (unsigned long)2, @"stream");
+            }
+        }
+        [log flushLog];
+    }];
+}
+
+- (void)testPerformanceDeferredFormatting {
+    AWSDDLog *log = [AWSDDLog new];
+    log.defersFormatting = YES;
+    [log addLogger:[[AWSDDBinaryFileLogger alloc] initWithLogFilePath:@"/dev/null"]];
+    [self measureBlock:^{
+        for (NSUInteger i = 0; i < AWSDDBinaryFileLoggerTestsIterations; i++) {
+            @autoreleasepool {
+                AWSDDBinaryFileLoggerTestsLog(log, @"EventCode:%lu, status:%lu, stream: %@", (unsigned long)i, (unsigned long)2, @"stream");
+            }
+        }
+        [log flushLog];
+    }];
+}
+
+@end
@@ -0,0 +1,270 @@
+//
+// Copyright 2010-2021 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License.
+// A copy of the License is located at
+//
+// http://aws.amazon.com/apache2.0
+//
+// or in the "license" file accompanying this file. This file is distributed
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+//
+
+#import <XCTest/XCTest.h>
+#import <AWSCore/AWSCore.h>
+
+static const NSUInteger AWSDDFileLoggerTestsIterations = 100000;
+
+#define AWSDDFileLoggerTestsLog(log, isAsynchronous, flg, frmt, ...) \
+    LOG_MACRO_TO_AWSDDLOG(log, isAsynchronous, AWSDDLogLevelAll, flg, 0, nil, __PRETTY_FUNCTION__, frmt, ##__VA_ARGS__)
+
+@interface AWSDDFileLoggerTestsFormatter : NSObject <AWSDDLogFormatter>
+
+@end
+
+@implementation AWSDDFileLoggerTestsFormatter
+
+- (NSString *)formatLogMessage:(AWSDDLogMessage *)logMessage {
+    return logMessage->_message;
+}
+
+@end
+
+@interface AWSDDFileLoggerTests : XCTestCase
+
+@property (nonatomic, strong) NSString *logsDirectory;
+@property (nonatomic, strong) AWSDDLogFileManagerDefault *logFileManager;
+@property (nonatomic, strong) AWSDDFileLogger *logger;
+@property (nonatomic, strong) AWSDDLog *log;
+
+@end
+
+@implementation AWSDDFileLoggerTests
+
+- (void)setUp {
+    [super setUp];
+
+    self.logsDirectory = [NSTemporaryDirectory() stringByAppendingPathComponent:[[NSUUID UUID] UUIDString]];
+    self.logFileManager = [[AWSDDLogFileManagerDefault alloc] initWithLogsDirectory:self.logsDirectory];
+    self.logger = [[AWSDDFileLogger alloc] initWithLogFileManager:self.logFileManager];
+    self.logger.logFormatter = [AWSDDFileLoggerTestsFormatter new];
+    self.log = [AWSDDLog new];
+}
+
+- (void)tearDown {
+    [self.log removeAllLoggers];
+    [[NSFileManager defaultManager] removeItemAtPath:self.logsDirectory error:nil];
+
+    [super tearDown];
+}
+
+- (NSString *)currentLogFileContents {
+    NSString *logFilePath = [self.logFileManager sortedLogFilePaths].firstObject;
+    return [NSString stringWithContentsOfFile:logFilePath encoding:NSUTF8StringEncoding error:nil];
+}
+
+// The path of a log file changes when it is archived on the simulator.
+- (NSString *)archivedLogFilePath {
+    NSString *logFilePath = [self.logFileManager sortedLogFilePaths].firstObject;
+    if ([[logFilePath pathExtension] isEqualToString:@"gz"]) {
+        logFilePath = [logFilePath stringByDeletingPathExtension];
+    }
+    return logFilePath;
+}
+
+- (void)rollLogFile {
+    XCTestExpectation *expectation = [self expectationWithDescription:@"rollLogFile"];
+    [self.logger rollLogFileWithCompletionBlock:^{
+        [expectation fulfill];
+    }];
+    [self waitForExpectationsWithTimeout:5 handler:nil];
+}
+
+- (void)testLogMessagesAreWrittenRightAwayByDefault {
+    [self.log addLogger:self.logger];
+
+    AWSDDFileLoggerTestsLog(self.log, NO, AWSDDLogFlagInfo, @"first");
+    XCTAssertEqualObjects([self currentLogFileContents], @"first\n");
+
+    for (int i = 0; i < 3; i++) {
+        AWSDDFileLoggerTestsLog(self.log, YES, AWSDDLogFlagInfo, @"message %d", i);
+    }
+    [self.log flushLog];
+    XCTAssertEqualObjects([self currentLogFileContents], @"first\nmessage 0\nmessage 1\nmessage 2\n");
+}
+
+- (void)testBufferedLogMessages {
+    self.logger.bufferSize = 64 * 1024;
+    self.logger.flushInterval = 0;
+    [self.log addLogger:self.logger];
+
+    AWSDDFileLoggerTestsLog(self.log, NO, AWSDDLogFlagInfo, @"info");
+    AWSDDFileLoggerTestsLog(self.log, NO, AWSDDLogFlagWarning, @"warning");
+    XCTAssertEqualObjects([self currentLogFileContents], @"");
+
+    // A critical log message writes the log messages before it.
+    AWSDDFileLoggerTestsLog(self.log, NO, AWSDDLogFlagError, @"error");
+    XCTAssertEqualObjects([self currentLogFileContents], @"info\nwarning\nerror\n");
+
+    AWSDDFileLoggerTestsLog(self.log, NO, AWSDDLogFlagDebug, @"debug");
+    XCTAssertEqualObjects([self currentLogFileContents], @"info\nwarning\nerror\n");
+
+    [self.log flushLog];
+    XCTAssertEqualObjects([self currentLogFileContents], @"info\nwarning\nerror\ndebug\n");
+}
+
+- (void)testBufferedLogMessagesAreWrittenWhenTheBufferIsFull {
+    self.logger.bufferSize = 16;
+    self.logger.flushInterval = 0;
+    [self.log addLogger:self.logger];
+
+    AWSDDFileLoggerTestsLog(self.log, NO, AWSDDLogFlagInfo, @"0123456");
+    XCTAssertEqualObjects([self currentLogFileContents], @"");
+
+    AWSDDFileLoggerTestsLog(self.log, NO, AWSDDLogFlagInfo, @"7890123");
+    XCTAssertEqualObjects([self currentLogFileContents], @"0123456\n7890123\n");
+}
+
+- (void)testBufferedLogMessagesAreWrittenAfterTheFlushInterval {
+    self.logger.bufferSize = 64 * 1024;
+    self.logger.flushInterval = 0.1;
+    [self.log addLogger:self.logger];
+
+    AWSDDFileLoggerTestsLog(self.log, NO, AWSDDLogFlagInfo, @"info");
+    XCTAssertEqualObjects([self currentLogFileContents], @"");
+
+    NSDate *timeout = [NSDate dateWithTimeIntervalSinceNow:5];
+    while (![[self currentLogFileContents] isEqualToString:@"info\n"] && [timeout timeIntervalSinceNow] > 0) {
+        [NSThread sleepForTimeInterval:0.05];
+    }
+    XCTAssertEqualObjects([self currentLogFileContents], @"info\n");
+}
+
+- (void)testBufferedLogMessagesAreWrittenWhenTheLogFileIsRolled {
+    self.logger.bufferSize = 64 * 1024;
+    self.logger.flushInterval = 0;
+    [self.log addLogger:self.logger];
+
+    AWSDDFileLoggerTestsLog(self.log, NO, AWSDDLogFlagInfo, @"rolled");
+    [self rollLogFile];
+
+    XCTAssertEqualObjects([self currentLogFileContents], @"rolled\n");
+}
+
+- (void)testRollingDueToSizeCountsBufferedLogMessages {
+    self.logger.bufferSize = 64 * 1024;
+    self.logger.flushInterval = 0;
+    self.logger.maximumFileSize = 10;
+    [self.log addLogger:self.logger];
+
+    AWSDDFileLoggerTestsLog(self.log, NO, AWSDDLogFlagInfo, @"0123456789");
+    AWSDDFileLoggerTestsLog(self.log, NO, AWSDDLogFlagInfo, @"next");
+    [self.log flushLog];
+
+    NSArray<NSString *> *sortedLogFilePaths = [self.logFileManager sortedLogFilePaths];
+    XCTAssertEqual([sortedLogFilePaths count], 2);
+    XCTAssertEqualObjects([NSString stringWithContentsOfFile:sortedLogFilePaths[0] encoding:NSUTF8StringEncoding error:nil], @"next\n");
+    XCTAssertEqualObjects([NSString stringWithContentsOfFile:sortedLogFilePaths[1] encoding:NSUTF8StringEncoding error:nil], @"0123456789\n");
+}
+
+- (void)testRolledLogFilesAreCompressed {
+    self.logFileManager.compressesArchivedLogFiles = YES;
+    [self.log addLogger:self.logger];
+
+    AWSDDFileLoggerTestsLog(self.log, NO, AWSDDLogFlagInfo, @"compressed");
+    [self rollLogFile];
+    NSString *logFilePath = [self archivedLogFilePath];
+
+    NSString *compressedLogFilePath = [logFilePath stringByAppendingPathExtension:@"gz"];
+    NSDate *timeout = [NSDate dateWithTimeIntervalSinceNow:5];
+    while ([[NSFileManager defaultManager] fileExistsAtPath:logFilePath] && [timeout timeIntervalSinceNow] > 0) {
+        [NSThread sleepForTimeInterval:0.05];
+    }
+
+    XCTAssertFalse([[NSFileManager defaultManager] fileExistsAtPath:logFilePath]);
+    NSData *compressedData = [NSData dataWithContentsOfFile:compressedLogFilePath];
+    XCTAssertEqualObjects([compressedData awsgzip_gunzippedData], [@"compressed\n" dataUsingEncoding:NSUTF8StringEncoding]);
+
+    NSArray<AWSDDLogFileInfo *> *sortedLogFileInfos = [self.logFileManager sortedLogFileInfos];
+    XCTAssertEqual([sortedLogFileInfos count], 1);
+    XCTAssertEqualObjects(sortedLogFileInfos[0].filePath, compressedLogFilePath);
+    XCTAssertTrue(sortedLogFileInfos[0].isArchived);
+
+    // The next log file comes before the compressed one.
+    AWSDDFileLoggerTestsLog(self.log, NO, AWSDDLogFlagInfo, @"next");
+    sortedLogFileInfos = [self.logFileManager sortedLogFileInfos];
+    XCTAssertEqual([sortedLogFileInfos count], 2);
+    XCTAssertFalse(sortedLogFileInfos[0].isArchived);
+    XCTAssertEqualObjects(sortedLogFileInfos[1].filePath, compressedLogFilePath);
+}
+
+- (void)testOldLogFilesAreDeleted {
+    self.logFileManager.maximumNumberOfLogFiles = 2;
+    [self.log addLogger:self.logger];
+
+    NSMutableArray<NSString *> *logFilePaths = [NSMutableArray array];
+    for (int i = 0; i < 5; i++) {
+        AWSDDFileLoggerTestsLog(self.log, NO, AWSDDLogFlagInfo, @"log file %d", i);
+        [self rollLogFile];
+        [logFilePaths insertObject:[self archivedLogFilePath] atIndex:0];
+    }
+    AWSDDFileLoggerTestsLog(self.log, NO, AWSDDLogFlagInfo, @"current");
+
+    // The current log file, and the two most recent archived log files.
+    NSArray<NSString *> *sortedLogFilePaths = [self.logFileManager sortedLogFilePaths];
+    XCTAssertEqual([sortedLogFilePaths count], 3);
+    XCTAssertEqualObjects(sortedLogFilePaths[1], logFilePaths[0]);
+    XCTAssertEqualObjects(sortedLogFilePaths[2], logFilePaths[1]);
+
+    NSArray<NSString *> *fileNames = [[NSFileManager defaultManager] contentsOfDirectoryAtPath:self.logsDirectory error:nil];
+    XCTAssertEqual([fileNames count], 3);
+}
+
+- (void)testLogFileIndexIsRebuiltWhenTheLogsDirectoryChanges {
+    [self.log addLogger:self.logger];
+
+    AWSDDFileLoggerTestsLog(self.log, NO, AWSDDLogFlagInfo, @"first");
+    [self rollLogFile];
+    NSString *logFilePath = [self archivedLogFilePath];
+    AWSDDFileLoggerTestsLog(self.log, NO, AWSDDLogFlagInfo, @"second");
+    XCTAssertEqual([[self.logFileManager sortedLogFilePaths] count], 2);
+
+    [[NSFileManager defaultManager] removeItemAtPath:logFilePath error:nil];
+    XCTAssertEqual([[self.logFileManager sortedLogFilePaths] count], 1);
+    XCTAssertFalse([[self.logFileManager sortedLogFilePaths] containsObject:logFilePath]);
+}
+
+// Compare with testPerformanceBufferedFileLogger.
+- (void)testPerformanceFileLogger {
+    self.logger.maximumFileSize = 0;
+    [self.log addLogger:self.logger];
+
+    [self measureBlock:^{
+        for (NSUInteger i = 0; i < AWSDDFileLoggerTestsIterations; i++) {
+            @autoreleasepool {
+                AWSDDFileLoggerTestsLog(self.log, YES, AWSDDLogFlagInfo, @"EventCode:%lu, status:%lu, stream: %@", (unsigned long)i, (unsigned long)2, @"stream");
+            }
+        }
+        [self.log flushLog];
+    }];
+}
+
+- (void)testPerformanceBufferedFileLogger {
+    self.logger.maximumFileSize = 0;
+    self.logger.bufferSize = 256 * 1024;
+    [self.log addLogger:self.logger];
+
+    [self measureBlock:^{
+        for (NSUInteger i = 0; i < AWSDDFileLoggerTestsIterations; i++) {
+            @autoreleasepool {
+                AWSDDFileLoggerTestsLog(self.log, YES, AWSDDLogFlagInfo, @"EventCode:%lu, status:%lu, stream: %@", (unsigned long)i, (unsigned long)2, @"stream");
+            }
+        }
+        [self.log flushLog];
+    }];
+}
+
+@end
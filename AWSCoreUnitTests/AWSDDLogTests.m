@@ -0,0 +1,371 @@
+//
+// Copyright 2010-2021 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License.
+// A copy of the License is located at
+//
+// http://aws.amazon.com/apache2.0
+//
+// or in the "license" file accompanying this file. This file is distributed
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+//
+
+#import <XCTest/XCTest.h>
+#import <AWSCore/AWSCore.h>
+
+static const NSUInteger AWSDDLogTestsIterations = 100000;
+
+// Records the messages it is handed, in batches if batchLogging is set.
+@interface AWSDDLogTestsLogger : AWSDDAbstractLogger
+
+@property (nonatomic, assign) BOOL batchLogging;
+@property (nonatomic, strong) dispatch_semaphore_t enteredSemaphore;
+@property (nonatomic, strong) dispatch_semaphore_t releaseSemaphore;
+
+- (NSArray<AWSDDLogMessage *> *)messages;
+- (NSArray<NSNumber *> *)batchSizes;
+
+@end
+
+@implementation AWSDDLogTestsLogger {
+    NSMutableArray<AWSDDLogMessage *> *_messages;
+    NSMutableArray<NSNumber *> *_batchSizes;
+}
+
+- (instancetype)init {
+    if (self = [super init]) {
+        _messages = [NSMutableArray new];
+        _batchSizes = [NSMutableArray new];
+    }
+    return self;
+}
+
+- (BOOL)respondsToSelector:(SEL)aSelector {
+    if (aSelector == @selector(logMessages:)) {
+        return self.batchLogging;
+    }
+    return [super respondsToSelector:aSelector];
+}
+
+- (void)logMessage:(AWSDDLogMessage *)logMessage {
+    [self logMessages:@[logMessage]];
+}
+
+- (void)logMessages:(NSArray<AWSDDLogMessage *> *)logMessages {
+    if (self.enteredSemaphore) {
+        dispatch_semaphore_signal(self.enteredSemaphore);
+        dispatch_semaphore_wait(self.releaseSemaphore, DISPATCH_TIME_FOREVER);
+    }
+    @synchronized (self) {
+        [_messages addObjectsFromArray:logMessages];
+        [_batchSizes addObject:@([logMessages count])];
+    }
+}
+
+- (NSArray<AWSDDLogMessage *> *)messages {
+    @synchronized (self) {
+        return [_messages copy];
+    }
+}
+
+- (NSArray<NSNumber *> *)batchSizes {
+    @synchronized (self) {
+        return [_batchSizes copy];
+    }
+}
+
+@end
+
+@interface AWSDDLogTestsNullLogger : AWSDDAbstractLogger
+
+@end
+
+@implementation AWSDDLogTestsNullLogger
+
+- (void)logMessage:(AWSDDLogMessage *)logMessage {
+}
+
+@end
+
+@interface AWSDDLogTests : XCTestCase
+
+@end
+
+@implementation AWSDDLogTests
+
+- (void)logMessage:(NSString *)message toLog:(AWSDDLog *)log flag:(AWSDDLogFlag)flag {
+    [log log:YES
+     message:message
+       level:AWSDDLogLevelAll
+        flag:flag
+     context:0
+        file:__FILE__
+    function:__PRETTY_FUNCTION__
+        line:__LINE__
+         tag:@"tag"];
+}
+
+- (void)testAsynchronousMessages {
+    AWSDDLog *log = [AWSDDLog new];
+    AWSDDLogTestsLogger *logger = [AWSDDLogTestsLogger new];
+    [log addLogger:logger];
+
+    NSString *threadName = [[NSThread currentThread] name];
+    [[NSThread currentThread] setName:@"AWSDDLogTests"];
+    for (NSUInteger i = 0; i < 10; i++) {
+        [self logMessage:[NSString stringWithFormat:@"%lu", (unsigned long)i] toLog:log flag:AWSDDLogFlagInfo];
+    }
+    [[NSThread currentThread] setName:threadName];
+    [log flushLog];
+
+    NSArray<AWSDDLogMessage *> *messages = [logger messages];
+    XCTAssertEqual([messages count], 10);
+    for (NSUInteger i = 0; i < [messages count]; i++) {
+        XCTAssertEqualObjects(messages[i].message, ([NSString stringWithFormat:@"%lu", (unsigned long)i]));
+    }
+
+    AWSDDLogMessage *message = messages[0];
+    XCTAssertEqual(message.flag, AWSDDLogFlagInfo);
+    XCTAssertEqual(message.level, AWSDDLogLevelAll);
+    XCTAssertEqualObjects(message.file, @__FILE__);
+    XCTAssertEqualObjects(message.fileName, @"AWSDDLogTests");
+    XCTAssertEqualObjects(message.function, @"-[AWSDDLogTests logMessage:toLog:flag:]");
+    XCTAssertEqualObjects(message.tag, @"tag");
+    XCTAssertEqualObjects(message.threadName, @"AWSDDLogTests");
+    XCTAssertEqualObjects(message.queueLabel, @"com.apple.main-thread");
+    XCTAssertGreaterThan([message.threadID length], 0);
+    XCTAssertLessThanOrEqual(fabs([message.timestamp timeIntervalSinceNow]), 60);
+}
+
+- (void)testFileAndFunctionAreCopied {
+    AWSDDLog *log = [AWSDDLog new];
+    AWSDDLogTestsLogger *logger = [AWSDDLogTestsLogger new];
+    [log addLogger:logger];
+
+    // Like the `#file` and `#function` strings of Swift, the strings do not outlive the call.
+    NSString *longPath = [[@"" stringByPaddingToLength:300 withString:@"/directory" startingAtIndex:0] stringByAppendingString:@"/Source.swift"];
+    char *file = strdup([longPath UTF8String]);
+    char *function = strdup("function()");
+    [log log:YES
+     message:@"message"
+       level:AWSDDLogLevelAll
+        flag:AWSDDLogFlagInfo
+     context:0
+        file:file
+    function:function
+        line:__LINE__
+         tag:nil];
+    memset(file, 'x', strlen(file));
+    memset(function, 'x', strlen(function));
+    free(file);
+    free(function);
+    [log flushLog];
+
+    AWSDDLogMessage *message = [logger messages][0];
+    XCTAssertTrue([longPath hasSuffix:message.file]);
+    XCTAssertEqualObjects(message.fileName, @"Source");
+    XCTAssertEqualObjects(message.function, @"function()");
+}
+
+- (void)testLongFileAndFunctionAreCutBetweenCharacters {
+    AWSDDLog *log = [AWSDDLog new];
+    AWSDDLogTestsLogger *logger = [AWSDDLogTestsLogger new];
+    [log addLogger:logger];
+
+    // Two bytes a character in UTF-8, so an odd number of bytes kept would cut one in half.
+    NSString *longPath = [[@"" stringByPaddingToLength:300 withString:@"é" startingAtIndex:0] stringByAppendingString:@"/Sources.swift"];
+    NSString *longFunction = [@"" stringByPaddingToLength:300 withString:@"é" startingAtIndex:0];
+    [log log:YES
+     message:@"message"
+       level:AWSDDLogLevelAll
+        flag:AWSDDLogFlagInfo
+     context:0
+        file:[longPath UTF8String]
+    function:[longFunction UTF8String]
+        line:__LINE__
+         tag:nil];
+    [log flushLog];
+
+    AWSDDLogMessage *message = [logger messages][0];
+    XCTAssertGreaterThan([message.file length], [@"/Sources.swift" length]);
+    XCTAssertTrue([longPath hasSuffix:message.file]);
+    XCTAssertGreaterThan([message.function length], 0);
+    XCTAssertTrue([longFunction hasPrefix:message.function]);
+}
+
+- (void)testSynchronousMessageAfterAsynchronousMessages {
+    AWSDDLog *log = [AWSDDLog new];
+    AWSDDLogTestsLogger *logger = [AWSDDLogTestsLogger new];
+    [log addLogger:logger];
+
+    [self logMessage:@"async" toLog:log flag:AWSDDLogFlagInfo];
+    [log log:NO
+     message:@"sync"
+       level:AWSDDLogLevelAll
+        flag:AWSDDLogFlagInfo
+     context:0
+        file:__FILE__
+    function:__PRETTY_FUNCTION__
+        line:__LINE__
+         tag:nil];
+
+    NSArray<AWSDDLogMessage *> *messages = [logger messages];
+    XCTAssertEqual([messages count], 2);
+    XCTAssertEqualObjects(messages[0].message, @"async");
+    XCTAssertEqualObjects(messages[1].message, @"sync");
+}
+
+- (void)testBatchesFilteredByLoggerLevel {
+    AWSDDLog *log = [AWSDDLog new];
+    AWSDDLogTestsLogger *errorLogger = [AWSDDLogTestsLogger new];
+    errorLogger.batchLogging = YES;
+    AWSDDLogTestsLogger *blockingLogger = [AWSDDLogTestsLogger new];
+    blockingLogger.batchLogging = YES;
+    blockingLogger.enteredSemaphore = dispatch_semaphore_create(0);
+    blockingLogger.releaseSemaphore = dispatch_semaphore_create(0);
+    [log addLogger:errorLogger withLevel:AWSDDLogLevelError];
+    [log addLogger:blockingLogger withLevel:AWSDDLogLevelAll];
+
+    // Hold the logging queue, so that the following messages are queued and delivered together.
+    [self logMessage:@"first" toLog:log flag:AWSDDLogFlagError];
+    dispatch_semaphore_wait(blockingLogger.enteredSemaphore, DISPATCH_TIME_FOREVER);
+    blockingLogger.enteredSemaphore = nil;
+    for (NSUInteger i = 0; i < 10; i++) {
+        [self logMessage:@"error" toLog:log flag:AWSDDLogFlagError];
+        [self logMessage:@"debug" toLog:log flag:AWSDDLogFlagDebug];
+    }
+    dispatch_semaphore_signal(blockingLogger.releaseSemaphore);
+    [log flushLog];
+
+    XCTAssertEqualObjects([blockingLogger batchSizes], (@[@1, @20]));
+    XCTAssertEqualObjects([errorLogger batchSizes], (@[@1, @10]));
+    for (AWSDDLogMessage *message in [errorLogger messages]) {
+        XCTAssertEqual(message.flag, AWSDDLogFlagError);
+    }
+}
+
+- (void)testDropPolicy {
+    AWSDDLog *log = [AWSDDLog new];
+    log.queueOverflowPolicy = AWSDDLogQueueOverflowPolicyDrop;
+    AWSDDLogTestsLogger *logger = [AWSDDLogTestsLogger new];
+    logger.enteredSemaphore = dispatch_semaphore_create(0);
+    logger.releaseSemaphore = dispatch_semaphore_create(0);
+    [log addLogger:logger];
+
+    [self logMessage:@"first" toLog:log flag:AWSDDLogFlagInfo];
+    dispatch_semaphore_wait(logger.enteredSemaphore, DISPATCH_TIME_FOREVER);
+    logger.enteredSemaphore = nil;
+
+    // The queue holds AWSDDLOG_MAX_QUEUE_SIZE (1000) statements, rounded up to a power of 2.
+    for (NSUInteger i = 0; i < 1024 + 10; i++) {
+        [self logMessage:@"queued" toLog:log flag:AWSDDLogFlagInfo];
+    }
+    XCTAssertEqual(log.droppedMessageCount, 10);
+
+    dispatch_semaphore_signal(logger.releaseSemaphore);
+    [log flushLog];
+    XCTAssertEqual([[logger messages] count], 1 + 1024);
+}
+
+- (void)testBlockPolicyLosesNothing {
+    AWSDDLog *log = [AWSDDLog new];
+    AWSDDLogTestsLogger *logger = [AWSDDLogTestsLogger new];
+    logger.batchLogging = YES;
+    [log addLogger:logger];
+
+    const NSUInteger threadCount = 4; // The size of nextIndexes
+    const NSUInteger messageCount = 5000;
+    dispatch_apply(threadCount, dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^(size_t thread) {
+        for (NSUInteger i = 0; i < messageCount; i++) {
+            [self logMessage:[NSString stringWithFormat:@"%zu %lu", thread, (unsigned long)i] toLog:log flag:AWSDDLogFlagInfo];
+        }
+    });
+    [log flushLog];
+
+    XCTAssertEqual(log.droppedMessageCount, 0);
+    NSArray<AWSDDLogMessage *> *messages = [logger messages];
+    XCTAssertEqual([messages count], threadCount * messageCount);
+
+    // The messages of each thread are in order.
+    NSUInteger nextIndexes[4] = {0};
+    for (AWSDDLogMessage *message in messages) {
+        NSArray<NSString *> *components = [message.message componentsSeparatedByString:@" "];
+        NSUInteger thread = (NSUInteger)[components[0] integerValue];
+        XCTAssertEqual((NSUInteger)[components[1] integerValue], nextIndexes[thread]);
+        nextIndexes[thread]++;
+    }
+    for (NSNumber *batchSize in [logger batchSizes]) {
+        XCTAssertLessThanOrEqual([batchSize unsignedIntegerValue], 64);
+    }
+}
+
+- (void)testLogMessageObjects {
+    AWSDDLog *log = [AWSDDLog new];
+    AWSDDLogTestsLogger *logger = [AWSDDLogTestsLogger new];
+    [log addLogger:logger];
+
+    AWSDDLogMessage *logMessage = [[AWSDDLogMessage alloc] initWithMessage:@"message"
+                                                                     level:AWSDDLogLevelAll
+                                                                      flag:AWSDDLogFlagWarning
+                                                                   context:1
+                                                                      file:@"file"
+                                                                  function:@"function"
+                                                                      line:2
+                                                                       tag:nil
+                                                                   options:(AWSDDLogMessageOptions)0
+                                                                 timestamp:nil];
+    [log log:YES message:logMessage];
+    [log flushLog];
+
+    XCTAssertEqual([[logger messages] count], 1);
+    XCTAssertEqual([logger messages][0], logMessage);
+}
+
+// Compare with testPerformanceSemaphoreQueue, which queues each message like AWSDDLog did before the ring buffer.
+- (void)testPerformanceRingBuffer {
+    AWSDDLog *log = [AWSDDLog new];
+    [log addLogger:[AWSDDLogTestsNullLogger new]];
+    [self measureBlock:^{
+        for (NSUInteger i = 0; i < AWSDDLogTestsIterations; i++) {
+            @autoreleasepool {
+                [self logMessage:@"message" toLog:log flag:AWSDDLogFlagInfo];
+            }
+        }
+        [log flushLog];
+    }];
+}
+
+- (void)testPerformanceSemaphoreQueue {
+    AWSDDLogTestsNullLogger *logger = [AWSDDLogTestsNullLogger new];
+    dispatch_queue_t loggingQueue = dispatch_queue_create("AWSDDLogTests", NULL);
+    dispatch_semaphore_t queueSemaphore = dispatch_semaphore_create(1000);
+    [self measureBlock:^{
+        for (NSUInteger i = 0; i < AWSDDLogTestsIterations; i++) {
+            @autoreleasepool {
+                AWSDDLogMessage *logMessage = [[AWSDDLogMessage alloc] initWithMessage:@"message"
+                                                                                 level:AWSDDLogLevelAll
+                                                                                  flag:AWSDDLogFlagInfo
+                                                                               context:0
+                                                                                  file:[NSString stringWithFormat:@"%s", __FILE__]
+                                                                              function:[NSString stringWithFormat:@"%s", __PRETTY_FUNCTION__]
+                                                                                  line:__LINE__
+                                                                                   tag:@"tag"
+                                                                               options:(AWSDDLogMessageOptions)0
+                                                                             timestamp:nil];
+                dispatch_semaphore_wait(queueSemaphore, DISPATCH_TIME_FOREVER);
+                dispatch_async(loggingQueue, ^{
+                    dispatch_sync(logger.loggerQueue, ^{ @autoreleasepool {
+                        [logger logMessage:logMessage];
+                    } });
+                    dispatch_semaphore_signal(queueSemaphore);
+                });
+            }
+        }
+        dispatch_sync(loggingQueue, ^{});
+    }];
+}
+
+@end
@@ -0,0 +1,184 @@
+//
+// Copyright 2010-2021 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License.
+// A copy of the License is located at
+//
+// http://aws.amazon.com/apache2.0
+//
+// or in the "license" file accompanying this file. This file is distributed
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+//
+
+#import <XCTest/XCTest.h>
+#import <AWSCore/AWSCore.h>
+#import <stdatomic.h>
+
+static const NSUInteger AWSExecutorPoolTestsBlockCount = 1000;
+
+@interface AWSExecutorPoolTests : XCTestCase
+
+@end
+
+@implementation AWSExecutorPoolTests
+
+- (void)testBlocksRunAtTheirQualityOfService {
+    AWSExecutorPool *pool = [AWSExecutorPool new];
+    NSDictionary<NSNumber *, NSNumber *> *expected = @{@(AWSExecutorQualityOfServiceUserInteractive) : @(NSQualityOfServiceUserInteractive),
+                                                       @(AWSExecutorQualityOfServiceUserInitiated) : @(NSQualityOfServiceUserInitiated),
+                                                       @(AWSExecutorQualityOfServiceBackground) : @(NSQualityOfServiceBackground)};
+    for (NSNumber *qualityOfService in expected) {
+        XCTestExpectation *expectation = [self expectationWithDescription:[qualityOfService stringValue]];
+        [pool execute:^{
+            XCTAssertEqual([NSThread currentThread].qualityOfService, [expected[qualityOfService] integerValue]);
+            XCTAssertFalse([NSThread isMainThread]);
+            [expectation fulfill];
+        } qualityOfService:[qualityOfService integerValue]];
+    }
+    [self waitForExpectationsWithTimeout:5 handler:nil];
+}
+
+- (void)testMaximumConcurrency {
+    AWSExecutorPool *pool = [[AWSExecutorPool alloc] initWithMaximumUserInteractiveConcurrency:0
+                                                               maximumUserInitiatedConcurrency:3
+                                                                  maximumBackgroundConcurrency:2];
+    XCTAssertEqual([pool maximumConcurrencyForQualityOfService:AWSExecutorQualityOfServiceUserInteractive], 1);
+    XCTAssertEqual([pool maximumConcurrencyForQualityOfService:AWSExecutorQualityOfServiceUserInitiated], 3);
+    XCTAssertEqual([pool maximumConcurrencyForQualityOfService:AWSExecutorQualityOfServiceBackground], 2);
+
+    // The blocks outlive this method only until the group is done, so the counters can live on the stack.
+    atomic_uint inFlightCount = 0;
+    atomic_uint maximumInFlightCount = 0;
+    atomic_uint *inFlight = &inFlightCount;
+    atomic_uint *maximumInFlight = &maximumInFlightCount;
+    dispatch_group_t group = dispatch_group_create();
+    for (NSUInteger i = 0; i < 64; i++) {
+        dispatch_group_enter(group);
+        [pool execute:^{
+            unsigned int current = atomic_fetch_add(inFlight, 1) + 1;
+            unsigned int maximum = atomic_load(maximumInFlight);
+            while (current > maximum && !atomic_compare_exchange_weak(maximumInFlight, &maximum, current)) {
+            }
+            usleep(1000);
+            atomic_fetch_sub(inFlight, 1);
+            dispatch_group_leave(group);
+        } qualityOfService:AWSExecutorQualityOfServiceUserInitiated];
+    }
+    XCTAssertEqual(dispatch_group_wait(group, dispatch_time(DISPATCH_TIME_NOW, 10 * NSEC_PER_SEC)), 0);
+    XCTAssertLessThanOrEqual(atomic_load(maximumInFlight), 3);
+    XCTAssertGreaterThanOrEqual(atomic_load(maximumInFlight), 1);
+}
+
+- (void)testSerialExecutorRunsBlocksInOrder {
+    AWSExecutor *executor = [[AWSExecutorPool defaultPool] serialExecutorWithQualityOfService:AWSExecutorQualityOfServiceBackground];
+    NSMutableArray *order = [NSMutableArray new];
+    atomic_uint inFlightCount = 0;
+    atomic_uint overlapCount = 0;
+    atomic_uint *inFlight = &inFlightCount;
+    atomic_uint *overlaps = &overlapCount;
+    dispatch_group_t group = dispatch_group_create();
+    for (NSUInteger i = 0; i < AWSExecutorPoolTestsBlockCount; i++) {
+        dispatch_group_enter(group);
+        [executor execute:^{
+            if (atomic_fetch_add(inFlight, 1) != 0) {
+                atomic_fetch_add(overlaps, 1);
+            }
+            [order addObject:@(i)];
+            atomic_fetch_sub(inFlight, 1);
+            dispatch_group_leave(group);
+        }];
+    }
+    XCTAssertEqual(dispatch_group_wait(group, dispatch_time(DISPATCH_TIME_NOW, 10 * NSEC_PER_SEC)), 0);
+    XCTAssertEqual(atomic_load(overlaps), 0);
+    XCTAssertEqual([order count], AWSExecutorPoolTestsBlockCount);
+    for (NSUInteger i = 0; i < AWSExecutorPoolTestsBlockCount; i++) {
+        XCTAssertEqualObjects(order[i], @(i));
+    }
+}
+
+// Blocks executed from a worker go onto its own deque, and are stolen by the other workers.
+- (void)testBlocksExecutedFromWorkers {
+    AWSExecutorPool *pool = [[AWSExecutorPool alloc] initWithMaximumUserInteractiveConcurrency:4
+                                                               maximumUserInitiatedConcurrency:4
+                                                                  maximumBackgroundConcurrency:4];
+    atomic_uint runCount = 0;
+    atomic_uint *runs = &runCount;
+    NSMutableSet<NSString *> *threadNames = [NSMutableSet new];
+    NSLock *lock = [NSLock new];
+    dispatch_group_t group = dispatch_group_create();
+    dispatch_group_enter(group);
+    [pool execute:^{
+        for (NSUInteger i = 0; i < AWSExecutorPoolTestsBlockCount; i++) {
+            dispatch_group_enter(group);
+            [pool execute:^{
+                [lock lock];
+                [threadNames addObject:[NSThread currentThread].name];
+                [lock unlock];
+                usleep(100);
+                atomic_fetch_add(runs, 1);
+                dispatch_group_leave(group);
+            } qualityOfService:AWSExecutorQualityOfServiceUserInitiated];
+        }
+        dispatch_group_leave(group);
+    } qualityOfService:AWSExecutorQualityOfServiceUserInitiated];
+    XCTAssertEqual(dispatch_group_wait(group, dispatch_time(DISPATCH_TIME_NOW, 10 * NSEC_PER_SEC)), 0);
+    XCTAssertEqual(atomic_load(runs), AWSExecutorPoolTestsBlockCount);
+    for (NSString *name in threadNames) {
+        XCTAssertTrue([name hasPrefix:@"com.amazonaws.AWSExecutorPool."]);
+    }
+}
+
+- (void)testTaskContinuationsRunOnThePool {
+    AWSExecutor *executor = [[AWSExecutorPool defaultPool] executorWithQualityOfService:AWSExecutorQualityOfServiceUserInitiated];
+    XCTAssertEqual(executor, [[AWSExecutorPool defaultPool] executorWithQualityOfService:AWSExecutorQualityOfServiceUserInitiated]);
+
+    XCTestExpectation *expectation = [self expectationWithDescription:@"continuation"];
+    [[AWSTask taskWithResult:@"result"] continueWithExecutor:executor withSuccessBlock:^id(AWSTask *task) {
+        XCTAssertEqualObjects(task.result, @"result");
+        XCTAssertEqual([NSThread currentThread].qualityOfService, NSQualityOfServiceUserInitiated);
+        [expectation fulfill];
+        return nil;
+    }];
+    [self waitForExpectationsWithTimeout:5 handler:nil];
+}
+
+- (void)testNetworkingConfigurationCopiesExecutor {
+    AWSNetworkingConfiguration *configuration = [AWSNetworkingConfiguration new];
+    XCTAssertNil(configuration.executor);
+    configuration.executor = [[AWSExecutorPool defaultPool] executorWithQualityOfService:AWSExecutorQualityOfServiceUserInteractive];
+    AWSNetworkingConfiguration *copy = [configuration copy];
+    XCTAssertEqual(copy.executor, configuration.executor);
+}
+
+- (void)testPerformancePool {
+    AWSExecutorPool *pool = [AWSExecutorPool defaultPool];
+    [self measureBlock:^{
+        dispatch_group_t group = dispatch_group_create();
+        for (NSUInteger i = 0; i < AWSExecutorPoolTestsBlockCount * 10; i++) {
+            dispatch_group_enter(group);
+            [pool execute:^{
+                dispatch_group_leave(group);
+            } qualityOfService:AWSExecutorQualityOfServiceUserInitiated];
+        }
+        dispatch_group_wait(group, DISPATCH_TIME_FOREVER);
+    }];
+}
+
+- (void)testPerformanceDispatchQueue {
+    dispatch_queue_t queue = dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0);
+    [self measureBlock:^{
+        dispatch_group_t group = dispatch_group_create();
+        for (NSUInteger i = 0; i < AWSExecutorPoolTestsBlockCount * 10; i++) {
+            dispatch_group_enter(group);
+            dispatch_async(queue, ^{
+                dispatch_group_leave(group);
+            });
+        }
+        dispatch_group_wait(group, DISPATCH_TIME_FOREVER);
+    }];
+}
+
+@end
@@ -0,0 +1,230 @@
+//
+// Copyright 2010-2021 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License.
+// A copy of the License is located at
+//
+// http://aws.amazon.com/apache2.0
+//
+// or in the "license" file accompanying this file. This file is distributed
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+//
+
+#import <XCTest/XCTest.h>
+#import <AWSCore/AWSCore.h>
+
+// The number of rows inserted and deleted by the benchmarks.
+static const NSUInteger AWSFMDBBulkUpdateTestsIterations = 10000;
+
+@interface AWSFMDBBulkUpdateTests : XCTestCase
+
+@property (nonatomic, strong) NSString *databasePath;
+@property (nonatomic, strong) AWSFMDatabaseQueue *databaseQueue;
+
+@end
+
+@implementation AWSFMDBBulkUpdateTests
+
+- (void)setUp {
+    [super setUp];
+    self.databasePath = [NSTemporaryDirectory() stringByAppendingPathComponent:[[NSUUID UUID] UUIDString]];
+    [self openDatabase];
+}
+
+- (void)tearDown {
+    [self removeDatabase];
+    [super tearDown];
+}
+
+- (void)openDatabase {
+    self.databaseQueue = [AWSFMDatabaseQueue storeDatabaseQueueWithPath:self.databasePath];
+    [self.databaseQueue inDatabase:^(AWSFMDatabase *db) {
+        XCTAssertTrue([db executeUpdate:@"CREATE TABLE IF NOT EXISTS record (name TEXT NOT NULL, data BLOB NOT NULL, retry_count INTEGER NOT NULL)"]);
+    }];
+}
+
+- (void)removeDatabase {
+    [self.databaseQueue close];
+    self.databaseQueue = nil;
+    for (NSString *suffix in @[@"", @"-wal", @"-shm", @"-journal"]) {
+        [[NSFileManager defaultManager] removeItemAtPath:[self.databasePath stringByAppendingString:suffix] error:nil];
+    }
+}
+
+- (NSArray<NSArray *> *)argumentArraysWithCount:(NSUInteger)count {
+    NSData *data = [NSMutableData dataWithLength:128];
+    NSMutableArray *argumentArrays = [NSMutableArray arrayWithCapacity:count];
+    for (NSUInteger i = 0; i < count; i++) {
+        [argumentArrays addObject:@[[NSString stringWithFormat:@"record-%lu", (unsigned long)i], data, @0]];
+    }
+    return argumentArrays;
+}
+
+- (NSArray<NSNumber *> *)rowIds {
+    NSMutableArray *rowIds = [NSMutableArray new];
+    [self.databaseQueue inDatabase:^(AWSFMDatabase *db) {
+        AWSFMResultSet *rs = [db executeQuery:@"SELECT rowid FROM record ORDER BY rowid"];
+        while ([rs next]) {
+            [rowIds addObject:@([rs longLongIntForColumn:@"rowid"])];
+        }
+        [rs close];
+    }];
+    return rowIds;
+}
+
+- (void)testExecuteUpdateWithArgumentArrays {
+    [self.databaseQueue inDatabase:^(AWSFMDatabase *db) {
+        XCTAssertTrue([db executeUpdate:@"INSERT INTO record (name, data, retry_count) VALUES (?, ?, ?)"
+                     withArgumentArrays:[self argumentArraysWithCount:100]]);
+        XCTAssertFalse([db inTransaction]);
+        XCTAssertEqual([db intForQuery:@"SELECT COUNT(*) FROM record"], 100);
+        XCTAssertEqualObjects([db stringForQuery:@"SELECT name FROM record ORDER BY rowid DESC LIMIT 1"], @"record-99");
+
+        XCTAssertTrue([db executeUpdate:@"UPDATE record SET retry_count = ? WHERE name = ?"
+                     withArgumentArrays:@[@[@1, @"record-0"], @[@2, @"record-1"]]]);
+        XCTAssertEqual([db intForQuery:@"SELECT SUM(retry_count) FROM record"], 3);
+
+        XCTAssertTrue([db executeUpdate:@"INSERT INTO record (name, data, retry_count) VALUES (?, ?, ?)"
+                     withArgumentArrays:@[]]);
+    }];
+}
+
+- (void)testExecuteUpdateWithArgumentArraysRollsBackOnError {
+    [self.databaseQueue inDatabase:^(AWSFMDatabase *db) {
+        NSMutableArray *argumentArrays = [[self argumentArraysWithCount:10] mutableCopy];
+        [argumentArrays addObject:@[@"record-10", [NSNull null], @0]];
+
+        XCTAssertFalse([db executeUpdate:@"INSERT INTO record (name, data, retry_count) VALUES (?, ?, ?)"
+                      withArgumentArrays:argumentArrays]);
+        XCTAssertEqual([db intForQuery:@"SELECT COUNT(*) FROM record"], 0);
+
+        XCTAssertFalse([db executeUpdate:@"INSERT INTO record (name, data, retry_count) VALUES (?, ?, ?)"
+                      withArgumentArrays:@[@[@"record-0", [NSData data]]]]);
+        XCTAssertEqual([db intForQuery:@"SELECT COUNT(*) FROM record"], 0);
+
+        // The statement is usable after a failure.
+        XCTAssertTrue([db executeUpdate:@"INSERT INTO record (name, data, retry_count) VALUES (?, ?, ?)"
+                     withArgumentArrays:[self argumentArraysWithCount:10]]);
+        XCTAssertEqual([db intForQuery:@"SELECT COUNT(*) FROM record"], 10);
+    }];
+}
+
+- (void)testExecuteUpdateWithArgumentArraysInTransaction {
+    [self.databaseQueue inTransaction:^(AWSFMDatabase *db, BOOL *rollback) {
+        XCTAssertTrue([db executeUpdate:@"INSERT INTO record (name, data, retry_count) VALUES (?, ?, ?)"
+                     withArgumentArrays:[self argumentArraysWithCount:10]]);
+        XCTAssertTrue([db inTransaction]);
+        *rollback = YES;
+    }];
+    [self.databaseQueue inDatabase:^(AWSFMDatabase *db) {
+        XCTAssertEqual([db intForQuery:@"SELECT COUNT(*) FROM record"], 0);
+    }];
+}
+
+- (void)testExecuteUpdateWithValuesInTemporaryTable {
+    [self.databaseQueue inDatabase:^(AWSFMDatabase *db) {
+        XCTAssertTrue([db executeUpdate:@"INSERT INTO record (name, data, retry_count) VALUES (?, ?, ?)"
+                     withArgumentArrays:[self argumentArraysWithCount:100]]);
+    }];
+    NSArray<NSNumber *> *rowIds = [self rowIds];
+
+    [self.databaseQueue inDatabase:^(AWSFMDatabase *db) {
+        NSMutableArray *evenRowIds = [NSMutableArray new];
+        for (NSNumber *rowId in rowIds) {
+            if ([rowId longLongValue] % 2 == 0) {
+                [evenRowIds addObject:rowId];
+            }
+        }
+        XCTAssertTrue([db executeUpdate:@"DELETE FROM record WHERE rowid IN aws_fmdb_values"
+             withValuesInTemporaryTable:evenRowIds]);
+        XCTAssertEqual([db intForQuery:@"SELECT COUNT(*) FROM record"], 50);
+        XCTAssertEqual([db intForQuery:@"SELECT COUNT(*) FROM aws_fmdb_values"], 0);
+
+        // Text values, duplicated values and values which match no row.
+        XCTAssertTrue([db executeUpdate:@"UPDATE record SET retry_count = retry_count + 1 WHERE name IN aws_fmdb_values"
+             withValuesInTemporaryTable:@[@"record-1", @"record-1", @"record-3", @"record-1000"]]);
+        XCTAssertEqual([db intForQuery:@"SELECT SUM(retry_count) FROM record"], 2);
+
+        XCTAssertFalse([db executeUpdate:@"DELETE FROM no_such_table WHERE rowid IN aws_fmdb_values"
+              withValuesInTemporaryTable:rowIds]);
+        XCTAssertEqual([db intForQuery:@"SELECT COUNT(*) FROM aws_fmdb_values"], 0);
+        XCTAssertEqual([db intForQuery:@"SELECT COUNT(*) FROM record"], 50);
+    }];
+}
+
+// Inserts one row per transaction, like the recorders and the Transfer Utility used to.
+// Compare with testPerformanceBulkInserts.
+- (void)testPerformanceRowByRowInserts {
+    NSArray<NSArray *> *argumentArrays = [self argumentArraysWithCount:AWSFMDBBulkUpdateTestsIterations];
+    [self measureMetrics:[[self class] defaultPerformanceMetrics] automaticallyStartMeasuring:NO forBlock:^{
+        [self removeDatabase];
+        [self openDatabase];
+
+        [self startMeasuring];
+        for (NSArray *arguments in argumentArrays) {
+            [self.databaseQueue inTransaction:^(AWSFMDatabase *db, BOOL *rollback) {
+                [db executeUpdate:@"INSERT INTO record (name, data, retry_count) VALUES (?, ?, ?)" withArgumentsInArray:arguments];
+            }];
+        }
+        [self stopMeasuring];
+    }];
+}
+
+- (void)testPerformanceBulkInserts {
+    NSArray<NSArray *> *argumentArrays = [self argumentArraysWithCount:AWSFMDBBulkUpdateTestsIterations];
+    [self measureMetrics:[[self class] defaultPerformanceMetrics] automaticallyStartMeasuring:NO forBlock:^{
+        [self removeDatabase];
+        [self openDatabase];
+
+        [self startMeasuring];
+        [self.databaseQueue inDatabase:^(AWSFMDatabase *db) {
+            [db executeUpdate:@"INSERT INTO record (name, data, retry_count) VALUES (?, ?, ?)" withArgumentArrays:argumentArrays];
+        }];
+        [self stopMeasuring];
+    }];
+}
+
+// Deletes rows by rowid one statement at a time in a single transaction, like the Kinesis recorder used to.
+// Compare with testPerformanceBulkDeletes.
+- (void)testPerformanceRowByRowDeletes {
+    NSArray<NSArray *> *argumentArrays = [self argumentArraysWithCount:AWSFMDBBulkUpdateTestsIterations];
+    [self measureMetrics:[[self class] defaultPerformanceMetrics] automaticallyStartMeasuring:NO forBlock:^{
+        [self removeDatabase];
+        [self openDatabase];
+        [self.databaseQueue inDatabase:^(AWSFMDatabase *db) {
+            [db executeUpdate:@"INSERT INTO record (name, data, retry_count) VALUES (?, ?, ?)" withArgumentArrays:argumentArrays];
+        }];
+        NSArray<NSNumber *> *rowIds = [self rowIds];
+
+        [self startMeasuring];
+        [self.databaseQueue inTransaction:^(AWSFMDatabase *db, BOOL *rollback) {
+            for (NSNumber *rowId in rowIds) {
+                [db executeUpdate:@"DELETE FROM record WHERE rowid = :rowid" withParameterDictionary:@{@"rowid" : rowId}];
+            }
+        }];
+        [self stopMeasuring];
+    }];
+}
+
+- (void)testPerformanceBulkDeletes {
+    NSArray<NSArray *> *argumentArrays = [self argumentArraysWithCount:AWSFMDBBulkUpdateTestsIterations];
+    [self measureMetrics:[[self class] defaultPerformanceMetrics] automaticallyStartMeasuring:NO forBlock:^{
+        [self removeDatabase];
+        [self openDatabase];
+        [self.databaseQueue inDatabase:^(AWSFMDatabase *db) {
+            [db executeUpdate:@"INSERT INTO record (name, data, retry_count) VALUES (?, ?, ?)" withArgumentArrays:argumentArrays];
+        }];
+        NSArray<NSNumber *> *rowIds = [self rowIds];
+
+        [self startMeasuring];
+        [self.databaseQueue inTransaction:^(AWSFMDatabase *db, BOOL *rollback) {
+            [db executeUpdate:@"DELETE FROM record WHERE rowid IN aws_fmdb_values" withValuesInTemporaryTable:rowIds];
+        }];
+        [self stopMeasuring];
+    }];
+}
+
+@end
@@ -0,0 +1,191 @@
+//
+// Copyright 2010-2021 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License.
+// A copy of the License is located at
+//
+// http://aws.amazon.com/apache2.0
+//
+// or in the "license" file accompanying this file. This file is distributed
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+//
+
+#import <XCTest/XCTest.h>
+#import <AWSCore/AWSCore.h>
+
+// The number of records written by the write benchmarks, one transaction each like the recorders do.
+static const NSUInteger AWSFMDBStoreProfileTestsIterations = 2000;
+
+@interface AWSFMDBStoreProfileTests : XCTestCase
+
+@property (nonatomic, strong) NSString *databasePath;
+
+@end
+
+@implementation AWSFMDBStoreProfileTests
+
+- (void)setUp {
+    [super setUp];
+    self.databasePath = [NSTemporaryDirectory() stringByAppendingPathComponent:[[NSUUID UUID] UUIDString]];
+}
+
+- (void)tearDown {
+    [self removeDatabase];
+    [super tearDown];
+}
+
+- (void)removeDatabase {
+    for (NSString *suffix in @[@"", @"-wal", @"-shm", @"-journal"]) {
+        [[NSFileManager defaultManager] removeItemAtPath:[self.databasePath stringByAppendingString:suffix] error:nil];
+    }
+}
+
+- (unsigned long long)fileSize {
+    return [[[NSFileManager defaultManager] attributesOfItemAtPath:self.databasePath error:nil] fileSize];
+}
+
+- (void)createRecordTableInDatabase:(AWSFMDatabase *)db {
+    XCTAssertTrue([db executeUpdate:@"CREATE TABLE IF NOT EXISTS record (data BLOB NOT NULL, timestamp REAL NOT NULL)"]);
+}
+
+- (void)insertRecordCount:(NSUInteger)count ofLength:(NSUInteger)length intoDatabaseQueue:(AWSFMDatabaseQueue *)databaseQueue {
+    NSMutableData *data = [NSMutableData dataWithLength:length];
+    for (NSUInteger i = 0; i < count; i++) {
+        [databaseQueue inDatabase:^(AWSFMDatabase *db) {
+            XCTAssertTrue([db executeUpdate:@"INSERT INTO record (data, timestamp) VALUES (?, ?)", data, @([[NSDate date] timeIntervalSince1970])]);
+        }];
+    }
+}
+
+- (void)testStoreProfile {
+    AWSFMDatabaseQueue *databaseQueue = [AWSFMDatabaseQueue storeDatabaseQueueWithPath:self.databasePath];
+    XCTAssertNotNil(databaseQueue);
+    [databaseQueue inDatabase:^(AWSFMDatabase *db) {
+        XCTAssertEqualObjects([[db stringForQuery:@"PRAGMA journal_mode"] lowercaseString], @"wal");
+        XCTAssertEqual([db intForQuery:@"PRAGMA synchronous"], 1);
+        XCTAssertEqual([db intForQuery:@"PRAGMA auto_vacuum"], 2);
+        XCTAssertTrue(db.shouldCacheStatements);
+    }];
+    [databaseQueue close];
+}
+
+- (void)testStoreProfileSwitchesExistingDatabaseToIncrementalVacuum {
+    AWSFMDatabaseQueue *databaseQueue = [AWSFMDatabaseQueue serialDatabaseQueueWithPath:self.databasePath];
+    [databaseQueue inDatabase:^(AWSFMDatabase *db) {
+        [self createRecordTableInDatabase:db];
+    }];
+    [self insertRecordCount:10 ofLength:100 intoDatabaseQueue:databaseQueue];
+    [databaseQueue inDatabase:^(AWSFMDatabase *db) {
+        XCTAssertEqual([db intForQuery:@"PRAGMA auto_vacuum"], 0);
+    }];
+    [databaseQueue close];
+
+    databaseQueue = [AWSFMDatabaseQueue storeDatabaseQueueWithPath:self.databasePath];
+    [databaseQueue inDatabase:^(AWSFMDatabase *db) {
+        XCTAssertEqual([db intForQuery:@"PRAGMA auto_vacuum"], 2);
+        XCTAssertEqual([db intForQuery:@"SELECT COUNT(*) FROM record"], 10);
+    }];
+    [databaseQueue close];
+}
+
+- (void)testFreePagesAreReleased {
+    AWSFMDatabaseQueue *databaseQueue = [AWSFMDatabaseQueue storeDatabaseQueueWithPath:self.databasePath];
+    [databaseQueue inDatabase:^(AWSFMDatabase *db) {
+        [self createRecordTableInDatabase:db];
+    }];
+    __block unsigned long long emptyByteCount = 0;
+    [databaseQueue inDatabase:^(AWSFMDatabase *db) {
+        emptyByteCount = [db aws_usedByteCount];
+    }];
+
+    [self insertRecordCount:1000 ofLength:1024 intoDatabaseQueue:databaseQueue];
+    [databaseQueue inDatabase:^(AWSFMDatabase *db) {
+        XCTAssertGreaterThan([db aws_usedByteCount], 1000 * 1024);
+        XCTAssertTrue([db executeUpdate:@"DELETE FROM record"]);
+        XCTAssertLessThan([db aws_usedByteCount], emptyByteCount + 16 * 1024);
+        XCTAssertGreaterThan([db intForQuery:@"PRAGMA freelist_count"], 0);
+
+        XCTAssertTrue([db aws_releaseFreePagesIfNeeded]);
+        XCTAssertEqual([db intForQuery:@"PRAGMA freelist_count"], 0);
+        XCTAssertTrue([db executeStatements:@"PRAGMA wal_checkpoint(TRUNCATE)"]);
+    }];
+    XCTAssertLessThan([self fileSize], 100 * 1024);
+    [databaseQueue close];
+}
+
+// Compare with testPerformanceStoreProfileWrites.
+- (void)testPerformanceDefaultWrites {
+    [self measureMetrics:[[self class] defaultPerformanceMetrics] automaticallyStartMeasuring:NO forBlock:^{
+        [self removeDatabase];
+        AWSFMDatabaseQueue *databaseQueue = [AWSFMDatabaseQueue serialDatabaseQueueWithPath:self.databasePath];
+        [databaseQueue inDatabase:^(AWSFMDatabase *db) {
+            [db executeStatements:@"PRAGMA auto_vacuum = FULL"];
+            [self createRecordTableInDatabase:db];
+        }];
+
+        [self startMeasuring];
+        [self insertRecordCount:AWSFMDBStoreProfileTestsIterations ofLength:1024 intoDatabaseQueue:databaseQueue];
+        [self stopMeasuring];
+        [databaseQueue close];
+    }];
+}
+
+- (void)testPerformanceStoreProfileWrites {
+    [self measureMetrics:[[self class] defaultPerformanceMetrics] automaticallyStartMeasuring:NO forBlock:^{
+        [self removeDatabase];
+        AWSFMDatabaseQueue *databaseQueue = [AWSFMDatabaseQueue storeDatabaseQueueWithPath:self.databasePath];
+        [databaseQueue inDatabase:^(AWSFMDatabase *db) {
+            [self createRecordTableInDatabase:db];
+        }];
+
+        [self startMeasuring];
+        [self insertRecordCount:AWSFMDBStoreProfileTestsIterations ofLength:1024 intoDatabaseQueue:databaseQueue];
+        [self stopMeasuring];
+        [databaseQueue close];
+    }];
+}
+
+// Opens a 5MB store the way the recorders used to: full auto vacuum and a VACUUM at every launch.
+// Compare with testPerformanceStoreProfileStartup.
+- (void)testPerformanceDefaultStartup {
+    AWSFMDatabaseQueue *databaseQueue = [AWSFMDatabaseQueue serialDatabaseQueueWithPath:self.databasePath];
+    [databaseQueue inDatabase:^(AWSFMDatabase *db) {
+        [db executeStatements:@"PRAGMA auto_vacuum = FULL"];
+        [self createRecordTableInDatabase:db];
+    }];
+    [self insertRecordCount:5 * 1024 ofLength:1024 intoDatabaseQueue:databaseQueue];
+    [databaseQueue close];
+
+    [self measureBlock:^{
+        AWSFMDatabaseQueue *databaseQueue = [AWSFMDatabaseQueue serialDatabaseQueueWithPath:self.databasePath];
+        [databaseQueue inDatabase:^(AWSFMDatabase *db) {
+            [db executeStatements:@"PRAGMA auto_vacuum = FULL"];
+            [self createRecordTableInDatabase:db];
+            [db executeUpdate:@"VACUUM"];
+        }];
+        [databaseQueue close];
+    }];
+}
+
+- (void)testPerformanceStoreProfileStartup {
+    AWSFMDatabaseQueue *databaseQueue = [AWSFMDatabaseQueue storeDatabaseQueueWithPath:self.databasePath];
+    [databaseQueue inDatabase:^(AWSFMDatabase *db) {
+        [self createRecordTableInDatabase:db];
+    }];
+    [self insertRecordCount:5 * 1024 ofLength:1024 intoDatabaseQueue:databaseQueue];
+    [databaseQueue close];
+
+    [self measureBlock:^{
+        AWSFMDatabaseQueue *databaseQueue = [AWSFMDatabaseQueue storeDatabaseQueueWithPath:self.databasePath];
+        [databaseQueue inDatabase:^(AWSFMDatabase *db) {
+            [self createRecordTableInDatabase:db];
+            [db aws_releaseFreePagesIfNeeded];
+        }];
+        [databaseQueue close];
+    }];
+}
+
+@end
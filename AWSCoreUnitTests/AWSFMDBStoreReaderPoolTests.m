@@ -0,0 +1,165 @@
+//
+// Copyright 2010-2021 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License.
+// A copy of the License is located at
+//
+// http://aws.amazon.com/apache2.0
+//
+// or in the "license" file accompanying this file. This file is distributed
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+//
+
+#import <XCTest/XCTest.h>
+#import <AWSCore/AWSCore.h>
+
+// The number of reads of each reader of the contention benchmarks.
+static const NSUInteger AWSFMDBStoreReaderPoolTestsIterations = 500;
+
+// The number of threads reading at the same time in the contention benchmarks.
+static const NSUInteger AWSFMDBStoreReaderPoolTestsReaderCount = 4;
+
+@interface AWSFMDBStoreReaderPoolTests : XCTestCase
+
+@property (nonatomic, strong) NSString *databasePath;
+@property (nonatomic, strong) AWSFMDatabaseQueue *databaseQueue;
+
+@end
+
+@implementation AWSFMDBStoreReaderPoolTests
+
+- (void)setUp {
+    [super setUp];
+    self.databasePath = [NSTemporaryDirectory() stringByAppendingPathComponent:[[NSUUID UUID] UUIDString]];
+    self.databaseQueue = [AWSFMDatabaseQueue storeDatabaseQueueWithPath:self.databasePath];
+    [self.databaseQueue inDatabase:^(AWSFMDatabase *db) {
+        XCTAssertTrue([db executeUpdate:@"CREATE TABLE IF NOT EXISTS record (data BLOB NOT NULL, timestamp REAL NOT NULL)"]);
+    }];
+}
+
+- (void)tearDown {
+    [self.databaseQueue close];
+    for (NSString *suffix in @[@"", @"-wal", @"-shm", @"-journal"]) {
+        [[NSFileManager defaultManager] removeItemAtPath:[self.databasePath stringByAppendingString:suffix] error:nil];
+    }
+    [super tearDown];
+}
+
+- (void)insertRecordCount:(NSUInteger)count {
+    NSData *data = [NSMutableData dataWithLength:1024];
+    [self.databaseQueue inTransaction:^(AWSFMDatabase *db, BOOL *rollback) {
+        for (NSUInteger i = 0; i < count; i++) {
+            XCTAssertTrue([db executeUpdate:@"INSERT INTO record (data, timestamp) VALUES (?, ?)", data, @([[NSDate date] timeIntervalSince1970])]);
+        }
+    }];
+}
+
+- (void)testReaderPoolReadsCommittedRecords {
+    AWSFMDatabasePool *databaseReaderPool = [AWSFMDatabasePool storeReaderPoolWithDatabaseQueue:self.databaseQueue];
+    XCTAssertNotNil(databaseReaderPool);
+    XCTAssertNil([AWSFMDatabasePool storeReaderPoolWithDatabaseQueue:nil]);
+
+    [self insertRecordCount:10];
+    [databaseReaderPool inDatabase:^(AWSFMDatabase *db) {
+        XCTAssertEqual([db intForQuery:@"SELECT COUNT(*) FROM record"], 10);
+        XCTAssertTrue(db.shouldCacheStatements);
+    }];
+
+    [self insertRecordCount:10];
+    [databaseReaderPool inDeferredTransaction:^(AWSFMDatabase *db, BOOL *rollback) {
+        XCTAssertEqual([db intForQuery:@"SELECT COUNT(*) FROM record"], 20);
+    }];
+    XCTAssertEqual([databaseReaderPool countOfOpenDatabases], 1);
+}
+
+- (void)testReaderPoolCannotWrite {
+    AWSFMDatabasePool *databaseReaderPool = [AWSFMDatabasePool storeReaderPoolWithDatabaseQueue:self.databaseQueue];
+    [databaseReaderPool inDatabase:^(AWSFMDatabase *db) {
+        XCTAssertFalse([db executeUpdate:@"INSERT INTO record (data, timestamp) VALUES (?, ?)", [NSData data], @0]);
+        XCTAssertEqual([db intForQuery:@"SELECT COUNT(*) FROM record"], 0);
+    }];
+}
+
+- (void)testReaderPoolDoesNotWaitForWriter {
+    AWSFMDatabasePool *databaseReaderPool = [AWSFMDatabasePool storeReaderPoolWithDatabaseQueue:self.databaseQueue];
+    [self insertRecordCount:10];
+
+    dispatch_semaphore_t writing = dispatch_semaphore_create(0);
+    dispatch_semaphore_t read = dispatch_semaphore_create(0);
+    XCTestExpectation *expectation = [self expectationWithDescription:@"The writer committed."];
+    dispatch_async(dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
+        [self.databaseQueue inTransaction:^(AWSFMDatabase *db, BOOL *rollback) {
+            XCTAssertTrue([db executeUpdate:@"DELETE FROM record"]);
+            dispatch_semaphore_signal(writing);
+            dispatch_semaphore_wait(read, DISPATCH_TIME_FOREVER);
+        }];
+        [expectation fulfill];
+    });
+
+    // The writer holds its transaction until the reader is done, so the read would deadlock on the database queue.
+    dispatch_semaphore_wait(writing, DISPATCH_TIME_FOREVER);
+    [databaseReaderPool inDatabase:^(AWSFMDatabase *db) {
+        XCTAssertEqual([db intForQuery:@"SELECT COUNT(*) FROM record"], 10);
+    }];
+    dispatch_semaphore_signal(read);
+    [self waitForExpectationsWithTimeout:10 handler:nil];
+
+    [databaseReaderPool inDatabase:^(AWSFMDatabase *db) {
+        XCTAssertEqual([db intForQuery:@"SELECT COUNT(*) FROM record"], 0);
+    }];
+}
+
+// Runs the readers while a writer inserts a record per transaction, and measures how long the readers take.
+- (void)measureContentionWithReadBlock:(void (^)(void))readBlock {
+    [self insertRecordCount:1000];
+
+    [self measureMetrics:[[self class] defaultPerformanceMetrics] automaticallyStartMeasuring:NO forBlock:^{
+        __block BOOL stop = NO;
+        dispatch_group_t writerGroup = dispatch_group_create();
+        dispatch_group_async(writerGroup, dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
+            NSData *data = [NSMutableData dataWithLength:1024];
+            while (!stop) {
+                [self.databaseQueue inTransaction:^(AWSFMDatabase *db, BOOL *rollback) {
+                    [db executeUpdate:@"INSERT INTO record (data, timestamp) VALUES (?, ?)", data, @([[NSDate date] timeIntervalSince1970])];
+                    [db executeUpdate:@"DELETE FROM record WHERE rowid = (SELECT MIN(rowid) FROM record)"];
+                }];
+            }
+        });
+
+        [self startMeasuring];
+        dispatch_apply(AWSFMDBStoreReaderPoolTestsReaderCount, dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^(size_t reader) {
+            for (NSUInteger i = 0; i < AWSFMDBStoreReaderPoolTestsIterations; i++) {
+                readBlock();
+            }
+        });
+        [self stopMeasuring];
+
+        stop = YES;
+        dispatch_group_wait(writerGroup, DISPATCH_TIME_FOREVER);
+    }];
+}
+
+// Compare with testPerformanceReaderPoolReads.
+- (void)testPerformanceDatabaseQueueReads {
+    [self measureContentionWithReadBlock:^{
+        [self.databaseQueue inDatabase:^(AWSFMDatabase *db) {
+            [db aws_usedByteCount];
+            [db intForQuery:@"SELECT COUNT(*) FROM record"];
+        }];
+    }];
+}
+
+- (void)testPerformanceReaderPoolReads {
+    AWSFMDatabasePool *databaseReaderPool = [AWSFMDatabasePool storeReaderPoolWithDatabaseQueue:self.databaseQueue];
+    [self measureContentionWithReadBlock:^{
+        [databaseReaderPool inDatabase:^(AWSFMDatabase *db) {
+            [db aws_usedByteCount];
+            [db intForQuery:@"SELECT COUNT(*) FROM record"];
+        }];
+    }];
+}
+
+@end
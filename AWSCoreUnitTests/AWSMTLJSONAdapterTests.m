@@ -0,0 +1,235 @@
+//
+// Copyright 2010-2021 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License.
+// A copy of the License is located at
+//
+// http://aws.amazon.com/apache2.0
+//
+// or in the "license" file accompanying this file. This file is distributed
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+//
+
+#import <XCTest/XCTest.h>
+#import <AWSCore/AWSCore.h>
+
+@interface AWSMTLJSONAdapterTestModel : AWSModel
+
+@property (nonatomic, strong) NSString *name;
+@property (nonatomic, strong) NSNumber *size;
+@property (nonatomic, strong) NSDate *lastModified;
+@property (nonatomic, strong) NSString *ownerName;
+@property (nonatomic, strong) NSString *ignored;
+@property (nonatomic, assign) NSInteger state;
+@property (nonatomic, assign) BOOL enabled;
+@property (nonatomic, assign) double ratio;
+@property (nonatomic, strong) AWSMTLJSONAdapterTestModel *child;
+@property (nonatomic, strong) NSArray<AWSMTLJSONAdapterTestModel *> *children;
+
+@end
+
+@implementation AWSMTLJSONAdapterTestModel
+
++ (NSDictionary *)JSONKeyPathsByPropertyKey {
+    return @{
+             @"name" : @"Name",
+             @"size" : @"Size",
+             @"lastModified" : @"LastModified",
+             @"ownerName" : @"Owner.DisplayName",
+             @"ignored" : [NSNull null],
+             @"state" : @"State",
+             @"enabled" : @"Enabled",
+             @"ratio" : @"Ratio",
+             @"child" : @"Child",
+             @"children" : @"Children",
+             };
+}
+
++ (NSValueTransformer *)lastModifiedJSONTransformer {
+    return [AWSMTLValueTransformer reversibleTransformerWithForwardBlock:^id(NSString *str) {
+        return [NSDate aws_dateFromString:str];
+    } reverseBlock:^id(NSDate *date) {
+        return [date aws_stringValue:AWSDateISO8601DateFormat1];
+    }];
+}
+
++ (NSValueTransformer *)stateJSONTransformer {
+    return [AWSMTLValueTransformer reversibleTransformerWithForwardBlock:^NSNumber *(NSString *value) {
+        return [value isEqualToString:@"ACTIVE"] ? @(1) : @(0);
+    } reverseBlock:^NSString *(NSNumber *value) {
+        return [value integerValue] == 1 ? @"ACTIVE" : @"INACTIVE";
+    }];
+}
+
++ (NSValueTransformer *)childJSONTransformer {
+    return [NSValueTransformer awsmtl_JSONDictionaryTransformerWithModelClass:[AWSMTLJSONAdapterTestModel class]];
+}
+
++ (NSValueTransformer *)childrenJSONTransformer {
+    return [NSValueTransformer awsmtl_JSONArrayTransformerWithModelClass:[AWSMTLJSONAdapterTestModel class]];
+}
+
+@end
+
+// A model with a validation method, which must still be called when parsing.
+@interface AWSMTLJSONAdapterValidatingTestModel : AWSMTLJSONAdapterTestModel
+
+@end
+
+@implementation AWSMTLJSONAdapterValidatingTestModel
+
+- (BOOL)validateName:(id *)ioValue error:(NSError **)error {
+    if ([*ioValue isEqualToString:@"invalid"]) {
+        if (error != NULL) {
+            *error = [NSError errorWithDomain:@"AWSMTLJSONAdapterTests" code:1 userInfo:nil];
+        }
+        return NO;
+    }
+    *ioValue = [*ioValue uppercaseString];
+    return YES;
+}
+
+@end
+
+// An adapter which reads the name from another key, to check that overrides are honored.
+@interface AWSMTLJSONAdapterTestAdapter : AWSMTLJSONAdapter
+
+@end
+
+@implementation AWSMTLJSONAdapterTestAdapter
+
+- (NSString *)JSONKeyPathForPropertyKey:(NSString *)key {
+    if ([key isEqualToString:@"name"]) {
+        return @"Title";
+    }
+    return [super JSONKeyPathForPropertyKey:key];
+}
+
+@end
+
+@interface AWSMTLJSONAdapterTests : XCTestCase
+
+@end
+
+@implementation AWSMTLJSONAdapterTests
+
+- (NSDictionary *)JSONDictionaryWithName:(NSString *)name {
+    return @{
+             @"Name" : name,
+             @"Size" : @(1024),
+             @"LastModified" : @"2019-01-02T03:45:06Z",
+             @"Owner" : @{@"DisplayName" : @"owner"},
+             @"ignored" : @"value",
+             @"State" : @"ACTIVE",
+             @"Enabled" : @(YES),
+             @"Ratio" : @(0.5),
+             @"Child" : @{@"Name" : @"child"},
+             @"Children" : @[@{@"Name" : @"first"}, @{@"Name" : @"second", @"Size" : [NSNull null]}],
+             };
+}
+
+- (void)testParsing {
+    NSError *error = nil;
+    AWSMTLJSONAdapterTestModel *model = [AWSMTLJSONAdapter modelOfClass:[AWSMTLJSONAdapterTestModel class]
+                                                      fromJSONDictionary:[self JSONDictionaryWithName:@"name"]
+                                                                   error:&error];
+    XCTAssertNil(error);
+    XCTAssertEqualObjects(model.name, @"name");
+    XCTAssertEqualObjects(model.size, @(1024));
+    XCTAssertEqualObjects(model.lastModified, [NSDate dateWithTimeIntervalSince1970:1546400706]);
+    XCTAssertEqualObjects(model.ownerName, @"owner");
+    XCTAssertNil(model.ignored);
+    XCTAssertEqual(model.state, 1);
+    XCTAssertTrue(model.enabled);
+    XCTAssertEqual(model.ratio, 0.5);
+    XCTAssertEqualObjects(model.child.name, @"child");
+    XCTAssertEqual([model.children count], 2);
+    XCTAssertEqualObjects(model.children[1].name, @"second");
+    XCTAssertNil(model.children[1].size);
+}
+
+- (void)testParsingNullAndMissingValues {
+    AWSMTLJSONAdapterTestModel *model = [AWSMTLJSONAdapter modelOfClass:[AWSMTLJSONAdapterTestModel class]
+                                                      fromJSONDictionary:@{@"Name" : [NSNull null], @"Owner" : @{}}
+                                                                   error:nil];
+    XCTAssertNotNil(model);
+    XCTAssertNil(model.name);
+    XCTAssertNil(model.ownerName);
+    XCTAssertEqual(model.state, 0);
+}
+
+- (void)testParsingCallsValidationMethods {
+    AWSMTLJSONAdapterValidatingTestModel *model = [AWSMTLJSONAdapter modelOfClass:[AWSMTLJSONAdapterValidatingTestModel class]
+                                                                fromJSONDictionary:[self JSONDictionaryWithName:@"name"]
+                                                                             error:nil];
+    XCTAssertEqualObjects(model.name, @"NAME");
+    XCTAssertEqual(model.state, 1);
+
+    NSError *error = nil;
+    model = [AWSMTLJSONAdapter modelOfClass:[AWSMTLJSONAdapterValidatingTestModel class]
+                         fromJSONDictionary:[self JSONDictionaryWithName:@"invalid"]
+                                      error:&error];
+    XCTAssertNil(model);
+    XCTAssertEqualObjects(error.domain, @"AWSMTLJSONAdapterTests");
+}
+
+- (void)testSerialization {
+    AWSMTLJSONAdapterTestModel *model = [AWSMTLJSONAdapter modelOfClass:[AWSMTLJSONAdapterTestModel class]
+                                                      fromJSONDictionary:[self JSONDictionaryWithName:@"name"]
+                                                                   error:nil];
+    NSDictionary *JSONDictionary = [AWSMTLJSONAdapter JSONDictionaryFromModel:model];
+    XCTAssertEqualObjects(JSONDictionary[@"Name"], @"name");
+    XCTAssertEqualObjects(JSONDictionary[@"LastModified"], @"2019-01-02T03:45:06Z");
+    XCTAssertEqualObjects(JSONDictionary[@"Owner"], @{@"DisplayName" : @"owner"});
+    XCTAssertEqualObjects(JSONDictionary[@"State"], @"ACTIVE");
+    XCTAssertNil(JSONDictionary[@"ignored"]);
+    XCTAssertEqualObjects([AWSMTLJSONAdapter modelOfClass:[AWSMTLJSONAdapterTestModel class] fromJSONDictionary:JSONDictionary error:nil], model);
+}
+
+- (void)testJSONKeyPathForPropertyKey {
+    AWSMTLJSONAdapterTestModel *model = [AWSMTLJSONAdapterTestModel new];
+    AWSMTLJSONAdapter *adapter = [[AWSMTLJSONAdapter alloc] initWithModel:model];
+    XCTAssertEqualObjects([adapter JSONKeyPathForPropertyKey:@"ownerName"], @"Owner.DisplayName");
+    XCTAssertNil([adapter JSONKeyPathForPropertyKey:@"ignored"]);
+    XCTAssertEqualObjects([adapter JSONKeyPathForPropertyKey:@"unmapped"], @"unmapped");
+}
+
+- (void)testSubclassOverridingJSONKeyPathForPropertyKey {
+    NSMutableDictionary *JSONDictionary = [[self JSONDictionaryWithName:@"name"] mutableCopy];
+    JSONDictionary[@"Title"] = @"title";
+
+    // The cached codec of the model class does not leak into the subclass, or the other way around.
+    AWSMTLJSONAdapterTestModel *model = [AWSMTLJSONAdapterTestAdapter modelOfClass:[AWSMTLJSONAdapterTestModel class]
+                                                                 fromJSONDictionary:JSONDictionary
+                                                                              error:nil];
+    XCTAssertEqualObjects(model.name, @"title");
+    XCTAssertEqualObjects(model.ownerName, @"owner");
+    XCTAssertEqual(model.state, 1);
+    XCTAssertEqualObjects([AWSMTLJSONAdapter modelOfClass:[AWSMTLJSONAdapterTestModel class] fromJSONDictionary:JSONDictionary error:nil].name, @"name");
+
+    NSDictionary *serialized = [AWSMTLJSONAdapterTestAdapter JSONDictionaryFromModel:model];
+    XCTAssertEqualObjects(serialized[@"Title"], @"title");
+    XCTAssertNil(serialized[@"Name"]);
+    XCTAssertEqualObjects(serialized[@"State"], @"ACTIVE");
+}
+
+- (void)testConcurrentParsing {
+    NSDictionary *JSONDictionary = [self JSONDictionaryWithName:@"name"];
+    __block NSUInteger failures = 0;
+    dispatch_apply(1000, dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^(size_t iteration) {
+        AWSMTLJSONAdapterTestModel *model = [AWSMTLJSONAdapter modelOfClass:[AWSMTLJSONAdapterTestModel class]
+                                                          fromJSONDictionary:JSONDictionary
+                                                                       error:nil];
+        if (![model.children[0].name isEqualToString:@"first"]) {
+            @synchronized (self) {
+                failures++;
+            }
+        }
+    });
+    XCTAssertEqual(failures, 0);
+}
+
+@end
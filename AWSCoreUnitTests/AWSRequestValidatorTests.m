@@ -0,0 +1,216 @@
+//
+// Copyright 2010-2021 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License.
+// A copy of the License is located at
+//
+// http://aws.amazon.com/apache2.0
+//
+// or in the "license" file accompanying this file. This file is distributed
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+//
+
+#import <XCTest/XCTest.h>
+#import <AWSCore/AWSCore.h>
+
+static const NSUInteger AWSRequestValidatorTestsItemCount = 10000;
+
+@interface AWSRequestValidatorTests : XCTestCase
+
+@end
+
+@implementation AWSRequestValidatorTests
+
+- (NSDictionary *)serviceDefinition {
+    static NSDictionary *serviceDefinition = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        serviceDefinition = @{
+                              @"operations" : @{
+                                      @"PutItems" : @{@"input" : @{@"shape" : @"PutItemsInput"}},
+                                      @"Describe" : @{@"input" : @{@"shape" : @"DescribeInput"}},
+                                      },
+                              @"shapes" : @{
+                                      @"PutItemsInput" : @{
+                                              @"type" : @"structure",
+                                              @"required" : @[@"TableName", @"Items"],
+                                              @"members" : @{
+                                                      @"TableName" : @{@"shape" : @"TableName"},
+                                                      @"Items" : @{@"shape" : @"ItemList"},
+                                                      @"Limit" : @{@"shape" : @"Limit"},
+                                                      @"Tags" : @{@"shape" : @"TagMap"},
+                                                      @"Filter" : @{@"shape" : @"Filter"},
+                                                      @"Payload" : @{@"shape" : @"Payload"},
+                                                      @"Comment" : @{@"shape" : @"String"},
+                                                      },
+                                              },
+                                      @"DescribeInput" : @{
+                                              @"type" : @"structure",
+                                              @"members" : @{@"Comment" : @{@"shape" : @"String"}},
+                                              },
+                                      @"TableName" : @{@"type" : @"string", @"min" : @(3), @"max" : @(8), @"pattern" : @"^[a-zA-Z0-9_.-]+$"},
+                                      @"ItemList" : @{@"type" : @"list", @"member" : @{@"shape" : @"Item"}, @"min" : @(1), @"max" : @(AWSRequestValidatorTestsItemCount)},
+                                      @"Item" : @{
+                                              @"type" : @"structure",
+                                              @"required" : @[@"Id"],
+                                              @"members" : @{
+                                                      @"Id" : @{@"shape" : @"Id"},
+                                                      @"Comment" : @{@"shape" : @"String"},
+                                                      },
+                                              },
+                                      @"Id" : @{@"type" : @"string", @"max" : @(4)},
+                                      @"Limit" : @{@"type" : @"integer", @"min" : @(1), @"max" : @(100)},
+                                      @"TagMap" : @{@"type" : @"map", @"key" : @{@"shape" : @"TagKey"}, @"value" : @{@"shape" : @"String"}, @"max" : @(2)},
+                                      @"TagKey" : @{@"type" : @"string", @"pattern" : @"^aws:"},
+                                      // A recursive shape, with the constraint only on the nested members.
+                                      @"Filter" : @{
+                                              @"type" : @"structure",
+                                              @"members" : @{
+                                                      @"And" : @{@"shape" : @"FilterList"},
+                                                      @"Value" : @{@"shape" : @"Id"},
+                                                      },
+                                              },
+                                      @"FilterList" : @{@"type" : @"list", @"member" : @{@"shape" : @"Filter"}},
+                                      @"Payload" : @{@"type" : @"blob", @"max" : @(4)},
+                                      @"String" : @{@"type" : @"string"},
+                                      },
+                              };
+    });
+    return serviceDefinition;
+}
+
+- (NSDictionary *)validParameters {
+    return @{
+             @"TableName" : @"table",
+             @"Items" : @[@{@"Id" : @"1"}, @{@"Id" : @"2", @"Comment" : @"comment"}],
+             @"Limit" : @(10),
+             @"Tags" : @{@"aws:key" : @"value"},
+             @"Filter" : @{@"And" : @[@{@"Value" : @"a"}, @{@"And" : @[@{@"Value" : @"b"}]}]},
+             @"Payload" : [@"data" dataUsingEncoding:NSUTF8StringEncoding],
+             };
+}
+
+- (NSError *)errorValidatingParameters:(NSDictionary *)parameters {
+    NSError *error = nil;
+    BOOL valid = [[AWSRequestValidator validatorForServiceDefinition:[self serviceDefinition]] validateParameters:parameters
+                                                                                                        actionName:@"PutItems"
+                                                                                                             error:&error];
+    XCTAssertEqual(valid, error == nil);
+    return error;
+}
+
+- (NSDictionary *)validParametersWithValue:(id)value forKey:(NSString *)key {
+    NSMutableDictionary *parameters = [[self validParameters] mutableCopy];
+    parameters[key] = value;
+    return parameters;
+}
+
+- (void)testValidParameters {
+    XCTAssertNil([self errorValidatingParameters:[self validParameters]]);
+}
+
+- (void)testValidatorIsCachedPerServiceDefinition {
+    XCTAssertEqual([AWSRequestValidator validatorForServiceDefinition:[self serviceDefinition]],
+                   [AWSRequestValidator validatorForServiceDefinition:[self serviceDefinition]]);
+}
+
+- (void)testOperationsWithoutConstraintsAreNotValidated {
+    AWSRequestValidator *validator = [AWSRequestValidator validatorForServiceDefinition:[self serviceDefinition]];
+    XCTAssertTrue([validator validateParameters:@{@"Comment" : @""} actionName:@"Describe" error:nil]);
+    XCTAssertTrue([validator validateParameters:@{} actionName:@"UnknownOperation" error:nil]);
+}
+
+- (void)testMissingRequiredParameter {
+    NSMutableDictionary *parameters = [[self validParameters] mutableCopy];
+    [parameters removeObjectForKey:@"TableName"];
+    NSError *error = [self errorValidatingParameters:parameters];
+    XCTAssertEqualObjects(error.domain, AWSValidationErrorDomain);
+    XCTAssertEqual(error.code, AWSValidationMissingRequiredParameter);
+    XCTAssertTrue([error.localizedDescription containsString:@"'TableName'"]);
+
+    error = [self errorValidatingParameters:[self validParametersWithValue:@[@{@"Id" : @"1"}, @{@"Comment" : @"no id"}] forKey:@"Items"]];
+    XCTAssertEqual(error.code, AWSValidationMissingRequiredParameter);
+    XCTAssertTrue([error.localizedDescription containsString:@"'Items[1].Id'"]);
+}
+
+- (void)testStringLength {
+    XCTAssertEqual([self errorValidatingParameters:[self validParametersWithValue:@"ab" forKey:@"TableName"]].code, AWSValidationInvalidStringParameter);
+    XCTAssertEqual([self errorValidatingParameters:[self validParametersWithValue:@"abcdefghi" forKey:@"TableName"]].code, AWSValidationInvalidStringParameter);
+    XCTAssertNil([self errorValidatingParameters:[self validParametersWithValue:@"abcdefgh" forKey:@"TableName"]]);
+
+    // The length is counted in code points, so four emoji fit into an Id of at most four characters.
+    NSMutableDictionary *parameters = [[self validParameters] mutableCopy];
+    parameters[@"Items"] = @[@{@"Id" : @"😀😀😀😀"}];
+    XCTAssertNil([self errorValidatingParameters:parameters]);
+    parameters[@"Items"] = @[@{@"Id" : @"😀😀😀😀😀"}];
+    XCTAssertTrue([[self errorValidatingParameters:parameters].localizedDescription containsString:@"'Items[0].Id'"]);
+}
+
+- (void)testPattern {
+    NSError *error = [self errorValidatingParameters:[self validParametersWithValue:@"tab le" forKey:@"TableName"]];
+    XCTAssertEqual(error.code, AWSValidationInvalidStringParameter);
+
+    error = [self errorValidatingParameters:[self validParametersWithValue:@{@"key" : @"value"} forKey:@"Tags"]];
+    XCTAssertEqual(error.code, AWSValidationInvalidStringParameter);
+    XCTAssertTrue([error.localizedDescription containsString:@"'Tags[key]'"]);
+}
+
+- (void)testRanges {
+    XCTAssertEqual([self errorValidatingParameters:[self validParametersWithValue:@(0) forKey:@"Limit"]].code, AWSValidationOutOfRangeParameter);
+    XCTAssertEqual([self errorValidatingParameters:[self validParametersWithValue:@(101) forKey:@"Limit"]].code, AWSValidationOutOfRangeParameter);
+    XCTAssertEqual([self errorValidatingParameters:[self validParametersWithValue:@[] forKey:@"Items"]].code, AWSValidationOutOfRangeParameter);
+    XCTAssertEqual([self errorValidatingParameters:[self validParametersWithValue:@{@"aws:a" : @"", @"aws:b" : @"", @"aws:c" : @""} forKey:@"Tags"]].code, AWSValidationOutOfRangeParameter);
+    XCTAssertEqual([self errorValidatingParameters:[self validParametersWithValue:[NSMutableData dataWithLength:5] forKey:@"Payload"]].code, AWSValidationOutOfRangeParameter);
+}
+
+- (void)testRecursiveShapes {
+    NSDictionary *filter = @{@"And" : @[@{@"Value" : @"a"}, @{@"And" : @[@{@"Value" : @"too long"}]}]};
+    NSError *error = [self errorValidatingParameters:[self validParametersWithValue:filter forKey:@"Filter"]];
+    XCTAssertEqual(error.code, AWSValidationInvalidStringParameter);
+    XCTAssertTrue([error.localizedDescription containsString:@"'Filter.And[1].And[0].Value'"]);
+}
+
+- (void)testInvalidPatternIsIgnored {
+    NSDictionary *serviceDefinition = @{
+                                        @"operations" : @{@"Get" : @{@"input" : @{@"shape" : @"GetInput"}}},
+                                        @"shapes" : @{
+                                                @"GetInput" : @{@"type" : @"structure", @"members" : @{@"Name" : @{@"shape" : @"Name"}}},
+                                                @"Name" : @{@"type" : @"string", @"pattern" : @"[a-z"},
+                                                },
+                                        };
+    XCTAssertTrue([[AWSRequestValidator validatorForServiceDefinition:serviceDefinition] validateParameters:@{@"Name" : @"name"}
+                                                                                                 actionName:@"Get"
+                                                                                                      error:nil]);
+}
+
+- (void)testRequestSerializerValidatesParameters {
+    AWSJSONRequestSerializer *serializer = [[AWSJSONRequestSerializer alloc] initWithJSONDefinition:[self serviceDefinition]
+                                                                                         actionName:@"PutItems"];
+    XCTAssertNil([serializer validateParameters:[self validParameters]].error);
+    XCTAssertEqual([serializer validateParameters:[self validParametersWithValue:@"ab" forKey:@"TableName"]].error.code, AWSValidationInvalidStringParameter);
+}
+
+- (void)testConfigurationCopiesValidatesRequestParameters {
+    AWSNetworkingConfiguration *configuration = [AWSNetworkingConfiguration new];
+    XCTAssertFalse(configuration.validatesRequestParameters);
+    configuration.validatesRequestParameters = YES;
+    XCTAssertTrue([(AWSNetworkingConfiguration *)[configuration copy] validatesRequestParameters]);
+}
+
+- (void)testPerformanceValidatingParameters {
+    NSMutableArray *items = [NSMutableArray arrayWithCapacity:AWSRequestValidatorTestsItemCount];
+    for (NSUInteger i = 0; i < AWSRequestValidatorTestsItemCount; i++) {
+        [items addObject:@{@"Id" : [NSString stringWithFormat:@"%lu", (unsigned long)(i % 1000)], @"Comment" : @"comment"}];
+    }
+    NSDictionary *parameters = [self validParametersWithValue:items forKey:@"Items"];
+    AWSRequestValidator *validator = [AWSRequestValidator validatorForServiceDefinition:[self serviceDefinition]];
+
+    [self measureBlock:^{
+        XCTAssertTrue([validator validateParameters:parameters actionName:@"PutItems" error:nil]);
+    }];
+}
+
+@end
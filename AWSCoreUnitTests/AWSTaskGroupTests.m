@@ -0,0 +1,294 @@
+//
+// Copyright 2010-2021 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License.
+// A copy of the License is located at
+//
+// http://aws.amazon.com/apache2.0
+//
+// or in the "license" file accompanying this file. This file is distributed
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+//
+
+#import <XCTest/XCTest.h>
+#import <AWSCore/AWSCore.h>
+#import <stdatomic.h>
+
+static const NSUInteger AWSTaskGroupTestsObjectCount = 1000;
+
+// An enumerator which creates its objects as they are read, and counts them.
+@interface AWSTaskGroupTestsEnumerator : NSEnumerator
+
+@property (nonatomic, assign) NSUInteger count;
+@property (nonatomic, assign) NSUInteger readCount;
+
+@end
+
+@implementation AWSTaskGroupTestsEnumerator
+
+- (id)nextObject {
+    if (self.readCount == self.count) {
+        return nil;
+    }
+    return @(self.readCount++);
+}
+
+@end
+
+@interface AWSTaskGroupTests : XCTestCase
+
+@end
+
+@implementation AWSTaskGroupTests
+
+- (NSArray *)numbersUpTo:(NSUInteger)count {
+    NSMutableArray *numbers = [NSMutableArray new];
+    for (NSUInteger i = 0; i < count; i++) {
+        [numbers addObject:@(i)];
+    }
+    return numbers;
+}
+
+- (void)testResultsInObjectOrder {
+    AWSTaskGroup *group = [AWSTaskGroup taskGroupWithMaximumConcurrency:4];
+    AWSTask<NSArray *> *task = [group runWithObjects:[self numbersUpTo:100] block:^AWSTask *(NSNumber *number, AWSCancellationToken *token) {
+        if ([number unsignedIntegerValue] % 10 == 0) {
+            return nil;
+        }
+        // Complete the tasks out of order.
+        return [[AWSTask taskWithDelay:arc4random_uniform(3)] continueWithSuccessBlock:^id(AWSTask *t) {
+            return @([number unsignedIntegerValue] * 2);
+        }];
+    }];
+    [task waitUntilFinished];
+
+    XCTAssertNil(task.error);
+    XCTAssertEqual([task.result count], 100);
+    for (NSUInteger i = 0; i < 100; i++) {
+        if (i % 10 == 0) {
+            XCTAssertEqualObjects(task.result[i], [NSNull null]);
+        } else {
+            XCTAssertEqualObjects(task.result[i], @(i * 2));
+        }
+    }
+}
+
+- (void)testEmptySequence {
+    AWSTask<NSArray *> *task = [[AWSTaskGroup taskGroupWithMaximumConcurrency:4] runWithObjects:@[] block:^AWSTask *(id object, AWSCancellationToken *token) {
+        XCTFail(@"No task should be started");
+        return nil;
+    }];
+    XCTAssertTrue(task.completed);
+    XCTAssertEqualObjects(task.result, @[]);
+}
+
+// Tasks which complete synchronously start the next one without recursing.
+- (void)testSynchronousTasks {
+    AWSTaskGroupTestsEnumerator *enumerator = [AWSTaskGroupTestsEnumerator new];
+    enumerator.count = AWSTaskGroupTestsObjectCount * 100;
+    AWSTask<NSArray *> *task = [[AWSTaskGroup taskGroupWithMaximumConcurrency:1] runWithEnumerator:enumerator block:^AWSTask *(NSNumber *number, AWSCancellationToken *token) {
+        return [AWSTask taskWithResult:number];
+    }];
+    XCTAssertTrue(task.completed);
+    XCTAssertEqual([task.result count], AWSTaskGroupTestsObjectCount * 100);
+}
+
+- (void)testMaximumConcurrencyAndLazyEnumeration {
+    AWSTaskGroupTestsEnumerator *enumerator = [AWSTaskGroupTestsEnumerator new];
+    enumerator.count = AWSTaskGroupTestsObjectCount;
+    NSMutableArray<AWSTaskCompletionSource *> *sources = [NSMutableArray new];
+    AWSTaskGroup *group = [AWSTaskGroup taskGroupWithMaximumConcurrency:3];
+    AWSTask<NSArray *> *task = [group runWithEnumerator:enumerator block:^AWSTask *(NSNumber *number, AWSCancellationToken *token) {
+        AWSTaskCompletionSource *source = [AWSTaskCompletionSource taskCompletionSource];
+        [sources addObject:source];
+        return source.task;
+    }];
+
+    // Completing the tasks one by one from the test thread starts the next ones synchronously.
+    for (NSUInteger i = 0; i < AWSTaskGroupTestsObjectCount; i++) {
+        XCTAssertEqual([sources count], MIN(i + 3, AWSTaskGroupTestsObjectCount));
+        XCTAssertEqual(enumerator.readCount, [sources count]);
+        XCTAssertFalse(task.completed);
+        sources[i].result = @(i);
+    }
+    XCTAssertTrue(task.completed);
+    XCTAssertEqual([task.result count], AWSTaskGroupTestsObjectCount);
+}
+
+- (void)testFailFast {
+    NSError *error = [NSError errorWithDomain:@"domain" code:1 userInfo:nil];
+    AWSTaskGroupTestsEnumerator *enumerator = [AWSTaskGroupTestsEnumerator new];
+    enumerator.count = AWSTaskGroupTestsObjectCount;
+    NSMutableArray<AWSTaskCompletionSource *> *sources = [NSMutableArray new];
+    NSMutableArray<AWSCancellationToken *> *tokens = [NSMutableArray new];
+    AWSTaskGroup *group = [AWSTaskGroup taskGroupWithMaximumConcurrency:4];
+    AWSTask<NSArray *> *task = [group runWithEnumerator:enumerator block:^AWSTask *(NSNumber *number, AWSCancellationToken *token) {
+        AWSTaskCompletionSource *source = [AWSTaskCompletionSource taskCompletionSource];
+        [sources addObject:source];
+        [tokens addObject:token];
+        return source.task;
+    }];
+
+    sources[1].error = error;
+    // No task is started after the failure, and the running ones are told to stop.
+    XCTAssertEqual([sources count], 4);
+    XCTAssertEqual(enumerator.readCount, 4);
+    XCTAssertTrue(tokens[0].cancellationRequested);
+    XCTAssertFalse(task.completed);
+
+    // The group completes once the running tasks complete.
+    sources[0].result = nil;
+    [sources[2] cancel];
+    XCTAssertFalse(task.completed);
+    sources[3].error = [NSError errorWithDomain:@"domain" code:2 userInfo:nil];
+    XCTAssertTrue(task.completed);
+    XCTAssertEqualObjects(task.error, error);
+}
+
+- (void)testCollectAll {
+    AWSTaskGroup *group = [AWSTaskGroup taskGroupWithMaximumConcurrency:4];
+    group.errorMode = AWSTaskGroupErrorModeCollectAll;
+    atomic_uint startedCount = 0;
+    atomic_uint *started = &startedCount;
+    AWSTask<NSArray *> *task = [group runWithObjects:[self numbersUpTo:100] block:^AWSTask *(NSNumber *number, AWSCancellationToken *token) {
+        atomic_fetch_add(started, 1);
+        XCTAssertFalse(token.cancellationRequested);
+        if ([number unsignedIntegerValue] % 25 == 0) {
+            return [AWSTask taskWithError:[NSError errorWithDomain:@"domain" code:[number integerValue] userInfo:nil]];
+        }
+        return [AWSTask taskWithResult:number];
+    }];
+    [task waitUntilFinished];
+
+    XCTAssertEqual(atomic_load(started), 100);
+    XCTAssertEqualObjects(task.error.domain, AWSTaskErrorDomain);
+    XCTAssertEqual(task.error.code, kAWSMultipleErrorsError);
+    NSArray<NSError *> *errors = task.error.userInfo[AWSTaskMultipleErrorsUserInfoKey];
+    XCTAssertEqual([errors count], 4);
+    XCTAssertEqualObjects([errors valueForKey:@"code"], (@[@0, @25, @50, @75]));
+
+    task = [group runWithObjects:@[@1, @2] block:^AWSTask *(NSNumber *number, AWSCancellationToken *token) {
+        return [number isEqual:@1] ? [AWSTask cancelledTask] : [AWSTask taskWithResult:number];
+    }];
+    XCTAssertTrue(task.cancelled);
+}
+
+- (void)testCancellation {
+    AWSCancellationTokenSource *cancellationTokenSource = [AWSCancellationTokenSource cancellationTokenSource];
+    AWSTaskGroupTestsEnumerator *enumerator = [AWSTaskGroupTestsEnumerator new];
+    enumerator.count = AWSTaskGroupTestsObjectCount;
+    NSMutableArray<AWSTaskCompletionSource *> *sources = [NSMutableArray new];
+    AWSTaskGroup *group = [AWSTaskGroup taskGroupWithMaximumConcurrency:2];
+    group.cancellationToken = cancellationTokenSource.token;
+    AWSTask<NSArray *> *task = [group runWithEnumerator:enumerator block:^AWSTask *(NSNumber *number, AWSCancellationToken *token) {
+        AWSTaskCompletionSource *source = [AWSTaskCompletionSource taskCompletionSource];
+        [sources addObject:source];
+        [token registerCancellationObserverWithBlock:^{
+            [source trySetCancelled];
+        }];
+        return source.task;
+    }];
+
+    sources[0].result = nil;
+    XCTAssertEqual([sources count], 3);
+    [cancellationTokenSource cancel];
+    XCTAssertEqual([sources count], 3);
+    XCTAssertTrue(task.cancelled);
+
+    // A cancelled token stops the group before it starts any task.
+    task = [group runWithObjects:[self numbersUpTo:10] block:^AWSTask *(id object, AWSCancellationToken *token) {
+        XCTFail(@"No task should be started");
+        return nil;
+    }];
+    XCTAssertTrue(task.cancelled);
+}
+
+- (void)testProgress {
+    AWSTaskGroup *group = [AWSTaskGroup taskGroupWithMaximumConcurrency:8];
+    group.errorMode = AWSTaskGroupErrorModeCollectAll;
+    NSMutableArray<NSArray *> *reports = [NSMutableArray new];
+    group.progressBlock = ^(NSUInteger completedCount, NSUInteger faultedCount) {
+        [reports addObject:@[@(completedCount), @(faultedCount)]];
+    };
+    AWSTask *task = [group runWithObjects:[self numbersUpTo:100] block:^AWSTask *(NSNumber *number, AWSCancellationToken *token) {
+        return [[AWSTask taskWithDelay:1] continueWithBlock:^id(AWSTask *t) {
+            if ([number unsignedIntegerValue] % 2 == 0) {
+                return [AWSTask taskWithError:[NSError errorWithDomain:@"domain" code:0 userInfo:nil]];
+            }
+            return number;
+        }];
+    }];
+    [task waitUntilFinished];
+
+    XCTAssertEqual([reports count], 100);
+    NSUInteger previousFaultedCount = 0;
+    for (NSUInteger i = 0; i < [reports count]; i++) {
+        XCTAssertEqualObjects(reports[i][0], @(i + 1));
+        XCTAssertGreaterThanOrEqual([reports[i][1] unsignedIntegerValue], previousFaultedCount);
+        previousFaultedCount = [reports[i][1] unsignedIntegerValue];
+    }
+    XCTAssertEqualObjects([reports lastObject], (@[@100, @50]));
+}
+
+// Completes the tasks of many groups from many threads at once, and checks that
+// the maximum concurrency holds and that every task runs exactly once.
+- (void)testConcurrentCompletion {
+    for (NSUInteger iteration = 0; iteration < 20; iteration++) {
+        atomic_uint runningCount = 0;
+        atomic_uint maximumRunningCount = 0;
+        atomic_uint runCount = 0;
+        atomic_uint *running = &runningCount;
+        atomic_uint *maximumRunning = &maximumRunningCount;
+        atomic_uint *runs = &runCount;
+
+        AWSTaskGroup *group = [AWSTaskGroup taskGroupWithMaximumConcurrency:5];
+        AWSTask<NSArray *> *task = [group runWithObjects:[self numbersUpTo:AWSTaskGroupTestsObjectCount] block:^AWSTask *(NSNumber *number, AWSCancellationToken *token) {
+            return [AWSTask taskFromExecutor:[AWSExecutor defaultExecutor] withBlock:^id{
+                unsigned int current = atomic_fetch_add(running, 1) + 1;
+                unsigned int maximum = atomic_load(maximumRunning);
+                while (current > maximum && !atomic_compare_exchange_weak(maximumRunning, &maximum, current)) {
+                }
+                atomic_fetch_add(runs, 1);
+                atomic_fetch_sub(running, 1);
+                return number;
+            }];
+        }];
+        [task waitUntilFinished];
+
+        XCTAssertNil(task.error);
+        XCTAssertEqual([task.result count], AWSTaskGroupTestsObjectCount);
+        XCTAssertEqual(atomic_load(runs), AWSTaskGroupTestsObjectCount);
+        XCTAssertLessThanOrEqual(atomic_load(maximumRunning), 5);
+    }
+}
+
+- (void)testPerformanceTaskGroup {
+    NSArray *numbers = [self numbersUpTo:AWSTaskGroupTestsObjectCount * 10];
+    AWSTaskGroup *group = [AWSTaskGroup taskGroupWithMaximumConcurrency:8];
+    [self measureBlock:^{
+        AWSTask *task = [group runWithObjects:numbers block:^AWSTask *(NSNumber *number, AWSCancellationToken *token) {
+            return [AWSTask taskFromExecutor:[AWSExecutor defaultExecutor] withBlock:^id{
+                return number;
+            }];
+        }];
+        [task waitUntilFinished];
+    }];
+}
+
+- (void)testPerformanceTaskForCompletionOfAllTasks {
+    NSArray *numbers = [self numbersUpTo:AWSTaskGroupTestsObjectCount * 10];
+    [self measureBlock:^{
+        NSMutableArray *tasks = [NSMutableArray new];
+        for (NSNumber *number in numbers) {
+            [tasks addObject:[AWSTask taskFromExecutor:[AWSExecutor defaultExecutor] withBlock:^id{
+                return number;
+            }]];
+        }
+        [[AWSTask taskForCompletionOfAllTasksWithResults:tasks] waitUntilFinished];
+    }];
+}
+
+@end
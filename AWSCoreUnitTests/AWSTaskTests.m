@@ -0,0 +1,262 @@
+//
+// Copyright 2010-2021 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License.
+// A copy of the License is located at
+//
+// http://aws.amazon.com/apache2.0
+//
+// or in the "license" file accompanying this file. This file is distributed
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+//
+
+#import <XCTest/XCTest.h>
+#import <AWSCore/AWSCore.h>
+#import <stdatomic.h>
+
+static const NSUInteger AWSTaskTestsIterations = 1000;
+static const NSUInteger AWSTaskTestsContinuationCount = 16;
+
+@interface AWSTaskTests : XCTestCase
+
+@end
+
+@implementation AWSTaskTests
+
+- (void)testCompletedTasks {
+    AWSTask *task = [AWSTask taskWithResult:@"result"];
+    XCTAssertTrue(task.completed);
+    XCTAssertFalse(task.faulted);
+    XCTAssertFalse(task.cancelled);
+    XCTAssertEqualObjects(task.result, @"result");
+    XCTAssertNil(task.error);
+
+    NSError *error = [NSError errorWithDomain:@"domain" code:1 userInfo:nil];
+    task = [AWSTask taskWithError:error];
+    XCTAssertTrue(task.completed);
+    XCTAssertTrue(task.faulted);
+    XCTAssertNil(task.result);
+    XCTAssertEqualObjects(task.error, error);
+
+    task = [AWSTask cancelledTask];
+    XCTAssertTrue(task.completed);
+    XCTAssertTrue(task.cancelled);
+    XCTAssertFalse(task.faulted);
+    XCTAssertTrue([[task description] containsString:@"cancelled = YES"]);
+}
+
+- (void)testOnlyFirstCompletionWins {
+    AWSTaskCompletionSource *source = [AWSTaskCompletionSource taskCompletionSource];
+    XCTAssertFalse(source.task.completed);
+    XCTAssertNil(source.task.result);
+    XCTAssertTrue([source trySetResult:@(1)]);
+    XCTAssertFalse([source trySetResult:@(2)]);
+    XCTAssertFalse([source trySetError:[NSError errorWithDomain:@"domain" code:1 userInfo:nil]]);
+    XCTAssertFalse([source trySetCancelled]);
+    XCTAssertEqualObjects(source.task.result, @(1));
+    XCTAssertFalse(source.task.faulted);
+    XCTAssertFalse(source.task.cancelled);
+}
+
+- (void)testContinuationsRunInRegistrationOrder {
+    AWSTaskCompletionSource *source = [AWSTaskCompletionSource taskCompletionSource];
+    NSMutableArray *order = [NSMutableArray new];
+    for (NSUInteger i = 0; i < AWSTaskTestsContinuationCount; i++) {
+        [source.task continueWithExecutor:[AWSExecutor immediateExecutor] withBlock:^id(AWSTask *task) {
+            [order addObject:@(i)];
+            return nil;
+        }];
+    }
+    XCTAssertEqual([order count], 0);
+    source.result = nil;
+
+    XCTAssertEqual([order count], AWSTaskTestsContinuationCount);
+    for (NSUInteger i = 0; i < AWSTaskTestsContinuationCount; i++) {
+        XCTAssertEqualObjects(order[i], @(i));
+    }
+}
+
+- (void)testContinuationRegisteredFromContinuationRuns {
+    AWSTaskCompletionSource *source = [AWSTaskCompletionSource taskCompletionSource];
+    __block BOOL ranNestedContinuation = NO;
+    [source.task continueWithExecutor:[AWSExecutor immediateExecutor] withBlock:^id(AWSTask *task) {
+        [task continueWithExecutor:[AWSExecutor immediateExecutor] withBlock:^id(AWSTask *nestedTask) {
+            ranNestedContinuation = YES;
+            return nil;
+        }];
+        return nil;
+    }];
+    source.result = nil;
+    XCTAssertTrue(ranNestedContinuation);
+}
+
+// The continuation of the outer task completes the inner task, whose continuation waits for a
+// continuation registered on the outer task while its continuations are still running.
+- (void)testContinuationRegisteredFromNestedCompletionRuns {
+    AWSTaskCompletionSource *outerSource = [AWSTaskCompletionSource taskCompletionSource];
+    AWSTaskCompletionSource *innerSource = [AWSTaskCompletionSource taskCompletionSource];
+    __block BOOL ranNestedContinuation = NO;
+    [innerSource.task continueWithExecutor:[AWSExecutor immediateExecutor] withBlock:^id(AWSTask *task) {
+        [[outerSource.task continueWithExecutor:[AWSExecutor immediateExecutor] withBlock:^id(AWSTask *outerTask) {
+            ranNestedContinuation = YES;
+            return nil;
+        }] waitUntilFinished];
+        return nil;
+    }];
+    [outerSource.task continueWithExecutor:[AWSExecutor immediateExecutor] withBlock:^id(AWSTask *task) {
+        innerSource.result = nil;
+        return nil;
+    }];
+    outerSource.result = nil;
+    XCTAssertTrue(ranNestedContinuation);
+}
+
+- (void)testWaitUntilFinished {
+    AWSTaskCompletionSource *source = [AWSTaskCompletionSource taskCompletionSource];
+    dispatch_after(dispatch_time(DISPATCH_TIME_NOW, 10 * NSEC_PER_MSEC), dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
+        source.result = @"result";
+    });
+    [source.task waitUntilFinished];
+    XCTAssertEqualObjects(source.task.result, @"result");
+
+    // Returns right away once the task is completed.
+    [source.task waitUntilFinished];
+}
+
+// Completes each task from several threads at once while other threads register
+// continuations and read its state, and checks that exactly one completion wins,
+// that every continuation runs exactly once, and that a completed task is never
+// observed without its result.
+- (void)testConcurrentCompletionAndContinuations {
+    for (NSUInteger iteration = 0; iteration < AWSTaskTestsIterations; iteration++) {
+        AWSTaskCompletionSource *source = [AWSTaskCompletionSource taskCompletionSource];
+        AWSTask *task = source.task;
+        // dispatch_apply returns after all of its iterations, so the counters can live on the stack.
+        atomic_uint winCount = 0;
+        atomic_uint continuationRunCount = 0;
+        atomic_uint inconsistentReadCount = 0;
+        atomic_uint *wins = &winCount;
+        atomic_uint *continuationRuns = &continuationRunCount;
+        atomic_uint *inconsistentReads = &inconsistentReadCount;
+
+        dispatch_apply(AWSTaskTestsContinuationCount, dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^(size_t i) {
+            switch (i % 4) {
+                case 0:
+                    if ([source trySetResult:@(i)]) {
+                        atomic_fetch_add(wins, 1);
+                    }
+                    break;
+                case 1:
+                    if ([source trySetError:[NSError errorWithDomain:@"domain" code:i userInfo:nil]]) {
+                        atomic_fetch_add(wins, 1);
+                    }
+                    break;
+                case 2:
+                    if (task.completed && !task.result && !task.error && !task.cancelled) {
+                        atomic_fetch_add(inconsistentReads, 1);
+                    }
+                    break;
+                default:
+                    break;
+            }
+            [task continueWithExecutor:[AWSExecutor immediateExecutor] withBlock:^id(AWSTask *t) {
+                if (!t.completed || (!t.result && !t.error)) {
+                    atomic_fetch_add(inconsistentReads, 1);
+                }
+                atomic_fetch_add(continuationRuns, 1);
+                return nil;
+            }];
+        });
+
+        XCTAssertEqual(atomic_load(wins), 1);
+        XCTAssertEqual(atomic_load(continuationRuns), AWSTaskTestsContinuationCount);
+        XCTAssertEqual(atomic_load(inconsistentReads), 0);
+        XCTAssertNotEqual(task.result != nil, task.faulted);
+    }
+}
+
+// Registers continuations from one thread while another thread completes the task, and checks that
+// the continuations registered around the completion still run in the order they were registered.
+- (void)testContinuationsRegisteredDuringCompletionRunInOrder {
+    for (NSUInteger iteration = 0; iteration < AWSTaskTestsIterations; iteration++) {
+        AWSTaskCompletionSource *source = [AWSTaskCompletionSource taskCompletionSource];
+        NSMutableArray *order = [NSMutableArray new];
+        dispatch_apply(2, dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^(size_t i) {
+            if (i == 0) {
+                source.result = nil;
+                return;
+            }
+            for (NSUInteger j = 0; j < AWSTaskTestsContinuationCount; j++) {
+                [source.task continueWithExecutor:[AWSExecutor immediateExecutor] withBlock:^id(AWSTask *task) {
+                    @synchronized(order) {
+                        [order addObject:@(j)];
+                    }
+                    return nil;
+                }];
+            }
+        });
+
+        XCTAssertEqual([order count], AWSTaskTestsContinuationCount);
+        for (NSUInteger j = 0; j < [order count]; j++) {
+            XCTAssertEqualObjects(order[j], @(j));
+        }
+    }
+}
+
+- (void)completeTaskCompletionSource:(AWSTaskCompletionSource *)source {
+    source.result = @"result";
+}
+
+- (void)testConcurrentWaitUntilFinished {
+    for (NSUInteger iteration = 0; iteration < AWSTaskTestsIterations / 10; iteration++) {
+        AWSTaskCompletionSource *source = [AWSTaskCompletionSource taskCompletionSource];
+        // Complete the task from a thread of its own, as the waiters may block all of the workers of dispatch_apply.
+        [NSThread detachNewThreadSelector:@selector(completeTaskCompletionSource:) toTarget:self withObject:source];
+        atomic_uint mismatchCount = 0;
+        atomic_uint *mismatches = &mismatchCount;
+        dispatch_apply(AWSTaskTestsContinuationCount, dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^(size_t i) {
+            [source.task waitUntilFinished];
+            if (![source.task.result isEqual:@"result"]) {
+                atomic_fetch_add(mismatches, 1);
+            }
+        });
+        XCTAssertEqual(atomic_load(mismatches), 0);
+    }
+}
+
+- (void)testPerformanceReadingCompletedTask {
+    AWSTask *task = [AWSTask taskWithResult:@"result"];
+    [self measureBlock:^{
+        dispatch_apply(8, dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^(size_t i) {
+            for (NSUInteger j = 0; j < 100000; j++) {
+                if (!task.completed || task.faulted || task.cancelled || !task.result) {
+                    XCTFail(@"Unexpected task state");
+                }
+            }
+        });
+    }];
+}
+
+- (void)testPerformanceContinuationChains {
+    [self measureBlock:^{
+        dispatch_apply(8, dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^(size_t i) {
+            for (NSUInteger j = 0; j < AWSTaskTestsIterations; j++) {
+                @autoreleasepool {
+                    AWSTaskCompletionSource *source = [AWSTaskCompletionSource taskCompletionSource];
+                    AWSTask *task = source.task;
+                    for (NSUInteger k = 0; k < 4; k++) {
+                        task = [task continueWithExecutor:[AWSExecutor immediateExecutor] withSuccessBlock:^id(AWSTask *t) {
+                            return t.result;
+                        }];
+                    }
+                    source.result = @(j);
+                }
+            }
+        });
+    }];
+}
+
+@end
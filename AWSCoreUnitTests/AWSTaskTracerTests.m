@@ -0,0 +1,180 @@
+//
+// Copyright 2010-2021 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License.
+// A copy of the License is located at
+//
+// http://aws.amazon.com/apache2.0
+//
+// or in the "license" file accompanying this file. This file is distributed
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+//
+
+#import <XCTest/XCTest.h>
+#import <AWSCore/AWSCore.h>
+
+static const NSUInteger AWSTaskTracerTestsIterations = 100000;
+
+@interface AWSTaskTracerTests : XCTestCase
+
+@end
+
+@implementation AWSTaskTracerTests
+
+- (void)tearDown {
+    AWSTaskTracer.sink = nil;
+    [super tearDown];
+}
+
+// Events are recorded right after their block returns, which can be after the task or expectation it completes.
+- (void)waitForEventCount:(NSUInteger)count sink:(AWSChromeTraceSink *)sink {
+    for (NSUInteger i = 0; i < 1000 && [[sink events] count] < count; i++) {
+        usleep(1000);
+    }
+}
+
+- (void)testNoEventsWithoutSink {
+    AWSChromeTraceSink *sink = [AWSChromeTraceSink new];
+    AWSTaskTracer.sink = sink;
+    AWSTaskTracer.sink = nil;
+
+    [[[AWSTask taskWithResult:nil] continueWithBlock:^id(AWSTask *task) {
+        return nil;
+    }] waitUntilFinished];
+    XCTAssertEqual([[sink events] count], 0);
+}
+
+- (void)testContinuationEvents {
+    AWSChromeTraceSink *sink = [AWSChromeTraceSink new];
+    AWSTaskTracer.sink = sink;
+
+    AWSTaskCompletionSource *source = [AWSTaskCompletionSource taskCompletionSource];
+    __block AWSTask *task = nil;
+    [AWSTaskTracer runWithOperationName:@"PutItem" block:^{
+        task = [source.task continueWithExecutor:[AWSExecutor executorWithDispatchQueue:dispatch_get_global_queue(QOS_CLASS_UTILITY, 0)] withBlock:^id(AWSTask *t) {
+            usleep(1000);
+            return nil;
+        }];
+    }];
+    // The continuation of the returned task is attributed to the operation as well.
+    task = [task continueWithBlock:^id(AWSTask *t) {
+        return nil;
+    }];
+    source.result = nil;
+    [task waitUntilFinished];
+    [self waitForEventCount:2 sink:sink];
+
+    // The second continuation runs within the first one, so its event is recorded first.
+    NSArray<AWSTaskTraceEvent *> *events = [sink events];
+    XCTAssertEqual([events count], 2);
+    for (AWSTaskTraceEvent *event in events) {
+        XCTAssertEqual(event.type, AWSTaskTraceEventTypeContinuation);
+        XCTAssertEqualObjects(event.operationName, @"PutItem");
+        XCTAssertLessThanOrEqual(event.enqueueTime, event.startTime);
+        XCTAssertLessThanOrEqual(event.startTime, event.endTime);
+        XCTAssertGreaterThan(event.threadID, 0);
+    }
+    XCTAssertGreaterThanOrEqual(events[1].endTime - events[1].startTime, 1000 * NSEC_PER_USEC);
+    XCTAssertLessThanOrEqual(events[1].startTime, events[0].enqueueTime);
+}
+
+- (void)testExecutionEvents {
+    AWSChromeTraceSink *sink = [AWSChromeTraceSink new];
+    AWSTaskTracer.sink = sink;
+
+    XCTestExpectation *expectation = [self expectationWithDescription:@"execute"];
+    [AWSTaskTracer runWithOperationName:@"Upload" block:^{
+        [[AWSExecutor executorWithDispatchQueue:dispatch_get_global_queue(QOS_CLASS_UTILITY, 0)] execute:^{
+            [expectation fulfill];
+        }];
+    }];
+    [self waitForExpectationsWithTimeout:5 handler:nil];
+    [self waitForEventCount:1 sink:sink];
+
+    NSArray<AWSTaskTraceEvent *> *events = [sink events];
+    XCTAssertEqual([events count], 1);
+    XCTAssertEqual(events[0].type, AWSTaskTraceEventTypeExecution);
+    XCTAssertEqualObjects(events[0].operationName, @"Upload");
+}
+
+- (void)testChromeTrace {
+    AWSChromeTraceSink *sink = [[AWSChromeTraceSink alloc] initWithMaximumEventCount:2];
+    [sink recordEvent:[[AWSTaskTraceEvent alloc] initWithType:AWSTaskTraceEventTypeContinuation
+                                                operationName:@"GetItem"
+                                                  enqueueTime:1000
+                                                    startTime:3000
+                                                      endTime:7000
+                                                     threadID:42]];
+    [sink recordEvent:[[AWSTaskTraceEvent alloc] initWithType:AWSTaskTraceEventTypeNetwork
+                                                operationName:@"GetItem"
+                                                  enqueueTime:10000
+                                                    startTime:10000
+                                                      endTime:50000
+                                                     threadID:43]];
+    [sink recordEvent:[[AWSTaskTraceEvent alloc] initWithType:AWSTaskTraceEventTypeExecution
+                                                operationName:nil
+                                                  enqueueTime:0
+                                                    startTime:0
+                                                      endTime:0
+                                                     threadID:0]];
+    XCTAssertEqual(sink.droppedEventCount, 1);
+
+    NSDictionary *trace = [NSJSONSerialization JSONObjectWithData:[sink traceData] options:0 error:nil];
+    NSArray<NSDictionary *> *traceEvents = trace[@"traceEvents"];
+    XCTAssertEqual([traceEvents count], 3);
+    XCTAssertEqualObjects(traceEvents[0][@"name"], @"GetItem");
+    XCTAssertEqualObjects(traceEvents[0][@"cat"], @"continuation");
+    XCTAssertEqualObjects(traceEvents[0][@"ph"], @"X");
+    XCTAssertEqualObjects(traceEvents[0][@"ts"], @3);
+    XCTAssertEqualObjects(traceEvents[0][@"dur"], @4);
+    XCTAssertEqualObjects(traceEvents[0][@"tid"], @42);
+    XCTAssertEqualObjects(traceEvents[0][@"args"][@"queued_us"], @2);
+    XCTAssertEqualObjects(traceEvents[1][@"ph"], @"b");
+    XCTAssertEqualObjects(traceEvents[2][@"ph"], @"e");
+    XCTAssertEqualObjects(traceEvents[1][@"id"], traceEvents[2][@"id"]);
+    XCTAssertEqualObjects(traceEvents[2][@"ts"], @50);
+    XCTAssertEqualObjects(trace[@"otherData"][@"droppedEventCount"], @1);
+
+    NSURL *URL = [[NSURL fileURLWithPath:NSTemporaryDirectory()] URLByAppendingPathComponent:@"AWSTaskTracerTests.json"];
+    NSError *error = nil;
+    XCTAssertTrue([sink writeToURL:URL error:&error]);
+    XCTAssertNil(error);
+    XCTAssertEqualObjects([NSData dataWithContentsOfURL:URL], [sink traceData]);
+    [[NSFileManager defaultManager] removeItemAtURL:URL error:nil];
+
+    [sink reset];
+    XCTAssertEqual([[sink events] count], 0);
+    XCTAssertEqual(sink.droppedEventCount, 0);
+}
+
+// Compare with testPerformanceContinuationsWithTracingOn for the cost of tracing.
+- (void)testPerformanceContinuationsWithTracingOff {
+    [self measureBlock:^{
+        for (NSUInteger i = 0; i < AWSTaskTracerTestsIterations; i++) {
+            @autoreleasepool {
+                [[AWSTask taskWithResult:nil] continueWithExecutor:[AWSExecutor immediateExecutor] withBlock:^id(AWSTask *task) {
+                    return nil;
+                }];
+            }
+        }
+    }];
+}
+
+- (void)testPerformanceContinuationsWithTracingOn {
+    AWSChromeTraceSink *sink = [[AWSChromeTraceSink alloc] initWithMaximumEventCount:0];
+    AWSTaskTracer.sink = sink;
+    [self measureBlock:^{
+        for (NSUInteger i = 0; i < AWSTaskTracerTestsIterations; i++) {
+            @autoreleasepool {
+                [[AWSTask taskWithResult:nil] continueWithExecutor:[AWSExecutor immediateExecutor] withBlock:^id(AWSTask *task) {
+                    return nil;
+                }];
+            }
+        }
+    }];
+}
+
+@end
@@ -0,0 +1,233 @@
+//
+// Copyright 2010-2021 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License.
+// A copy of the License is located at
+//
+// http://aws.amazon.com/apache2.0
+//
+// or in the "license" file accompanying this file. This file is distributed
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+//
+
+#import <XCTest/XCTest.h>
+#import <AWSCore/AWSCore.h>
+
+static const NSUInteger AWSTimestampFormatTestsFuzzIterations = 20000;
+
+@interface AWSTimestampFormatTests : XCTestCase
+
+@property (nonatomic, assign) uint64_t randomState;
+
+@end
+
+@implementation AWSTimestampFormatTests
+
+- (void)setUp {
+    [super setUp];
+    // a fixed seed, so that failures can be reproduced
+    self.randomState = 0x2545F4914F6CDD1DULL;
+}
+
+#pragma mark - Helpers
+
+- (uint64_t)nextRandom {
+    // xorshift64*
+    uint64_t x = self.randomState;
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    self.randomState = x;
+    return x * 0x2545F4914F6CDD1DULL;
+}
+
+- (NSDateFormatter *)dateFormatterWithFormat:(NSString *)dateFormat {
+    NSDateFormatter *dateFormatter = [NSDateFormatter new];
+    dateFormatter.timeZone = [NSTimeZone timeZoneWithName:@"GMT"];
+    dateFormatter.locale = [NSLocale localeWithLocaleIdentifier:@"en_US_POSIX"];
+    dateFormatter.dateFormat = dateFormat;
+    return dateFormatter;
+}
+
+- (NSArray<NSString *> *)dateFormats {
+    return @[AWSDateISO8601DateFormat1,
+             AWSDateISO8601DateFormat2,
+             AWSDateISO8601DateFormat3,
+             AWSDateRFC822DateFormat1,
+             AWSDateShortDateFormat1,
+             AWSDateShortDateFormat2];
+}
+
+// A random time between 1600 and 9000, with a random fraction of a second.
+- (NSTimeInterval)randomTimeInterval {
+    NSTimeInterval start = [[NSDate aws_dateFromString:@"1600-01-01T00:00:00Z" format:AWSDateISO8601DateFormat1] timeIntervalSinceReferenceDate];
+    NSTimeInterval end = [[NSDate aws_dateFromString:@"9000-01-01T00:00:00Z" format:AWSDateISO8601DateFormat1] timeIntervalSinceReferenceDate];
+    uint64_t random = [self nextRandom];
+    NSTimeInterval seconds = floor(start + (end - start) * ((double)(random >> 11) / (double)(1ULL << 53)));
+    switch (random % 4) {
+        case 0:
+            return seconds;
+        case 1:
+            return seconds + (double)([self nextRandom] % 1000) / 1000.0;
+        default:
+            return seconds + (double)([self nextRandom] >> 11) / (double)(1ULL << 53);
+    }
+}
+
+- (NSString *)stringWithTimestampFormat:(AWSTimestampFormat)format timeInterval:(NSTimeInterval)timeInterval {
+    char buffer[AWSTimestampMaxLength];
+    size_t length = AWSTimestampWrite(timeInterval, format, buffer, sizeof(buffer));
+    return length ? [[NSString alloc] initWithBytes:buffer length:length encoding:NSASCIIStringEncoding] : nil;
+}
+
+#pragma mark - Tests
+
+- (void)testKnownValues {
+    NSDate *date = [NSDate dateWithTimeIntervalSince1970:1546400706.789];
+    XCTAssertEqualObjects([date aws_stringValue:AWSDateISO8601DateFormat1], @"2019-01-02T03:45:06Z");
+    XCTAssertEqualObjects([date aws_stringValue:AWSDateISO8601DateFormat2], @"20190102T034506Z");
+    XCTAssertEqualObjects([date aws_stringValue:AWSDateISO8601DateFormat3], @"2019-01-02T03:45:06.789Z");
+    XCTAssertEqualObjects([date aws_stringValue:AWSDateRFC822DateFormat1], @"Wed, 02 Jan 2019 03:45:06 GMT");
+    XCTAssertEqualObjects([date aws_stringValue:AWSDateShortDateFormat1], @"20190102");
+    XCTAssertEqualObjects([date aws_stringValue:AWSDateShortDateFormat2], @"2019-01-02");
+    XCTAssertEqualObjects(AWSTimestampStringFromTimeInterval([date timeIntervalSinceReferenceDate], AWSTimestampFormatEpochSeconds), @"1546400707");
+
+    NSTimeInterval timeInterval = 0;
+    XCTAssertTrue(AWSTimestampParseString(@"Wed, 2 Jan 2019 03:45:06 CST", AWSTimestampFormatRFC822, &timeInterval));
+    XCTAssertEqual(timeInterval + NSTimeIntervalSince1970, 1546422306);
+    XCTAssertTrue(AWSTimestampParseString(@"2019-01-02T03:45:06.789Z", AWSTimestampFormatISO8601Milliseconds, &timeInterval));
+    XCTAssertEqualWithAccuracy(timeInterval + NSTimeIntervalSince1970, 1546400706.789, 0.0001);
+    XCTAssertTrue(AWSTimestampParseString(@"-12.5", AWSTimestampFormatEpochSeconds, &timeInterval));
+    XCTAssertEqual(timeInterval + NSTimeIntervalSince1970, -12.5);
+}
+
+- (void)testRejectedValues {
+    NSTimeInterval timeInterval = 0;
+    XCTAssertFalse(AWSTimestampParseString(@"2019-13-02T03:45:06Z", AWSTimestampFormatISO8601, &timeInterval));
+    XCTAssertFalse(AWSTimestampParseString(@"2019-02-29T03:45:06Z", AWSTimestampFormatISO8601, &timeInterval));
+    XCTAssertFalse(AWSTimestampParseString(@"2019-01-02T24:00:00Z", AWSTimestampFormatISO8601, &timeInterval));
+    XCTAssertFalse(AWSTimestampParseString(@"2019-01-02T03:45:06", AWSTimestampFormatISO8601, &timeInterval));
+    XCTAssertFalse(AWSTimestampParseString(@"1500-01-02T03:45:06Z", AWSTimestampFormatISO8601, &timeInterval));
+    XCTAssertFalse(AWSTimestampParseString(@"Thu, 02 Jan 2019 03:45:06 GMT", AWSTimestampFormatRFC822, &timeInterval));
+    XCTAssertFalse(AWSTimestampParseString(@"Wed, 02 Jan 2019 03:45:06 CET", AWSTimestampFormatRFC822, &timeInterval));
+    XCTAssertFalse(AWSTimestampParseString(@"1.5e3", AWSTimestampFormatEpochSeconds, &timeInterval));
+    XCTAssertFalse(AWSTimestampParseString(@"", AWSTimestampFormatEpochSeconds, &timeInterval));
+    XCTAssertNil(AWSTimestampStringFromTimeInterval(NAN, AWSTimestampFormatISO8601));
+
+    // Dates which are not handled still go through NSDateFormatter.
+    NSDate *date = [NSDate aws_dateFromString:@"Wed, 02 Jan 2019 03:45:06 CET" format:AWSDateRFC822DateFormat1];
+    XCTAssertEqualObjects(date, [[self dateFormatterWithFormat:AWSDateRFC822DateFormat1] dateFromString:@"Wed, 02 Jan 2019 03:45:06 CET"]);
+    XCTAssertNil([NSDate aws_dateFromString:@"1546400706"]);
+}
+
+- (void)testEpochSecondsMatchesStringWithFormat {
+    double values[] = {0, -0.0, 0.5, 1.5, 2.5, -0.4, -0.5, -1.5, 1546400706.4999, 1546400706.5, 99999999999.5, -62135596800};
+    for (size_t i = 0; i < sizeof(values) / sizeof(values[0]); i++) {
+        NSDate *date = [NSDate dateWithTimeIntervalSince1970:values[i]];
+        XCTAssertEqualObjects(AWSTimestampStringFromTimeInterval([date timeIntervalSinceReferenceDate], AWSTimestampFormatEpochSeconds),
+                              ([NSString stringWithFormat:@"%.lf", [date timeIntervalSince1970]]), @"%f", values[i]);
+    }
+}
+
+- (void)testFuzzFormattingMatchesDateFormatter {
+    for (NSString *dateFormat in [self dateFormats]) {
+        NSDateFormatter *dateFormatter = [self dateFormatterWithFormat:dateFormat];
+        AWSTimestampFormat format;
+        XCTAssertTrue(AWSTimestampFormatForDateFormat(dateFormat, &format));
+
+        for (NSUInteger i = 0; i < AWSTimestampFormatTestsFuzzIterations; i++) {
+            NSTimeInterval timeInterval = [self randomTimeInterval];
+            NSDate *date = [NSDate dateWithTimeIntervalSinceReferenceDate:timeInterval];
+            NSString *expected = [dateFormatter stringFromDate:date];
+            NSString *string = [self stringWithTimestampFormat:format timeInterval:timeInterval];
+            if (![string isEqualToString:expected]) {
+                XCTFail(@"%@ of %.6f: %@ != %@", dateFormat, timeInterval, string, expected);
+                break;
+            }
+        }
+    }
+}
+
+- (void)testFuzzParsingMatchesDateFormatter {
+    for (NSString *dateFormat in [self dateFormats]) {
+        NSDateFormatter *dateFormatter = [self dateFormatterWithFormat:dateFormat];
+        AWSTimestampFormat format;
+        XCTAssertTrue(AWSTimestampFormatForDateFormat(dateFormat, &format));
+
+        for (NSUInteger i = 0; i < AWSTimestampFormatTestsFuzzIterations; i++) {
+            NSString *string = [dateFormatter stringFromDate:[NSDate dateWithTimeIntervalSinceReferenceDate:[self randomTimeInterval]]];
+            if (i % 2 == 1) {
+                // mutate a character, which is usually rejected by both
+                NSMutableString *mutatedString = [string mutableCopy];
+                NSUInteger index = [self nextRandom] % [string length];
+                static const char *characters = "0123456789 :-.TZGMTSCDPJanWed,";
+                unichar character = characters[[self nextRandom] % strlen(characters)];
+                [mutatedString replaceCharactersInRange:NSMakeRange(index, 1) withString:[NSString stringWithCharacters:&character length:1]];
+                string = mutatedString;
+            }
+
+            NSTimeInterval timeInterval = 0;
+            if (AWSTimestampParseString(string, format, &timeInterval)) {
+                NSDate *expected = [dateFormatter dateFromString:string];
+                if (!expected || [expected timeIntervalSinceReferenceDate] != timeInterval) {
+                    XCTFail(@"%@ of %@: %.6f != %@", dateFormat, string, timeInterval, expected);
+                    break;
+                }
+            } else if (i % 2 == 0) {
+                XCTFail(@"%@ of %@ is not parsed", dateFormat, string);
+                break;
+            }
+        }
+    }
+}
+
+- (void)testConcurrentUse {
+    NSArray<NSString *> *dateFormats = [self dateFormats];
+    NSDate *date = [NSDate dateWithTimeIntervalSince1970:1546400706.789];
+    NSMutableArray<NSString *> *expected = [NSMutableArray new];
+    for (NSString *dateFormat in dateFormats) {
+        [expected addObject:[[self dateFormatterWithFormat:dateFormat] stringFromDate:date]];
+    }
+
+    __block NSUInteger failures = 0;
+    dispatch_apply(10000, dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^(size_t iteration) {
+        NSUInteger index = iteration % [dateFormats count];
+        NSString *string = [date aws_stringValue:dateFormats[index]];
+        NSDate *parsedDate = [NSDate aws_dateFromString:string format:dateFormats[index]];
+        if (![string isEqualToString:expected[index]] || !parsedDate) {
+            @synchronized (self) {
+                failures++;
+            }
+        }
+    });
+    XCTAssertEqual(failures, 0);
+}
+
+#pragma mark - Benchmarks
+
+- (void)testPerformanceDateFormatter {
+    NSDateFormatter *isoFormatter = [self dateFormatterWithFormat:AWSDateISO8601DateFormat1];
+    NSDateFormatter *rfcFormatter = [self dateFormatterWithFormat:AWSDateRFC822DateFormat1];
+    NSDate *date = [NSDate dateWithTimeIntervalSince1970:1546400706];
+    [self measureBlock:^{
+        for (int i = 0; i < 10000; i++) {
+            [isoFormatter dateFromString:[isoFormatter stringFromDate:date]];
+            [rfcFormatter dateFromString:[rfcFormatter stringFromDate:date]];
+        }
+    }];
+}
+
+- (void)testPerformanceTimestampFormat {
+    NSDate *date = [NSDate dateWithTimeIntervalSince1970:1546400706];
+    [self measureBlock:^{
+        for (int i = 0; i < 10000; i++) {
+            [NSDate aws_dateFromString:[date aws_stringValue:AWSDateISO8601DateFormat1] format:AWSDateISO8601DateFormat1];
+            [NSDate aws_dateFromString:[date aws_stringValue:AWSDateRFC822DateFormat1] format:AWSDateRFC822DateFormat1];
+        }
+    }];
+}
+
+@end
@@ -0,0 +1,283 @@
+//
+// Copyright 2010-2021 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License.
+// A copy of the License is located at
+//
+// http://aws.amazon.com/apache2.0
+//
+// or in the "license" file accompanying this file. This file is distributed
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+//
+
+#import <XCTest/XCTest.h>
+#import "AWSCore.h"
+#import "AWSJSONStreamParser.h"
+
+@interface AWSJSONStreamParserTestsItem : AWSMTLModel <AWSMTLJSONSerializing>
+
+@property (nonatomic, strong) NSString *identifier;
+@property (nonatomic, strong) NSArray<NSString *> *tags;
+
+@end
+
+@implementation AWSJSONStreamParserTestsItem
+
++ (NSDictionary *)JSONKeyPathsByPropertyKey {
+    return @{@"identifier" : @"Id",
+             @"tags" : @"Tags"};
+}
+
+@end
+
+@interface AWSJSONStreamParserTestsScanOutput : AWSMTLModel <AWSMTLJSONSerializing>
+
+@property (nonatomic, strong) NSArray<AWSJSONStreamParserTestsItem *> *items;
+@property (nonatomic, strong) NSNumber *count;
+
+@end
+
+@implementation AWSJSONStreamParserTestsScanOutput
+
++ (NSDictionary *)JSONKeyPathsByPropertyKey {
+    return @{@"items" : @"Items",
+             @"count" : @"Count"};
+}
+
++ (NSValueTransformer *)itemsJSONTransformer {
+    return [NSValueTransformer awsmtl_JSONArrayTransformerWithModelClass:[AWSJSONStreamParserTestsItem class]];
+}
+
+@end
+
+@interface AWSJSONStreamParserTests : XCTestCase
+
+@property (nonatomic, strong) NSDictionary *serviceDefinition;
+@property (nonatomic, strong) NSHTTPURLResponse *response;
+
+@end
+
+@implementation AWSJSONStreamParserTests
+
+- (void)setUp {
+    [super setUp];
+    self.serviceDefinition = @{
+        @"operations": @{
+                @"Scan": @{
+                        @"name": @"Scan",
+                        @"output": @{@"shape": @"ScanOutput"}
+                },
+                @"Describe": @{
+                        @"name": @"Describe",
+                        @"output": @{@"shape": @"DescribeOutput"}
+                }
+        },
+        @"shapes": @{
+                @"ScanOutput": @{
+                        @"type": @"structure",
+                        @"members": @{
+                                @"Items": @{@"shape": @"ItemList"},
+                                @"Count": @{@"shape": @"Integer"},
+                                @"NextToken": @{@"shape": @"String"},
+                                @"Blob": @{@"shape": @"Blob"}
+                        }
+                },
+                @"DescribeOutput": @{
+                        @"type": @"structure",
+                        @"members": @{
+                                @"Name": @{@"shape": @"String"}
+                        }
+                },
+                @"ItemList": @{
+                        @"type": @"list",
+                        @"member": @{@"shape": @"Item"}
+                },
+                @"Item": @{
+                        @"type": @"structure",
+                        @"members": @{
+                                @"Id": @{@"shape": @"String"},
+                                @"Tags": @{@"shape": @"TagList"}
+                        }
+                },
+                @"TagList": @{
+                        @"type": @"list",
+                        @"member": @{@"shape": @"String"}
+                },
+                @"Integer": @{@"type": @"integer"},
+                @"String": @{@"type": @"string"},
+                @"Blob": @{@"type": @"blob"}
+        }
+    };
+    self.response = [[NSHTTPURLResponse alloc] initWithURL:[NSURL URLWithString:@"https://service.us-east-1.amazonaws.com"]
+                                                statusCode:200
+                                               HTTPVersion:@"HTTP/1.1"
+                                              headerFields:@{@"Content-Type": @"application/x-amz-json-1.0"}];
+}
+
+- (AWSJSONStreamParser *)parserWithItems:(NSMutableArray *)items {
+    return [AWSJSONStreamParser parserForResponse:self.response
+                                       actionName:@"Scan"
+                            serviceDefinitionRule:self.serviceDefinition
+                                  listItemHandler:^(NSString *memberName, id item) {
+                                      XCTAssertEqualObjects(memberName, @"Items");
+                                      [items addObject:item];
+                                  }];
+}
+
+- (NSData *)scanBody {
+    NSString *body = @"{ \"Count\" : 3, \"Items\" : [ {\"Id\":\"a\",\"Tags\":[\"x\",\"y\"]}, {\"Id\":\"b}]\\\"\"}, {\"Id\":\"c\",\"Tags\":[]} ],"
+    "\"NextToken\":\"token\", \"Blob\":\"aGVsbG8=\", \"Unknown\": {\"Nested\": [1, 2, {\"a\": null}]} }";
+    return [body dataUsingEncoding:NSUTF8StringEncoding];
+}
+
+- (void)verifyItems:(NSArray *)items result:(NSDictionary *)result {
+    XCTAssertEqual([items count], 3);
+    XCTAssertEqualObjects(items[0][@"Id"], @"a");
+    XCTAssertEqualObjects(items[0][@"Tags"], (@[@"x", @"y"]));
+    XCTAssertEqualObjects(items[1][@"Id"], @"b}]\"");
+    XCTAssertEqualObjects(items[2][@"Tags"], @[]);
+
+    XCTAssertNil(result[@"Items"]);
+    XCTAssertNil(result[@"Unknown"]);
+    XCTAssertEqualObjects(result[@"Count"], @3);
+    XCTAssertEqualObjects(result[@"NextToken"], @"token");
+    XCTAssertEqualObjects(result[@"Blob"], [@"hello" dataUsingEncoding:NSUTF8StringEncoding]);
+}
+
+- (void)testParseWholeBody {
+    NSMutableArray *items = [NSMutableArray new];
+    AWSJSONStreamParser *parser = [self parserWithItems:items];
+    XCTAssertEqualObjects(parser.streamedMemberNames, [NSSet setWithObject:@"Items"]);
+
+    NSError *error = nil;
+    XCTAssertTrue([parser parseData:[self scanBody] error:&error]);
+    XCTAssertNil(error);
+    NSDictionary *result = [parser finishWithError:&error];
+    XCTAssertNil(error);
+    [self verifyItems:items result:result];
+}
+
+- (void)testParseOneByteAtATime {
+    NSMutableArray *items = [NSMutableArray new];
+    AWSJSONStreamParser *parser = [self parserWithItems:items];
+
+    NSData *body = [self scanBody];
+    NSError *error = nil;
+    for (NSUInteger i = 0; i < [body length]; i++) {
+        XCTAssertTrue([parser parseData:[body subdataWithRange:NSMakeRange(i, 1)] error:&error]);
+        if (i < 40) {
+            XCTAssertEqual([items count], 0);
+        }
+    }
+    NSDictionary *result = [parser finishWithError:&error];
+    XCTAssertNil(error);
+    [self verifyItems:items result:result];
+}
+
+- (void)testItemsAreDeliveredBeforeBodyIsComplete {
+    NSMutableArray *items = [NSMutableArray new];
+    AWSJSONStreamParser *parser = [self parserWithItems:items];
+
+    NSData *body = [@"{\"Items\":[{\"Id\":\"a\"},{\"Id\":\"b\"}," dataUsingEncoding:NSUTF8StringEncoding];
+    XCTAssertTrue([parser parseData:body error:nil]);
+    XCTAssertEqual([items count], 2);
+
+    NSError *error = nil;
+    XCTAssertNil([parser finishWithError:&error]);
+    XCTAssertNotNil(error);
+}
+
+- (void)testEmptyListAndEmptyObject {
+    NSMutableArray *items = [NSMutableArray new];
+    AWSJSONStreamParser *parser = [self parserWithItems:items];
+    XCTAssertTrue([parser parseData:[@"{\"Items\":[],\"Count\":0}" dataUsingEncoding:NSUTF8StringEncoding] error:nil]);
+    NSDictionary *result = [parser finishWithError:nil];
+    XCTAssertEqual([items count], 0);
+    XCTAssertEqualObjects(result[@"Count"], @0);
+
+    parser = [self parserWithItems:items];
+    XCTAssertTrue([parser parseData:[@" {} " dataUsingEncoding:NSUTF8StringEncoding] error:nil]);
+    XCTAssertEqualObjects([parser finishWithError:nil], @{});
+}
+
+- (void)testInvalidBody {
+    NSMutableArray *items = [NSMutableArray new];
+    AWSJSONStreamParser *parser = [self parserWithItems:items];
+
+    NSError *error = nil;
+    XCTAssertFalse([parser parseData:[@"{\"Items\":[{\"Id\":\"a\"} {\"Id\":\"b\"}]}" dataUsingEncoding:NSUTF8StringEncoding] error:&error]);
+    XCTAssertNotNil(error);
+    XCTAssertEqual([items count], 1);
+    XCTAssertNil([parser finishWithError:nil]);
+}
+
+- (void)testNoParserWithoutListMembersOrForErrors {
+    AWSNetworkingResponseListItemBlock handler = ^(NSString *memberName, id item) {};
+    XCTAssertNil([AWSJSONStreamParser parserForResponse:self.response
+                                             actionName:@"Describe"
+                                  serviceDefinitionRule:self.serviceDefinition
+                                        listItemHandler:handler]);
+
+    NSHTTPURLResponse *errorResponse = [[NSHTTPURLResponse alloc] initWithURL:self.response.URL
+                                                                   statusCode:400
+                                                                  HTTPVersion:@"HTTP/1.1"
+                                                                 headerFields:nil];
+    XCTAssertNil([AWSJSONStreamParser parserForResponse:errorResponse
+                                             actionName:@"Scan"
+                                  serviceDefinitionRule:self.serviceDefinition
+                                        listItemHandler:handler]);
+}
+
+- (void)testResponseSerializerParsesStreamedBody {
+    NSMutableArray *items = [NSMutableArray new];
+    AWSNetworkingRequest *request = [AWSNetworkingRequest new];
+    request.responseListItemHandler = ^(NSString *memberName, id item) {
+        [items addObject:item];
+    };
+
+    AWSJSONResponseSerializer *serializer = [[AWSJSONResponseSerializer alloc] initWithJSONDefinition:self.serviceDefinition
+                                                                                           actionName:@"Scan"
+                                                                                          outputClass:nil];
+    id<AWSHTTPURLResponseStreamParser> parser = [serializer streamParserForResponse:self.response request:request];
+    XCTAssertNotNil(parser);
+    XCTAssertTrue([parser parseData:[self scanBody] error:nil]);
+
+    NSError *error = nil;
+    NSDictionary *result = [serializer responseObjectForResponse:self.response
+                                                 originalRequest:nil
+                                                  currentRequest:nil
+                                                            data:parser
+                                                           error:&error];
+    XCTAssertNil(error);
+    [self verifyItems:items result:result];
+}
+
+- (void)testResponseSerializerConvertsStreamedElements {
+    NSMutableArray *items = [NSMutableArray new];
+    AWSNetworkingRequest *request = [AWSNetworkingRequest new];
+    request.responseListItemHandler = ^(NSString *memberName, id item) {
+        [items addObject:item];
+    };
+
+    AWSJSONResponseSerializer *serializer = [[AWSJSONResponseSerializer alloc] initWithJSONDefinition:self.serviceDefinition
+                                                                                           actionName:@"Scan"
+                                                                                          outputClass:[AWSJSONStreamParserTestsScanOutput class]];
+    id<AWSHTTPURLResponseStreamParser> parser = [serializer streamParserForResponse:self.response request:request];
+    XCTAssertTrue([parser parseData:[self scanBody] error:nil]);
+
+    // Each element is the model it would be in the list property of the output.
+    XCTAssertEqual([items count], 3);
+    for (id item in items) {
+        XCTAssertTrue([item isKindOfClass:[AWSJSONStreamParserTestsItem class]]);
+    }
+    AWSJSONStreamParserTestsItem *firstItem = items[0];
+    AWSJSONStreamParserTestsItem *secondItem = items[1];
+    XCTAssertEqualObjects(firstItem.identifier, @"a");
+    XCTAssertEqualObjects(firstItem.tags, (@[@"x", @"y"]));
+    XCTAssertEqualObjects(secondItem.identifier, @"b}]\"");
+}
+
+@end
@@ -0,0 +1,355 @@
+//
+// Copyright 2010-2021 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License.
+// A copy of the License is located at
+//
+// http://aws.amazon.com/apache2.0
+//
+// or in the "license" file accompanying this file. This file is distributed
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+//
+
+#import <XCTest/XCTest.h>
+#import "AWSCore.h"
+#import "AWSQueryFormWriter.h"
+
+@interface AWSQueryFormWriterTests : XCTestCase
+
+@property (nonatomic, strong) NSDictionary *serviceDefinition;
+
+@end
+
+@implementation AWSQueryFormWriterTests
+
+- (void)setUp {
+    [super setUp];
+    self.serviceDefinition = @{
+        @"metadata": @{@"apiVersion": @"2012-11-05"},
+        @"operations": @{
+                @"SendMessageBatch": @{
+                        @"name": @"SendMessageBatch",
+                        @"input": @{@"shape": @"SendMessageBatchRequest"}
+                },
+                @"PutMetricData": @{
+                        @"name": @"PutMetricData",
+                        @"input": @{@"shape": @"PutMetricDataInput"}
+                }
+        },
+        @"shapes": @{
+                @"SendMessageBatchRequest": @{
+                        @"type": @"structure",
+                        @"members": @{
+                                @"QueueUrl": @{@"shape": @"String"},
+                                @"Entries": @{@"shape": @"SendMessageBatchRequestEntryList"}
+                        }
+                },
+                @"SendMessageBatchRequestEntryList": @{
+                        @"type": @"list",
+                        @"member": @{@"shape": @"SendMessageBatchRequestEntry", @"locationName": @"SendMessageBatchRequestEntry"},
+                        @"flattened": @YES
+                },
+                @"SendMessageBatchRequestEntry": @{
+                        @"type": @"structure",
+                        @"members": @{
+                                @"Id": @{@"shape": @"String"},
+                                @"MessageBody": @{@"shape": @"String"},
+                                @"DelaySeconds": @{@"shape": @"Integer"},
+                                @"MessageAttributes": @{@"shape": @"MessageBodyAttributeMap", @"locationName": @"MessageAttribute"}
+                        }
+                },
+                @"MessageBodyAttributeMap": @{
+                        @"type": @"map",
+                        @"key": @{@"shape": @"String", @"locationName": @"Name"},
+                        @"value": @{@"shape": @"MessageAttributeValue", @"locationName": @"Value"},
+                        @"flattened": @YES
+                },
+                @"MessageAttributeValue": @{
+                        @"type": @"structure",
+                        @"members": @{
+                                @"StringValue": @{@"shape": @"String"},
+                                @"BinaryValue": @{@"shape": @"Blob"},
+                                @"DataType": @{@"shape": @"String"}
+                        }
+                },
+                @"PutMetricDataInput": @{
+                        @"type": @"structure",
+                        @"members": @{
+                                @"Namespace": @{@"shape": @"String"},
+                                @"MetricData": @{@"shape": @"MetricData"}
+                        }
+                },
+                @"MetricData": @{
+                        @"type": @"list",
+                        @"member": @{@"shape": @"MetricDatum"}
+                },
+                @"MetricDatum": @{
+                        @"type": @"structure",
+                        @"members": @{
+                                @"MetricName": @{@"shape": @"String"},
+                                @"Dimensions": @{@"shape": @"Dimensions"},
+                                @"Timestamp": @{@"shape": @"Timestamp"},
+                                @"Value": @{@"shape": @"Double"},
+                                @"Unit": @{@"shape": @"String"},
+                                @"StorageResolution": @{@"shape": @"Integer"},
+                                @"HighResolution": @{@"shape": @"Boolean"}
+                        }
+                },
+                @"Dimensions": @{
+                        @"type": @"list",
+                        @"member": @{@"shape": @"Dimension"}
+                },
+                @"Dimension": @{
+                        @"type": @"structure",
+                        @"members": @{
+                                @"Name": @{@"shape": @"String"},
+                                @"Value": @{@"shape": @"String"}
+                        }
+                },
+                @"String": @{@"type": @"string"},
+                @"Integer": @{@"type": @"integer"},
+                @"Double": @{@"type": @"double"},
+                @"Boolean": @{@"type": @"boolean"},
+                @"Blob": @{@"type": @"blob"},
+                @"Timestamp": @{@"type": @"timestamp"}
+        }
+    };
+}
+
+#pragma mark - Helpers
+
+// The body as built before `AWSQueryFormWriter`, mirroring `-[AWSQueryStringRequestSerializer processParameters:queryString:]`.
+- (void)appendParameters:(NSDictionary *)parameters toQueryString:(NSMutableString *)queryString {
+    for (NSString *key in parameters) {
+        id obj = parameters[key];
+        if ([obj isKindOfClass:[NSDictionary class]]) {
+            [self appendParameters:obj toQueryString:queryString];
+        } else {
+            if ([queryString length] > 0) {
+                [queryString appendString:@"&"];
+            }
+            [queryString appendString:[key aws_stringWithURLEncoding]];
+            [queryString appendString:@"="];
+            if ([obj isKindOfClass:[NSNumber class]]) {
+                [queryString appendString:[[obj stringValue] aws_stringWithURLEncoding]];
+            } else {
+                [queryString appendString:[[obj description] aws_stringWithURLEncoding]];
+            }
+        }
+    }
+}
+
+- (NSString *)legacyBodyForParameters:(NSDictionary *)parameters actionName:(NSString *)actionName {
+    NSError *error = nil;
+    NSDictionary *formattedParams = [AWSQueryParamBuilder buildFormattedParams:parameters
+                                                                    actionName:actionName
+                                                         serviceDefinitionRule:self.serviceDefinition
+                                                                         error:&error];
+    XCTAssertNil(error);
+    NSMutableString *queryString = [NSMutableString new];
+    [self appendParameters:formattedParams toQueryString:queryString];
+    return queryString;
+}
+
+- (NSString *)bodyForParameters:(NSDictionary *)parameters actionName:(NSString *)actionName {
+    NSError *error = nil;
+    NSData *data = [AWSQueryFormWriter formDataForDictionary:parameters
+                                                  actionName:actionName
+                                       serviceDefinitionRule:self.serviceDefinition
+                                                    protocol:AWSQueryFormWriterProtocolQuery
+                                                       error:&error];
+    XCTAssertNil(error);
+    return [[NSString alloc] initWithData:data encoding:NSUTF8StringEncoding];
+}
+
+- (NSCountedSet *)pairsOfBody:(NSString *)body {
+    return [[NSCountedSet alloc] initWithArray:[body componentsSeparatedByString:@"&"]];
+}
+
+- (NSDictionary *)sendMessageBatchParametersWithCount:(NSUInteger)count {
+    NSMutableArray *entries = [NSMutableArray new];
+    for (NSUInteger i = 0; i < count; i++) {
+        [entries addObject:@{
+            @"Id": [NSString stringWithFormat:@"msg-%lu", (unsigned long)i],
+            @"MessageBody": [NSString stringWithFormat:@"{\"index\": %lu, \"text\": \"50%% off & more ünïcödé 🎉\"}", (unsigned long)i],
+            @"DelaySeconds": @(i % 10),
+            @"MessageAttributes": @{
+                    @"Source": @{@"DataType": @"String", @"StringValue": @"unit test"},
+                    @"payload": @{@"DataType": @"Binary", @"BinaryValue": [@"hello" dataUsingEncoding:NSUTF8StringEncoding]}
+            }
+        }];
+    }
+    return @{@"QueueUrl": @"https://sqs.us-east-1.amazonaws.com/123456789012/queue",
+             @"Entries": entries};
+}
+
+- (NSDictionary *)putMetricDataParametersWithCount:(NSUInteger)count {
+    NSMutableArray *metricData = [NSMutableArray new];
+    for (NSUInteger i = 0; i < count; i++) {
+        [metricData addObject:@{
+            @"MetricName": [NSString stringWithFormat:@"Latency/%lu", (unsigned long)i],
+            @"Dimensions": @[@{@"Name": @"Operation", @"Value": @"GetItem"},
+                             @{@"Name": @"Region", @"Value": @"us-east-1"}],
+            @"Timestamp": [NSDate dateWithTimeIntervalSince1970:1600000000 + i],
+            @"Value": @(i * 0.25),
+            @"Unit": @"Milliseconds",
+            @"StorageResolution": @60,
+            @"HighResolution": @(i % 2 == 0)
+        }];
+    }
+    return @{@"Namespace": @"AWS/Test", @"MetricData": metricData};
+}
+
+#pragma mark - Tests
+
+- (void)testActionAndVersionOnly {
+    NSString *body = [self bodyForParameters:nil actionName:@"SendMessageBatch"];
+    XCTAssertEqualObjects(body, @"Action=SendMessageBatch&Version=2012-11-05");
+}
+
+- (void)testFlattenedListMapAndBlobMatchParamBuilder {
+    NSDictionary *parameters = [self sendMessageBatchParametersWithCount:3];
+    NSString *body = [self bodyForParameters:parameters actionName:@"SendMessageBatch"];
+    NSString *legacyBody = [self legacyBodyForParameters:parameters actionName:@"SendMessageBatch"];
+
+    XCTAssertEqualObjects([self pairsOfBody:body], [self pairsOfBody:legacyBody]);
+    XCTAssertTrue([body containsString:@"SendMessageBatchRequestEntry.1.MessageAttribute.1.Name=payload"]);
+    XCTAssertTrue([body containsString:@"SendMessageBatchRequestEntry.1.MessageAttribute.1.Value.BinaryValue=aGVsbG8%3D"]);
+    XCTAssertTrue([body containsString:@"SendMessageBatchRequestEntry.1.MessageAttribute.2.Name=Source"]);
+    XCTAssertTrue([body containsString:@"SendMessageBatchRequestEntry.3.DelaySeconds=2"]);
+}
+
+- (void)testListTimestampNumberAndBooleanMatchParamBuilder {
+    NSDictionary *parameters = [self putMetricDataParametersWithCount:3];
+    NSString *body = [self bodyForParameters:parameters actionName:@"PutMetricData"];
+    NSString *legacyBody = [self legacyBodyForParameters:parameters actionName:@"PutMetricData"];
+
+    XCTAssertEqualObjects([self pairsOfBody:body], [self pairsOfBody:legacyBody]);
+    XCTAssertTrue([body containsString:@"MetricData.member.2.Dimensions.member.2.Value=us-east-1"]);
+    XCTAssertTrue([body containsString:@"MetricData.member.1.HighResolution=true"]);
+    XCTAssertTrue([body containsString:@"MetricData.member.2.HighResolution=false"]);
+    XCTAssertTrue([body containsString:@"MetricData.member.3.Value=0.5"]);
+}
+
+- (void)testPercentEncoding {
+    NSDictionary *parameters = @{@"QueueUrl": @"a b+c/d?e=f&g~h_i.j-k%20l ü"};
+    NSString *body = [self bodyForParameters:parameters actionName:@"SendMessageBatch"];
+    XCTAssertEqualObjects(body, @"Action=SendMessageBatch&Version=2012-11-05&QueueUrl=a%20b%2Bc%2Fd%3Fe%3Df%26g~h_i.j-k%20l%20%C3%BC");
+    XCTAssertEqualObjects([self pairsOfBody:body],
+                          [self pairsOfBody:[self legacyBodyForParameters:parameters actionName:@"SendMessageBatch"]]);
+}
+
+- (void)testOutputIsDeterministic {
+    NSDictionary *parameters = [self sendMessageBatchParametersWithCount:2];
+    NSString *body = [self bodyForParameters:parameters actionName:@"SendMessageBatch"];
+    XCTAssertEqualObjects(body, [self bodyForParameters:[parameters mutableCopy] actionName:@"SendMessageBatch"]);
+
+    NSArray *pairs = [body componentsSeparatedByString:@"&"];
+    XCTAssertTrue([pairs[0] hasPrefix:@"Action="]);
+    XCTAssertTrue([pairs[1] hasPrefix:@"Version="]);
+    XCTAssertTrue([pairs[2] hasPrefix:@"SendMessageBatchRequestEntry.1.DelaySeconds="]);
+    XCTAssertTrue([[pairs lastObject] hasPrefix:@"QueueUrl="]);
+}
+
+- (void)testInvalidParameters {
+    NSError *error = nil;
+    NSData *data = [AWSQueryFormWriter formDataForDictionary:@{@"Entries": @"not a list"}
+                                                  actionName:@"SendMessageBatch"
+                                       serviceDefinitionRule:self.serviceDefinition
+                                                    protocol:AWSQueryFormWriterProtocolQuery
+                                                       error:&error];
+    XCTAssertNil(data);
+    XCTAssertEqualObjects(error.domain, AWSQueryParamBuilderErrorDomain);
+    XCTAssertEqual(error.code, AWSQueryParamBuilderInvalidParameter);
+
+    error = nil;
+    data = [AWSQueryFormWriter formDataForDictionary:@{@"QueueUrl": @"url"}
+                                          actionName:@"Unknown"
+                                serviceDefinitionRule:self.serviceDefinition
+                                            protocol:AWSQueryFormWriterProtocolQuery
+                                               error:&error];
+    XCTAssertNil(data);
+    XCTAssertEqual(error.code, AWSQueryParamBuilderUndefinedActionRule);
+}
+
+- (void)testEC2ListAndQueryName {
+    NSDictionary *definition = @{
+        @"metadata": @{@"apiVersion": @"2016-11-15"},
+        @"operations": @{@"DescribeInstances": @{@"input": @{@"shape": @"DescribeInstancesRequest"}}},
+        @"shapes": @{
+                @"DescribeInstancesRequest": @{
+                        @"type": @"structure",
+                        @"members": @{
+                                @"InstanceIds": @{@"shape": @"InstanceIdStringList", @"locationName": @"InstanceId"},
+                                @"DryRun": @{@"shape": @"Boolean", @"locationName": @"dryRun"},
+                                @"MaxResults": @{@"shape": @"Integer", @"queryName": @"MaxResultsOverride"}
+                        }
+                },
+                @"InstanceIdStringList": @{
+                        @"type": @"list",
+                        @"member": @{@"shape": @"String", @"locationName": @"InstanceId"}
+                },
+                @"String": @{@"type": @"string"},
+                @"Integer": @{@"type": @"integer"},
+                @"Boolean": @{@"type": @"boolean"}
+        }
+    };
+    NSDictionary *parameters = @{@"InstanceIds": @[@"i-1", @"i-2"], @"DryRun": @YES, @"MaxResults": @5};
+
+    NSError *error = nil;
+    NSData *data = [AWSQueryFormWriter formDataForDictionary:parameters
+                                                  actionName:@"DescribeInstances"
+                                       serviceDefinitionRule:definition
+                                                    protocol:AWSQueryFormWriterProtocolEC2
+                                                       error:&error];
+    XCTAssertNil(error);
+    NSString *body = [[NSString alloc] initWithData:data encoding:NSUTF8StringEncoding];
+    XCTAssertEqualObjects(body, @"Action=DescribeInstances&Version=2016-11-15&DryRun=true&InstanceId.1=i-1&InstanceId.2=i-2&MaxResultsOverride=5");
+
+    NSDictionary *formattedParams = [AWSEC2ParamBuilder buildFormattedParams:parameters
+                                                                  actionName:@"DescribeInstances"
+                                                       serviceDefinitionRule:definition
+                                                                       error:&error];
+    NSMutableString *legacyBody = [NSMutableString new];
+    [self appendParameters:formattedParams toQueryString:legacyBody];
+    XCTAssertEqualObjects([self pairsOfBody:body], [self pairsOfBody:legacyBody]);
+}
+
+#pragma mark - Benchmarks
+
+- (void)testPerformanceSendMessageBatchParamBuilder {
+    NSDictionary *parameters = [self sendMessageBatchParametersWithCount:10];
+    [self measureBlock:^{
+        for (int i = 0; i < 200; i++) {
+            [self legacyBodyForParameters:parameters actionName:@"SendMessageBatch"];
+        }
+    }];
+}
+
+- (void)testPerformanceSendMessageBatchFormWriter {
+    NSDictionary *parameters = [self sendMessageBatchParametersWithCount:10];
+    [self measureBlock:^{
+        for (int i = 0; i < 200; i++) {
+            [self bodyForParameters:parameters actionName:@"SendMessageBatch"];
+        }
+    }];
+}
+
+- (void)testPerformancePutMetricDataParamBuilder {
+    NSDictionary *parameters = [self putMetricDataParametersWithCount:1000];
+    [self measureBlock:^{
+        [self legacyBodyForParameters:parameters actionName:@"PutMetricData"];
+    }];
+}
+
+- (void)testPerformancePutMetricDataFormWriter {
+    NSDictionary *parameters = [self putMetricDataParametersWithCount:1000];
+    [self measureBlock:^{
+        [self bodyForParameters:parameters actionName:@"PutMetricData"];
+    }];
+}
+
+@end
@@ -0,0 +1,519 @@
+//
+// Copyright 2010-2021 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License.
+// A copy of the License is located at
+//
+// http://aws.amazon.com/apache2.0
+//
+// or in the "license" file accompanying this file. This file is distributed
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+//
+
+#import <XCTest/XCTest.h>
+#import <mach/mach.h>
+#import <mach/mach_time.h>
+#import <pthread.h>
+#import <stdatomic.h>
+#import "AWSCore.h"
+#import "AWSQueryFormWriter.h"
+
+// Benchmarks the request and response serializers against the corpus in
+// `Resources/benchmark-<protocol>-<service>.json`. Each corpus file holds a
+// trimmed copy of the service definition and a list of cases with the request
+// parameters and a recorded response.
+//
+// The harness is configured through the environment, which `xcodebuild` passes
+// on to the test runner when the variables are prefixed with `TEST_RUNNER_`
+// (see `Scripts/serialization_benchmark.sh`):
+//
+//   AWS_SERIALIZATION_BENCHMARK_ITERATIONS  Iterations per case (default 20).
+//   AWS_SERIALIZATION_BENCHMARK_REPORT      Where to write the JSON report
+//                                           (default: the temporary directory).
+//   AWS_SERIALIZATION_BENCHMARK_BASELINE    A report of an earlier run. When
+//                                           set, the test fails if ns/op or
+//                                           bytes/op regressed.
+//   AWS_SERIALIZATION_BENCHMARK_THRESHOLD   The tolerated regression as a
+//                                           fraction (default 0.1).
+
+static NSString *const AWSSerializationBenchmarkIterationsKey = @"AWS_SERIALIZATION_BENCHMARK_ITERATIONS";
+static NSString *const AWSSerializationBenchmarkReportKey = @"AWS_SERIALIZATION_BENCHMARK_REPORT";
+static NSString *const AWSSerializationBenchmarkBaselineKey = @"AWS_SERIALIZATION_BENCHMARK_BASELINE";
+static NSString *const AWSSerializationBenchmarkThresholdKey = @"AWS_SERIALIZATION_BENCHMARK_THRESHOLD";
+
+static NSUInteger const AWSSerializationBenchmarkDefaultIterations = 20;
+static double const AWSSerializationBenchmarkDefaultThreshold = 0.1;
+
+#pragma mark - Allocation counting
+
+// The hook libmalloc calls for every allocation when it is set, which is how
+// the malloc stack logging tools record allocations.
+typedef void (AWSMallocLogger)(uint32_t type, uintptr_t arg1, uintptr_t arg2, uintptr_t arg3, uintptr_t result, uint32_t numHotFramesToSkip);
+extern AWSMallocLogger *malloc_logger;
+
+static const uint32_t AWSMallocLogTypeAllocate = 2;
+static const uint32_t AWSMallocLogTypeDeallocate = 4;
+
+static AWSMallocLogger *AWSPreviousMallocLogger = NULL;
+static pthread_t AWSAllocationCountingThread = NULL;
+static uint64_t AWSAllocatedBytes = 0;
+static uint64_t AWSAllocationCount = 0;
+
+static void AWSCountAllocation(uint32_t type, uintptr_t arg1, uintptr_t arg2, uintptr_t arg3, uintptr_t result, uint32_t numHotFramesToSkip) {
+    if (AWSPreviousMallocLogger) {
+        AWSPreviousMallocLogger(type, arg1, arg2, arg3, result, numHotFramesToSkip);
+    }
+    // Only the allocations of the benchmarked thread are counted. The counters
+    // are never written by another thread.
+    if ((type & AWSMallocLogTypeAllocate) && pthread_equal(pthread_self(), AWSAllocationCountingThread)) {
+        // realloc logs both flags, with the new size in arg3.
+        AWSAllocatedBytes += (type & AWSMallocLogTypeDeallocate) ? arg3 : arg2;
+        AWSAllocationCount++;
+    }
+}
+
+static void AWSStartCountingAllocations(void) {
+    AWSAllocatedBytes = 0;
+    AWSAllocationCount = 0;
+    AWSAllocationCountingThread = pthread_self();
+    AWSPreviousMallocLogger = malloc_logger;
+    malloc_logger = AWSCountAllocation;
+}
+
+static void AWSStopCountingAllocations(void) {
+    malloc_logger = AWSPreviousMallocLogger;
+    AWSPreviousMallocLogger = NULL;
+    AWSAllocationCountingThread = NULL;
+}
+
+#pragma mark - Footprint sampling
+
+static uint64_t AWSPhysicalFootprint(void) {
+    task_vm_info_data_t info;
+    mach_msg_type_number_t count = TASK_VM_INFO_COUNT;
+    if (task_info(mach_task_self(), TASK_VM_INFO, (task_info_t)&info, &count) != KERN_SUCCESS) {
+        return 0;
+    }
+    return info.phys_footprint;
+}
+
+// Samples the physical footprint of the process every millisecond, which is
+// the resident memory the system accounts to the app, and keeps the peak.
+@interface AWSFootprintSampler : NSObject
+
+@property (nonatomic, readonly) uint64_t initialFootprint;
+@property (nonatomic, readonly) uint64_t peakFootprint;
+
+- (void)start;
+- (void)stop;
+
+@end
+
+@implementation AWSFootprintSampler {
+    dispatch_source_t _timer;
+    _Atomic uint64_t _peakFootprint;
+}
+
+- (void)sample {
+    uint64_t footprint = AWSPhysicalFootprint();
+    uint64_t peak = atomic_load(&_peakFootprint);
+    while (footprint > peak && !atomic_compare_exchange_weak(&_peakFootprint, &peak, footprint)) {
+    }
+}
+
+- (void)start {
+    _initialFootprint = AWSPhysicalFootprint();
+    atomic_store(&_peakFootprint, _initialFootprint);
+
+    __weak AWSFootprintSampler *weakSelf = self;
+    _timer = dispatch_source_create(DISPATCH_SOURCE_TYPE_TIMER, 0, 0, dispatch_get_global_queue(QOS_CLASS_USER_INTERACTIVE, 0));
+    dispatch_source_set_timer(_timer, DISPATCH_TIME_NOW, NSEC_PER_MSEC, 100 * NSEC_PER_USEC);
+    dispatch_source_set_event_handler(_timer, ^{
+        [weakSelf sample];
+    });
+    dispatch_resume(_timer);
+}
+
+- (void)stop {
+    dispatch_source_cancel(_timer);
+    _timer = nil;
+    [self sample];
+}
+
+- (uint64_t)peakFootprint {
+    return atomic_load(&_peakFootprint);
+}
+
+@end
+
+#pragma mark - Measurements
+
+@interface AWSSerializationBenchmarkMeasurement : NSObject
+
+@property (nonatomic, assign) double nanosecondsPerOperation;
+@property (nonatomic, assign) double bytesPerOperation;
+@property (nonatomic, assign) double allocationsPerOperation;
+
+- (NSDictionary *)dictionaryValue;
+
+@end
+
+@implementation AWSSerializationBenchmarkMeasurement
+
+- (NSDictionary *)dictionaryValue {
+    return @{
+             @"ns_per_op" : @(round(self.nanosecondsPerOperation)),
+             @"bytes_per_op" : @(round(self.bytesPerOperation)),
+             @"allocations_per_op" : @(round(self.allocationsPerOperation)),
+             };
+}
+
+@end
+
+static uint64_t AWSNanosecondsFromMachTime(uint64_t machTime) {
+    static mach_timebase_info_data_t timebase;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        mach_timebase_info(&timebase);
+    });
+    return machTime * timebase.numer / timebase.denom;
+}
+
+@interface AWSSerializationBenchmarkTests : XCTestCase
+
+@end
+
+@implementation AWSSerializationBenchmarkTests
+
++ (NSArray<NSString *> *)corpusNames {
+    return @[
+             @"benchmark-rest-xml-s3",
+             @"benchmark-json-dynamodb",
+             @"benchmark-json-kinesis",
+             @"benchmark-rest-json-pinpoint",
+             @"benchmark-rest-json-location",
+             @"benchmark-query-sqs",
+             @"benchmark-query-sns",
+             @"benchmark-ec2-ec2",
+             ];
+}
+
++ (NSArray<NSDictionary *> *)corpora {
+    static NSArray *corpora = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        NSMutableArray *loadedCorpora = [NSMutableArray new];
+        for (NSString *corpusName in [self corpusNames]) {
+            NSString *filePath = [[NSBundle bundleForClass:self] pathForResource:corpusName ofType:@"json"];
+            NSData *data = [NSData dataWithContentsOfFile:filePath];
+            id corpus = data ? [NSJSONSerialization JSONObjectWithData:data options:0 error:nil] : nil;
+            if ([corpus isKindOfClass:[NSDictionary class]]) {
+                [loadedCorpora addObject:corpus];
+            }
+        }
+        corpora = loadedCorpora;
+    });
+    return corpora;
+}
+
++ (NSDictionary *)environment {
+    return [[NSProcessInfo processInfo] environment];
+}
+
+#pragma mark - Encoding and decoding
+
+- (NSURL *)endpointForCorpus:(NSDictionary *)corpus {
+    NSString *endpointPrefix = corpus[@"definition"][@"metadata"][@"endpointPrefix"];
+    return [NSURL URLWithString:[NSString stringWithFormat:@"https://%@.us-east-1.amazonaws.com", endpointPrefix]];
+}
+
+// Serializes the request of a case the way the service client does, and
+// returns it, or nil and an error.
+- (NSURLRequest *)encodeCase:(NSDictionary *)benchmarkCase
+                      corpus:(NSDictionary *)corpus
+                       error:(NSError *__autoreleasing *)error {
+    NSDictionary *definition = corpus[@"definition"];
+    NSString *protocol = corpus[@"protocol"];
+    NSString *operation = benchmarkCase[@"operation"];
+    NSDictionary *parameters = benchmarkCase[@"request"];
+
+    NSMutableURLRequest *request = [NSMutableURLRequest requestWithURL:[self endpointForCorpus:corpus]];
+    if ([protocol isEqualToString:@"ec2"]) {
+        // The EC2 request serializer lives in the AWSEC2 module, and only
+        // writes the form with the EC2 flavour of the query writer.
+        request.HTTPMethod = @"POST";
+        request.HTTPBody = [AWSQueryFormWriter formDataForDictionary:parameters
+                                                          actionName:operation
+                                               serviceDefinitionRule:definition
+                                                            protocol:AWSQueryFormWriterProtocolEC2
+                                                               error:error];
+        return request.HTTPBody ? request : nil;
+    }
+
+    id<AWSURLRequestSerializer> serializer = nil;
+    if ([protocol isEqualToString:@"json"] || [protocol isEqualToString:@"rest-json"]) {
+        serializer = [[AWSJSONRequestSerializer alloc] initWithJSONDefinition:definition actionName:operation];
+    } else if ([protocol isEqualToString:@"rest-xml"]) {
+        serializer = [[AWSXMLRequestSerializer alloc] initWithJSONDefinition:definition actionName:operation];
+    } else {
+        serializer = [[AWSQueryStringRequestSerializer alloc] initWithJSONDefinition:definition actionName:operation];
+    }
+
+    AWSTask *task = [serializer serializeRequest:request headers:@{} parameters:parameters];
+    if (task.error) {
+        if (error) {
+            *error = task.error;
+        }
+        return nil;
+    }
+    return request;
+}
+
+- (NSHTTPURLResponse *)responseForCase:(NSDictionary *)benchmarkCase corpus:(NSDictionary *)corpus {
+    return [[NSHTTPURLResponse alloc] initWithURL:[self endpointForCorpus:corpus]
+                                       statusCode:[benchmarkCase[@"response"][@"status_code"] integerValue]
+                                      HTTPVersion:@"HTTP/1.1"
+                                     headerFields:benchmarkCase[@"response"][@"headers"]];
+}
+
+// Deserializes the recorded response of a case into the dictionary the output
+// model is built from.
+- (NSDictionary *)decodeCase:(NSDictionary *)benchmarkCase
+                      corpus:(NSDictionary *)corpus
+                    response:(NSHTTPURLResponse *)response
+                        data:(NSData *)data
+                       error:(NSError *__autoreleasing *)error {
+    NSDictionary *definition = corpus[@"definition"];
+    NSString *protocol = corpus[@"protocol"];
+    NSString *operation = benchmarkCase[@"operation"];
+
+    id<AWSHTTPURLResponseSerializer> serializer = nil;
+    if ([protocol isEqualToString:@"json"] || [protocol isEqualToString:@"rest-json"]) {
+        serializer = [[AWSJSONResponseSerializer alloc] initWithJSONDefinition:definition actionName:operation outputClass:nil];
+    } else {
+        serializer = [[AWSXMLResponseSerializer alloc] initWithJSONDefinition:definition actionName:operation outputClass:nil];
+    }
+
+    return [serializer responseObjectForResponse:response
+                                 originalRequest:nil
+                                  currentRequest:nil
+                                            data:data
+                                           error:error];
+}
+
+- (AWSSerializationBenchmarkMeasurement *)measureIterations:(NSUInteger)iterations block:(void (^)(void))block {
+    // Warm up the caches of the serializers.
+    for (NSUInteger i = 0; i < 2; i++) {
+        @autoreleasepool {
+            block();
+        }
+    }
+
+    uint64_t elapsed = 0;
+    AWSStartCountingAllocations();
+    for (NSUInteger i = 0; i < iterations; i++) {
+        @autoreleasepool {
+            uint64_t start = mach_absolute_time();
+            block();
+            elapsed += mach_absolute_time() - start;
+        }
+    }
+    AWSStopCountingAllocations();
+
+    AWSSerializationBenchmarkMeasurement *measurement = [AWSSerializationBenchmarkMeasurement new];
+    measurement.nanosecondsPerOperation = (double)AWSNanosecondsFromMachTime(elapsed) / iterations;
+    measurement.bytesPerOperation = (double)AWSAllocatedBytes / iterations;
+    measurement.allocationsPerOperation = (double)AWSAllocationCount / iterations;
+    return measurement;
+}
+
+#pragma mark - Report
+
+- (NSUInteger)iterations {
+    NSInteger iterations = [[[self class] environment][AWSSerializationBenchmarkIterationsKey] integerValue];
+    return iterations > 0 ? iterations : AWSSerializationBenchmarkDefaultIterations;
+}
+
+- (double)threshold {
+    NSString *threshold = [[self class] environment][AWSSerializationBenchmarkThresholdKey];
+    return threshold ? [threshold doubleValue] : AWSSerializationBenchmarkDefaultThreshold;
+}
+
+- (NSString *)reportPath {
+    NSString *reportPath = [[self class] environment][AWSSerializationBenchmarkReportKey];
+    return reportPath ?: [NSTemporaryDirectory() stringByAppendingPathComponent:@"serialization-benchmark.json"];
+}
+
+// Compares the encode and decode measurements of every case with the baseline
+// report, and returns a description of each metric that regressed by more than
+// the threshold.
+- (NSArray<NSString *> *)regressionsOfReport:(NSDictionary *)report
+                                  toBaseline:(NSDictionary *)baseline
+                                   threshold:(double)threshold {
+    NSMutableArray *regressions = [NSMutableArray new];
+    [report[@"cases"] enumerateKeysAndObjectsUsingBlock:^(NSString *caseName, NSDictionary *results, BOOL *stop) {
+        NSDictionary *baselineResults = baseline[@"cases"][caseName];
+        if (!baselineResults) {
+            return;
+        }
+        for (NSString *phase in @[@"encode", @"decode"]) {
+            for (NSString *metric in @[@"ns_per_op", @"bytes_per_op"]) {
+                double value = [results[phase][metric] doubleValue];
+                double baselineValue = [baselineResults[phase][metric] doubleValue];
+                if (baselineValue > 0 && value > baselineValue * (1 + threshold)) {
+                    [regressions addObject:[NSString stringWithFormat:@"%@ %@ %@: %.0f, baseline %.0f (+%.1f%%)",
+                                            caseName, phase, metric, value, baselineValue, (value / baselineValue - 1) * 100]];
+                }
+            }
+        }
+    }];
+    return [regressions sortedArrayUsingSelector:@selector(compare:)];
+}
+
+#pragma mark - Tests
+
+- (void)testCorpusCoversEveryProtocol {
+    NSArray *corpora = [[self class] corpora];
+    XCTAssertEqual([corpora count], [[[self class] corpusNames] count]);
+
+    NSSet *protocols = [NSSet setWithArray:[corpora valueForKey:@"protocol"]];
+    NSSet *expectedProtocols = [NSSet setWithArray:@[@"rest-xml", @"json", @"rest-json", @"query", @"ec2"]];
+    XCTAssertEqualObjects(protocols, expectedProtocols);
+}
+
+- (void)testCorpusRoundTrips {
+    for (NSDictionary *corpus in [[self class] corpora]) {
+        for (NSDictionary *benchmarkCase in corpus[@"cases"]) {
+            NSError *error = nil;
+            NSURLRequest *request = [self encodeCase:benchmarkCase corpus:corpus error:&error];
+            XCTAssertNil(error, @"%@ %@", corpus[@"service"], benchmarkCase[@"name"]);
+            XCTAssertNotNil(request, @"%@ %@", corpus[@"service"], benchmarkCase[@"name"]);
+
+            NSData *data = [benchmarkCase[@"response"][@"body"] dataUsingEncoding:NSUTF8StringEncoding];
+            NSDictionary *output = [self decodeCase:benchmarkCase
+                                             corpus:corpus
+                                           response:[self responseForCase:benchmarkCase corpus:corpus]
+                                               data:data
+                                              error:&error];
+            XCTAssertNil(error, @"%@ %@", corpus[@"service"], benchmarkCase[@"name"]);
+            XCTAssertTrue([output isKindOfClass:[NSDictionary class]] && [output count] > 0, @"%@ %@", corpus[@"service"], benchmarkCase[@"name"]);
+        }
+    }
+}
+
+- (void)testSerializationBenchmark {
+    NSUInteger iterations = [self iterations];
+    NSMutableDictionary *results = [NSMutableDictionary new];
+
+    for (NSDictionary *corpus in [[self class] corpora]) {
+        for (NSDictionary *benchmarkCase in corpus[@"cases"]) {
+            NSString *caseName = [NSString stringWithFormat:@"%@/%@/%@", corpus[@"protocol"], corpus[@"service"], benchmarkCase[@"name"]];
+            NSHTTPURLResponse *response = [self responseForCase:benchmarkCase corpus:corpus];
+            NSData *data = [benchmarkCase[@"response"][@"body"] dataUsingEncoding:NSUTF8StringEncoding];
+            NSURLRequest *request = [self encodeCase:benchmarkCase corpus:corpus error:nil];
+
+            AWSFootprintSampler *sampler = [AWSFootprintSampler new];
+            [sampler start];
+            AWSSerializationBenchmarkMeasurement *encode = [self measureIterations:iterations block:^{
+                [self encodeCase:benchmarkCase corpus:corpus error:nil];
+            }];
+            AWSSerializationBenchmarkMeasurement *decode = [self measureIterations:iterations block:^{
+                [self decodeCase:benchmarkCase corpus:corpus response:response data:data error:nil];
+            }];
+            [sampler stop];
+
+            results[caseName] = @{
+                                  @"encode" : [encode dictionaryValue],
+                                  @"decode" : [decode dictionaryValue],
+                                  @"request_body_bytes" : @([request.HTTPBody length]),
+                                  @"response_body_bytes" : @([data length]),
+                                  @"peak_footprint_bytes" : @(sampler.peakFootprint),
+                                  @"peak_footprint_growth_bytes" : @(sampler.peakFootprint - sampler.initialFootprint),
+                                  };
+            NSLog(@"%@: encode %.0f ns/op %.0f B/op, decode %.0f ns/op %.0f B/op, peak footprint %.1f MB",
+                  caseName,
+                  encode.nanosecondsPerOperation, encode.bytesPerOperation,
+                  decode.nanosecondsPerOperation, decode.bytesPerOperation,
+                  sampler.peakFootprint / (1024.0 * 1024.0));
+        }
+    }
+
+    NSDictionary *report = @{
+                             @"iterations" : @(iterations),
+                             @"cases" : results,
+                             };
+    NSData *reportData = [NSJSONSerialization dataWithJSONObject:report
+                                                         options:NSJSONWritingPrettyPrinted | NSJSONWritingSortedKeys
+                                                           error:nil];
+    XCTAssertTrue([reportData writeToFile:[self reportPath] atomically:YES], @"Unable to write the report to %@", [self reportPath]);
+    NSLog(@"Serialization benchmark report: %@", [self reportPath]);
+
+    NSString *baselinePath = [[self class] environment][AWSSerializationBenchmarkBaselineKey];
+    if (baselinePath) {
+        NSData *baselineData = [NSData dataWithContentsOfFile:baselinePath];
+        NSDictionary *baseline = baselineData ? [NSJSONSerialization JSONObjectWithData:baselineData options:0 error:nil] : nil;
+        XCTAssertNotNil(baseline, @"Unable to read the baseline report at %@", baselinePath);
+
+        NSArray *regressions = [self regressionsOfReport:report toBaseline:baseline threshold:[self threshold]];
+        XCTAssertEqual([regressions count], 0, @"Regressed by more than %.0f%%:\n%@",
+                       [self threshold] * 100, [regressions componentsJoinedByString:@"\n"]);
+    }
+}
+
+- (void)testRegressionsOfReport {
+    NSDictionary *baseline = @{@"cases" : @{
+                                       @"json/Kinesis/PutRecords" : @{
+                                               @"encode" : @{@"ns_per_op" : @(1000), @"bytes_per_op" : @(2000)},
+                                               @"decode" : @{@"ns_per_op" : @(1000), @"bytes_per_op" : @(2000)},
+                                               },
+                                       }};
+    NSDictionary *report = @{@"cases" : @{
+                                     @"json/Kinesis/PutRecords" : @{
+                                             @"encode" : @{@"ns_per_op" : @(1099), @"bytes_per_op" : @(1000)},
+                                             @"decode" : @{@"ns_per_op" : @(1101), @"bytes_per_op" : @(2500)},
+                                             },
+                                     @"json/Kinesis/New" : @{
+                                             @"encode" : @{@"ns_per_op" : @(5000), @"bytes_per_op" : @(5000)},
+                                             },
+                                     }};
+    NSArray *regressions = [self regressionsOfReport:report toBaseline:baseline threshold:0.1];
+    XCTAssertEqual([regressions count], 2);
+    XCTAssertTrue([regressions[0] hasPrefix:@"json/Kinesis/PutRecords decode bytes_per_op"]);
+    XCTAssertTrue([regressions[1] hasPrefix:@"json/Kinesis/PutRecords decode ns_per_op"]);
+}
+
+- (void)testPerformanceEncodingCorpus API_AVAILABLE(ios(13.0)) {
+    NSArray *corpora = [[self class] corpora];
+    [self measureWithMetrics:@[[XCTMemoryMetric new], [XCTClockMetric new]] block:^{
+        for (NSDictionary *corpus in corpora) {
+            for (NSDictionary *benchmarkCase in corpus[@"cases"]) {
+                @autoreleasepool {
+                    [self encodeCase:benchmarkCase corpus:corpus error:nil];
+                }
+            }
+        }
+    }];
+}
+
+- (void)testPerformanceDecodingCorpus API_AVAILABLE(ios(13.0)) {
+    NSArray *corpora = [[self class] corpora];
+    [self measureWithMetrics:@[[XCTMemoryMetric new], [XCTClockMetric new]] block:^{
+        for (NSDictionary *corpus in corpora) {
+            for (NSDictionary *benchmarkCase in corpus[@"cases"]) {
+                @autoreleasepool {
+                    NSData *data = [benchmarkCase[@"response"][@"body"] dataUsingEncoding:NSUTF8StringEncoding];
+                    [self decodeCase:benchmarkCase
+                              corpus:corpus
+                            response:[self responseForCase:benchmarkCase corpus:corpus]
+                                data:data
+                               error:nil];
+                }
+            }
+        }
+    }];
+}
+
+@end
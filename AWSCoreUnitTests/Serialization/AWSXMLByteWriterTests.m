@@ -0,0 +1,320 @@
+//
+// Copyright 2010-2021 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License.
+// A copy of the License is located at
+//
+// http://aws.amazon.com/apache2.0
+//
+// or in the "license" file accompanying this file. This file is distributed
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+//
+
+#import <XCTest/XCTest.h>
+#import "AWSCore.h"
+#import "AWSXMLWriter.h"
+#import "AWSXMLByteWriter.h"
+
+static NSString *const AWSXMLByteWriterTestsNamespace = @"http://s3.amazonaws.com/doc/2006-03-01/";
+
+@interface AWSXMLByteWriterTests : XCTestCase
+
+@property (nonatomic, strong) NSDictionary *serviceDefinition;
+
+@end
+
+@implementation AWSXMLByteWriterTests
+
+- (void)setUp {
+    [super setUp];
+    self.serviceDefinition = @{
+        @"metadata": @{@"apiVersion": @"2006-03-01", @"protocol": @"rest-xml"},
+        @"operations": @{
+                @"CompleteMultipartUpload": @{
+                        @"name": @"CompleteMultipartUpload",
+                        @"input": @{@"shape": @"CompleteMultipartUploadRequest"}
+                },
+                @"DeleteObjects": @{
+                        @"name": @"DeleteObjects",
+                        @"input": @{@"shape": @"DeleteObjectsRequest"}
+                }
+        },
+        @"shapes": @{
+                @"CompleteMultipartUploadRequest": @{
+                        @"type": @"structure",
+                        @"members": @{
+                                @"Bucket": @{@"shape": @"String", @"location": @"uri", @"locationName": @"Bucket"},
+                                @"MultipartUpload": @{@"shape": @"CompletedMultipartUpload", @"locationName": @"CompleteMultipartUpload",
+                                                      @"xmlNamespace": @{@"uri": AWSXMLByteWriterTestsNamespace}}
+                        },
+                        @"payload": @"MultipartUpload"
+                },
+                @"CompletedMultipartUpload": @{
+                        @"type": @"structure",
+                        @"members": @{
+                                @"Parts": @{@"shape": @"CompletedPartList", @"locationName": @"Part"}
+                        }
+                },
+                @"CompletedPartList": @{
+                        @"type": @"list",
+                        @"member": @{@"shape": @"CompletedPart"},
+                        @"flattened": @YES
+                },
+                @"CompletedPart": @{
+                        @"type": @"structure",
+                        @"members": @{
+                                @"ETag": @{@"shape": @"String"},
+                                @"PartNumber": @{@"shape": @"Integer"}
+                        }
+                },
+                @"DeleteObjectsRequest": @{
+                        @"type": @"structure",
+                        @"members": @{
+                                @"Bucket": @{@"shape": @"String", @"location": @"uri", @"locationName": @"Bucket"},
+                                @"Delete": @{@"shape": @"Delete", @"locationName": @"Delete",
+                                             @"xmlNamespace": @{@"uri": AWSXMLByteWriterTestsNamespace}}
+                        },
+                        @"payload": @"Delete"
+                },
+                @"Delete": @{
+                        @"type": @"structure",
+                        @"members": @{
+                                @"Objects": @{@"shape": @"ObjectIdentifierList", @"locationName": @"Object"},
+                                @"Quiet": @{@"shape": @"Boolean"}
+                        }
+                },
+                @"ObjectIdentifierList": @{
+                        @"type": @"list",
+                        @"member": @{@"shape": @"ObjectIdentifier"},
+                        @"flattened": @YES
+                },
+                @"ObjectIdentifier": @{
+                        @"type": @"structure",
+                        @"members": @{
+                                @"Key": @{@"shape": @"String"},
+                                @"VersionId": @{@"shape": @"String"}
+                        }
+                },
+                @"String": @{@"type": @"string"},
+                @"Integer": @{@"type": @"integer"},
+                @"Boolean": @{@"type": @"boolean"}
+        }
+    };
+}
+
+#pragma mark - Helpers
+
+// Drives either writer the same way `AWSXMLBuilder` does for a CompleteMultipartUpload request.
+- (void)writeCompleteMultipartUploadWithPartCount:(NSUInteger)count writer:(id)writer {
+    [writer writeStartElement:@"CompleteMultipartUpload"];
+    [writer writeAttribute:@"xmlns" value:AWSXMLByteWriterTestsNamespace];
+    for (NSUInteger i = 1; i <= count; i++) {
+        [writer writeStartElement:@"Part"];
+        [writer writeStartElement:@"ETag"];
+        [writer writeCharacters:[NSString stringWithFormat:@"\"%032lx\"", (unsigned long)i * 2654435761u]];
+        [writer writeEndElement:@"ETag"];
+        [writer writeStartElement:@"PartNumber"];
+        [writer writeCharacters:[@(i) stringValue]];
+        [writer writeEndElement:@"PartNumber"];
+        [writer writeEndElement:@"Part"];
+    }
+    [writer writeEndElement:@"CompleteMultipartUpload"];
+}
+
+- (void)writeDeleteObjectsWithKeyCount:(NSUInteger)count writer:(id)writer {
+    [writer writeStartElement:@"Delete"];
+    [writer writeAttribute:@"xmlns" value:AWSXMLByteWriterTestsNamespace];
+    for (NSUInteger i = 0; i < count; i++) {
+        [writer writeStartElement:@"Object"];
+        [writer writeStartElement:@"Key"];
+        [writer writeCharacters:[NSString stringWithFormat:@"photos/2021/<album & \"trip\">/ünïcödé-%lu.jpg", (unsigned long)i]];
+        [writer writeEndElement:@"Key"];
+        [writer writeEndElement:@"Object"];
+    }
+    [writer writeStartElement:@"Quiet"];
+    [writer writeCharacters:@"true"];
+    [writer writeEndElement:@"Quiet"];
+    [writer writeEndElement:@"Delete"];
+}
+
+- (NSDictionary *)completeMultipartUploadParametersWithPartCount:(NSUInteger)count {
+    NSMutableArray *parts = [NSMutableArray arrayWithCapacity:count];
+    for (NSUInteger i = 1; i <= count; i++) {
+        [parts addObject:@{@"ETag": [NSString stringWithFormat:@"\"%032lx\"", (unsigned long)i * 2654435761u],
+                           @"PartNumber": @(i)}];
+    }
+    return @{@"Bucket": @"bucket", @"MultipartUpload": @{@"Parts": parts}};
+}
+
+- (NSDictionary *)deleteObjectsParametersWithKeyCount:(NSUInteger)count {
+    NSMutableArray *objects = [NSMutableArray arrayWithCapacity:count];
+    for (NSUInteger i = 0; i < count; i++) {
+        [objects addObject:@{@"Key": [NSString stringWithFormat:@"photos/2021/<album & \"trip\">/ünïcödé-%lu.jpg", (unsigned long)i]}];
+    }
+    return @{@"Bucket": @"bucket", @"Delete": @{@"Objects": objects, @"Quiet": @YES}};
+}
+
+#pragma mark - Tests
+
+- (void)testMatchesXMLWriter {
+    AWSXMLWriter *xmlWriter = [AWSXMLWriter new];
+    AWSXMLByteWriter *byteWriter = [AWSXMLByteWriter new];
+    [self writeCompleteMultipartUploadWithPartCount:3 writer:xmlWriter];
+    [self writeCompleteMultipartUploadWithPartCount:3 writer:byteWriter];
+    XCTAssertEqualObjects([byteWriter toString], [xmlWriter toString]);
+    XCTAssertEqualObjects([byteWriter toData], [xmlWriter toData]);
+
+    xmlWriter = [AWSXMLWriter new];
+    byteWriter = [AWSXMLByteWriter new];
+    [self writeDeleteObjectsWithKeyCount:3 writer:xmlWriter];
+    [self writeDeleteObjectsWithKeyCount:3 writer:byteWriter];
+    XCTAssertEqualObjects([byteWriter toString], [xmlWriter toString]);
+    XCTAssertEqualObjects([byteWriter toData], [xmlWriter toData]);
+}
+
+- (void)testEscapingMatchesXMLWriter {
+    NSArray *values = @[@"",
+                        @"plain",
+                        @"<a href=\"x\">&amp;</a>",
+                        @"tab\tline\nreturn\r bell\a null\x01 end",
+                        @"café 日本語",
+                        [NSString stringWithFormat:@"valid%C%C nonchar%C%C", (unichar)0xD7FF, (unichar)0xFFFD, (unichar)0xFFFE, (unichar)0xFFFF],
+                        [@"" stringByPaddingToLength:3000 withString:@"é<&>\"" startingAtIndex:0]];
+    for (NSString *value in values) {
+        AWSXMLWriter *xmlWriter = [AWSXMLWriter new];
+        AWSXMLByteWriter *byteWriter = [AWSXMLByteWriter new];
+        for (id writer in @[xmlWriter, byteWriter]) {
+            [writer writeStartElement:@"Root"];
+            [writer writeAttribute:@"value" value:value];
+            [writer writeStartElement:@"Empty"];
+            [writer writeEndElement];
+            [writer writeStartElement:@"Text"];
+            [writer writeCharacters:value];
+            [writer writeEndElement];
+            [writer writeEndElement];
+        }
+        XCTAssertEqualObjects([byteWriter toString], [xmlWriter toString], @"%@", value);
+        XCTAssertEqual(byteWriter.level, 0);
+    }
+}
+
+- (void)testSupplementaryCharactersAndUnpairedSurrogates {
+    AWSXMLByteWriter *writer = [AWSXMLByteWriter new];
+    [writer writeStartElement:@"Key"];
+    NSString *value = [NSString stringWithFormat:@"a\U0001F600b%C%Cc", (unichar)0xD800, (unichar)0xDC00];
+    [writer writeCharacters:[value stringByAppendingString:[NSString stringWithFormat:@"%C", (unichar)0xDBFF]]];
+    [writer writeEndElement:@"Key"];
+    XCTAssertEqualObjects([writer toString], @"\n<Key>a\U0001F600b\U00010000c</Key>");
+
+    writer = [AWSXMLByteWriter new];
+    [writer writeStartElement:@"Key"];
+    [writer writeCharacters:[NSString stringWithFormat:@"x%Cy", (unichar)0xDC00]];
+    [writer writeEndElement:@"Key"];
+    XCTAssertEqualObjects([writer toString], @"\n<Key>xy</Key>");
+}
+
+- (void)testInvalidUsage {
+    AWSXMLByteWriter *writer = [AWSXMLByteWriter new];
+    XCTAssertThrows([writer writeEndElement]);
+    XCTAssertThrows([writer writeEndElement:@"Key"]);
+    XCTAssertThrows([writer writeAttribute:@"xmlns" value:@"uri"]);
+}
+
+- (void)testDeepNesting {
+    AWSXMLWriter *xmlWriter = [AWSXMLWriter new];
+    AWSXMLByteWriter *byteWriter = [AWSXMLByteWriter new];
+    for (id writer in @[xmlWriter, byteWriter]) {
+        for (int i = 0; i < 100; i++) {
+            [writer writeStartElement:[NSString stringWithFormat:@"Level%d", i]];
+        }
+        [writer writeCharacters:@"leaf"];
+        for (int i = 0; i < 100; i++) {
+            [writer writeEndElement];
+        }
+    }
+    XCTAssertEqualObjects([byteWriter toString], [xmlWriter toString]);
+}
+
+- (void)testXMLBuilderCompleteMultipartUpload {
+    NSError *error = nil;
+    NSString *xml = [AWSXMLBuilder xmlStringForDictionary:[self completeMultipartUploadParametersWithPartCount:2]
+                                               actionName:@"CompleteMultipartUpload"
+                                    serviceDefinitionRule:self.serviceDefinition
+                                                    error:&error];
+    XCTAssertNil(error);
+    XCTAssertTrue([xml hasPrefix:@"\n<CompleteMultipartUpload xmlns=\"http://s3.amazonaws.com/doc/2006-03-01/\">\n\t<Part>"]);
+    XCTAssertTrue([xml containsString:@"\n\t\t<PartNumber>2</PartNumber>"]);
+    XCTAssertTrue([xml containsString:@"<ETag>&quot;0000000000000000000000009e3779b1&quot;</ETag>"]);
+    XCTAssertTrue([xml hasSuffix:@"</Part>\n</CompleteMultipartUpload>"]);
+}
+
+- (void)testXMLBuilderDeleteObjects {
+    NSError *error = nil;
+    NSData *data = [AWSXMLBuilder xmlDataForDictionary:[self deleteObjectsParametersWithKeyCount:1]
+                                            actionName:@"DeleteObjects"
+                                 serviceDefinitionRule:self.serviceDefinition
+                                                 error:&error];
+    XCTAssertNil(error);
+    NSString *xml = [[NSString alloc] initWithData:data encoding:NSUTF8StringEncoding];
+    XCTAssertTrue([xml containsString:@"\n\t<Object>\n\t\t<Key>photos/2021/&lt;album &amp; &quot;trip&quot;&gt;/ünïcödé-0.jpg</Key>\n\t</Object>"]);
+    XCTAssertTrue([xml containsString:@"\n\t<Quiet>true</Quiet>"]);
+}
+
+#pragma mark - Benchmarks
+
+- (void)testPerformanceCompleteMultipartUploadXMLWriter {
+    [self measureBlock:^{
+        AWSXMLWriter *writer = [AWSXMLWriter new];
+        [self writeCompleteMultipartUploadWithPartCount:10000 writer:writer];
+        XCTAssertNotNil([writer toData]);
+    }];
+}
+
+- (void)testPerformanceCompleteMultipartUploadByteWriter {
+    [self measureBlock:^{
+        AWSXMLByteWriter *writer = [AWSXMLByteWriter new];
+        [self writeCompleteMultipartUploadWithPartCount:10000 writer:writer];
+        XCTAssertNotNil([writer toData]);
+    }];
+}
+
+- (void)testPerformanceDeleteObjectsXMLWriter {
+    [self measureBlock:^{
+        AWSXMLWriter *writer = [AWSXMLWriter new];
+        [self writeDeleteObjectsWithKeyCount:1000 writer:writer];
+        XCTAssertNotNil([writer toData]);
+    }];
+}
+
+- (void)testPerformanceDeleteObjectsByteWriter {
+    [self measureBlock:^{
+        AWSXMLByteWriter *writer = [AWSXMLByteWriter new];
+        [self writeDeleteObjectsWithKeyCount:1000 writer:writer];
+        XCTAssertNotNil([writer toData]);
+    }];
+}
+
+- (void)testPerformanceXMLBuilderCompleteMultipartUpload {
+    NSDictionary *parameters = [self completeMultipartUploadParametersWithPartCount:10000];
+    [self measureBlock:^{
+        XCTAssertNotNil([AWSXMLBuilder xmlDataForDictionary:parameters
+                                                 actionName:@"CompleteMultipartUpload"
+                                      serviceDefinitionRule:self.serviceDefinition
+                                                      error:nil]);
+    }];
+}
+
+- (void)testPerformanceXMLBuilderDeleteObjects {
+    NSDictionary *parameters = [self deleteObjectsParametersWithKeyCount:1000];
+    [self measureBlock:^{
+        XCTAssertNotNil([AWSXMLBuilder xmlDataForDictionary:parameters
+                                                 actionName:@"DeleteObjects"
+                                      serviceDefinitionRule:self.serviceDefinition
+                                                      error:nil]);
+    }];
+}
+
+@end
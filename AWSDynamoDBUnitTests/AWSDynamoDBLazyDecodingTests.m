@@ -0,0 +1,186 @@
+//
+// Copyright 2010-2021 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License.
+// A copy of the License is located at
+//
+// http://aws.amazon.com/apache2.0
+//
+// or in the "license" file accompanying this file. This file is distributed
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+//
+
+#import <XCTest/XCTest.h>
+#import <objc/runtime.h>
+#import "AWSDynamoDBModel.h"
+#import "AWSDynamoDBResources.h"
+
+static const NSUInteger AWSDynamoDBLazyDecodingTestsItemCount = 10000;
+
+@interface AWSDynamoDBLazyDecodingTests : XCTestCase
+
+@end
+
+@implementation AWSDynamoDBLazyDecodingTests
+
+// The body of a Scan response.
+- (NSData *)scanOutputData {
+    NSMutableArray *items = [NSMutableArray arrayWithCapacity:AWSDynamoDBLazyDecodingTestsItemCount];
+    for (NSUInteger i = 0; i < AWSDynamoDBLazyDecodingTestsItemCount; i++) {
+        [items addObject:@{
+                           @"id" : @{@"S" : [NSString stringWithFormat:@"item-%lu", (unsigned long)i]},
+                           @"count" : @{@"N" : [NSString stringWithFormat:@"%lu", (unsigned long)i]},
+                           @"active" : @{@"BOOL" : @(i % 2 == 0)},
+                           @"tags" : @{@"SS" : @[@"a", @"b", @"c"]},
+                           @"address" : @{@"M" : @{@"city" : @{@"S" : @"Seattle"},
+                                                   @"zip" : @{@"N" : @"98101"}}},
+                           @"history" : @{@"L" : @[@{@"N" : @"1"}, @{@"S" : @"two"}, @{@"NULL" : @(YES)}]},
+                           }];
+    }
+    NSDictionary *body = @{
+                           @"Count" : @(AWSDynamoDBLazyDecodingTestsItemCount),
+                           @"ScannedCount" : @(AWSDynamoDBLazyDecodingTestsItemCount),
+                           @"Items" : items,
+                           @"LastEvaluatedKey" : @{@"id" : @{@"S" : @"item-9999"}},
+                           @"ConsumedCapacity" : @{@"TableName" : @"table", @"CapacityUnits" : @(128.5)},
+                           };
+    return [NSJSONSerialization dataWithJSONObject:body options:0 error:nil];
+}
+
+- (NSHTTPURLResponse *)responseWithStatusCode:(NSInteger)statusCode {
+    return [[NSHTTPURLResponse alloc] initWithURL:[NSURL URLWithString:@"https://dynamodb.us-east-1.amazonaws.com"]
+                                       statusCode:statusCode
+                                      HTTPVersion:@"HTTP/1.1"
+                                     headerFields:@{@"Content-Type" : @"application/x-amz-json-1.0"}];
+}
+
+- (AWSJSONLazyDictionary *)lazyDictionaryForData:(NSData *)data statusCode:(NSInteger)statusCode {
+    return [AWSJSONLazyDictionary dictionaryForJsonData:data
+                                               response:[self responseWithStatusCode:statusCode]
+                                             actionName:@"Scan"
+                                  serviceDefinitionRule:[[AWSDynamoDBResources sharedInstance] JSONObject]];
+}
+
+- (NSDictionary *)eagerDictionaryForData:(NSData *)data {
+    return [AWSJSONParser dictionaryForJsonData:data
+                                       response:[self responseWithStatusCode:200]
+                                     actionName:@"Scan"
+                          serviceDefinitionRule:[[AWSDynamoDBResources sharedInstance] JSONObject]
+                                          error:nil];
+}
+
+- (void)testLazyModelEqualsEagerModel {
+    NSData *data = [self scanOutputData];
+    AWSDynamoDBScanOutput *eagerOutput = [AWSMTLJSONAdapter modelOfClass:[AWSDynamoDBScanOutput class]
+                                                       fromJSONDictionary:[self eagerDictionaryForData:data]
+                                                                    error:nil];
+
+    NSError *error = nil;
+    AWSDynamoDBScanOutput *lazyOutput = [AWSMTLJSONAdapter modelOfClass:[AWSDynamoDBScanOutput class]
+                                                      fromJSONDictionary:[self lazyDictionaryForData:data statusCode:200]
+                                                                   error:&error];
+    XCTAssertNil(error);
+    XCTAssertTrue([lazyOutput isKindOfClass:[AWSDynamoDBScanOutput class]]);
+    XCTAssertEqual([lazyOutput class], [AWSDynamoDBScanOutput class]);
+    XCTAssertNotEqual(object_getClass(lazyOutput), [AWSDynamoDBScanOutput class]);
+    XCTAssertEqualObjects(lazyOutput.lastEvaluatedKey[@"id"].S, @"item-9999");
+    XCTAssertEqualObjects(lazyOutput.items[42][@"address"].M[@"city"].S, @"Seattle");
+    XCTAssertEqualObjects(lazyOutput, eagerOutput);
+    XCTAssertEqualObjects([lazyOutput copy], eagerOutput);
+}
+
+- (void)testReadingMemberDoesNotParseOtherMembers {
+    // The items are not valid JSON, which only matters once they are read.
+    NSString *body = @"{\"Count\":2,\"LastEvaluatedKey\":{\"id\":{\"S\":\"b\"}},\"Items\":[{\"id\":{\"S\":\"a\"}},nul]}";
+    AWSJSONLazyDictionary *dictionary = [self lazyDictionaryForData:[body dataUsingEncoding:NSUTF8StringEncoding] statusCode:200];
+    XCTAssertNotNil(dictionary);
+    XCTAssertNil([self eagerDictionaryForData:[body dataUsingEncoding:NSUTF8StringEncoding]]);
+
+    AWSDynamoDBScanOutput *output = [AWSMTLJSONAdapter modelOfClass:[AWSDynamoDBScanOutput class]
+                                                  fromJSONDictionary:dictionary
+                                                               error:nil];
+    XCTAssertEqualObjects(output.count, @(2));
+    XCTAssertEqualObjects(output.lastEvaluatedKey[@"id"].S, @"b");
+    XCTAssertNil([AWSMTLJSONAdapter lazyDecodingErrorForModel:output]);
+    XCTAssertNil(output.items);
+    XCTAssertNotNil([AWSMTLJSONAdapter lazyDecodingErrorForModel:output]);
+}
+
+- (void)testKeysAgreeWithLookups {
+    NSString *body = @"{\"Count\":2,\"LastEvaluatedKey\":{\"id\":{\"S\":\"b\"}},\"Items\":[{\"id\":{\"S\":\"a\"}},nul]}";
+    AWSJSONLazyDictionary *dictionary = [self lazyDictionaryForData:[body dataUsingEncoding:NSUTF8StringEncoding] statusCode:200];
+    XCTAssertEqual([dictionary count], 2);
+    NSArray *keys = [[dictionary allKeys] sortedArrayUsingSelector:@selector(compare:)];
+    XCTAssertEqualObjects(keys, (@[@"Count", @"LastEvaluatedKey"]));
+    for (NSString *key in dictionary) {
+        XCTAssertNotNil(dictionary[key]);
+    }
+    XCTAssertNil(dictionary[@"Items"]);
+}
+
+- (void)testSettingPropertyBeforeReadingIt {
+    AWSDynamoDBScanOutput *output = [AWSMTLJSONAdapter modelOfClass:[AWSDynamoDBScanOutput class]
+                                                  fromJSONDictionary:[self lazyDictionaryForData:[self scanOutputData] statusCode:200]
+                                                               error:nil];
+    output.items = @[];
+    XCTAssertEqualObjects(output.items, @[]);
+    XCTAssertEqualObjects(output.count, @(AWSDynamoDBLazyDecodingTestsItemCount));
+}
+
+- (void)testUnsupportedResponsesAreNotParsedLazily {
+    XCTAssertNil([self lazyDictionaryForData:[self scanOutputData] statusCode:400]);
+    XCTAssertNil([self lazyDictionaryForData:[@"[]" dataUsingEncoding:NSUTF8StringEncoding] statusCode:200]);
+    XCTAssertNil([self lazyDictionaryForData:[@"{\"Count\":1" dataUsingEncoding:NSUTF8StringEncoding] statusCode:200]);
+    XCTAssertNil([self lazyDictionaryForData:[@"{\"Count\":1}}" dataUsingEncoding:NSUTF8StringEncoding] statusCode:200]);
+}
+
+- (void)testConcurrentReads {
+    AWSDynamoDBScanOutput *output = [AWSMTLJSONAdapter modelOfClass:[AWSDynamoDBScanOutput class]
+                                                  fromJSONDictionary:[self lazyDictionaryForData:[self scanOutputData] statusCode:200]
+                                                               error:nil];
+    __block NSUInteger failures = 0;
+    dispatch_apply(100, dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^(size_t iteration) {
+        if ([output.items count] != AWSDynamoDBLazyDecodingTestsItemCount
+            || ![output.lastEvaluatedKey[@"id"].S isEqualToString:@"item-9999"]) {
+            @synchronized (self) {
+                failures++;
+            }
+        }
+    });
+    XCTAssertEqual(failures, 0);
+}
+
+- (void)testPerformanceReadingPaginationTokenEagerly {
+    NSData *data = [self scanOutputData];
+    [self measureBlock:^{
+        AWSDynamoDBScanOutput *output = [AWSMTLJSONAdapter modelOfClass:[AWSDynamoDBScanOutput class]
+                                                      fromJSONDictionary:[self eagerDictionaryForData:data]
+                                                                   error:nil];
+        XCTAssertEqualObjects(output.lastEvaluatedKey[@"id"].S, @"item-9999");
+    }];
+}
+
+- (void)testPerformanceReadingPaginationTokenLazily {
+    NSData *data = [self scanOutputData];
+    [self measureBlock:^{
+        AWSDynamoDBScanOutput *output = [AWSMTLJSONAdapter modelOfClass:[AWSDynamoDBScanOutput class]
+                                                      fromJSONDictionary:[self lazyDictionaryForData:data statusCode:200]
+                                                                   error:nil];
+        XCTAssertEqualObjects(output.lastEvaluatedKey[@"id"].S, @"item-9999");
+    }];
+}
+
+- (void)testPerformanceMemoryReadingPaginationTokenLazily API_AVAILABLE(ios(13.0)) {
+    NSData *data = [self scanOutputData];
+    [self measureWithMetrics:@[[XCTMemoryMetric new], [XCTClockMetric new]] block:^{
+        AWSDynamoDBScanOutput *output = [AWSMTLJSONAdapter modelOfClass:[AWSDynamoDBScanOutput class]
+                                                      fromJSONDictionary:[self lazyDictionaryForData:data statusCode:200]
+                                                                   error:nil];
+        XCTAssertEqualObjects(output.lastEvaluatedKey[@"id"].S, @"item-9999");
+    }];
+}
+
+@end
@@ -0,0 +1,82 @@
+//
+// Copyright 2010-2021 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License.
+// A copy of the License is located at
+//
+// http://aws.amazon.com/apache2.0
+//
+// or in the "license" file accompanying this file. This file is distributed
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+//
+
+#import <XCTest/XCTest.h>
+#import "AWSDynamoDBModel.h"
+
+static const NSUInteger AWSDynamoDBModelDecodingTestsItemCount = 10000;
+
+@interface AWSDynamoDBModelDecodingTests : XCTestCase
+
+@end
+
+@implementation AWSDynamoDBModelDecodingTests
+
+// A Scan response as returned by NSJSONSerialization.
+- (NSDictionary *)scanOutputJSONDictionary {
+    NSMutableArray *items = [NSMutableArray arrayWithCapacity:AWSDynamoDBModelDecodingTestsItemCount];
+    for (NSUInteger i = 0; i < AWSDynamoDBModelDecodingTestsItemCount; i++) {
+        [items addObject:@{
+                           @"id" : @{@"S" : [NSString stringWithFormat:@"item-%lu", (unsigned long)i]},
+                           @"count" : @{@"N" : [NSString stringWithFormat:@"%lu", (unsigned long)i]},
+                           @"active" : @{@"BOOL" : @(i % 2 == 0)},
+                           @"tags" : @{@"SS" : @[@"a", @"b", @"c"]},
+                           @"address" : @{@"M" : @{@"city" : @{@"S" : @"Seattle"},
+                                                   @"zip" : @{@"N" : @"98101"}}},
+                           @"history" : @{@"L" : @[@{@"N" : @"1"}, @{@"S" : @"two"}, @{@"NULL" : @(YES)}]},
+                           }];
+    }
+    return @{
+             @"Count" : @(AWSDynamoDBModelDecodingTestsItemCount),
+             @"ScannedCount" : @(AWSDynamoDBModelDecodingTestsItemCount),
+             @"Items" : items,
+             @"LastEvaluatedKey" : @{@"id" : @{@"S" : @"item-9999"}},
+             @"ConsumedCapacity" : @{@"TableName" : @"table", @"CapacityUnits" : @(128.5)},
+             };
+}
+
+- (void)testDecodingScanOutput {
+    NSError *error = nil;
+    AWSDynamoDBScanOutput *output = [AWSMTLJSONAdapter modelOfClass:[AWSDynamoDBScanOutput class]
+                                                  fromJSONDictionary:[self scanOutputJSONDictionary]
+                                                               error:&error];
+    XCTAssertNil(error);
+    XCTAssertEqualObjects(output.count, @(AWSDynamoDBModelDecodingTestsItemCount));
+    XCTAssertEqual([output.items count], AWSDynamoDBModelDecodingTestsItemCount);
+    XCTAssertEqualObjects(output.consumedCapacity.tableName, @"table");
+    XCTAssertEqualObjects(output.lastEvaluatedKey[@"id"].S, @"item-9999");
+
+    NSDictionary<NSString *, AWSDynamoDBAttributeValue *> *item = output.items[42];
+    XCTAssertEqualObjects(item[@"id"].S, @"item-42");
+    XCTAssertEqualObjects(item[@"count"].N, @"42");
+    XCTAssertEqualObjects(item[@"active"].BOOLEAN, @(YES));
+    XCTAssertEqualObjects(item[@"tags"].SS, (@[@"a", @"b", @"c"]));
+    XCTAssertEqualObjects(item[@"address"].M[@"city"].S, @"Seattle");
+    XCTAssertEqual([item[@"history"].L count], 3);
+    XCTAssertEqualObjects(item[@"history"].L[1].S, @"two");
+    XCTAssertEqualObjects(item[@"history"].L[2].NIL, @(YES));
+}
+
+- (void)testPerformanceDecodingScanOutput {
+    NSDictionary *JSONDictionary = [self scanOutputJSONDictionary];
+    [self measureBlock:^{
+        AWSDynamoDBScanOutput *output = [AWSMTLJSONAdapter modelOfClass:[AWSDynamoDBScanOutput class]
+                                                      fromJSONDictionary:JSONDictionary
+                                                                   error:nil];
+        XCTAssertEqual([output.items count], AWSDynamoDBModelDecodingTestsItemCount);
+    }];
+}
+
+@end
@@ -62,18 +62,17 @@
     
     //Need to add version and actionName
     NSError *error = nil;
-    NSDictionary *formattedParams = [AWSEC2ParamBuilder buildFormattedParams:parameters
-                                                                  actionName:self.actionName
-                                                       serviceDefinitionRule:self.serviceDefinitionJSON error:&error];
+    NSData *formData = [AWSQueryFormWriter formDataForDictionary:parameters
+                                                      actionName:self.actionName
+                                           serviceDefinitionRule:self.serviceDefinitionJSON
+                                                        protocol:AWSQueryFormWriterProtocolEC2
+                                                           error:&error];
     if (error) {
         return [AWSTask taskWithError:error];
     }
     
-    NSMutableString *queryString = [NSMutableString new];
-    [self processParameters:formattedParams queryString:queryString];
-    
-    if ([queryString length] > 0) {
-        request.HTTPBody = [queryString dataUsingEncoding:NSUTF8StringEncoding];
+    if ([formData length] > 0) {
+        request.HTTPBody = formData;
     }
     
     //contruct additional headers
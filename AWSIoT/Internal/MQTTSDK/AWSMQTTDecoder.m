@@ -54,13 +54,11 @@ int maxLengthMultiplier = 128 * 128 * 128;
 }
 
 - (void)stream:(NSStream*)sender handleEvent:(NSStreamEvent)eventCode {
-    AWSDDLogVerbose(@"%s [Line %d] EventCode:%lu, status:%lu, stream: %@, Thread: %@",
-                    __PRETTY_FUNCTION__,
-                    __LINE__,
+    // The function, line and thread are part of every log message.
+    AWSDDLogVerbose(@"EventCode:%lu, status:%lu, stream: %@",
                     (unsigned long)eventCode,
                     (unsigned long)_status,
-                    sender,
-                    [NSThread currentThread]);
+                    sender);
 
     if (stream == nil) {
         return;
@@ -56,7 +56,8 @@
     if(stream == nil)
         return;
 
-    AWSDDLogVerbose(@"%s [Line %d] EventCode:%lu, Thread: %@", __PRETTY_FUNCTION__, __LINE__, (unsigned long)eventCode, [NSThread currentThread]);
+    // The function, line and thread are part of every log message.
+    AWSDDLogVerbose(@"EventCode:%lu", (unsigned long)eventCode);
     switch (eventCode) {
         case NSStreamEventOpenCompleted:
             break;
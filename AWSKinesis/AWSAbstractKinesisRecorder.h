@@ -16,16 +16,91 @@
 #import <Foundation/Foundation.h>
 #import <AWSCore/AWSService.h>
 
+/**
+ When the task returned by `saveRecord:streamName:` completes.
+ */
+typedef NS_ENUM(NSInteger, AWSKinesisRecorderSaveDurability) {
+    /**
+     The task completes once the record is committed to the database on disk. Records saved while the previous records are being written are committed together, in a single transaction.
+     */
+    AWSKinesisRecorderSaveDurabilityCommitted,
+    /**
+     The task completes once the record is added to the buffer in memory, and the record is committed later with the records saved after it. Records which are not committed yet are lost if the app is terminated.
+     */
+    AWSKinesisRecorderSaveDurabilityBuffered,
+};
+
+/**
+ How a recorder stores the saved records on disk.
+ */
+typedef NS_ENUM(NSInteger, AWSKinesisRecorderStorage) {
+    /**
+     The records are stored in a SQLite database.
+     */
+    AWSKinesisRecorderStorageDatabase,
+    /**
+     The records are appended to a log of segment files, and submitted in the order they were saved. A segment file is deleted once all of its records are submitted. Records which are partially written when the app is terminated are discarded when the recorder is created again.
+     */
+    AWSKinesisRecorderStorageLog,
+};
+
+/**
+ The default number of saved records committed in a transaction, 500.
+ */
+FOUNDATION_EXPORT NSUInteger const AWSKinesisAbstractClientSaveBatchRecordCountDefault;
+
+/**
+ The records of a stream which are saved to disk and not submitted yet.
+ */
+@interface AWSKinesisRecorderStreamBacklog : NSObject
+
+/**
+ The name of the stream.
+ */
+@property (nonatomic, strong, readonly) NSString *streamName;
+
+/**
+ The number of records.
+ */
+@property (nonatomic, assign, readonly) NSUInteger recordCount;
+
+/**
+ The number of bytes of the data and partition keys of the records.
+ */
+@property (nonatomic, assign, readonly) NSUInteger byteCount;
+
+/**
+ When the oldest record was saved.
+ */
+@property (nonatomic, strong, readonly) NSDate *oldestRecordDate;
+
+/**
+ When the backoff of the stream ends, or `nil` if the stream is not throttled. `submitAllRecords` does not send records to the stream until then.
+ */
+@property (nonatomic, strong, readonly) NSDate *backoffDate;
+
+@end
+
 /**
  `AWSAbstractKinesisRecorder` is an abstract class. You should not instantiate this class directly. Instead use its concrete subclasses `AWSKinesisRecorder` and `AWSFirehoseRecorder`.
  */
 @interface AWSAbstractKinesisRecorder : AWSService
 
 /**
- The number of bytes currently used to store AWSKinesisPutRecordInput objects on disk.
+ How the recorder stores the saved records. The records saved with one storage are not submitted by a recorder created with the other.
+ */
+@property (nonatomic, assign, readonly) AWSKinesisRecorderStorage storage;
+
+/**
+ The number of bytes currently used to store AWSKinesisPutRecordInput objects on disk. With `AWSKinesisRecorderStorageLog`, it is the number of bytes of the records which are not submitted yet.
  */
 @property (nonatomic, assign, readonly) NSUInteger diskBytesUsed;
 
+/**
+ The records which are saved to disk and not submitted yet, for each stream which has records, in the order of the stream names. With `AWSKinesisRecorderStorageLog`, the records are read from the log to count them.
+ */
+@property (nonatomic, strong, readonly) NSArray<AWSKinesisRecorderStreamBacklog *> *streamBacklogs;
+
 /**
  The threshold of disk bytes for notification. When exceeded, `saveRecord:streamName:` posts AWSKinesisRecorderByteThresholdReachedNotification. The default is 0 meaning it will not post the notification.
  @discussion The `notificationByteThreshold` should be smaller than `diskByteLimit`.
@@ -43,10 +118,32 @@
 @property (nonatomic, assign) NSTimeInterval diskAgeLimit;
 
 /**
- The maxium batch data size in bytes. The default value is 512KB. The maximum is 4MB.
+ The maxium batch data size in bytes. The default value is 512KB. The maximum is 5MB for Kinesis and 4MB for Firehose. A request also takes at most 500 records.
  */
 @property (nonatomic, assign) NSUInteger batchRecordsByteLimit;
 
+/**
+ When the tasks returned by `saveRecord:streamName:` complete. The default is `AWSKinesisRecorderSaveDurabilityCommitted`.
+ */
+@property (nonatomic, assign) AWSKinesisRecorderSaveDurability saveDurability;
+
+/**
+ The maximum time in seconds a saved record waits in memory for more records to be committed with. Waiting lets more records share a transaction when records are saved one after the other. The default is 0, which commits the records saved while the previous records are being written.
+ */
+@property (nonatomic, assign) NSTimeInterval saveInterval;
+
+/**
+ The number of saved records which are committed without waiting for `saveInterval`. The default value is 500.
+ */
+@property (nonatomic, assign) NSUInteger saveBatchRecordCount;
+
+/**
+ The maximum number of requests `submitAllRecords` keeps in flight at once. The requests are shared fairly between the streams which have records to submit. The default value is 4.
+
+ When the records of a stream are throttled, or a request to a stream fails, no more requests are sent to the stream until its backoff delay passes, which starts at one second and doubles up to a minute while the stream keeps being throttled. When a request fails because the device is offline, no more requests are sent at all. The records which were not submitted are kept.
+ */
+@property (nonatomic, assign) NSUInteger submitConcurrencyLimit;
+
 /**
  Saves a record to local storage to be sent later. The record will be submitted to the streamName provided with a randomly generated partition key to ensure equal distribution across shards.
 
@@ -16,6 +16,8 @@
 #import <CommonCrypto/CommonDigest.h>
 #import "AWSAbstractKinesisRecorder.h"
 #import "AWSKinesis.h"
+#import "AWSKinesisRecordAggregator.h"
+#import "AWSKinesisRecordLog.h"
 
 // Kinesis Abstract Client
 NSUInteger const AWSKinesisAbstractClientByteLimitDefault = 5 * 1024 * 1024; // 5MB
@@ -23,6 +25,11 @@ NSTimeInterval const AWSKinesisAbstractClientAgeLimitDefault = 0.0; // Keeps the
 NSString *const AWSKinesisAbstractClientUserAgent = @"recorder";
 NSUInteger const AWSKinesisAbstractClientBatchRecordByteLimitDefault = 512 * 1024; // 512KB
 NSString *const AWSKinesisAbstractClientRecorderDatabasePathPrefix = @"com/amazonaws/AWSKinesisRecorder";
+NSUInteger const AWSKinesisAbstractClientSaveBatchRecordCountDefault = 500;
+NSUInteger const AWSKinesisAbstractClientSubmitConcurrencyLimitDefault = 4;
+NSTimeInterval const AWSKinesisAbstractClientStreamBackoffDelayMin = 1.0;
+NSTimeInterval const AWSKinesisAbstractClientStreamBackoffDelayMax = 60.0;
+NSTimeInterval const AWSKinesisAbstractClientAggregationLingerIntervalDefault = 0.1;
 
 @protocol AWSKinesisRecorderHelper <NSObject>
 
@@ -32,8 +39,14 @@ NSString *const AWSKinesisAbstractClientRecorderDatabasePathPrefix = @"com/amazo
                             records:(NSArray *)temporaryRecords
                              rowIds:(NSArray *)rowIds
                           putRowIds:(NSMutableArray *)putRowIds
-                        retryRowIds:(NSMutableArray *)retryRowIds
-                               stop:(BOOL *)stop;
+                        retryRowIds:(NSMutableArray *)retryRowIds;
+
+- (NSUInteger)batchRecordCountLimit;
+
+- (NSUInteger)batchByteLimit;
+
+- (NSString *)cachedShardIdForStream:(NSString *)streamName
+                        partitionKey:(NSString *)partitionKey;
 
 - (NSError *)dataTooLargeError;
 
@@ -43,11 +56,149 @@ NSString *const AWSKinesisAbstractClientRecorderDatabasePathPrefix = @"com/amazo
 
 @end
 
+@class AWSKinesisRecorderSubmitWindow;
+
+// The records of a stream sent in one request.
+@interface AWSKinesisRecorderSubmitBatch : NSObject
+
+@property (nonatomic, strong) NSString *streamName;
+@property (nonatomic, strong) NSMutableArray<NSDictionary *> *records;
+@property (nonatomic, strong) NSMutableArray *rowIds;
+@property (nonatomic, strong) NSMutableArray *putRowIds;
+@property (nonatomic, strong) NSMutableArray *retryRowIds;
+@property (nonatomic, assign) BOOL submitted;
+@property (nonatomic, weak) AWSKinesisRecorderSubmitWindow *window;
+
+@end
+
+@implementation AWSKinesisRecorderSubmitBatch
+
+- (instancetype)init {
+    if (self = [super init]) {
+        _records = [NSMutableArray new];
+        _rowIds = [NSMutableArray new];
+        _putRowIds = [NSMutableArray new];
+        _retryRowIds = [NSMutableArray new];
+    }
+    return self;
+}
+
+@end
+
+// The records of the record log read at once, which are acknowledged together once their batches are complete.
+@interface AWSKinesisRecorderSubmitWindow : NSObject
+
+@property (nonatomic, assign) unsigned long long nextOffset;
+@property (nonatomic, assign) NSUInteger pendingBatchCount;
+@property (nonatomic, assign) BOOL submitted;
+@property (nonatomic, strong) NSMutableArray<AWSKinesisRecordLogEntry *> *keptRecords;
+
+@end
+
+@implementation AWSKinesisRecorderSubmitWindow
+
+- (instancetype)init {
+    if (self = [super init]) {
+        _keptRecords = [NSMutableArray new];
+    }
+    return self;
+}
+
+@end
+
+// The records of a stream of the database which a submission has read.
+@interface AWSKinesisRecorderStreamCursor : NSObject
+
+@property (nonatomic, strong) NSString *streamName;
+@property (nonatomic, assign) NSTimeInterval timestamp;
+@property (nonatomic, assign) int64_t rowId;
+@property (nonatomic, assign) BOOL exhausted;
+@property (nonatomic, assign) NSUInteger inFlightBatchCount;
+
+@end
+
+@implementation AWSKinesisRecorderStreamCursor
+
+- (instancetype)init {
+    if (self = [super init]) {
+        _timestamp = -1;
+    }
+    return self;
+}
+
+@end
+
+// The time until which a throttled stream is not submitted to.
+@interface AWSKinesisRecorderStreamBackoff : NSObject
+
+@property (nonatomic, assign) NSTimeInterval delay;
+@property (nonatomic, strong) NSDate *date;
+
+@end
+
+@implementation AWSKinesisRecorderStreamBackoff
+
+@end
+
+// The state of a run of `submitAllRecords`. Only used on the shared submit executor.
+@interface AWSKinesisRecorderSubmission : NSObject
+
+@property (nonatomic, strong) AWSTaskCompletionSource *taskCompletionSource;
+@property (nonatomic, assign) NSUInteger inFlightBatchCount;
+@property (nonatomic, assign) BOOL stopped;
+@property (nonatomic, strong) NSError *error;
+@property (nonatomic, strong) NSMutableDictionary<NSString *, AWSKinesisRecorderStreamCursor *> *streamCursors;
+@property (nonatomic, assign) NSUInteger nextStreamIndex;
+@property (nonatomic, assign) BOOL exhausted;
+@property (nonatomic, assign) unsigned long long cursorOffset;
+@property (nonatomic, assign) unsigned long long cursorEndOffset;
+@property (nonatomic, strong) NSMutableArray<AWSKinesisRecorderSubmitWindow *> *windows;
+
+@end
+
+@implementation AWSKinesisRecorderSubmission
+
+- (instancetype)init {
+    if (self = [super init]) {
+        _taskCompletionSource = [AWSTaskCompletionSource taskCompletionSource];
+        _streamCursors = [NSMutableDictionary new];
+        _windows = [NSMutableArray new];
+    }
+    return self;
+}
+
+@end
+
+@interface AWSKinesisRecorderStreamBacklog()
+
+@property (nonatomic, strong) NSString *streamName;
+@property (nonatomic, assign) NSUInteger recordCount;
+@property (nonatomic, assign) NSUInteger byteCount;
+@property (nonatomic, strong) NSDate *oldestRecordDate;
+@property (nonatomic, strong) NSDate *backoffDate;
+
+@end
+
+@implementation AWSKinesisRecorderStreamBacklog
+
+@end
+
 @interface AWSAbstractKinesisRecorder()
 
 @property (nonatomic, strong) id<AWSKinesisRecorderHelper> recorderHelper;
 @property (nonatomic, strong) AWSFMDatabaseQueue *databaseQueue;
+@property (nonatomic, strong) AWSFMDatabasePool *databaseReaderPool;
+@property (nonatomic, strong) AWSKinesisRecordLog *recordLog;
 @property (nonatomic, strong) NSString *databasePath;
+@property (nonatomic, strong) NSObject *saveLock;
+@property (nonatomic, strong) NSMutableArray<NSArray *> *bufferedRecords;
+@property (nonatomic, strong) NSMutableArray<AWSTaskCompletionSource *> *bufferedTaskCompletionSources;
+@property (nonatomic, assign) NSUInteger bufferedByteCount;
+@property (nonatomic, strong) AWSKinesisRecorderSubmission *submission;
+@property (nonatomic, strong) NSMutableDictionary<NSString *, AWSKinesisRecorderStreamBackoff *> *streamBackoffs;
+// Declared by `AWSKinesisRecorder`. Firehose does not de-aggregate records.
+@property (nonatomic, assign) BOOL aggregationEnabled;
+@property (nonatomic, assign) NSTimeInterval aggregationLingerInterval;
 
 @end
 
@@ -61,16 +212,27 @@ NSString *const AWSKinesisAbstractClientRecorderDatabasePathPrefix = @"com/amazo
 
 - (instancetype)initWithConfiguration:(AWSServiceConfiguration *)configuration
                            identifier:(NSString *)identifier
-                            cacheName:(NSString *)cacheName {
+                            cacheName:(NSString *)cacheName
+                              storage:(AWSKinesisRecorderStorage)storage {
     if (self = [super init]) {
         AWSServiceConfiguration *_configuration = [configuration copy];
         [_configuration addUserAgentProductToken:AWSKinesisAbstractClientUserAgent];
         NSString *databaseDirectoryPath = [NSTemporaryDirectory() stringByAppendingPathComponent:AWSKinesisAbstractClientRecorderDatabasePathPrefix];
 
         _databasePath = [databaseDirectoryPath stringByAppendingPathComponent:identifier];
+        _storage = storage;
         _diskByteLimit = AWSKinesisAbstractClientByteLimitDefault;
         _diskAgeLimit = AWSKinesisAbstractClientAgeLimitDefault;
         _batchRecordsByteLimit = AWSKinesisAbstractClientBatchRecordByteLimitDefault;
+        _saveDurability = AWSKinesisRecorderSaveDurabilityCommitted;
+        _saveInterval = 0.0;
+        _saveBatchRecordCount = AWSKinesisAbstractClientSaveBatchRecordCountDefault;
+        _submitConcurrencyLimit = AWSKinesisAbstractClientSubmitConcurrencyLimitDefault;
+        _saveLock = [NSObject new];
+        _bufferedRecords = [NSMutableArray new];
+        _bufferedTaskCompletionSources = [NSMutableArray new];
+        _streamBackoffs = [NSMutableDictionary new];
+        _aggregationLingerInterval = AWSKinesisAbstractClientAggregationLingerIntervalDefault;
 
         // Creates a directory for storing databases if it doesn't exist.
         BOOL fileExistsAtPath = [[NSFileManager defaultManager] fileExistsAtPath:databaseDirectoryPath];
@@ -85,261 +247,838 @@ NSString *const AWSKinesisAbstractClientRecorderDatabasePathPrefix = @"com/amazo
             }
         }
 
-        // Creates a database for the identifier if it doesn't exist.
-        AWSDDLogDebug(@"Database path: [%@]", _databasePath);
-        _databaseQueue = [AWSFMDatabaseQueue serialDatabaseQueueWithPath:_databasePath];
-        [_databaseQueue inDatabase:^(AWSFMDatabase *db) {
-            if (![db executeStatements:@"PRAGMA auto_vacuum = FULL"]) {
-                AWSDDLogError(@"Failed to enable 'auto_vacuum' to 'FULL'. %@", db.lastError);
+        if (_storage == AWSKinesisRecorderStorageLog) {
+            NSError *error = nil;
+            _recordLog = [[AWSKinesisRecordLog alloc] initWithDirectoryPath:[_databasePath stringByAppendingPathExtension:@"log"]
+                                                           segmentByteLimit:AWSKinesisRecordLogSegmentByteLimitDefault
+                                                                      error:&error];
+            if (!_recordLog) {
+                AWSDDLogError(@"Failed to open the record log. Using the database instead. [%@]", error);
+                _storage = AWSKinesisRecorderStorageDatabase;
             }
+        }
 
-            if (![db executeUpdate:
-                  @"CREATE TABLE IF NOT EXISTS record ("
-                  @"partition_key TEXT NOT NULL,"
-                  @"stream_name TEXT NOT NULL,"
-                  @"data BLOB NOT NULL,"
-                  @"timestamp REAL NOT NULL,"
-                  @"retry_count INTEGER NOT NULL)"]) {
-                AWSDDLogError(@"SQLite error. [%@]", db.lastError);
-            }
+        if (_storage == AWSKinesisRecorderStorageDatabase) {
+            // Creates a database for the identifier if it doesn't exist.
+            AWSDDLogDebug(@"Database path: [%@]", _databasePath);
+            _databaseQueue = [AWSFMDatabaseQueue storeDatabaseQueueWithPath:_databasePath];
+            [_databaseQueue inDatabase:^(AWSFMDatabase *db) {
+                if (![db executeUpdate:
+                      @"CREATE TABLE IF NOT EXISTS record ("
+                      @"partition_key TEXT NOT NULL,"
+                      @"stream_name TEXT NOT NULL,"
+                      @"data BLOB NOT NULL,"
+                      @"timestamp REAL NOT NULL,"
+                      @"retry_count INTEGER NOT NULL)"]) {
+                    AWSDDLogError(@"SQLite error. [%@]", db.lastError);
+                }
 
-            if (![db executeUpdate:@"VACUUM"]) {
-                AWSDDLogError(@"SQLite error. [%@]", db.lastError);
-            }
-        }];
+                // Submissions read the records of each stream in the order they were saved.
+                if (![db executeUpdate:@"CREATE INDEX IF NOT EXISTS record_timestamp ON record (timestamp)"]
+                    || ![db executeUpdate:@"CREATE INDEX IF NOT EXISTS record_stream_name_timestamp ON record (stream_name, timestamp)"]) {
+                    AWSDDLogError(@"SQLite error. [%@]", db.lastError);
+                }
+
+                [db aws_releaseFreePagesIfNeeded];
+            }];
+            _databaseReaderPool = [AWSFMDatabasePool storeReaderPoolWithDatabaseQueue:_databaseQueue];
+        }
     }
     return self;
 }
 
-+ (dispatch_queue_t)sharedQueue {
-    static dispatch_queue_t queue;
+// Saves, reads and removes the records of all recorders one block at a time, at the default quality of service.
++ (AWSExecutor *)sharedExecutor {
+    static AWSExecutor *executor;
     static dispatch_once_t predicate;
 
     dispatch_once(&predicate, ^{
-        queue = dispatch_queue_create("com.amazonaws.AWSKinesisRecorder", DISPATCH_QUEUE_SERIAL);
+        executor = [AWSExecutor executorWithDispatchQueue:dispatch_queue_create("com.amazonaws.AWSKinesisRecorder", DISPATCH_QUEUE_SERIAL)];
     });
 
-    return queue;
+    return executor;
+}
+
+// Runs the submissions of all recorders one block at a time, on the background workers of the default pool,
+// so that a submission does not hold up the saves.
++ (AWSExecutor *)sharedSubmitExecutor {
+    static AWSExecutor *executor;
+    static dispatch_once_t predicate;
+
+    dispatch_once(&predicate, ^{
+        executor = [[AWSExecutorPool defaultPool] serialExecutorWithQualityOfService:AWSExecutorQualityOfServiceBackground];
+    });
+
+    return executor;
 }
 
 - (AWSTask *)saveRecord:(NSData *)data
              streamName:(NSString *)streamName {
-    return [self saveRecord:data streamName:streamName partitionKey:[[NSUUID UUID] UUIDString]];
+    // The partition key is generated when the record is written.
+    return [self bufferRecord:data streamName:streamName partitionKey:nil];
 }
 
 - (AWSTask *)saveRecord:(NSData *)data
              streamName:(NSString *)streamName
            partitionKey:(NSString *)partitionKey {
+    return [self bufferRecord:data streamName:streamName partitionKey:partitionKey];
+}
+
+- (AWSTask *)bufferRecord:(NSData *)data
+               streamName:(NSString *)streamName
+             partitionKey:(NSString *)partitionKey {
     // Returns error if the total size of data and partition key exceeds 256KB.
     if ([data length] > 256 * 1024) {
         return [AWSTask taskWithError:[self.recorderHelper dataTooLargeError]];
     }
 
+    AWSKinesisRecorderSaveDurability saveDurability = self.saveDurability;
+    NSTimeInterval saveInterval = self.saveInterval;
+    NSUInteger saveBatchRecordCount = MAX(self.saveBatchRecordCount, 1);
+    BOOL aggregationEnabled = self.aggregationEnabled;
+    if (aggregationEnabled) {
+        // The records wait for the records they are aggregated with, until they could fill an aggregated record.
+        saveInterval = MAX(saveInterval, self.aggregationLingerInterval);
+        saveBatchRecordCount = NSUIntegerMax;
+    }
+    AWSTaskCompletionSource *taskCompletionSource = nil;
+    if (saveDurability == AWSKinesisRecorderSaveDurabilityCommitted) {
+        taskCompletionSource = [AWSTaskCompletionSource taskCompletionSource];
+    }
+
+    // The records are written by `writeBufferedRecords`, which takes all the records buffered by then.
+    NSUInteger bufferedRecordCount = 0;
+    BOOL filled = NO;
+    @synchronized(self.saveLock) {
+        [self.bufferedRecords addObject:@[partitionKey ?: [NSNull null],
+                                          streamName,
+                                          data,
+                                          @([[NSDate date] timeIntervalSince1970])]];
+        if (taskCompletionSource) {
+            [self.bufferedTaskCompletionSources addObject:taskCompletionSource];
+        }
+        bufferedRecordCount = [self.bufferedRecords count];
+        self.bufferedByteCount += [data length];
+        filled = (bufferedRecordCount == saveBatchRecordCount
+                  || (aggregationEnabled
+                      && self.bufferedByteCount >= AWSKinesisRecordAggregatorByteLimit
+                      && self.bufferedByteCount - [data length] < AWSKinesisRecordAggregatorByteLimit));
+    }
+
+    if (bufferedRecordCount == 1 && saveInterval > 0 && saveBatchRecordCount > 1) {
+        // The first record of a group waits for the next ones.
+        dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(saveInterval * NSEC_PER_SEC)), dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_BACKGROUND, 0), ^{
+            [AWSTask taskFromExecutor:[AWSKinesisRecorder sharedExecutor] withBlock:^id _Nonnull{
+                return [self writeBufferedRecords];
+            }];
+        });
+    } else if ((bufferedRecordCount == 1 && saveInterval <= 0) || filled) {
+        [AWSTask taskFromExecutor:[AWSKinesisRecorder sharedExecutor] withBlock:^id _Nonnull{
+            return [self writeBufferedRecords];
+        }];
+    }
+
+    if (taskCompletionSource) {
+        return taskCompletionSource.task;
+    }
+    return [AWSTask taskWithResult:nil];
+}
+
++ (NSString *)randomPartitionKey {
+    uint64_t value[2];
+    arc4random_buf(value, sizeof(value));
+    return [NSString stringWithFormat:@"%016llx%016llx", value[0], value[1]];
+}
+
+// Commits the buffered records together, then evicts the records past the age and size limits once.
+// Must be run on the shared executor.
+- (AWSTask *)writeBufferedRecords {
+    NSArray<NSArray *> *records = nil;
+    NSArray<AWSTaskCompletionSource *> *taskCompletionSources = nil;
+    @synchronized(self.saveLock) {
+        if ([self.bufferedRecords count] == 0) {
+            return [AWSTask taskWithResult:nil];
+        }
+        records = self.bufferedRecords;
+        taskCompletionSources = self.bufferedTaskCompletionSources;
+        self.bufferedRecords = [NSMutableArray new];
+        self.bufferedTaskCompletionSources = [NSMutableArray new];
+        self.bufferedByteCount = 0;
+    }
+
+    if (self.aggregationEnabled) {
+        records = [self aggregateRecords:records];
+    }
+
+    NSUInteger usedByteCount = 0;
+    NSError *error = nil;
+    if (self.recordLog) {
+        error = [self commitRecordsToRecordLog:records usedByteCount:&usedByteCount];
+    } else {
+        error = [self commitRecordsToDatabase:records usedByteCount:&usedByteCount];
+    }
+
+    if (!error) {
+        [self.recorderHelper checkByteThresholdForNotification:self.notificationByteThreshold
+                                            notificationSender:self
+                                                      fileSize:usedByteCount];
+    }
+
+    for (AWSTaskCompletionSource *taskCompletionSource in taskCompletionSources) {
+        if (error) {
+            [taskCompletionSource setError:error];
+        } else {
+            [taskCompletionSource setResult:nil];
+        }
+    }
+
+    if (error) {
+        return [AWSTask taskWithError:error];
+    }
+    return [AWSTask taskWithResult:nil];
+}
+
+// Packs the records of each stream which have the same partition key, or no partition key, into aggregated records.
+// The records without a partition key share the random partition key of their aggregated record.
+// When the shards of the stream are known, the records whose partition keys belong to the same shard are packed together.
+- (NSArray<NSArray *> *)aggregateRecords:(NSArray<NSArray *> *)records {
+    NSMutableArray<NSArray *> *aggregatedRecords = [NSMutableArray new];
+    NSMutableArray<NSArray *> *groups = [NSMutableArray new];
+    NSMutableDictionary<NSArray *, AWSKinesisRecordAggregator *> *aggregators = [NSMutableDictionary new];
+    NSMutableDictionary<NSArray *, NSNumber *> *timestamps = [NSMutableDictionary new];
+
+    void (^addAggregatedRecord)(NSArray *) = ^(NSArray *group) {
+        AWSKinesisRecordAggregator *aggregator = aggregators[group];
+        [aggregatedRecords addObject:@[aggregator.partitionKey, group[0], [aggregator aggregatedData], timestamps[group]]];
+        [aggregators removeObjectForKey:group];
+    };
+
+    for (NSArray *record in records) {
+        NSString *shardId = nil;
+        if (record[0] != [NSNull null]) {
+            shardId = [self.recorderHelper cachedShardIdForStream:record[1] partitionKey:record[0]];
+        }
+        NSArray *group = shardId ? @[record[1], [NSNull null], shardId] : @[record[1], record[0]];
+        AWSKinesisRecordAggregator *aggregator = aggregators[group];
+        if (aggregator && ![aggregator canAddRecordWithData:record[2]
+                                               partitionKey:record[0] == [NSNull null] ? aggregator.partitionKey : record[0]]) {
+            addAggregatedRecord(group);
+            aggregator = nil;
+        }
+        if (!aggregator) {
+            aggregator = [AWSKinesisRecordAggregator new];
+            aggregators[group] = aggregator;
+            timestamps[group] = record[3];
+            [groups addObject:group];
+        }
+
+        NSString *partitionKey = record[0] == [NSNull null] ? (aggregator.partitionKey ?: [[self class] randomPartitionKey]) : record[0];
+        [aggregator addRecordWithData:record[2] partitionKey:partitionKey];
+    }
+
+    // The aggregated records which are not full are added in the order of their first records.
+    for (NSArray *group in groups) {
+        if (aggregators[group]) {
+            addAggregatedRecord(group);
+        }
+    }
+    return aggregatedRecords;
+}
+
+// Inserts the records in one transaction, then evicts the records past the age and size limits once.
+- (NSError *)commitRecordsToDatabase:(NSArray<NSArray *> *)records
+                       usedByteCount:(NSUInteger *)usedByteCount {
     AWSFMDatabaseQueue *databaseQueue = self.databaseQueue;
     NSTimeInterval diskAgeLimit = self.diskAgeLimit;
-    NSString *databasePath = self.databasePath;
-    NSUInteger notificationByteThreshold = self.notificationByteThreshold;
     NSUInteger diskByteLimit = self.diskByteLimit;
-    __weak id notificationSender = self;
 
-    return [[AWSTask taskWithResult:nil] continueWithExecutor:[AWSExecutor executorWithDispatchQueue:[AWSKinesisRecorder sharedQueue]] withSuccessBlock:^id _Nullable(AWSTask * _Nonnull task) {
-        // Inserts a new record to the database.
-        __block NSError *error = nil;
-        [databaseQueue inDatabase:^(AWSFMDatabase *db) {
-            BOOL result = [db executeUpdate:
-                           @"INSERT INTO record ("
-                           @"partition_key, stream_name, data, timestamp, retry_count"
-                           @") VALUES ("
-                           @":partition_key, :stream_name, :data, :timestamp, :retry_count"
-                           @")"
-                    withParameterDictionary:@{
-                                              @"partition_key" : partitionKey,
-                                              @"stream_name" : streamName,
-                                              @"data" : data,
-                                              @"timestamp" : @([[NSDate date] timeIntervalSince1970]),
-                                              @"retry_count" : @0
-                                              }
-                           ];
+    NSMutableArray<NSArray *> *argumentArrays = [NSMutableArray arrayWithCapacity:[records count]];
+    for (NSArray *record in records) {
+        NSString *partitionKey = record[0] == [NSNull null] ? [[self class] randomPartitionKey] : record[0];
+        [argumentArrays addObject:@[partitionKey, record[1], record[2], record[3], @0]];
+    }
 
+    __block NSError *error = nil;
+    __block BOOL deleted = NO;
+    [databaseQueue inTransaction:^(AWSFMDatabase *db, BOOL *rollback) {
+        BOOL result = [db executeUpdate:
+                       @"INSERT INTO record ("
+                       @"partition_key, stream_name, data, timestamp, retry_count"
+                       @") VALUES (?, ?, ?, ?, ?)"
+                     withArgumentArrays:argumentArrays];
+        if (!result) {
+            AWSDDLogError(@"SQLite error. Rolling back... [%@]", db.lastError);
+            error = db.lastError;
+            *rollback = YES;
+            return;
+        }
 
+        if (diskAgeLimit > 0) {
+            // Deletes old records exceeding the threshold.
+            result = [db executeUpdate:
+                      @"DELETE FROM record "
+                      @"WHERE timestamp < :timestamp"
+               withParameterDictionary:@{
+                                         @"timestamp" : @([[NSDate date] timeIntervalSince1970] - diskAgeLimit)
+                                         }
+                      ];
             if (!result) {
                 AWSDDLogError(@"SQLite error. [%@]", db.lastError);
-                error = db.lastError;
             }
+            deleted = deleted || [db changes] > 0;
+        }
+
+        *usedByteCount = (NSUInteger)[db aws_usedByteCount];
+        if (diskByteLimit > 0 && *usedByteCount > diskByteLimit) {
+            // Deletes the oldest records which free as many bytes as the disk size threshold is exceeded by.
+            NSUInteger excessByteCount = *usedByteCount - diskByteLimit;
+            NSUInteger selectedByteCount = 0;
+            NSMutableArray<NSNumber *> *rowIds = [NSMutableArray new];
+            AWSFMResultSet *rs = [db executeQuery:
+                                  @"SELECT rowid, LENGTH(data) + LENGTH(partition_key) + LENGTH(stream_name) AS byte_count "
+                                  @"FROM record "
+                                  @"ORDER BY timestamp ASC"];
+            while (selectedByteCount < excessByteCount && [rs next]) {
+                [rowIds addObject:@([rs longLongIntForColumn:@"rowid"])];
+                selectedByteCount += (NSUInteger)[rs longLongIntForColumn:@"byte_count"];
+            }
+            [rs close];
+
+            result = [db executeUpdate:@"DELETE FROM record WHERE rowid IN aws_fmdb_values"
+            withValuesInTemporaryTable:rowIds];
+            if (!result) {
+                AWSDDLogError(@"SQLite error. [%@]", db.lastError);
+            }
+            deleted = YES;
+            *usedByteCount = (NSUInteger)[db aws_usedByteCount];
+        }
+    }];
+
+    if (deleted) {
+        [databaseQueue inDatabase:^(AWSFMDatabase *db) {
+            [db aws_releaseFreePagesIfNeeded];
         }];
+    }
 
-        if (!error && diskAgeLimit > 0) {
-            [databaseQueue inDatabase:^(AWSFMDatabase *db) {
-                // Deletes old records exceeding the threshold.
-                BOOL result = [db executeUpdate:
-                               @"DELETE FROM record "
-                               @"WHERE timestamp < :timestamp"
-                        withParameterDictionary:@{
-                                                  @"timestamp" : @([[NSDate date] timeIntervalSince1970] - diskAgeLimit)
-                                                  }
-                               ];
-                if (!result) {
-                    AWSDDLogError(@"SQLite error. [%@]", db.lastError);
-                    error = db.lastError;
-                }
-            }];
+    return error;
+}
+
+// Appends the records to the log, then acknowledges the records past the age and size limits.
+- (NSError *)commitRecordsToRecordLog:(NSArray<NSArray *> *)records
+                        usedByteCount:(NSUInteger *)usedByteCount {
+    AWSKinesisRecordLog *recordLog = self.recordLog;
+    NSTimeInterval diskAgeLimit = self.diskAgeLimit;
+    NSUInteger diskByteLimit = self.diskByteLimit;
+
+    NSMutableArray<AWSKinesisRecordLogEntry *> *entries = [NSMutableArray arrayWithCapacity:[records count]];
+    for (NSArray *record in records) {
+        AWSKinesisRecordLogEntry *entry = [AWSKinesisRecordLogEntry new];
+        entry.partitionKey = record[0] == [NSNull null] ? [[self class] randomPartitionKey] : record[0];
+        entry.streamName = record[1];
+        entry.data = record[2];
+        entry.timestamp = [record[3] doubleValue];
+        [entries addObject:entry];
+    }
+
+    NSError *error = nil;
+    if (![recordLog appendRecords:entries error:&error]) {
+        AWSDDLogError(@"Failed to append to the record log. [%@]", error);
+        return error;
+    }
+
+    if (diskAgeLimit > 0 || (diskByteLimit > 0 && recordLog.byteCount > diskByteLimit)) {
+        NSError *evictionError = nil;
+        if (![recordLog acknowledgeRecordsBeforeTimestamp:diskAgeLimit > 0 ? [[NSDate date] timeIntervalSince1970] - diskAgeLimit : 0
+                                           byteCountLimit:diskByteLimit
+                                                    error:&evictionError]) {
+            AWSDDLogError(@"Failed to remove the records past the limits from the record log. [%@]", evictionError);
         }
+    }
 
-        if (error) {
-            return [AWSTask taskWithError:error];
+    *usedByteCount = recordLog.byteCount;
+    return nil;
+}
+
+- (AWSTask *)submitAllRecords {
+    return [[[AWSTask taskWithResult:nil] continueWithExecutor:[AWSKinesisRecorder sharedExecutor] withSuccessBlock:^id _Nullable(AWSTask * _Nonnull task) {
+        return [self writeBufferedRecords];
+    }] continueWithExecutor:[AWSKinesisRecorder sharedSubmitExecutor] withSuccessBlock:^id _Nullable(AWSTask * _Nonnull task) {
+        NSError *error = nil;
+
+        // A submission which is already running submits the records saved since it started too.
+        AWSKinesisRecorderSubmission *submission = self.submission;
+        if (!submission) {
+            submission = [AWSKinesisRecorderSubmission new];
+            submission.cursorOffset = self.recordLog.acknowledgedOffset;
+            self.submission = submission;
+        }
+        if (self.recordLog) {
+            submission.exhausted = NO;
+            submission.cursorEndOffset = self.recordLog.endOffset;
+        } else if (![self readStreamsOfSubmission:submission error:&error]) {
+            submission.error = submission.error ?: error;
+            submission.stopped = YES;
+        }
+        [self continueSubmission:submission];
+
+        return submission.taskCompletionSource.task;
+    }];
+}
+
+// Sends batches until `submitConcurrencyLimit` requests are in flight or no more records can be sent,
+// and completes the submission once no request is in flight. Must be run on the shared submit executor.
+- (void)continueSubmission:(AWSKinesisRecorderSubmission *)submission {
+    NSUInteger submitConcurrencyLimit = MAX(self.submitConcurrencyLimit, 1);
+    while (!submission.stopped && submission.inFlightBatchCount < submitConcurrencyLimit) {
+        NSError *error = nil;
+        NSArray<AWSKinesisRecorderSubmitBatch *> *batches = nil;
+        if (self.recordLog) {
+            batches = [self readBatchesFromRecordLog:submission error:&error];
+        } else {
+            batches = [self readBatchesFromDatabase:submission error:&error];
         }
 
-        NSDictionary *attributes = [[NSFileManager defaultManager] attributesOfItemAtPath:databasePath
-                                                                                    error:&error];
-        if (attributes) {
-            NSUInteger fileSize = (NSUInteger)[attributes fileSize];
-            [self.recorderHelper checkByteThresholdForNotification:notificationByteThreshold
-                                                notificationSender:notificationSender
-                                                          fileSize:fileSize];
-            if (fileSize > diskByteLimit) {
-                // Deletes the oldest record if it exceeds the disk size threshold.
-                [databaseQueue inDatabase:^(AWSFMDatabase *db) {
-                    BOOL result = [db executeUpdate:
-                                   @"DELETE FROM record "
-                                   @"WHERE rowid IN ( "
-                                   @"SELECT rowid "
-                                   @"FROM record "
-                                   @"ORDER BY timestamp ASC "
-                                   @"LIMIT 1 "
-                                   @")"
-                                   ];
-                    if (!result) {
-                        AWSDDLogError(@"SQLite error. [%@]", db.lastError);
-                        error = db.lastError;
-                        return;
-                    }
-                }];
+        if (!batches) {
+            submission.error = submission.error ?: error;
+            submission.stopped = YES;
+        } else if ([batches count] == 0) {
+            break;
+        }
+        for (AWSKinesisRecorderSubmitBatch *batch in batches) {
+            [self sendBatch:batch submission:submission];
+        }
+    }
 
+    if (submission.inFlightBatchCount == 0) {
+        [self finishSubmission:submission];
+    }
+}
+
+- (void)sendBatch:(AWSKinesisRecorderSubmitBatch *)batch
+       submission:(AWSKinesisRecorderSubmission *)submission {
+    AWSKinesisRecorderStreamCursor *streamCursor = submission.streamCursors[batch.streamName];
+    streamCursor.inFlightBatchCount += 1;
+    submission.inFlightBatchCount += 1;
+
+    [[self.recorderHelper submitRecordsForStream:batch.streamName
+                                         records:batch.records
+                                          rowIds:batch.rowIds
+                                       putRowIds:batch.putRowIds
+                                     retryRowIds:batch.retryRowIds] continueWithExecutor:[AWSKinesisRecorder sharedSubmitExecutor] withBlock:^id _Nullable(AWSTask * _Nonnull task) {
+        streamCursor.inFlightBatchCount -= 1;
+        submission.inFlightBatchCount -= 1;
+        if (task.error) {
+            // The records of the failed batch are kept.
+            submission.error = submission.error ?: task.error;
+            if ([self isSubmissionStoppingError:task.error]) {
+                submission.stopped = YES;
             }
-        } else if (error) {
-            return [AWSTask taskWithError:error];
+        } else {
+            batch.submitted = YES;
+        }
+
+        // A stream whose records were throttled, or whose request failed, is not sent to until its backoff ends.
+        if (!submission.stopped) {
+            BOOL throttled = task.error || [batch.retryRowIds count] > 0;
+            [self updateBackoffOfStream:batch.streamName throttled:throttled];
+            if (throttled) {
+                streamCursor.exhausted = YES;
+            }
+        }
+
+        NSError *error = nil;
+        if (self.recordLog) {
+            error = [self completeRecordLogBatch:batch submission:submission];
+        } else {
+            error = [self completeDatabaseBatch:batch];
+        }
+        if (error) {
+            submission.error = submission.error ?: error;
+            submission.stopped = YES;
         }
 
+        [self continueSubmission:submission];
         return nil;
     }];
 }
 
-- (AWSTask *)submitAllRecords {
-    AWSFMDatabaseQueue *databaseQueue = self.databaseQueue;
+- (void)finishSubmission:(AWSKinesisRecorderSubmission *)submission {
+    if (self.recordLog) {
+        NSError *error = [self acknowledgeWindowsOfSubmission:submission finishing:YES];
+        submission.error = submission.error ?: error;
+    } else {
+        [self.databaseQueue inDatabase:^(AWSFMDatabase *db) {
+            // If a record failed three times, give up and delete the record.
+            if (![db executeUpdate:@"DELETE FROM record WHERE retry_count > 3"]) {
+                AWSDDLogError(@"SQLite error. [%@]", db.lastError);
+                submission.error = submission.error ?: db.lastError;
+            }
+            [db aws_releaseFreePagesIfNeeded];
+        }];
+    }
 
-    return [[AWSTask taskWithResult:nil] continueWithExecutor:[AWSExecutor executorWithDispatchQueue:[AWSKinesisRecorder sharedQueue]] withSuccessBlock:^id _Nullable(AWSTask * _Nonnull task) {
-        __block NSError *error = nil;
-        __block NSUInteger batchSize = 0;
-        __block BOOL stop = NO;
-
-        do {
-            [databaseQueue inTransaction:^(AWSFMDatabase *db, BOOL *rollback) {
-                NSMutableArray *rowIds = nil;
-
-                AWSFMResultSet *rs = [db executeQuery:
-                                      @"SELECT rowid, partition_key, data, retry_count, stream_name "
-                                      @"FROM record "
-                                      @"WHERE stream_name = (SELECT stream_name FROM record ORDER BY timestamp ASC LIMIT 1) "
-                                      @"ORDER BY timestamp ASC "
-                                      @"LIMIT 128"];
-                if (!rs) {
-                    AWSDDLogError(@"SQLite error. Rolling back... [%@]", db.lastError);
-                    error = db.lastError;
-                    *rollback = YES;
-                    return;
-                }
+    if (self.submission == submission) {
+        self.submission = nil;
+    }
+    if (submission.error) {
+        [submission.taskCompletionSource trySetError:submission.error];
+    } else {
+        [submission.taskCompletionSource trySetResult:nil];
+    }
+}
 
-                NSUInteger batchDataSize = 0;
-                NSMutableArray *temporaryRecords = [NSMutableArray new];
-                rowIds = [NSMutableArray new];
-                while ([rs next]) {
-                    [temporaryRecords addObject:@{
-                                                  @"partition_key": [rs stringForColumn:@"partition_key"],
-                                                  @"data": [rs dataForColumn:@"data"],
-                                                  @"stream_name": [rs stringForColumn:@"stream_name"],
-                                                  }];
-
-                    [rowIds addObject:[rs stringForColumn:@"rowid"]];
-                    batchDataSize += [[rs dataForColumn:@"data"] length];
-
-                    if (batchDataSize > self.batchRecordsByteLimit) { // if the batch size exceeds `batchRecordsByteLimit`, stop there.
-                        break;
-                    }
-                }
-                rs = nil;
-                batchSize = [temporaryRecords count];
-
-                if (batchSize > 0) {
-                    __block NSMutableArray *putRowIds = [NSMutableArray new];
-                    __block NSMutableArray *retryRowIds = [NSMutableArray new];
-
-                    NSString *streamName = temporaryRecords[0][@"stream_name"];
-
-                    AWSTask *submitTask = \
-                        [self.recorderHelper submitRecordsForStream:streamName
-                                                            records:temporaryRecords
-                                                             rowIds:rowIds
-                                                          putRowIds:putRowIds
-                                                        retryRowIds:retryRowIds
-                                                               stop:&stop];
-
-                    [submitTask waitUntilFinished];
-
-                    if (submitTask.error) {
-                        error = submitTask.error;
-                    }
-
-                    for (NSString *rowId in putRowIds) {
-                        BOOL result = [db executeUpdate:@"DELETE FROM record WHERE rowid = :rowid"
-                                withParameterDictionary:@{
-                                                          @"rowid" : rowId
-                                                          }];
-                        if (!result) {
-                            AWSDDLogError(@"SQLite error. [%@]", db.lastError);
-                            error = db.lastError;
-                        }
-                    }
-
-                    for (NSString *rowId in retryRowIds) {
-                        BOOL result = [db executeUpdate:@"UPDATE record SET retry_count = retry_count + 1 WHERE rowid = :rowid"
-                                withParameterDictionary:@{
-                                                          @"rowid" : rowId
-                                                          }];
-                        if (!result) {
-                            AWSDDLogError(@"SQLite error. [%@]", db.lastError);
-                            error = db.lastError;
-                        }
-                    }
-                }
+// Errors which no other request would succeed past, such as the device being offline.
+- (BOOL)isSubmissionStoppingError:(NSError *)error {
+    return [@[NSURLErrorDomain, AWSCognitoIdentityErrorDomain] containsObject:error.domain];
+}
 
-                // If a record failed three times, give up and delete the record.
-                BOOL result = [db executeUpdate:@"DELETE FROM record WHERE retry_count > 3"];
-                if (!result) {
-                    AWSDDLogError(@"SQLite error. [%@]", db.lastError);
-                    error = db.lastError;
-                }
-            }];
-        } while (!stop && !error && batchSize > 0);
+- (BOOL)isStreamBackingOff:(NSString *)streamName {
+    @synchronized(self.streamBackoffs) {
+        NSDate *date = self.streamBackoffs[streamName].date;
+        return date && [date timeIntervalSinceNow] > 0;
+    }
+}
 
+// Doubles the backoff delay of a throttled stream, from one second up to a minute, and clears it once a request is not throttled.
+- (void)updateBackoffOfStream:(NSString *)streamName
+                    throttled:(BOOL)throttled {
+    @synchronized(self.streamBackoffs) {
+        if (!throttled) {
+            [self.streamBackoffs removeObjectForKey:streamName];
+            return;
+        }
+
+        AWSKinesisRecorderStreamBackoff *backoff = self.streamBackoffs[streamName];
+        if (!backoff) {
+            backoff = [AWSKinesisRecorderStreamBackoff new];
+            self.streamBackoffs[streamName] = backoff;
+            backoff.delay = AWSKinesisAbstractClientStreamBackoffDelayMin;
+        } else if ([backoff.date timeIntervalSinceNow] <= 0) {
+            // The requests sent before the backoff started do not extend it.
+            backoff.delay = MIN(backoff.delay * 2, AWSKinesisAbstractClientStreamBackoffDelayMax);
+        } else {
+            return;
+        }
+        backoff.date = [NSDate dateWithTimeIntervalSinceNow:backoff.delay];
+    }
+}
+
+// Groups the records of a read into a batch per stream, in the order of the first record of each stream.
+- (NSArray<AWSKinesisRecorderSubmitBatch *> *)batchesWithRecords:(NSArray<NSDictionary *> *)records
+                                                          rowIds:(NSArray *)rowIds {
+    NSMutableArray<AWSKinesisRecorderSubmitBatch *> *batches = [NSMutableArray new];
+    NSMutableDictionary<NSString *, AWSKinesisRecorderSubmitBatch *> *batchesByStreamName = [NSMutableDictionary new];
+    for (NSUInteger i = 0; i < [records count]; i++) {
+        NSString *streamName = records[i][@"stream_name"];
+        AWSKinesisRecorderSubmitBatch *batch = batchesByStreamName[streamName];
+        if (!batch) {
+            batch = [AWSKinesisRecorderSubmitBatch new];
+            batch.streamName = streamName;
+            batchesByStreamName[streamName] = batch;
+            [batches addObject:batch];
+        }
+        [batch.records addObject:records[i]];
+        [batch.rowIds addObject:rowIds[i]];
+    }
+    return batches;
+}
+
+// Adds a cursor for each stream of the database which the submission has no cursor for, and lets the streams which ran out of records be read again.
+- (BOOL)readStreamsOfSubmission:(AWSKinesisRecorderSubmission *)submission
+                          error:(NSError **)error {
+    __block NSError *readError = nil;
+    NSMutableArray<NSString *> *streamNames = [NSMutableArray new];
+    [self.databaseReaderPool inDatabase:^(AWSFMDatabase *db) {
+        AWSFMResultSet *rs = [db executeQuery:@"SELECT DISTINCT stream_name FROM record"];
+        if (!rs) {
+            AWSDDLogError(@"SQLite error. [%@]", db.lastError);
+            readError = db.lastError;
+            return;
+        }
+        while ([rs next]) {
+            [streamNames addObject:[rs stringForColumn:@"stream_name"]];
+        }
+        [rs close];
+    }];
+
+    if (readError) {
         if (error) {
-            return [AWSTask taskWithError:error];
+            *error = readError;
+        }
+        return NO;
+    }
+
+    for (AWSKinesisRecorderStreamCursor *streamCursor in [submission.streamCursors allValues]) {
+        streamCursor.exhausted = NO;
+    }
+    for (NSString *streamName in streamNames) {
+        if (!submission.streamCursors[streamName]) {
+            AWSKinesisRecorderStreamCursor *streamCursor = [AWSKinesisRecorderStreamCursor new];
+            streamCursor.streamName = streamName;
+            submission.streamCursors[streamName] = streamCursor;
+        }
+    }
+    return YES;
+}
+
+// Picks the stream with the fewest requests in flight, taking turns between the streams with as many, and skipping the streams which ran out of records or are backing off.
+- (AWSKinesisRecorderStreamCursor *)nextStreamCursorOfSubmission:(AWSKinesisRecorderSubmission *)submission {
+    NSArray<NSString *> *streamNames = [[submission.streamCursors allKeys] sortedArrayUsingSelector:@selector(compare:)];
+    AWSKinesisRecorderStreamCursor *nextStreamCursor = nil;
+    NSUInteger nextStreamIndex = 0;
+    for (NSUInteger i = 0; i < [streamNames count]; i++) {
+        NSUInteger streamIndex = (submission.nextStreamIndex + i) % [streamNames count];
+        AWSKinesisRecorderStreamCursor *streamCursor = submission.streamCursors[streamNames[streamIndex]];
+        if (streamCursor.exhausted) {
+            continue;
+        }
+        if ([self isStreamBackingOff:streamCursor.streamName]) {
+            streamCursor.exhausted = YES;
+            continue;
+        }
+        if (!nextStreamCursor || streamCursor.inFlightBatchCount < nextStreamCursor.inFlightBatchCount) {
+            nextStreamCursor = streamCursor;
+            nextStreamIndex = streamIndex;
         }
+    }
+
+    if (nextStreamCursor) {
+        submission.nextStreamIndex = nextStreamIndex + 1;
+    }
+    return nextStreamCursor;
+}
+
+// Reads the records after the cursor of the next stream to send to, as many as a request can take.
+// Returns no batch once every stream ran out of records or is backing off.
+- (NSArray<AWSKinesisRecorderSubmitBatch *> *)readBatchesFromDatabase:(AWSKinesisRecorderSubmission *)submission
+                                                                error:(NSError **)error {
+    NSUInteger recordCountLimit = [self.recorderHelper batchRecordCountLimit];
+    NSUInteger byteLimit = MIN(self.batchRecordsByteLimit, [self.recorderHelper batchByteLimit]);
 
+    AWSKinesisRecorderStreamCursor *streamCursor = nil;
+    while ((streamCursor = [self nextStreamCursorOfSubmission:submission])) {
+        __block NSError *readError = nil;
+        AWSKinesisRecorderSubmitBatch *batch = [AWSKinesisRecorderSubmitBatch new];
+        batch.streamName = streamCursor.streamName;
+        [self.databaseReaderPool inDatabase:^(AWSFMDatabase *db) {
+            AWSFMResultSet *rs = [db executeQuery:
+                                  @"SELECT rowid, partition_key, data, timestamp "
+                                  @"FROM record "
+                                  @"WHERE stream_name = :stream_name "
+                                  @"AND timestamp >= :timestamp AND (timestamp > :timestamp OR rowid > :rowid) "
+                                  @"ORDER BY timestamp ASC, rowid ASC "
+                                  @"LIMIT :limit"
+                          withParameterDictionary:@{
+                                                    @"stream_name" : streamCursor.streamName,
+                                                    @"timestamp" : @(streamCursor.timestamp),
+                                                    @"rowid" : @(streamCursor.rowId),
+                                                    @"limit" : @(recordCountLimit),
+                                                    }];
+            if (!rs) {
+                AWSDDLogError(@"SQLite error. [%@]", db.lastError);
+                readError = db.lastError;
+                return;
+            }
+
+            NSUInteger byteCount = 0;
+            while ([rs next]) {
+                NSString *partitionKey = [rs stringForColumn:@"partition_key"];
+                NSData *data = [rs dataForColumn:@"data"];
+                NSUInteger recordByteCount = [data length] + [partitionKey lengthOfBytesUsingEncoding:NSUTF8StringEncoding];
+                if ([batch.records count] > 0 && byteCount + recordByteCount > byteLimit) {
+                    // The record is read again by the next read.
+                    break;
+                }
+                byteCount += recordByteCount;
+
+                [batch.records addObject:@{
+                                           @"partition_key": partitionKey,
+                                           @"data": data,
+                                           @"stream_name": streamCursor.streamName,
+                                           }];
+                [batch.rowIds addObject:@([rs longLongIntForColumn:@"rowid"])];
+                streamCursor.timestamp = [rs doubleForColumn:@"timestamp"];
+                streamCursor.rowId = [rs longLongIntForColumn:@"rowid"];
+            }
+            [rs close];
+        }];
+
+        if (readError) {
+            if (error) {
+                *error = readError;
+            }
+            return nil;
+        }
+        if ([batch.records count] > 0) {
+            return @[batch];
+        }
+        streamCursor.exhausted = YES;
+    }
+    return @[];
+}
+
+// Deletes the records which were put and counts a retry for the records to retry, in a transaction of their own.
+- (NSError *)completeDatabaseBatch:(AWSKinesisRecorderSubmitBatch *)batch {
+    if ([batch.putRowIds count] == 0 && [batch.retryRowIds count] == 0) {
         return nil;
+    }
+
+    __block NSError *error = nil;
+    [self.databaseQueue inTransaction:^(AWSFMDatabase *db, BOOL *rollback) {
+        BOOL result = [db executeUpdate:@"DELETE FROM record WHERE rowid IN aws_fmdb_values"
+             withValuesInTemporaryTable:batch.putRowIds];
+        if (!result) {
+            AWSDDLogError(@"SQLite error. [%@]", db.lastError);
+            error = db.lastError;
+        }
+
+        result = [db executeUpdate:@"UPDATE record SET retry_count = retry_count + 1 WHERE rowid IN aws_fmdb_values"
+        withValuesInTemporaryTable:batch.retryRowIds];
+        if (!result) {
+            AWSDDLogError(@"SQLite error. [%@]", db.lastError);
+            error = db.lastError;
+        }
     }];
+    return error;
+}
+
+// Reads windows of the log after the cursor of the submission, as many records as a request can take each, until a window has records to send.
+// The records of the streams which are backing off are kept without being sent.
+// Stops at the end the log had when the submission started or was joined, so that the records appended again are not read again.
+- (NSArray<AWSKinesisRecorderSubmitBatch *> *)readBatchesFromRecordLog:(AWSKinesisRecorderSubmission *)submission
+                                                                 error:(NSError **)error {
+    while (!submission.exhausted) {
+        if (submission.cursorOffset >= submission.cursorEndOffset) {
+            submission.exhausted = YES;
+            break;
+        }
+
+        NSArray<AWSKinesisRecordLogEntry *> *entries = [self.recordLog readRecordsFromOffset:submission.cursorOffset
+                                                                            recordCountLimit:[self.recorderHelper batchRecordCountLimit]
+                                                                                   byteLimit:MIN(self.batchRecordsByteLimit, [self.recorderHelper batchByteLimit])
+                                                                                       error:error];
+        if (!entries) {
+            return nil;
+        }
+        if ([entries count] == 0) {
+            submission.exhausted = YES;
+            break;
+        }
+
+        NSMutableArray<NSDictionary *> *records = [NSMutableArray arrayWithCapacity:[entries count]];
+        for (AWSKinesisRecordLogEntry *entry in entries) {
+            [records addObject:@{
+                                 @"partition_key": entry.partitionKey,
+                                 @"data": entry.data,
+                                 @"stream_name": entry.streamName,
+                                 }];
+        }
+
+        AWSKinesisRecorderSubmitWindow *window = [AWSKinesisRecorderSubmitWindow new];
+        window.nextOffset = [entries lastObject].nextOffset;
+        submission.cursorOffset = window.nextOffset;
+        [submission.windows addObject:window];
+
+        NSMutableArray<AWSKinesisRecorderSubmitBatch *> *batches = [NSMutableArray new];
+        for (AWSKinesisRecorderSubmitBatch *batch in [self batchesWithRecords:records rowIds:entries]) {
+            if ([self isStreamBackingOff:batch.streamName]) {
+                [window.keptRecords addObjectsFromArray:batch.rowIds];
+                continue;
+            }
+            batch.window = window;
+            if (!submission.streamCursors[batch.streamName]) {
+                AWSKinesisRecorderStreamCursor *streamCursor = [AWSKinesisRecorderStreamCursor new];
+                streamCursor.streamName = batch.streamName;
+                submission.streamCursors[batch.streamName] = streamCursor;
+            }
+            [batches addObject:batch];
+        }
+        window.pendingBatchCount = [batches count];
+        if ([batches count] > 0) {
+            return batches;
+        }
+    }
+    return @[];
+}
+
+- (NSError *)completeRecordLogBatch:(AWSKinesisRecorderSubmitBatch *)batch
+                         submission:(AWSKinesisRecorderSubmission *)submission {
+    AWSKinesisRecorderSubmitWindow *window = batch.window;
+    window.pendingBatchCount -= 1;
+    if (batch.submitted) {
+        window.submitted = YES;
+        NSSet<AWSKinesisRecordLogEntry *> *putRecords = [NSSet setWithArray:batch.putRowIds];
+        NSSet<AWSKinesisRecordLogEntry *> *retryRecords = [NSSet setWithArray:batch.retryRowIds];
+        for (AWSKinesisRecordLogEntry *record in batch.rowIds) {
+            if ([retryRecords containsObject:record]) {
+                // If a record failed three times, give up and delete the record.
+                if (record.retryCount < 3) {
+                    record.retryCount += 1;
+                    [window.keptRecords addObject:record];
+                }
+            } else if (![putRecords containsObject:record]) {
+                // The records which were not sent, such as the records of a shard which is backing off, are kept as they are.
+                [window.keptRecords addObject:record];
+            }
+        }
+    } else {
+        [window.keptRecords addObjectsFromArray:batch.rowIds];
+    }
+
+    return [self acknowledgeWindowsOfSubmission:submission finishing:NO];
+}
+
+// Acknowledges the windows at the start of the log whose requests are complete, after appending their records to retry again.
+// A window whose requests all failed is kept, unless a window after it was submitted when the submission finishes.
+// Its records are then appended again too, so that the records after it are not submitted twice.
+- (NSError *)acknowledgeWindowsOfSubmission:(AWSKinesisRecorderSubmission *)submission
+                                  finishing:(BOOL)finishing {
+    AWSKinesisRecordLog *recordLog = self.recordLog;
+    while ([submission.windows count] > 0) {
+        AWSKinesisRecorderSubmitWindow *window = [submission.windows firstObject];
+        if (window.pendingBatchCount > 0) {
+            break;
+        }
+        if (!window.submitted
+            && !(finishing && [[submission.windows valueForKeyPath:@"@max.submitted"] boolValue])) {
+            break;
+        }
+
+        NSError *error = nil;
+        // The records evicted past the disk limits while the window was submitted are not appended again.
+        if (![recordLog appendRecords:window.keptRecords acknowledgingToOffset:window.nextOffset error:&error]) {
+            AWSDDLogError(@"Failed to update the record log. [%@]", error);
+            return error;
+        }
+        [submission.windows removeObjectAtIndex:0];
+    }
+    return nil;
 }
 
 - (AWSTask *)removeAllRecords {
     AWSFMDatabaseQueue *databaseQueue = self.databaseQueue;
+    AWSKinesisRecordLog *recordLog = self.recordLog;
+
+    return [[AWSTask taskWithResult:nil] continueWithExecutor:[AWSKinesisRecorder sharedExecutor] withSuccessBlock:^id _Nullable(AWSTask * _Nonnull task) {
+        // Completes the tasks of the buffered records before they are removed with the others.
+        [self writeBufferedRecords];
 
-    return [[AWSTask taskWithResult:nil] continueWithExecutor:[AWSExecutor executorWithDispatchQueue:[AWSKinesisRecorder sharedQueue]] withSuccessBlock:^id _Nullable(AWSTask * _Nonnull task) {
         __block NSError *error = nil;
-        [databaseQueue inDatabase:^(AWSFMDatabase *db) {
-            if (![db executeUpdate:@"DELETE FROM record"]) {
-                AWSDDLogError(@"SQLite error. [%@]", db.lastError);
-                error = db.lastError;
+        if (recordLog) {
+            NSError *recordLogError = nil;
+            if (![recordLog removeAllRecords:&recordLogError]) {
+                AWSDDLogError(@"Failed to remove the records from the record log. [%@]", recordLogError);
+                error = recordLogError;
             }
-        }];
+        } else {
+            [databaseQueue inDatabase:^(AWSFMDatabase *db) {
+                if (![db executeUpdate:@"DELETE FROM record"]) {
+                    AWSDDLogError(@"SQLite error. [%@]", db.lastError);
+                    error = db.lastError;
+                }
+                [db aws_releaseFreePagesIfNeeded];
+            }];
+        }
 
         if (error) {
             return [AWSTask taskWithError:error];
@@ -350,20 +1089,78 @@ NSString *const AWSKinesisAbstractClientRecorderDatabasePathPrefix = @"com/amazo
 }
 
 - (NSUInteger)diskBytesUsed {
-    NSError *error = nil;
-    NSDictionary *attributes = [[NSFileManager defaultManager] attributesOfItemAtPath:self.databasePath
-                                                                                error:&error];
-    if (attributes) {
-        return (NSUInteger)[attributes fileSize];
+    if (self.recordLog) {
+        return self.recordLog.byteCount;
+    }
+
+    __block NSUInteger diskBytesUsed = 0;
+    [self.databaseReaderPool inDatabase:^(AWSFMDatabase *db) {
+        diskBytesUsed = (NSUInteger)[db aws_usedByteCount];
+    }];
+    return diskBytesUsed;
+}
+
+- (NSArray<AWSKinesisRecorderStreamBacklog *> *)streamBacklogs {
+    NSMutableDictionary<NSString *, AWSKinesisRecorderStreamBacklog *> *streamBacklogs = [NSMutableDictionary new];
+    if (self.recordLog) {
+        unsigned long long offset = self.recordLog.acknowledgedOffset;
+        NSArray<AWSKinesisRecordLogEntry *> *records = nil;
+        while ([(records = [self.recordLog readRecordsFromOffset:offset
+                                                recordCountLimit:AWSKinesisAbstractClientSaveBatchRecordCountDefault
+                                                       byteLimit:0
+                                                           error:nil]) count] > 0) {
+            for (AWSKinesisRecordLogEntry *record in records) {
+                AWSKinesisRecorderStreamBacklog *streamBacklog = streamBacklogs[record.streamName];
+                if (!streamBacklog) {
+                    streamBacklog = [AWSKinesisRecorderStreamBacklog new];
+                    streamBacklog.streamName = record.streamName;
+                    streamBacklog.oldestRecordDate = [NSDate dateWithTimeIntervalSince1970:record.timestamp];
+                    streamBacklogs[record.streamName] = streamBacklog;
+                }
+                streamBacklog.recordCount += 1;
+                streamBacklog.byteCount += [record.data length] + [record.partitionKey lengthOfBytesUsingEncoding:NSUTF8StringEncoding];
+            }
+            offset = [records lastObject].nextOffset;
+        }
     } else {
-        AWSDDLogError(@"Error [%@]", error);
-        return 0;
+        [self.databaseReaderPool inDatabase:^(AWSFMDatabase *db) {
+            AWSFMResultSet *rs = [db executeQuery:
+                                  @"SELECT stream_name, COUNT(*) AS record_count, SUM(LENGTH(data) + LENGTH(CAST(partition_key AS BLOB))) AS byte_count, MIN(timestamp) AS timestamp "
+                                  @"FROM record "
+                                  @"GROUP BY stream_name"];
+            if (!rs) {
+                AWSDDLogError(@"SQLite error. [%@]", db.lastError);
+                return;
+            }
+            while ([rs next]) {
+                AWSKinesisRecorderStreamBacklog *streamBacklog = [AWSKinesisRecorderStreamBacklog new];
+                streamBacklog.streamName = [rs stringForColumn:@"stream_name"];
+                streamBacklog.recordCount = (NSUInteger)[rs longLongIntForColumn:@"record_count"];
+                streamBacklog.byteCount = (NSUInteger)[rs longLongIntForColumn:@"byte_count"];
+                streamBacklog.oldestRecordDate = [NSDate dateWithTimeIntervalSince1970:[rs doubleForColumn:@"timestamp"]];
+                streamBacklogs[streamBacklog.streamName] = streamBacklog;
+            }
+            [rs close];
+        }];
+    }
+
+    NSMutableArray<AWSKinesisRecorderStreamBacklog *> *sortedStreamBacklogs = [NSMutableArray arrayWithCapacity:[streamBacklogs count]];
+    for (NSString *streamName in [[streamBacklogs allKeys] sortedArrayUsingSelector:@selector(compare:)]) {
+        AWSKinesisRecorderStreamBacklog *streamBacklog = streamBacklogs[streamName];
+        @synchronized(self.streamBackoffs) {
+            NSDate *backoffDate = self.streamBackoffs[streamName].date;
+            if ([backoffDate timeIntervalSinceNow] > 0) {
+                streamBacklog.backoffDate = backoffDate;
+            }
+        }
+        [sortedStreamBacklogs addObject:streamBacklog];
     }
+    return sortedStreamBacklogs;
 }
 
 - (void)setBatchRecordsByteLimit:(NSUInteger)batchRecordsByteLimit {
-    if (batchRecordsByteLimit > 4 * 1024 * 1024) {
-        _batchRecordsByteLimit = 4 * 1024 * 1024;
+    if (batchRecordsByteLimit > 5 * 1024 * 1024) {
+        _batchRecordsByteLimit = 5 * 1024 * 1024;
     } else {
         _batchRecordsByteLimit = batchRecordsByteLimit;
     }
@@ -130,6 +130,19 @@ FOUNDATION_EXPORT NSString *const AWSFirehoseRecorderByteThresholdReachedNotific
  */
 + (void)registerFirehoseRecorderWithConfiguration:(AWSServiceConfiguration *)configuration forKey:(NSString *)key;
 
+/**
+ Creates a service client with the given service configuration and storage, and registers it for the key.
+
+ @warning After calling this method, do not modify the configuration object. It may cause unspecified behaviors.
+
+ @param configuration A service configuration object.
+ @param storage       How the service client stores the saved records.
+ @param key           A string to identify the service client.
+ */
++ (void)registerFirehoseRecorderWithConfiguration:(AWSServiceConfiguration *)configuration
+                                          storage:(AWSKinesisRecorderStorage)storage
+                                           forKey:(NSString *)key;
+
 /**
  Retrieves the service client associated with the key. You need to call `+ registerFirehoseWithConfiguration:forKey:` before invoking this method.
 
@@ -44,7 +44,8 @@ NSString *const AWSFirehoseRecorderCacheName = @"com.amazonaws.AWSFirehoseRecord
 
 - (instancetype)initWithConfiguration:(AWSServiceConfiguration *)configuration
                            identifier:(NSString *)identifier
-                            cacheName:(NSString *)cacheName;
+                            cacheName:(NSString *)cacheName
+                              storage:(AWSKinesisRecorderStorage)storage;
 
 + (NSString *) databasePathForKey:(NSString *)key;
 
@@ -77,13 +78,22 @@ static AWSSynchronizedMutableDictionary *_serviceClients = nil;
 
         _defaultFirehoseRecorder = [[AWSFirehoseRecorder alloc] initWithConfiguration:serviceConfiguration
                                                                          identifier:@"Default"
-                                                                          cacheName:AWSFirehoseRecorderCacheName];
+                                                                          cacheName:AWSFirehoseRecorderCacheName
+                                                                            storage:AWSKinesisRecorderStorageDatabase];
     });
 
     return _defaultFirehoseRecorder;
 }
 
 + (void)registerFirehoseRecorderWithConfiguration:(AWSServiceConfiguration *)configuration forKey:(NSString *)key {
+    [self registerFirehoseRecorderWithConfiguration:configuration
+                                            storage:AWSKinesisRecorderStorageDatabase
+                                             forKey:key];
+}
+
++ (void)registerFirehoseRecorderWithConfiguration:(AWSServiceConfiguration *)configuration
+                                          storage:(AWSKinesisRecorderStorage)storage
+                                           forKey:(NSString *)key {
     static dispatch_once_t onceToken;
     dispatch_once(&onceToken, ^{
         _serviceClients = [AWSSynchronizedMutableDictionary new];
@@ -92,7 +102,8 @@ static AWSSynchronizedMutableDictionary *_serviceClients = nil;
     NSString *identifier = [AWSAbstractKinesisRecorder databasePathForKey:key];
     AWSFirehoseRecorder *FirehoseRecorder = [[AWSFirehoseRecorder alloc] initWithConfiguration:configuration
                                                                                  identifier:identifier
-                                                                                  cacheName:[NSString stringWithFormat:@"%@.%@", AWSFirehoseRecorderCacheName, key]];
+                                                                                  cacheName:[NSString stringWithFormat:@"%@.%@", AWSFirehoseRecorderCacheName, key]
+                                                                                    storage:storage];
     [_serviceClients setObject:FirehoseRecorder
                         forKey:key];
 }
@@ -129,10 +140,12 @@ static AWSSynchronizedMutableDictionary *_serviceClients = nil;
 
 - (instancetype)initWithConfiguration:(AWSServiceConfiguration *)configuration
                            identifier:(NSString *)identifier
-                            cacheName:(NSString *)cacheName {
+                            cacheName:(NSString *)cacheName
+                              storage:(AWSKinesisRecorderStorage)storage {
     if (self = [super initWithConfiguration:configuration
                                 identifier:identifier
-                                 cacheName:cacheName]) {
+                                 cacheName:cacheName
+                                   storage:storage]) {
         self.recorderHelper = [[AWSFirehoseRecorderHelper alloc] initWithConfiguration:configuration];
     }
     return self;
@@ -160,8 +173,7 @@ static AWSSynchronizedMutableDictionary *_serviceClients = nil;
                             records:(NSArray *)temporaryRecords
                              rowIds:(NSArray *)rowIds
                           putRowIds:(NSMutableArray *)putRowIds
-                        retryRowIds:(NSMutableArray *)retryRowIds
-                               stop:(BOOL *)stop {
+                        retryRowIds:(NSMutableArray *)retryRowIds {
     NSMutableArray *records = [NSMutableArray new];
 
     for (NSDictionary *recordDictionary in temporaryRecords) {
@@ -179,11 +191,6 @@ static AWSSynchronizedMutableDictionary *_serviceClients = nil;
     return [[self.firehose putRecordBatch:putRecordBatchInput] continueWithBlock:^id(AWSTask *task) {
         if (task.error) {
             AWSDDLogError(@"Error: [%@]", task.error);
-            const NSArray *stopErrorDomains = @[NSURLErrorDomain, AWSCognitoIdentityErrorDomain];
-
-            if (task.error && [stopErrorDomains containsObject:task.error.domain]) {
-                *stop = YES;
-            }
             return [AWSTask taskWithError:task.error];
         }
         if (task.result) {
@@ -208,6 +215,21 @@ static AWSSynchronizedMutableDictionary *_serviceClients = nil;
     }];
 }
 
+// The limits of a PutRecordBatch request.
+- (NSUInteger)batchRecordCountLimit {
+    return 500;
+}
+
+- (NSUInteger)batchByteLimit {
+    return 4 * 1024 * 1024; // 4MB
+}
+
+// Firehose has no shards.
+- (NSString *)cachedShardIdForStream:(NSString *)streamName
+                        partitionKey:(NSString *)partitionKey {
+    return nil;
+}
+
 - (NSError *)dataTooLargeError {
     return [NSError errorWithDomain:AWSFirehoseRecorderErrorDomain
                                code:AWSFirehoseRecorderErrorDataTooLarge
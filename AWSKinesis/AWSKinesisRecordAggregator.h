@@ -0,0 +1,71 @@
+//
+// Copyright 2010-2021 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License.
+// A copy of the License is located at
+//
+// http://aws.amazon.com/apache2.0
+//
+// or in the "license" file accompanying this file. This file is distributed
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+//
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ The maximum size in bytes of a Kinesis record, data and partition key, 1MB.
+ */
+FOUNDATION_EXPORT NSUInteger const AWSKinesisRecordAggregatorByteLimit;
+
+/**
+ The four bytes an aggregated record starts with.
+ */
+FOUNDATION_EXPORT const uint8_t AWSKinesisRecordAggregatorMagic[4];
+
+/**
+ Packs records into one Kinesis record in the aggregated record format of the Kinesis Producer Library, which the Kinesis Client Library de-aggregates.
+
+ An aggregated record is the magic bytes, the `AggregatedRecord` protobuf message of the records, and the MD5 digest of the message. The partition key of the aggregated record is the partition key of its first record.
+ */
+@interface AWSKinesisRecordAggregator : NSObject
+
+/**
+ The number of records added.
+ */
+@property (nonatomic, assign, readonly) NSUInteger recordCount;
+
+/**
+ The partition key of the aggregated record, or `nil` if no record was added.
+ */
+@property (nonatomic, strong, readonly, nullable) NSString *partitionKey;
+
+/**
+ The size in bytes of the data of the aggregated record with the records added so far.
+ */
+@property (nonatomic, assign, readonly) NSUInteger byteCount;
+
+/**
+ Whether the record can be added without taking the aggregated record, data and partition key, past `AWSKinesisRecordAggregatorByteLimit`. The first record can always be added.
+ */
+- (BOOL)canAddRecordWithData:(NSData *)data
+                partitionKey:(NSString *)partitionKey;
+
+/**
+ Adds the record.
+ */
+- (void)addRecordWithData:(NSData *)data
+             partitionKey:(NSString *)partitionKey;
+
+/**
+ The data of the aggregated record. When a single record was added, it is the data of the record, which does not need to be aggregated.
+ */
+- (NSData *)aggregatedData;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,177 @@
+//
+// Copyright 2010-2021 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License.
+// A copy of the License is located at
+//
+// http://aws.amazon.com/apache2.0
+//
+// or in the "license" file accompanying this file. This file is distributed
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+//
+
+#import "AWSKinesisRecordAggregator.h"
+#import <CommonCrypto/CommonDigest.h>
+
+NSUInteger const AWSKinesisRecordAggregatorByteLimit = 1024 * 1024; // 1MB
+const uint8_t AWSKinesisRecordAggregatorMagic[4] = {0xF3, 0x89, 0x9A, 0xC2};
+
+// The fields of the messages, with their wire types.
+//
+// message AggregatedRecord {
+//     repeated string partition_key_table = 1;
+//     repeated string explicit_hash_key_table = 2;
+//     repeated Record records = 3;
+// }
+//
+// message Record {
+//     required uint64 partition_key_index = 1;
+//     optional uint64 explicit_hash_key_index = 2;
+//     required bytes data = 3;
+//     repeated Tag tags = 4;
+// }
+static const uint8_t AWSKinesisRecordAggregatorPartitionKeyTableTag = (1 << 3) | 2;
+static const uint8_t AWSKinesisRecordAggregatorRecordsTag = (3 << 3) | 2;
+static const uint8_t AWSKinesisRecordAggregatorPartitionKeyIndexTag = (1 << 3) | 0;
+static const uint8_t AWSKinesisRecordAggregatorDataTag = (3 << 3) | 2;
+
+static NSUInteger AWSKinesisRecordAggregatorVarintLength(uint64_t value) {
+    NSUInteger length = 1;
+    while (value >= 0x80) {
+        value >>= 7;
+        length++;
+    }
+    return length;
+}
+
+static void AWSKinesisRecordAggregatorAppendVarint(NSMutableData *data, uint64_t value) {
+    uint8_t bytes[10];
+    NSUInteger length = 0;
+    while (value >= 0x80) {
+        bytes[length++] = (uint8_t)(value | 0x80);
+        value >>= 7;
+    }
+    bytes[length++] = (uint8_t)value;
+    [data appendBytes:bytes length:length];
+}
+
+// The length of a length-delimited field of `length` bytes, with its tag.
+static NSUInteger AWSKinesisRecordAggregatorFieldLength(NSUInteger length) {
+    return 1 + AWSKinesisRecordAggregatorVarintLength(length) + length;
+}
+
+@interface AWSKinesisRecordAggregator()
+
+@property (nonatomic, assign) NSUInteger recordCount;
+@property (nonatomic, strong) NSString *partitionKey;
+@property (nonatomic, assign) NSUInteger messageLength;
+@property (nonatomic, strong) NSMutableArray<NSString *> *partitionKeys;
+@property (nonatomic, strong) NSMutableDictionary<NSString *, NSNumber *> *partitionKeyIndexes;
+@property (nonatomic, strong) NSMutableArray<NSData *> *records;
+@property (nonatomic, strong) NSMutableArray<NSNumber *> *recordPartitionKeyIndexes;
+
+@end
+
+@implementation AWSKinesisRecordAggregator
+
+- (instancetype)init {
+    if (self = [super init]) {
+        _partitionKeys = [NSMutableArray new];
+        _partitionKeyIndexes = [NSMutableDictionary new];
+        _records = [NSMutableArray new];
+        _recordPartitionKeyIndexes = [NSMutableArray new];
+    }
+    return self;
+}
+
+- (NSUInteger)byteCount {
+    return sizeof(AWSKinesisRecordAggregatorMagic) + self.messageLength + CC_MD5_DIGEST_LENGTH;
+}
+
+// The length of the `Record` message of a record.
+- (NSUInteger)recordMessageLengthWithData:(NSData *)data
+                        partitionKeyIndex:(NSUInteger)partitionKeyIndex {
+    return 1 + AWSKinesisRecordAggregatorVarintLength(partitionKeyIndex) + AWSKinesisRecordAggregatorFieldLength([data length]);
+}
+
+// The length the message grows by when the record is added.
+- (NSUInteger)messageLengthOfRecordWithData:(NSData *)data
+                               partitionKey:(NSString *)partitionKey {
+    NSNumber *partitionKeyIndex = self.partitionKeyIndexes[partitionKey];
+    NSUInteger length = 0;
+    if (!partitionKeyIndex) {
+        partitionKeyIndex = @([self.partitionKeys count]);
+        length += AWSKinesisRecordAggregatorFieldLength([partitionKey lengthOfBytesUsingEncoding:NSUTF8StringEncoding]);
+    }
+    length += AWSKinesisRecordAggregatorFieldLength([self recordMessageLengthWithData:data
+                                                                   partitionKeyIndex:[partitionKeyIndex unsignedIntegerValue]]);
+    return length;
+}
+
+- (BOOL)canAddRecordWithData:(NSData *)data
+                partitionKey:(NSString *)partitionKey {
+    if (self.recordCount == 0) {
+        return YES;
+    }
+    NSUInteger byteCount = self.byteCount + [self messageLengthOfRecordWithData:data partitionKey:partitionKey];
+    return byteCount + [self.partitionKey lengthOfBytesUsingEncoding:NSUTF8StringEncoding] <= AWSKinesisRecordAggregatorByteLimit;
+}
+
+- (void)addRecordWithData:(NSData *)data
+             partitionKey:(NSString *)partitionKey {
+    self.messageLength += [self messageLengthOfRecordWithData:data partitionKey:partitionKey];
+
+    NSNumber *partitionKeyIndex = self.partitionKeyIndexes[partitionKey];
+    if (!partitionKeyIndex) {
+        partitionKeyIndex = @([self.partitionKeys count]);
+        self.partitionKeyIndexes[partitionKey] = partitionKeyIndex;
+        [self.partitionKeys addObject:partitionKey];
+    }
+    [self.records addObject:data];
+    [self.recordPartitionKeyIndexes addObject:partitionKeyIndex];
+
+    if (self.recordCount == 0) {
+        self.partitionKey = partitionKey;
+    }
+    self.recordCount += 1;
+}
+
+- (NSData *)aggregatedData {
+    if (self.recordCount == 1) {
+        return [self.records firstObject];
+    }
+
+    NSMutableData *message = [NSMutableData dataWithCapacity:self.messageLength];
+    for (NSString *partitionKey in self.partitionKeys) {
+        NSData *partitionKeyData = [partitionKey dataUsingEncoding:NSUTF8StringEncoding];
+        [message appendBytes:&AWSKinesisRecordAggregatorPartitionKeyTableTag length:1];
+        AWSKinesisRecordAggregatorAppendVarint(message, [partitionKeyData length]);
+        [message appendData:partitionKeyData];
+    }
+    for (NSUInteger i = 0; i < [self.records count]; i++) {
+        NSData *data = self.records[i];
+        NSUInteger partitionKeyIndex = [self.recordPartitionKeyIndexes[i] unsignedIntegerValue];
+
+        [message appendBytes:&AWSKinesisRecordAggregatorRecordsTag length:1];
+        AWSKinesisRecordAggregatorAppendVarint(message, [self recordMessageLengthWithData:data partitionKeyIndex:partitionKeyIndex]);
+        [message appendBytes:&AWSKinesisRecordAggregatorPartitionKeyIndexTag length:1];
+        AWSKinesisRecordAggregatorAppendVarint(message, partitionKeyIndex);
+        [message appendBytes:&AWSKinesisRecordAggregatorDataTag length:1];
+        AWSKinesisRecordAggregatorAppendVarint(message, [data length]);
+        [message appendData:data];
+    }
+
+    unsigned char digest[CC_MD5_DIGEST_LENGTH];
+    CC_MD5([message bytes], (CC_LONG)[message length], digest);
+
+    NSMutableData *aggregatedData = [NSMutableData dataWithCapacity:self.byteCount];
+    [aggregatedData appendBytes:AWSKinesisRecordAggregatorMagic length:sizeof(AWSKinesisRecordAggregatorMagic)];
+    [aggregatedData appendData:message];
+    [aggregatedData appendBytes:digest length:CC_MD5_DIGEST_LENGTH];
+    return aggregatedData;
+}
+
+@end
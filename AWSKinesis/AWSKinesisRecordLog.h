@@ -0,0 +1,133 @@
+//
+// Copyright 2010-2021 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License.
+// A copy of the License is located at
+//
+// http://aws.amazon.com/apache2.0
+//
+// or in the "license" file accompanying this file. This file is distributed
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+//
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ The default size in bytes at which `AWSKinesisRecordLog` starts a new segment file, 1MB.
+ */
+FOUNDATION_EXPORT NSUInteger const AWSKinesisRecordLogSegmentByteLimitDefault;
+
+/**
+ A record of `AWSKinesisRecordLog`.
+ */
+@interface AWSKinesisRecordLogEntry : NSObject
+
+@property (nonatomic, strong) NSString *partitionKey;
+@property (nonatomic, strong) NSString *streamName;
+@property (nonatomic, strong) NSData *data;
+@property (nonatomic, assign) NSTimeInterval timestamp;
+@property (nonatomic, assign) uint32_t retryCount;
+
+/**
+ The offset of the record in the log. Set by `readRecordsFromOffset:recordCountLimit:byteLimit:error:`.
+ */
+@property (nonatomic, assign) unsigned long long offset;
+
+/**
+ The offset of the record after this one. Acknowledging up to it removes this record.
+ */
+@property (nonatomic, assign) unsigned long long nextOffset;
+
+@end
+
+/**
+ An append-only log of records, stored in a directory of segment files.
+
+ Each record is framed with its length and the CRC-32 of its contents. Records are read in the order they were appended, from the acknowledged offset, which is saved in a checkpoint file. A segment file is deleted once all of its records are acknowledged.
+
+ When the log is opened, a record which was partially written to the last segment, for example because the app was terminated, is truncated away. A record which fails its CRC check when it is read is skipped with the rest of its segment. When a failed write leaves part of a record in a segment which cannot be truncated, the next records are appended to a new segment.
+
+ The methods of this class are thread-safe.
+ */
+@interface AWSKinesisRecordLog : NSObject
+
+/**
+ The offset of the first record which is not acknowledged.
+ */
+@property (nonatomic, assign, readonly) unsigned long long acknowledgedOffset;
+
+/**
+ The offset the next record is appended at.
+ */
+@property (nonatomic, assign, readonly) unsigned long long endOffset;
+
+/**
+ The number of bytes used by the records which are not acknowledged.
+ */
+@property (nonatomic, assign, readonly) NSUInteger byteCount;
+
+/**
+ Opens the log in `directoryPath`, creating the directory if needed, and recovers it.
+
+ @param directoryPath    The directory of the segment files and the checkpoint file.
+ @param segmentByteLimit The size in bytes at which a new segment file is started.
+ @param error            The error if the log cannot be opened.
+
+ @return The log, or `nil` if it cannot be opened.
+ */
+- (nullable instancetype)initWithDirectoryPath:(NSString *)directoryPath
+                              segmentByteLimit:(NSUInteger)segmentByteLimit
+                                         error:(NSError **)error;
+
+/**
+ Appends the records to the log in order, with one write per segment. When a write fails, the records of that write and the records after them are not appended.
+ */
+- (BOOL)appendRecords:(NSArray<AWSKinesisRecordLogEntry *> *)records
+                error:(NSError **)error;
+
+/**
+ Reads the records from `offset` in order. Stops after `recordCountLimit` records, or before the record which would take the data and partition keys read past `byteLimit`. The first record is always read. A `byteLimit` of 0 is ignored.
+ */
+- (nullable NSArray<AWSKinesisRecordLogEntry *> *)readRecordsFromOffset:(unsigned long long)offset
+                                                       recordCountLimit:(NSUInteger)recordCountLimit
+                                                              byteLimit:(NSUInteger)byteLimit
+                                                                  error:(NSError **)error;
+
+/**
+ Acknowledges the records before `offset`, saves the checkpoint and deletes the segment files which only contain acknowledged records.
+ */
+- (BOOL)acknowledgeToOffset:(unsigned long long)offset
+                      error:(NSError **)error;
+
+/**
+ Appends again the records read from the log which are to be read again, then acknowledges the records before `offset`. The records which were acknowledged since they were read, for example because they took the log past its limits, are left out, so that they are not read again.
+ */
+- (BOOL)appendRecords:(NSArray<AWSKinesisRecordLogEntry *> *)records
+acknowledgingToOffset:(unsigned long long)offset
+                error:(NSError **)error;
+
+/**
+ Acknowledges the oldest records which are older than `timestamp`, or which take the log past `byteCountLimit`. A `timestamp` or `byteCountLimit` of 0 is ignored.
+ */
+- (BOOL)acknowledgeRecordsBeforeTimestamp:(NSTimeInterval)timestamp
+                           byteCountLimit:(NSUInteger)byteCountLimit
+                                    error:(NSError **)error;
+
+/**
+ Acknowledges all the records.
+ */
+- (BOOL)removeAllRecords:(NSError **)error;
+
+/**
+ Closes the files of the log. The log cannot be used afterwards.
+ */
+- (void)close;
+
+@end
+
+NS_ASSUME_NONNULL_END
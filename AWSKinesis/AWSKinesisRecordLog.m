@@ -0,0 +1,608 @@
+//
+// Copyright 2010-2021 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License.
+// A copy of the License is located at
+//
+// http://aws.amazon.com/apache2.0
+//
+// or in the "license" file accompanying this file. This file is distributed
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+//
+
+#import "AWSKinesisRecordLog.h"
+#import <AWSCore/AWSCore.h>
+#import <fcntl.h>
+#import <unistd.h>
+
+NSUInteger const AWSKinesisRecordLogSegmentByteLimitDefault = 1024 * 1024; // 1MB
+
+static NSString *const AWSKinesisRecordLogSegmentPathExtension = @"segment";
+static NSString *const AWSKinesisRecordLogCheckpointFileName = @"checkpoint";
+static const uint32_t AWSKinesisRecordLogCheckpointMagic = 0x4B524C43;
+
+// A frame is the length and the CRC-32 of the record, followed by the record.
+static const size_t AWSKinesisRecordLogFrameHeaderLength = 8;
+// A record starts with its timestamp, its retry count, and the lengths of its partition key and stream name.
+static const size_t AWSKinesisRecordLogRecordHeaderLength = 20;
+// Records are smaller than 256KB, so a longer frame is corrupted.
+static const uint32_t AWSKinesisRecordLogRecordLengthLimit = 16 * 1024 * 1024;
+
+typedef NS_ENUM(NSInteger, AWSKinesisRecordLogFrameStatus) {
+    AWSKinesisRecordLogFrameStatusValid,
+    AWSKinesisRecordLogFrameStatusEnd,
+    AWSKinesisRecordLogFrameStatusCorrupted,
+    AWSKinesisRecordLogFrameStatusFailed,
+};
+
+static uint32_t AWSKinesisRecordLogCRC32(const uint8_t *bytes, size_t length) {
+    static uint32_t table[256];
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        for (uint32_t i = 0; i < 256; i++) {
+            uint32_t value = i;
+            for (int bit = 0; bit < 8; bit++) {
+                value = (value & 1) ? (0xEDB88320 ^ (value >> 1)) : (value >> 1);
+            }
+            table[i] = value;
+        }
+    });
+
+    uint32_t crc = 0xFFFFFFFF;
+    for (size_t i = 0; i < length; i++) {
+        crc = table[(crc ^ bytes[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return crc ^ 0xFFFFFFFF;
+}
+
+static void AWSKinesisRecordLogAppendUInt32(NSMutableData *data, uint32_t value) {
+    value = CFSwapInt32HostToLittle(value);
+    [data appendBytes:&value length:sizeof(value)];
+}
+
+static void AWSKinesisRecordLogAppendUInt64(NSMutableData *data, uint64_t value) {
+    value = CFSwapInt64HostToLittle(value);
+    [data appendBytes:&value length:sizeof(value)];
+}
+
+static uint32_t AWSKinesisRecordLogGetUInt32(const uint8_t *bytes) {
+    uint32_t value;
+    memcpy(&value, bytes, sizeof(value));
+    return CFSwapInt32LittleToHost(value);
+}
+
+static uint64_t AWSKinesisRecordLogGetUInt64(const uint8_t *bytes) {
+    uint64_t value;
+    memcpy(&value, bytes, sizeof(value));
+    return CFSwapInt64LittleToHost(value);
+}
+
+static NSError *AWSKinesisRecordLogPOSIXError(void) {
+    return [NSError errorWithDomain:NSPOSIXErrorDomain
+                               code:errno
+                           userInfo:nil];
+}
+
+// Appends the frame of `record` to `frames`.
+static void AWSKinesisRecordLogAppendFrame(NSMutableData *frames, AWSKinesisRecordLogEntry *record) {
+    NSData *partitionKey = [record.partitionKey dataUsingEncoding:NSUTF8StringEncoding];
+    NSData *streamName = [record.streamName dataUsingEncoding:NSUTF8StringEncoding];
+    uint32_t recordLength = (uint32_t)(AWSKinesisRecordLogRecordHeaderLength + [partitionKey length] + [streamName length] + [record.data length]);
+
+    NSUInteger frameStart = [frames length];
+    AWSKinesisRecordLogAppendUInt32(frames, recordLength);
+    AWSKinesisRecordLogAppendUInt32(frames, 0);
+
+    uint64_t timestamp;
+    NSTimeInterval recordTimestamp = record.timestamp;
+    memcpy(&timestamp, &recordTimestamp, sizeof(timestamp));
+    AWSKinesisRecordLogAppendUInt64(frames, timestamp);
+    AWSKinesisRecordLogAppendUInt32(frames, record.retryCount);
+    AWSKinesisRecordLogAppendUInt32(frames, (uint32_t)[partitionKey length]);
+    AWSKinesisRecordLogAppendUInt32(frames, (uint32_t)[streamName length]);
+    [frames appendData:partitionKey];
+    [frames appendData:streamName];
+    [frames appendData:record.data];
+
+    uint32_t crc = CFSwapInt32HostToLittle(AWSKinesisRecordLogCRC32((const uint8_t *)[frames bytes] + frameStart + AWSKinesisRecordLogFrameHeaderLength, recordLength));
+    [frames replaceBytesInRange:NSMakeRange(frameStart + 4, sizeof(crc)) withBytes:&crc];
+}
+
+// Reads the frame at `position`, and checks its length and CRC-32. Sets errno when it fails.
+static AWSKinesisRecordLogFrameStatus AWSKinesisRecordLogReadFrame(int fileDescriptor, off_t position, NSData **record) {
+    uint8_t header[AWSKinesisRecordLogFrameHeaderLength];
+    ssize_t readLength = pread(fileDescriptor, header, sizeof(header), position);
+    if (readLength < 0) {
+        return AWSKinesisRecordLogFrameStatusFailed;
+    }
+    if (readLength == 0) {
+        return AWSKinesisRecordLogFrameStatusEnd;
+    }
+    if (readLength < (ssize_t)sizeof(header)) {
+        return AWSKinesisRecordLogFrameStatusCorrupted;
+    }
+
+    uint32_t recordLength = AWSKinesisRecordLogGetUInt32(header);
+    if (recordLength < AWSKinesisRecordLogRecordHeaderLength || recordLength > AWSKinesisRecordLogRecordLengthLimit) {
+        return AWSKinesisRecordLogFrameStatusCorrupted;
+    }
+
+    NSMutableData *data = [NSMutableData dataWithLength:recordLength];
+    readLength = pread(fileDescriptor, [data mutableBytes], recordLength, position + sizeof(header));
+    if (readLength < 0) {
+        return AWSKinesisRecordLogFrameStatusFailed;
+    }
+    if (readLength < (ssize_t)recordLength
+        || AWSKinesisRecordLogCRC32([data bytes], recordLength) != AWSKinesisRecordLogGetUInt32(header + 4)) {
+        return AWSKinesisRecordLogFrameStatusCorrupted;
+    }
+
+    *record = data;
+    return AWSKinesisRecordLogFrameStatusValid;
+}
+
+static AWSKinesisRecordLogEntry *AWSKinesisRecordLogDecodeRecord(NSData *data) {
+    const uint8_t *bytes = [data bytes];
+    uint64_t timestamp = AWSKinesisRecordLogGetUInt64(bytes);
+    uint32_t retryCount = AWSKinesisRecordLogGetUInt32(bytes + 8);
+    NSUInteger partitionKeyLength = AWSKinesisRecordLogGetUInt32(bytes + 12);
+    NSUInteger streamNameLength = AWSKinesisRecordLogGetUInt32(bytes + 16);
+    if (AWSKinesisRecordLogRecordHeaderLength + partitionKeyLength + streamNameLength > [data length]) {
+        return nil;
+    }
+
+    AWSKinesisRecordLogEntry *record = [AWSKinesisRecordLogEntry new];
+    NSTimeInterval recordTimestamp;
+    memcpy(&recordTimestamp, &timestamp, sizeof(recordTimestamp));
+    record.timestamp = recordTimestamp;
+    record.retryCount = retryCount;
+
+    NSUInteger position = AWSKinesisRecordLogRecordHeaderLength;
+    record.partitionKey = [[NSString alloc] initWithBytes:bytes + position
+                                                   length:partitionKeyLength
+                                                 encoding:NSUTF8StringEncoding];
+    position += partitionKeyLength;
+    record.streamName = [[NSString alloc] initWithBytes:bytes + position
+                                                 length:streamNameLength
+                                               encoding:NSUTF8StringEncoding];
+    position += streamNameLength;
+    record.data = [data subdataWithRange:NSMakeRange(position, [data length] - position)];
+    if (!record.partitionKey || !record.streamName) {
+        return nil;
+    }
+    return record;
+}
+
+@implementation AWSKinesisRecordLogEntry
+
+@end
+
+@interface AWSKinesisRecordLog()
+
+@property (nonatomic, strong) NSString *directoryPath;
+@property (nonatomic, assign) NSUInteger segmentByteLimit;
+@property (nonatomic, strong) NSMutableArray<NSNumber *> *segmentBaseOffsets;
+@property (nonatomic, assign) int writeFileDescriptor;
+@property (nonatomic, assign) BOOL activeSegmentDamaged;
+@property (nonatomic, assign) int readFileDescriptor;
+@property (nonatomic, assign) unsigned long long readSegmentBaseOffset;
+@property (nonatomic, assign, readwrite) unsigned long long acknowledgedOffset;
+@property (nonatomic, assign, readwrite) unsigned long long endOffset;
+
+@end
+
+@implementation AWSKinesisRecordLog
+
+- (instancetype)initWithDirectoryPath:(NSString *)directoryPath
+                     segmentByteLimit:(NSUInteger)segmentByteLimit
+                                error:(NSError **)error {
+    if (self = [super init]) {
+        _directoryPath = directoryPath;
+        _segmentByteLimit = MAX(segmentByteLimit, 1);
+        _segmentBaseOffsets = [NSMutableArray new];
+        _writeFileDescriptor = -1;
+        _readFileDescriptor = -1;
+
+        if (![self open:error]) {
+            [self close];
+            return nil;
+        }
+    }
+    return self;
+}
+
+- (void)dealloc {
+    [self close];
+}
+
+- (BOOL)open:(NSError **)error {
+    NSFileManager *fileManager = [NSFileManager defaultManager];
+    if (![fileManager createDirectoryAtPath:self.directoryPath
+                withIntermediateDirectories:YES
+                                 attributes:nil
+                                      error:error]) {
+        return NO;
+    }
+    NSArray<NSString *> *fileNames = [fileManager contentsOfDirectoryAtPath:self.directoryPath error:error];
+    if (!fileNames) {
+        return NO;
+    }
+
+    for (NSString *fileName in fileNames) {
+        unsigned long long baseOffset = 0;
+        if ([[fileName pathExtension] isEqualToString:AWSKinesisRecordLogSegmentPathExtension]
+            && [[NSScanner scannerWithString:[fileName stringByDeletingPathExtension]] scanUnsignedLongLong:&baseOffset]) {
+            [self.segmentBaseOffsets addObject:@(baseOffset)];
+        }
+    }
+    [self.segmentBaseOffsets sortUsingSelector:@selector(compare:)];
+
+    BOOL hasCheckpoint = NO;
+    unsigned long long checkpoint = [self readCheckpoint:&hasCheckpoint];
+    unsigned long long lastBaseOffset = hasCheckpoint ? checkpoint : 0;
+    if ([self.segmentBaseOffsets count] > 0) {
+        lastBaseOffset = [[self.segmentBaseOffsets lastObject] unsignedLongLongValue];
+        [self.segmentBaseOffsets removeLastObject];
+    }
+
+    // Only the last segment can end with a partially written record. Keeps the records before it.
+    unsigned long long validLength = 0;
+    int fileDescriptor = open([[self segmentPathForBaseOffset:lastBaseOffset] fileSystemRepresentation], O_RDONLY);
+    if (fileDescriptor >= 0) {
+        NSData *record = nil;
+        AWSKinesisRecordLogFrameStatus status;
+        while ((status = AWSKinesisRecordLogReadFrame(fileDescriptor, (off_t)validLength, &record)) == AWSKinesisRecordLogFrameStatusValid) {
+            validLength += AWSKinesisRecordLogFrameHeaderLength + [record length];
+        }
+        close(fileDescriptor);
+        if (status == AWSKinesisRecordLogFrameStatusFailed) {
+            if (error) {
+                *error = AWSKinesisRecordLogPOSIXError();
+            }
+            return NO;
+        }
+    }
+
+    self.endOffset = lastBaseOffset;
+    if (![self startSegmentAtEndOffset:error]) {
+        return NO;
+    }
+    if (ftruncate(self.writeFileDescriptor, (off_t)validLength) != 0) {
+        if (error) {
+            *error = AWSKinesisRecordLogPOSIXError();
+        }
+        return NO;
+    }
+    self.endOffset = lastBaseOffset + validLength;
+
+    unsigned long long firstBaseOffset = [[self.segmentBaseOffsets firstObject] unsignedLongLongValue];
+    self.acknowledgedOffset = hasCheckpoint ? MIN(MAX(checkpoint, firstBaseOffset), self.endOffset) : firstBaseOffset;
+    [self deleteAcknowledgedSegments];
+
+    return YES;
+}
+
+- (void)close {
+    @synchronized(self) {
+        if (self.writeFileDescriptor >= 0) {
+            close(self.writeFileDescriptor);
+            self.writeFileDescriptor = -1;
+        }
+        if (self.readFileDescriptor >= 0) {
+            close(self.readFileDescriptor);
+            self.readFileDescriptor = -1;
+        }
+    }
+}
+
+- (NSUInteger)byteCount {
+    @synchronized(self) {
+        return (NSUInteger)(self.endOffset - self.acknowledgedOffset);
+    }
+}
+
+#pragma mark - Segments
+
+- (NSString *)segmentPathForBaseOffset:(unsigned long long)baseOffset {
+    NSString *fileName = [NSString stringWithFormat:@"%020llu.%@", baseOffset, AWSKinesisRecordLogSegmentPathExtension];
+    return [self.directoryPath stringByAppendingPathComponent:fileName];
+}
+
+- (unsigned long long)activeSegmentBaseOffset {
+    return [[self.segmentBaseOffsets lastObject] unsignedLongLongValue];
+}
+
+// Makes a segment starting at `endOffset` the segment records are appended to.
+- (BOOL)startSegmentAtEndOffset:(NSError **)error {
+    NSString *path = [self segmentPathForBaseOffset:self.endOffset];
+    int fileDescriptor = open([path fileSystemRepresentation], O_WRONLY | O_CREAT | O_APPEND, 0600);
+    if (fileDescriptor < 0) {
+        if (error) {
+            *error = AWSKinesisRecordLogPOSIXError();
+        }
+        return NO;
+    }
+
+    if (self.writeFileDescriptor >= 0) {
+        close(self.writeFileDescriptor);
+    }
+    self.writeFileDescriptor = fileDescriptor;
+    self.activeSegmentDamaged = NO;
+    [self.segmentBaseOffsets addObject:@(self.endOffset)];
+    return YES;
+}
+
+// Ends the active segment when the frames written in part by a failed write could not be truncated away, so that
+// they are never read as records: the next records are appended to a new segment. An empty segment is replaced.
+- (BOOL)sealDamagedSegment:(NSError **)error {
+    if (self.endOffset > [self activeSegmentBaseOffset]) {
+        return [self startSegmentAtEndOffset:error];
+    }
+
+    NSString *path = [self segmentPathForBaseOffset:self.endOffset];
+    int fileDescriptor = open([path fileSystemRepresentation], O_WRONLY | O_CREAT | O_TRUNC | O_APPEND, 0600);
+    if (fileDescriptor < 0) {
+        if (error) {
+            *error = AWSKinesisRecordLogPOSIXError();
+        }
+        return NO;
+    }
+    close(self.writeFileDescriptor);
+    self.writeFileDescriptor = fileDescriptor;
+    self.activeSegmentDamaged = NO;
+    return YES;
+}
+
+- (void)deleteAcknowledgedSegments {
+    while ([self.segmentBaseOffsets count] > 1
+           && [self.segmentBaseOffsets[1] unsignedLongLongValue] <= self.acknowledgedOffset) {
+        unsigned long long baseOffset = [self.segmentBaseOffsets[0] unsignedLongLongValue];
+        if (self.readFileDescriptor >= 0 && self.readSegmentBaseOffset == baseOffset) {
+            close(self.readFileDescriptor);
+            self.readFileDescriptor = -1;
+        }
+        NSString *path = [self segmentPathForBaseOffset:baseOffset];
+        if (unlink([path fileSystemRepresentation]) != 0 && errno != ENOENT) {
+            AWSDDLogError(@"Failed to delete the log segment [%@]. [%@]", path, AWSKinesisRecordLogPOSIXError());
+        }
+        [self.segmentBaseOffsets removeObjectAtIndex:0];
+    }
+}
+
+- (int)readFileDescriptorForSegmentBaseOffset:(unsigned long long)baseOffset
+                                        error:(NSError **)error {
+    if (self.readFileDescriptor >= 0 && self.readSegmentBaseOffset == baseOffset) {
+        return self.readFileDescriptor;
+    }
+    if (self.readFileDescriptor >= 0) {
+        close(self.readFileDescriptor);
+        self.readFileDescriptor = -1;
+    }
+
+    int fileDescriptor = open([[self segmentPathForBaseOffset:baseOffset] fileSystemRepresentation], O_RDONLY);
+    if (fileDescriptor < 0) {
+        if (error) {
+            *error = AWSKinesisRecordLogPOSIXError();
+        }
+        return -1;
+    }
+    self.readFileDescriptor = fileDescriptor;
+    self.readSegmentBaseOffset = baseOffset;
+    return fileDescriptor;
+}
+
+#pragma mark - Checkpoint
+
+- (unsigned long long)readCheckpoint:(BOOL *)hasCheckpoint {
+    NSData *data = [NSData dataWithContentsOfFile:[self.directoryPath stringByAppendingPathComponent:AWSKinesisRecordLogCheckpointFileName]];
+    *hasCheckpoint = NO;
+    if ([data length] != 16) {
+        return 0;
+    }
+
+    const uint8_t *bytes = [data bytes];
+    if (AWSKinesisRecordLogGetUInt32(bytes + 12) != AWSKinesisRecordLogCheckpointMagic
+        || AWSKinesisRecordLogGetUInt32(bytes + 8) != AWSKinesisRecordLogCRC32(bytes, 8)) {
+        AWSDDLogError(@"The checkpoint of the log [%@] is corrupted.", self.directoryPath);
+        return 0;
+    }
+    *hasCheckpoint = YES;
+    return AWSKinesisRecordLogGetUInt64(bytes);
+}
+
+- (BOOL)writeCheckpoint:(unsigned long long)offset
+                  error:(NSError **)error {
+    NSMutableData *data = [NSMutableData dataWithCapacity:16];
+    AWSKinesisRecordLogAppendUInt64(data, offset);
+    AWSKinesisRecordLogAppendUInt32(data, AWSKinesisRecordLogCRC32([data bytes], 8));
+    AWSKinesisRecordLogAppendUInt32(data, AWSKinesisRecordLogCheckpointMagic);
+    return [data writeToFile:[self.directoryPath stringByAppendingPathComponent:AWSKinesisRecordLogCheckpointFileName]
+                     options:NSDataWritingAtomic
+                       error:error];
+}
+
+#pragma mark - Records
+
+- (BOOL)appendRecords:(NSArray<AWSKinesisRecordLogEntry *> *)records
+                error:(NSError **)error {
+    @synchronized(self) {
+        if (self.activeSegmentDamaged && ![self sealDamagedSegment:error]) {
+            return NO;
+        }
+
+        NSMutableData *frames = [NSMutableData new];
+        for (AWSKinesisRecordLogEntry *record in records) {
+            AWSKinesisRecordLogAppendFrame(frames, record);
+            if (self.endOffset - [self activeSegmentBaseOffset] + [frames length] >= self.segmentByteLimit) {
+                if (![self writeFrames:frames error:error]
+                    || ![self startSegmentAtEndOffset:error]) {
+                    return NO;
+                }
+                [frames setLength:0];
+            }
+        }
+        return [self writeFrames:frames error:error];
+    }
+}
+
+- (BOOL)writeFrames:(NSData *)frames
+              error:(NSError **)error {
+    const uint8_t *bytes = [frames bytes];
+    size_t remainingLength = [frames length];
+    while (remainingLength > 0) {
+        ssize_t writtenLength = write(self.writeFileDescriptor, bytes, remainingLength);
+        if (writtenLength < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (error) {
+                *error = AWSKinesisRecordLogPOSIXError();
+            }
+            // Removes the frames written so far, so that the segment ends with a whole record.
+            if (ftruncate(self.writeFileDescriptor, (off_t)(self.endOffset - [self activeSegmentBaseOffset])) != 0) {
+                AWSDDLogError(@"Failed to truncate the log [%@]. Starting a new segment. [%@]", self.directoryPath, AWSKinesisRecordLogPOSIXError());
+                self.activeSegmentDamaged = YES;
+                NSError *sealError = nil;
+                if (![self sealDamagedSegment:&sealError]) {
+                    AWSDDLogError(@"Failed to start a new segment of the log [%@]. [%@]", self.directoryPath, sealError);
+                }
+            }
+            return NO;
+        }
+        bytes += writtenLength;
+        remainingLength -= writtenLength;
+    }
+    self.endOffset += [frames length];
+    return YES;
+}
+
+- (NSArray<AWSKinesisRecordLogEntry *> *)readRecordsFromOffset:(unsigned long long)offset
+                                              recordCountLimit:(NSUInteger)recordCountLimit
+                                                     byteLimit:(NSUInteger)byteLimit
+                                                         error:(NSError **)error {
+    @synchronized(self) {
+        NSMutableArray<AWSKinesisRecordLogEntry *> *records = [NSMutableArray new];
+        unsigned long long position = MAX(offset, self.acknowledgedOffset);
+        NSUInteger byteCount = 0;
+
+        while (position < self.endOffset && [records count] < recordCountLimit) {
+            NSUInteger segmentIndex = [self.segmentBaseOffsets count] - 1;
+            while (segmentIndex > 0 && [self.segmentBaseOffsets[segmentIndex] unsignedLongLongValue] > position) {
+                segmentIndex--;
+            }
+            unsigned long long baseOffset = [self.segmentBaseOffsets[segmentIndex] unsignedLongLongValue];
+            int fileDescriptor = [self readFileDescriptorForSegmentBaseOffset:baseOffset error:error];
+            if (fileDescriptor < 0) {
+                return nil;
+            }
+
+            NSData *data = nil;
+            AWSKinesisRecordLogFrameStatus status = AWSKinesisRecordLogReadFrame(fileDescriptor, (off_t)(position - baseOffset), &data);
+            if (status == AWSKinesisRecordLogFrameStatusFailed) {
+                if (error) {
+                    *error = AWSKinesisRecordLogPOSIXError();
+                }
+                return nil;
+            }
+            AWSKinesisRecordLogEntry *record = status == AWSKinesisRecordLogFrameStatusValid ? AWSKinesisRecordLogDecodeRecord(data) : nil;
+            if (!record) {
+                // Skips the rest of the segment. The active segment ends where the next record will be appended.
+                BOOL activeSegment = segmentIndex + 1 >= [self.segmentBaseOffsets count];
+                unsigned long long segmentEndOffset = activeSegment ? self.endOffset : [self.segmentBaseOffsets[segmentIndex + 1] unsignedLongLongValue];
+                if (status != AWSKinesisRecordLogFrameStatusEnd || activeSegment) {
+                    AWSDDLogError(@"Skipping the corrupted records of the log [%@] from offset [%llu] to offset [%llu].", self.directoryPath, position, segmentEndOffset);
+                }
+                position = segmentEndOffset;
+                continue;
+            }
+
+            NSUInteger recordByteCount = [record.data length] + [record.partitionKey lengthOfBytesUsingEncoding:NSUTF8StringEncoding];
+            if (byteLimit > 0 && [records count] > 0 && byteCount + recordByteCount > byteLimit) {
+                break;
+            }
+            byteCount += recordByteCount;
+
+            record.offset = position;
+            position += AWSKinesisRecordLogFrameHeaderLength + [data length];
+            record.nextOffset = position;
+            [records addObject:record];
+        }
+
+        return records;
+    }
+}
+
+- (BOOL)acknowledgeToOffset:(unsigned long long)offset
+                      error:(NSError **)error {
+    @synchronized(self) {
+        offset = MIN(MAX(offset, self.acknowledgedOffset), self.endOffset);
+        if (offset == self.acknowledgedOffset) {
+            return YES;
+        }
+        if (![self writeCheckpoint:offset error:error]) {
+            return NO;
+        }
+        self.acknowledgedOffset = offset;
+
+        // When every record is acknowledged, starts a new segment so that the current one can be deleted too.
+        if (offset == self.endOffset
+            && self.endOffset > [self activeSegmentBaseOffset]
+            && ![self startSegmentAtEndOffset:error]) {
+            return NO;
+        }
+        [self deleteAcknowledgedSegments];
+        return YES;
+    }
+}
+
+- (BOOL)appendRecords:(NSArray<AWSKinesisRecordLogEntry *> *)records
+acknowledgingToOffset:(unsigned long long)offset
+                error:(NSError **)error {
+    @synchronized(self) {
+        NSMutableArray<AWSKinesisRecordLogEntry *> *pendingRecords = [NSMutableArray arrayWithCapacity:[records count]];
+        for (AWSKinesisRecordLogEntry *record in records) {
+            if (record.offset >= self.acknowledgedOffset) {
+                [pendingRecords addObject:record];
+            }
+        }
+        return [self appendRecords:pendingRecords error:error]
+            && [self acknowledgeToOffset:offset error:error];
+    }
+}
+
+- (BOOL)acknowledgeRecordsBeforeTimestamp:(NSTimeInterval)timestamp
+                           byteCountLimit:(NSUInteger)byteCountLimit
+                                    error:(NSError **)error {
+    @synchronized(self) {
+        unsigned long long offset = self.acknowledgedOffset;
+        while (offset < self.endOffset) {
+            NSArray<AWSKinesisRecordLogEntry *> *records = [self readRecordsFromOffset:offset
+                                                                      recordCountLimit:1
+                                                                             byteLimit:0
+                                                                                 error:error];
+            if (!records) {
+                return NO;
+            }
+
+            AWSKinesisRecordLogEntry *record = [records firstObject];
+            BOOL expired = timestamp > 0 && record.timestamp < timestamp;
+            BOOL exceeding = byteCountLimit > 0 && self.endOffset - record.offset > byteCountLimit;
+            if (!record || (!expired && !exceeding)) {
+                break;
+            }
+            offset = record.nextOffset;
+        }
+        return [self acknowledgeToOffset:offset error:error];
+    }
+}
+
+- (BOOL)removeAllRecords:(NSError **)error {
+    @synchronized(self) {
+        return [self acknowledgeToOffset:self.endOffset error:error];
+    }
+}
+
+@end
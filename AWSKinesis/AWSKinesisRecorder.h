@@ -43,6 +43,32 @@ FOUNDATION_EXPORT NSString *const AWSKinesisRecorderByteThresholdReachedNotifica
  */
 @interface AWSKinesisRecorder : AWSAbstractKinesisRecorder
 
+/**
+ Whether saved records are packed into aggregated records of the Kinesis Producer Library format, which the Kinesis Client Library de-aggregates transparently. The default is `NO`.
+
+ The records of a stream which have the same partition key, or which have no partition key, are packed together up to the 1MB limit of a Kinesis record. The records without a partition key share the partition key of their aggregated record. Consider raising `batchRecordsByteLimit`, so that a request can take several full aggregated records.
+ */
+@property (nonatomic, assign) BOOL aggregationEnabled;
+
+/**
+ When `aggregationEnabled` is `YES`, the maximum time in seconds a saved record waits in memory for more records to be aggregated with. The records are written earlier once they could fill an aggregated record. With `AWSKinesisRecorderSaveDurabilityCommitted`, the task returned by `saveRecord:streamName:` completes after this delay. The default value is 0.1 seconds.
+ */
+@property (nonatomic, assign) NSTimeInterval aggregationLingerInterval;
+
+/**
+ Whether the records are sent according to the shards of their stream, which are listed with `ListShards` and cached. The default is `NO`.
+
+ A record goes to the open shard whose hash key range contains the MD5 digest of its partition key. A request takes no more records for a shard than the shard accepts in a second, 1,000 records or 1MB, and leaves the other records for the next submission. When a shard throttles records, only that shard backs off, and its records are kept until it accepts records again; the other shards of the stream are not held back. The records of a stream whose shards cannot be listed are sent as if this property were `NO`. With `aggregationEnabled`, the records of the same shard are packed together.
+
+ The credentials need the `kinesis:ListShards` permission.
+ */
+@property (nonatomic, assign) BOOL shardMapEnabled;
+
+/**
+ When `shardMapEnabled` is `YES`, the time in seconds after which the shards of a stream are listed again. The shards are also listed again when a record is put to a shard which is not in the cached map, for example after the stream was resharded. The default value is 300 seconds.
+ */
+@property (nonatomic, assign) NSTimeInterval shardMapRefreshInterval;
+
 /**
  Returns a shared instance of this service client using `[AWSServiceManager defaultServiceManager].defaultServiceConfiguration`. When `defaultServiceConfiguration` is not set, this method returns nil.
 
@@ -129,6 +155,19 @@ FOUNDATION_EXPORT NSString *const AWSKinesisRecorderByteThresholdReachedNotifica
  */
 + (void)registerKinesisRecorderWithConfiguration:(AWSServiceConfiguration *)configuration forKey:(NSString *)key;
 
+/**
+ Creates a service client with the given service configuration and storage, and registers it for the key.
+
+ @warning After calling this method, do not modify the configuration object. It may cause unspecified behaviors.
+
+ @param configuration A service configuration object.
+ @param storage       How the service client stores the saved records.
+ @param key           A string to identify the service client.
+ */
++ (void)registerKinesisRecorderWithConfiguration:(AWSServiceConfiguration *)configuration
+                                         storage:(AWSKinesisRecorderStorage)storage
+                                          forKey:(NSString *)key;
+
 /**
  Retrieves the service client associated with the key. You need to call `+ registerKinesisWithConfiguration:forKey:` before invoking this method.
 
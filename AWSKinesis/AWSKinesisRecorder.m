@@ -15,6 +15,7 @@
 
 #import "AWSKinesisRecorder.h"
 #import "AWSKinesis.h"
+#import "AWSKinesisShardMap.h"
 
 // Constants
 NSString *const AWSKinesisRecorderErrorDomain = @"com.amazonaws.AWSKinesisRecorderErrorDomain";
@@ -23,6 +24,14 @@ NSString *const AWSKinesisRecorderByteThresholdReachedNotificationDiskBytesUsedK
 
 static NSString *const AWSInfoKinesisRecorder = @"KinesisRecorder";
 
+// What a shard accepts in a second.
+static NSUInteger const AWSKinesisRecorderShardRecordCountLimit = 1000;
+static NSUInteger const AWSKinesisRecorderShardByteLimit = 1024 * 1024; // 1MB
+
+static NSTimeInterval const AWSKinesisRecorderShardMapRefreshIntervalDefault = 300.0;
+static NSTimeInterval const AWSKinesisRecorderShardBackoffDelayMin = 1.0;
+static NSTimeInterval const AWSKinesisRecorderShardBackoffDelayMax = 60.0;
+
 // Legacy constants
 NSString *const AWSKinesisRecorderCacheName = @"com.amazonaws.AWSKinesisRecorderCacheName.Cache";
 
@@ -35,6 +44,14 @@ NSString *const AWSKinesisRecorderCacheName = @"com.amazonaws.AWSKinesisRecorder
 @interface AWSKinesisRecorderHelper : NSObject <AWSKinesisRecorderHelper>
 
 @property (nonatomic, strong) AWSKinesis *kinesis;
+@property (atomic, assign) BOOL shardMapEnabled;
+@property (atomic, assign) NSTimeInterval shardMapRefreshInterval;
+
+// Guarded by @synchronized(self).
+@property (nonatomic, strong) NSMutableDictionary<NSString *, AWSKinesisShardMap *> *shardMaps;
+@property (nonatomic, strong) NSMutableDictionary<NSString *, AWSTask<AWSKinesisShardMap *> *> *shardMapTasks;
+@property (nonatomic, strong) NSMutableDictionary<NSString *, NSNumber *> *shardBackoffDelays;
+@property (nonatomic, strong) NSMutableDictionary<NSString *, NSDate *> *shardBackoffDates;
 
 @end
 
@@ -44,7 +61,8 @@ NSString *const AWSKinesisRecorderCacheName = @"com.amazonaws.AWSKinesisRecorder
 
 - (instancetype)initWithConfiguration:(AWSServiceConfiguration *)configuration
                            identifier:(NSString *)identifier
-                            cacheName:(NSString *)cacheName;
+                            cacheName:(NSString *)cacheName
+                              storage:(AWSKinesisRecorderStorage)storage;
 
 + (NSString *) databasePathForKey:(NSString *)key;
 
@@ -58,6 +76,10 @@ NSString *const AWSKinesisRecorderCacheName = @"com.amazonaws.AWSKinesisRecorder
 
 @implementation AWSKinesisRecorder
 
+// The properties are implemented by `AWSAbstractKinesisRecorder`, where the records are saved.
+@dynamic aggregationEnabled;
+@dynamic aggregationLingerInterval;
+
 static AWSSynchronizedMutableDictionary *_serviceClients = nil;
 
 + (instancetype)defaultKinesisRecorder {
@@ -83,13 +105,22 @@ static AWSSynchronizedMutableDictionary *_serviceClients = nil;
 
         _defaultKinesisRecorder = [[AWSKinesisRecorder alloc] initWithConfiguration:serviceConfiguration
                                                                          identifier:@"Default"
-                                                                          cacheName:AWSKinesisRecorderCacheName];
+                                                                          cacheName:AWSKinesisRecorderCacheName
+                                                                            storage:AWSKinesisRecorderStorageDatabase];
     });
 
     return _defaultKinesisRecorder;
 }
 
 + (void)registerKinesisRecorderWithConfiguration:(AWSServiceConfiguration *)configuration forKey:(NSString *)key {
+    [self registerKinesisRecorderWithConfiguration:configuration
+                                           storage:AWSKinesisRecorderStorageDatabase
+                                            forKey:key];
+}
+
++ (void)registerKinesisRecorderWithConfiguration:(AWSServiceConfiguration *)configuration
+                                         storage:(AWSKinesisRecorderStorage)storage
+                                          forKey:(NSString *)key {
     static dispatch_once_t onceToken;
     dispatch_once(&onceToken, ^{
         _serviceClients = [AWSSynchronizedMutableDictionary new];
@@ -98,7 +129,8 @@ static AWSSynchronizedMutableDictionary *_serviceClients = nil;
     NSString *identifier = [AWSAbstractKinesisRecorder databasePathForKey:key];
     AWSKinesisRecorder *kinesisRecorder = [[AWSKinesisRecorder alloc] initWithConfiguration:configuration
                                                                                  identifier:identifier
-                                                                                  cacheName:[NSString stringWithFormat:@"%@.%@", AWSKinesisRecorderCacheName, key]];
+                                                                                  cacheName:[NSString stringWithFormat:@"%@.%@", AWSKinesisRecorderCacheName, key]
+                                                                                    storage:storage];
     [_serviceClients setObject:kinesisRecorder
                         forKey:key];
 }
@@ -135,15 +167,33 @@ static AWSSynchronizedMutableDictionary *_serviceClients = nil;
 
 - (instancetype)initWithConfiguration:(AWSServiceConfiguration *)configuration
                            identifier:(NSString *)identifier
-                            cacheName:(NSString *)cacheName {
+                            cacheName:(NSString *)cacheName
+                              storage:(AWSKinesisRecorderStorage)storage {
     if (self = [super initWithConfiguration:configuration
                                 identifier:identifier
-                                 cacheName:cacheName]) {
+                                 cacheName:cacheName
+                                   storage:storage]) {
         self.recorderHelper = [[AWSKinesisRecorderHelper alloc] initWithConfiguration:configuration];
     }
     return self;
 }
 
+- (BOOL)shardMapEnabled {
+    return ((AWSKinesisRecorderHelper *)self.recorderHelper).shardMapEnabled;
+}
+
+- (void)setShardMapEnabled:(BOOL)shardMapEnabled {
+    ((AWSKinesisRecorderHelper *)self.recorderHelper).shardMapEnabled = shardMapEnabled;
+}
+
+- (NSTimeInterval)shardMapRefreshInterval {
+    return ((AWSKinesisRecorderHelper *)self.recorderHelper).shardMapRefreshInterval;
+}
+
+- (void)setShardMapRefreshInterval:(NSTimeInterval)shardMapRefreshInterval {
+    ((AWSKinesisRecorderHelper *)self.recorderHelper).shardMapRefreshInterval = shardMapRefreshInterval;
+}
+
 @end
 
 @implementation AWSKinesisRecorderHelper
@@ -151,6 +201,11 @@ static AWSSynchronizedMutableDictionary *_serviceClients = nil;
 - (instancetype)initWithConfiguration:(AWSServiceConfiguration *)configuration {
     if (self = [super init]) {
         _kinesis = [[AWSKinesis alloc] initWithConfiguration:configuration];
+        _shardMapRefreshInterval = AWSKinesisRecorderShardMapRefreshIntervalDefault;
+        _shardMaps = [NSMutableDictionary new];
+        _shardMapTasks = [NSMutableDictionary new];
+        _shardBackoffDelays = [NSMutableDictionary new];
+        _shardBackoffDates = [NSMutableDictionary new];
     }
 
     return self;
@@ -160,17 +215,67 @@ static AWSSynchronizedMutableDictionary *_serviceClients = nil;
                             records:(NSArray *)temporaryRecords
                              rowIds:(NSArray *)rowIds
                           putRowIds:(NSMutableArray *)putRowIds
-                        retryRowIds:(NSMutableArray *)retryRowIds
-                               stop:(BOOL *)stop {
+                        retryRowIds:(NSMutableArray *)retryRowIds {
+    if (!self.shardMapEnabled) {
+        return [self putRecords:temporaryRecords
+                     streamName:streamName
+                         rowIds:rowIds
+                      putRowIds:putRowIds
+                    retryRowIds:retryRowIds
+                       shardMap:nil];
+    }
+
+    return [[self shardMapForStream:streamName] continueWithSuccessBlock:^id(AWSTask<AWSKinesisShardMap *> *task) {
+        return [self putRecords:temporaryRecords
+                     streamName:streamName
+                         rowIds:rowIds
+                      putRowIds:putRowIds
+                    retryRowIds:retryRowIds
+                       shardMap:task.result];
+    }];
+}
+
+// Puts the records. With a shard map, the records of a shard which is backing off, or past what a shard accepts in a second,
+// are left out, and they are neither put nor retried, so that they are kept for a later submission.
+- (AWSTask *)putRecords:(NSArray *)temporaryRecords
+             streamName:(NSString *)streamName
+                 rowIds:(NSArray *)rowIds
+              putRowIds:(NSMutableArray *)putRowIds
+            retryRowIds:(NSMutableArray *)retryRowIds
+               shardMap:(AWSKinesisShardMap *)shardMap {
     NSMutableArray *records = [NSMutableArray new];
+    NSMutableArray *sentRowIds = [NSMutableArray new];
+    NSMutableArray *sentShardIds = [NSMutableArray new];
+    NSMutableDictionary<NSString *, NSNumber *> *shardRecordCounts = [NSMutableDictionary new];
+    NSMutableDictionary<NSString *, NSNumber *> *shardByteCounts = [NSMutableDictionary new];
 
-    for (NSDictionary *recordDictionary in temporaryRecords) {
+    for (NSUInteger i = 0; i < [temporaryRecords count]; i++) {
+        NSDictionary *recordDictionary = temporaryRecords[i];
         AWSKinesisPutRecordsRequestEntry *requestEntry = [AWSKinesisPutRecordsRequestEntry new];
         requestEntry.partitionKey = recordDictionary[@"partition_key"];
         requestEntry.data = recordDictionary[@"data"];
         streamName = recordDictionary[@"stream_name"];
 
+        NSString *shardId = shardMap.shardCount > 0 ? [shardMap shardIdForPartitionKey:requestEntry.partitionKey] : nil;
+        if (shardId) {
+            NSUInteger shardRecordCount = [shardRecordCounts[shardId] unsignedIntegerValue];
+            NSUInteger shardByteCount = [shardByteCounts[shardId] unsignedIntegerValue] + [requestEntry.data length] + [requestEntry.partitionKey lengthOfBytesUsingEncoding:NSUTF8StringEncoding];
+            if ([self isShardBackingOff:shardId streamName:streamName]
+                || shardRecordCount >= AWSKinesisRecorderShardRecordCountLimit
+                || (shardRecordCount > 0 && shardByteCount > AWSKinesisRecorderShardByteLimit)) {
+                continue;
+            }
+            shardRecordCounts[shardId] = @(shardRecordCount + 1);
+            shardByteCounts[shardId] = @(shardByteCount);
+        }
+
         [records addObject:requestEntry];
+        [sentRowIds addObject:rowIds[i]];
+        [sentShardIds addObject:shardId ?: [NSNull null]];
+    }
+
+    if ([records count] == 0) {
+        return [AWSTask taskWithResult:nil];
     }
 
     AWSKinesisPutRecordsInput *putRecordsInput = [AWSKinesisPutRecordsInput new];
@@ -180,34 +285,174 @@ static AWSSynchronizedMutableDictionary *_serviceClients = nil;
     return [[self.kinesis putRecords:putRecordsInput] continueWithBlock:^id(AWSTask *task) {
         if (task.error) {
             AWSDDLogError(@"Error: [%@]", task.error);
-            if ([task.error.domain isEqualToString:NSURLErrorDomain]) {
-                *stop = YES;
-            }
-
             return [AWSTask taskWithError:task.error];
         }
         if (task.result) {
             AWSKinesisPutRecordsOutput *putRecordsOutput = task.result;
+            NSMutableSet<NSString *> *acceptingShardIds = [NSMutableSet new];
+            NSMutableSet<NSString *> *throttledShardIds = [NSMutableSet new];
 
             for (int i = 0; i < [putRecordsOutput.records count]; i++) {
                 AWSKinesisPutRecordsResultEntry *resultEntry = putRecordsOutput.records[i];
+                NSString *shardId = sentShardIds[i] != [NSNull null] ? sentShardIds[i] : nil;
                 if (resultEntry.errorCode) {
                     AWSDDLogInfo(@"Error Code: [%@] Error Message: [%@]", resultEntry.errorCode, resultEntry.errorMessage);
                 }
+                if (shardId && [resultEntry.errorCode isEqualToString:@"ProvisionedThroughputExceededException"]) {
+                    // Only the shard backs off. The record is kept, without counting as a retry of the stream.
+                    [throttledShardIds addObject:shardId];
+                    continue;
+                }
                 // When the error code is ProvisionedThroughputExceededException or InternalFailure,
                 // we should retry. So, don't delete the row from the database.
                 if (![resultEntry.errorCode isEqualToString:@"ProvisionedThroughputExceededException"]
                     && ![resultEntry.errorCode isEqualToString:@"InternalFailure"]) {
-                    [putRowIds addObject:rowIds[i]];
+                    [putRowIds addObject:sentRowIds[i]];
                 } else {
-                    [retryRowIds addObject:rowIds[i]];
+                    [retryRowIds addObject:sentRowIds[i]];
+                }
+                if (shardId && !resultEntry.errorCode) {
+                    [acceptingShardIds addObject:shardId];
+                }
+                if (shardMap.shardCount > 0 && resultEntry.shardId && ![shardMap containsShardId:resultEntry.shardId]) {
+                    // The stream was resharded.
+                    [self invalidateShardMap:shardMap streamName:streamName];
                 }
             }
+
+            for (NSString *shardId in throttledShardIds) {
+                [self updateBackoffOfShard:shardId streamName:streamName throttled:YES];
+            }
+            [acceptingShardIds minusSet:throttledShardIds];
+            for (NSString *shardId in acceptingShardIds) {
+                [self updateBackoffOfShard:shardId streamName:streamName throttled:NO];
+            }
         }
         return nil;
     }];
 }
 
+// Returns the shard map of the stream, listing the shards when the cached map is older than `shardMapRefreshInterval`.
+// When the shards cannot be listed, the stream gets an empty map until the next refresh.
+- (AWSTask<AWSKinesisShardMap *> *)shardMapForStream:(NSString *)streamName {
+    @synchronized(self) {
+        AWSKinesisShardMap *shardMap = self.shardMaps[streamName];
+        if (shardMap && -[shardMap.date timeIntervalSinceNow] < self.shardMapRefreshInterval) {
+            return [AWSTask taskWithResult:shardMap];
+        }
+
+        AWSTask<AWSKinesisShardMap *> *task = self.shardMapTasks[streamName];
+        if (task) {
+            return task;
+        }
+
+        task = [[self listShardsOfStream:streamName
+                                  shards:[NSMutableArray new]
+                               nextToken:nil] continueWithBlock:^id(AWSTask<NSArray<AWSKinesisShard *> *> *task) {
+            if (task.error) {
+                AWSDDLogError(@"Failed to list the shards of %@: [%@]", streamName, task.error);
+            }
+            AWSKinesisShardMap *shardMap = [[AWSKinesisShardMap alloc] initWithShards:task.result ?: @[]];
+            @synchronized(self) {
+                self.shardMaps[streamName] = shardMap;
+                [self.shardMapTasks removeObjectForKey:streamName];
+            }
+            return shardMap;
+        }];
+        if (!task.completed) {
+            self.shardMapTasks[streamName] = task;
+        }
+        return task;
+    }
+}
+
+- (AWSTask<NSArray<AWSKinesisShard *> *> *)listShardsOfStream:(NSString *)streamName
+                                                       shards:(NSMutableArray<AWSKinesisShard *> *)shards
+                                                    nextToken:(NSString *)nextToken {
+    AWSKinesisListShardsInput *listShardsInput = [AWSKinesisListShardsInput new];
+    // The stream name cannot be set with a next token.
+    if (nextToken) {
+        listShardsInput.nextToken = nextToken;
+    } else {
+        listShardsInput.streamName = streamName;
+    }
+    return [[self.kinesis listShards:listShardsInput] continueWithSuccessBlock:^id(AWSTask<AWSKinesisListShardsOutput *> *task) {
+        [shards addObjectsFromArray:task.result.shards ?: @[]];
+        if (task.result.nextToken) {
+            return [self listShardsOfStream:streamName
+                                     shards:shards
+                                  nextToken:task.result.nextToken];
+        }
+        return shards;
+    }];
+}
+
+- (void)invalidateShardMap:(AWSKinesisShardMap *)shardMap
+                streamName:(NSString *)streamName {
+    @synchronized(self) {
+        if (self.shardMaps[streamName] == shardMap) {
+            [self.shardMaps removeObjectForKey:streamName];
+        }
+    }
+}
+
+- (NSString *)cachedShardIdForStream:(NSString *)streamName
+                        partitionKey:(NSString *)partitionKey {
+    if (!self.shardMapEnabled) {
+        return nil;
+    }
+    AWSKinesisShardMap *shardMap = nil;
+    @synchronized(self) {
+        shardMap = self.shardMaps[streamName];
+    }
+    if (!shardMap) {
+        // Lists the shards for the records saved next.
+        [self shardMapForStream:streamName];
+        return nil;
+    }
+    return [shardMap shardIdForPartitionKey:partitionKey];
+}
+
+- (BOOL)isShardBackingOff:(NSString *)shardId
+               streamName:(NSString *)streamName {
+    NSString *key = [NSString stringWithFormat:@"%@/%@", streamName, shardId];
+    @synchronized(self) {
+        NSDate *backoffDate = self.shardBackoffDates[key];
+        return backoffDate && [backoffDate timeIntervalSinceNow] > 0;
+    }
+}
+
+// A throttled shard backs off for a delay which doubles from 1 second up to 60 seconds. The backoff ends when the shard accepts a record.
+- (void)updateBackoffOfShard:(NSString *)shardId
+                  streamName:(NSString *)streamName
+                   throttled:(BOOL)throttled {
+    NSString *key = [NSString stringWithFormat:@"%@/%@", streamName, shardId];
+    @synchronized(self) {
+        if (!throttled) {
+            [self.shardBackoffDelays removeObjectForKey:key];
+            [self.shardBackoffDates removeObjectForKey:key];
+            return;
+        }
+        if (self.shardBackoffDates[key] && [self.shardBackoffDates[key] timeIntervalSinceNow] > 0) {
+            // A concurrent request was throttled by the same shard.
+            return;
+        }
+        NSNumber *delay = self.shardBackoffDelays[key];
+        NSTimeInterval backoffDelay = delay ? MIN([delay doubleValue] * 2, AWSKinesisRecorderShardBackoffDelayMax) : AWSKinesisRecorderShardBackoffDelayMin;
+        self.shardBackoffDelays[key] = @(backoffDelay);
+        self.shardBackoffDates[key] = [NSDate dateWithTimeIntervalSinceNow:backoffDelay];
+    }
+}
+
+// The limits of a PutRecords request.
+- (NSUInteger)batchRecordCountLimit {
+    return 500;
+}
+
+- (NSUInteger)batchByteLimit {
+    return 5 * 1024 * 1024; // 5MB
+}
+
 - (NSError *)dataTooLargeError {
     return [NSError errorWithDomain:AWSKinesisRecorderErrorDomain
                                code:AWSKinesisRecorderErrorDataTooLarge
@@ -0,0 +1,56 @@
+//
+// Copyright 2010-2021 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License.
+// A copy of the License is located at
+//
+// http://aws.amazon.com/apache2.0
+//
+// or in the "license" file accompanying this file. This file is distributed
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+//
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+@class AWSKinesisShard;
+
+/**
+ The open shards of a stream and their hash key ranges, as listed by `ListShards`.
+
+ Kinesis puts a record to the shard whose hash key range contains the MD5 digest of its partition key, read as a 128-bit integer.
+ */
+@interface AWSKinesisShardMap : NSObject
+
+/**
+ When the shards were listed.
+ */
+@property (nonatomic, strong, readonly) NSDate *date;
+
+/**
+ The number of open shards.
+ */
+@property (nonatomic, assign, readonly) NSUInteger shardCount;
+
+/**
+ Creates a map of the shards which are open. The closed shards, which have an ending sequence number, and the shards with an invalid hash key range are left out.
+ */
+- (instancetype)initWithShards:(NSArray<AWSKinesisShard *> *)shards;
+
+/**
+ The shard of a record with the partition key, or `nil` if no open shard has its hash key.
+ */
+- (nullable NSString *)shardIdForPartitionKey:(NSString *)partitionKey;
+
+/**
+ Whether the shard is an open shard of the map.
+ */
+- (BOOL)containsShardId:(NSString *)shardId;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,167 @@
+//
+// Copyright 2010-2021 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License.
+// A copy of the License is located at
+//
+// http://aws.amazon.com/apache2.0
+//
+// or in the "license" file accompanying this file. This file is distributed
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+//
+
+#import "AWSKinesisShardMap.h"
+#import <CommonCrypto/CommonDigest.h>
+#import "AWSKinesisModel.h"
+
+// A 128-bit hash key. `__int128` is not available on 32-bit devices.
+typedef struct {
+    uint64_t high;
+    uint64_t low;
+} AWSKinesisHashKey;
+
+static NSComparisonResult AWSKinesisHashKeyCompare(AWSKinesisHashKey a, AWSKinesisHashKey b) {
+    if (a.high != b.high) {
+        return a.high < b.high ? NSOrderedAscending : NSOrderedDescending;
+    }
+    if (a.low != b.low) {
+        return a.low < b.low ? NSOrderedAscending : NSOrderedDescending;
+    }
+    return NSOrderedSame;
+}
+
+// Parses a decimal hash key. Fails on anything but digits, and on values past 2^128 - 1.
+static BOOL AWSKinesisHashKeyParse(NSString *string, AWSKinesisHashKey *hashKey) {
+    if ([string length] == 0) {
+        return NO;
+    }
+
+    AWSKinesisHashKey value = {0, 0};
+    for (NSUInteger i = 0; i < [string length]; i++) {
+        unichar character = [string characterAtIndex:i];
+        if (character < '0' || character > '9') {
+            return NO;
+        }
+
+        // value = value * 10 + digit, in 32-bit parts so that the carries fit in 64 bits.
+        uint64_t parts[4] = {value.low & 0xFFFFFFFF, value.low >> 32, value.high & 0xFFFFFFFF, value.high >> 32};
+        uint64_t carry = character - '0';
+        for (int part = 0; part < 4; part++) {
+            uint64_t product = parts[part] * 10 + carry;
+            parts[part] = product & 0xFFFFFFFF;
+            carry = product >> 32;
+        }
+        if (carry > 0) {
+            return NO;
+        }
+        value.low = parts[0] | (parts[1] << 32);
+        value.high = parts[2] | (parts[3] << 32);
+    }
+
+    *hashKey = value;
+    return YES;
+}
+
+static AWSKinesisHashKey AWSKinesisHashKeyForPartitionKey(NSString *partitionKey) {
+    NSData *data = [partitionKey dataUsingEncoding:NSUTF8StringEncoding];
+    unsigned char digest[CC_MD5_DIGEST_LENGTH];
+    CC_MD5([data bytes], (CC_LONG)[data length], digest);
+
+    AWSKinesisHashKey hashKey = {0, 0};
+    for (int i = 0; i < 8; i++) {
+        hashKey.high = (hashKey.high << 8) | digest[i];
+        hashKey.low = (hashKey.low << 8) | digest[i + 8];
+    }
+    return hashKey;
+}
+
+@interface AWSKinesisShardMap()
+
+@property (nonatomic, strong) NSDate *date;
+@property (nonatomic, strong) NSArray<NSString *> *shardIds;
+@property (nonatomic, strong) NSData *hashKeyRanges;
+
+@end
+
+@implementation AWSKinesisShardMap
+
+- (instancetype)initWithShards:(NSArray<AWSKinesisShard *> *)shards {
+    if (self = [super init]) {
+        _date = [NSDate date];
+
+        NSMutableArray<NSArray *> *ranges = [NSMutableArray new];
+        for (AWSKinesisShard *shard in shards) {
+            AWSKinesisHashKey startingHashKey;
+            AWSKinesisHashKey endingHashKey;
+            if (!shard.shardId
+                || shard.sequenceNumberRange.endingSequenceNumber
+                || !AWSKinesisHashKeyParse(shard.hashKeyRange.startingHashKey, &startingHashKey)
+                || !AWSKinesisHashKeyParse(shard.hashKeyRange.endingHashKey, &endingHashKey)
+                || AWSKinesisHashKeyCompare(startingHashKey, endingHashKey) == NSOrderedDescending) {
+                continue;
+            }
+            [ranges addObject:@[[NSValue valueWithBytes:&startingHashKey objCType:@encode(AWSKinesisHashKey)],
+                                [NSValue valueWithBytes:&endingHashKey objCType:@encode(AWSKinesisHashKey)],
+                                shard.shardId]];
+        }
+
+        // The open shards cover the hash key space without overlapping, so sorting them by their starting hash keys sorts their ranges.
+        [ranges sortUsingComparator:^NSComparisonResult(NSArray *a, NSArray *b) {
+            AWSKinesisHashKey aStartingHashKey;
+            AWSKinesisHashKey bStartingHashKey;
+            [a[0] getValue:&aStartingHashKey];
+            [b[0] getValue:&bStartingHashKey];
+            return AWSKinesisHashKeyCompare(aStartingHashKey, bStartingHashKey);
+        }];
+
+        NSMutableArray<NSString *> *shardIds = [NSMutableArray arrayWithCapacity:[ranges count]];
+        NSMutableData *hashKeyRanges = [NSMutableData dataWithCapacity:[ranges count] * 2 * sizeof(AWSKinesisHashKey)];
+        for (NSArray *range in ranges) {
+            AWSKinesisHashKey hashKeys[2];
+            [range[0] getValue:&hashKeys[0]];
+            [range[1] getValue:&hashKeys[1]];
+            [hashKeyRanges appendBytes:hashKeys length:sizeof(hashKeys)];
+            [shardIds addObject:range[2]];
+        }
+        _shardIds = shardIds;
+        _hashKeyRanges = hashKeyRanges;
+    }
+    return self;
+}
+
+- (NSUInteger)shardCount {
+    return [self.shardIds count];
+}
+
+- (NSString *)shardIdForHashKey:(AWSKinesisHashKey)hashKey {
+    const AWSKinesisHashKey *hashKeyRanges = [self.hashKeyRanges bytes];
+
+    // Finds the last shard which starts at or before the hash key.
+    NSUInteger lower = 0;
+    NSUInteger upper = [self.shardIds count];
+    while (lower < upper) {
+        NSUInteger middle = lower + (upper - lower) / 2;
+        if (AWSKinesisHashKeyCompare(hashKeyRanges[middle * 2], hashKey) == NSOrderedDescending) {
+            upper = middle;
+        } else {
+            lower = middle + 1;
+        }
+    }
+    if (lower == 0 || AWSKinesisHashKeyCompare(hashKey, hashKeyRanges[(lower - 1) * 2 + 1]) == NSOrderedDescending) {
+        return nil;
+    }
+    return self.shardIds[lower - 1];
+}
+
+- (NSString *)shardIdForPartitionKey:(NSString *)partitionKey {
+    return [self shardIdForHashKey:AWSKinesisHashKeyForPartitionKey(partitionKey)];
+}
+
+- (BOOL)containsShardId:(NSString *)shardId {
+    return [self.shardIds containsObject:shardId];
+}
+
+@end
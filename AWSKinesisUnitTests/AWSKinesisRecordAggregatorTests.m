@@ -0,0 +1,135 @@
+//
+// Copyright 2010-2021 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License.
+// A copy of the License is located at
+//
+// http://aws.amazon.com/apache2.0
+//
+// or in the "license" file accompanying this file. This file is distributed
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+//
+
+#import <XCTest/XCTest.h>
+#import <CommonCrypto/CommonDigest.h>
+#import "AWSKinesisRecordAggregator.h"
+
+// Reads a varint of the message, as a protobuf decoder would.
+static uint64_t AWSKinesisRecordAggregatorTestsReadVarint(const uint8_t *bytes, NSUInteger length, NSUInteger *position) {
+    uint64_t value = 0;
+    for (int shift = 0; *position < length; shift += 7) {
+        uint8_t byte = bytes[(*position)++];
+        value |= (uint64_t)(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) {
+            break;
+        }
+    }
+    return value;
+}
+
+@interface AWSKinesisRecordAggregatorTests : XCTestCase
+
+@end
+
+@implementation AWSKinesisRecordAggregatorTests
+
+// De-aggregates the records the way the Kinesis Client Library does, checking the magic bytes and the MD5 digest.
+// Returns the partition key and the data of each record.
+- (NSArray<NSArray *> *)recordsWithAggregatedData:(NSData *)aggregatedData {
+    XCTAssertGreaterThan([aggregatedData length], sizeof(AWSKinesisRecordAggregatorMagic) + CC_MD5_DIGEST_LENGTH);
+    XCTAssertEqual(memcmp([aggregatedData bytes], AWSKinesisRecordAggregatorMagic, sizeof(AWSKinesisRecordAggregatorMagic)), 0);
+
+    NSData *message = [aggregatedData subdataWithRange:NSMakeRange(sizeof(AWSKinesisRecordAggregatorMagic), [aggregatedData length] - sizeof(AWSKinesisRecordAggregatorMagic) - CC_MD5_DIGEST_LENGTH)];
+    unsigned char digest[CC_MD5_DIGEST_LENGTH];
+    CC_MD5([message bytes], (CC_LONG)[message length], digest);
+    XCTAssertEqual(memcmp((const uint8_t *)[aggregatedData bytes] + [aggregatedData length] - CC_MD5_DIGEST_LENGTH, digest, CC_MD5_DIGEST_LENGTH), 0);
+
+    const uint8_t *bytes = [message bytes];
+    NSUInteger position = 0;
+    NSMutableArray<NSString *> *partitionKeys = [NSMutableArray new];
+    NSMutableArray<NSArray *> *records = [NSMutableArray new];
+    while (position < [message length]) {
+        uint64_t tag = AWSKinesisRecordAggregatorTestsReadVarint(bytes, [message length], &position);
+        uint64_t fieldLength = AWSKinesisRecordAggregatorTestsReadVarint(bytes, [message length], &position);
+        XCTAssertEqual(tag & 0x7, 2);
+        NSData *field = [message subdataWithRange:NSMakeRange(position, (NSUInteger)fieldLength)];
+        position += (NSUInteger)fieldLength;
+
+        if (tag >> 3 == 1) {
+            [partitionKeys addObject:[[NSString alloc] initWithData:field encoding:NSUTF8StringEncoding]];
+        } else if (tag >> 3 == 3) {
+            const uint8_t *recordBytes = [field bytes];
+            NSUInteger recordPosition = 0;
+            uint64_t partitionKeyIndex = 0;
+            NSData *data = nil;
+            while (recordPosition < [field length]) {
+                uint64_t recordTag = AWSKinesisRecordAggregatorTestsReadVarint(recordBytes, [field length], &recordPosition);
+                if (recordTag == ((1 << 3) | 0)) {
+                    partitionKeyIndex = AWSKinesisRecordAggregatorTestsReadVarint(recordBytes, [field length], &recordPosition);
+                } else if (recordTag == ((3 << 3) | 2)) {
+                    uint64_t dataLength = AWSKinesisRecordAggregatorTestsReadVarint(recordBytes, [field length], &recordPosition);
+                    data = [field subdataWithRange:NSMakeRange(recordPosition, (NSUInteger)dataLength)];
+                    recordPosition += (NSUInteger)dataLength;
+                } else {
+                    XCTFail(@"Unexpected field %llu.", recordTag);
+                    return nil;
+                }
+            }
+            XCTAssertLessThan(partitionKeyIndex, [partitionKeys count]);
+            [records addObject:@[partitionKeys[(NSUInteger)partitionKeyIndex], data]];
+        } else {
+            XCTFail(@"Unexpected field %llu.", tag);
+            return nil;
+        }
+    }
+    return records;
+}
+
+- (void)testAggregatedDataIsDeaggregated {
+    AWSKinesisRecordAggregator *aggregator = [AWSKinesisRecordAggregator new];
+    XCTAssertNil(aggregator.partitionKey);
+    for (NSUInteger i = 0; i < 300; i++) {
+        // Records longer than 127 bytes take two bytes for their length.
+        NSData *data = [[NSString stringWithFormat:@"record-%lu-%@", (unsigned long)i, [@"" stringByPaddingToLength:i withString:@"x" startingAtIndex:0]] dataUsingEncoding:NSUTF8StringEncoding];
+        NSString *partitionKey = [NSString stringWithFormat:@"partition-key-%lu", (unsigned long)(i % 3)];
+        XCTAssertTrue([aggregator canAddRecordWithData:data partitionKey:partitionKey]);
+        [aggregator addRecordWithData:data partitionKey:partitionKey];
+    }
+    XCTAssertEqual(aggregator.recordCount, 300);
+    XCTAssertEqualObjects(aggregator.partitionKey, @"partition-key-0");
+
+    NSData *aggregatedData = [aggregator aggregatedData];
+    XCTAssertEqual([aggregatedData length], aggregator.byteCount);
+
+    NSArray<NSArray *> *records = [self recordsWithAggregatedData:aggregatedData];
+    XCTAssertEqual([records count], 300);
+    for (NSUInteger i = 0; i < [records count]; i++) {
+        XCTAssertEqualObjects(records[i][0], ([NSString stringWithFormat:@"partition-key-%lu", (unsigned long)(i % 3)]));
+        XCTAssertTrue([[[NSString alloc] initWithData:records[i][1] encoding:NSUTF8StringEncoding] hasPrefix:([NSString stringWithFormat:@"record-%lu-", (unsigned long)i])]);
+    }
+}
+
+- (void)testSingleRecordIsNotAggregated {
+    NSData *data = [@"record" dataUsingEncoding:NSUTF8StringEncoding];
+    AWSKinesisRecordAggregator *aggregator = [AWSKinesisRecordAggregator new];
+    [aggregator addRecordWithData:data partitionKey:@"partition-key"];
+    XCTAssertEqualObjects([aggregator aggregatedData], data);
+}
+
+- (void)testAggregatedRecordByteLimit {
+    NSData *data = [NSMutableData dataWithLength:100 * 1024];
+    AWSKinesisRecordAggregator *aggregator = [AWSKinesisRecordAggregator new];
+    while ([aggregator canAddRecordWithData:data partitionKey:@"partition-key"]) {
+        [aggregator addRecordWithData:data partitionKey:@"partition-key"];
+    }
+    XCTAssertEqual(aggregator.recordCount, 10);
+
+    NSData *aggregatedData = [aggregator aggregatedData];
+    XCTAssertLessThanOrEqual([aggregatedData length] + [@"partition-key" length], AWSKinesisRecordAggregatorByteLimit);
+    XCTAssertEqual([[self recordsWithAggregatedData:aggregatedData] count], 10);
+}
+
+@end
@@ -0,0 +1,338 @@
+//
+// Copyright 2010-2021 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License.
+// A copy of the License is located at
+//
+// http://aws.amazon.com/apache2.0
+//
+// or in the "license" file accompanying this file. This file is distributed
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+//
+
+#import <XCTest/XCTest.h>
+#import <AWSCore/AWSCore.h>
+#import "AWSKinesisRecordLog.h"
+
+// The number of records saved and submitted by the benchmarks.
+static const NSUInteger AWSKinesisRecordLogTestsIterations = 10000;
+
+// The number of records saved together and submitted together by the benchmarks, as the recorders do.
+static const NSUInteger AWSKinesisRecordLogTestsSaveBatchRecordCount = 500;
+static const NSUInteger AWSKinesisRecordLogTestsSubmitBatchRecordCount = 128;
+
+@interface AWSKinesisRecordLogTests : XCTestCase
+
+@property (nonatomic, strong) NSString *directoryPath;
+
+@end
+
+@implementation AWSKinesisRecordLogTests
+
+- (void)setUp {
+    [super setUp];
+    self.directoryPath = [NSTemporaryDirectory() stringByAppendingPathComponent:[[NSUUID UUID] UUIDString]];
+}
+
+- (void)tearDown {
+    [[NSFileManager defaultManager] removeItemAtPath:self.directoryPath error:nil];
+    [super tearDown];
+}
+
+- (AWSKinesisRecordLog *)openRecordLogWithSegmentByteLimit:(NSUInteger)segmentByteLimit {
+    NSError *error = nil;
+    AWSKinesisRecordLog *recordLog = [[AWSKinesisRecordLog alloc] initWithDirectoryPath:self.directoryPath
+                                                                       segmentByteLimit:segmentByteLimit
+                                                                                  error:&error];
+    XCTAssertNotNil(recordLog);
+    XCTAssertNil(error);
+    return recordLog;
+}
+
+- (NSArray<AWSKinesisRecordLogEntry *> *)recordsWithCount:(NSUInteger)count dataLength:(NSUInteger)dataLength {
+    NSMutableArray<AWSKinesisRecordLogEntry *> *records = [NSMutableArray arrayWithCapacity:count];
+    for (NSUInteger i = 0; i < count; i++) {
+        AWSKinesisRecordLogEntry *record = [AWSKinesisRecordLogEntry new];
+        record.partitionKey = [NSString stringWithFormat:@"partition-key-%lu", (unsigned long)i];
+        record.streamName = i % 2 == 0 ? @"stream-even" : @"stream-odd";
+        record.data = [NSMutableData dataWithLength:dataLength];
+        record.timestamp = 1000 + i;
+        [records addObject:record];
+    }
+    return records;
+}
+
+- (NSArray<AWSKinesisRecordLogEntry *> *)readAllRecords:(AWSKinesisRecordLog *)recordLog {
+    NSError *error = nil;
+    NSArray<AWSKinesisRecordLogEntry *> *records = [recordLog readRecordsFromOffset:recordLog.acknowledgedOffset
+                                                                   recordCountLimit:NSUIntegerMax
+                                                                          byteLimit:0
+                                                                              error:&error];
+    XCTAssertNil(error);
+    return records;
+}
+
+- (NSArray<NSString *> *)segmentFileNames {
+    NSArray<NSString *> *fileNames = [[NSFileManager defaultManager] contentsOfDirectoryAtPath:self.directoryPath error:nil];
+    return [[fileNames filteredArrayUsingPredicate:[NSPredicate predicateWithFormat:@"pathExtension == 'segment'"]]
+            sortedArrayUsingSelector:@selector(compare:)];
+}
+
+- (void)testAppendAndReadRecords {
+    AWSKinesisRecordLog *recordLog = [self openRecordLogWithSegmentByteLimit:AWSKinesisRecordLogSegmentByteLimitDefault];
+    XCTAssertEqual(recordLog.byteCount, 0);
+    XCTAssertEqual([[self readAllRecords:recordLog] count], 0);
+
+    XCTAssertTrue([recordLog appendRecords:[self recordsWithCount:10 dataLength:100] error:nil]);
+    XCTAssertEqual(recordLog.endOffset, recordLog.byteCount);
+
+    NSArray<AWSKinesisRecordLogEntry *> *records = [self readAllRecords:recordLog];
+    XCTAssertEqual([records count], 10);
+    XCTAssertEqualObjects(records[3].partitionKey, @"partition-key-3");
+    XCTAssertEqualObjects(records[3].streamName, @"stream-odd");
+    XCTAssertEqual([records[3].data length], 100);
+    XCTAssertEqual(records[3].timestamp, 1003);
+    XCTAssertEqual(records[3].retryCount, 0);
+    XCTAssertEqual(records[0].offset, 0);
+    XCTAssertEqual(records[4].offset, records[3].nextOffset);
+    XCTAssertEqual([records lastObject].nextOffset, recordLog.endOffset);
+
+    NSArray<AWSKinesisRecordLogEntry *> *limitedRecords = [recordLog readRecordsFromOffset:records[2].offset
+                                                                          recordCountLimit:5
+                                                                                 byteLimit:0
+                                                                                     error:nil];
+    XCTAssertEqual([limitedRecords count], 5);
+    XCTAssertEqualObjects(limitedRecords[0].partitionKey, @"partition-key-2");
+
+    // Stops before the record which would take the data and the partition keys past the limit.
+    limitedRecords = [recordLog readRecordsFromOffset:0 recordCountLimit:10 byteLimit:350 error:nil];
+    XCTAssertEqual([limitedRecords count], 3);
+    limitedRecords = [recordLog readRecordsFromOffset:0 recordCountLimit:10 byteLimit:1 error:nil];
+    XCTAssertEqual([limitedRecords count], 1);
+}
+
+- (void)testAcknowledgeDeletesSegments {
+    AWSKinesisRecordLog *recordLog = [self openRecordLogWithSegmentByteLimit:4096];
+    XCTAssertTrue([recordLog appendRecords:[self recordsWithCount:100 dataLength:1000] error:nil]);
+    NSUInteger segmentCount = [[self segmentFileNames] count];
+    XCTAssertGreaterThan(segmentCount, 20);
+
+    NSArray<AWSKinesisRecordLogEntry *> *records = [self readAllRecords:recordLog];
+    XCTAssertTrue([recordLog acknowledgeToOffset:records[50].offset error:nil]);
+    XCTAssertLessThan([[self segmentFileNames] count], segmentCount);
+    XCTAssertEqual(recordLog.byteCount, recordLog.endOffset - records[50].offset);
+
+    // The checkpoint is kept when the log is opened again.
+    [recordLog close];
+    recordLog = [self openRecordLogWithSegmentByteLimit:4096];
+    XCTAssertEqual(recordLog.acknowledgedOffset, records[50].offset);
+    NSArray<AWSKinesisRecordLogEntry *> *remainingRecords = [self readAllRecords:recordLog];
+    XCTAssertEqual([remainingRecords count], 50);
+    XCTAssertEqualObjects(remainingRecords[0].partitionKey, @"partition-key-50");
+
+    // Acknowledging every record leaves a single empty segment.
+    XCTAssertTrue([recordLog removeAllRecords:nil]);
+    XCTAssertEqual(recordLog.byteCount, 0);
+    NSArray<NSString *> *segmentFileNames = [self segmentFileNames];
+    XCTAssertEqual([segmentFileNames count], 1);
+    NSDictionary *attributes = [[NSFileManager defaultManager] attributesOfItemAtPath:[self.directoryPath stringByAppendingPathComponent:segmentFileNames[0]] error:nil];
+    XCTAssertEqual([attributes fileSize], 0);
+
+    XCTAssertTrue([recordLog appendRecords:[self recordsWithCount:1 dataLength:10] error:nil]);
+    XCTAssertEqual([[self readAllRecords:recordLog] count], 1);
+}
+
+- (void)testRecoveryTruncatesPartiallyWrittenRecord {
+    AWSKinesisRecordLog *recordLog = [self openRecordLogWithSegmentByteLimit:AWSKinesisRecordLogSegmentByteLimitDefault];
+    XCTAssertTrue([recordLog appendRecords:[self recordsWithCount:10 dataLength:100] error:nil]);
+    unsigned long long endOffset = recordLog.endOffset;
+    [recordLog close];
+
+    // Writes the start of a record, as if the app was terminated while appending it.
+    NSString *segmentPath = [self.directoryPath stringByAppendingPathComponent:[[self segmentFileNames] lastObject]];
+    NSFileHandle *fileHandle = [NSFileHandle fileHandleForWritingAtPath:segmentPath];
+    [fileHandle seekToEndOfFile];
+    uint32_t header[2] = {CFSwapInt32HostToLittle(200), 0};
+    [fileHandle writeData:[NSData dataWithBytes:header length:sizeof(header)]];
+    [fileHandle writeData:[NSMutableData dataWithLength:50]];
+    [fileHandle closeFile];
+
+    recordLog = [self openRecordLogWithSegmentByteLimit:AWSKinesisRecordLogSegmentByteLimitDefault];
+    XCTAssertEqual(recordLog.endOffset, endOffset);
+    XCTAssertEqual([[self readAllRecords:recordLog] count], 10);
+
+    XCTAssertTrue([recordLog appendRecords:[self recordsWithCount:1 dataLength:100] error:nil]);
+    XCTAssertEqual([[self readAllRecords:recordLog] count], 11);
+}
+
+- (void)testCorruptedRecordsAreSkipped {
+    AWSKinesisRecordLog *recordLog = [self openRecordLogWithSegmentByteLimit:4096];
+    XCTAssertTrue([recordLog appendRecords:[self recordsWithCount:20 dataLength:1000] error:nil]);
+    NSArray<AWSKinesisRecordLogEntry *> *records = [self readAllRecords:recordLog];
+    [recordLog close];
+
+    // Flips a byte of the data of the second record of the first segment.
+    NSString *segmentPath = [self.directoryPath stringByAppendingPathComponent:[[self segmentFileNames] firstObject]];
+    NSMutableData *segment = [NSMutableData dataWithContentsOfFile:segmentPath];
+    ((uint8_t *)[segment mutableBytes])[records[1].nextOffset - 1] ^= 0xFF;
+    XCTAssertTrue([segment writeToFile:segmentPath atomically:YES]);
+
+    recordLog = [self openRecordLogWithSegmentByteLimit:4096];
+    NSArray<AWSKinesisRecordLogEntry *> *readRecords = [self readAllRecords:recordLog];
+    XCTAssertEqualObjects(readRecords[0].partitionKey, @"partition-key-0");
+    XCTAssertEqualObjects(readRecords[1].partitionKey, @"partition-key-4");
+    XCTAssertEqual([readRecords count], 17);
+}
+
+- (void)testCorruptedRecordsOfActiveSegmentAreSkipped {
+    AWSKinesisRecordLog *recordLog = [self openRecordLogWithSegmentByteLimit:AWSKinesisRecordLogSegmentByteLimitDefault];
+    XCTAssertTrue([recordLog appendRecords:[self recordsWithCount:3 dataLength:100] error:nil]);
+    NSArray<AWSKinesisRecordLogEntry *> *records = [self readAllRecords:recordLog];
+    unsigned long long endOffset = recordLog.endOffset;
+
+    // Flips a byte of the data of the second record while the log is open.
+    NSString *segmentPath = [self.directoryPath stringByAppendingPathComponent:[[self segmentFileNames] lastObject]];
+    NSFileHandle *fileHandle = [NSFileHandle fileHandleForUpdatingAtPath:segmentPath];
+    [fileHandle seekToFileOffset:records[1].nextOffset - 1];
+    uint8_t byte = ((const uint8_t *)[[fileHandle readDataOfLength:1] bytes])[0] ^ 0xFF;
+    [fileHandle seekToFileOffset:records[1].nextOffset - 1];
+    [fileHandle writeData:[NSData dataWithBytes:&byte length:1]];
+    [fileHandle closeFile];
+
+    NSArray<AWSKinesisRecordLogEntry *> *readRecords = [self readAllRecords:recordLog];
+    XCTAssertEqual([readRecords count], 1);
+    XCTAssertEqualObjects(readRecords[0].partitionKey, @"partition-key-0");
+
+    // The records appended afterwards are still read.
+    XCTAssertTrue([recordLog appendRecords:[self recordsWithCount:1 dataLength:100] error:nil]);
+    readRecords = [recordLog readRecordsFromOffset:records[0].nextOffset recordCountLimit:10 byteLimit:0 error:nil];
+    XCTAssertEqual([readRecords count], 1);
+    XCTAssertEqual(readRecords[0].offset, endOffset);
+}
+
+- (void)testAcknowledgeRecordsPastLimits {
+    AWSKinesisRecordLog *recordLog = [self openRecordLogWithSegmentByteLimit:4096];
+    XCTAssertTrue([recordLog appendRecords:[self recordsWithCount:20 dataLength:1000] error:nil]);
+
+    XCTAssertTrue([recordLog acknowledgeRecordsBeforeTimestamp:1005 byteCountLimit:0 error:nil]);
+    XCTAssertEqualObjects([self readAllRecords:recordLog][0].partitionKey, @"partition-key-5");
+
+    XCTAssertTrue([recordLog acknowledgeRecordsBeforeTimestamp:0 byteCountLimit:5000 error:nil]);
+    XCTAssertLessThanOrEqual(recordLog.byteCount, 5000);
+    XCTAssertEqual([[self readAllRecords:recordLog] count], 4);
+
+    XCTAssertTrue([recordLog acknowledgeRecordsBeforeTimestamp:0 byteCountLimit:0 error:nil]);
+    XCTAssertEqual([[self readAllRecords:recordLog] count], 4);
+}
+
+- (void)testRecordsAcknowledgedPastLimitsAreNotAppendedAgain {
+    AWSKinesisRecordLog *recordLog = [self openRecordLogWithSegmentByteLimit:4096];
+    XCTAssertTrue([recordLog appendRecords:[self recordsWithCount:10 dataLength:1000] error:nil]);
+    NSArray<AWSKinesisRecordLogEntry *> *readRecords = [self readAllRecords:recordLog];
+    XCTAssertEqual([readRecords count], 10);
+
+    // The first records expire while all of them are submitted, and all of them are to be submitted again.
+    XCTAssertTrue([recordLog acknowledgeRecordsBeforeTimestamp:1005 byteCountLimit:0 error:nil]);
+    unsigned long long endOffset = recordLog.endOffset;
+    XCTAssertTrue([recordLog appendRecords:readRecords acknowledgingToOffset:[readRecords lastObject].nextOffset error:nil]);
+
+    NSArray<AWSKinesisRecordLogEntry *> *records = [self readAllRecords:recordLog];
+    XCTAssertEqual([records count], 5);
+    XCTAssertEqual(recordLog.acknowledgedOffset, endOffset);
+    XCTAssertEqualObjects(records[0].partitionKey, @"partition-key-5");
+
+    // None of them are appended again once all of them are acknowledged.
+    readRecords = records;
+    XCTAssertTrue([recordLog removeAllRecords:nil]);
+    XCTAssertTrue([recordLog appendRecords:readRecords acknowledgingToOffset:[readRecords lastObject].nextOffset error:nil]);
+    XCTAssertEqual([[self readAllRecords:recordLog] count], 0);
+}
+
+// Saves the records in batches and submits them in batches, with the table and the statements of the database storage of the recorders.
+// Compare with testPerformanceRecordLogQueue.
+- (void)testPerformanceDatabaseQueue {
+    NSArray<AWSKinesisRecordLogEntry *> *records = [self recordsWithCount:AWSKinesisRecordLogTestsIterations dataLength:1024];
+    NSMutableArray<NSArray *> *argumentArrays = [NSMutableArray arrayWithCapacity:[records count]];
+    for (AWSKinesisRecordLogEntry *record in records) {
+        [argumentArrays addObject:@[record.partitionKey, record.streamName, record.data, @(record.timestamp), @0]];
+    }
+
+    [self measureMetrics:[[self class] defaultPerformanceMetrics] automaticallyStartMeasuring:NO forBlock:^{
+        NSString *databasePath = [self.directoryPath stringByAppendingPathComponent:[[NSUUID UUID] UUIDString]];
+        [[NSFileManager defaultManager] createDirectoryAtPath:self.directoryPath withIntermediateDirectories:YES attributes:nil error:nil];
+        AWSFMDatabaseQueue *databaseQueue = [AWSFMDatabaseQueue storeDatabaseQueueWithPath:databasePath];
+        [databaseQueue inDatabase:^(AWSFMDatabase *db) {
+            XCTAssertTrue([db executeUpdate:@"CREATE TABLE IF NOT EXISTS record (partition_key TEXT NOT NULL, stream_name TEXT NOT NULL, data BLOB NOT NULL, timestamp REAL NOT NULL, retry_count INTEGER NOT NULL)"]);
+        }];
+
+        [self startMeasuring];
+        for (NSUInteger i = 0; i < [argumentArrays count]; i += AWSKinesisRecordLogTestsSaveBatchRecordCount) {
+            [databaseQueue inTransaction:^(AWSFMDatabase *db, BOOL *rollback) {
+                [db executeUpdate:@"INSERT INTO record (partition_key, stream_name, data, timestamp, retry_count) VALUES (?, ?, ?, ?, ?)"
+               withArgumentArrays:[argumentArrays subarrayWithRange:NSMakeRange(i, AWSKinesisRecordLogTestsSaveBatchRecordCount)]];
+            }];
+        }
+
+        __block NSUInteger submittedRecordCount = 0;
+        __block BOOL done = NO;
+        while (!done) {
+            [databaseQueue inTransaction:^(AWSFMDatabase *db, BOOL *rollback) {
+                NSMutableArray<NSNumber *> *rowIds = [NSMutableArray new];
+                AWSFMResultSet *rs = [db executeQuery:
+                                      @"SELECT rowid, partition_key, data, retry_count, stream_name "
+                                      @"FROM record "
+                                      @"WHERE stream_name = (SELECT stream_name FROM record ORDER BY timestamp ASC LIMIT 1) "
+                                      @"ORDER BY timestamp ASC "
+                                      @"LIMIT 128"];
+                while ([rs next]) {
+                    [rs dataForColumn:@"data"];
+                    [rowIds addObject:@([rs longLongIntForColumn:@"rowid"])];
+                }
+                [rs close];
+                [db executeUpdate:@"DELETE FROM record WHERE rowid IN aws_fmdb_values" withValuesInTemporaryTable:rowIds];
+                submittedRecordCount += [rowIds count];
+                done = [rowIds count] == 0;
+            }];
+            [databaseQueue inDatabase:^(AWSFMDatabase *db) {
+                [db aws_releaseFreePagesIfNeeded];
+            }];
+        }
+        [self stopMeasuring];
+
+        XCTAssertEqual(submittedRecordCount, AWSKinesisRecordLogTestsIterations);
+        [databaseQueue close];
+    }];
+}
+
+- (void)testPerformanceRecordLogQueue {
+    NSArray<AWSKinesisRecordLogEntry *> *records = [self recordsWithCount:AWSKinesisRecordLogTestsIterations dataLength:1024];
+
+    [self measureMetrics:[[self class] defaultPerformanceMetrics] automaticallyStartMeasuring:NO forBlock:^{
+        [[NSFileManager defaultManager] removeItemAtPath:self.directoryPath error:nil];
+        AWSKinesisRecordLog *recordLog = [self openRecordLogWithSegmentByteLimit:AWSKinesisRecordLogSegmentByteLimitDefault];
+
+        [self startMeasuring];
+        for (NSUInteger i = 0; i < [records count]; i += AWSKinesisRecordLogTestsSaveBatchRecordCount) {
+            [recordLog appendRecords:[records subarrayWithRange:NSMakeRange(i, AWSKinesisRecordLogTestsSaveBatchRecordCount)] error:nil];
+        }
+
+        NSUInteger submittedRecordCount = 0;
+        NSArray<AWSKinesisRecordLogEntry *> *batch = nil;
+        while ([(batch = [recordLog readRecordsFromOffset:recordLog.acknowledgedOffset
+                                         recordCountLimit:AWSKinesisRecordLogTestsSubmitBatchRecordCount
+                                                byteLimit:0
+                                                    error:nil]) count] > 0) {
+            [recordLog acknowledgeToOffset:[batch lastObject].nextOffset error:nil];
+            submittedRecordCount += [batch count];
+        }
+        [self stopMeasuring];
+
+        XCTAssertEqual(submittedRecordCount, AWSKinesisRecordLogTestsIterations);
+        [recordLog close];
+    }];
+}
+
+@end
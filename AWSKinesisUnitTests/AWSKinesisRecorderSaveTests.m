@@ -0,0 +1,182 @@
+//
+// Copyright 2010-2021 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License.
+// A copy of the License is located at
+//
+// http://aws.amazon.com/apache2.0
+//
+// or in the "license" file accompanying this file. This file is distributed
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+//
+
+#import <XCTest/XCTest.h>
+#import "AWSTestUtility.h"
+#import "AWSKinesis.h"
+
+// The number of records saved by the benchmarks.
+static const NSUInteger AWSKinesisRecorderSaveTestsIterations = 2000;
+
+static NSString *const AWSKinesisRecorderSaveTestsKey = @"AWSKinesisRecorderSaveTests";
+
+@interface AWSKinesisRecorderSaveTests : XCTestCase
+
+@property (nonatomic, strong) AWSKinesisRecorder *kinesisRecorder;
+
+@end
+
+@implementation AWSKinesisRecorderSaveTests
+
+- (void)setUp {
+    [super setUp];
+    [AWSTestUtility setupFakeCognitoCredentialsProvider];
+
+    AWSServiceConfiguration *configuration = [[AWSServiceConfiguration alloc] initWithRegion:AWSRegionUSEast1
+                                                                         credentialsProvider:[AWSServiceManager defaultServiceManager].defaultServiceConfiguration.credentialsProvider];
+    [AWSKinesisRecorder registerKinesisRecorderWithConfiguration:configuration forKey:AWSKinesisRecorderSaveTestsKey];
+    self.kinesisRecorder = [AWSKinesisRecorder KinesisRecorderForKey:AWSKinesisRecorderSaveTestsKey];
+    [[self.kinesisRecorder removeAllRecords] waitUntilFinished];
+}
+
+- (void)tearDown {
+    [[self.kinesisRecorder removeAllRecords] waitUntilFinished];
+    [AWSKinesisRecorder removeKinesisRecorderForKey:AWSKinesisRecorderSaveTestsKey];
+    [super tearDown];
+}
+
+- (NSData *)recordDataOfLength:(NSUInteger)length {
+    return [NSMutableData dataWithLength:length];
+}
+
+- (AWSTask *)saveRecordCount:(NSUInteger)count data:(NSData *)data {
+    NSMutableArray<AWSTask *> *tasks = [NSMutableArray arrayWithCapacity:count];
+    for (NSUInteger i = 0; i < count; i++) {
+        [tasks addObject:[self.kinesisRecorder saveRecord:data streamName:@"AWSKinesisRecorderSaveTests"]];
+    }
+    return [AWSTask taskForCompletionOfAllTasks:tasks];
+}
+
+- (void)testSavedRecordsAreCommitted {
+    self.kinesisRecorder.saveInterval = 0.05;
+
+    AWSTask *task = [self saveRecordCount:100 data:[self recordDataOfLength:10 * 1024]];
+    [task waitUntilFinished];
+    XCTAssertNil(task.error);
+    XCTAssertGreaterThan(self.kinesisRecorder.diskBytesUsed, 100 * 10 * 1024);
+}
+
+- (void)testBufferedRecordsAreCommittedByBatch {
+    self.kinesisRecorder.saveDurability = AWSKinesisRecorderSaveDurabilityBuffered;
+    self.kinesisRecorder.saveInterval = 60;
+    self.kinesisRecorder.saveBatchRecordCount = 10;
+
+    AWSTask *task = [self saveRecordCount:9 data:[self recordDataOfLength:10 * 1024]];
+    XCTAssertTrue(task.completed);
+    XCTAssertLessThan(self.kinesisRecorder.diskBytesUsed, 13000);
+
+    // The tenth record fills the batch. A committed record is written after it.
+    [self saveRecordCount:1 data:[self recordDataOfLength:10 * 1024]];
+    self.kinesisRecorder.saveDurability = AWSKinesisRecorderSaveDurabilityCommitted;
+    self.kinesisRecorder.saveInterval = 0;
+    [[self saveRecordCount:1 data:[self recordDataOfLength:10 * 1024]] waitUntilFinished];
+    XCTAssertGreaterThan(self.kinesisRecorder.diskBytesUsed, 11 * 10 * 1024);
+}
+
+- (void)testRemoveAllRecordsRemovesBufferedRecords {
+    self.kinesisRecorder.saveDurability = AWSKinesisRecorderSaveDurabilityBuffered;
+    self.kinesisRecorder.saveInterval = 60;
+
+    [self saveRecordCount:10 data:[self recordDataOfLength:10 * 1024]];
+    [[self.kinesisRecorder removeAllRecords] waitUntilFinished];
+
+    self.kinesisRecorder.saveDurability = AWSKinesisRecorderSaveDurabilityCommitted;
+    self.kinesisRecorder.saveInterval = 0;
+    [[self saveRecordCount:1 data:[self recordDataOfLength:1024]] waitUntilFinished];
+    XCTAssertLessThan(self.kinesisRecorder.diskBytesUsed, 13000);
+}
+
+- (void)testDiskByteLimitOfGroupedRecords {
+    self.kinesisRecorder.diskByteLimit = 1024 * 1024;
+
+    AWSTask *task = [self saveRecordCount:200 data:[self recordDataOfLength:50 * 1024]];
+    [task waitUntilFinished];
+    XCTAssertNil(task.error);
+    XCTAssertGreaterThan(self.kinesisRecorder.diskBytesUsed, 500 * 1024);
+    XCTAssertLessThan(self.kinesisRecorder.diskBytesUsed, 1.2 * 1024 * 1024);
+
+    self.kinesisRecorder.diskByteLimit = 5 * 1024 * 1024;
+}
+
+// Saves each record after the previous one is committed, so that every record is committed on its own.
+// Compare with testPerformanceSaveRecordsGrouped.
+- (void)testPerformanceSaveRecordsOneByOne {
+    NSData *data = [self recordDataOfLength:1024];
+    [self measureMetrics:[[self class] defaultPerformanceMetrics] automaticallyStartMeasuring:NO forBlock:^{
+        [[self.kinesisRecorder removeAllRecords] waitUntilFinished];
+
+        [self startMeasuring];
+        for (NSUInteger i = 0; i < AWSKinesisRecorderSaveTestsIterations; i++) {
+            [[self.kinesisRecorder saveRecord:data streamName:@"AWSKinesisRecorderSaveTests"] waitUntilFinished];
+        }
+        [self stopMeasuring];
+    }];
+}
+
+- (void)testPerformanceSaveRecordsGrouped {
+    NSData *data = [self recordDataOfLength:1024];
+    [self measureMetrics:[[self class] defaultPerformanceMetrics] automaticallyStartMeasuring:NO forBlock:^{
+        [[self.kinesisRecorder removeAllRecords] waitUntilFinished];
+
+        [self startMeasuring];
+        [[self saveRecordCount:AWSKinesisRecorderSaveTestsIterations data:data] waitUntilFinished];
+        [self stopMeasuring];
+    }];
+}
+
+// Compare with testPerformanceSaveRecordsOneByOne.
+- (void)testPerformanceSaveRecordsOneByOneToRecordLog {
+    NSString *key = @"AWSKinesisRecorderSaveTestsRecordLog";
+    [AWSKinesisRecorder registerKinesisRecorderWithConfiguration:[AWSServiceManager defaultServiceManager].defaultServiceConfiguration
+                                                         storage:AWSKinesisRecorderStorageLog
+                                                          forKey:key];
+    AWSKinesisRecorder *kinesisRecorder = [AWSKinesisRecorder KinesisRecorderForKey:key];
+    XCTAssertEqual(kinesisRecorder.storage, AWSKinesisRecorderStorageLog);
+
+    NSData *data = [self recordDataOfLength:1024];
+    [self measureMetrics:[[self class] defaultPerformanceMetrics] automaticallyStartMeasuring:NO forBlock:^{
+        [[kinesisRecorder removeAllRecords] waitUntilFinished];
+
+        [self startMeasuring];
+        for (NSUInteger i = 0; i < AWSKinesisRecorderSaveTestsIterations; i++) {
+            [[kinesisRecorder saveRecord:data streamName:@"AWSKinesisRecorderSaveTests"] waitUntilFinished];
+        }
+        [self stopMeasuring];
+
+        XCTAssertGreaterThan(kinesisRecorder.diskBytesUsed, AWSKinesisRecorderSaveTestsIterations * 1024);
+    }];
+
+    [[kinesisRecorder removeAllRecords] waitUntilFinished];
+    [AWSKinesisRecorder removeKinesisRecorderForKey:key];
+}
+
+// Compare with testPerformanceSaveRecordsGrouped.
+- (void)testPerformanceSaveRecordsBuffered {
+    NSData *data = [self recordDataOfLength:1024];
+    self.kinesisRecorder.saveDurability = AWSKinesisRecorderSaveDurabilityBuffered;
+    self.kinesisRecorder.saveInterval = 0.1;
+    [self measureMetrics:[[self class] defaultPerformanceMetrics] automaticallyStartMeasuring:NO forBlock:^{
+        [[self.kinesisRecorder removeAllRecords] waitUntilFinished];
+
+        [self startMeasuring];
+        for (NSUInteger i = 0; i < AWSKinesisRecorderSaveTestsIterations; i++) {
+            [self.kinesisRecorder saveRecord:data streamName:@"AWSKinesisRecorderSaveTests"];
+        }
+        [[self.kinesisRecorder removeAllRecords] waitUntilFinished];
+        [self stopMeasuring];
+    }];
+}
+
+@end
@@ -0,0 +1,392 @@
+//
+// Copyright 2010-2021 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License.
+// A copy of the License is located at
+//
+// http://aws.amazon.com/apache2.0
+//
+// or in the "license" file accompanying this file. This file is distributed
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+//
+
+#import <XCTest/XCTest.h>
+#import <CommonCrypto/CommonDigest.h>
+#import "OCMock.h"
+#import "AWSTestUtility.h"
+#import "AWSKinesis.h"
+
+// The number of records submitted by the benchmarks.
+static const NSUInteger AWSKinesisRecorderSubmitTestsIterations = 5000;
+
+// The time the stand-in takes to answer a request.
+static const NSTimeInterval AWSKinesisRecorderSubmitTestsLatency = 0.01;
+
+static NSString *const AWSKinesisRecorderSubmitTestsKey = @"AWSKinesisRecorderSubmitTests";
+
+// The stand-in streams have two shards, split at 2^127, so the first bit of the MD5 digest of a partition key picks its shard.
+static NSString *AWSKinesisRecorderSubmitTestsShardId(NSString *partitionKey) {
+    NSData *data = [partitionKey dataUsingEncoding:NSUTF8StringEncoding];
+    unsigned char digest[CC_MD5_DIGEST_LENGTH];
+    CC_MD5([data bytes], (CC_LONG)[data length], digest);
+    return (digest[0] & 0x80) ? @"shardId-000000000001" : @"shardId-000000000000";
+}
+
+// Answers the PutRecords and ListShards requests of a recorder in place of Kinesis, after a fixed latency.
+@interface AWSKinesisRecorderSubmitTestsStandIn : NSObject
+
+@property (nonatomic, strong) id mockNetworking;
+@property (nonatomic, strong) NSError *error;
+@property (nonatomic, strong) NSSet<NSString *> *throttledStreamNames;
+@property (nonatomic, strong) NSSet<NSString *> *throttledShardIds;
+@property (nonatomic, assign) NSUInteger listShardsRequestCount;
+@property (nonatomic, strong) NSCountedSet<NSString *> *putShardIds;
+@property (nonatomic, assign) NSUInteger putRecordCount;
+@property (nonatomic, strong) NSCountedSet<NSString *> *putStreamNames;
+@property (nonatomic, assign) NSUInteger maxBatchRecordCount;
+@property (nonatomic, assign) NSUInteger inFlightRequestCount;
+@property (nonatomic, assign) NSUInteger maxInFlightRequestCount;
+@property (nonatomic, strong) NSMutableArray<AWSTask *> *tasks;
+
+@end
+
+@implementation AWSKinesisRecorderSubmitTestsStandIn
+
+- (instancetype)initWithKinesisRecorder:(AWSKinesisRecorder *)kinesisRecorder {
+    if (self = [super init]) {
+        _tasks = [NSMutableArray new];
+        _throttledStreamNames = [NSSet set];
+        _throttledShardIds = [NSSet set];
+        _putStreamNames = [NSCountedSet new];
+        _putShardIds = [NSCountedSet new];
+        _mockNetworking = OCMClassMock([AWSNetworking class]);
+        __weak AWSKinesisRecorderSubmitTestsStandIn *weakSelf = self;
+        OCMStub([_mockNetworking sendRequest:[OCMArg isKindOfClass:[AWSNetworkingRequest class]]]).andDo(^(NSInvocation *invocation) {
+            __unsafe_unretained AWSNetworkingRequest *request = nil;
+            [invocation getArgument:&request atIndex:2];
+            AWSTask *task = nil;
+            if ([request.headers[@"X-Amz-Target"] hasSuffix:@".ListShards"]) {
+                task = [weakSelf listShards];
+            } else {
+                task = [weakSelf putRecords:request.parameters[@"Records"] streamName:request.parameters[@"StreamName"]];
+            }
+            [invocation setReturnValue:&task];
+        });
+
+        AWSKinesis *kinesis = [kinesisRecorder valueForKeyPath:@"recorderHelper.kinesis"];
+        [kinesis setValue:_mockNetworking forKey:@"networking"];
+    }
+    return self;
+}
+
+- (AWSTask *)listShards {
+    @synchronized(self) {
+        self.listShardsRequestCount += 1;
+    }
+
+    NSMutableArray<AWSKinesisShard *> *shards = [NSMutableArray new];
+    NSArray<NSArray<NSString *> *> *hashKeyRanges = @[@[@"0", @"170141183460469231731687303715884105727"],
+                                                      @[@"170141183460469231731687303715884105728", @"340282366920938463463374607431768211455"]];
+    for (NSUInteger i = 0; i < [hashKeyRanges count]; i++) {
+        AWSKinesisShard *shard = [AWSKinesisShard new];
+        shard.shardId = [NSString stringWithFormat:@"shardId-00000000000%lu", (unsigned long)i];
+        shard.hashKeyRange = [AWSKinesisHashKeyRange new];
+        shard.hashKeyRange.startingHashKey = hashKeyRanges[i][0];
+        shard.hashKeyRange.endingHashKey = hashKeyRanges[i][1];
+        [shards addObject:shard];
+    }
+    AWSKinesisListShardsOutput *listShardsOutput = [AWSKinesisListShardsOutput new];
+    listShardsOutput.shards = shards;
+    return [AWSTask taskWithResult:listShardsOutput];
+}
+
+- (AWSTask *)putRecords:(NSArray *)records streamName:(NSString *)streamName {
+    AWSTaskCompletionSource *taskCompletionSource = [AWSTaskCompletionSource taskCompletionSource];
+    NSError *error = nil;
+    BOOL throttled = NO;
+    NSSet<NSString *> *throttledShardIds = nil;
+    @synchronized(self) {
+        // The tasks are kept, so that they outlive the invocation they are returned from.
+        [self.tasks addObject:taskCompletionSource.task];
+        self.inFlightRequestCount += 1;
+        self.maxInFlightRequestCount = MAX(self.maxInFlightRequestCount, self.inFlightRequestCount);
+        self.maxBatchRecordCount = MAX(self.maxBatchRecordCount, [records count]);
+        error = self.error;
+        throttled = [self.throttledStreamNames containsObject:streamName];
+        throttledShardIds = self.throttledShardIds;
+    }
+
+    NSMutableArray<NSString *> *shardIds = [NSMutableArray arrayWithCapacity:[records count]];
+    for (NSDictionary *record in records) {
+        [shardIds addObject:AWSKinesisRecorderSubmitTestsShardId(record[@"PartitionKey"])];
+    }
+
+    dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(AWSKinesisRecorderSubmitTestsLatency * NSEC_PER_SEC)), dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
+        @synchronized(self) {
+            self.inFlightRequestCount -= 1;
+            if (!error && !throttled) {
+                for (NSUInteger i = 0; i < [records count]; i++) {
+                    if (![throttledShardIds containsObject:shardIds[i]]) {
+                        self.putRecordCount += 1;
+                        [self.putStreamNames addObject:streamName];
+                        [self.putShardIds addObject:shardIds[i]];
+                    }
+                }
+            }
+        }
+
+        if (error) {
+            [taskCompletionSource setError:error];
+            return;
+        }
+        NSMutableArray<AWSKinesisPutRecordsResultEntry *> *resultEntries = [NSMutableArray arrayWithCapacity:[records count]];
+        NSUInteger failedRecordCount = 0;
+        for (NSUInteger i = 0; i < [records count]; i++) {
+            AWSKinesisPutRecordsResultEntry *resultEntry = [AWSKinesisPutRecordsResultEntry new];
+            if (throttled || [throttledShardIds containsObject:shardIds[i]]) {
+                resultEntry.errorCode = @"ProvisionedThroughputExceededException";
+                failedRecordCount += 1;
+            } else {
+                resultEntry.sequenceNumber = [@(i) stringValue];
+                resultEntry.shardId = shardIds[i];
+            }
+            [resultEntries addObject:resultEntry];
+        }
+        AWSKinesisPutRecordsOutput *putRecordsOutput = [AWSKinesisPutRecordsOutput new];
+        putRecordsOutput.failedRecordCount = @(failedRecordCount);
+        putRecordsOutput.records = resultEntries;
+        [taskCompletionSource setResult:putRecordsOutput];
+    });
+
+    return taskCompletionSource.task;
+}
+
+@end
+
+@interface AWSKinesisRecorderSubmitTests : XCTestCase
+
+@property (nonatomic, strong) AWSKinesisRecorder *kinesisRecorder;
+@property (nonatomic, strong) AWSKinesisRecorderSubmitTestsStandIn *standIn;
+
+@end
+
+@implementation AWSKinesisRecorderSubmitTests
+
+- (void)setUp {
+    [super setUp];
+    [AWSTestUtility setupFakeCognitoCredentialsProvider];
+
+    [AWSKinesisRecorder registerKinesisRecorderWithConfiguration:[AWSServiceManager defaultServiceManager].defaultServiceConfiguration
+                                                          forKey:AWSKinesisRecorderSubmitTestsKey];
+    self.kinesisRecorder = [AWSKinesisRecorder KinesisRecorderForKey:AWSKinesisRecorderSubmitTestsKey];
+    self.standIn = [[AWSKinesisRecorderSubmitTestsStandIn alloc] initWithKinesisRecorder:self.kinesisRecorder];
+    [[self.kinesisRecorder removeAllRecords] waitUntilFinished];
+}
+
+- (void)tearDown {
+    [[self.kinesisRecorder removeAllRecords] waitUntilFinished];
+    [AWSKinesisRecorder removeKinesisRecorderForKey:AWSKinesisRecorderSubmitTestsKey];
+    [super tearDown];
+}
+
+- (void)saveRecordCount:(NSUInteger)count kinesisRecorder:(AWSKinesisRecorder *)kinesisRecorder {
+    [self saveRecordCount:count streamNames:@[@"AWSKinesisRecorderSubmitTests"] kinesisRecorder:kinesisRecorder];
+}
+
+// Saves the records to the streams in turn.
+- (void)saveRecordCount:(NSUInteger)count streamNames:(NSArray<NSString *> *)streamNames kinesisRecorder:(AWSKinesisRecorder *)kinesisRecorder {
+    NSData *data = [NSMutableData dataWithLength:1024];
+    NSMutableArray<AWSTask *> *tasks = [NSMutableArray arrayWithCapacity:count];
+    for (NSUInteger i = 0; i < count; i++) {
+        [tasks addObject:[kinesisRecorder saveRecord:data streamName:streamNames[i % [streamNames count]]]];
+    }
+    AWSTask *task = [AWSTask taskForCompletionOfAllTasks:tasks];
+    [task waitUntilFinished];
+    XCTAssertNil(task.error);
+}
+
+- (void)testSubmitAllRecordsKeepsRequestsInFlight {
+    [self saveRecordCount:2000 kinesisRecorder:self.kinesisRecorder];
+
+    AWSTask *task = [self.kinesisRecorder submitAllRecords];
+    [task waitUntilFinished];
+    XCTAssertNil(task.error);
+    XCTAssertEqual(self.standIn.putRecordCount, 2000);
+    XCTAssertGreaterThan(self.standIn.maxBatchRecordCount, 128);
+    XCTAssertLessThanOrEqual(self.standIn.maxBatchRecordCount, 500);
+    XCTAssertGreaterThan(self.standIn.maxInFlightRequestCount, 1);
+    XCTAssertLessThanOrEqual(self.standIn.maxInFlightRequestCount, 4);
+
+    // The submitted records were deleted.
+    [[self.kinesisRecorder submitAllRecords] waitUntilFinished];
+    XCTAssertEqual(self.standIn.putRecordCount, 2000);
+}
+
+- (void)testSubmitConcurrencyLimit {
+    self.kinesisRecorder.submitConcurrencyLimit = 1;
+    [self saveRecordCount:2000 kinesisRecorder:self.kinesisRecorder];
+
+    AWSTask *task = [self.kinesisRecorder submitAllRecords];
+    [task waitUntilFinished];
+    XCTAssertNil(task.error);
+    XCTAssertEqual(self.standIn.putRecordCount, 2000);
+    XCTAssertEqual(self.standIn.maxInFlightRequestCount, 1);
+}
+
+- (void)testSubmitAllRecordsKeepsRecordsOnNetworkError {
+    [self saveRecordCount:2000 kinesisRecorder:self.kinesisRecorder];
+
+    self.standIn.error = [NSError errorWithDomain:NSURLErrorDomain code:NSURLErrorNotConnectedToInternet userInfo:nil];
+    AWSTask *task = [self.kinesisRecorder submitAllRecords];
+    [task waitUntilFinished];
+    XCTAssertEqualObjects(task.error.domain, NSURLErrorDomain);
+    XCTAssertEqual(self.standIn.putRecordCount, 0);
+
+    self.standIn.error = nil;
+    task = [self.kinesisRecorder submitAllRecords];
+    [task waitUntilFinished];
+    XCTAssertNil(task.error);
+    XCTAssertEqual(self.standIn.putRecordCount, 2000);
+}
+
+- (void)testThrottledStreamDoesNotStopOtherStreams {
+    [self saveRecordCount:2000 streamNames:@[@"AWSKinesisRecorderSubmitTestsA", @"AWSKinesisRecorderSubmitTestsB"] kinesisRecorder:self.kinesisRecorder];
+
+    NSArray<AWSKinesisRecorderStreamBacklog *> *streamBacklogs = self.kinesisRecorder.streamBacklogs;
+    XCTAssertEqual([streamBacklogs count], 2);
+    XCTAssertEqualObjects(streamBacklogs[0].streamName, @"AWSKinesisRecorderSubmitTestsA");
+    XCTAssertEqual(streamBacklogs[0].recordCount, 1000);
+    XCTAssertGreaterThan(streamBacklogs[0].byteCount, 1000 * 1024);
+    XCTAssertNotNil(streamBacklogs[0].oldestRecordDate);
+    XCTAssertNil(streamBacklogs[0].backoffDate);
+
+    self.standIn.throttledStreamNames = [NSSet setWithObject:@"AWSKinesisRecorderSubmitTestsA"];
+    AWSTask *task = [self.kinesisRecorder submitAllRecords];
+    [task waitUntilFinished];
+    XCTAssertNil(task.error);
+    XCTAssertEqual([self.standIn.putStreamNames countForObject:@"AWSKinesisRecorderSubmitTestsA"], 0);
+    XCTAssertEqual([self.standIn.putStreamNames countForObject:@"AWSKinesisRecorderSubmitTestsB"], 1000);
+
+    // The throttled stream keeps its records until its backoff ends.
+    streamBacklogs = self.kinesisRecorder.streamBacklogs;
+    XCTAssertEqual([streamBacklogs count], 1);
+    XCTAssertEqualObjects(streamBacklogs[0].streamName, @"AWSKinesisRecorderSubmitTestsA");
+    XCTAssertEqual(streamBacklogs[0].recordCount, 1000);
+    XCTAssertNotNil(streamBacklogs[0].backoffDate);
+
+    self.standIn.throttledStreamNames = [NSSet set];
+    [[self.kinesisRecorder submitAllRecords] waitUntilFinished];
+    XCTAssertEqual([self.standIn.putStreamNames countForObject:@"AWSKinesisRecorderSubmitTestsA"], 0);
+
+    [NSThread sleepForTimeInterval:1.1];
+    [[self.kinesisRecorder submitAllRecords] waitUntilFinished];
+    XCTAssertEqual([self.standIn.putStreamNames countForObject:@"AWSKinesisRecorderSubmitTestsA"], 1000);
+    XCTAssertEqual([self.kinesisRecorder.streamBacklogs count], 0);
+}
+
+- (void)testThrottledShardDoesNotHoldBackOtherShards {
+    self.kinesisRecorder.shardMapEnabled = YES;
+    [self saveRecordCount:2000 kinesisRecorder:self.kinesisRecorder];
+
+    self.standIn.throttledShardIds = [NSSet setWithObject:@"shardId-000000000001"];
+    AWSTask *task = [self.kinesisRecorder submitAllRecords];
+    [task waitUntilFinished];
+    XCTAssertNil(task.error);
+    XCTAssertEqual(self.standIn.listShardsRequestCount, 1);
+    NSUInteger putRecordCount = [self.standIn.putShardIds countForObject:@"shardId-000000000000"];
+    XCTAssertGreaterThan(putRecordCount, 0);
+    XCTAssertEqual(self.standIn.putRecordCount, putRecordCount);
+
+    // Only the records of the throttled shard are kept, and the stream does not back off.
+    NSArray<AWSKinesisRecorderStreamBacklog *> *streamBacklogs = self.kinesisRecorder.streamBacklogs;
+    XCTAssertEqual([streamBacklogs count], 1);
+    XCTAssertEqual(streamBacklogs[0].recordCount, 2000 - putRecordCount);
+    XCTAssertNil(streamBacklogs[0].backoffDate);
+
+    // The shard is not sent records until its backoff ends.
+    self.standIn.throttledShardIds = [NSSet set];
+    [[self.kinesisRecorder submitAllRecords] waitUntilFinished];
+    XCTAssertEqual(self.standIn.putRecordCount, putRecordCount);
+
+    [NSThread sleepForTimeInterval:1.1];
+    [[self.kinesisRecorder submitAllRecords] waitUntilFinished];
+    XCTAssertEqual(self.standIn.putRecordCount, 2000);
+    XCTAssertEqual([self.kinesisRecorder.streamBacklogs count], 0);
+    // The cached shard map is used.
+    XCTAssertEqual(self.standIn.listShardsRequestCount, 1);
+}
+
+- (void)testAggregatedRecords {
+    self.kinesisRecorder.aggregationEnabled = YES;
+    self.kinesisRecorder.aggregationLingerInterval = 0.05;
+    self.kinesisRecorder.batchRecordsByteLimit = 5 * 1024 * 1024;
+    [self saveRecordCount:2000 kinesisRecorder:self.kinesisRecorder];
+
+    AWSTask *task = [self.kinesisRecorder submitAllRecords];
+    [task waitUntilFinished];
+    XCTAssertNil(task.error);
+
+    // 2000 records of 1KB fit in a few aggregated records of up to 1MB.
+    XCTAssertGreaterThanOrEqual(self.standIn.putRecordCount, 2);
+    XCTAssertLessThanOrEqual(self.standIn.putRecordCount, 20);
+    XCTAssertEqual([self.kinesisRecorder.streamBacklogs count], 0);
+}
+
+- (void)testSubmitAllRecordsFromRecordLog {
+    NSString *key = @"AWSKinesisRecorderSubmitTestsRecordLog";
+    [AWSKinesisRecorder registerKinesisRecorderWithConfiguration:[AWSServiceManager defaultServiceManager].defaultServiceConfiguration
+                                                         storage:AWSKinesisRecorderStorageLog
+                                                          forKey:key];
+    AWSKinesisRecorder *kinesisRecorder = [AWSKinesisRecorder KinesisRecorderForKey:key];
+    AWSKinesisRecorderSubmitTestsStandIn *standIn = [[AWSKinesisRecorderSubmitTestsStandIn alloc] initWithKinesisRecorder:kinesisRecorder];
+    [[kinesisRecorder removeAllRecords] waitUntilFinished];
+    [self saveRecordCount:2000 kinesisRecorder:kinesisRecorder];
+
+    AWSTask *task = [kinesisRecorder submitAllRecords];
+    [task waitUntilFinished];
+    XCTAssertNil(task.error);
+    XCTAssertEqual(standIn.putRecordCount, 2000);
+    XCTAssertGreaterThan(standIn.maxInFlightRequestCount, 1);
+    XCTAssertEqual(kinesisRecorder.diskBytesUsed, 0);
+
+    [[kinesisRecorder removeAllRecords] waitUntilFinished];
+    [AWSKinesisRecorder removeKinesisRecorderForKey:key];
+}
+
+- (void)measureSubmitAllRecords {
+    [self measureMetrics:[[self class] defaultPerformanceMetrics] automaticallyStartMeasuring:NO forBlock:^{
+        [[self.kinesisRecorder removeAllRecords] waitUntilFinished];
+        [self saveRecordCount:AWSKinesisRecorderSubmitTestsIterations kinesisRecorder:self.kinesisRecorder];
+
+        [self startMeasuring];
+        [[self.kinesisRecorder submitAllRecords] waitUntilFinished];
+        [self stopMeasuring];
+    }];
+}
+
+// Sends one request at a time, as the recorder did before requests were pipelined.
+// Compare with testPerformanceSubmitAllRecords.
+- (void)testPerformanceSubmitAllRecordsOneInFlight {
+    self.kinesisRecorder.submitConcurrencyLimit = 1;
+    [self measureSubmitAllRecords];
+}
+
+- (void)testPerformanceSubmitAllRecords {
+    [self measureSubmitAllRecords];
+}
+
+// Sends a few aggregated records instead of a Kinesis record per saved record.
+// Compare with testPerformanceSubmitAllRecords.
+- (void)testPerformanceSubmitAllRecordsAggregated {
+    self.kinesisRecorder.aggregationEnabled = YES;
+    self.kinesisRecorder.aggregationLingerInterval = 0.05;
+    self.kinesisRecorder.batchRecordsByteLimit = 5 * 1024 * 1024;
+    [self measureSubmitAllRecords];
+
+    XCTAssertLessThan(self.standIn.putRecordCount, AWSKinesisRecorderSubmitTestsIterations / 100);
+}
+
+@end
@@ -0,0 +1,98 @@
+//
+// Copyright 2010-2021 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License.
+// A copy of the License is located at
+//
+// http://aws.amazon.com/apache2.0
+//
+// or in the "license" file accompanying this file. This file is distributed
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+//
+
+#import <XCTest/XCTest.h>
+#import "AWSKinesisModel.h"
+#import "AWSKinesisShardMap.h"
+
+// The MD5 digests of "a" and "b", read as 128-bit integers.
+static NSString *const AWSKinesisShardMapTestsHashKeyA = @"16955237001963240173058271559858726497";
+static NSString *const AWSKinesisShardMapTestsHashKeyB = @"195289424170611159128911017612795795343";
+
+@interface AWSKinesisShardMapTests : XCTestCase
+
+@end
+
+@implementation AWSKinesisShardMapTests
+
+- (AWSKinesisShard *)shardWithId:(NSString *)shardId
+                 startingHashKey:(NSString *)startingHashKey
+                   endingHashKey:(NSString *)endingHashKey {
+    AWSKinesisShard *shard = [AWSKinesisShard new];
+    shard.shardId = shardId;
+    shard.hashKeyRange = [AWSKinesisHashKeyRange new];
+    shard.hashKeyRange.startingHashKey = startingHashKey;
+    shard.hashKeyRange.endingHashKey = endingHashKey;
+    shard.sequenceNumberRange = [AWSKinesisSequenceNumberRange new];
+    shard.sequenceNumberRange.startingSequenceNumber = @"0";
+    return shard;
+}
+
+- (void)testPartitionKeysAreMappedByTheirHashKeys {
+    // The shards are listed out of order, split at 2^127.
+    AWSKinesisShardMap *shardMap = [[AWSKinesisShardMap alloc] initWithShards:@[[self shardWithId:@"shardId-000000000001"
+                                                                                   startingHashKey:@"170141183460469231731687303715884105728"
+                                                                                     endingHashKey:@"340282366920938463463374607431768211455"],
+                                                                                [self shardWithId:@"shardId-000000000000"
+                                                                                   startingHashKey:@"0"
+                                                                                     endingHashKey:@"170141183460469231731687303715884105727"]]];
+    XCTAssertEqual(shardMap.shardCount, 2);
+    XCTAssertNotNil(shardMap.date);
+    XCTAssertEqualObjects([shardMap shardIdForPartitionKey:@"a"], @"shardId-000000000000");
+    XCTAssertEqualObjects([shardMap shardIdForPartitionKey:@"b"], @"shardId-000000000001");
+    XCTAssertEqualObjects([shardMap shardIdForPartitionKey:@"c"], @"shardId-000000000000");
+    XCTAssertEqualObjects([shardMap shardIdForPartitionKey:@"d"], @"shardId-000000000001");
+    XCTAssertTrue([shardMap containsShardId:@"shardId-000000000001"]);
+    XCTAssertFalse([shardMap containsShardId:@"shardId-000000000002"]);
+}
+
+- (void)testHashKeyRangesAreInclusive {
+    AWSKinesisShardMap *shardMap = [[AWSKinesisShardMap alloc] initWithShards:@[[self shardWithId:@"shardId-000000000000"
+                                                                                   startingHashKey:AWSKinesisShardMapTestsHashKeyA
+                                                                                     endingHashKey:AWSKinesisShardMapTestsHashKeyA],
+                                                                                [self shardWithId:@"shardId-000000000001"
+                                                                                   startingHashKey:@"16955237001963240173058271559858726498"
+                                                                                     endingHashKey:AWSKinesisShardMapTestsHashKeyB]]];
+    XCTAssertEqualObjects([shardMap shardIdForPartitionKey:@"a"], @"shardId-000000000000");
+    XCTAssertEqualObjects([shardMap shardIdForPartitionKey:@"b"], @"shardId-000000000001");
+    // The hash key of "d" is past the last shard.
+    XCTAssertNil([shardMap shardIdForPartitionKey:@"d"]);
+}
+
+- (void)testClosedAndInvalidShardsAreLeftOut {
+    AWSKinesisShard *closedShard = [self shardWithId:@"shardId-000000000000"
+                                     startingHashKey:@"0"
+                                       endingHashKey:@"340282366920938463463374607431768211455"];
+    closedShard.sequenceNumberRange.endingSequenceNumber = @"1";
+    AWSKinesisShardMap *shardMap = [[AWSKinesisShardMap alloc] initWithShards:@[closedShard,
+                                                                                [self shardWithId:@"shardId-000000000001"
+                                                                                   startingHashKey:@"0"
+                                                                                     endingHashKey:@"340282366920938463463374607431768211456"],
+                                                                                [self shardWithId:@"shardId-000000000002"
+                                                                                   startingHashKey:@"0x10"
+                                                                                     endingHashKey:@"100"],
+                                                                                [self shardWithId:@"shardId-000000000003"
+                                                                                   startingHashKey:@"100"
+                                                                                     endingHashKey:@"10"],
+                                                                                [self shardWithId:@"shardId-000000000004"
+                                                                                   startingHashKey:@"0"
+                                                                                     endingHashKey:nil]]];
+    XCTAssertEqual(shardMap.shardCount, 0);
+    XCTAssertNil([shardMap shardIdForPartitionKey:@"a"]);
+
+    XCTAssertEqual([[AWSKinesisShardMap alloc] initWithShards:@[]].shardCount, 0);
+}
+
+@end
@@ -0,0 +1,112 @@
+//
+// Copyright 2010-2021 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License.
+// A copy of the License is located at
+//
+// http://aws.amazon.com/apache2.0
+//
+// or in the "license" file accompanying this file. This file is distributed
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+//
+
+#import <Foundation/Foundation.h>
+#import <AWSCore/AWSCore.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+@class AWSLogs;
+
+/**
+ The default limit of the disk space used by the log events waiting to be uploaded, 5MB.
+ */
+FOUNDATION_EXPORT NSUInteger const AWSLogsLoggerDiskByteLimitDefault;
+
+/**
+ The default number of log streams uploaded to at the same time, 4.
+ */
+FOUNDATION_EXPORT NSUInteger const AWSLogsLoggerMaximumConcurrentUploadsDefault;
+
+/**
+ A logger which uploads log messages to a log group of Amazon CloudWatch Logs.
+
+ Add it to `AWSDDLog` like any other logger:
+
+     AWSLogsLogger *logger = [[AWSLogsLogger alloc] initWithLogs:[AWSLogs defaultLogs]
+                                                    logGroupName:@"MyLogGroup"
+                                                   logStreamName:[[UIDevice currentDevice] identifierForVendor].UUIDString];
+     [AWSDDLog addLogger:logger withLevel:AWSDDLogLevelInfo];
+
+ The log messages are kept in memory and saved to a database on disk according to `saveThreshold` and `saveInterval`, so that they are not lost when the app is terminated or the device is offline. After each save, the saved log messages are uploaded with `PutLogEvents` in batches which are as large as CloudWatch Logs allows: up to 10,000 log events and 1,048,576 bytes, sorted by time and spanning less than 24 hours. Log events are saved compressed with gzip.
+
+ Each log stream has one upload in flight at a time, using the sequence token of the previous upload. When log messages go to several log streams (see `logStreamNameBlock`), up to `maximumConcurrentUploads` log streams are uploaded to at the same time. A log stream which does not exist yet is created.
+
+ When an upload is throttled or fails because the device is offline, the log stream waits before it is uploaded to again, twice as long after each failure up to 5 minutes. Log events which CloudWatch Logs rejects as invalid are deleted. While log events cannot be uploaded, the oldest of them are deleted when they take more than `diskByteLimit` bytes on disk, or when they are older than `maxAge`.
+
+ @warning The logger does not log its own errors through `AWSDDLog`. Do not add it to a log which `AWSLogs` also logs to with a level which includes `AWSDDLogFlagVerbose`, otherwise every upload logs messages which are uploaded again.
+ */
+@interface AWSLogsLogger : AWSDDAbstractDatabaseLogger <AWSDDLogger>
+
+- (instancetype)init NS_UNAVAILABLE;
+
+/**
+ Creates a logger which uploads log messages to a log stream.
+
+ @param logs          The service client used to upload the log events.
+ @param logGroupName  The name of the log group. It must exist.
+ @param logStreamName The name of the log stream. It is created if it does not exist.
+
+ @return A logger. Loggers of the same log group and log stream share the log events saved on disk.
+ */
+- (instancetype)initWithLogs:(AWSLogs *)logs
+                logGroupName:(NSString *)logGroupName
+               logStreamName:(NSString *)logStreamName NS_DESIGNATED_INITIALIZER;
+
+/**
+ The service client used to upload the log events.
+ */
+@property (nonatomic, strong, readonly) AWSLogs *logs;
+
+/**
+ The name of the log group.
+ */
+@property (nonatomic, strong, readonly) NSString *logGroupName;
+
+/**
+ The name of the log stream of the log messages for which `logStreamNameBlock` is `nil` or returns `nil`.
+ */
+@property (nonatomic, strong, readonly) NSString *logStreamName;
+
+/**
+ Returns the name of the log stream of a log message, e.g. to upload the log messages of different log contexts to different log streams. It is invoked on the logger queue, before the log message is saved. Set it before the logger is added.
+ */
+@property (atomic, copy, nullable) NSString * _Nullable (^logStreamNameBlock)(AWSDDLogMessage *logMessage);
+
+/**
+ The maximum number of log streams uploaded to at the same time. The default is 4.
+ */
+@property (atomic, assign) NSUInteger maximumConcurrentUploads;
+
+/**
+ The limit of the disk space used by the log events waiting to be uploaded. When exceeded, the oldest log events are deleted. Setting this value to 0 means no limit. The default is 5MB.
+ */
+@property (atomic, assign) NSUInteger diskByteLimit;
+
+/**
+ The number of bytes used on disk by the log events waiting to be uploaded.
+ */
+@property (nonatomic, assign, readonly) NSUInteger diskBytesUsed;
+
+/**
+ Saves the pending log messages, and uploads all saved log events.
+
+ @return A task which completes when there is nothing left to upload, or the log streams left to upload to are waiting after a failure. task.error is the last error of an upload, if any.
+ */
+- (AWSTask *)submitAllLogEvents;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,776 @@
+//
+// Copyright 2010-2021 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License.
+// A copy of the License is located at
+//
+// http://aws.amazon.com/apache2.0
+//
+// or in the "license" file accompanying this file. This file is distributed
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+//
+
+#import <CommonCrypto/CommonDigest.h>
+#import <libkern/OSByteOrder.h>
+#import "AWSLogsLogger.h"
+#import "AWSLogsService.h"
+
+// The logger must not log through AWSDDLog: it runs on its own logger queue, and would upload its own messages.
+#ifndef AWSDD_NSLOG_LEVEL
+    #define AWSDD_NSLOG_LEVEL 2
+#endif
+
+#define NSLogError(frmt, ...)    do{ if(AWSDD_NSLOG_LEVEL >= 1) NSLog((frmt), ##__VA_ARGS__); } while(0)
+#define NSLogWarn(frmt, ...)     do{ if(AWSDD_NSLOG_LEVEL >= 2) NSLog((frmt), ##__VA_ARGS__); } while(0)
+#define NSLogInfo(frmt, ...)     do{ if(AWSDD_NSLOG_LEVEL >= 3) NSLog((frmt), ##__VA_ARGS__); } while(0)
+
+NSUInteger const AWSLogsLoggerDiskByteLimitDefault = 5 * 1024 * 1024; // 5MB
+NSUInteger const AWSLogsLoggerMaximumConcurrentUploadsDefault = 4;
+
+static NSString *const AWSLogsLoggerDatabasePathPrefix = @"com/amazonaws/AWSLogsLogger";
+
+// The limits of a PutLogEvents request.
+static const NSUInteger AWSLogsLoggerBatchEventCountLimit = 10000;
+static const NSUInteger AWSLogsLoggerBatchByteLimit = 1048576;
+static const NSUInteger AWSLogsLoggerEventOverheadByteCount = 26;
+static const int64_t AWSLogsLoggerBatchTimeSpanLimit = 24 * 60 * 60 * 1000; // 24 hours in milliseconds
+static const NSUInteger AWSLogsLoggerEventByteLimit = 256 * 1024 - 26;
+
+// The number of bytes of free pages of the database above which they are released to the file system.
+static const long AWSLogsLoggerFreeByteCountLimit = 256 * 1024;
+
+// A log stream accepts 5 requests per second.
+static const NSTimeInterval AWSLogsLoggerMinimumUploadInterval = 0.2;
+static const NSTimeInterval AWSLogsLoggerMinimumRetryInterval = 1.0;
+static const NSTimeInterval AWSLogsLoggerMaximumRetryInterval = 5 * 60;
+
+#pragma mark - AWSLogsLoggerChunk
+
+/**
+ Log events of a log stream, encoded one after the other as a little-endian 64-bit timestamp in milliseconds, a little-endian 32-bit length, and the UTF-8 bytes of the message. The events of a chunk fit in one PutLogEvents request.
+ */
+@interface AWSLogsLoggerChunk : NSObject
+
+@property (nonatomic, strong, readonly) NSString *logStreamName;
+@property (nonatomic, strong, readonly) NSMutableData *data;
+@property (nonatomic, assign, readonly) NSUInteger eventCount;
+@property (nonatomic, assign, readonly) NSUInteger byteCount;
+@property (nonatomic, assign, readonly) int64_t firstTimestamp;
+@property (nonatomic, assign, readonly) int64_t lastTimestamp;
+
+- (instancetype)initWithLogStreamName:(NSString *)logStreamName;
+
+- (BOOL)canAppendEventWithTimestamp:(int64_t)timestamp length:(NSUInteger)length;
+
+- (void)appendEventWithTimestamp:(int64_t)timestamp bytes:(const void *)bytes length:(NSUInteger)length;
+
++ (NSArray<AWSLogsInputLogEvent *> *)logEventsFromData:(NSData *)data;
+
+@end
+
+@implementation AWSLogsLoggerChunk
+
+- (instancetype)initWithLogStreamName:(NSString *)logStreamName {
+    if (self = [super init]) {
+        _logStreamName = logStreamName;
+        _data = [NSMutableData new];
+    }
+    return self;
+}
+
+- (BOOL)canAppendEventWithTimestamp:(int64_t)timestamp length:(NSUInteger)length {
+    if (_eventCount == 0) {
+        return YES;
+    }
+    return _eventCount < AWSLogsLoggerBatchEventCountLimit
+    && _byteCount + length + AWSLogsLoggerEventOverheadByteCount <= AWSLogsLoggerBatchByteLimit
+    && MAX(_lastTimestamp, timestamp) - MIN(_firstTimestamp, timestamp) < AWSLogsLoggerBatchTimeSpanLimit;
+}
+
+- (void)appendEventWithTimestamp:(int64_t)timestamp bytes:(const void *)bytes length:(NSUInteger)length {
+    uint64_t littleEndianTimestamp = OSSwapHostToLittleInt64((uint64_t)timestamp);
+    uint32_t littleEndianLength = OSSwapHostToLittleInt32((uint32_t)length);
+    [_data appendBytes:&littleEndianTimestamp length:sizeof(littleEndianTimestamp)];
+    [_data appendBytes:&littleEndianLength length:sizeof(littleEndianLength)];
+    [_data appendBytes:bytes length:length];
+
+    _firstTimestamp = _eventCount == 0 ? timestamp : MIN(_firstTimestamp, timestamp);
+    _lastTimestamp = _eventCount == 0 ? timestamp : MAX(_lastTimestamp, timestamp);
+    _eventCount++;
+    _byteCount += length + AWSLogsLoggerEventOverheadByteCount;
+}
+
++ (NSArray<AWSLogsInputLogEvent *> *)logEventsFromData:(NSData *)data {
+    NSMutableArray<AWSLogsInputLogEvent *> *logEvents = [NSMutableArray new];
+    const uint8_t *bytes = [data bytes];
+    NSUInteger length = [data length];
+    NSUInteger offset = 0;
+    while (offset < length) {
+        uint64_t littleEndianTimestamp;
+        uint32_t littleEndianLength;
+        if (length - offset < sizeof(littleEndianTimestamp) + sizeof(littleEndianLength)) {
+            return nil;
+        }
+        memcpy(&littleEndianTimestamp, bytes + offset, sizeof(littleEndianTimestamp));
+        offset += sizeof(littleEndianTimestamp);
+        memcpy(&littleEndianLength, bytes + offset, sizeof(littleEndianLength));
+        offset += sizeof(littleEndianLength);
+
+        uint32_t messageLength = OSSwapLittleToHostInt32(littleEndianLength);
+        if (length - offset < messageLength) {
+            return nil;
+        }
+        NSString *message = [[NSString alloc] initWithBytes:bytes + offset
+                                                     length:messageLength
+                                                   encoding:NSUTF8StringEncoding];
+        offset += messageLength;
+        if (!message) {
+            return nil;
+        }
+
+        AWSLogsInputLogEvent *logEvent = [AWSLogsInputLogEvent new];
+        logEvent.message = message;
+        logEvent.timestamp = @((int64_t)OSSwapLittleToHostInt64(littleEndianTimestamp));
+        [logEvents addObject:logEvent];
+    }
+    return logEvents;
+}
+
+@end
+
+#pragma mark - AWSLogsLoggerStream
+
+// The upload state of a log stream. Accessed on the logger queue only.
+@interface AWSLogsLoggerStream : NSObject
+
+@property (nonatomic, strong) NSString *name;
+@property (nonatomic, strong) NSString *sequenceToken;
+@property (nonatomic, assign, getter=isUploading) BOOL uploading;
+@property (nonatomic, assign) NSUInteger failureCount;
+@property (nonatomic, assign) CFAbsoluteTime nextUploadTime;
+@property (nonatomic, assign) BOOL createdLogStream;
+
+@end
+
+@implementation AWSLogsLoggerStream
+
+@end
+
+#pragma mark - AWSLogsLogger
+
+@interface AWSLogsLogger() {
+    NSMutableDictionary<NSString *, AWSLogsLoggerChunk *> *_currentChunks;
+    NSMutableArray<AWSLogsLoggerChunk *> *_unsavedChunks;
+    NSMutableDictionary<NSString *, AWSLogsLoggerStream *> *_streams;
+    NSUInteger _uploadCount;
+    NSError *_lastUploadError;
+    NSMutableArray<AWSTaskCompletionSource *> *_submitTaskCompletionSources;
+    dispatch_source_t _uploadTimer;
+    CFAbsoluteTime _uploadTimerFireTime;
+}
+
+@property (nonatomic, strong) AWSFMDatabaseQueue *databaseQueue;
+
+@end
+
+@implementation AWSLogsLogger
+
+- (instancetype)initWithLogs:(AWSLogs *)logs
+                logGroupName:(NSString *)logGroupName
+               logStreamName:(NSString *)logStreamName {
+    if (self = [super init]) {
+        _logs = logs;
+        _logGroupName = [logGroupName copy];
+        _logStreamName = [logStreamName copy];
+        _maximumConcurrentUploads = AWSLogsLoggerMaximumConcurrentUploadsDefault;
+        _diskByteLimit = AWSLogsLoggerDiskByteLimitDefault;
+
+        _currentChunks = [NSMutableDictionary new];
+        _unsavedChunks = [NSMutableArray new];
+        _streams = [NSMutableDictionary new];
+        _submitTaskCompletionSources = [NSMutableArray new];
+
+        NSString *databaseDirectoryPath = [NSTemporaryDirectory() stringByAppendingPathComponent:AWSLogsLoggerDatabasePathPrefix];
+        NSError *error = nil;
+        if (![[NSFileManager defaultManager] createDirectoryAtPath:databaseDirectoryPath
+                                       withIntermediateDirectories:YES
+                                                        attributes:nil
+                                                             error:&error]) {
+            NSLogError(@"AWSLogsLogger: Failed to create a directory for database. [%@]", error);
+        }
+
+        NSString *identifier = [NSString stringWithFormat:@"%@/%@", _logGroupName, _logStreamName];
+        NSString *databasePath = [databaseDirectoryPath stringByAppendingPathComponent:[AWSLogsLogger sha256FromString:identifier]];
+        _databaseQueue = [AWSFMDatabaseQueue storeDatabaseQueueWithPath:databasePath];
+        [_databaseQueue inDatabase:^(AWSFMDatabase *db) {
+            if (![db executeUpdate:
+                  @"CREATE TABLE IF NOT EXISTS log_event_chunk ("
+                  @"id INTEGER PRIMARY KEY AUTOINCREMENT,"
+                  @"log_stream_name TEXT NOT NULL,"
+                  @"first_timestamp INTEGER NOT NULL,"
+                  @"last_timestamp INTEGER NOT NULL,"
+                  @"event_count INTEGER NOT NULL,"
+                  @"byte_count INTEGER NOT NULL,"
+                  @"data BLOB NOT NULL)"]) {
+                NSLogError(@"AWSLogsLogger: SQLite error. [%@]", db.lastError);
+            }
+
+            if (![db executeUpdate:@"CREATE INDEX IF NOT EXISTS log_event_chunk_log_stream_name ON log_event_chunk (log_stream_name)"]) {
+                NSLogError(@"AWSLogsLogger: SQLite error. [%@]", db.lastError);
+            }
+
+            if (![db executeUpdate:
+                  @"CREATE TABLE IF NOT EXISTS log_stream ("
+                  @"log_stream_name TEXT PRIMARY KEY NOT NULL,"
+                  @"sequence_token TEXT NOT NULL)"]) {
+                NSLogError(@"AWSLogsLogger: SQLite error. [%@]", db.lastError);
+            }
+        }];
+    }
+    return self;
+}
+
+- (void)dealloc {
+    if (_uploadTimer) {
+        dispatch_source_cancel(_uploadTimer);
+    }
+}
+
+- (NSString *)loggerName {
+    return @"com.amazonaws.AWSLogsLogger";
+}
+
++ (NSString *)sha256FromString:(NSString *)string {
+    NSData *data = [string dataUsingEncoding:NSUTF8StringEncoding];
+    unsigned char digest[CC_SHA256_DIGEST_LENGTH];
+    CC_SHA256([data bytes], (CC_LONG)[data length], digest);
+
+    NSMutableString *hexString = [NSMutableString stringWithCapacity:CC_SHA256_DIGEST_LENGTH * 2];
+    for (int i = 0; i < CC_SHA256_DIGEST_LENGTH; i++) {
+        [hexString appendFormat:@"%02x", digest[i]];
+    }
+    return hexString;
+}
+
+- (NSUInteger)diskBytesUsed {
+    __block NSUInteger diskBytesUsed = 0;
+    [self.databaseQueue inDatabase:^(AWSFMDatabase *db) {
+        AWSFMResultSet *rs = [db executeQuery:@"SELECT SUM(LENGTH(data)) FROM log_event_chunk"];
+        if ([rs next]) {
+            diskBytesUsed = (NSUInteger)[rs unsignedLongLongIntForColumnIndex:0];
+        }
+        [rs close];
+    }];
+    return diskBytesUsed;
+}
+
+#pragma mark - AWSDDAbstractDatabaseLogger
+
+- (BOOL)db_log:(AWSDDLogMessage *)logMessage {
+    NSString *message = _logFormatter ? [_logFormatter formatLogMessage:logMessage] : logMessage->_message;
+    if ([message length] == 0) {
+        return NO;
+    }
+
+    NSString *logStreamName = nil;
+    NSString * (^logStreamNameBlock)(AWSDDLogMessage *) = self.logStreamNameBlock;
+    if (logStreamNameBlock) {
+        logStreamName = logStreamNameBlock(logMessage);
+    }
+    if (!logStreamName) {
+        logStreamName = _logStreamName;
+    }
+
+    // Truncates the message to the size limit of a log event, on a character boundary.
+    NSData *messageData = [message dataUsingEncoding:NSUTF8StringEncoding];
+    const uint8_t *bytes = [messageData bytes];
+    NSUInteger length = [messageData length];
+    if (length > AWSLogsLoggerEventByteLimit) {
+        length = AWSLogsLoggerEventByteLimit;
+        while (length > 0 && (bytes[length] & 0xC0) == 0x80) {
+            length--;
+        }
+    }
+
+    int64_t timestamp = (int64_t)llround([logMessage->_timestamp timeIntervalSince1970] * 1000);
+
+    AWSLogsLoggerChunk *chunk = _currentChunks[logStreamName];
+    if (chunk && ![chunk canAppendEventWithTimestamp:timestamp length:length]) {
+        [_unsavedChunks addObject:chunk];
+        chunk = nil;
+    }
+    if (!chunk) {
+        chunk = [[AWSLogsLoggerChunk alloc] initWithLogStreamName:logStreamName];
+        _currentChunks[logStreamName] = chunk;
+    }
+    [chunk appendEventWithTimestamp:timestamp bytes:bytes length:length];
+
+    return YES;
+}
+
+- (void)db_save {
+    [self saveChunks];
+    [self scheduleUploads];
+}
+
+- (void)db_delete {
+    [self deleteExpiredChunks];
+}
+
+- (void)db_saveAndDelete {
+    [self saveChunks];
+    [self deleteExpiredChunks];
+    [self scheduleUploads];
+}
+
+- (void)didAddLogger {
+    [super didAddLogger];
+
+    // Uploads the log events saved before the app was last terminated.
+    [self scheduleUploads];
+}
+
+#pragma mark - Database
+
+- (void)saveChunks {
+    [_unsavedChunks addObjectsFromArray:[_currentChunks allValues]];
+    [_currentChunks removeAllObjects];
+    if ([_unsavedChunks count] == 0) {
+        return;
+    }
+
+    NSArray<AWSLogsLoggerChunk *> *chunks = [_unsavedChunks copy];
+    [_unsavedChunks removeAllObjects];
+
+    NSMutableArray<NSData *> *compressedData = [NSMutableArray arrayWithCapacity:[chunks count]];
+    for (AWSLogsLoggerChunk *chunk in chunks) {
+        [compressedData addObject:[chunk.data awsgzip_gzippedData]];
+    }
+
+    NSUInteger diskByteLimit = self.diskByteLimit;
+    [self.databaseQueue inTransaction:^(AWSFMDatabase *db, BOOL *rollback) {
+        for (NSUInteger i = 0; i < [chunks count]; i++) {
+            AWSLogsLoggerChunk *chunk = chunks[i];
+            if (![db executeUpdate:@"INSERT INTO log_event_chunk (log_stream_name, first_timestamp, last_timestamp, event_count, byte_count, data) VALUES (?, ?, ?, ?, ?, ?)",
+                  chunk.logStreamName, @(chunk.firstTimestamp), @(chunk.lastTimestamp), @(chunk.eventCount), @(chunk.byteCount), compressedData[i]]) {
+                NSLogError(@"AWSLogsLogger: SQLite error. Rolling back... [%@]", db.lastError);
+                *rollback = YES;
+                return;
+            }
+        }
+
+        if (diskByteLimit == 0) {
+            return;
+        }
+
+        // Deletes the oldest chunks which do not fit in the disk byte limit.
+        NSNumber *lastDeletedChunkId = nil;
+        NSUInteger diskBytesUsed = 0;
+        AWSFMResultSet *rs = [db executeQuery:@"SELECT id, LENGTH(data) FROM log_event_chunk ORDER BY id DESC"];
+        while ([rs next]) {
+            diskBytesUsed += (NSUInteger)[rs unsignedLongLongIntForColumnIndex:1];
+            if (diskBytesUsed > diskByteLimit) {
+                lastDeletedChunkId = @([rs longLongIntForColumnIndex:0]);
+                break;
+            }
+        }
+        [rs close];
+
+        if (lastDeletedChunkId) {
+            NSLogWarn(@"AWSLogsLogger: The log events waiting to be uploaded exceed the disk byte limit. Deleting the oldest log events.");
+            if (![db executeUpdate:@"DELETE FROM log_event_chunk WHERE id <= ?", lastDeletedChunkId]) {
+                NSLogError(@"AWSLogsLogger: SQLite error. [%@]", db.lastError);
+            }
+            [AWSLogsLogger releaseFreePagesOfDatabase:db];
+        }
+    }];
+}
+
+// Releases the free pages like -[AWSFMDatabase aws_releaseFreePagesIfNeeded], without logging through AWSDDLog.
++ (void)releaseFreePagesOfDatabase:(AWSFMDatabase *)db {
+    if ([db longForQuery:@"PRAGMA freelist_count"] * [db longForQuery:@"PRAGMA page_size"] <= AWSLogsLoggerFreeByteCountLimit) {
+        return;
+    }
+    if (![db executeStatements:@"PRAGMA incremental_vacuum"]) {
+        NSLogError(@"AWSLogsLogger: SQLite error. [%@]", db.lastError);
+    }
+}
+
+- (void)deleteExpiredChunks {
+    if (_maxAge <= 0.0) {
+        return;
+    }
+
+    int64_t oldestTimestamp = (int64_t)(([[NSDate date] timeIntervalSince1970] - _maxAge) * 1000);
+    [self.databaseQueue inDatabase:^(AWSFMDatabase *db) {
+        if (![db executeUpdate:@"DELETE FROM log_event_chunk WHERE last_timestamp < ?", @(oldestTimestamp)]) {
+            NSLogError(@"AWSLogsLogger: SQLite error. [%@]", db.lastError);
+        }
+        [AWSLogsLogger releaseFreePagesOfDatabase:db];
+    }];
+}
+
+- (void)deleteChunksWithIds:(NSArray<NSNumber *> *)chunkIds {
+    if ([chunkIds count] == 0) {
+        return;
+    }
+
+    NSString *statement = [NSString stringWithFormat:@"DELETE FROM log_event_chunk WHERE id IN (%@)", [chunkIds componentsJoinedByString:@","]];
+    [self.databaseQueue inDatabase:^(AWSFMDatabase *db) {
+        if (![db executeUpdate:statement]) {
+            NSLogError(@"AWSLogsLogger: SQLite error. [%@]", db.lastError);
+        }
+        [AWSLogsLogger releaseFreePagesOfDatabase:db];
+    }];
+}
+
+// The names of the log streams with log events to upload, the stream with the oldest log events first.
+- (NSArray<NSString *> *)pendingLogStreamNames {
+    NSMutableArray<NSString *> *logStreamNames = [NSMutableArray new];
+    [self.databaseQueue inDatabase:^(AWSFMDatabase *db) {
+        AWSFMResultSet *rs = [db executeQuery:@"SELECT log_stream_name, MIN(id) AS oldest FROM log_event_chunk GROUP BY log_stream_name ORDER BY oldest"];
+        while ([rs next]) {
+            [logStreamNames addObject:[rs stringForColumnIndex:0]];
+        }
+        [rs close];
+    }];
+    return logStreamNames;
+}
+
+// Reads the oldest chunks of a log stream which fit in one PutLogEvents request.
+- (NSArray<AWSLogsInputLogEvent *> *)logEventsForLogStreamName:(NSString *)logStreamName
+                                                      chunkIds:(NSMutableArray<NSNumber *> *)chunkIds {
+    NSMutableArray<AWSLogsInputLogEvent *> *logEvents = [NSMutableArray new];
+    NSMutableArray<NSNumber *> *corruptChunkIds = [NSMutableArray new];
+    [self.databaseQueue inDatabase:^(AWSFMDatabase *db) {
+        NSUInteger eventCount = 0;
+        NSUInteger byteCount = 0;
+        int64_t firstTimestamp = 0;
+        int64_t lastTimestamp = 0;
+
+        AWSFMResultSet *rs = [db executeQuery:@"SELECT id, first_timestamp, last_timestamp, event_count, byte_count, data FROM log_event_chunk WHERE log_stream_name = ? ORDER BY id", logStreamName];
+        while ([rs next]) {
+            int64_t chunkFirstTimestamp = [rs longLongIntForColumnIndex:1];
+            int64_t chunkLastTimestamp = [rs longLongIntForColumnIndex:2];
+            NSUInteger chunkEventCount = (NSUInteger)[rs unsignedLongLongIntForColumnIndex:3];
+            NSUInteger chunkByteCount = (NSUInteger)[rs unsignedLongLongIntForColumnIndex:4];
+            if ([chunkIds count] > 0
+                && (eventCount + chunkEventCount > AWSLogsLoggerBatchEventCountLimit
+                    || byteCount + chunkByteCount > AWSLogsLoggerBatchByteLimit
+                    || MAX(lastTimestamp, chunkLastTimestamp) - MIN(firstTimestamp, chunkFirstTimestamp) >= AWSLogsLoggerBatchTimeSpanLimit)) {
+                break;
+            }
+
+            NSNumber *chunkId = @([rs longLongIntForColumnIndex:0]);
+            NSArray<AWSLogsInputLogEvent *> *chunkLogEvents = [AWSLogsLoggerChunk logEventsFromData:[[rs dataForColumnIndex:5] awsgzip_gunzippedData]];
+            if (!chunkLogEvents) {
+                [corruptChunkIds addObject:chunkId];
+                continue;
+            }
+
+            firstTimestamp = [chunkIds count] == 0 ? chunkFirstTimestamp : MIN(firstTimestamp, chunkFirstTimestamp);
+            lastTimestamp = [chunkIds count] == 0 ? chunkLastTimestamp : MAX(lastTimestamp, chunkLastTimestamp);
+            eventCount += chunkEventCount;
+            byteCount += chunkByteCount;
+            [chunkIds addObject:chunkId];
+            [logEvents addObjectsFromArray:chunkLogEvents];
+        }
+        [rs close];
+    }];
+
+    if ([corruptChunkIds count] > 0) {
+        NSLogError(@"AWSLogsLogger: Deleting %lu unreadable chunks of log events.", (unsigned long)[corruptChunkIds count]);
+        [self deleteChunksWithIds:corruptChunkIds];
+    }
+
+    // The log events of a request must be in chronological order.
+    return [logEvents sortedArrayWithOptions:NSSortStable usingComparator:^NSComparisonResult(AWSLogsInputLogEvent *event1, AWSLogsInputLogEvent *event2) {
+        return [event1.timestamp compare:event2.timestamp];
+    }];
+}
+
+#pragma mark - Uploading
+
+- (AWSTask *)submitAllLogEvents {
+    AWSTaskCompletionSource *taskCompletionSource = [AWSTaskCompletionSource taskCompletionSource];
+    dispatch_async(self.loggerQueue, ^{
+        [self->_submitTaskCompletionSources addObject:taskCompletionSource];
+        [self savePendingLogEntries];
+        [self scheduleUploads];
+    });
+    return taskCompletionSource.task;
+}
+
+- (AWSLogsLoggerStream *)streamNamed:(NSString *)logStreamName {
+    AWSLogsLoggerStream *stream = _streams[logStreamName];
+    if (!stream) {
+        stream = [AWSLogsLoggerStream new];
+        stream.name = logStreamName;
+        // Picks up the sequence token saved when the stream was last evicted.
+        [self.databaseQueue inDatabase:^(AWSFMDatabase *db) {
+            stream.sequenceToken = [db stringForQuery:@"SELECT sequence_token FROM log_stream WHERE log_stream_name = ?", logStreamName];
+        }];
+        _streams[logStreamName] = stream;
+    }
+    return stream;
+}
+
+// Saves the sequence tokens of the streams which have nothing left to upload and are not waiting, and forgets them,
+// so that a logger writing to many log streams over time does not keep the state of each of them.
+- (void)evictStreamsExceptNamed:(NSSet<NSString *> *)pendingLogStreamNames now:(CFAbsoluteTime)now {
+    NSMutableArray<AWSLogsLoggerStream *> *idleStreams = [NSMutableArray new];
+    for (AWSLogsLoggerStream *stream in [_streams allValues]) {
+        if (!stream.isUploading && stream.nextUploadTime <= now && ![pendingLogStreamNames containsObject:stream.name]) {
+            [idleStreams addObject:stream];
+        }
+    }
+    if ([idleStreams count] == 0) {
+        return;
+    }
+
+    __block BOOL saved = YES;
+    [self.databaseQueue inTransaction:^(AWSFMDatabase *db, BOOL *rollback) {
+        for (AWSLogsLoggerStream *stream in idleStreams) {
+            BOOL result = stream.sequenceToken
+            ? [db executeUpdate:@"INSERT OR REPLACE INTO log_stream (log_stream_name, sequence_token) VALUES (?, ?)", stream.name, stream.sequenceToken]
+            : [db executeUpdate:@"DELETE FROM log_stream WHERE log_stream_name = ?", stream.name];
+            if (!result) {
+                NSLogError(@"AWSLogsLogger: SQLite error. Rolling back... [%@]", db.lastError);
+                saved = NO;
+                *rollback = YES;
+                return;
+            }
+        }
+    }];
+
+    // Keeps the streams whose sequence tokens could not be saved.
+    if (saved) {
+        for (AWSLogsLoggerStream *stream in idleStreams) {
+            [_streams removeObjectForKey:stream.name];
+        }
+    }
+}
+
+// Starts uploading to the log streams which are not waiting, and arms the upload timer for those which are.
+- (void)scheduleUploads {
+    NSAssert([self isOnInternalLoggerQueue], @"scheduleUploads must be invoked on the logger queue.");
+
+    NSUInteger maximumConcurrentUploads = MAX(self.maximumConcurrentUploads, (NSUInteger)1);
+    CFAbsoluteTime now = CFAbsoluteTimeGetCurrent();
+    CFAbsoluteTime nextUploadTime = 0;
+    BOOL waitingWithoutFailure = NO;
+
+    NSArray<NSString *> *pendingLogStreamNames = [self pendingLogStreamNames];
+    for (NSString *logStreamName in pendingLogStreamNames) {
+        AWSLogsLoggerStream *stream = [self streamNamed:logStreamName];
+        if (stream.isUploading) {
+            continue;
+        }
+        if (stream.nextUploadTime > now) {
+            nextUploadTime = nextUploadTime == 0 ? stream.nextUploadTime : MIN(nextUploadTime, stream.nextUploadTime);
+            waitingWithoutFailure = waitingWithoutFailure || stream.failureCount == 0;
+            continue;
+        }
+        if (_uploadCount >= maximumConcurrentUploads) {
+            waitingWithoutFailure = YES;
+            continue;
+        }
+        [self uploadStream:stream];
+    }
+
+    [self evictStreamsExceptNamed:[NSSet setWithArray:pendingLogStreamNames] now:now];
+
+    if (nextUploadTime > 0) {
+        [self scheduleUploadTimerAtTime:nextUploadTime];
+    }
+
+    if (_uploadCount == 0 && !waitingWithoutFailure) {
+        [self completeSubmitTasks];
+    }
+}
+
+- (void)scheduleUploadTimerAtTime:(CFAbsoluteTime)fireTime {
+    if (!_uploadTimer) {
+        _uploadTimer = dispatch_source_create(DISPATCH_SOURCE_TYPE_TIMER, 0, 0, self.loggerQueue);
+
+        __weak AWSLogsLogger *weakSelf = self;
+        dispatch_source_set_event_handler(_uploadTimer, ^{ @autoreleasepool {
+            AWSLogsLogger *strongSelf = weakSelf;
+            if (strongSelf) {
+                strongSelf->_uploadTimerFireTime = 0;
+                [strongSelf scheduleUploads];
+            }
+        } });
+        dispatch_source_set_timer(_uploadTimer, DISPATCH_TIME_FOREVER, DISPATCH_TIME_FOREVER, 0);
+        dispatch_resume(_uploadTimer);
+    }
+
+    if (_uploadTimerFireTime > 0 && _uploadTimerFireTime <= fireTime) {
+        return;
+    }
+    _uploadTimerFireTime = fireTime;
+
+    NSTimeInterval delay = MAX(fireTime - CFAbsoluteTimeGetCurrent(), 0);
+    dispatch_source_set_timer(_uploadTimer,
+                              dispatch_time(DISPATCH_TIME_NOW, (int64_t)(delay * NSEC_PER_SEC)),
+                              DISPATCH_TIME_FOREVER,
+                              (uint64_t)(0.05 * NSEC_PER_SEC));
+}
+
+- (void)completeSubmitTasks {
+    if ([_submitTaskCompletionSources count] == 0) {
+        return;
+    }
+
+    NSArray<AWSTaskCompletionSource *> *taskCompletionSources = [_submitTaskCompletionSources copy];
+    [_submitTaskCompletionSources removeAllObjects];
+    NSError *error = _lastUploadError;
+    _lastUploadError = nil;
+
+    for (AWSTaskCompletionSource *taskCompletionSource in taskCompletionSources) {
+        if (error) {
+            [taskCompletionSource setError:error];
+        } else {
+            [taskCompletionSource setResult:nil];
+        }
+    }
+}
+
+- (void)uploadStream:(AWSLogsLoggerStream *)stream {
+    NSMutableArray<NSNumber *> *chunkIds = [NSMutableArray new];
+    NSArray<AWSLogsInputLogEvent *> *logEvents = [self logEventsForLogStreamName:stream.name chunkIds:chunkIds];
+    if ([logEvents count] == 0) {
+        return;
+    }
+
+    stream.uploading = YES;
+    stream.nextUploadTime = CFAbsoluteTimeGetCurrent() + AWSLogsLoggerMinimumUploadInterval;
+    _uploadCount++;
+
+    AWSLogsPutLogEventsRequest *request = [AWSLogsPutLogEventsRequest new];
+    request.logGroupName = self.logGroupName;
+    request.logStreamName = stream.name;
+    request.logEvents = logEvents;
+    request.sequenceToken = stream.sequenceToken;
+
+    [[self.logs putLogEvents:request] continueWithBlock:^id(AWSTask<AWSLogsPutLogEventsResponse *> *task) {
+        dispatch_async(self.loggerQueue, ^{ @autoreleasepool {
+            [self stream:stream didUploadChunksWithIds:chunkIds task:task];
+        } });
+        return nil;
+    }];
+}
+
+- (void)stream:(AWSLogsLoggerStream *)stream didUploadChunksWithIds:(NSArray<NSNumber *> *)chunkIds task:(AWSTask<AWSLogsPutLogEventsResponse *> *)task {
+    stream.uploading = NO;
+    _uploadCount--;
+
+    NSError *error = task.error;
+    if (!error) {
+        AWSLogsPutLogEventsResponse *response = task.result;
+        stream.sequenceToken = response.nextSequenceToken;
+        stream.failureCount = 0;
+        stream.createdLogStream = NO;
+        AWSLogsRejectedLogEventsInfo *rejectedLogEventsInfo = response.rejectedLogEventsInfo;
+        if (rejectedLogEventsInfo) {
+            NSLogWarn(@"AWSLogsLogger: Some log events were rejected. tooNewLogEventStartIndex: %@ tooOldLogEventEndIndex: %@ expiredLogEventEndIndex: %@",
+                      rejectedLogEventsInfo.tooNewLogEventStartIndex,
+                      rejectedLogEventsInfo.tooOldLogEventEndIndex,
+                      rejectedLogEventsInfo.expiredLogEventEndIndex);
+        }
+        [self deleteChunksWithIds:chunkIds];
+        [self scheduleUploads];
+        return;
+    }
+
+    if ([error.domain isEqualToString:AWSLogsErrorDomain]) {
+        NSString *expectedSequenceToken = error.userInfo[@"expectedSequenceToken"];
+        if (![expectedSequenceToken isKindOfClass:[NSString class]]) {
+            expectedSequenceToken = nil;
+        }
+
+        switch (error.code) {
+            case AWSLogsErrorDataAlreadyAccepted:
+                stream.sequenceToken = expectedSequenceToken;
+                stream.failureCount = 0;
+                [self deleteChunksWithIds:chunkIds];
+                [self scheduleUploads];
+                return;
+
+            case AWSLogsErrorInvalidSequenceToken:
+                // Retries right away with the expected sequence token, unless it was the one just used.
+                if (expectedSequenceToken != stream.sequenceToken && ![expectedSequenceToken isEqualToString:stream.sequenceToken]) {
+                    stream.sequenceToken = expectedSequenceToken;
+                    [self scheduleUploads];
+                    return;
+                }
+                break;
+
+            case AWSLogsErrorResourceNotFound:
+                if (!stream.createdLogStream) {
+                    [self createLogStream:stream];
+                    return;
+                }
+                break;
+
+            case AWSLogsErrorInvalidParameter:
+                NSLogError(@"AWSLogsLogger: Deleting %lu chunks of log events rejected by the service. [%@]", (unsigned long)[chunkIds count], error);
+                _lastUploadError = error;
+                stream.failureCount = 0;
+                [self deleteChunksWithIds:chunkIds];
+                [self scheduleUploads];
+                return;
+
+            default:
+                break;
+        }
+    }
+
+    [self stream:stream didFailWithError:error];
+}
+
+- (void)stream:(AWSLogsLoggerStream *)stream didFailWithError:(NSError *)error {
+    // Waits twice as long after each failure, with jitter so that log streams do not retry in lockstep.
+    stream.failureCount++;
+    NSTimeInterval delay = MIN(AWSLogsLoggerMinimumRetryInterval * pow(2, MIN(stream.failureCount - 1, (NSUInteger)16)), AWSLogsLoggerMaximumRetryInterval);
+    delay = delay / 2 + delay / 2 * ((double)arc4random_uniform(1000) / 1000);
+    stream.nextUploadTime = CFAbsoluteTimeGetCurrent() + delay;
+    _lastUploadError = error;
+
+    NSLogInfo(@"AWSLogsLogger: Failed to upload to log stream %@. Retrying in %.1f seconds. [%@]", stream.name, delay, error);
+    [self scheduleUploads];
+}
+
+- (void)createLogStream:(AWSLogsLoggerStream *)stream {
+    stream.uploading = YES;
+    stream.createdLogStream = YES;
+    _uploadCount++;
+
+    AWSLogsCreateLogStreamRequest *request = [AWSLogsCreateLogStreamRequest new];
+    request.logGroupName = self.logGroupName;
+    request.logStreamName = stream.name;
+
+    [[self.logs createLogStream:request] continueWithBlock:^id(AWSTask *task) {
+        dispatch_async(self.loggerQueue, ^{ @autoreleasepool {
+            stream.uploading = NO;
+            self->_uploadCount--;
+
+            NSError *error = task.error;
+            if (error && !([error.domain isEqualToString:AWSLogsErrorDomain] && error.code == AWSLogsErrorResourceAlreadyExists)) {
+                // Tries to create the log stream again after waiting.
+                stream.createdLogStream = NO;
+                [self stream:stream didFailWithError:error];
+                return;
+            }
+
+            stream.sequenceToken = nil;
+            [self scheduleUploads];
+        } });
+        return nil;
+    }];
+}
+
+@end
@@ -0,0 +1,420 @@
+//
+// Copyright 2010-2021 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License.
+// A copy of the License is located at
+//
+// http://aws.amazon.com/apache2.0
+//
+// or in the "license" file accompanying this file. This file is distributed
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+//
+
+#import <XCTest/XCTest.h>
+#import "AWSLogsService.h"
+#import "AWSLogsLogger.h"
+
+static const NSUInteger AWSLogsLoggerTestsIterations = 100000;
+
+#define AWSLogsLoggerTestsLog(log, ctx, frmt, ...) \
+    LOG_MACRO_TO_AWSDDLOG(log, YES, AWSDDLogLevelAll, AWSDDLogFlagInfo, ctx, nil, __PRETTY_FUNCTION__, frmt, ##__VA_ARGS__)
+
+@interface AWSLogs (AWSLogsLoggerTests)
+
+- (instancetype)initWithConfiguration:(AWSServiceConfiguration *)configuration;
+
+@end
+
+// Stands in for CloudWatch Logs: checks the requests against the service limits, and answers them after a latency.
+@interface AWSLogsLoggerTestsLogs : AWSLogs
+
+@property (nonatomic, assign) NSTimeInterval latency;
+@property (nonatomic, assign) NSUInteger throttledRequestCount;
+@property (nonatomic, assign) BOOL failsAllRequests;
+@property (nonatomic, assign) BOOL requiresLogStreamCreation;
+@property (nonatomic, strong) XCTestExpectation *expectation;
+@property (nonatomic, assign) NSUInteger expectedEventCount;
+
+@property (nonatomic, strong) NSMutableArray<AWSLogsPutLogEventsRequest *> *requests;
+@property (nonatomic, strong) NSMutableArray<NSString *> *nextSequenceTokens;
+@property (nonatomic, strong) NSMutableArray<NSString *> *violations;
+@property (nonatomic, strong) NSMutableSet<NSString *> *logStreamNames;
+@property (nonatomic, assign) NSUInteger eventCount;
+@property (nonatomic, assign) NSUInteger concurrentRequestCount;
+@property (nonatomic, assign) NSUInteger maximumConcurrentRequestCount;
+
+@end
+
+@implementation AWSLogsLoggerTestsLogs
+
+- (instancetype)init {
+    AWSServiceConfiguration *configuration = [[AWSServiceConfiguration alloc] initWithRegion:AWSRegionUSEast1
+                                                                         credentialsProvider:nil];
+    if (self = [super initWithConfiguration:configuration]) {
+        _requests = [NSMutableArray new];
+        _nextSequenceTokens = [NSMutableArray new];
+        _violations = [NSMutableArray new];
+        _logStreamNames = [NSMutableSet new];
+    }
+    return self;
+}
+
+- (AWSTask *)respondWithResult:(id)result error:(NSError *)error {
+    AWSTaskCompletionSource *taskCompletionSource = [AWSTaskCompletionSource taskCompletionSource];
+    dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(self.latency * NSEC_PER_SEC)), dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
+        @synchronized (self) {
+            self.concurrentRequestCount--;
+        }
+        if (error) {
+            [taskCompletionSource setError:error];
+        } else {
+            [taskCompletionSource setResult:result];
+        }
+    });
+    return taskCompletionSource.task;
+}
+
+- (AWSTask<AWSLogsPutLogEventsResponse *> *)putLogEvents:(AWSLogsPutLogEventsRequest *)request {
+    NSError *error = nil;
+    BOOL fulfill = NO;
+    @synchronized (self) {
+        self.concurrentRequestCount++;
+        self.maximumConcurrentRequestCount = MAX(self.maximumConcurrentRequestCount, self.concurrentRequestCount);
+
+        if (self.failsAllRequests) {
+            error = [NSError errorWithDomain:NSURLErrorDomain code:NSURLErrorNotConnectedToInternet userInfo:nil];
+        } else if (self.throttledRequestCount > 0) {
+            self.throttledRequestCount--;
+            error = [NSError errorWithDomain:AWSServiceErrorDomain code:AWSServiceErrorThrottlingException userInfo:nil];
+        } else if (self.requiresLogStreamCreation && ![self.logStreamNames containsObject:request.logStreamName]) {
+            error = [NSError errorWithDomain:AWSLogsErrorDomain code:AWSLogsErrorResourceNotFound userInfo:nil];
+        } else {
+            [self.requests addObject:request];
+            [self validateRequest:request];
+            self.eventCount += [request.logEvents count];
+            fulfill = self.expectedEventCount > 0 && self.eventCount == self.expectedEventCount;
+        }
+    }
+    if (fulfill) {
+        [self.expectation fulfill];
+    }
+
+    AWSLogsPutLogEventsResponse *response = [AWSLogsPutLogEventsResponse new];
+    response.nextSequenceToken = [[NSUUID UUID] UUIDString];
+    if (!error) {
+        @synchronized (self) {
+            [self.nextSequenceTokens addObject:response.nextSequenceToken];
+        }
+    }
+    return [self respondWithResult:error ? nil : response error:error];
+}
+
+- (AWSTask *)createLogStream:(AWSLogsCreateLogStreamRequest *)request {
+    @synchronized (self) {
+        self.concurrentRequestCount++;
+        [self.logStreamNames addObject:request.logStreamName];
+    }
+    return [self respondWithResult:nil error:nil];
+}
+
+- (void)validateRequest:(AWSLogsPutLogEventsRequest *)request {
+    if ([request.logEvents count] == 0 || [request.logEvents count] > 10000) {
+        [self.violations addObject:[NSString stringWithFormat:@"%lu log events", (unsigned long)[request.logEvents count]]];
+    }
+
+    NSUInteger byteCount = 0;
+    for (NSUInteger i = 0; i < [request.logEvents count]; i++) {
+        AWSLogsInputLogEvent *logEvent = request.logEvents[i];
+        byteCount += [logEvent.message lengthOfBytesUsingEncoding:NSUTF8StringEncoding] + 26;
+        if (i > 0 && [logEvent.timestamp longLongValue] < [request.logEvents[i - 1].timestamp longLongValue]) {
+            [self.violations addObject:@"log events out of chronological order"];
+        }
+    }
+    if (byteCount > 1048576) {
+        [self.violations addObject:[NSString stringWithFormat:@"%lu bytes", (unsigned long)byteCount]];
+    }
+
+    long long span = [[request.logEvents lastObject].timestamp longLongValue] - [[request.logEvents firstObject].timestamp longLongValue];
+    if (span >= 24 * 60 * 60 * 1000) {
+        [self.violations addObject:@"log events span 24 hours"];
+    }
+}
+
+@end
+
+@interface AWSLogsLoggerTests : XCTestCase
+
+@end
+
+@implementation AWSLogsLoggerTests
+
+- (AWSLogsLogger *)loggerWithLogs:(AWSLogs *)logs {
+    AWSLogsLogger *logger = [[AWSLogsLogger alloc] initWithLogs:logs
+                                                   logGroupName:@"AWSLogsLoggerTests"
+                                                  logStreamName:[[NSUUID UUID] UUIDString]];
+    // Saves the log messages when the log is flushed only, so that the batches are predictable.
+    logger.saveThreshold = 0;
+    logger.saveInterval = 0;
+    return logger;
+}
+
+- (void)testLogEventsAreUploadedInFullBatches {
+    AWSLogsLoggerTestsLogs *logs = [AWSLogsLoggerTestsLogs new];
+    AWSLogsLogger *logger = [self loggerWithLogs:logs];
+    AWSDDLog *log = [AWSDDLog new];
+    [log addLogger:logger];
+
+    for (NSUInteger i = 0; i < 25000; i++) {
+        AWSLogsLoggerTestsLog(log, 0, @"log event %lu", (unsigned long)i);
+    }
+    [log flushLog];
+
+    AWSTask *task = [logger submitAllLogEvents];
+    [task waitUntilFinished];
+    XCTAssertNil(task.error);
+
+    XCTAssertEqualObjects(logs.violations, @[]);
+    XCTAssertEqual([logs.requests count], 3);
+    XCTAssertEqual(logs.eventCount, 25000);
+    XCTAssertEqualObjects(logs.requests[0].logEvents[0].message, @"log event 0");
+    XCTAssertEqualObjects(logs.requests[0].logGroupName, @"AWSLogsLoggerTests");
+    XCTAssertEqualObjects(logs.requests[0].logStreamName, logger.logStreamName);
+    XCTAssertNil(logs.requests[0].sequenceToken);
+    XCTAssertNotNil(logs.requests[1].sequenceToken);
+    XCTAssertEqual(logger.diskBytesUsed, 0);
+
+    [log removeLogger:logger];
+}
+
+- (void)testLargeLogEventsAreSplitIntoBatchesOfOneMegabyte {
+    AWSLogsLoggerTestsLogs *logs = [AWSLogsLoggerTestsLogs new];
+    AWSLogsLogger *logger = [self loggerWithLogs:logs];
+    AWSDDLog *log = [AWSDDLog new];
+    [log addLogger:logger];
+
+    NSString *message = [@"" stringByPaddingToLength:100 * 1024 withString:@"a" startingAtIndex:0];
+    for (NSUInteger i = 0; i < 25; i++) {
+        AWSLogsLoggerTestsLog(log, 0, @"%@", message);
+    }
+    NSString *tooLargeMessage = [@"" stringByPaddingToLength:300 * 1024 withString:@"é" startingAtIndex:0];
+    AWSLogsLoggerTestsLog(log, 0, @"%@", tooLargeMessage);
+    [log flushLog];
+
+    AWSTask *task = [logger submitAllLogEvents];
+    [task waitUntilFinished];
+    XCTAssertNil(task.error);
+
+    XCTAssertEqualObjects(logs.violations, @[]);
+    XCTAssertEqual([logs.requests count], 3);
+    XCTAssertEqual(logs.eventCount, 26);
+    NSString *truncatedMessage = [[logs.requests lastObject].logEvents lastObject].message;
+    XCTAssertEqual([truncatedMessage lengthOfBytesUsingEncoding:NSUTF8StringEncoding], 256 * 1024 - 26);
+    XCTAssertTrue([tooLargeMessage hasPrefix:truncatedMessage]);
+
+    [log removeLogger:logger];
+}
+
+- (void)testThrottledUploadIsRetried {
+    AWSLogsLoggerTestsLogs *logs = [AWSLogsLoggerTestsLogs new];
+    logs.throttledRequestCount = 1;
+    logs.expectedEventCount = 100;
+    logs.expectation = [self expectationWithDescription:@"The log events are uploaded."];
+    AWSLogsLogger *logger = [self loggerWithLogs:logs];
+    AWSDDLog *log = [AWSDDLog new];
+    [log addLogger:logger];
+
+    for (NSUInteger i = 0; i < 100; i++) {
+        AWSLogsLoggerTestsLog(log, 0, @"log event %lu", (unsigned long)i);
+    }
+    [log flushLog];
+
+    AWSTask *task = [logger submitAllLogEvents];
+    [task waitUntilFinished];
+    XCTAssertEqualObjects(task.error.domain, AWSServiceErrorDomain);
+    XCTAssertEqual(task.error.code, AWSServiceErrorThrottlingException);
+    XCTAssertEqual([logs.requests count], 0);
+    XCTAssertGreaterThan(logger.diskBytesUsed, 0);
+
+    [self waitForExpectationsWithTimeout:10 handler:nil];
+    XCTAssertEqual([logs.requests count], 1);
+
+    [log removeLogger:logger];
+}
+
+- (void)testLogStreamIsCreated {
+    AWSLogsLoggerTestsLogs *logs = [AWSLogsLoggerTestsLogs new];
+    logs.requiresLogStreamCreation = YES;
+    AWSLogsLogger *logger = [self loggerWithLogs:logs];
+    AWSDDLog *log = [AWSDDLog new];
+    [log addLogger:logger];
+
+    AWSLogsLoggerTestsLog(log, 0, @"log event");
+    [log flushLog];
+
+    AWSTask *task = [logger submitAllLogEvents];
+    [task waitUntilFinished];
+    XCTAssertNil(task.error);
+    XCTAssertEqualObjects(logs.logStreamNames, [NSSet setWithObject:logger.logStreamName]);
+    XCTAssertEqual(logs.eventCount, 1);
+
+    [log removeLogger:logger];
+}
+
+- (void)testLogStreamsAreUploadedConcurrently {
+    AWSLogsLoggerTestsLogs *logs = [AWSLogsLoggerTestsLogs new];
+    logs.latency = 0.1;
+    AWSLogsLogger *logger = [self loggerWithLogs:logs];
+    logger.maximumConcurrentUploads = 3;
+    NSString *logStreamName = logger.logStreamName;
+    logger.logStreamNameBlock = ^NSString *(AWSDDLogMessage *logMessage) {
+        return [NSString stringWithFormat:@"%@-%ld", logStreamName, (long)logMessage.context];
+    };
+    AWSDDLog *log = [AWSDDLog new];
+    [log addLogger:logger];
+
+    for (NSUInteger i = 0; i < 4000; i++) {
+        AWSLogsLoggerTestsLog(log, i % 4, @"log event %lu", (unsigned long)i);
+    }
+    [log flushLog];
+
+    AWSTask *task = [logger submitAllLogEvents];
+    [task waitUntilFinished];
+    XCTAssertNil(task.error);
+
+    XCTAssertEqualObjects(logs.violations, @[]);
+    XCTAssertEqual([logs.requests count], 4);
+    XCTAssertEqual(logs.eventCount, 4000);
+    XCTAssertEqual(logs.maximumConcurrentRequestCount, 3);
+    NSSet *logStreamNames = [NSSet setWithArray:[logs.requests valueForKey:@"logStreamName"]];
+    XCTAssertEqual([logStreamNames count], 4);
+
+    [log removeLogger:logger];
+}
+
+- (void)testIdleLogStreamsAreEvicted {
+    AWSLogsLoggerTestsLogs *logs = [AWSLogsLoggerTestsLogs new];
+    AWSLogsLogger *logger = [self loggerWithLogs:logs];
+    NSString *logStreamName = logger.logStreamName;
+    logger.logStreamNameBlock = ^NSString *(AWSDDLogMessage *logMessage) {
+        return [NSString stringWithFormat:@"%@-%ld", logStreamName, (long)logMessage.context];
+    };
+    AWSDDLog *log = [AWSDDLog new];
+    [log addLogger:logger];
+
+    // Uploads to a log stream, then to another one once the first one is no longer waiting.
+    for (NSUInteger context = 0; context < 3; context++) {
+        AWSLogsLoggerTestsLog(log, context % 2, @"log event %lu", (unsigned long)context);
+        [log flushLog];
+        AWSTask *task = [logger submitAllLogEvents];
+        [task waitUntilFinished];
+        XCTAssertNil(task.error);
+        [NSThread sleepForTimeInterval:0.3];
+    }
+    [[logger submitAllLogEvents] waitUntilFinished];
+
+    XCTAssertEqual([logs.requests count], 3);
+    XCTAssertEqual([[logger valueForKey:@"streams"] count], 0);
+    // The sequence token of the evicted log stream was saved, and is used when uploading to it again.
+    XCTAssertEqualObjects(logs.requests[2].logStreamName, logs.requests[0].logStreamName);
+    XCTAssertEqualObjects(logs.requests[2].sequenceToken, logs.nextSequenceTokens[0]);
+
+    [log removeLogger:logger];
+}
+
+- (void)testDiskByteLimit {
+    AWSLogsLoggerTestsLogs *logs = [AWSLogsLoggerTestsLogs new];
+    logs.failsAllRequests = YES;
+    AWSLogsLogger *logger = [self loggerWithLogs:logs];
+    logger.diskByteLimit = 64 * 1024;
+    AWSDDLog *log = [AWSDDLog new];
+    [log addLogger:logger];
+
+    for (NSUInteger j = 0; j < 10; j++) {
+        for (NSUInteger i = 0; i < 1000; i++) {
+            AWSLogsLoggerTestsLog(log, 0, @"log event %@", [[NSUUID UUID] UUIDString]);
+        }
+        [log flushLog];
+    }
+
+    XCTAssertGreaterThan(logger.diskBytesUsed, 0);
+    XCTAssertLessThanOrEqual(logger.diskBytesUsed, 64 * 1024);
+    XCTAssertEqual([logs.requests count], 0);
+
+    [log removeLogger:logger];
+}
+
+- (void)testChunksSavedAfterTrimDuringUploadAreKept {
+    AWSLogsLoggerTestsLogs *logs = [AWSLogsLoggerTestsLogs new];
+    logs.latency = 0.5;
+    AWSLogsLogger *logger = [self loggerWithLogs:logs];
+    logger.diskByteLimit = 4 * 1024;
+    AWSDDLog *log = [AWSDDLog new];
+    [log addLogger:logger];
+
+    AWSLogsLoggerTestsLog(log, 0, @"first");
+    [log flushLog];
+    AWSTask *task = [logger submitAllLogEvents];
+
+    // While the first chunk is uploaded, a chunk larger than the disk byte limit removes every chunk.
+    NSMutableString *message = [NSMutableString new];
+    for (NSUInteger i = 0; i < 400; i++) {
+        [message appendString:[[NSUUID UUID] UUIDString]];
+    }
+    AWSLogsLoggerTestsLog(log, 0, @"%@", message);
+    [log flushLog];
+    XCTAssertEqual(logger.diskBytesUsed, 0);
+
+    // The chunk saved next is not removed when the upload of the first chunk completes.
+    AWSLogsLoggerTestsLog(log, 0, @"second");
+    [log flushLog];
+    [task waitUntilFinished];
+    XCTAssertNil(task.error);
+
+    XCTAssertEqual([logs.requests count], 2);
+    XCTAssertEqualObjects(logs.requests[0].logEvents[0].message, @"first");
+    XCTAssertEqualObjects([logs.requests lastObject].logEvents[0].message, @"second");
+    XCTAssertEqual(logger.diskBytesUsed, 0);
+
+    [log removeLogger:logger];
+}
+
+- (void)uploadLogEventsToLogStreamCount:(NSUInteger)logStreamCount {
+    AWSLogsLoggerTestsLogs *logs = [AWSLogsLoggerTestsLogs new];
+    logs.latency = 0.05;
+    AWSLogsLogger *logger = [self loggerWithLogs:logs];
+    NSString *logStreamName = logger.logStreamName;
+    logger.logStreamNameBlock = ^NSString *(AWSDDLogMessage *logMessage) {
+        return [NSString stringWithFormat:@"%@-%ld", logStreamName, (long)logMessage.context];
+    };
+    AWSDDLog *log = [AWSDDLog new];
+    [log addLogger:logger];
+
+    for (NSUInteger i = 0; i < AWSLogsLoggerTestsIterations; i++) {
+        @autoreleasepool {
+            AWSLogsLoggerTestsLog(log, i % logStreamCount, @"EventCode:%lu, status:%lu, stream: %@", (unsigned long)i, (unsigned long)2, @"stream");
+        }
+    }
+    [log flushLog];
+    [[logger submitAllLogEvents] waitUntilFinished];
+    XCTAssertEqual(logs.eventCount, AWSLogsLoggerTestsIterations);
+
+    [log removeLogger:logger];
+}
+
+// Compare with testPerformanceFourLogStreams.
+- (void)testPerformanceOneLogStream {
+    [self measureBlock:^{
+        [self uploadLogEventsToLogStreamCount:1];
+    }];
+}
+
+- (void)testPerformanceFourLogStreams {
+    [self measureBlock:^{
+        [self uploadLogEventsToLogStreamCount:4];
+    }];
+}
+
+@end
@@ -54,6 +54,7 @@ NSString *const FAILURE_REASON = @"NSLocalizedFailureReason";
 
 @property (nonatomic, weak) AWSPinpointContext *context;
 @property (nonatomic, strong) AWSFMDatabaseQueue *databaseQueue;
+@property (nonatomic, strong) AWSFMDatabasePool *databaseReaderPool;
 @property (nonatomic, strong) NSString *databasePath;
 @property (nonatomic, strong) AWSPinpointEndpointProfile *profile;
 @property (nonatomic, strong) NSObject *lock;
@@ -117,13 +118,8 @@ NSString *const FAILURE_REASON = @"NSLocalizedFailureReason";
         
         // Creates a database for the identifier if it doesn't exist.
         AWSDDLogDebug(@"Database path: [%@]", _databasePath);
-        _databaseQueue = [AWSFMDatabaseQueue serialDatabaseQueueWithPath:_databasePath];
+        _databaseQueue = [AWSFMDatabaseQueue storeDatabaseQueueWithPath:_databasePath];
         [_databaseQueue inDatabase:^(AWSFMDatabase *db) {
-            db.shouldCacheStatements = YES;
-            if (![db executeStatements:@"PRAGMA auto_vacuum = FULL"]) {
-                AWSDDLogError(@"Failed to enable 'auto_vacuum' to 'FULL'. %@", db.lastError);
-            }
-            
             //Event Table
             if (![db executeUpdate:
                   @"CREATE TABLE IF NOT EXISTS Event ("
@@ -158,6 +154,7 @@ NSString *const FAILURE_REASON = @"NSLocalizedFailureReason";
                 AWSDDLogError(@"SQLite error. [%@]", db.lastError);
             }
         }];
+        _databaseReaderPool = [AWSFMDatabasePool storeReaderPoolWithDatabaseQueue:_databaseQueue];
     }
     return self;
 }
@@ -166,15 +163,29 @@ NSString *const FAILURE_REASON = @"NSLocalizedFailureReason";
     [_databaseQueue close];
 }
 
-+ (dispatch_queue_t)sharedQueue {
-    static dispatch_queue_t queue;
+// Saves, reads and removes the events of all event recorders one block at a time, at the default quality of service.
++ (AWSExecutor *)sharedExecutor {
+    static AWSExecutor *executor;
     static dispatch_once_t predicate;
-    
+
     dispatch_once(&predicate, ^{
-        queue = dispatch_queue_create("com.amazonaws.AWSPinpointEventRecorder", DISPATCH_QUEUE_SERIAL);
+        executor = [AWSExecutor executorWithDispatchQueue:dispatch_queue_create("com.amazonaws.AWSPinpointEventRecorder", DISPATCH_QUEUE_SERIAL)];
     });
-    
-    return queue;
+
+    return executor;
+}
+
+// Runs the database work of the submissions of all event recorders one block at a time, on the background workers
+// of the default pool, so that a submission does not hold up the saves.
++ (AWSExecutor *)sharedSubmitExecutor {
+    static AWSExecutor *executor;
+    static dispatch_once_t predicate;
+
+    dispatch_once(&predicate, ^{
+        executor = [[AWSExecutorPool defaultPool] serialExecutorWithQualityOfService:AWSExecutorQualityOfServiceBackground];
+    });
+
+    return executor;
 }
 
 - (AWSPinpointSession *)validateOrRetrieveSession:(AWSPinpointSession *) session {
@@ -228,7 +239,6 @@ NSString *const FAILURE_REASON = @"NSLocalizedFailureReason";
     
     AWSFMDatabaseQueue *databaseQueue = self.databaseQueue;
     NSTimeInterval diskAgeLimit = self.diskAgeLimit;
-    NSString *databasePath = self.databasePath;
     NSUInteger notificationByteThreshold = self.notificationByteThreshold;
     NSUInteger diskByteLimit = self.diskByteLimit;
     __weak id notificationSender = self;
@@ -236,7 +246,7 @@ NSString *const FAILURE_REASON = @"NSLocalizedFailureReason";
     __block AWSPinpointEvent *event = [eventToSave copy];
     AWSDDLogVerbose(@"saveEvent: [%@]", event.toDictionary);
     
-    return [[AWSTask taskWithResult:nil] continueWithExecutor:[AWSExecutor executorWithDispatchQueue:[AWSPinpointEventRecorder sharedQueue]] withSuccessBlock:^id _Nullable(AWSTask * _Nonnull task) {
+    return [[AWSTask taskWithResult:nil] continueWithExecutor:[AWSPinpointEventRecorder sharedExecutor] withSuccessBlock:^id _Nullable(AWSTask * _Nonnull task) {
         // Inserts a new record to the database.
         __block NSError *error = nil;
         [databaseQueue inDatabase:^(AWSFMDatabase *db) {
@@ -306,6 +316,7 @@ NSString *const FAILURE_REASON = @"NSLocalizedFailureReason";
                     AWSDDLogError(@"SQLite error. [%@]", db.lastError);
                     error = db.lastError;
                 }
+                [db aws_releaseFreePagesIfNeeded];
             }];
         }
         
@@ -313,49 +324,47 @@ NSString *const FAILURE_REASON = @"NSLocalizedFailureReason";
             return [AWSTask taskWithError:error];
         }
         
-        NSDictionary *attributes = [[NSFileManager defaultManager] attributesOfItemAtPath:databasePath
-                                                                                    error:&error];
-        if (attributes) {
-            NSUInteger fileSize = (NSUInteger)[attributes fileSize];
-            [self checkByteThresholdForNotification:notificationByteThreshold
-                                 notificationSender:notificationSender
-                                           fileSize:fileSize];
-            if (fileSize > diskByteLimit) {
-                //First Flush the dirty events
+        NSUInteger fileSize = (NSUInteger)[self diskBytesUsed];
+        [self checkByteThresholdForNotification:notificationByteThreshold
+                             notificationSender:notificationSender
+                                       fileSize:fileSize];
+        if (fileSize > diskByteLimit) {
+            //First Flush the dirty events
+            [databaseQueue inDatabase:^(AWSFMDatabase *db) {
+                if (![db executeUpdate:@"DELETE FROM DirtyEvent"]) {
+                    AWSDDLogError(@"SQLite error. [%@]", db.lastError);
+                    error = db.lastError;
+                }
+            }];
+            
+            if (error) {
+                return [AWSTask taskWithError:error];
+            }
+            
+            if ([self diskBytesUsed] > diskByteLimit) {
+                // Deletes the oldest event if it still exceeds the disk size threshold after clearing the dirty events.
                 [databaseQueue inDatabase:^(AWSFMDatabase *db) {
-                    if (![db executeUpdate:@"DELETE FROM DirtyEvent"]) {
+                    AWSDDLogWarn(@"Deleting oldest event from disk, diskByteLimit has been reached.");
+                    BOOL result = [db executeUpdate:
+                                   @"DELETE FROM Event "
+                                   @"WHERE id IN ( "
+                                   @"SELECT id "
+                                   @"FROM Event "
+                                   @"ORDER BY timestamp ASC "
+                                   @"LIMIT 1 "
+                                   @")"
+                                   ];
+                    if (!result) {
                         AWSDDLogError(@"SQLite error. [%@]", db.lastError);
                         error = db.lastError;
+                        return;
                     }
                 }];
-                
-                if (error) {
-                    return [AWSTask taskWithError:error];
-                }
-                
-                if ([self diskBytesUsed] > diskByteLimit) {
-                    // Deletes the oldest event if it still exceeds the disk size threshold after clearing the dirty events.
-                    [databaseQueue inDatabase:^(AWSFMDatabase *db) {
-                        AWSDDLogWarn(@"Deleting oldest event from disk, diskByteLimit has been reached.");
-                        BOOL result = [db executeUpdate:
-                                       @"DELETE FROM Event "
-                                       @"WHERE id IN ( "
-                                       @"SELECT id "
-                                       @"FROM Event "
-                                       @"ORDER BY timestamp ASC "
-                                       @"LIMIT 1 "
-                                       @")"
-                                       ];
-                        if (!result) {
-                            AWSDDLogError(@"SQLite error. [%@]", db.lastError);
-                            error = db.lastError;
-                            return;
-                        }
-                    }];
-                }
             }
-        } else if (error) {
-            return [AWSTask taskWithError:error];
+            
+            if (error) {
+                return [AWSTask taskWithError:error];
+            }
         }
         
         return [AWSTask taskWithResult:event];
@@ -366,7 +375,7 @@ NSString *const FAILURE_REASON = @"NSLocalizedFailureReason";
     AWSFMDatabaseQueue *databaseQueue = self.databaseQueue;
     NSString *sessionId = [self validateOrRetrieveSessionId:self.context.sessionClient.session.sessionId];
     
-    return [[AWSTask taskWithResult:nil] continueWithExecutor:[AWSExecutor executorWithDispatchQueue:[AWSPinpointEventRecorder sharedQueue]] withSuccessBlock:^id _Nullable(AWSTask * _Nonnull task) {
+    return [[AWSTask taskWithResult:nil] continueWithExecutor:[AWSPinpointEventRecorder sharedExecutor] withSuccessBlock:^id _Nullable(AWSTask * _Nonnull task) {
         __block NSError *error = nil;
         
         [databaseQueue inTransaction:^(AWSFMDatabase *db, BOOL *rollback) {
@@ -408,14 +417,14 @@ NSString *const FAILURE_REASON = @"NSLocalizedFailureReason";
 
 //Only used for testing
 - (AWSTask*) getCurrentSession: (AWSPinpointSession*) session {
-    AWSFMDatabaseQueue *databaseQueue = self.databaseQueue;
+    AWSFMDatabasePool *databaseReaderPool = self.databaseReaderPool;
     NSString *sessionId = [self validateOrRetrieveSessionId:session.sessionId];
     
-    return [[AWSTask taskWithResult:nil] continueWithExecutor:[AWSExecutor executorWithDispatchQueue:[AWSPinpointEventRecorder sharedQueue]] withSuccessBlock:^id _Nullable(AWSTask * _Nonnull task) {
+    return [[AWSTask taskWithResult:nil] continueWithExecutor:[AWSPinpointEventRecorder sharedExecutor] withSuccessBlock:^id _Nullable(AWSTask * _Nonnull task) {
         __block NSError *error = nil;
         __block AWSPinpointEvent *event;
         
-        [databaseQueue inTransaction:^(AWSFMDatabase *db, BOOL *rollback) {
+        [databaseReaderPool inDeferredTransaction:^(AWSFMDatabase *db, BOOL *rollback) {
             AWSFMResultSet *rs = [db executeQuery:
                                   @"SELECT id, attributes, eventType, metrics, eventTimestamp, sessionId, sessionStartTime, sessionStopTime, timestamp, retryCount "
                                   @"FROM Event "
@@ -474,13 +483,13 @@ NSString *const FAILURE_REASON = @"NSLocalizedFailureReason";
 }
 
 - (AWSTask<NSArray<AWSPinpointEvent *> *> *) getEventsWithLimit:(NSNumber *) limit {
-    AWSFMDatabaseQueue *databaseQueue = self.databaseQueue;
+    AWSFMDatabasePool *databaseReaderPool = self.databaseReaderPool;
     
-    return [[AWSTask taskWithResult:nil] continueWithExecutor:[AWSExecutor executorWithDispatchQueue:[AWSPinpointEventRecorder sharedQueue]] withSuccessBlock:^id _Nullable(AWSTask * _Nonnull task) {
+    return [[AWSTask taskWithResult:nil] continueWithExecutor:[AWSPinpointEventRecorder sharedExecutor] withSuccessBlock:^id _Nullable(AWSTask * _Nonnull task) {
         __block NSError *error = nil;
         __block NSMutableArray *events = [NSMutableArray new];
         
-        [databaseQueue inTransaction:^(AWSFMDatabase *db, BOOL *rollback) {
+        [databaseReaderPool inDeferredTransaction:^(AWSFMDatabase *db, BOOL *rollback) {
             AWSFMResultSet *rs = [db executeQuery:[NSString stringWithFormat:
                                                    @"SELECT id, attributes, eventType, metrics, eventTimestamp, sessionId, sessionStartTime, sessionStopTime, timestamp, retryCount "
                                                    @"FROM Event "
@@ -537,13 +546,13 @@ NSString *const FAILURE_REASON = @"NSLocalizedFailureReason";
 }
 
 - (AWSTask<NSArray<AWSPinpointEvent *> *> *) getDirtyEventsWithLimit:(NSNumber *) limit {
-    AWSFMDatabaseQueue *databaseQueue = self.databaseQueue;
+    AWSFMDatabasePool *databaseReaderPool = self.databaseReaderPool;
     
-    return [[AWSTask taskWithResult:nil] continueWithExecutor:[AWSExecutor executorWithDispatchQueue:[AWSPinpointEventRecorder sharedQueue]] withSuccessBlock:^id _Nullable(AWSTask * _Nonnull task) {
+    return [[AWSTask taskWithResult:nil] continueWithExecutor:[AWSPinpointEventRecorder sharedExecutor] withSuccessBlock:^id _Nullable(AWSTask * _Nonnull task) {
         __block NSError *error = nil;
         __block NSMutableArray *events = [NSMutableArray new];
         
-        [databaseQueue inTransaction:^(AWSFMDatabase *db, BOOL *rollback) {
+        [databaseReaderPool inDeferredTransaction:^(AWSFMDatabase *db, BOOL *rollback) {
             AWSFMResultSet *rs = [db executeQuery:[NSString stringWithFormat:
                                                    @"SELECT id, attributes, eventType, metrics, eventTimestamp, sessionId, sessionStartTime, sessionStopTime, timestamp, retryCount "
                                                    @"FROM DirtyEvent "
@@ -737,7 +746,7 @@ NSString *const FAILURE_REASON = @"NSLocalizedFailureReason";
     AWSFMDatabaseQueue *databaseQueue = self.databaseQueue;
     NSDictionary *temporaryEvents = [eventsWithEventId copy];
 
-    return [[AWSTask taskWithResult:nil] continueWithExecutor:[AWSExecutor executorWithDispatchQueue:[AWSPinpointEventRecorder sharedQueue]]
+    return [[AWSTask taskWithResult:nil] continueWithExecutor:[AWSPinpointEventRecorder sharedSubmitExecutor]
                                              withSuccessBlock:^id _Nullable(AWSTask * _Nonnull task) {
         __block NSError *error = nil;
         __block NSMutableDictionary *events = [NSMutableDictionary new];
@@ -753,7 +762,7 @@ NSString *const FAILURE_REASON = @"NSLocalizedFailureReason";
                                }];
         
         return [[AWSTask taskForCompletionOfAllTasksWithResults:@[submitTask]] continueWithBlock:^id _Nullable(AWSTask * _Nonnull t) {
-            AWSTask *failTask = [AWSTask taskFromExecutor:[AWSExecutor executorWithDispatchQueue:[AWSPinpointEventRecorder sharedQueue]] withBlock:^id _Nonnull{
+            AWSTask *failTask = [AWSTask taskFromExecutor:[AWSPinpointEventRecorder sharedSubmitExecutor] withBlock:^id _Nonnull{
                 // If an event failed three times, mark even as dirty
                 [databaseQueue inTransaction:^(AWSFMDatabase *db, BOOL *rollback) {
                     BOOL result = [db executeUpdate:[NSString stringWithFormat:
@@ -768,7 +777,7 @@ NSString *const FAILURE_REASON = @"NSLocalizedFailureReason";
                 return [AWSTask taskWithResult:nil];
             }];
             
-            AWSTask *moveTask = [AWSTask taskFromExecutor:[AWSExecutor executorWithDispatchQueue:[AWSPinpointEventRecorder sharedQueue]] withBlock:^id _Nonnull{
+            AWSTask *moveTask = [AWSTask taskFromExecutor:[AWSPinpointEventRecorder sharedSubmitExecutor] withBlock:^id _Nonnull{
                 //Move dirty events into DirtyEvent table
                 [databaseQueue inTransaction:^(AWSFMDatabase *db, BOOL *rollback) {
                     BOOL result = [db executeUpdate:[NSString stringWithFormat:
@@ -783,7 +792,7 @@ NSString *const FAILURE_REASON = @"NSLocalizedFailureReason";
                 return [AWSTask taskWithResult:nil];
             }];
             
-            AWSTask *deleteTask = [AWSTask taskFromExecutor:[AWSExecutor executorWithDispatchQueue:[AWSPinpointEventRecorder sharedQueue]] withBlock:^id _Nonnull{
+            AWSTask *deleteTask = [AWSTask taskFromExecutor:[AWSPinpointEventRecorder sharedSubmitExecutor] withBlock:^id _Nonnull{
                 //Delete dirty events
                 [databaseQueue inTransaction:^(AWSFMDatabase *db, BOOL *rollback) {
                     BOOL result = [db executeUpdate:[NSString stringWithFormat:
@@ -793,6 +802,7 @@ NSString *const FAILURE_REASON = @"NSLocalizedFailureReason";
                         AWSDDLogError(@"SQLite error. [%@]", db.lastError);
                         error = db.lastError;
                     }
+                    [db aws_releaseFreePagesIfNeeded];
                 }];
                 return [AWSTask taskWithResult:nil];
             }];
@@ -810,13 +820,14 @@ NSString *const FAILURE_REASON = @"NSLocalizedFailureReason";
 - (AWSTask *)removeAllEvents {
     AWSFMDatabaseQueue *databaseQueue = self.databaseQueue;
     
-    return [[AWSTask taskWithResult:nil] continueWithExecutor:[AWSExecutor executorWithDispatchQueue:[AWSPinpointEventRecorder sharedQueue]] withSuccessBlock:^id _Nullable(AWSTask * _Nonnull task) {
+    return [[AWSTask taskWithResult:nil] continueWithExecutor:[AWSPinpointEventRecorder sharedExecutor] withSuccessBlock:^id _Nullable(AWSTask * _Nonnull task) {
         __block NSError *error = nil;
         [databaseQueue inDatabase:^(AWSFMDatabase *db) {
             if (![db executeUpdate:@"DELETE FROM Event"]) {
                 AWSDDLogError(@"SQLite error. [%@]", db.lastError);
                 error = db.lastError;
             }
+            [db aws_releaseFreePagesIfNeeded];
         }];
         
         if (error) {
@@ -830,13 +841,14 @@ NSString *const FAILURE_REASON = @"NSLocalizedFailureReason";
 - (AWSTask *)removeAllDirtyEvents {
     AWSFMDatabaseQueue *databaseQueue = self.databaseQueue;
     
-    return [[AWSTask taskWithResult:nil] continueWithExecutor:[AWSExecutor executorWithDispatchQueue:[AWSPinpointEventRecorder sharedQueue]] withSuccessBlock:^id _Nullable(AWSTask * _Nonnull task) {
+    return [[AWSTask taskWithResult:nil] continueWithExecutor:[AWSPinpointEventRecorder sharedExecutor] withSuccessBlock:^id _Nullable(AWSTask * _Nonnull task) {
         __block NSError *error = nil;
         [databaseQueue inDatabase:^(AWSFMDatabase *db) {
             if (![db executeUpdate:@"DELETE FROM DirtyEvent"]) {
                 AWSDDLogError(@"SQLite error. [%@]", db.lastError);
                 error = db.lastError;
             }
+            [db aws_releaseFreePagesIfNeeded];
         }];
         
         if (error) {
@@ -848,15 +860,11 @@ NSString *const FAILURE_REASON = @"NSLocalizedFailureReason";
 }
 
 - (uint64_t)diskBytesUsed {
-    NSError *error = nil;
-    NSDictionary *attributes = [[NSFileManager defaultManager] attributesOfItemAtPath:self.databasePath
-                                                                                error:&error];
-    if (attributes) {
-        return [attributes fileSize];
-    } else {
-        AWSDDLogError(@"Error [%@]", error);
-        return 0;
-    }
+    __block uint64_t diskBytesUsed = 0;
+    [self.databaseReaderPool inDatabase:^(AWSFMDatabase *db) {
+        diskBytesUsed = [db aws_usedByteCount];
+    }];
+    return diskBytesUsed;
 }
 
 - (void)setBatchRecordsByteLimit:(NSUInteger)batchRecordsByteLimit {
@@ -1033,36 +1041,28 @@ NSString *const FAILURE_REASON = @"NSLocalizedFailureReason";
                 NSInteger responseCode = [task.error.userInfo[@"responseStatusCode"] integerValue];
                 AWSDDLogError(@"Server rejected submission of %lu events. (Events will be marked dirty.) Response code:%ld, Error Message:%@", (unsigned long)[events count], (long)responseCode, task.error);
                 
-                return [AWSTask taskForCompletionOfAllTasksWithResults:@[[AWSTask taskFromExecutor:[AWSExecutor executorWithDispatchQueue:[AWSPinpointEventRecorder sharedQueue]] withBlock:^id _Nonnull{
-                    for (__block NSString *eventID in _temporaryEvents) {
-                        [databaseQueue inTransaction:^(AWSFMDatabase *db, BOOL *rollback) {
-                            BOOL result = [db executeUpdate:[NSString stringWithFormat:@"UPDATE Event SET dirty = %@ WHERE id = :id", [NSNumber numberWithInteger:AWSPinpointClientInvalidEvent]]
-                                    withParameterDictionary:@{
-                                                              @"id" : eventID
-                                                              }];
-                            if (!result) {
-                                AWSDDLogError(@"SQLite error. [%@]", db.lastError);
-                                *error = db.lastError;
-                            }
-                        }];
-                    }
+                return [AWSTask taskForCompletionOfAllTasksWithResults:@[[AWSTask taskFromExecutor:[AWSPinpointEventRecorder sharedSubmitExecutor] withBlock:^id _Nonnull{
+                    [databaseQueue inTransaction:^(AWSFMDatabase *db, BOOL *rollback) {
+                        BOOL result = [db executeUpdate:[NSString stringWithFormat:@"UPDATE Event SET dirty = %@ WHERE id IN aws_fmdb_values", [NSNumber numberWithInteger:AWSPinpointClientInvalidEvent]]
+                             withValuesInTemporaryTable:[_temporaryEvents allKeys]];
+                        if (!result) {
+                            AWSDDLogError(@"SQLite error. [%@]", db.lastError);
+                            *error = db.lastError;
+                        }
+                    }];
                     return [AWSTask taskWithError:[self processError:task.error]];
                 }]]];
             } else {
                 AWSDDLogError(@"Unable to successfully deliver events to server. Events will be retried. Error Message:%@", task.error);
-                return [AWSTask taskForCompletionOfAllTasksWithResults:@[[AWSTask taskFromExecutor:[AWSExecutor executorWithDispatchQueue:[AWSPinpointEventRecorder sharedQueue]] withBlock:^id _Nonnull{
-                    for (__block NSString *eventID in _temporaryEvents) {
-                        [databaseQueue inTransaction:^(AWSFMDatabase *db, BOOL *rollback) {
-                            BOOL result = [db executeUpdate:@"UPDATE Event SET retryCount = retryCount + 1 WHERE id = :id"
-                                    withParameterDictionary:@{
-                                                              @"id" : eventID
-                                                              }];
-                            if (!result) {
-                                AWSDDLogError(@"SQLite error. [%@]", db.lastError);
-                                *error = db.lastError;
-                            }
-                        }];
-                    }
+                return [AWSTask taskForCompletionOfAllTasksWithResults:@[[AWSTask taskFromExecutor:[AWSPinpointEventRecorder sharedSubmitExecutor] withBlock:^id _Nonnull{
+                    [databaseQueue inTransaction:^(AWSFMDatabase *db, BOOL *rollback) {
+                        BOOL result = [db executeUpdate:@"UPDATE Event SET retryCount = retryCount + 1 WHERE id IN aws_fmdb_values"
+                             withValuesInTemporaryTable:[_temporaryEvents allKeys]];
+                        if (!result) {
+                            AWSDDLogError(@"SQLite error. [%@]", db.lastError);
+                            *error = db.lastError;
+                        }
+                    }];
                     return task;
                 }]]];
             }
@@ -1085,47 +1085,36 @@ NSString *const FAILURE_REASON = @"NSLocalizedFailureReason";
                          (unsigned int)[[_processedEvents objectForKey:@"retryableEvents"] count],
                          (unsigned int)[[_processedEvents objectForKey:@"dirtyEvents"] count]);
 
-            return [[AWSTask taskForCompletionOfAllTasksWithResults:@[[AWSTask taskFromExecutor:[AWSExecutor executorWithDispatchQueue:[AWSPinpointEventRecorder sharedQueue]] withBlock:^id _Nonnull{
-                //submitted events, update database
-                for (__block NSString *eventID in [_processedEvents objectForKey:@"acceptedEvents"]) {
-                    [databaseQueue inTransaction:^(AWSFMDatabase *db, BOOL *rollback) {
-                        BOOL result = [db executeUpdate:@"DELETE FROM Event WHERE id = :id"
-                                withParameterDictionary:@{
-                                                          @"id" : eventID
-                                                          }];
-                        if (!result) {
-                            AWSDDLogError(@"SQLite error. [%@]", db.lastError);
-                            *error = db.lastError;
-                        }
-                    }];
-                }
-                //retryable events, update database
-                for (__block NSString *eventID in [_processedEvents objectForKey:@"retryableEvents"]) {
-                    [databaseQueue inTransaction:^(AWSFMDatabase *db, BOOL *rollback) {
-                        BOOL result = [db executeUpdate:@"UPDATE Event SET retryCount = retryCount + 1 WHERE id = :id"
-                                withParameterDictionary:@{
-                                                          @"id" : eventID
-                                                          }];
-                        if (!result) {
-                            AWSDDLogError(@"SQLite error. [%@]", db.lastError);
-                            *error = db.lastError;
-                        }
-                    }];
-                }
-                
-                //rejected events, mark dirty, update database
-                for (__block NSString *eventID in [_processedEvents objectForKey:@"dirtyEvents"]) {
-                    [databaseQueue inTransaction:^(AWSFMDatabase *db, BOOL *rollback) {
-                        BOOL result = [db executeUpdate:[NSString stringWithFormat:@"UPDATE Event SET dirty = %@ WHERE id = :id", [NSNumber numberWithInteger:AWSPinpointClientInvalidEvent]]
-                                withParameterDictionary:@{
-                                                          @"id" : eventID
-                                                          }];
-                        if (!result) {
-                            AWSDDLogError(@"SQLite error. [%@]", db.lastError);
-                            *error = db.lastError;
-                        }
-                    }];
-                }
+            return [[AWSTask taskForCompletionOfAllTasksWithResults:@[[AWSTask taskFromExecutor:[AWSPinpointEventRecorder sharedSubmitExecutor] withBlock:^id _Nonnull{
+                [databaseQueue inTransaction:^(AWSFMDatabase *db, BOOL *rollback) {
+                    //submitted events, update database
+                    BOOL result = [db executeUpdate:@"DELETE FROM Event WHERE id IN aws_fmdb_values"
+                         withValuesInTemporaryTable:[[_processedEvents objectForKey:@"acceptedEvents"] allKeys]];
+                    if (!result) {
+                        AWSDDLogError(@"SQLite error. [%@]", db.lastError);
+                        *error = db.lastError;
+                    }
+
+                    //retryable events, update database
+                    result = [db executeUpdate:@"UPDATE Event SET retryCount = retryCount + 1 WHERE id IN aws_fmdb_values"
+                    withValuesInTemporaryTable:[[_processedEvents objectForKey:@"retryableEvents"] allKeys]];
+                    if (!result) {
+                        AWSDDLogError(@"SQLite error. [%@]", db.lastError);
+                        *error = db.lastError;
+                    }
+
+                    //rejected events, mark dirty, update database
+                    result = [db executeUpdate:[NSString stringWithFormat:@"UPDATE Event SET dirty = %@ WHERE id IN aws_fmdb_values", [NSNumber numberWithInteger:AWSPinpointClientInvalidEvent]]
+                    withValuesInTemporaryTable:[[_processedEvents objectForKey:@"dirtyEvents"] allKeys]];
+                    if (!result) {
+                        AWSDDLogError(@"SQLite error. [%@]", db.lastError);
+                        *error = db.lastError;
+                    }
+                }];
+
+                [databaseQueue inDatabase:^(AWSFMDatabase *db) {
+                    [db aws_releaseFreePagesIfNeeded];
+                }];
                 
                 return task;
             }]]] continueWithBlock:^id _Nullable(AWSTask * _Nonnull t) {
@@ -73,6 +73,7 @@ static int const AWSS3TransferUtilityMultiPartDefaultConcurrencyLimit = 5;
 @property (strong, nonatomic) AWSSynchronizedMutableDictionary *completedTaskDictionary;
 @property (copy, nonatomic) void (^backgroundURLSessionCompletionHandler)(void);
 @property (strong, nonatomic) AWSFMDatabaseQueue *databaseQueue;
+@property (strong, nonatomic) AWSFMDatabasePool *databaseReaderPool;
 @end
 
 @interface AWSS3TransferUtilityTask()
@@ -209,12 +210,12 @@ static int const AWSS3TransferUtilityMultiPartDefaultConcurrencyLimit = 5;
 + (void) insertMultiPartUploadRequestInDB:(AWSS3TransferUtilityMultiPartUploadTask *) task
                             databaseQueue: (AWSFMDatabaseQueue *) databaseQueue;
 
-+ (void) insertMultiPartUploadRequestSubTaskInDB:(AWSS3TransferUtilityMultiPartUploadTask *) task
-                                         subTask:(AWSS3TransferUtilityUploadSubTask *) subTask
-                                   databaseQueue: (AWSFMDatabaseQueue *) databaseQueue;
++ (void) insertMultiPartUploadRequestSubTasksInDB:(AWSS3TransferUtilityMultiPartUploadTask *) task
+                                          subTasks:(NSArray<AWSS3TransferUtilityUploadSubTask *> *) subTasks
+                                    databaseQueue: (AWSFMDatabaseQueue *) databaseQueue;
 
 + (NSMutableArray *) getTransferTaskDataFromDB:(NSString *)nsURLSessionID
-                                 databaseQueue: (AWSFMDatabaseQueue *) databaseQueue;
+                            databaseReaderPool: (AWSFMDatabasePool *) databaseReaderPool;
 
 + (NSString *) getJSONRepresentation: (NSDictionary *) dict;
 + (NSDictionary*) getDictionaryFromJson: (NSString *)json;
@@ -486,6 +487,7 @@ static AWSS3TransferUtility *_defaultS3TransferUtility = nil;
         
         //Instantiate the Database Helper
         self.databaseQueue = [AWSS3TransferUtilityDatabaseHelper createDatabase:_cacheDirectoryPath];
+        self.databaseReaderPool = [AWSFMDatabasePool storeReaderPoolWithDatabaseQueue:self.databaseQueue];
 
         if (recoverState) {
             //Recover the state from the previous time this was instantiated
@@ -519,7 +521,7 @@ static AWSS3TransferUtility *_defaultS3TransferUtility = nil;
       tempTransferDictionary: (NSMutableDictionary *) tempTransferDictionary
 {
     //Get All Tasks from DB
-    NSMutableArray *tasks = [AWSS3TransferUtilityDatabaseHelper getTransferTaskDataFromDB:_sessionIdentifier databaseQueue:_databaseQueue];
+    NSMutableArray *tasks = [AWSS3TransferUtilityDatabaseHelper getTransferTaskDataFromDB:_sessionIdentifier databaseReaderPool:_databaseReaderPool];
     
     //Iterate through the tasks and populate transferRequests and Multipart dictionary.
     for( NSMutableDictionary *task in tasks ) {
@@ -1358,7 +1360,8 @@ static AWSS3TransferUtility *_defaultS3TransferUtility = nil;
         
         AWSDDLogInfo(@"Initiated multipart upload on server: %@", output.uploadId);
         AWSDDLogInfo(@"Concurrency Limit is %@", self.transferUtilityConfiguration.multiPartConcurrencyLimit);
-        //Loop through the file and upload the parts one by one
+        //Loop through the file and create the parts
+        NSMutableArray<AWSS3TransferUtilityUploadSubTask *> *subTasks = [NSMutableArray arrayWithCapacity:partCount];
         for (int32_t i = 1; i <= partCount ; i++) {
             NSUInteger dataLength = AWSS3TransferUtilityMultiPartSize;
             if (i == partCount) {
@@ -1374,10 +1377,15 @@ static AWSS3TransferUtility *_defaultS3TransferUtility = nil;
             subTask.responseData = @"";
             subTask.file = @"";
             subTask.eTag = @"";
-            
-            //Save in Database
-            [AWSS3TransferUtilityDatabaseHelper insertMultiPartUploadRequestSubTaskInDB:transferUtilityMultiPartUploadTask subTask:subTask databaseQueue:self.databaseQueue];
-            
+            [subTasks addObject:subTask];
+        }
+
+        //Save in Database
+        [AWSS3TransferUtilityDatabaseHelper insertMultiPartUploadRequestSubTasksInDB:transferUtilityMultiPartUploadTask subTasks:subTasks databaseQueue:self.databaseQueue];
+
+        //Upload the parts one by one
+        for (int32_t i = 1; i <= partCount ; i++) {
+            AWSS3TransferUtilityUploadSubTask *subTask = subTasks[i - 1];
             NSError *subTaskCreationError;
             
             //Move to inProgress or Waiting based on concurrency limit
@@ -101,7 +101,7 @@ NSString *const AWSS3TransferUtilityDatabaseName = @"transfer_utility_database";
     NSString * databasePath = [dbDirPath stringByAppendingString:AWSS3TransferUtilityDatabaseName];
     //Open the database if the directory exists
     AWSDDLogInfo(@"Transfer Utility Database Path: [%@]", databasePath);
-    AWSFMDatabaseQueue *databaseQueue = [AWSFMDatabaseQueue databaseQueueWithPath: databasePath];
+    AWSFMDatabaseQueue *databaseQueue = [AWSFMDatabaseQueue storeDatabaseQueueWithPath:databasePath];
     
     if (!databaseQueue) {
         AWSDDLogError(@"Unable to create Database Queue for [%@]", databasePath);
@@ -134,7 +134,7 @@ NSString *const AWSS3TransferUtilityDatabaseName = @"transfer_utility_database";
                           db.lastError);
             return;
         }
-        
+        [db aws_releaseFreePagesIfNeeded];
     }];
 }
 
@@ -154,7 +154,9 @@ NSString *const AWSS3TransferUtilityDatabaseName = @"transfer_utility_database";
         if (!result) {
             AWSDDLogError(@"Failed to delete transfer_request [%@] in Database. [%@]", transferID,
                           db.lastError);
+            return;
         }
+        [db aws_releaseFreePagesIfNeeded];
     }];
 }
 
@@ -257,26 +259,46 @@ NSString *const AWSS3TransferUtilityDatabaseName = @"transfer_utility_database";
                                                     databaseQueue:databaseQueue];
 }
 
-+ (void) insertMultiPartUploadRequestSubTaskInDB:(AWSS3TransferUtilityMultiPartUploadTask *) task
-                                         subTask:(AWSS3TransferUtilityUploadSubTask *) subTask
-                                   databaseQueue: (AWSFMDatabaseQueue *) databaseQueue {
-    [AWSS3TransferUtilityDatabaseHelper insertTransferRequestInDB:task.transferID
-                                                   nsURLSessionID:task.nsURLSessionID
-                                                   taskIdentifier:@(subTask.taskIdentifier)
-                                                     transferType:subTask.transferType
-                                                           bucket:task.bucket
-                                                              key:task.key
-                                                       partNumber:subTask.partNumber
-                                                      multiPartID:task.uploadID
-                                                             eTag:@""
-                                                             file:subTask.file
-                                             temporaryFileCreated: YES
-                                                    contentLength:@(subTask.totalBytesExpectedToSend)
-                                                           status:subTask.status
-                                                       retryCount:@(0)
-                                               requestHeadersJSON:[self getJSONRepresentation:task.expression.requestHeaders]
-                                            requestParametersJSON:[self getJSONRepresentation:task.expression.requestParameters]
-                                                    databaseQueue:databaseQueue];
++ (void) insertMultiPartUploadRequestSubTasksInDB:(AWSS3TransferUtilityMultiPartUploadTask *) task
+                                          subTasks:(NSArray<AWSS3TransferUtilityUploadSubTask *> *) subTasks
+                                    databaseQueue: (AWSFMDatabaseQueue *) databaseQueue {
+    NSString *const AWSS3TransferUtiltyInsertPartIntoAWSTransfer = @"INSERT INTO awstransfer ("
+    @"transfer_id,ns_url_session_id, session_task_id, transfer_type, bucket_name, key, part_number, multi_part_id, etag, file, "
+    @"temporary_file_created, content_length, status, retry_count, request_headers, request_parameters"
+    @") VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)";
+
+    NSString *requestHeadersJSON = [self getJSONRepresentation:task.expression.requestHeaders];
+    NSString *requestParametersJSON = [self getJSONRepresentation:task.expression.requestParameters];
+
+    // The parts are inserted with a single prepared statement in a single transaction, rather than one transaction per part.
+    NSMutableArray *argumentArrays = [NSMutableArray arrayWithCapacity:[subTasks count]];
+    for (AWSS3TransferUtilityUploadSubTask *subTask in subTasks) {
+        [argumentArrays addObject:@[task.transferID,
+                                    task.nsURLSessionID,
+                                    @(subTask.taskIdentifier),
+                                    subTask.transferType,
+                                    task.bucket,
+                                    task.key,
+                                    subTask.partNumber,
+                                    task.uploadID,
+                                    @"",
+                                    subTask.file,
+                                    @1,
+                                    @(subTask.totalBytesExpectedToSend),
+                                    [AWSS3TransferUtilityDatabaseHelper getStringRepresentation:subTask.status],
+                                    @0,
+                                    requestHeadersJSON,
+                                    requestParametersJSON]];
+    }
+
+    [databaseQueue inDatabase:^(AWSFMDatabase *db) {
+        BOOL result = [db executeUpdate:AWSS3TransferUtiltyInsertPartIntoAWSTransfer
+                     withArgumentArrays:argumentArrays];
+
+        if (!result) {
+            AWSDDLogError(@"Failed to save the parts of Transfer [%@] in awstransfer database table. [%@]", task.transferID, db.lastError);
+        }
+    }];
 }
 
 + (void) insertTransferRequestInDB: (NSString *) transferID
@@ -337,7 +359,7 @@ NSString *const AWSS3TransferUtilityDatabaseName = @"transfer_utility_database";
 }
 
 + (NSMutableArray *) getTransferTaskDataFromDB:(NSString *)nsURLSessionID
-                                 databaseQueue: (AWSFMDatabaseQueue *) databaseQueue
+                            databaseReaderPool: (AWSFMDatabasePool *) databaseReaderPool
 {
     NSString *const AWSS3TransferUtilityQueryAWSTransfer = @"Select transfer_id, session_task_id, "
     @"transfer_type, bucket_name, key, part_number, multi_part_id, etag, file, temporary_file_created, content_length, "
@@ -346,8 +368,8 @@ NSString *const AWSS3TransferUtilityDatabaseName = @"transfer_utility_database";
     @"Where ns_url_session_id=:ns_url_session_id order by transfer_id, part_number";
     
     NSMutableArray *tasks = [NSMutableArray new];
-    //Read from DB
-    [databaseQueue inDatabase:^(AWSFMDatabase *db) {
+    //Read from DB, without waiting for the writes of the transfers in progress
+    [databaseReaderPool inDatabase:^(AWSFMDatabase *db) {
         //Get all AWSTransferRecords
         AWSFMResultSet *rs = [db executeQuery:AWSS3TransferUtilityQueryAWSTransfer
                       withParameterDictionary:@{
@@ -0,0 +1,79 @@
+//
+// Copyright 2010-2021 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License").
+// You may not use this file except in compliance with the License.
+// A copy of the License is located at
+//
+// http://aws.amazon.com/apache2.0
+//
+// or in the "license" file accompanying this file. This file is distributed
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+// express or implied. See the License for the specific language governing
+// permissions and limitations under the License.
+//
+
+#import <XCTest/XCTest.h>
+#import "AWSS3Model.h"
+
+static const NSUInteger AWSS3ModelDecodingTestsObjectCount = 10000;
+
+@interface AWSS3ModelDecodingTests : XCTestCase
+
+@end
+
+@implementation AWSS3ModelDecodingTests
+
+// A ListObjectsV2 response as returned by the XML response serializer.
+- (NSDictionary *)listObjectsV2OutputJSONDictionary {
+    NSMutableArray *contents = [NSMutableArray arrayWithCapacity:AWSS3ModelDecodingTestsObjectCount];
+    for (NSUInteger i = 0; i < AWSS3ModelDecodingTestsObjectCount; i++) {
+        [contents addObject:@{
+                              @"Key" : [NSString stringWithFormat:@"photos/2019/01/%05lu.jpg", (unsigned long)i],
+                              @"LastModified" : @"2019-01-02T03:45:06.000Z",
+                              @"ETag" : @"\"9b2cf535f27731c974343645a3985328\"",
+                              @"Size" : @(1024 + i),
+                              @"StorageClass" : @"STANDARD",
+                              @"Owner" : @{@"ID" : @"75aa57f09aa0c8caeab4f8c24e99d10f8e7faeebf76c078efc7c6caea54ba06a",
+                                           @"DisplayName" : @"owner"},
+                              }];
+    }
+    return @{
+             @"Name" : @"bucket",
+             @"Prefix" : @"photos/",
+             @"KeyCount" : @(AWSS3ModelDecodingTestsObjectCount),
+             @"MaxKeys" : @(AWSS3ModelDecodingTestsObjectCount),
+             @"IsTruncated" : @(NO),
+             @"Contents" : contents,
+             };
+}
+
+- (void)testDecodingListObjectsV2Output {
+    NSError *error = nil;
+    AWSS3ListObjectsV2Output *output = [AWSMTLJSONAdapter modelOfClass:[AWSS3ListObjectsV2Output class]
+                                                     fromJSONDictionary:[self listObjectsV2OutputJSONDictionary]
+                                                                  error:&error];
+    XCTAssertNil(error);
+    XCTAssertEqualObjects(output.name, @"bucket");
+    XCTAssertEqualObjects(output.isTruncated, @(NO));
+    XCTAssertEqual([output.contents count], AWSS3ModelDecodingTestsObjectCount);
+
+    AWSS3Object *object = output.contents[42];
+    XCTAssertEqualObjects(object.key, @"photos/2019/01/00042.jpg");
+    XCTAssertEqualObjects(object.lastModified, [NSDate dateWithTimeIntervalSince1970:1546400706]);
+    XCTAssertEqualObjects(object.size, @(1066));
+    XCTAssertEqual(object.storageClass, AWSS3ObjectStorageClassStandard);
+    XCTAssertEqualObjects(object.owner.displayName, @"owner");
+}
+
+- (void)testPerformanceDecodingListObjectsV2Output {
+    NSDictionary *JSONDictionary = [self listObjectsV2OutputJSONDictionary];
+    [self measureBlock:^{
+        AWSS3ListObjectsV2Output *output = [AWSMTLJSONAdapter modelOfClass:[AWSS3ListObjectsV2Output class]
+                                                         fromJSONDictionary:JSONDictionary
+                                                                      error:nil];
+        XCTAssertEqual([output.contents count], AWSS3ModelDecodingTestsObjectCount);
+    }];
+}
+
+@end
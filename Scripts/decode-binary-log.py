@@ -0,0 +1,217 @@
+#!/usr/bin/env python3
+#
+# Copyright 2010-2021 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License").
+# You may not use this file except in compliance with the License.
+# A copy of the License is located at
+#
+# http://aws.amazon.com/apache2.0
+#
+# or in the "license" file accompanying this file. This file is distributed
+# on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+# express or implied. See the License for the specific language governing
+# permissions and limitations under the License.
+#
+# Decodes the log files written by AWSDDBinaryFileLogger into text, one line
+# per message. The file format is described in AWSDDBinaryFileLogger.h.
+#
+#   Scripts/decode-binary-log.py [--verbose] [--utc] FILE...
+
+import argparse
+import datetime
+import re
+import struct
+import sys
+
+HEADER = b"AWSDDBL\x01"
+
+RECORD_SESSION = 0x01
+RECORD_SITE = 0x02
+RECORD_EVENT = 0x03
+RECORD_TEXT = 0x04
+
+FLAGS = {1: "E", 2: "W", 4: "I", 8: "D", 16: "V"}
+
+# %[flags][width][.precision][length modifier]conversion, as parsed by AWSDDLogArguments.m.
+CONVERSION = re.compile(
+    r"%(?:(?P<percent>%)"
+    r"|(?P<flags>[-+ #0']*)(?P<width>\*|\d*)(?:\.(?P<precision>\*|\d*))?"
+    r"(?:hh|h|ll|l|q|L|z|t|j)?(?P<conversion>[diDouxXOUcCeEfFgGaAsS@p]))"
+)
+
+
+class DecodeError(Exception):
+    pass
+
+
+class Reader:
+    def __init__(self, data):
+        self.data = data
+        self.position = 0
+
+    def at_end(self):
+        return self.position >= len(self.data)
+
+    def read(self, length):
+        if self.position + length > len(self.data):
+            raise DecodeError("truncated record at offset %d" % self.position)
+        value = self.data[self.position:self.position + length]
+        self.position += length
+        return value
+
+    def uint8(self):
+        return self.read(1)[0]
+
+    def uint32(self):
+        return struct.unpack("<I", self.read(4))[0]
+
+    def int64(self):
+        return struct.unpack("<q", self.read(8))[0]
+
+    def uint64(self):
+        return struct.unpack("<Q", self.read(8))[0]
+
+    def double(self):
+        return struct.unpack("<d", self.read(8))[0]
+
+    def string(self):
+        return self.read(self.uint32()).decode("utf-8", errors="replace")
+
+
+def read_arguments(data):
+    reader = Reader(data)
+    arguments = []
+    while not reader.at_end():
+        kind = chr(reader.uint8())
+        if kind == "i":
+            arguments.append(reader.int64())
+        elif kind in ("u", "p"):
+            arguments.append(reader.uint64())
+        elif kind == "f":
+            arguments.append(reader.double())
+        elif kind == "s":
+            arguments.append(reader.string())
+        else:
+            raise DecodeError("unknown argument type %r" % kind)
+    return arguments
+
+
+def format_message(format_string, arguments):
+    arguments = iter(arguments)
+
+    def substitute(match):
+        if match.group("percent"):
+            return "%"
+        try:
+            width = match.group("width")
+            if width == "*":
+                width = str(next(arguments))
+            precision = match.group("precision")
+            if precision == "*":
+                precision = str(next(arguments))
+            specification = "%" + match.group("flags").replace("'", "") + width
+            if precision is not None:
+                specification += "." + precision
+            conversion = match.group("conversion")
+            value = next(arguments)
+        except StopIteration:
+            return match.group(0)
+
+        if conversion in "diDuU":
+            return (specification + "d") % value
+        if conversion in "oO":
+            return (specification + "o") % value
+        if conversion in "xX":
+            return (specification + conversion) % value
+        if conversion == "c":
+            return (specification + "s") % chr(value & 0xFF)
+        if conversion == "C":
+            return (specification + "s") % chr(value)
+        if conversion in "eEfFgG":
+            return (specification + conversion) % value
+        if conversion in "aA":
+            hexadecimal = float.hex(value)
+            return hexadecimal.upper() if conversion == "A" else hexadecimal
+        if conversion == "p":
+            return (specification + "s") % ("0x%x" % value)
+        return (specification + "s") % value
+
+    return CONVERSION.sub(substitute, format_string)
+
+
+def format_line(time, flag, context, thread_id, thread_name, queue_label, file, function, line, message, arguments):
+    if arguments.utc:
+        timestamp = datetime.datetime.fromtimestamp(time, datetime.timezone.utc)
+    else:
+        timestamp = datetime.datetime.fromtimestamp(time)
+    text = timestamp.strftime("%Y/%m/%d %H:%M:%S:") + "%03d" % (timestamp.microsecond // 1000)
+    if arguments.verbose:
+        text += " [%s] [%s%s] %s:%d %s" % (
+            FLAGS.get(flag, str(flag)),
+            thread_id,
+            ":" + (thread_name or queue_label) if (thread_name or queue_label) else "",
+            file.rsplit("/", 1)[-1],
+            line,
+            function,
+        )
+    return text + "  " + message
+
+
+def decode(data, arguments, output):
+    if data[:len(HEADER)] != HEADER:
+        raise DecodeError("not a binary log file")
+    reader = Reader(data)
+    reader.position = len(HEADER)
+    sites = {}
+    while not reader.at_end():
+        record = reader.uint8()
+        if record == RECORD_SESSION:
+            reader.double()
+            sites = {}
+        elif record == RECORD_SITE:
+            identifier = reader.uint32()
+            sites[identifier] = (reader.string(), reader.string(), reader.uint32(), reader.string())
+        elif record == RECORD_EVENT:
+            identifier = reader.uint32()
+            time, flag, context = reader.double(), reader.uint32(), reader.int64()
+            thread_id, thread_name, queue_label = reader.string(), reader.string(), reader.string()
+            packed = reader.read(reader.uint32())
+            if identifier not in sites:
+                raise DecodeError("undefined site %d" % identifier)
+            file, function, line, format_string = sites[identifier]
+            message = format_message(format_string, read_arguments(packed))
+            output.write(format_line(time, flag, context, thread_id, thread_name, queue_label,
+                                     file, function, line, message, arguments) + "\n")
+        elif record == RECORD_TEXT:
+            time, flag, context = reader.double(), reader.uint32(), reader.int64()
+            thread_id, thread_name, queue_label = reader.string(), reader.string(), reader.string()
+            file, function, line, message = reader.string(), reader.string(), reader.uint32(), reader.string()
+            output.write(format_line(time, flag, context, thread_id, thread_name, queue_label,
+                                     file, function, line, message, arguments) + "\n")
+        else:
+            raise DecodeError("unknown record type 0x%02x at offset %d" % (record, reader.position - 1))
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Decodes the log files written by AWSDDBinaryFileLogger.")
+    parser.add_argument("files", metavar="FILE", nargs="+", help="a binary log file")
+    parser.add_argument("-v", "--verbose", action="store_true",
+                        help="include the flag, thread and location of each message")
+    parser.add_argument("--utc", action="store_true", help="print times in UTC rather than local time")
+    arguments = parser.parse_args()
+
+    status = 0
+    for path in arguments.files:
+        with open(path, "rb") as file:
+            data = file.read()
+        try:
+            decode(data, arguments, sys.stdout)
+        except DecodeError as error:
+            sys.stderr.write("%s: %s\n" % (path, error))
+            status = 1
+    return status
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,65 @@
+#!/bin/bash
+
+# Runs the serialization benchmark in AWSCoreUnitTests on a simulator, and
+# optionally compares the result with a baseline report.
+#
+#   Scripts/serialization_benchmark.sh [--record <report.json>]
+#                                      [--baseline <report.json>]
+#                                      [--threshold <fraction>]
+#                                      [--iterations <count>]
+#                                      [--destination <xcodebuild destination>]
+#
+# Record a baseline on the base branch, then compare a change against it:
+#
+#   git checkout main && Scripts/serialization_benchmark.sh --record /tmp/baseline.json
+#   git checkout my-branch && Scripts/serialization_benchmark.sh --baseline /tmp/baseline.json
+#
+# The script exits with a non-zero status when encode or decode ns/op or
+# bytes/op of any case regressed by more than the threshold (default 0.1).
+
+set -euo pipefail
+
+readonly SCRIPT_DIR=$(cd "$(dirname "$0")" && pwd)
+readonly ROOT_DIR=$(dirname "$SCRIPT_DIR")
+
+REPORT="${TMPDIR:-/tmp}/serialization-benchmark.json"
+BASELINE=""
+THRESHOLD="0.1"
+ITERATIONS="20"
+DESTINATION="platform=iOS Simulator,name=iPhone 12,OS=latest"
+
+function usage {
+  sed -n '3,18p' "$0" | sed 's/^# \{0,1\}//'
+  exit 1
+}
+
+while [[ $# -gt 0 ]] ; do
+  case "$1" in
+    --record) REPORT="$2"; shift 2 ;;
+    --baseline) BASELINE="$2"; shift 2 ;;
+    --threshold) THRESHOLD="$2"; shift 2 ;;
+    --iterations) ITERATIONS="$2"; shift 2 ;;
+    --destination) DESTINATION="$2"; shift 2 ;;
+    -h|--help) usage ;;
+    *) echo "Unknown option: $1" >&2; usage ;;
+  esac
+done
+
+# xcodebuild passes variables prefixed with TEST_RUNNER_ on to the test
+# process, without the prefix.
+export TEST_RUNNER_AWS_SERIALIZATION_BENCHMARK_REPORT="$REPORT"
+export TEST_RUNNER_AWS_SERIALIZATION_BENCHMARK_THRESHOLD="$THRESHOLD"
+export TEST_RUNNER_AWS_SERIALIZATION_BENCHMARK_ITERATIONS="$ITERATIONS"
+if [[ -n "$BASELINE" ]] ; then
+  export TEST_RUNNER_AWS_SERIALIZATION_BENCHMARK_BASELINE="$BASELINE"
+fi
+
+cd "$ROOT_DIR"
+xcodebuild test \
+  -project AWSiOSSDKv2.xcodeproj \
+  -scheme AWSCore \
+  -sdk iphonesimulator \
+  -destination "$DESTINATION" \
+  -only-testing:AWSCoreUnitTests/AWSSerializationBenchmarkTests/testSerializationBenchmark
+
+echo "Report written to $REPORT"